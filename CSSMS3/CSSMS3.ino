@@ -56,6 +56,11 @@ constexpr long UpdateDisplayInterval = 100;
 void UpdateDisplayCallback();
 Task UpdateDisplayTask((UpdateDisplayInterval * TASK_MILLISECOND), TASK_FOREVER, &UpdateDisplayCallback, &MainScheduler, false);
 
+// Screen snapshots (see CSSMS3Display::RequestScreenSnapshot()), sent a chunk at a time so the other tasks keep running:
+constexpr long SendSnapshotInterval = 2;
+void SendSnapshotCallback();
+Task SendSnapshotTask((SendSnapshotInterval * TASK_MILLISECOND), TASK_FOREVER, &SendSnapshotCallback, &MainScheduler, false);
+
 constexpr long SendCSSMPacketInterval = 100;
 void SendCSSMPacketCallback();
 Task SendCSSMPacketTask((SendCSSMPacketInterval * TASK_MILLISECOND), TASK_FOREVER, &SendCSSMPacketCallback, &MainScheduler, false);
@@ -67,6 +72,15 @@ Task ReadEnvSensorsTask((ReadEnvSensorsInterval * TASK_MILLISECOND), TASK_FOREVE
 #include "src/CSSMS3Status.h"
 #include <I2CBus.h>
 
+// Time sync requests to the MCC, whose clock is shared by all the modules (see ClockSync.h):
+void SendTimeSyncCallback();
+Task SendTimeSyncTask((ClockSyncInterval * TASK_MILLISECOND), TASK_FOREVER, &SendTimeSyncCallback, &MainScheduler, false);
+
+// This end's ESP-NOW link statistics, sent to the MCC once per statistics window (see LinkMonitor.h):
+constexpr long SendLinkStatsInterval = LinkStatsWindow;
+void SendLinkStatsCallback();
+Task SendLinkStatsTask((SendLinkStatsInterval * TASK_MILLISECOND), TASK_FOREVER, &SendLinkStatsCallback, &MainScheduler, false);
+
 // MRS MCC MAC addresses for reference; set in CSSMS3Status:
 //uint8_t MRSMCCMAC[6] = { 0xF0, 0xF5, 0xBD, 0x42, 0xB7, 0x78 };		// MRS Dev1 MCC
 //uint8_t MRSMCCMAC[6] = { 0x80, 0x65, 0x99, 0xA1, 0xDE, 0x98 };		// Breadboard prototype MCC
@@ -76,6 +90,7 @@ constexpr uint16_t MaxCSSMSendRetries = 16;
 
 //#include "src/ESP32WiFi.h"
 #include <WiFi.h>
+#include <esp_wifi.h>
 //#define LocalWiFiSSID "WeatherDogPacNW"
 //#define LocalWiFiPW "5TgbnhY6"
 #define LocalWiFiSSID "320"
@@ -111,6 +126,8 @@ void setup()
 		CSSMS3Status.ComMode = CSSMS3StatusClass::ComModes::IDCPktSerial;
 	}
 
+	CSSMS3Status.Init();
+
 	pinMode(HeartbeatLEDPin, OUTPUT);
 	sprintf(buf, "Heartbeat LED on GPIO%02D", HeartbeatLEDPin);
 	_PL(buf);
@@ -217,6 +234,12 @@ void setup()
 		// Register OnDataReceived callback
 		esp_now_register_recv_cb(esp_now_recv_cb_t(OnMRSMCCDataReceived));
 
+		// The ESP-NOW receive callback does not get the signal strength; catch the MCC's frames in promiscuous mode
+		//(management frames only) to measure it:
+		wifi_promiscuous_filter_t filter = { .filter_mask = WIFI_PROMIS_FILTER_MASK_MGMT };
+		esp_wifi_set_promiscuous_filter(&filter);
+		esp_wifi_set_promiscuous_rx_cb(OnPromiscuousFrameReceived);
+		esp_wifi_set_promiscuous(true);
 	}
 	sprintf(buf, "CSSMDrivePacket: %d b", sizeof(CSSMDrivePacket));
 	CSSMS3Status.AddDebugTextLine(buf);
@@ -253,6 +276,8 @@ void setup()
 	if (CSSMS3Status.ESPNOWStatus)
 	{
 		SendCSSMPacketTask.enable();
+		SendTimeSyncTask.enable();
+		SendLinkStatsTask.enable();
 		// Set ESPNOWStatus to match initial setting of the ESP-NOW menu item used to enable / disable the command stream from 
 		//the CSSM to the MRS MCC, which should be FALSE to start
 		// User initiates telemetry to the MRS through the on-screen menu system when ready:
@@ -287,6 +312,18 @@ void UpdateDisplayCallback()
 {
 	CSSMS3Status.Update();		// To check health of ESP-NOW telemetry
 	cssmS3Display.Update();
+	if (cssmS3Display.IsSendingSnapshot())
+	{
+		SendSnapshotTask.enableIfNot();
+	}
+}
+
+void SendSnapshotCallback()
+{
+	if (!cssmS3Display.SendScreenSnapshotChunk())
+	{
+		SendSnapshotTask.disable();
+	}
 }
 
 void SendCSSMPacketCallback()
@@ -298,6 +335,7 @@ void SendCSSMPacketCallback()
 
 	if (CSSMS3Status.ESPNOWStatus)
 	{
+		CSSMS3Status.cssmDrivePacket.LinkSequence++;
 		result = esp_now_send(CSSMS3Status.MRSMCCMAC, (uint8_t*)&CSSMS3Status.cssmDrivePacket, sizeof(CSSMS3Status.cssmDrivePacket));
 		if (result != ESP_NOW_SEND_SUCCESS)
 		{
@@ -307,6 +345,39 @@ void SendCSSMPacketCallback()
 	}
 }
 
+/// <summary>
+/// Sends a time sync request stamped with this module's clock; the MCC returns it stamped with its own and the reply
+/// is matched to the request by sequence number in CSSMS3Status.Update()
+/// </summary>
+void SendTimeSyncCallback()
+{
+	if (!CSSMS3Status.ESPNOWStatus)
+	{
+		return;
+	}
+
+	TimeSyncPacket packet;
+	packet.Sequence = ++CSSMS3Status.TimeSyncSequence;
+	packet.ResidualOffset = CSSMS3Status.Clock.ResidualOffset;
+	packet.OriginateTime = esp_timer_get_time();
+	esp_now_send(CSSMS3Status.MRSMCCMAC, (uint8_t*)&packet, sizeof(packet));
+}
+
+/// <summary>
+/// Sends this end's view of the ESP-NOW link to the MCC, which shows it alongside its own
+/// </summary>
+void SendLinkStatsCallback()
+{
+	if (!CSSMS3Status.ESPNOWStatus)
+	{
+		return;
+	}
+
+	LinkStatsPacket packet;
+	CSSMS3Status.Link.GetStats(packet);
+	esp_now_send(CSSMS3Status.MRSMCCMAC, (uint8_t*)&packet, sizeof(packet));
+}
+
 void ReadEnvSensorsCallback()
 {
 	EnvSensors.Update();
@@ -317,6 +388,7 @@ void OnMRSMCCDataSent(const uint8_t* mac_addr, esp_now_send_status_t status)
 	char buf[64];
 
 	bool result = (status == ESP_NOW_SEND_SUCCESS);
+	CSSMS3Status.Link.RecordSend(result);
 	if (result)
 	{
 		CSSMS3Status.ESPNOWPacketSentCount++;
@@ -349,18 +421,53 @@ void OnMRSMCCDataSent(const uint8_t* mac_addr, esp_now_send_status_t status)
 
 void OnMRSMCCDataReceived(const uint8_t* mac, const uint8_t* data, int lenght)
 {
+	int64_t receiveTime = esp_timer_get_time();
 	char buf[32];
 
 	switch (data[0])
 	{
 	case 0x30:
 		memcpy(&(CSSMS3Status.mcStatus), data, sizeof(CSSMS3Status.mcStatus));
+		CSSMS3Status.Link.RecordReceived(CSSMS3Status.mcStatus.LinkSequence, (uint32_t)receiveTime);
 		break;
 	case 0x31:
 		memcpy(&(CSSMS3Status.mrsStatusPacket), data, sizeof(CSSMS3Status.mrsStatusPacket));
 		break;
 	case 0x32:
 		memcpy(&(CSSMS3Status.mrsSensorPacket), data, sizeof(CSSMS3Status.mrsSensorPacket));
+		CSSMS3Status.MRSSensorPacketReceivedCount++;
+		break;
+	case 0x33:
+		if (lenght == sizeof(PolarScanChunkPacket))
+		{
+			PolarScanChunkPacket chunk;
+			memcpy(&chunk, data, sizeof(chunk));
+			CSSMS3Status.ScanChunkQueue.Push(chunk);
+		}
+		break;
+	case 0x34:
+		if (lenght == sizeof(OccupancyTilePacket))
+		{
+			OccupancyTilePacket tile;
+			memcpy(&tile, data, sizeof(tile));
+			CSSMS3Status.MapTileQueue.Push(tile);
+		}
+		break;
+	case 0x35:
+		if (lenght == sizeof(TimeSyncPacket))
+		{
+			CSSMS3StatusClass::TimeSyncReply reply;
+			memcpy(&reply.Packet, data, sizeof(reply.Packet));
+			reply.DestinationTime = receiveTime;
+			CSSMS3Status.TimeSyncQueue.Push(reply);
+		}
+		break;
+	case 0x36:
+		if (lenght == sizeof(LinkStatsPacket))
+		{
+			memcpy(&(CSSMS3Status.MCCLinkStats), data, sizeof(CSSMS3Status.MCCLinkStats));
+			CSSMS3Status.MCCLinkStatsReceivedCount++;
+		}
 		break;
 	default:
 		break;
@@ -371,4 +478,23 @@ void OnMRSMCCDataReceived(const uint8_t* mac, const uint8_t* data, int lenght)
 	CSSMS3Status.MCCPacketReceiptInterval = receiptTime - CSSMS3Status.LastMCCPacketReceivedTime;
 	CSSMS3Status.LastMCCPacketReceivedTime = receiptTime;
 
+}
+
+/// <summary>
+/// Passes the signal strength of ESP-NOW frames (vendor specific action frames) from the MCC to the link monitor
+/// </summary>
+void OnPromiscuousFrameReceived(void* buf, wifi_promiscuous_pkt_type_t type)
+{
+	if (type != WIFI_PKT_MGMT)
+	{
+		return;
+	}
+
+	const wifi_promiscuous_pkt_t* pkt = (const wifi_promiscuous_pkt_t*)buf;
+	const uint8_t* frame = pkt->payload;
+	if (pkt->rx_ctrl.sig_len > 24 && frame[0] == 0xD0 && frame[24] == 127
+		&& memcmp(frame + 10, CSSMS3Status.MRSMCCMAC, 6) == 0)
+	{
+		CSSMS3Status.Link.RecordRSSI(pkt->rx_ctrl.rssi);
+	}
 }
\ No newline at end of file
@@ -72,6 +72,48 @@ void BarGauge::SetPowBarColor(uint16_t newPowBarColor)
 	PowBarColor = newPowBarColor;
 }
 
+/// <param name="rate">Hz; Update() draws at most this often, 0 for every call</param>
+void BarGauge::SetMaxUpdateRate(float rate)
+{
+	MinUpdateInterval = (rate > 0.0f) ? 1000.0f / rate : 0;
+}
+
+void BarGauge::Fill(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color)
+{
+	tft->fillRect(x, y, w, h, color);
+	LastUpdatePixels += w * h;
+}
+
+/// <summary>
+/// Fills the part of the bar between two heights of the same sign
+/// </summary>
+/// <param name="from">pixels; nearer Y0 than to</param>
+void BarGauge::FillBar(int from, int to, uint16_t color)
+{
+	if (to > 0)
+	{
+		Fill(Xtl + 2, Y0 - to, WBar, to - from, color);
+	}
+	else
+	{
+		Fill(Xtl + 2, Y0 + 1 - from, WBar, from - to, color);
+	}
+}
+
+/// <returns>Left edge of the power bar, or -1 if the gauge has none</returns>
+int32_t BarGauge::GetPowerBarX()
+{
+	switch (LayoutType)
+	{
+	case PowerBarLeft:
+		return Xtl - 4;
+	case PowerBarRight:
+		return Xtl + WFrame + 2;
+	default:
+		return -1;
+	}
+}
+
 void BarGauge::DrawFrame()
 {
 	tft->fillRect(Xtl, Ytl, WFrame, HFrame, TFT_BLACK);
@@ -97,32 +139,66 @@ void BarGauge::DrawFrame()
 	//default:
 	//	break;
 	//}
+
+	// Clear the power bar and start again with nothing drawn:
+	if (GetPowerBarX() >= 0)
+	{
+		tft->fillRect(GetPowerBarX(), Ytl, 3, HFrame, TFT_BLACK);
+	}
+	DrawnBar = 0;
+	DrawnPowerBar = 0;
+	DrawnText[0] = 0;
+	DrawnTextColor = TFT_BLACK;
+	LastUpdateTime = millis() - MinUpdateInterval;
 }
 
+/// <summary>
+/// Shows new readings, drawing only the strips of the bars that have grown or shrunk and the digits of the numeric
+/// reading that have changed; nothing is drawn if neither the bar heights nor the numeric reading have changed
+/// </summary>
 void BarGauge::Update(float newReading, float newPowerReading)
 {
 	char buf[16];
-	
+
 	reading = newReading;
-	int16_t HBar = 0;
+	powerReading = newPowerReading;
+
+	uint32_t now = millis();
+	if (MinUpdateInterval > 0 && now - LastUpdateTime < MinUpdateInterval)
+	{
+		return;
+	}
+	LastUpdateTime = now;
+	LastUpdatePixels = 0;
+
+	// Bar, constrained to the frame:
+	int maxBar = HFrame / 2 - 1;
+	int newBar = 0;
+	uint16_t barColor = PosBarColor;
 	if (reading < 0.0f)
 	{
-		tft->fillRect(Xtl + 2, Y0 + 1, WBar, HFrame / 2 - 1, TFT_BLACK);
-		HBar = reading / minReading * (HFrame / 2 - 1);
-		tft->fillRect(Xtl + 2, Y0 + 1, WBar, HBar, NegBarColor);
-		tft->setTextColor(NegBarColor, TFT_BLACK, true);
+		newBar = -min((int)(reading / minReading * maxBar), maxBar);
+		barColor = NegBarColor;
 	}
 	else
 	{
-		tft->fillRect(Xtl + 2, Y0 - HFrame / 2 + 1, WBar, HFrame / 2 - 1, TFT_BLACK);
-		HBar = reading / maxReading * (HFrame / 2 - 1);
-		tft->fillRect(Xtl + 2, Y0 - HBar, WBar, HBar, PosBarColor);
-		tft->setTextColor(PosBarColor, TFT_BLACK, true);
+		newBar = min((int)(reading / maxReading * maxBar), maxBar);
 	}
 
-	powerReading = newPowerReading;
-	// Constrain height of power bar to 0..maxPowerReading:
-	HBar = min((int)(powerReading / maxPowerReading * HFrame), HFrame);
+	if ((DrawnBar > 0 && newBar < 0) || (DrawnBar < 0 && newBar > 0))
+	{
+		FillBar(0, DrawnBar, TFT_BLACK);
+		DrawnBar = 0;
+	}
+	if (abs(newBar) > abs(DrawnBar))
+	{
+		FillBar(DrawnBar, newBar, barColor);
+	}
+	else if (abs(newBar) < abs(DrawnBar))
+	{
+		FillBar(newBar, DrawnBar, TFT_BLACK);
+	}
+	DrawnBar = newBar;
 
 	// Display numeric reading as pecent of full scale:
 	float pctReading = 0.0f;
@@ -134,27 +210,49 @@ void BarGauge::Update(float newReading, float newPowerReading)
 	{
 		pctReading = reading / maxReading * 100.0f;
 	}
-	sprintf(buf, "%+04.0f", pctReading);
+	snprintf(buf, sizeof(buf), "%+04.0f", pctReading);
 
-	tft->setTextDatum(TC_DATUM);
-	tft->drawString(buf, X0 + 1, Ytl + HFrame + 12, 1);
-	switch (LayoutType)
+	int32_t textY = Ytl + HFrame + 12;
+	tft->setTextColor(barColor, TFT_BLACK, true);
+	if (barColor != DrawnTextColor || strlen(buf) != strlen(DrawnText))
 	{
-	case NoPowerBar:
-		break;
-	case PowerBarLeft:
-		// Erase old power bar:
-		tft->fillRect(Xtl - 4, Ytl, 3, HFrame, TFT_BLACK);
-		// Draw power bar:
-		tft->fillRect(Xtl - 4, Ytl + HFrame - HBar, 3, HBar, PowBarColor);
-		break;
-	case PowerBarRight:
-		// Erase old power bar:
-		tft->fillRect(Xtl + WFrame + 2, Ytl, 3, HFrame, TFT_BLACK);
-		// Draw power bar:
-		tft->fillRect(Xtl + WFrame + 2, Ytl + HFrame - HBar, 3, HBar, PowBarColor);
-		break;
-	default:
-		break;
+		if (DrawnText[0] != 0)
+		{
+			int32_t drawnWidth = tft->textWidth(DrawnText, 1);
+			Fill(X0 + 1 - drawnWidth / 2, textY, drawnWidth, tft->fontHeight(1), TFT_BLACK);
+		}
+		tft->setTextDatum(TC_DATUM);
+		LastUpdatePixels += tft->drawString(buf, X0 + 1, textY, 1) * tft->fontHeight(1);
+	}
+	else
+	{
+		// Same length in a fixed width font, so the characters stay where they are:
+		int32_t charWidth = tft->textWidth(buf, 1) / strlen(buf);
+		int32_t x = X0 + 1 - tft->textWidth(buf, 1) / 2;
+		for (uint8_t i = 0; buf[i] != 0; i++)
+		{
+			if (buf[i] != DrawnText[i])
+			{
+				LastUpdatePixels += tft->drawChar(buf[i], x + i * charWidth, textY, 1) * tft->fontHeight(1);
+			}
+		}
+	}
+	strlcpy(DrawnText, buf, sizeof(DrawnText));
+	DrawnTextColor = barColor;
+
+	// Power bar, constrained to 0..maxPowerReading:
+	int32_t powerBarX = GetPowerBarX();
+	if (powerBarX >= 0)
+	{
+		int newPowerBar = constrain((int)(powerReading / maxPowerReading * HFrame), 0, HFrame);
+		if (newPowerBar > DrawnPowerBar)
+		{
+			Fill(powerBarX, Ytl + HFrame - newPowerBar, 3, newPowerBar - DrawnPowerBar, PowBarColor);
+		}
+		else if (newPowerBar < DrawnPowerBar)
+		{
+			Fill(powerBarX, Ytl + HFrame - DrawnPowerBar, 3, DrawnPowerBar - newPowerBar, TFT_BLACK);
+		}
+		DrawnPowerBar = newPowerBar;
 	}
 }
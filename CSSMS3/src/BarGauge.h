@@ -64,6 +64,18 @@ protected:
 	float powerReading = 0.0f;
 	float maxPowerReading = 0.0f;
 
+	// What is currently drawn, so Update() only draws what has changed:
+	int DrawnBar = 0;					// pixels; positive up from Y0, negative down
+	int DrawnPowerBar = 0;				// pixels
+	char DrawnText[8] = "";
+	uint16_t DrawnTextColor = TFT_BLACK;
+
+	uint32_t MinUpdateInterval = 0;		// ms; 0 for no limit
+	uint32_t LastUpdateTime = 0;		// ms
+
+	void Fill(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color);
+	void FillBar(int from, int to, uint16_t color);
+	int32_t GetPowerBarX();
 
 public:
 	bool Init(TFT_eSPI* _tft, int x0, int y0, BarGaugeLayoutTypes layoutType = BarGaugeLayoutTypes::NoPowerBar, int frameWidth = defaultFrameWidth, int frameHeight = defaultFrameHeight);
@@ -74,6 +86,9 @@ public:
 	void SetPosBarColor(uint16_t newPosBarColor);
 	void SetNegBarColor(uint16_t newNegBarColor);
 	void SetPowBarColor(uint16_t newPowBarColor);
+	void SetMaxUpdateRate(float rate);
+
+	uint32_t LastUpdatePixels = 0;		// Pixels written by the last Update() not skipped by SetMaxUpdateRate()
 
 	void DrawFrame();
 	void Update(float newReading, float newPowerReading = 0.0f);
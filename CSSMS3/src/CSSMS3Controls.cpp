@@ -128,7 +128,9 @@ void CSSMS3Controls::WaypointOSBHandler(int value)
 		CSSMS3Status.cssmDrivePacket.DriveMode = CSSMDrivePacket::DriveModes::SEQ;
 		break;
 	default:
+		// Entering WPT mode stops the MRS until a waypoint is entered with D-TO on the WPT page:
 		CSSMS3Status.cssmDrivePacket.DriveMode = CSSMDrivePacket::DriveModes::WPT;
+		CSSMS3Status.cssmDrivePacket.WaypointValid = false;
 		break;
 	}
 	cssmS3Display.ShowCurrentDriveModePage();
@@ -268,6 +270,17 @@ void CSSMS3Controls::SetSPD(int value)
 	CSSMS3Status.cssmDrivePacket.SpeedSetting = value;
 }
 
+void CSSMS3Controls::DirectTo(int value)
+{
+	CSSMDrivePacket& packet = CSSMS3Status.cssmDrivePacket;
+	packet.WaypointX = cssmS3Controls.WaypointXMenuItem->GetValue() / 10.0f;
+	packet.WaypointY = cssmS3Controls.WaypointYMenuItem->GetValue() / 10.0f;
+	packet.WaypointSequence++;
+	packet.WaypointValid = true;
+	packet.DriveMode = CSSMDrivePacket::DriveModes::WPT;
+	cssmS3Display.Control(CSSMS3Display::Commands::WPTPage);
+}
+
 bool CSSMS3Controls::Init(TFT_eSPI* parentTFT)
 {
 	char buf[64];
@@ -408,6 +421,73 @@ bool CSSMS3Controls::Init(TFT_eSPI* parentTFT)
 	DebugMenu->AddItem(ShowFontMenuItem);
 	ShowFontMenuItem->SetOnExecuteHandler(cssmS3Display.ShowFontTableFixed);
 
+	SnapshotMenuItem = new MenuItemClass("Snap", 156, 157, 40, 12, MenuItemClass::MenuItemTypes::Action);
+	SnapshotMenuItem->Init(tft);
+	DebugMenu->AddItem(SnapshotMenuItem);
+	SnapshotMenuItem->SetOnExecuteHandler(cssmS3Display.RequestScreenSnapshot);
+
+	SENPageMenu = new TFTMenuClass();
+	SENPageMenu->Init(tft);
+
+	SENPageMenu->AddItem(NextPageMenuItem);
+
+	TurretScanMenuItem = new MenuItemClass("Scan", 36, 157, 56, 12, MenuItemClass::MenuItemTypes::OffOn);
+	TurretScanMenuItem->Init(tft);
+	SENPageMenu->AddItem(TurretScanMenuItem);
+	TurretScanMenuItem->SetOnExecuteHandler(SetTurretScan);
+
+	TurretScanPatternMenuItem = new MenuItemClass("Pat", 98, 157, 56, 12, MenuItemClass::MenuItemTypes::Numeric);
+	TurretScanPatternMenuItem->Init(tft);
+	SENPageMenu->AddItem(TurretScanPatternMenuItem);
+	TurretScanPatternMenuItem->SetOnExecuteHandler(SetTurretScanPattern);
+	TurretScanPatternMenuItem->SetMinValue(0);
+	TurretScanPatternMenuItem->SetMaxValue(TurretScanPatternCount - 1);
+	TurretScanPatternMenuItem->SetNumericStepSize(1);
+	TurretScanPatternMenuItem->SetValue(0);
+
+	HomeTurretMenuItem = new MenuItemClass("Home", 162, 157, 56, 12, MenuItemClass::MenuItemTypes::Action);
+	HomeTurretMenuItem->Init(tft);
+	SENPageMenu->AddItem(HomeTurretMenuItem);
+	HomeTurretMenuItem->SetOnExecuteHandler(HomeTurret);
+
+	TurretAutoRehomeMenuItem = new MenuItemClass("AutoH", 226, 157, 56, 12, MenuItemClass::MenuItemTypes::OffOn);
+	TurretAutoRehomeMenuItem->Init(tft);
+	SENPageMenu->AddItem(TurretAutoRehomeMenuItem);
+	TurretAutoRehomeMenuItem->SetOnExecuteHandler(SetTurretAutoRehome);
+	TurretAutoRehomeMenuItem->SetValue(0);
+
+	// Forward VL53L1X settings, sent together whenever one of them is changed:
+	FwdRangingBudgetMenuItem = new MenuItemClass("TB ms", 2, 70, 56, 12, MenuItemClass::MenuItemTypes::Numeric);
+	FwdRangingBudgetMenuItem->Init(tft);
+	SENPageMenu->AddItem(FwdRangingBudgetMenuItem);
+	FwdRangingBudgetMenuItem->SetOnExecuteHandler(SetFwdRanging);
+	FwdRangingBudgetMenuItem->SetMinValue(15);
+	FwdRangingBudgetMenuItem->SetMaxValue(500);
+	FwdRangingBudgetMenuItem->SetNumericStepSize(5);
+	FwdRangingBudgetMenuItem->SetValue(defaultFwdRangingBudget);
+
+	FwdRangingLongMenuItem = new MenuItemClass("Long", 62, 70, 48, 12, MenuItemClass::MenuItemTypes::OffOn);
+	FwdRangingLongMenuItem->Init(tft);
+	SENPageMenu->AddItem(FwdRangingLongMenuItem);
+	FwdRangingLongMenuItem->SetOnExecuteHandler(SetFwdRanging);
+	FwdRangingLongMenuItem->SetValue(1);
+
+	FwdRangingZonesMenuItem = new MenuItemClass("Zones", 114, 70, 56, 12, MenuItemClass::MenuItemTypes::OffOn);
+	FwdRangingZonesMenuItem->Init(tft);
+	SENPageMenu->AddItem(FwdRangingZonesMenuItem);
+	FwdRangingZonesMenuItem->SetOnExecuteHandler(SetFwdRanging);
+	FwdRangingZonesMenuItem->SetValue(0);
+
+	ChartsMenu = new TFTMenuClass();
+	ChartsMenu->Init(tft);
+
+	ChartsMenu->AddItem(NextPageMenuItem);
+
+	ChartSpanMenuItem = new MenuItemClass("Span", 36, 157, 56, 12, MenuItemClass::MenuItemTypes::Action);
+	ChartSpanMenuItem->Init(tft);
+	ChartsMenu->AddItem(ChartSpanMenuItem);
+	ChartSpanMenuItem->SetOnExecuteHandler(cssmS3Display.NextChartSpan);
+
 	HDGPageMenu = new TFTMenuClass();
 	HDGPageMenu->Init(tft);
 
@@ -468,6 +548,33 @@ bool CSSMS3Controls::Init(TFT_eSPI* parentTFT)
 	STPositionMenuItem->SetNumericStepSize(ManualSTControlDelta);
 	STPositionMenuItem->SetValue(0);
 
+	// The waypoint is entered in decimetres (OTOS frame) and only sent to the MCC by D-TO:
+	WPTPageMenu = new TFTMenuClass();
+	WPTPageMenu->Init(tft);
+
+	WaypointXMenuItem = new MenuItemClass("X dm", 36, 157, 56, 12, MenuItemClass::MenuItemTypes::Numeric);
+	WaypointXMenuItem->Init(tft);
+	WPTPageMenu->AddItem(WaypointXMenuItem);
+	WaypointXMenuItem->SetOnExecuteHandler(nullptr);
+	WaypointXMenuItem->SetMinValue(-MaxWaypointEntry);
+	WaypointXMenuItem->SetMaxValue(MaxWaypointEntry);
+	WaypointXMenuItem->SetNumericStepSize(1);
+	WaypointXMenuItem->SetValue(0);
+
+	WaypointYMenuItem = new MenuItemClass("Y dm", 98, 157, 56, 12, MenuItemClass::MenuItemTypes::Numeric);
+	WaypointYMenuItem->Init(tft);
+	WPTPageMenu->AddItem(WaypointYMenuItem);
+	WaypointYMenuItem->SetOnExecuteHandler(nullptr);
+	WaypointYMenuItem->SetMinValue(-MaxWaypointEntry);
+	WaypointYMenuItem->SetMaxValue(MaxWaypointEntry);
+	WaypointYMenuItem->SetNumericStepSize(1);
+	WaypointYMenuItem->SetValue(0);
+
+	DirectToMenuItem = new MenuItemClass("D-TO", 162, 157, 56, 12, MenuItemClass::MenuItemTypes::Action);
+	DirectToMenuItem->Init(tft);
+	WPTPageMenu->AddItem(DirectToMenuItem);
+	DirectToMenuItem->SetOnExecuteHandler(DirectTo);
+
 	// Set up ADC:
 	SetupADC();
 
@@ -519,6 +626,16 @@ void CSSMS3Controls::Update()
 		currentMenu = DebugMenu;
 		break;
 	}
+	case CSSMS3Display::Pages::SEN:
+	{
+		currentMenu = SENPageMenu;
+		break;
+	}
+	case CSSMS3Display::Pages::TEL:
+	{
+		currentMenu = ChartsMenu;
+		break;
+	}
 	case CSSMS3Display::Pages::DRV:
 	{
 		currentMenu = DRVPageMenu;
@@ -529,6 +646,11 @@ void CSSMS3Controls::Update()
 		currentMenu = HDGPageMenu;
 		break;
 	}
+	case CSSMS3Display::Pages::WPT:
+	{
+		currentMenu = WPTPageMenu;
+		break;
+	}
 	default:
 		currentMenu = MainMenu;
 		break;
@@ -838,6 +960,70 @@ void CSSMS3Controls::SetTurretPosition(int value)
 	}
 }
 
+void CSSMS3Controls::SetTurretScan(int value)
+{
+	CSSMCommandPacket cp;
+	cp.command = value ? CSSMCommandPacket::StartTurretScan : CSSMCommandPacket::StopTurretScan;
+	SendCommandPacket(cp);
+}
+
+void CSSMS3Controls::SetTurretScanPattern(int value)
+{
+	CSSMCommandPacket cp;
+	cp.command = CSSMCommandPacket::SetTurretScanPattern;
+	cp.turretPosition = value;
+	SendCommandPacket(cp);
+}
+
+void CSSMS3Controls::HomeTurret(int value)
+{
+	CSSMCommandPacket cp;
+	cp.command = CSSMCommandPacket::HomeTurret;
+	SendCommandPacket(cp);
+}
+
+void CSSMS3Controls::SetTurretAutoRehome(int value)
+{
+	CSSMCommandPacket cp;
+	cp.command = CSSMCommandPacket::SetTurretAutoRehome;
+	cp.turretPosition = value;
+	SendCommandPacket(cp);
+}
+
+void CSSMS3Controls::SetFwdRanging(int value)
+{
+	CSSMCommandPacket cp;
+	cp.command = CSSMCommandPacket::ConfigureFwdRanging;
+	cp.turretPosition = cssmS3Controls.FwdRangingBudgetMenuItem->GetValue() & FwdRangingBudgetMask;
+	if (cssmS3Controls.FwdRangingLongMenuItem->GetValue())
+	{
+		cp.turretPosition |= FwdRangingLongMode;
+	}
+	if (cssmS3Controls.FwdRangingZonesMenuItem->GetValue())
+	{
+		cp.turretPosition |= FwdRangingZoneCycling;
+	}
+	SendCommandPacket(cp);
+}
+
+/// <summary>
+/// Sends a command packet to the MCC, which forwards sensor turret commands to the MRS SEN module
+/// </summary>
+void CSSMS3Controls::SendCommandPacket(CSSMCommandPacket& cp)
+{
+	char buf2[64];
+
+	if (CSSMS3Status.ESPNOWStatus)
+	{
+		esp_err_t result = esp_now_send(CSSMS3Status.MRSMCCMAC, (uint8_t*)&cp, sizeof(cp));
+		if (result != ESP_NOW_SEND_SUCCESS)
+		{
+			sprintf(buf2, "ESP-NOW send error: %S", esp_err_to_name(result));
+			_PL(buf2)
+		}
+	}
+}
+
 String CSSMS3Controls::GetKPVoltageString(String format)
 {
 	return KPVoltage.GetRealString(format);
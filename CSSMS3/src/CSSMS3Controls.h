@@ -26,6 +26,7 @@
 #include "esp_adc_cal.h"
 
 #include <esp_now.h>
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\CSSMCommandPacket.h"
 
 constexpr uint32_t defaultVRef = 1100;
 
@@ -72,6 +73,9 @@ constexpr byte OSBLevelCount = OSBCount + 1;
 
 constexpr float defaultManualSteeringDelta = 5.0f;		// % change in turn rate setting per count of the FuncEncoder when in DRV or DRVTw drive mode
 constexpr float defaultManualSpeedDelta = 1.0f;			// % change in speed setting per count of the FuncEncoder
+constexpr int TurretScanPatternCount = 4;					// Sensor turret scan patterns (see STScanPattern.h in MRSSENXIAOS3)
+constexpr int defaultFwdRangingBudget = 33;					// ms; forward VL53L1X timing budget (see MRSChassisSensors.h in MRSSENXIAOS3)
+constexpr int MaxWaypointEntry = 99;						// dm; range of the WPT page waypoint X and Y entries
 constexpr float defaultManualSTControlDelta = 5.0f;		// Default change in Sensor Turret position setting (in degrees) per count of the FuncEncoder when in STControl mode
 
 class CSSMS3Controls
@@ -139,6 +143,13 @@ protected:
 	static void T1Reset(int value);				// Send command to MRS resetting Trip 1 odometer measurements
 	static void T2Reset(int value);				// Send command to MRS resetting Trip 1 odometer measurements
 	static void SetTurretPosition(int value);	// Send command to set new Sensor Turret position
+	static void SetTurretScan(int value);		// Send command to start (1) or stop (0) the Sensor Turret scan
+	static void SetTurretScanPattern(int value);	// Send command to select a Sensor Turret scan pattern
+	static void HomeTurret(int value);			// Send command to re-reference the Sensor Turret position
+	static void SetTurretAutoRehome(int value);	// Send command to enable (1) or disable (0) periodic Sensor Turret re-homing
+	static void SetFwdRanging(int value);		// Send the forward VL53L1X timing budget, distance mode and zone cycling settings
+	static void DirectTo(int value);			// Make the X and Y entered on the WPT page the waypoint and navigate to it
+	static void SendCommandPacket(CSSMCommandPacket& cp);
 
 public:
 	enum NavEncoderModes
@@ -181,6 +192,19 @@ public:
 	MenuItemClass* ReportMemoryMenuItem;
 	MenuItemClass* MCCalibMenuItem;
 	MenuItemClass* ShowFontMenuItem;
+	MenuItemClass* SnapshotMenuItem;
+
+	TFTMenuClass* SENPageMenu;			// SEN page menu
+	MenuItemClass* TurretScanMenuItem;
+	MenuItemClass* TurretScanPatternMenuItem;
+	MenuItemClass* HomeTurretMenuItem;
+	MenuItemClass* TurretAutoRehomeMenuItem;
+	MenuItemClass* FwdRangingBudgetMenuItem;
+	MenuItemClass* FwdRangingLongMenuItem;
+	MenuItemClass* FwdRangingZonesMenuItem;
+
+	TFTMenuClass* ChartsMenu;			// TEL page menu
+	MenuItemClass* ChartSpanMenuItem;
 
 	TFTMenuClass* HDGPageMenu;			// HDG page menu
 	MenuItemClass* HDGHoldMenuItem;
@@ -194,6 +218,8 @@ public:
 	MenuItemClass* STPositionMenuItem;
 
 	TFTMenuClass* WPTPageMenu;			// WPT page menu
+	MenuItemClass* WaypointXMenuItem;
+	MenuItemClass* WaypointYMenuItem;
 	MenuItemClass* DirectToMenuItem;
 
 	TFTMenuClass* SEQPageMenu;			// SEQ page menu
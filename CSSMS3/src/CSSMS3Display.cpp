@@ -34,8 +34,10 @@ void CSSMS3Display::GetTimeString(uint64_t msTime, String* timeString)
 
 void CSSMS3Display::DrawPageHeaderAndFooter()
 {
-	// Clear display:
+	// Clear display (the footer menu is pushed straight to the panel):
+	tft.ReleasePanelAreas();
 	tft.fillScreen(TFT_BLACK);
+	tft.ReservePanelArea(FooterMenuX, FooterMenuY, FooterMenuWidth, FooterMenuHeight);
 
 	// Draw header:
 	tft.setTextSize(1);
@@ -53,6 +55,43 @@ void CSSMS3Display::DrawPageHeaderAndFooter()
 	tft.setTextDatum(TR_DATUM);
 	tft.drawString(ComModeHeadings[CSSMS3Status.ComMode], tft.width() - 2, 2);
 
+	BatteryWarningShown = false;
+}
+
+/// <summary>
+/// Flashes a low battery banner over the page title while either MRS UPS 3S pack is near brown-out,
+/// restoring the title when the condition clears
+/// </summary>
+void CSSMS3Display::DrawBatteryWarning()
+{
+	bool phase = (millis() / 500) % 2;
+
+	if (!CSSMS3Status.LowBatteryWarning && !BatteryWarningShown)
+	{
+		return;
+	}
+	if (CSSMS3Status.LowBatteryWarning && BatteryWarningShown && phase == BatteryWarningPhase)
+	{
+		return;
+	}
+
+	tft.fillRect(tft.width() / 2 - 60, 0, 120, 12, TFT_BLACK);
+	tft.setTextSize(1);
+	tft.setTextDatum(TC_DATUM);
+	if (CSSMS3Status.LowBatteryWarning && phase)
+	{
+		tft.setTextColor(TFT_RED, TFT_BLACK, true);
+		sprintf(buf, "LOW BAT L%2.0F%% R%2.0F%%", CSSMS3Status.mrsSensorPacket.INA219SOC, CSSMS3Status.mrsSensorPacket.RINA219SOC);
+	}
+	else
+	{
+		tft.setTextColor(TFT_SKYBLUE, TFT_BLACK, false);
+		sprintf(buf, "%s", PageTitles[currentPage]);
+	}
+	tft.drawString(buf, tft.width() / 2, 2);
+
+	BatteryWarningShown = CSSMS3Status.LowBatteryWarning;
+	BatteryWarningPhase = phase;
 }
 
 void CSSMS3Display::DrawDashboard(int32_t xTC, int32_t yTC, bool showDriveData, bool showProximityData, bool showHDGBox, bool showCRSBox)
@@ -270,6 +309,37 @@ void CSSMS3Display::DrawCOMPage()
 	sprintf(buf, "%s %5d", "Downlink retries", CSSMS3Status.SendRetries);
 	tft.drawString(buf, tft.width() / 2, 60);
 
+	tft.setTextColor(TFT_CYAN, TFT_BLACK, true);
+	sprintf(buf, "Scan %5u %4u ms %4u B", CSSMS3Status.ScanAssembler.GetLatestScanID(),
+		CSSMS3Status.ScanAssembler.LastLatency, CSSMS3Status.ScanAssembler.BytesPerScan);
+	tft.drawString(buf, tft.width() / 2, 70);
+	sprintf(buf, "%s %5d", "Scan chunks lost", CSSMS3Status.ScanAssembler.ChunksLost);
+	tft.drawString(buf, tft.width() / 2, 80);
+	sprintf(buf, "%s %5d", "Map tiles       ", CSSMS3Status.MapTilesReceived);
+	tft.drawString(buf, tft.width() / 2, 90);
+
+	// Clock synchronisation residual and the age of the last sensor packet on the shared clock:
+	tft.setTextColor(CSSMS3Status.Clock.IsSynchronised() ? TFT_GREEN : TFT_ORANGE, TFT_BLACK, true);
+	sprintf(buf, "Clk %+6ld us age %4ld ms ", (long)CSSMS3Status.Clock.ResidualOffset,
+		(long)((CSSMS3Status.Clock.GetSharedTime() - CSSMS3Status.mrsSensorPacket.Timestamp) / 1000));
+	tft.drawString(buf, tft.width() / 2, 100);
+
+	// ESP-NOW link quality (see LinkMonitor.h) as seen from this end (left) and as last reported by the MCC (top
+	//right): score, RSSI (dBm), loss and send failure rates, mean interval, jitter and interval histogram (% per bin):
+	LinkMonitorClass& link = CSSMS3Status.Link;
+	tft.setTextColor(link.Score >= 50 ? TFT_GREEN : TFT_ORANGE, TFT_BLACK, true);
+	sprintf(buf, "Q%3u R%4ld L%5.1f%% F%5.1f%%", link.Score, link.RSSIValid ? lroundf(link.RSSI) : 0L,
+		link.LossRate * 100.0f, link.FailRate * 100.0f);
+	tft.drawString(buf, 2, 50);
+	sprintf(buf, "Int %5.1f Jit %5.1f ms", link.MeanInterval, link.Jitter);
+	tft.drawString(buf, 2, 60);
+	tft.drawString(link.GetHistogramString(), tft.width() / 2, 110);
+
+	const LinkStatsPacket& remote = CSSMS3Status.MCCLinkStats;
+	tft.setTextColor(CSSMS3Status.MCCLinkStatsReceivedCount == 0 ? TFT_DARKGREY : remote.Score >= 50 ? TFT_GREEN : TFT_ORANGE,
+		TFT_BLACK, true);
+	sprintf(buf, "MCC Q%3u R%4d L%5.1f%%", remote.Score, remote.RSSI, remote.LossRate * 100.0f);
+	tft.drawString(buf, tft.width() / 2, 30);
 
 }
 
@@ -280,6 +350,7 @@ void CSSMS3Display::DrawDBGPage()
 	if (lastPage != currentPage)
 	{
 		DrawPageHeaderAndFooter();
+		tft.ReservePanelArea(DBGMenuX, FooterMenuY, FooterMenuX - DBGMenuX, FooterMenuHeight);
 
 		int32_t halfScreenWidth = tft.width() / 2;
 		int32_t halfScreenHeight = tft.height() / 2;
@@ -369,6 +440,9 @@ void CSSMS3Display::DrawDBGPage()
 	// Update dynamic displays:
 	//DrawDashboard(tft.width() / 2, tft.height() - 50, false);
 
+	tft.setTextColor(TFT_SILVER, TFT_BLACK, true);
+	tft.setTextDatum(CL_DATUM);
+	tft.drawString(tft.GetStatusString(), 2, tft.height() / 2 + 60);
 
 }
 
@@ -391,9 +465,9 @@ void CSSMS3Display::DrawSENPage()
 
 
 		// Draw footer menu:
-		if (cssmS3Controls.MainMenu != nullptr)
+		if (cssmS3Controls.SENPageMenu != nullptr)
 		{
-			cssmS3Controls.MainMenu->Draw();
+			cssmS3Controls.SENPageMenu->Draw();
 		}
 
 		lastPage = currentPage;
@@ -451,6 +525,10 @@ void CSSMS3Display::DrawMRSPage()
 		tft.drawString("Current", cursorX, cursorY);
 		cursorY += 10;
 		tft.drawString("Power", cursorX, cursorY);
+		cursorY += 10;
+		tft.drawString("SOC", cursorX, cursorY);
+		cursorY += 10;
+		tft.drawString("Runtime", cursorX, cursorY);
 
 		cursorX = tft.width() / 2 + 15;
 		cursorY = 20;
@@ -460,6 +538,10 @@ void CSSMS3Display::DrawMRSPage()
 		tft.drawString("Current", cursorX, cursorY);
 		cursorY += 10;
 		tft.drawString("Power", cursorX, cursorY);
+		cursorY += 10;
+		tft.drawString("SOC", cursorX, cursorY);
+		cursorY += 10;
+		tft.drawString("Runtime", cursorX, cursorY);
 
 		// Draw footer menu:
 		if (cssmS3Controls.MainMenu != nullptr)
@@ -487,6 +569,19 @@ void CSSMS3Display::DrawMRSPage()
 	cursorY += 10;
 	sprintf(buf, "%5.0F mW", CSSMS3Status.mrsSensorPacket.INA219Power);
 	tft.drawString(buf, cursorX, cursorY);	// Right justified
+	cursorY += 10;
+	sprintf(buf, "%5.1F  %%", CSSMS3Status.mrsSensorPacket.INA219SOC);
+	tft.drawString(buf, cursorX, cursorY);	// Right justified
+	cursorY += 10;
+	if (CSSMS3Status.mrsSensorPacket.INA219Runtime < 0.0f)
+	{
+		sprintf(buf, "  --- min");
+	}
+	else
+	{
+		sprintf(buf, "%5.0F min", CSSMS3Status.mrsSensorPacket.INA219Runtime);
+	}
+	tft.drawString(buf, cursorX, cursorY);	// Right justified
 
 	tft.setTextColor(TFT_GREEN, TFT_BLACK, true);
 	cursorX = tft.width() - 5;
@@ -499,6 +594,68 @@ void CSSMS3Display::DrawMRSPage()
 	cursorY += 10;
 	sprintf(buf, "%5.0F mW", CSSMS3Status.mrsSensorPacket.RINA219Power);
 	tft.drawString(buf, cursorX, cursorY);	// Right justified
+	cursorY += 10;
+	sprintf(buf, "%5.1F  %%", CSSMS3Status.mrsSensorPacket.RINA219SOC);
+	tft.drawString(buf, cursorX, cursorY);	// Right justified
+	cursorY += 10;
+	if (CSSMS3Status.mrsSensorPacket.RINA219Runtime < 0.0f)
+	{
+		sprintf(buf, "  --- min");
+	}
+	else
+	{
+		sprintf(buf, "%5.0F min", CSSMS3Status.mrsSensorPacket.RINA219Runtime);
+	}
+	tft.drawString(buf, cursorX, cursorY);	// Right justified
+}
+
+/// <summary>
+/// Strip charts of track speed against setting, track currents, UPS bus voltages and forward range
+/// </summary>
+void CSSMS3Display::DrawTELPage()
+{
+	currentPage = TEL;
+
+	if (lastPage != currentPage)
+	{
+		// Clear display and redraw static elements of the page format:
+		DrawPageHeaderAndFooter();
+
+		SpeedChart.DrawFrame();
+		CurrentChart.DrawFrame();
+		BatteryChart.DrawFrame();
+		RangeChart.DrawFrame();
+
+		// Span shown, left of the footer menu:
+		uint32_t span = ChartHistorySize * ChartSampleInterval / 1000 * CSSMS3Status.SpeedHistory.GetSamplesPerBucket(ChartLevel);
+		if (span < 60)
+		{
+			sprintf(buf, "%lus", (unsigned long)span);
+		}
+		else
+		{
+			sprintf(buf, "%lum", (unsigned long)(span / 60));
+		}
+		tft.setTextSize(1);
+		tft.setTextColor(TFT_SILVER, TFT_BLACK, true);
+		tft.setTextDatum(CL_DATUM);
+		tft.drawString(buf, 2, FooterMenuY + FooterMenuHeight / 2);
+
+		// Draw footer menu:
+		if (cssmS3Controls.ChartsMenu != nullptr)
+		{
+			cssmS3Controls.ChartsMenu->Draw();
+		}
+
+		lastPage = currentPage;
+		lastSystemPage = currentPage;
+	}
+
+	// Update dynamic displays:
+	SpeedChart.Update();
+	CurrentChart.Update();
+	BatteryChart.Update();
+	RangeChart.Update();
 }
 
 void CSSMS3Display::DrawDRVPage()
@@ -509,6 +666,7 @@ void CSSMS3Display::DrawDRVPage()
 	{
 		// Clear display and redraw static elements of the page format:
 		DrawPageHeaderAndFooter();
+		tft.ReservePanelArea(DRVTripMenuX, DRVTripMenuY, DRVTripMenuWidth, DRVTripMenuHeight);
 
 		tft.setTextSize(1);
 
@@ -671,6 +829,10 @@ void CSSMS3Display::DrawWPTPage()
 {
 	currentPage = WPT;
 
+	MRSSensorPacket& sensors = CSSMS3Status.mrsSensorPacket;
+	TrailMap.SetWaypoint(CSSMS3Status.cssmDrivePacket.WaypointValid, CSSMS3Status.cssmDrivePacket.WaypointX,
+		CSSMS3Status.cssmDrivePacket.WaypointY);
+
 	if (lastPage != currentPage)
 	{
 		// Clear display and redraw static elements of the page format:
@@ -678,11 +840,12 @@ void CSSMS3Display::DrawWPTPage()
 
 		tft.setTextSize(1);
 
+		TrailMap.DrawFrame(sensors.ODOSPosX, sensors.ODOSPosY, sensors.ODOSHdg);
 
 		// Draw footer menu:
-		if (cssmS3Controls.MainMenu != nullptr)
+		if (cssmS3Controls.WPTPageMenu != nullptr)
 		{
-			cssmS3Controls.MainMenu->Draw();
+			cssmS3Controls.WPTPageMenu->Draw();
 		}
 
 		lastPage = currentPage;
@@ -690,6 +853,8 @@ void CSSMS3Display::DrawWPTPage()
 
 	// Update dynamic displays:
 
+	TrailMap.Update(sensors.ODOSPosX, sensors.ODOSPosY, sensors.ODOSHdg);
+
 	DrawDashboard(tft.width() / 2, tft.height() - 50);
 
 
@@ -699,6 +864,10 @@ void CSSMS3Display::DrawSEQPage()
 {
 	currentPage = SEQ;
 
+	MRSSensorPacket& sensors = CSSMS3Status.mrsSensorPacket;
+	TrailMap.SetWaypoint(CSSMS3Status.cssmDrivePacket.WaypointValid, CSSMS3Status.cssmDrivePacket.WaypointX,
+		CSSMS3Status.cssmDrivePacket.WaypointY);
+
 	if (lastPage != currentPage)
 	{
 		// Clear display and redraw static elements of the page format:
@@ -706,6 +875,7 @@ void CSSMS3Display::DrawSEQPage()
 
 		tft.setTextSize(1);
 
+		TrailMap.DrawFrame(sensors.ODOSPosX, sensors.ODOSPosY, sensors.ODOSHdg);
 
 		// Draw footer menu:
 		if (cssmS3Controls.MainMenu != nullptr)
@@ -718,6 +888,8 @@ void CSSMS3Display::DrawSEQPage()
 
 	// Update dynamic displays:
 
+	TrailMap.Update(sensors.ODOSPosX, sensors.ODOSPosY, sensors.ODOSHdg);
+
 	DrawDashboard(tft.width() / 2, tft.height() - 50);
 
 
@@ -726,6 +898,7 @@ void CSSMS3Display::DrawSEQPage()
 void CSSMS3Display::DrawNONEPage()
 {
 	currentPage = NONE;
+	tft.ReleasePanelAreas();
 	tft.fillScreen(TFT_BLACK);
 	lastPage = NONE;
 }
@@ -737,8 +910,13 @@ bool CSSMS3Display::Init()
 	pinMode(LCD_POWER_ON, OUTPUT);
 	digitalWrite(LCD_POWER_ON, HIGH);
 
-	tft.init();
-	tft.setRotation(3);
+	Panel.init();
+	Panel.setRotation(3);
+	Panel.fillScreen(TFT_BLACK);
+	if (!tft.Init())
+	{
+		return false;
+	}
 
 	//Control(CSSMS3Display::Commands::SYSPage);
 	cssmS3Display.Control(CSSMS3Display::Commands::DBGPage);
@@ -758,6 +936,35 @@ bool CSSMS3Display::Init()
 	RTrackBarGauge.SetLimits(-7500.0f, 7500.0f);
 	RTrackBarGauge.SetPowerLimit(1.0f);
 
+	// Strip charts for the TEL page, 100 columns wide to show every bucket of the histories:
+	SpeedChart.Init(&tft, 40, 15, 200, 31);
+	SpeedChart.SetLabel("Spd qpps");
+	SpeedChart.SetLimits(-7500.0f, 7500.0f);
+	SpeedChart.AddTrace(&CSSMS3Status.SpeedSettingHistory, TFT_ORANGE);
+	SpeedChart.AddTrace(&CSSMS3Status.SpeedHistory, TFT_GREEN);
+
+	CurrentChart.Init(&tft, 40, 50, 200, 31);
+	CurrentChart.SetLabel("L/R Trk A");
+	CurrentChart.SetValueFormat("%6.2f");
+	CurrentChart.SetLimits(0.0f, 5.0f);
+	CurrentChart.AddTrace(&CSSMS3Status.LTrackCurrentHistory, TFT_CYAN);
+	CurrentChart.AddTrace(&CSSMS3Status.RTrackCurrentHistory, TFT_GREEN);
+
+	BatteryChart.Init(&tft, 40, 85, 200, 31);
+	BatteryChart.SetLabel("L/R UPS V");
+	BatteryChart.SetValueFormat("%6.2f");
+	BatteryChart.SetLimits(9.0f, 12.6f);
+	BatteryChart.AddTrace(&CSSMS3Status.LBatteryHistory, TFT_RED);
+	BatteryChart.AddTrace(&CSSMS3Status.RBatteryHistory, TFT_GREEN);
+
+	RangeChart.Init(&tft, 40, 120, 200, 31);
+	RangeChart.SetLabel("Range mm");
+	RangeChart.SetLimits(0.0f, 4000.0f);
+	RangeChart.AddTrace(&CSSMS3Status.RangeHistory, TFT_YELLOW);
+
+	// Moving map for the WPT and SEQ pages, between the header and the dashboard:
+	TrailMap.Init(&tft, &CSSMS3Status.Map, &CSSMS3Status.PoseTrail, 2, 13, 316, 104);
+
 	return true;
 }
 
@@ -768,6 +975,14 @@ bool CSSMS3Display::Test()
 
 void CSSMS3Display::Update()
 {
+	// Hold the page while a snapshot of it is being sent:
+	if (SnapshotSending)
+	{
+		return;
+	}
+
+	tft.BeginFrame();
+
 	switch (currentPage)
 	{
 	case SYS:
@@ -785,6 +1000,9 @@ void CSSMS3Display::Update()
 	case MRS:
 		DrawMRSPage();
 		break;
+	case TEL:
+		DrawTELPage();
+		break;
 	case DRV:
 		DrawDRVPage();
 		break;
@@ -801,6 +1019,15 @@ void CSSMS3Display::Update()
 	default:
 		DrawNONEPage();
 	}
+
+	DrawBatteryWarning();
+
+	tft.Flush();
+
+	if (SnapshotPending && currentPage != DBG)
+	{
+		BeginScreenSnapshot();
+	}
 }
 
 void CSSMS3Display::Control(uint8_t command)
@@ -825,6 +1052,9 @@ void CSSMS3Display::Control(uint8_t command)
 	case MRSPage:
 		DrawMRSPage();
 		break;
+	case TELPage:
+		DrawTELPage();
+		break;
 	case DRVPage:
 		DrawDRVPage();
 		break;
@@ -847,6 +1077,8 @@ void CSSMS3Display::Control(uint8_t command)
 	default:
 		break;
 	}
+
+	tft.Flush();
 }
 
 void CSSMS3Display::SetCurrentPage(Pages page)
@@ -927,7 +1159,7 @@ void CSSMS3Display::PrevPage(int /*value*/)
 	{
 		if (currentPage <= CSSMS3Display::Pages::SYS)
 		{
-			currentPage = CSSMS3Display::Pages::MRS;
+			currentPage = CSSMS3Display::Pages::TEL;
 		}
 		else
 		{
@@ -955,7 +1187,7 @@ void CSSMS3Display::NextPage(int /*value*/)
 	}
 	else
 	{
-		if (currentPage >= CSSMS3Display::Pages::MRS)
+		if (currentPage >= CSSMS3Display::Pages::TEL)
 		{
 			currentPage = CSSMS3Display::Pages::SYS;
 		}
@@ -968,9 +1200,10 @@ void CSSMS3Display::NextPage(int /*value*/)
 	}
 }
 
+/// <returns>The panel itself, for widgets that push their own sprites (the menus); pages draw to the renderer</returns>
 TFT_eSPI* CSSMS3Display::GetTFT()
 {
-	return &tft;
+	return &Panel;
 }
 
 byte CSSMS3Display::GetDisplayBrightness()
@@ -999,6 +1232,68 @@ void CSSMS3Display::ReportHeapStatus(int /*value*/)
 	cssmS3Display.RefreshPage(CSSMS3Display::Pages::DBG);
 }
 
+/// <summary>
+/// Requests a snapshot of the next page shown after the DBG page (see WriteScreenSnapshot())
+/// </summary>
+void CSSMS3Display::RequestScreenSnapshot(int /*value*/)
+{
+	cssmS3Display.SnapshotPending = true;
+	cssmS3Display.AddDebugTextLine("Snapshot on next page");
+}
+
+/// <summary>
+/// Steps the strip charts through their spans (history levels): 10 s, 1 min and 10 min
+/// </summary>
+void CSSMS3Display::NextChartSpan(int /*value*/)
+{
+	cssmS3Display.ChartLevel = (cssmS3Display.ChartLevel + 1) % ChartHistoryLevels;
+	cssmS3Display.SpeedChart.SetLevel(cssmS3Display.ChartLevel);
+	cssmS3Display.CurrentChart.SetLevel(cssmS3Display.ChartLevel);
+	cssmS3Display.BatteryChart.SetLevel(cssmS3Display.ChartLevel);
+	cssmS3Display.RangeChart.SetLevel(cssmS3Display.ChartLevel);
+	cssmS3Display.RefreshPage(TEL);
+}
+
+/// <summary>
+/// Starts sending the current page over Serial as a PPM image (see TileRenderer::WriteSnapshot()), after a line giving
+/// the page and its frame hash, which is also added to the debug text.  The image itself is sent by
+/// SendScreenSnapshotChunk(); the page is not redrawn until it has all been sent.
+/// </summary>
+void CSSMS3Display::BeginScreenSnapshot()
+{
+	sprintf(buf, "Snapshot %s %08lX", (currentPage < NONE) ? PageTitles[currentPage] : "None", (unsigned long)tft.GetFrameHash());
+	Serial.println(buf);
+	CSSMS3Status.AddDebugTextLine(buf);
+	tft.BeginSnapshot();
+	SnapshotPending = false;
+	SnapshotSending = true;
+}
+
+/// <summary>
+/// Sends as much of the snapshot as Serial can take without blocking; called from a task of its own while
+/// IsSendingSnapshot()
+/// </summary>
+/// <returns>True while there is more to send</returns>
+bool CSSMS3Display::SendScreenSnapshotChunk()
+{
+	if (!SnapshotSending)
+	{
+		return false;
+	}
+
+	int room = Serial.availableForWrite();
+	if (room > 0 && tft.WriteSnapshotChunk(Serial, min(room, MaxSnapshotChunk)))
+	{
+		SnapshotSending = false;
+	}
+	return SnapshotSending;
+}
+
+bool CSSMS3Display::IsSendingSnapshot()
+{
+	return SnapshotSending;
+}
+
 void CSSMS3Display::ShowFontTableFixed(int /*value*/)
 {
 	cssmS3Display.ShowingFontTable = !cssmS3Display.ShowingFontTable;
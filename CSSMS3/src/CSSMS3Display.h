@@ -23,8 +23,23 @@
 #include "CSSMS3Status.h"
 #include <TFT_eSPI.h>
 #include "BarGauge.h"
+#include "StripChart.h"
+#include "MapView.h"
+#include "TileRenderer.h"
 
 constexpr byte DefaultDisplayBrightness = 128;
+constexpr int MaxSnapshotChunk = 1024;				// bytes; most of a screen snapshot sent per SendScreenSnapshotChunk()
+
+// Panel areas the CSSMS3Controls menus push their items to directly (see TileRenderer::ReservePanelArea()):
+constexpr int32_t FooterMenuX = 36;				// ESPN (or HOLD) to Next
+constexpr int32_t FooterMenuY = 157;
+constexpr int32_t FooterMenuWidth = 248;
+constexpr int32_t FooterMenuHeight = 12;
+constexpr int32_t DBGMenuX = 2;					// Mem, left of the footer menu on the DBG page
+constexpr int32_t DRVTripMenuX = 2;				// T1RST & T2RST on the DRV page
+constexpr int32_t DRVTripMenuY = 90;
+constexpr int32_t DRVTripMenuWidth = 48;
+constexpr int32_t DRVTripMenuHeight = 40;
 
 class CSSMS3Display
 {
@@ -36,6 +51,7 @@ public:
 		DBG,
 		SEN,
 		MRS,
+		TEL,
 
 		DRV,
 		HDG,
@@ -48,12 +64,20 @@ public:
 protected:
 	char buf[64];
 
-	TFT_eSPI tft = TFT_eSPI();
+	TFT_eSPI Panel = TFT_eSPI();
+	TileRenderer tft{ &Panel };					// Pages are drawn off-screen and pushed to the Panel by Update()
 
 	BarGauge LTrackBarGauge;
 	BarGauge MRSTrackBarGauge;
 	BarGauge RTrackBarGauge;
 
+	StripChart SpeedChart;
+	StripChart CurrentChart;
+	StripChart BatteryChart;
+	StripChart RangeChart;
+	uint8_t ChartLevel = 0;						// History level (span) shown by the strip charts
+	MapView TrailMap;							// Moving map of the WPT and SEQ pages
+
 	static byte Brightness;
 
 	static Pages currentPage;
@@ -67,6 +91,7 @@ protected:
 		"Debug",
 		"Sensors",
 		"MRS",
+		"Charts",
 
 		"Drive",
 		"Heading",
@@ -98,22 +123,29 @@ protected:
 	};
 
 	bool ShowingFontTable = false;
+	bool BatteryWarningShown = false;			// Low battery banner is currently drawn over the page title
+	bool BatteryWarningPhase = false;			// Banner flash phase
+	bool SnapshotPending = false;
+	bool SnapshotSending = false;				// Page is held until its snapshot has been sent
 
 	void GetTimeString(uint64_t msTime, String* timeString);
 
 	void DrawPageHeaderAndFooter();
+	void DrawBatteryWarning();
 	void DrawDashboard(int32_t xTC, int32_t yTC, bool showDriveData = true, bool showProximityData = true, bool showHDGBox = true, bool showCRSBox = true);
 	void DrawSYSPage();
 	void DrawCOMPage();
 	void DrawDBGPage();
 	void DrawSENPage();
 	void DrawMRSPage();
+	void DrawTELPage();
 	void DrawDRVPage();
 	void DrawHDGPage();
 	void DrawWPTPage();
 	void DrawSEQPage();
 
 	void DrawNONEPage();
+	void BeginScreenSnapshot();
 
 
 public:
@@ -126,6 +158,7 @@ public:
 		DBGPage,
 		SENPage,
 		MRSPage,
+		TELPage,
 		DRVPage,
 		HDGPage,
 		WPTPage,
@@ -158,6 +191,10 @@ public:
 
 	void AddDebugTextLine(String newLine);
 	static void ReportHeapStatus(int value);
+	static void RequestScreenSnapshot(int value);
+	bool SendScreenSnapshotChunk();
+	bool IsSendingSnapshot();
+	static void NextChartSpan(int value);
 	static void ShowFontTableFixed(int value);
 	void ShowFontTable(int32_t xTL, int32_t yTL);
 
@@ -7,11 +7,85 @@
 
 void CSSMS3StatusClass::Init()
 {
+	PoseHistory.SetWindow(PoseHistoryWindow);
+
+	ChartHistory* histories[] = { &SpeedHistory, &SpeedSettingHistory, &LTrackCurrentHistory, &RTrackCurrentHistory,
+		&LBatteryHistory, &RBatteryHistory, &RangeHistory };
+	for (ChartHistory* history : histories)
+	{
+		history->SetFactor(1, 6);
+		history->SetFactor(2, 10);
+	}
+	LastChartSampleTime = millis();
+	Link.Init(MCCStatusPacketInterval);
 }
 
 void CSSMS3StatusClass::Update()
 {
 	MRSMCCESPNOWLinkStatus = (MRSMCCPacketReceivedCount != SaveMRSMCCPacketReceivedCount);
+	Link.Update(millis());
+
+	PolarScanChunkPacket chunk;
+	while (ScanChunkQueue.Pop(chunk))
+	{
+		ScanAssembler.AddChunk(chunk);
+	}
+	ScanAssembler.Update();
+
+	OccupancyTilePacket tile;
+	while (MapTileQueue.Pop(tile))
+	{
+		Map.ApplyTile(tile);
+		MapTilesReceived++;
+	}
+
+	if (MRSSensorPacketReceivedCount > 0 && mrsSensorPacket.Timestamp > PoseHistory.GetNewestTime())
+	{
+		PoseHistory.Add(mrsSensorPacket.Timestamp, { mrsSensorPacket.ODOSPosX, mrsSensorPacket.ODOSPosY, mrsSensorPacket.ODOSHdg });
+		PoseTrail.Add(mrsSensorPacket.ODOSPosX, mrsSensorPacket.ODOSPosY);
+	}
+
+	// Sampled on a fixed schedule whether or not new telemetry has arrived, so the charts keep time; a late call
+	//catches up (repeating the latest values) unless it is so late that the schedule is restarted:
+	uint32_t now = millis();
+	if (now - LastChartSampleTime > 10 * ChartSampleInterval)
+	{
+		LastChartSampleTime = now - ChartSampleInterval;
+	}
+	while (now - LastChartSampleTime >= ChartSampleInterval)
+	{
+		LastChartSampleTime += ChartSampleInterval;
+		SampleChartHistories();
+	}
+
+	// Replies to earlier requests (e.g. delayed by a retry) would be counted with the wrong round trip:
+	TimeSyncReply reply;
+	while (TimeSyncQueue.Pop(reply))
+	{
+		if (reply.Packet.Sequence == TimeSyncSequence)
+		{
+			Clock.AddExchange(reply.Packet.OriginateTime, reply.Packet.ReceiveTime, reply.Packet.TransmitTime,
+				reply.DestinationTime);
+		}
+	}
+
+	// Warn of an impending brown-out on either pack (runtime is negative while a pack is not discharging):
+	LowBatteryWarning = (MRSSensorPacketReceivedCount > 0)
+		&& ((mrsSensorPacket.INA219SOC < LowBatterySOCThreshold)
+			|| (mrsSensorPacket.RINA219SOC < LowBatterySOCThreshold)
+			|| (mrsSensorPacket.INA219Runtime >= 0.0f && mrsSensorPacket.INA219Runtime < LowBatteryRuntimeThreshold)
+			|| (mrsSensorPacket.RINA219Runtime >= 0.0f && mrsSensorPacket.RINA219Runtime < LowBatteryRuntimeThreshold));
+}
+
+void CSSMS3StatusClass::SampleChartHistories()
+{
+	SpeedHistory.Add((mcStatus.M1Speed + mcStatus.M2Speed) / 2.0f);
+	SpeedSettingHistory.Add((mcStatus.M1SpeedSetting + mcStatus.M2SpeedSetting) / 2.0f);
+	LTrackCurrentHistory.Add(mcStatus.M2Current);
+	RTrackCurrentHistory.Add(mcStatus.M1Current);
+	LBatteryHistory.Add(mrsSensorPacket.INA219VBus);
+	RBatteryHistory.Add(mrsSensorPacket.RINA219VBus);
+	RangeHistory.Add(mrsSensorPacket.FWDVL53L1XRange);
 }
 
 void CSSMS3StatusClass::AddDebugTextLine(String newLine)
@@ -21,12 +21,35 @@
 #endif
 
 constexpr uint8_t MAX_DEBUG_TEXT_LINES = 14;
+constexpr uint32_t PoseHistoryWindow = 60000;		// ms
+constexpr uint16_t ChartHistorySize = 100;			// Buckets per level of each strip chart history
+constexpr uint8_t ChartHistoryLevels = 3;
+constexpr uint32_t ChartSampleInterval = 100;		// ms; with factors of 1, 6 and 10 the levels cover 10 s, 1 min and 10 min
+constexpr uint16_t RobotTrailSize = 256;			// Points; older parts of the trail are simplified to stay within this
+constexpr float RobotTrailSpacing = 0.02f;			// m; minimum distance between trail points
+constexpr float RobotTrailTolerance = 0.01f;		// m; initial simplification tolerance
+constexpr float MCCStatusPacketInterval = 150.0f;	// ms; nominal period of the MCC's RC2x15AMCStatusPackets
 
 #include "C:\Repos\MRS-VS2022\MRSCommon\src\CSSMDrivePacket.h"
 #include "C:\Repos\MRS-VS2022\MRSCommon\src\CSSMCommandPacket.h"
 #include "C:\Repos\MRS-VS2022\MRSCommon\src\RC2x15AMCStatusPacket.h"
 #include "C:\Repos\MRS-VS2022\MRSCommon\src\MRSStatusPacket.h"
 #include "C:\Repos\MRS-VS2022\MRSCommon\src\MRSSensorPacket.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\PolarScanAssembler.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\OccupancyGrid.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\SPSCQueue.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\BatteryFuelGauge.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\TimeSyncPacket.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\ClockSync.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\TimeHistory.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\MinMaxHistory.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\Trail.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\LinkMonitor.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\LinkStatsPacket.h"
+
+typedef MinMaxHistory<ChartHistorySize, ChartHistoryLevels> ChartHistory;
+typedef OccupancyGrid<8> MapGrid;
+typedef Trail<RobotTrailSize> RobotTrail;
 
 class CSSMS3StatusClass
 {
@@ -49,6 +72,35 @@ public:
 	RC2x15AMCStatusPacket mcStatus;
 	MRSStatusPacket mrsStatusPacket;
 	MRSSensorPacket mrsSensorPacket;
+	SPSCQueue<PolarScanChunkPacket, 8> ScanChunkQueue;	// Polar scan chunks from the ESP-NOW receive callback
+	PolarScanAssemblerClass ScanAssembler;
+	SPSCQueue<OccupancyTilePacket, 8> MapTileQueue;		// Changed MCC map tiles from the ESP-NOW receive callback
+	MapGrid Map;										// Copy of the MCC occupancy grid, built from its tiles
+	uint32_t MapTilesReceived = 0;
+
+	// Time sync replies from the MCC, stamped on receipt (us) by the ESP-NOW receive callback:
+	struct TimeSyncReply
+	{
+		TimeSyncPacket Packet;
+		int64_t DestinationTime;
+	};
+	SPSCQueue<TimeSyncReply, 4> TimeSyncQueue;
+	ClockSyncClass Clock;								// Maps this module's clock onto the MCC's (shared) clock
+	uint8_t TimeSyncSequence = 0;						// Sequence number of the last request sent
+
+	// OTOS pose from each new MRSSensorPacket, on the shared clock (see TimeHistory.h):
+	TimeHistory<HistoryPose, 128> PoseHistory;
+	RobotTrail PoseTrail = RobotTrail(RobotTrailSpacing, RobotTrailTolerance);	// OTOS positions for the map page
+
+	// Telemetry sampled every ChartSampleInterval for the strip charts (see MinMaxHistory.h):
+	ChartHistory SpeedHistory;							// qpps; mean of the track speeds
+	ChartHistory SpeedSettingHistory;					// qpps; mean of the track speed settings
+	ChartHistory LTrackCurrentHistory;					// A; M2
+	ChartHistory RTrackCurrentHistory;					// A; M1
+	ChartHistory LBatteryHistory;						// V; LUPS bus
+	ChartHistory RBatteryHistory;						// V; RUPS bus
+	ChartHistory RangeHistory;							// mm; forward VL53L1X
+	uint32_t LastChartSampleTime = 0;					// ms
 
 	enum ComModes
 	{
@@ -75,9 +127,15 @@ public:
 
 	uint32_t MRSMCCPacketReceivedCount = 0;		// Running count of telemetry packets received from the MRS MCC (not used?)
 	uint32_t SaveMRSMCCPacketReceivedCount = 0;	// (not used?)
+	uint32_t MRSSensorPacketReceivedCount = 0;	// Running count of MRSSensorPackets received from the MRS MCC
 	uint64_t MCCPacketReceiptInterval = 0;		// Time in ms between receipt of the last two telemetry packets from the MRS MCC 
 	uint64_t LastMCCPacketReceivedTime = 0;		// Used to calculate interval between receipt of telemetry packets from he MRS MCC
 	bool MRSMCCESPNOWLinkStatus = false;		// Flag indicating the state of health of the telemetry uplink from the MRS to the CSSM
+	LinkMonitorClass Link;						// This end's view of the ESP-NOW link (see LinkMonitor.h)
+	LinkStatsPacket MCCLinkStats;				// The MCC's view of the link, as last reported by it
+	uint32_t MCCLinkStatsReceivedCount = 0;
+
+	bool LowBatteryWarning = false;				// Either MRS UPS 3S pack is below the SOC or runtime warning threshold
 	
 	bool WiFiStatus = false;
 	 
@@ -99,6 +157,7 @@ public:
 	void Update();
 	void AddDebugTextLine(String newLine);
 	void ClearDebugText();
+	void SampleChartHistories();
 
 };
 
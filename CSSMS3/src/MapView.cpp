@@ -0,0 +1,434 @@
+/*	MapView.cpp
+*	MapView - Helper class to draw a moving map of the robot's trail, waypoint and the MCC occupancy grid
+*
+*/
+
+#include "MapView.h"
+
+/// <summary>
+/// Sets the map area (inside a one pixel frame) and the grid and trail it shows
+/// </summary>
+bool MapView::Init(TileRenderer* _tft, const MapGrid* map, const RobotTrail* path, int32_t x, int32_t y, int32_t w, int32_t h)
+{
+	tft = _tft;
+	Map = map;
+	Path = path;
+	X = x;
+	Y = y;
+	W = w;
+	H = h;
+	MapDrawn = false;
+	MarkerDrawn = false;
+	memset(DrawnTileValid, 0, sizeof(DrawnTileValid));
+	return (tft != nullptr && Map != nullptr && Path != nullptr && W > 2 * MapMarkerSize && H > 2 * MapMarkerSize);
+}
+
+/// <summary>
+/// Sets the map scale; the map is redrawn by the next Update()
+/// </summary>
+void MapView::SetScale(int32_t mmPerPixel)
+{
+	if (mmPerPixel > 0 && mmPerPixel != Scale)
+	{
+		Scale = mmPerPixel;
+		MapDrawn = false;
+	}
+}
+
+/// <summary>
+/// Sets the waypoint shown (e.g. the commanded WPT mode waypoint); drawn, moved or removed by the next Update()
+/// </summary>
+/// <param name="x">m, OTOS frame</param>
+/// <param name="y">m, OTOS frame</param>
+void MapView::SetWaypoint(bool shown, float x, float y)
+{
+	WaypointShown = shown;
+	WaypointXm = x;
+	WaypointYm = y;
+}
+
+int32_t MapView::FloorDiv(int32_t a, int32_t b)
+{
+	return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+int32_t MapView::CeilDiv(int32_t a, int32_t b)
+{
+	return -FloorDiv(-a, b);
+}
+
+/// <summary>
+/// Clips an area of the screen to the map
+/// </summary>
+/// <returns>False if nothing of the area is left</returns>
+bool MapView::ClipToView(int32_t& x, int32_t& y, int32_t& w, int32_t& h)
+{
+	int32_t x1 = min(x + w, X + W);
+	int32_t y1 = min(y + h, Y + H);
+	x = max(x, X);
+	y = max(y, Y);
+	w = x1 - x;
+	h = y1 - y;
+	return (w > 0 && h > 0);
+}
+
+/// <summary>
+/// Draws the grid lines crossing an area of the map; world pixel p is on the line of the grid square holding p * Scale mm
+/// </summary>
+void MapView::DrawGrid(int32_t x, int32_t y, int32_t w, int32_t h)
+{
+	int32_t px0 = ViewX + x - (X + W / 2);
+	int32_t px1 = px0 + w - 1;
+	for (int32_t k = FloorDiv(px0 * Scale, MapGridSpacing); k <= FloorDiv(px1 * Scale, MapGridSpacing) + 1; k++)
+	{
+		int32_t px = CeilDiv(k * MapGridSpacing, Scale);
+		if (px >= px0 && px <= px1)
+		{
+			tft->drawFastVLine(ScreenX(px), y, h, GridColor);
+		}
+	}
+
+	int32_t py1 = ViewY + (Y + H / 2) - y;				// Top row of the area
+	int32_t py0 = py1 - h + 1;
+	for (int32_t k = FloorDiv(py0 * Scale, MapGridSpacing); k <= FloorDiv(py1 * Scale, MapGridSpacing) + 1; k++)
+	{
+		int32_t py = CeilDiv(k * MapGridSpacing, Scale);
+		if (py >= py0 && py <= py1)
+		{
+			tft->drawFastHLine(x, ScreenY(py), w, GridColor);
+		}
+	}
+}
+
+/// <summary>
+/// Draws the known cells of a world tile within an area of the map, joining cells of the same state along each row
+/// </summary>
+void MapView::DrawTileCells(int32_t tx, int32_t ty, int32_t x, int32_t y, int32_t w, int32_t h)
+{
+	// World pixel edges of the tile's columns and rows (pixels belong to the cell holding their centre):
+	int32_t cellSize = Map->GetCellSize();
+	int32_t px[OccupancyTileSide + 1];
+	int32_t py[OccupancyTileSide + 1];
+	for (int32_t i = 0; i <= OccupancyTileSide; i++)
+	{
+		px[i] = CeilDiv((tx * OccupancyTileSide + i) * cellSize, Scale);
+		py[i] = CeilDiv((ty * OccupancyTileSide + i) * cellSize, Scale);
+	}
+
+	int32_t left = ScreenX(px[0]);
+	int32_t top = ScreenY(py[OccupancyTileSide] - 1);
+	if (left >= x + w || left + px[OccupancyTileSide] - px[0] <= x
+		|| top >= y + h || top + py[OccupancyTileSide] - py[0] <= y)
+	{
+		return;
+	}
+
+	for (int32_t j = 0; j < OccupancyTileSide; j++)
+	{
+		int32_t rowTop = ScreenY(py[j + 1] - 1);
+		int32_t rowHeight = py[j + 1] - py[j];
+		if (rowHeight <= 0 || rowTop >= y + h || rowTop + rowHeight <= y)
+		{
+			continue;
+		}
+
+		int32_t i = 0;
+		while (i < OccupancyTileSide)
+		{
+			OccupancyStates state = Map->GetState(tx * OccupancyTileSide + i, ty * OccupancyTileSide + j);
+			int32_t run = i + 1;
+			while (run < OccupancyTileSide && Map->GetState(tx * OccupancyTileSide + run, ty * OccupancyTileSide + j) == state)
+			{
+				run++;
+			}
+			if (state != UnknownCell)
+			{
+				uint16_t color = (state == FreeCell) ? FreeColor : ((state == OccupiedCell) ? OccupiedColor : UncertainColor);
+				tft->fillRect(ScreenX(px[i]), rowTop, px[run] - px[i], rowHeight, color);
+			}
+			i = run;
+		}
+	}
+}
+
+/// <summary>
+/// Draws the trail segments ending at point first and after that cross an area of the map
+/// </summary>
+void MapView::DrawTrail(uint16_t first, int32_t x, int32_t y, int32_t w, int32_t h)
+{
+	uint16_t count = Path->GetCount();
+	if (count < 2)
+	{
+		return;
+	}
+
+	first = max(first, (uint16_t)1);
+	const TrailPoint& start = Path->Get(first - 1);
+	int32_t x0 = ScreenX(ToPixels(start.X));
+	int32_t y0 = ScreenY(ToPixels(start.Y));
+	for (uint16_t i = first; i < count; i++)
+	{
+		const TrailPoint& point = Path->Get(i);
+		int32_t x1 = ScreenX(ToPixels(point.X));
+		int32_t y1 = ScreenY(ToPixels(point.Y));
+		if (max(x0, x1) >= x && min(x0, x1) < x + w && max(y0, y1) >= y && min(y0, y1) < y + h)
+		{
+			tft->drawLine(x0, y0, x1, y1, TrailColor);
+			SegmentsDrawn++;
+		}
+		x0 = x1;
+		y0 = y1;
+	}
+}
+
+void MapView::DrawWaypoint()
+{
+	int32_t x = ScreenX(DrawnWaypointX);
+	int32_t y = ScreenY(DrawnWaypointY);
+	tft->drawCircle(x, y, MapWaypointSize, WaypointColor);
+	tft->drawFastHLine(x - MapWaypointSize + 2, y, 2 * MapWaypointSize - 3, WaypointColor);
+	tft->drawFastVLine(x, y - MapWaypointSize + 2, 2 * MapWaypointSize - 3, WaypointColor);
+}
+
+/// <summary>
+/// Draws everything but the robot marker in an area of the map, clipped to the area
+/// </summary>
+void MapView::DrawRegion(int32_t x, int32_t y, int32_t w, int32_t h)
+{
+	if (!ClipToView(x, y, w, h))
+	{
+		return;
+	}
+
+	tft->setViewport(x, y, w, h, false);
+	tft->fillRect(x, y, w, h, TFT_BLACK);
+	DrawGrid(x, y, w, h);
+
+	int32_t tx;
+	int32_t ty;
+	uint8_t revision;
+	for (uint16_t b = 0; b < MapGrid::BufferTiles; b++)
+	{
+		if (Map->GetBufferTileInfo(b, tx, ty, revision))
+		{
+			DrawTileCells(tx, ty, x, y, w, h);
+		}
+	}
+
+	DrawTrail(1, x, y, w, h);
+	if (WaypointDrawn)
+	{
+		DrawWaypoint();
+	}
+	tft->resetViewport();
+}
+
+void MapView::DrawTileRegion(int32_t tx, int32_t ty)
+{
+	int32_t cellSize = Map->GetCellSize();
+	int32_t px0 = CeilDiv(tx * OccupancyTileSide * cellSize, Scale);
+	int32_t px1 = CeilDiv((tx + 1) * OccupancyTileSide * cellSize, Scale);
+	int32_t py0 = CeilDiv(ty * OccupancyTileSide * cellSize, Scale);
+	int32_t py1 = CeilDiv((ty + 1) * OccupancyTileSide * cellSize, Scale);
+	DrawRegion(ScreenX(px0), ScreenY(py1 - 1), px1 - px0, py1 - py0);
+	TilesDrawn++;
+}
+
+/// <summary>
+/// Records the occupancy tiles drawn and, if draw is set, first redraws those that have changed since they were recorded
+/// </summary>
+void MapView::DrawTiles(bool draw)
+{
+	int32_t tx = 0;
+	int32_t ty = 0;
+	uint8_t revision = 0;
+	for (uint16_t b = 0; b < MapGrid::BufferTiles; b++)
+	{
+		bool valid = Map->GetBufferTileInfo(b, tx, ty, revision);
+		bool moved = DrawnTileValid[b] && (!valid || tx != DrawnTileX[b] || ty != DrawnTileY[b]);
+		bool changed = valid && (!DrawnTileValid[b] || moved || revision != DrawnTileRevision[b]);
+		if (draw)
+		{
+			if (moved)
+			{
+				DrawTileRegion(DrawnTileX[b], DrawnTileY[b]);
+			}
+			if (changed)
+			{
+				DrawTileRegion(tx, ty);
+			}
+		}
+		DrawnTileValid[b] = valid;
+		DrawnTileX[b] = tx;
+		DrawnTileY[b] = ty;
+		DrawnTileRevision[b] = revision;
+	}
+}
+
+/// <summary>
+/// Redraws the whole map centred on the robot
+/// </summary>
+void MapView::DrawMap(int32_t robotX, int32_t robotY)
+{
+	ViewX = robotX;
+	ViewY = robotY;
+	MarkerDrawn = false;
+	DrawnCellSize = Map->GetCellSize();
+	DrawnTrailRevision = Path->Revision;
+	DrawnTrailCount = Path->GetCount();
+	WaypointDrawn = WaypointShown;
+	DrawnWaypointX = ToPixels(WaypointXm);
+	DrawnWaypointY = ToPixels(WaypointYm);
+	DrawTiles(false);
+
+	DrawRegion(X, Y, W, H);
+	MapDrawn = true;
+	FullRedraws++;
+}
+
+/// <summary>
+/// Moves the view by scrolling the map and drawing the strips uncovered
+/// </summary>
+/// <param name="dx">World pixels; positive to move the view east (the map scrolls left)</param>
+/// <param name="dy">World pixels; positive to move the view north (the map scrolls down)</param>
+void MapView::Pan(int32_t dx, int32_t dy)
+{
+	tft->ScrollArea(X, Y, W, H, -dx, dy);
+	ViewX += dx;
+	ViewY += dy;
+
+	if (dx > 0)
+	{
+		DrawRegion(X + W - dx, Y, dx, H);
+	}
+	else if (dx < 0)
+	{
+		DrawRegion(X, Y, -dx, H);
+	}
+	if (dy > 0)
+	{
+		DrawRegion(X, Y, W, dy);
+	}
+	else if (dy < 0)
+	{
+		DrawRegion(X, Y + H + dy, W, -dy);
+	}
+	Pans++;
+}
+
+/// <param name="heading">Degrees counterclockwise from OTOS +x</param>
+void MapView::DrawMarker(int32_t robotX, int32_t robotY, float heading)
+{
+	MarkerX = ScreenX(robotX);
+	MarkerY = ScreenY(robotY);
+
+	float radians = heading * DEG_TO_RAD;
+	float backLeft = radians + 140.0f * DEG_TO_RAD;
+	float backRight = radians - 140.0f * DEG_TO_RAD;
+	int32_t size = MapMarkerSize - 1;
+
+	tft->setViewport(X, Y, W, H, false);
+	tft->fillTriangle(
+		MarkerX + (int32_t)lroundf(size * cosf(radians)), MarkerY - (int32_t)lroundf(size * sinf(radians)),
+		MarkerX + (int32_t)lroundf(size * cosf(backLeft)), MarkerY - (int32_t)lroundf(size * sinf(backLeft)),
+		MarkerX + (int32_t)lroundf(size * cosf(backRight)), MarkerY - (int32_t)lroundf(size * sinf(backRight)),
+		RobotColor);
+	tft->resetViewport();
+	MarkerDrawn = true;
+}
+
+void MapView::EraseMarker()
+{
+	if (MarkerDrawn)
+	{
+		DrawRegion(MarkerX - MapMarkerSize, MarkerY - MapMarkerSize, 2 * MapMarkerSize + 1, 2 * MapMarkerSize + 1);
+		MarkerDrawn = false;
+	}
+}
+
+/// <summary>
+/// Draws the frame and the whole map
+/// </summary>
+/// <param name="x">Robot position, m, OTOS frame</param>
+/// <param name="y">Robot position, m, OTOS frame</param>
+/// <param name="heading">Robot heading, degrees</param>
+void MapView::DrawFrame(float x, float y, float heading)
+{
+	if (tft == nullptr)
+	{
+		return;
+	}
+	tft->drawRect(X - 1, Y - 1, W + 2, H + 2, FrameColor);
+	MapDrawn = false;
+	Update(x, y, heading);
+}
+
+/// <summary>
+/// Draws what has changed since the last update, panning the view if the robot has left the middle half of it
+/// </summary>
+/// <param name="x">Robot position, m, OTOS frame</param>
+/// <param name="y">Robot position, m, OTOS frame</param>
+/// <param name="heading">Robot heading, degrees</param>
+void MapView::Update(float x, float y, float heading)
+{
+	if (tft == nullptr)
+	{
+		return;
+	}
+
+	int32_t robotX = ToPixels(x);
+	int32_t robotY = ToPixels(y);
+	if (!MapDrawn || Path->Revision != DrawnTrailRevision || Map->GetCellSize() != DrawnCellSize
+		|| abs(robotX - ViewX) >= W || abs(robotY - ViewY) >= H)
+	{
+		DrawMap(robotX, robotY);
+		DrawMarker(robotX, robotY, heading);
+		return;
+	}
+
+	EraseMarker();
+
+	if (abs(robotX - ViewX) > W / 4 || abs(robotY - ViewY) > H / 4)
+	{
+		Pan(robotX - ViewX, robotY - ViewY);
+	}
+
+	DrawTiles(true);
+
+	uint16_t count = Path->GetCount();
+	if (count > DrawnTrailCount)
+	{
+		tft->setViewport(X, Y, W, H, false);
+		DrawTrail(DrawnTrailCount, X, Y, W, H);
+		if (WaypointDrawn)
+		{
+			DrawWaypoint();
+		}
+		tft->resetViewport();
+		DrawnTrailCount = count;
+	}
+
+	int32_t waypointX = ToPixels(WaypointXm);
+	int32_t waypointY = ToPixels(WaypointYm);
+	if (WaypointShown != WaypointDrawn || (WaypointShown && (waypointX != DrawnWaypointX || waypointY != DrawnWaypointY)))
+	{
+		bool erase = WaypointDrawn;
+		int32_t eraseX = ScreenX(DrawnWaypointX) - MapWaypointSize;
+		int32_t eraseY = ScreenY(DrawnWaypointY) - MapWaypointSize;
+		WaypointDrawn = WaypointShown;
+		DrawnWaypointX = waypointX;
+		DrawnWaypointY = waypointY;
+		if (erase)
+		{
+			DrawRegion(eraseX, eraseY, 2 * MapWaypointSize + 1, 2 * MapWaypointSize + 1);
+		}
+		if (WaypointDrawn)
+		{
+			tft->setViewport(X, Y, W, H, false);
+			DrawWaypoint();
+			tft->resetViewport();
+		}
+	}
+
+	DrawMarker(robotX, robotY, heading);
+}
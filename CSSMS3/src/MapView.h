@@ -0,0 +1,121 @@
+/*	MapView.h
+*	MapView - Helper class to draw a moving map of the robot's trail, waypoint and the MCC occupancy grid
+*
+*	The map is drawn north (OTOS +y) up at a whole number of mm per pixel, and every position is first rounded to a
+*	world pixel, so that the picture of the world only ever moves by whole pixels.  The view keeps the robot within its
+*	middle half; when the robot leaves it the view is re-centred by scrolling the map on the canvas
+*	(TileRenderer::ScrollArea()) and drawing only the strips uncovered, which come out exactly as a full redraw would
+*	have drawn them.  Between pans only what has changed is drawn: new trail segments, occupancy tiles whose revision
+*	has changed (OccupancyGrid::GetBufferTileInfo()), the waypoint if it has moved and the robot marker, which is erased
+*	by redrawing the map under it.  The whole map is only redrawn when the trail has been simplified (its older points
+*	have moved), the scale or cell size has changed, or the robot has jumped further than the view.
+*
+*	Areas of the map are drawn through a viewport clipped to the area, so a line or cell crossing its edge does not
+*	overwrite the map next to it.
+*
+*	Mitchell Baldwin copyright 2026
+*
+*	v 0.00:	Initial data structure
+*	v
+*
+*/
+
+#ifndef _MapView_h
+#define _MapView_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+#include "TileRenderer.h"
+#include "CSSMS3Status.h"
+
+constexpr int32_t DefaultMapScale = 25;				// mm per pixel
+constexpr int32_t MapGridSpacing = 1000;			// mm between grid lines
+constexpr int32_t MapMarkerSize = 7;				// pixels; half the size of the area the robot marker is drawn in
+constexpr int32_t MapWaypointSize = 4;				// pixels; radius of the waypoint marker
+
+class MapView
+{
+protected:
+	TileRenderer* tft = nullptr;
+	const MapGrid* Map = nullptr;
+	const RobotTrail* Path = nullptr;
+
+	int32_t X = 0;										// Top left corner of the map, inside the frame
+	int32_t Y = 0;
+	int32_t W = 0;
+	int32_t H = 0;
+	int32_t Scale = DefaultMapScale;					// mm per pixel
+
+	uint16_t FrameColor = TFT_DARKGREY;
+	uint16_t GridColor = 0x2124;
+	uint16_t FreeColor = 0x18E3;
+	uint16_t UncertainColor = 0x4A49;
+	uint16_t OccupiedColor = TFT_WHITE;
+	uint16_t TrailColor = TFT_CYAN;
+	uint16_t WaypointColor = TFT_MAGENTA;
+	uint16_t RobotColor = TFT_YELLOW;
+
+	bool MapDrawn = false;
+	int32_t ViewX = 0;									// World pixel at the centre of the view
+	int32_t ViewY = 0;
+	uint16_t DrawnCellSize = 0;							// mm
+	uint32_t DrawnTrailRevision = 0;
+	uint16_t DrawnTrailCount = 0;						// Trail points drawn
+
+	// Occupancy tiles as drawn, by buffer tile:
+	bool DrawnTileValid[MapGrid::BufferTiles];
+	int32_t DrawnTileX[MapGrid::BufferTiles];
+	int32_t DrawnTileY[MapGrid::BufferTiles];
+	uint8_t DrawnTileRevision[MapGrid::BufferTiles];
+
+	bool WaypointShown = false;							// As set by SetWaypoint()
+	float WaypointXm = 0.0f;							// m
+	float WaypointYm = 0.0f;
+	bool WaypointDrawn = false;
+	int32_t DrawnWaypointX = 0;							// World pixel
+	int32_t DrawnWaypointY = 0;
+
+	bool MarkerDrawn = false;
+	int32_t MarkerX = 0;								// Screen pixel
+	int32_t MarkerY = 0;
+
+	static int32_t FloorDiv(int32_t a, int32_t b);
+	static int32_t CeilDiv(int32_t a, int32_t b);
+	bool ClipToView(int32_t& x, int32_t& y, int32_t& w, int32_t& h);
+
+	int32_t ToPixels(float position) { return (int32_t)lroundf(position * 1000.0f / Scale); }
+	int32_t ScreenX(int32_t px) { return X + W / 2 + px - ViewX; }
+	int32_t ScreenY(int32_t py) { return Y + H / 2 - (py - ViewY); }
+
+	void DrawGrid(int32_t x, int32_t y, int32_t w, int32_t h);
+	void DrawTileCells(int32_t tx, int32_t ty, int32_t x, int32_t y, int32_t w, int32_t h);
+	void DrawTrail(uint16_t first, int32_t x, int32_t y, int32_t w, int32_t h);
+	void DrawWaypoint();
+	void DrawRegion(int32_t x, int32_t y, int32_t w, int32_t h);
+	void DrawTileRegion(int32_t tx, int32_t ty);
+	void DrawTiles(bool draw);
+	void DrawMap(int32_t robotX, int32_t robotY);
+	void Pan(int32_t dx, int32_t dy);
+	void DrawMarker(int32_t robotX, int32_t robotY, float heading);
+	void EraseMarker();
+
+public:
+	bool Init(TileRenderer* _tft, const MapGrid* map, const RobotTrail* path, int32_t x, int32_t y, int32_t w, int32_t h);
+	void SetScale(int32_t mmPerPixel);
+	int32_t GetScale() { return Scale; }
+	void SetWaypoint(bool shown, float x = 0.0f, float y = 0.0f);
+
+	uint32_t FullRedraws = 0;
+	uint32_t Pans = 0;
+	uint32_t TilesDrawn = 0;
+	uint32_t SegmentsDrawn = 0;
+
+	void DrawFrame(float x, float y, float heading);
+	void Update(float x, float y, float heading);
+};
+
+#endif
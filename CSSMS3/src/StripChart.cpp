@@ -0,0 +1,192 @@
+/*	StripChart.cpp
+*	StripChart - Helper class to draw a scrolling strip chart of one or two telemetry channels
+*
+*/
+
+#include "StripChart.h"
+
+/// <summary>
+/// Sets the chart's plot area; the scale is drawn in the 36 pixels to its left and the label and values to its right
+/// </summary>
+/// <param name="w">Plot width, pixels; rounded down to whole columns of at most ChartHistorySize buckets</param>
+bool StripChart::Init(TileRenderer* _tft, int32_t x, int32_t y, int32_t w, int32_t h)
+{
+	tft = _tft;
+	X = x;
+	Y = y;
+	Columns = min(w / StripChartColumnWidth, (int32_t)ChartHistorySize);
+	W = Columns * StripChartColumnWidth;
+	H = h;
+	PlotDrawn = false;
+	return (tft != nullptr && Columns > 0 && H > 1);
+}
+
+void StripChart::SetLabel(const char* label)
+{
+	Label = label;
+}
+
+/// <param name="format">printf format of the latest values, e.g. "%+6.0f"; at most 10 characters wide</param>
+void StripChart::SetValueFormat(const char* format)
+{
+	ValueFormat = format;
+}
+
+void StripChart::SetLimits(float min, float max)
+{
+	MinValue = min;
+	MaxValue = (max > min) ? max : min + 1.0f;
+	PlotDrawn = false;
+}
+
+/// <returns>False if the chart already has MaxStripChartTraces traces</returns>
+bool StripChart::AddTrace(const ChartHistory* history, uint16_t color)
+{
+	if (TraceCount >= MaxStripChartTraces || history == nullptr)
+	{
+		return false;
+	}
+	Traces[TraceCount].History = history;
+	Traces[TraceCount].Color = color;
+	Traces[TraceCount].DrawnText[0] = '\0';
+	TraceCount++;
+	PlotDrawn = false;
+	return true;
+}
+
+/// <summary>
+/// Selects the history level (time span) shown; the plot is redrawn by the next Update()
+/// </summary>
+void StripChart::SetLevel(uint8_t level)
+{
+	if (level < ChartHistoryLevels && level != Level)
+	{
+		Level = level;
+		PlotDrawn = false;
+	}
+}
+
+int32_t StripChart::ValueToY(float value)
+{
+	int32_t y = Y + H - 1 - (int32_t)lroundf((value - MinValue) * (H - 1) / (MaxValue - MinValue));
+	return constrain(y, Y, Y + H - 1);
+}
+
+/// <summary>
+/// Draws the column of each trace's bucket of a given age over the zero line
+/// </summary>
+/// <param name="age">0 for the newest bucket</param>
+void StripChart::DrawColumn(int32_t x, uint16_t age)
+{
+	tft->fillRect(x, Y, StripChartColumnWidth, H, TFT_BLACK);
+	if (MinValue < 0.0f && MaxValue > 0.0f)
+	{
+		tft->drawFastHLine(x, ValueToY(0.0f), StripChartColumnWidth, ZeroColor);
+	}
+
+	for (uint8_t i = 0; i < TraceCount; i++)
+	{
+		const ChartHistory* history = Traces[i].History;
+		if (age >= history->GetCount(Level))
+		{
+			continue;
+		}
+		const MinMax& bucket = history->Get(Level, age);
+		int32_t yTop = ValueToY(bucket.Max);
+		int32_t yBottom = ValueToY(bucket.Min);
+		tft->fillRect(x, yTop, StripChartColumnWidth, yBottom - yTop + 1, Traces[i].Color);
+	}
+}
+
+void StripChart::DrawPlot()
+{
+	for (int32_t column = 0; column < Columns; column++)
+	{
+		DrawColumn(X + column * StripChartColumnWidth, Columns - 1 - column);
+	}
+	LastUpdateColumns = Columns;
+	DrawnTotal = (TraceCount > 0) ? Traces[0].History->GetTotal(Level) : 0;
+	PlotDrawn = true;
+}
+
+/// <summary>
+/// Draws the latest value of each trace below the label, where it has changed
+/// </summary>
+void StripChart::DrawValues(bool force)
+{
+	char buf[12];
+	tft->setTextSize(1);
+	tft->setTextDatum(TL_DATUM);
+	for (uint8_t i = 0; i < TraceCount; i++)
+	{
+		snprintf(buf, sizeof(buf), ValueFormat, Traces[i].History->GetLatest());
+		if (force || strcmp(buf, Traces[i].DrawnText) != 0)
+		{
+			tft->setTextColor(Traces[i].Color, TFT_BLACK, true);
+			tft->drawString(buf, X + W + 4, Y + 10 * (i + 1));
+			strlcpy(Traces[i].DrawnText, buf, sizeof(Traces[i].DrawnText));
+		}
+	}
+}
+
+/// <summary>
+/// Draws the whole chart: frame, scale, label, plot and values
+/// </summary>
+void StripChart::DrawFrame()
+{
+	char buf[12];
+
+	tft->drawRect(X - 1, Y - 1, W + 2, H + 2, FrameColor);
+
+	tft->setTextSize(1);
+	tft->setTextColor(ScaleColor, TFT_BLACK, true);
+	tft->setTextDatum(TR_DATUM);
+	snprintf(buf, sizeof(buf), "%.5g", MaxValue);
+	tft->drawString(buf, X - 3, Y - 1);
+	tft->setTextDatum(BR_DATUM);
+	snprintf(buf, sizeof(buf), "%.5g", MinValue);
+	tft->drawString(buf, X - 3, Y + H + 1);
+
+	tft->setTextColor(LabelColor, TFT_BLACK, true);
+	tft->setTextDatum(TL_DATUM);
+	tft->drawString(Label, X + W + 4, Y);
+
+	DrawPlot();
+	DrawValues(true);
+}
+
+/// <summary>
+/// Scrolls the plot by the buckets completed since the last update and draws them, and redraws changed values
+/// </summary>
+void StripChart::Update()
+{
+	LastUpdateColumns = 0;
+	if (tft == nullptr || TraceCount == 0)
+	{
+		return;
+	}
+
+	if (!PlotDrawn)
+	{
+		DrawPlot();
+	}
+	else
+	{
+		uint32_t added = Traces[0].History->GetTotal(Level) - DrawnTotal;
+		if (added >= (uint32_t)Columns)
+		{
+			DrawPlot();
+		}
+		else if (added > 0)
+		{
+			tft->ScrollArea(X, Y, W, H, -(int16_t)(added * StripChartColumnWidth), 0);
+			for (uint32_t age = 0; age < added; age++)
+			{
+				DrawColumn(X + W - (age + 1) * StripChartColumnWidth, age);
+			}
+			LastUpdateColumns = added;
+			DrawnTotal += added;
+		}
+	}
+	DrawValues(false);
+}
@@ -0,0 +1,87 @@
+/*	StripChart.h
+*	StripChart - Helper class to draw a scrolling strip chart of one or two telemetry channels
+*
+*	Each channel is a ChartHistory (see MinMaxHistory.h) and each of its buckets at the chosen level is drawn as a
+*	column, ColumnWidth pixels wide, spanning the minimum to the maximum of the values that went into it, with the
+*	newest bucket on the right.  When new buckets have been completed Update() scrolls the plot left on the canvas
+*	(TileRenderer::ScrollArea()) and draws only the new columns, so its cost does not depend on the span shown.
+*	The scale is drawn to the left of the plot and the label and latest values to the right.
+*
+*	Mitchell Baldwin copyright 2026
+*
+*	v 0.00:	Initial data structure
+*	v
+*
+*/
+
+#ifndef _StripChart_h
+#define _StripChart_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+#include "TileRenderer.h"
+#include "CSSMS3Status.h"
+
+constexpr uint8_t MaxStripChartTraces = 2;
+constexpr int32_t StripChartColumnWidth = 2;		// pixels per history bucket
+
+class StripChart
+{
+protected:
+	struct Trace
+	{
+		const ChartHistory* History;
+		uint16_t Color;
+		char DrawnText[12];								// Latest value as drawn, so it is only redrawn when it changes
+	};
+
+	TileRenderer* tft = nullptr;
+
+	int32_t X = 0;										// Top left corner of the plot, inside the frame
+	int32_t Y = 0;
+	int32_t W = 0;
+	int32_t H = 0;
+	int32_t Columns = 0;
+
+	uint16_t FrameColor = TFT_DARKGREY;
+	uint16_t LabelColor = TFT_YELLOW;
+	uint16_t ScaleColor = TFT_SILVER;
+	uint16_t ZeroColor = TFT_DARKGREY;
+
+	String Label;
+	const char* ValueFormat = "%+6.0f";
+	float MinValue = 0.0f;
+	float MaxValue = 1.0f;
+
+	Trace Traces[MaxStripChartTraces];
+	uint8_t TraceCount = 0;
+	uint8_t Level = 0;
+
+	bool PlotDrawn = false;
+	uint32_t DrawnTotal = 0;							// History buckets drawn up to (see MinMaxHistory::GetTotal())
+
+	int32_t ValueToY(float value);
+	void DrawColumn(int32_t x, uint16_t age);
+	void DrawPlot();
+	void DrawValues(bool force);
+
+public:
+	bool Init(TileRenderer* _tft, int32_t x, int32_t y, int32_t w, int32_t h);
+	void SetLabel(const char* label);
+	void SetValueFormat(const char* format);
+	void SetLimits(float min, float max);
+	bool AddTrace(const ChartHistory* history, uint16_t color);
+	void SetLevel(uint8_t level);
+	uint8_t GetLevel() { return Level; }
+
+	uint32_t LastUpdateColumns = 0;						// Columns drawn by the last Update()
+
+	void DrawFrame();
+	void Update();
+};
+
+#endif
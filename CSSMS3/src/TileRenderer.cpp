@@ -0,0 +1,468 @@
+/*	TileRenderer.cpp
+*	TileRenderer - Off-screen canvas for the local display that only pushes the parts of the screen that have changed
+*
+*/
+
+#include "TileRenderer.h"
+
+TileRenderer::TileRenderer(TFT_eSPI* panel) : TFT_eSprite(panel)
+{
+	memset(DirtyTiles, 0, sizeof(DirtyTiles));
+	memset(TileHashes, 0, sizeof(TileHashes));
+}
+
+/// <summary>
+/// Creates the canvas the size of the (initialized and rotated) panel
+/// </summary>
+/// <returns>False if there is not enough memory for the canvas even at 8 bit colour depth</returns>
+bool TileRenderer::Init()
+{
+	int32_t w = _tft->width();
+	int32_t h = _tft->height();
+
+	setColorDepth(16);
+	Created = (createSprite(w, h) != nullptr);
+	if (!Created)
+	{
+		setColorDepth(8);
+		Created = (createSprite(w, h) != nullptr);
+	}
+	if (!Created)
+	{
+		return false;
+	}
+
+	TileWidth = (w + RenderTileColumns - 1) / RenderTileColumns;
+	TileHeight = (h + RenderTileRows - 1) / RenderTileRows;
+
+	fillSprite(TFT_BLACK);
+	InvalidateAll();
+	ResetStats();
+	return true;
+}
+
+/// <summary>
+/// FNV-1a hash of a tile's pixels
+/// </summary>
+uint32_t TileRenderer::HashTile(int32_t column, int32_t row)
+{
+	int32_t x0 = column * TileWidth;
+	int32_t y0 = row * TileHeight;
+	int32_t x1 = min(x0 + TileWidth, _iwidth);
+	int32_t y1 = min(y0 + TileHeight, _iheight);
+	uint32_t hash = 2166136261u;
+
+	if (getColorDepth() == 16)
+	{
+		const uint16_t* pixels = (const uint16_t*)getPointer();
+		for (int32_t y = y0; y < y1; y++)
+		{
+			const uint16_t* pixel = pixels + y * _iwidth + x0;
+			for (int32_t x = x0; x < x1; x++)
+			{
+				hash = (hash ^ *pixel++) * 16777619u;
+			}
+		}
+	}
+	else
+	{
+		const uint8_t* pixels = (const uint8_t*)getPointer();
+		for (int32_t y = y0; y < y1; y++)
+		{
+			const uint8_t* pixel = pixels + y * _iwidth + x0;
+			for (int32_t x = x0; x < x1; x++)
+			{
+				hash = (hash ^ *pixel++) * 16777619u;
+			}
+		}
+	}
+	return hash;
+}
+
+/// <summary>
+/// Pushes part of the canvas to the panel, leaving out any reserved panel areas
+/// </summary>
+void TileRenderer::PushArea(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t firstArea)
+{
+	for (uint8_t i = firstArea; i < ReservedAreaCount; i++)
+	{
+		const PanelArea& area = ReservedAreas[i];
+		int32_t ix0 = max(x, area.X);
+		int32_t iy0 = max(y, area.Y);
+		int32_t ix1 = min(x + w, area.X + area.W);
+		int32_t iy1 = min(y + h, area.Y + area.H);
+		if (ix0 >= ix1 || iy0 >= iy1)
+		{
+			continue;
+		}
+
+		// Push the parts above, below, left and right of the reserved area:
+		if (iy0 > y)
+		{
+			PushArea(x, y, w, iy0 - y, i + 1);
+		}
+		if (iy1 < y + h)
+		{
+			PushArea(x, iy1, w, y + h - iy1, i + 1);
+		}
+		if (ix0 > x)
+		{
+			PushArea(x, iy0, ix0 - x, iy1 - iy0, i + 1);
+		}
+		if (ix1 < x + w)
+		{
+			PushArea(ix1, iy0, x + w - ix1, iy1 - iy0, i + 1);
+		}
+		return;
+	}
+
+	pushSprite(x, y, x, y, w, h);
+	BytesPushed += w * h * 2;
+}
+
+/// <summary>
+/// Marks the tiles an area overlaps as dirty
+/// </summary>
+/// <param name="force">Push the tiles even if their contents have not changed</param>
+/// <returns>The number of pixels of the area on the canvas</returns>
+int32_t TileRenderer::MarkDirty(int32_t x, int32_t y, int32_t w, int32_t h, bool force)
+{
+	int32_t x1 = min(x + w, _iwidth);
+	int32_t y1 = min(y + h, _iheight);
+	x = max(x, (int32_t)0);
+	y = max(y, (int32_t)0);
+	if (!Created || x >= x1 || y >= y1)
+	{
+		return 0;
+	}
+
+	for (int32_t row = y / TileHeight; row <= (y1 - 1) / TileHeight; row++)
+	{
+		for (int32_t column = x / TileWidth; column <= (x1 - 1) / TileWidth; column++)
+		{
+			DirtyTiles[row] |= (1 << column);
+			if (force)
+			{
+				TileHashes[row][column] = 0;
+			}
+		}
+	}
+	return (x1 - x) * (y1 - y);
+}
+
+/// <summary>
+/// Marks an area to be pushed by the next Flush() whether or not its contents have changed
+/// </summary>
+void TileRenderer::Invalidate(int32_t x, int32_t y, int32_t w, int32_t h)
+{
+	MarkDirty(x, y, w, h, true);
+}
+
+void TileRenderer::InvalidateAll()
+{
+	Invalidate(0, 0, _iwidth, _iheight);
+}
+
+/// <summary>
+/// Reserves an area of the panel for a widget that draws straight to it; Flush() never pushes over it
+/// </summary>
+void TileRenderer::ReservePanelArea(int32_t x, int32_t y, int32_t w, int32_t h)
+{
+	if (ReservedAreaCount < MaxReservedPanelAreas)
+	{
+		ReservedAreas[ReservedAreaCount++] = { x, y, w, h };
+	}
+}
+
+/// <summary>
+/// Clears the reserved areas on the panel and hands them back to the canvas
+/// </summary>
+void TileRenderer::ReleasePanelAreas()
+{
+	for (uint8_t i = 0; i < ReservedAreaCount; i++)
+	{
+		const PanelArea& area = ReservedAreas[i];
+		_tft->fillRect(area.X, area.Y, area.W, area.H, TFT_BLACK);
+		Invalidate(area.X, area.Y, area.W, area.H);
+	}
+	ReservedAreaCount = 0;
+}
+
+/// <summary>
+/// Scrolls an area of the canvas by moving its pixels (see TFT_eSprite::scroll()), filling what it uncovers
+/// </summary>
+/// <param name="dx">pixels; negative to the left</param>
+/// <param name="dy">pixels; negative up</param>
+void TileRenderer::ScrollArea(int32_t x, int32_t y, int32_t w, int32_t h, int16_t dx, int16_t dy, uint16_t color)
+{
+	DrawDepth++;
+	setScrollRect(x, y, w, h, color);
+	scroll(dx, dy);
+	DrawDepth--;
+	CountPixels(MarkDirty(x, y, w, h));
+}
+
+void TileRenderer::BeginFrame()
+{
+	FrameStartTime = micros();
+	FrameStarted = true;
+}
+
+/// <summary>
+/// Pushes the dirty tiles whose contents have changed since they were last pushed
+/// </summary>
+void TileRenderer::Flush()
+{
+	if (!Created)
+	{
+		return;
+	}
+
+	uint32_t flushStartTime = micros();
+	int32_t columns = (_iwidth + TileWidth - 1) / TileWidth;
+	int32_t rows = (_iheight + TileHeight - 1) / TileHeight;
+	BytesPushed = 0;
+	TilesPushed = 0;
+	TilesHashed = 0;
+
+	for (int32_t row = 0; row < rows; row++)
+	{
+		if (DirtyTiles[row] == 0)
+		{
+			continue;
+		}
+
+		// Push each run of changed tiles in the row at once:
+		int32_t runStart = -1;
+		for (int32_t column = 0; column <= columns; column++)
+		{
+			bool changed = false;
+			if (column < columns && (DirtyTiles[row] & (1 << column)))
+			{
+				uint32_t hash = HashTile(column, row);
+				TilesHashed++;
+				if (hash != TileHashes[row][column])
+				{
+					TileHashes[row][column] = hash;
+					changed = true;
+				}
+			}
+
+			if (changed)
+			{
+				TilesPushed++;
+				if (runStart < 0)
+				{
+					runStart = column;
+				}
+			}
+			else if (runStart >= 0)
+			{
+				int32_t x = runStart * TileWidth;
+				int32_t y = row * TileHeight;
+				PushArea(x, y, min(column * TileWidth, _iwidth) - x, min(y + TileHeight, _iheight) - y);
+				runStart = -1;
+			}
+		}
+		DirtyTiles[row] = 0;
+	}
+
+	uint32_t now = micros();
+	FlushTime = now - flushStartTime;
+	FrameTime = FrameStarted ? now - FrameStartTime : FlushTime;
+	FrameStarted = false;
+
+	PixelsDrawn = PixelsDrawing;
+	PixelsDrawing = 0;
+
+	FrameCount++;
+	TotalBytesPushed += BytesPushed;
+	MaxFrameTime = max(MaxFrameTime, FrameTime);
+	if (FrameCount == 1)
+	{
+		AverageFrameTime = FrameTime;
+		AveragePixelsDrawn = PixelsDrawn;
+		AverageBytesPushed = BytesPushed;
+	}
+	else
+	{
+		AverageFrameTime += RenderStatsSmoothing * (FrameTime - AverageFrameTime);
+		AveragePixelsDrawn += RenderStatsSmoothing * (PixelsDrawn - AveragePixelsDrawn);
+		AverageBytesPushed += RenderStatsSmoothing * (BytesPushed - AverageBytesPushed);
+	}
+}
+
+void TileRenderer::ResetStats()
+{
+	FrameCount = 0;
+	MaxFrameTime = 0;
+	AverageFrameTime = 0.0f;
+	AveragePixelsDrawn = 0.0f;
+	AverageBytesPushed = 0.0f;
+	TotalBytesPushed = 0;
+}
+
+/// <returns>Average and maximum frame time and average bytes pushed per frame</returns>
+String TileRenderer::GetStatusString()
+{
+	char buf[32];
+	snprintf(buf, sizeof(buf), "Frm %4.0f/%5luus %5.0fB", AverageFrameTime, (unsigned long)MaxFrameTime, AverageBytesPushed);
+	return String(buf);
+}
+
+/// <returns>Hash of the whole canvas; equal for identical frames at the same colour depth</returns>
+uint32_t TileRenderer::GetFrameHash()
+{
+	uint32_t hash = 2166136261u;
+	for (int32_t row = 0; row * TileHeight < _iheight; row++)
+	{
+		for (int32_t column = 0; column * TileWidth < _iwidth; column++)
+		{
+			hash = (hash ^ HashTile(column, row)) * 16777619u;
+		}
+	}
+	return hash;
+}
+
+/// <summary>
+/// Writes the canvas as a binary (P6) PPM image; the panel areas reserved for other widgets are not included
+/// </summary>
+void TileRenderer::WriteSnapshot(Print& out)
+{
+	BeginSnapshot();
+	while (!WriteSnapshotChunk(out, SIZE_MAX))
+	{
+	}
+}
+
+/// <summary>
+/// Starts a snapshot to be sent by WriteSnapshotChunk(); the canvas must not be drawn into until it has been sent
+/// </summary>
+void TileRenderer::BeginSnapshot()
+{
+	SnapshotPixel = -1;
+}
+
+/// <summary>
+/// Writes the next part of the snapshot started by BeginSnapshot(): the PPM header on the first call, then whole
+/// pixels, at most maxBytes of them
+/// </summary>
+/// <returns>True once the whole image has been written (or there is no canvas)</returns>
+bool TileRenderer::WriteSnapshotChunk(Print& out, size_t maxBytes)
+{
+	if (!Created)
+	{
+		return true;
+	}
+
+	if (SnapshotPixel < 0)
+	{
+		char buf[64];
+		snprintf(buf, sizeof(buf), "P6\n# frame %08lX %u bit\n%ld %ld\n255\n", (unsigned long)GetFrameHash(), getColorDepth(), (long)_iwidth, (long)_iheight);
+		out.print(buf);
+		SnapshotPixel = 0;
+		return false;
+	}
+
+	int32_t pixelCount = _iwidth * _iheight;
+	size_t pixels = min((size_t)(pixelCount - SnapshotPixel), maxBytes / 3);
+	uint8_t rgb[3 * 32];
+	uint8_t count = 0;
+	for (size_t i = 0; i < pixels; i++, SnapshotPixel++)
+	{
+		uint16_t color = readPixel(SnapshotPixel % _iwidth, SnapshotPixel / _iwidth);
+		rgb[count++] = ((color >> 11) & 0x1F) * 255 / 31;
+		rgb[count++] = ((color >> 5) & 0x3F) * 255 / 63;
+		rgb[count++] = (color & 0x1F) * 255 / 31;
+		if (count == sizeof(rgb))
+		{
+			out.write(rgb, count);
+			count = 0;
+		}
+	}
+	out.write(rgb, count);
+
+	if (SnapshotPixel < pixelCount)
+	{
+		return false;
+	}
+	out.println();
+	return true;
+}
+
+void TileRenderer::drawPixel(int32_t x, int32_t y, uint32_t color)
+{
+	TFT_eSprite::drawPixel(x, y, color);
+	if (x >= 0 && y >= 0 && x < _iwidth && y < _iheight)
+	{
+		DirtyTiles[y / TileHeight] |= (1 << (x / TileWidth));
+		CountPixels(1);
+	}
+}
+
+void TileRenderer::drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uint32_t bg, uint8_t size)
+{
+	DrawDepth++;
+	TFT_eSprite::drawChar(x, y, c, color, bg, size);
+	DrawDepth--;
+	CountPixels(MarkDirty(x, y, 6 * size, 8 * size));
+}
+
+int16_t TileRenderer::drawChar(uint16_t uniCode, int32_t x, int32_t y, uint8_t font)
+{
+	DrawDepth++;
+	int16_t width = TFT_eSprite::drawChar(uniCode, x, y, font);
+	DrawDepth--;
+	CountPixels(MarkDirty(x, y, width + textsize, fontHeight(font)));
+	return width;
+}
+
+void TileRenderer::drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color)
+{
+	DrawDepth++;
+	TFT_eSprite::drawLine(x0, y0, x1, y1, color);
+	DrawDepth--;
+	MarkDirty(min(x0, x1), min(y0, y1), abs(x1 - x0) + 1, abs(y1 - y0) + 1);
+	CountPixels(max(abs(x1 - x0), abs(y1 - y0)) + 1);
+}
+
+void TileRenderer::drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color)
+{
+	DrawDepth++;
+	TFT_eSprite::drawFastVLine(x, y, h, color);
+	DrawDepth--;
+	CountPixels(MarkDirty(x, y, 1, h));
+}
+
+void TileRenderer::drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color)
+{
+	DrawDepth++;
+	TFT_eSprite::drawFastHLine(x, y, w, color);
+	DrawDepth--;
+	CountPixels(MarkDirty(x, y, w, 1));
+}
+
+void TileRenderer::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color)
+{
+	DrawDepth++;
+	TFT_eSprite::fillRect(x, y, w, h, color);
+	DrawDepth--;
+	CountPixels(MarkDirty(x, y, w, h));
+}
+
+/// <summary>
+/// Catches the functions that write a window of pixels directly (pushColor() etc.)
+/// </summary>
+void TileRenderer::setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+{
+	TFT_eSprite::setWindow(x0, y0, x1, y1);
+	MarkDirty(min(x0, x1), min(y0, y1), abs(x1 - x0) + 1, abs(y1 - y0) + 1);
+}
+
+void TileRenderer::fillSprite(uint32_t color)
+{
+	DrawDepth++;
+	TFT_eSprite::fillSprite(color);
+	DrawDepth--;
+	CountPixels(MarkDirty(0, 0, _iwidth, _iheight));
+}
@@ -0,0 +1,125 @@
+/*	TileRenderer.h
+*	TileRenderer - Off-screen canvas for the local display that only pushes the parts of the screen that have changed
+*
+*	The pages are drawn into a full screen TFT_eSprite (16 bit colour in PSRAM, or 8 bit if that cannot be allocated)
+*	instead of straight to the panel.  The screen is divided into a grid of tiles (32 x 17 pixels on the 320 x 170
+*	T-Display S3); each drawing primitive marks the tiles it touches as dirty and Flush() hashes the dirty tiles,
+*	pushing only those whose contents have actually changed, joining neighbouring tiles in a row into one push.
+*	Redrawing a line of text with the same value, or a whole page with mostly the same content, so costs a hash of the
+*	tiles involved rather than a transfer to the panel.
+*
+*	ScrollArea() moves part of the canvas in place (e.g. a strip chart's plot), so that only the strip it uncovers has
+*	to be drawn; the tiles it covers are then pushed if their contents have changed.
+*
+*	Some widgets (e.g. the TFTMenu footer menus) push their own sprites straight to the panel; the areas they occupy are
+*	reserved with ReservePanelArea() and never overwritten from the canvas.  Released areas are cleared on the panel.
+*
+*	Frame time (BeginFrame() to the end of Flush()), flush time, the pixels written to the canvas and the bytes and tiles
+*	pushed are measured for each frame, with running averages and the maximum frame time.  Pixels are counted once per
+*	drawing call (a character cell, a line or a rectangle), not again for the primitives it is drawn with.
+*
+*	WriteSnapshot() sends the canvas as a binary PPM image (with its frame hash in a comment) so that the output of a
+*	page can be compared pixel for pixel before and after a change to how it is drawn; GetFrameHash() alone is enough
+*	to check that nothing has changed.  At about 160 KB the image takes seconds to send over a serial port, so
+*	BeginSnapshot() and WriteSnapshotChunk() send it a part at a time instead, as the port has room for it.
+*
+*	Mitchell Baldwin copyright 2026
+*
+*	v 0.00:	Initial data structure
+*	v
+*
+*/
+
+#ifndef _TileRenderer_h
+#define _TileRenderer_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+#include <TFT_eSPI.h>
+
+constexpr int32_t RenderTileColumns = 10;			// Tile grid; tile size is the screen size / grid size rounded up
+constexpr int32_t RenderTileRows = 10;
+constexpr uint8_t MaxReservedPanelAreas = 4;
+constexpr float RenderStatsSmoothing = 0.0625f;	// Weight of the latest frame in the running averages
+
+class TileRenderer : public TFT_eSprite
+{
+protected:
+	struct PanelArea
+	{
+		int32_t X;
+		int32_t Y;
+		int32_t W;
+		int32_t H;
+	};
+
+	bool Created = false;
+	int32_t TileWidth = 1;							// pixels
+	int32_t TileHeight = 1;
+	uint16_t DirtyTiles[RenderTileRows];			// One bit per column
+	uint32_t TileHashes[RenderTileRows][RenderTileColumns];
+	PanelArea ReservedAreas[MaxReservedPanelAreas];
+	uint8_t ReservedAreaCount = 0;
+	uint32_t FrameStartTime = 0;					// us
+	bool FrameStarted = false;
+	uint32_t PixelsDrawing = 0;						// This frame so far
+	uint8_t DrawDepth = 0;							// Nesting of overridden primitives, so pixels are counted once
+	int32_t SnapshotPixel = -1;						// Next pixel of the snapshot being sent; -1 for the header
+
+	void CountPixels(int32_t pixels) { if (DrawDepth == 0) PixelsDrawing += pixels; }
+	int32_t MarkDirty(int32_t x, int32_t y, int32_t w, int32_t h, bool force = false);
+	uint32_t HashTile(int32_t column, int32_t row);
+	void PushArea(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t firstArea = 0);
+
+public:
+	uint32_t FrameCount = 0;
+	uint32_t FrameTime = 0;							// us; last frame
+	uint32_t FlushTime = 0;							// us; last frame
+	uint32_t PixelsDrawn = 0;						// last frame
+	uint32_t BytesPushed = 0;						// last frame
+	uint16_t TilesPushed = 0;						// last frame
+	uint16_t TilesHashed = 0;						// last frame
+	float AverageFrameTime = 0.0f;					// us
+	float AveragePixelsDrawn = 0.0f;
+	float AverageBytesPushed = 0.0f;
+	uint32_t MaxFrameTime = 0;						// us
+	uint64_t TotalBytesPushed = 0;
+
+	TileRenderer(TFT_eSPI* panel);
+
+	bool Init();
+	bool IsCreated() { return Created; }
+
+	void Invalidate(int32_t x, int32_t y, int32_t w, int32_t h);
+	void InvalidateAll();
+	void ReservePanelArea(int32_t x, int32_t y, int32_t w, int32_t h);
+	void ReleasePanelAreas();
+	void ScrollArea(int32_t x, int32_t y, int32_t w, int32_t h, int16_t dx, int16_t dy, uint16_t color = TFT_BLACK);
+
+	void BeginFrame();
+	void Flush();
+	void ResetStats();
+	String GetStatusString();
+	uint32_t GetFrameHash();
+	void WriteSnapshot(Print& out);
+	void BeginSnapshot();
+	bool WriteSnapshotChunk(Print& out, size_t maxBytes);
+
+	// Drawing primitives that other TFT_eSPI functions are built on, overridden to mark the area they touch:
+	using TFT_eSprite::drawChar;
+	void drawPixel(int32_t x, int32_t y, uint32_t color) override;
+	void drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uint32_t bg, uint8_t size) override;
+	int16_t drawChar(uint16_t uniCode, int32_t x, int32_t y, uint8_t font) override;
+	void drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color) override;
+	void drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color) override;
+	void drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color) override;
+	void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) override;
+	void setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1) override;
+	void fillSprite(uint32_t color);
+};
+
+#endif
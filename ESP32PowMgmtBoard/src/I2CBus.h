@@ -20,7 +20,7 @@
 	#include "WProgram.h"
 #endif
 
-constexpr auto MaxI2CDeviceCount = 8;
+constexpr auto MaxI2CDeviceCount = 16;			// Addresses kept by Scan(); the address strings show the first few
 
 // Using the TTGO T-Display pin 22 is used for the built-in LED, so we must re-map SCL to another pin:
 // Default SCL definition is static const uint8_t SCL = 22
@@ -0,0 +1,160 @@
+/*	BarGaugeTest.cpp
+*	CSSMS3 BarGauge drawing only what has changed: pixels written in steady driving against the previous full redraw
+*	of each update, the same frames as a fresh full draw after sign changes and out of range readings, nothing drawn
+*	for an unchanged reading, and SetMaxUpdateRate()
+*
+*/
+
+#include "HostTest.h"
+#include "../CSSMS3/src/BarGauge.h"
+#include <random>
+
+/// <summary>
+/// BarGauge with the previous Update(), which redrew the half of the bar, the reading and the power bar on every call
+/// </summary>
+class FullRedrawGauge : public BarGauge
+{
+public:
+	void FullUpdate(float newReading, float newPowerReading)
+	{
+		char buf[16];
+
+		reading = newReading;
+		int16_t bar = 0;
+		if (reading < 0.0f)
+		{
+			tft->fillRect(Xtl + 2, Y0 + 1, WBar, HFrame / 2 - 1, TFT_BLACK);
+			bar = reading / minReading * (HFrame / 2 - 1);
+			tft->fillRect(Xtl + 2, Y0 + 1, WBar, bar, NegBarColor);
+			tft->setTextColor(NegBarColor, TFT_BLACK, true);
+		}
+		else
+		{
+			tft->fillRect(Xtl + 2, Y0 - HFrame / 2 + 1, WBar, HFrame / 2 - 1, TFT_BLACK);
+			bar = reading / maxReading * (HFrame / 2 - 1);
+			tft->fillRect(Xtl + 2, Y0 - bar, WBar, bar, PosBarColor);
+			tft->setTextColor(PosBarColor, TFT_BLACK, true);
+		}
+
+		powerReading = newPowerReading;
+		bar = min((int)(powerReading / maxPowerReading * HFrame), HFrame);
+
+		float pctReading = (reading < 0.0f) ? 0.0f - reading / minReading * 100.0f : reading / maxReading * 100.0f;
+		sprintf(buf, "%+04.0f", pctReading);
+		tft->setTextDatum(TC_DATUM);
+		tft->drawString(buf, X0 + 1, Ytl + HFrame + 12, 1);
+
+		tft->fillRect(Xtl - 4, Ytl, 3, HFrame, TFT_BLACK);
+		tft->fillRect(Xtl - 4, Ytl + HFrame - bar, 3, bar, PowBarColor);
+	}
+};
+
+static void InitGauge(BarGauge& gauge, TFT_eSPI* tft)
+{
+	gauge.Init(tft, 180, 76, BarGauge::PowerBarLeft);		// LTrackBarGauge on the DRV page
+	gauge.SetLabel((char*)"LTrk");
+	gauge.SetLimits(-7500.0f, 7500.0f);
+	gauge.SetPowerLimit(1.0f);
+	gauge.DrawFrame();
+}
+
+static void TestSteadyDriving()
+{
+	TFT_eSPI incremental;
+	TFT_eSPI full;
+	incremental.setRotation(3);
+	full.setRotation(3);
+	BarGauge gauge;
+	FullRedrawGauge fullGauge;
+	InitGauge(gauge, &incremental);
+	InitGauge(fullGauge, &full);
+	incremental.HostResetCounts();
+	full.HostResetCounts();
+
+	// 3000 of 7500 with +/- 30 of noise and a slow swell, at 40% power
+	constexpr int Frames = 600;
+	std::mt19937 random(1);
+	int differing = 0;
+	for (int frame = 0; frame < Frames; frame++)
+	{
+		float speed = 3000.0f + (float)(random() % 61) - 30.0f + 500.0f * sinf(frame / 300.0f);
+		float power = 0.4f + (float)(random() % 21 - 10) / 1000.0f;
+		gauge.Update(speed, power);
+		fullGauge.FullUpdate(speed, power);
+		differing += (incremental.HostFrameHash() != full.HostFrameHash());
+	}
+
+	double incrementalPixels = (double)incremental.HostPixelsWritten / Frames;
+	double fullPixels = (double)full.HostPixelsWritten / Frames;
+	printf("Steady driving: %.0f pixels per update redrawn in full, %.1f drawing changes only (%.0f x fewer)\n",
+		fullPixels, incrementalPixels, fullPixels / incrementalPixels);
+	CHECK(differing == 0);
+	CHECK(incrementalPixels * 10.0 < fullPixels);
+}
+
+static void TestTransitions()
+{
+	TFT_eSPI incremental;
+	TFT_eSPI fresh;
+	incremental.setRotation(3);
+	fresh.setRotation(3);
+	BarGauge gauge;
+	InitGauge(gauge, &incremental);
+
+	// Sign changes, beyond the limits, and back to small readings
+	const float readings[] = { 5000.0f, -2000.0f, -8000.0f, 9000.0f, 0.0f, -0.5f, 7000.0f, -7500.0f, 120.0f, -3000.0f };
+	for (float reading : readings)
+	{
+		gauge.Update(reading, fabsf(reading) / 5000.0f);
+
+		BarGauge freshGauge;
+		fresh.fillScreen(TFT_BLACK);
+		InitGauge(freshGauge, &fresh);
+		freshGauge.Update(reading, fabsf(reading) / 5000.0f);
+		CHECK(incremental.HostFrameHash() == fresh.HostFrameHash());
+	}
+}
+
+static void TestUnchanged()
+{
+	TFT_eSPI panel;
+	panel.setRotation(3);
+	BarGauge gauge;
+	InitGauge(gauge, &panel);
+	gauge.Update(2500.0f, 0.3f);
+
+	// Less than a pixel of bar and the same percentage: nothing drawn
+	panel.HostResetCounts();
+	gauge.Update(2510.0f, 0.301f);
+	CHECK(panel.HostPixelsWritten == 0 && gauge.LastUpdatePixels == 0);
+}
+
+static void TestMaxUpdateRate()
+{
+	HostClock::Set(1000000);
+	TFT_eSPI panel;
+	panel.setRotation(3);
+	BarGauge gauge;
+	InitGauge(gauge, &panel);
+	gauge.SetMaxUpdateRate(5.0f);
+
+	// Called at 10 Hz for 10 s with a new reading every time
+	int draws = 0;
+	for (int i = 0; i < 100; i++)
+	{
+		HostClock::Advance(100000);
+		panel.HostResetCounts();
+		gauge.Update(1000.0f + 50.0f * i, 0.5f);
+		draws += (panel.HostPixelsWritten > 0);
+	}
+	CHECK(draws == 50);
+}
+
+int main()
+{
+	TestSteadyDriving();
+	TestTransitions();
+	TestUnchanged();
+	TestMaxUpdateRate();
+	return HostTestResult("BarGaugeTest");
+}
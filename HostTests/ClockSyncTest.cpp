@@ -0,0 +1,125 @@
+/*	ClockSyncTest.cpp
+*	ClockSyncClass: offset recovery from NTP style exchanges, the Simulate() error bound over a range of drifts and
+*	delays, and the MCC - MRS SEN exchange end to end, with the MRS SEN module simulated on the host Wire bus
+*	stamping its clock from the request handler as the firmware does
+*
+*/
+
+#include "HostTest.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\ClockSync.h"
+#include "../MRSMCC/src/MRSSENsors.h"
+
+constexpr int64_t SENOffset = 987654321;					// us; MRS SEN clock - MCC clock
+
+/// <summary>
+/// Simulates the bus timing of the clock register exchange; the MRS SEN clock runs SENOffset ahead of the host clock
+/// </summary>
+class FakeClockSEN : public HostI2CDevice
+{
+public:
+	uint32_t RequestLatency = 0;							// us from the read's address byte to the request handler
+	int64_t StampTime = 0;									// us, MCC clock; when the last clock read was stamped
+	MRSSENClockExchange Exchange;
+	uint8_t SelectedAddress = 0;
+	int Exchanges = 0;
+
+	int64_t GetByteTime() { return 9000000LL / Wire.getClock(); }
+
+	bool OnWrite(uint8_t address, const uint8_t* data, size_t length) override
+	{
+		HostClock::Advance((1 + length) * GetByteTime());
+		if (address != defaultMRSSENAddress || length == 0)
+		{
+			return false;
+		}
+		SelectedAddress = data[0];
+		if (data[0] == MRSSEN_ClockAddress && length == 1 + sizeof(Exchange))
+		{
+			memcpy(&Exchange, data + 1, sizeof(Exchange));
+			Exchanges++;
+		}
+		return true;
+	}
+
+	size_t OnRead(uint8_t address, uint8_t* data, size_t length) override
+	{
+		if (address != defaultMRSSENAddress || SelectedAddress != MRSSEN_ClockAddress)
+		{
+			return 0;
+		}
+		HostClock::Advance(GetByteTime() + RequestLatency);
+		MRSSENClockRegister clock;
+		StampTime = esp_timer_get_time();
+		clock.ReadTime = StampTime + SENOffset;
+		memcpy(data, &clock, min(length, sizeof(clock)));
+		HostClock::Advance(length * GetByteTime());
+		return length;
+	}
+};
+
+static void TestAddExchange()
+{
+	ClockSyncClass clock;
+	CHECK(!clock.IsSynchronised());
+	clock.AddExchange(0, 1000, 1100, 300);					// Remote 900 us ahead, 200 us round trip
+	clock.AddExchange(1000000, 1001000, 1001100, 1000300);
+	clock.AddExchange(2000000, 2001000, 2001100, 2000300);
+	CHECK(clock.IsSynchronised());
+	CHECK_NEAR(clock.ToShared(3000000) - 3000000, 900, 1);
+	CHECK_NEAR(clock.GetDriftPPM(), 0.0, 0.1);
+	CHECK(clock.Rejected == 0);
+}
+
+static void TestSimulate()
+{
+	randomSeed(1);
+	for (float drift : { 0.0f, 20.0f, -50.0f, 100.0f })
+	{
+		for (uint32_t delay : { 100u, 2000u })
+		{
+			// Random one way delays bound each exchange's offset error by half the round trip
+			int32_t error = ClockSyncClass::Simulate(drift, delay, 120);
+			CHECK(error <= (int32_t)delay);
+		}
+	}
+}
+
+static void TestMRSSENExchange()
+{
+	FakeClockSEN sen;
+	MRSSENsorsClass sensors;
+	Wire.Device = &sen;
+	HostClock::Set(1000000);
+	sensors.Init();
+
+	for (uint32_t frequency : { 100000u, 400000u })
+	{
+		Wire.setClock(frequency);
+		for (uint32_t latency : { 0u, 50u, 400u })
+		{
+			sen.RequestLatency = latency;
+			int32_t residual = 0;
+			CHECK(sensors.SyncClock(residual));
+			CHECK(sen.Exchanges > 0);
+
+			// The stamp lies inside the MCC's window, so the midpoint is within half the round trip of it
+			const MRSSENClockExchange& exchange = sen.Exchange;
+			CHECK(exchange.MCCSendTime <= sen.StampTime && sen.StampTime <= exchange.MCCReceiveTime);
+			int64_t midpoint = (exchange.MCCSendTime + exchange.MCCReceiveTime) / 2;
+			int64_t roundTrip = exchange.MCCReceiveTime - exchange.MCCSendTime;
+			CHECK_NEAR(exchange.SENReceiveTime - midpoint, SENOffset, roundTrip / 2 + 1);
+			CHECK_NEAR(roundTrip, latency, 1);
+			HostClock::Advance(ClockSyncInterval * 1000LL);
+		}
+	}
+	Wire.setClock(100000);
+	Wire.Device = nullptr;
+}
+
+int main()
+{
+	TestAddExchange();
+	TestSimulate();
+	TestMRSSENExchange();
+	return HostTestResult("ClockSyncTest");
+}
@@ -0,0 +1,185 @@
+/*	CollisionGuardTest.cpp
+*	RC2x15AMCClass collision guard in the loop with the MCC's range reads and motor control ticks: approaches to a wall
+*	at several speeds with the sensor turret looking ahead and scanning the forward cone stop GuardStopDistance short of
+*	the wall, the motor setting follows every drop in the guard limit within one control tick, and a turret looking
+*	aside holds the MRS to GuardCreepSpeed
+*
+*/
+
+#include "HostTest.h"
+#include "../MRSMCC/src/RC2x15AMC.h"
+#include "../MRSMCC/src/MCCStatus.h"
+
+constexpr uint32_t UpdateRangeInterval = 25;				// ms; MCC Safety priority range read, as MRSMCC.ino
+constexpr uint32_t UpdateMotorControllerInterval = 50;		// ms; MCC motor control task
+constexpr uint32_t MotorControllerPhase = 10;				// ms after each range read the motor control task runs
+constexpr float WallRange = 2500.0f;						// mm
+constexpr float SweepHalfAngle = 30.0f;						// degrees; MRS SEN default sweep, -30 to 30
+constexpr float SweepRate = 30.0f;							// degrees/s; one pass every 2 s
+constexpr float VL53L1XMaxRange = 4000.0f;					// mm; further returns are reported as no range
+constexpr float StopTolerance = 25.0f;						// mm beyond GuardStopDistance the MRS may stop
+
+enum TurretModes
+{
+	Ahead,
+	Scanning,
+	Aside,
+};
+
+struct Approach
+{
+	float Gap = 0.0f;										// mm; wall range once stopped
+	float LimitedRange = 0.0f;								// mm; wall range when the guard first reduced the setting
+	uint32_t Reaction = 0;									// ms from the range read that needed a lower setting to it
+	uint32_t ApproachTime = 0;								// ms to within 1 m of the wall
+	float MaxSpeed = 0.0f;									// mm/s
+	int LateTicks = 0;										// Control ticks that left the setting above the guard limit
+};
+
+static float TurretAngle(TurretModes turret, uint32_t t)
+{
+	if (turret == Ahead)
+	{
+		return 0.0f;
+	}
+	if (turret == Aside)
+	{
+		return 90.0f;
+	}
+	float phase = fmodf(t * SweepRate / 1000.0f, 4.0f * SweepHalfAngle);
+	return (phase < 2.0f * SweepHalfAngle) ? phase - SweepHalfAngle : 3.0f * SweepHalfAngle - phase;
+}
+
+/// <summary>
+/// Drives RC2x15AMCClass::Update() in DRV mode at a wall straight ahead, one ms at a time, with the motors following
+/// their setting at GuardDeceleration and the VL53L1X on the turret reading the wall along its bearing
+/// </summary>
+static Approach Simulate(float commanded, TurretModes turret)
+{
+	Approach result;
+	HostClock::Set(1000000);
+	RC2x15AMCClass controller;
+	controller.Init();
+	MCCStatus.mcStatus.M1Speed = 0;
+	MCCStatus.mcStatus.M2Speed = 0;
+	MCCStatus.lastCSSMDrivePacket = CSSMDrivePacket();
+	MCCStatus.cssmDrivePacket = CSSMDrivePacket();
+	MCCStatus.cssmDrivePacket.DriveMode = CSSMDrivePacket::DriveModes::DRV;
+	MCCStatus.cssmDrivePacket.SpeedSetting = commanded;
+
+	float travelled = 0.0f;									// mm
+	float speed = 0.0f;										// mm/s
+	float setting = 0.0f;
+	uint32_t needTime = 0;
+	uint32_t stoppedTime = 0;
+	for (uint32_t t = 1; t <= 30000 && (stoppedTime == 0 || t - stoppedTime < 1000); t++)
+	{
+		HostClock::Advance(1000);
+		float angle = TurretAngle(turret, t);
+		if (t % UpdateRangeInterval == 0)
+		{
+			float range = (WallRange - travelled) / cosf(angle * DEG_TO_RAD);
+			bool valid = (fabsf(angle) < 90.0f && range < VL53L1XMaxRange);
+			controller.UpdateCollisionGuard(valid ? (uint16_t)range : 0, (int)lroundf(angle), millis());
+			if (needTime == 0 && result.LimitedRange == 0.0f && controller.GetGuardSpeedLimit() < setting)
+			{
+				needTime = t;
+			}
+		}
+		if (t % UpdateMotorControllerInterval == MotorControllerPhase)
+		{
+			// As ReadStatus() reads them back from the RoboClaw:
+			MCCStatus.mcStatus.M1Speed = (int32_t)(speed * controller.KRTrack);
+			MCCStatus.mcStatus.M2Speed = (int32_t)(speed * controller.KLTrack);
+			float limit = controller.GetGuardSpeedLimit();
+			controller.Update();
+			setting = (MCCStatus.mcStatus.M2SpeedSetting / controller.KLTrack + MCCStatus.mcStatus.M1SpeedSetting / controller.KRTrack) / 2.0f;
+			result.LateTicks += (setting > limit + GuardLimitStep);
+			if (needTime != 0 && result.LimitedRange == 0.0f && setting < commanded - 1.0f)
+			{
+				result.LimitedRange = WallRange - travelled;
+				result.Reaction = t - needTime;
+			}
+		}
+
+		float step = GuardDeceleration / 1000.0f;
+		speed += constrain(setting - speed, -step, step);
+		travelled += speed / 1000.0f;
+		result.MaxSpeed = max(result.MaxSpeed, speed);
+		if (result.ApproachTime == 0 && WallRange - travelled <= 1000.0f)
+		{
+			result.ApproachTime = t;
+		}
+		if (stoppedTime == 0 && result.LimitedRange != 0.0f && speed <= 0.0f)
+		{
+			stoppedTime = t;
+		}
+		else if (speed > 0.0f)
+		{
+			stoppedTime = 0;
+		}
+	}
+	result.Gap = WallRange - travelled;
+	return result;
+}
+
+static void TestApproaches()
+{
+	const char* names[] = { "ahead", "scanning" };
+	for (int turret = Ahead; turret <= Scanning; turret++)
+	{
+		uint32_t approachTime[3];
+		int i = 0;
+		for (float commanded : { 200.0f, 400.0f, 600.0f })
+		{
+			Approach approach = Simulate(commanded, (TurretModes)turret);
+			printf("Guard, turret %-8s %3.0f mm/s: limited at %4.0f mm after %2lu ms, stopped %5.1f mm short, "
+				"%4.1f s to within 1 m\n", names[turret], commanded, approach.LimitedRange, (unsigned long)approach.Reaction,
+				approach.Gap, approach.ApproachTime / 1000.0f);
+			CHECK(approach.Gap >= GuardStopDistance && approach.Gap <= GuardStopDistance + StopTolerance);
+			CHECK(approach.LimitedRange > GuardStopDistance && approach.Reaction <= UpdateMotorControllerInterval);
+			CHECK(approach.LateTicks == 0);
+			approachTime[i++] = approach.ApproachTime;
+		}
+
+		// Not held to GuardCreepSpeed: each faster approach gets to the wall sooner
+		CHECK(approachTime[0] < (uint32_t)(1500.0f * 1000.0f / GuardCreepSpeed));
+		CHECK(approachTime[1] < approachTime[0] && approachTime[2] < approachTime[1]);
+	}
+}
+
+static void TestTurretAside()
+{
+	// No range is ever taken: the setting never exceeds GuardCreepSpeed, and the MRS is not stopped
+	RC2x15AMCClass controller;
+	Approach approach = Simulate(400.0f, Aside);
+	CHECK(approach.MaxSpeed <= GuardCreepSpeed && approach.LateTicks == 0);
+	CHECK(approach.ApproachTime > 0 && approach.ApproachTime < (uint32_t)(1600.0f * 1000.0f / GuardCreepSpeed));
+
+	// Off the cone ranges are counted and ignored; a clear range ahead lifts the limit, a wall beside the path does
+	// not hold the MRS back as much as one in it
+	HostClock::Set(1000000);
+	controller.UpdateCollisionGuard(500, GuardConeHalfAngle + 1, millis());
+	CHECK(controller.GuardRangesOutsideCone == 1 && controller.GetGuardSpeedLimit() == GuardCreepSpeed);
+	controller.UpdateCollisionGuard(500, -GuardConeHalfAngle - 1 + 360, millis());
+	CHECK(controller.GuardRangesOutsideCone == 2);
+	controller.UpdateCollisionGuard(3000, 0, millis());
+	float clear = controller.GetGuardSpeedLimit();
+	controller.UpdateCollisionGuard(600, 0, millis() + 25);
+	float wall = controller.GetGuardSpeedLimit();
+	controller.UpdateCollisionGuard(600, 20, millis() + 50);
+	float beside = controller.GetGuardSpeedLimit();
+	CHECK(clear > 600.0f && wall < beside && beside < clear);
+
+	// Stale: GuardCreepSpeed once GuardRangeTimeout has passed
+	HostClock::Advance((GuardRangeTimeout + 100) * 1000);
+	CHECK(controller.GetGuardSpeedLimit() == GuardCreepSpeed);
+}
+
+int main()
+{
+	MCCStatus.Init();
+	TestApproaches();
+	TestTurretAside();
+	return HostTestResult("CollisionGuardTest");
+}
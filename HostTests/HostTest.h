@@ -0,0 +1,27 @@
+/*	HostTest.h
+*	Checks and reporting shared by the host tests
+*
+*/
+
+#ifndef _HOSTTEST_h
+#define _HOSTTEST_h
+
+#include <stdio.h>
+
+static int HostTestFailures = 0;
+
+#define CHECK(condition) \
+	do { if (!(condition)) { HostTestFailures++; printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); } } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance) \
+	do { double a_ = (actual), e_ = (expected); if (fabs(a_ - e_) > (tolerance)) { HostTestFailures++; \
+		printf("%s:%d: %s = %g, expected %g +/- %g\n", __FILE__, __LINE__, #actual, a_, e_, (double)(tolerance)); } } while (0)
+
+/// <returns>Process exit code</returns>
+inline int HostTestResult(const char* name)
+{
+	printf("%s: %s\n", name, (HostTestFailures == 0) ? "PASS" : "FAIL");
+	return (HostTestFailures == 0) ? 0 : 1;
+}
+
+#endif
@@ -0,0 +1,156 @@
+/*	LinkMonitorTest.cpp
+*	LinkMonitorClass sequence accounting: the sequence number wrapping, lost, late and duplicate packets, and the other
+*	end restarting, with the interval histogram, jitter and the score of each statistics window
+*
+*/
+
+#include "HostTest.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\LinkMonitor.h"
+
+constexpr float Nominal = 100.0f;							// ms
+constexpr uint8_t OnTimeBin = 3;							// 95 - 105 % of nominal
+
+/// <summary>
+/// Sends count packets from sequence first, one every Nominal ms from time (us), and advances time past them
+/// </summary>
+static void Receive(LinkMonitorClass& link, uint16_t first, uint16_t count, uint32_t& time)
+{
+	for (uint16_t i = 0; i < count; i++)
+	{
+		link.RecordReceived(first + i, time);
+		time += (uint32_t)(Nominal * 1000.0f);
+	}
+}
+
+static void TestWrap()
+{
+	LinkMonitorClass link;
+	link.Init(Nominal);
+	uint32_t time = 1000000;
+
+	// 65530 to 9, through 65535 and 0:
+	Receive(link, 65530, 16, time);
+	CHECK(link.Received == 16 && link.Lost == 0 && link.Late == 0 && link.Restarts == 0);
+	CHECK(link.Histogram[OnTimeBin] == 15);
+	CHECK_NEAR(link.Jitter, 0.0, 0.001);
+	CHECK_NEAR(link.MeanInterval, Nominal, 0.001);
+}
+
+static void TestLost()
+{
+	LinkMonitorClass link;
+	link.Init(Nominal);
+	uint32_t time = 1000000;
+
+	// 65534 and 65535 received, 0 to 2 lost across the wrap, 3 received three intervals later:
+	Receive(link, 65534, 2, time);
+	time += 3 * (uint32_t)(Nominal * 1000.0f);
+	Receive(link, 3, 1, time);
+	CHECK(link.Received == 3 && link.Lost == 3 && link.Restarts == 0);
+	CHECK(link.Histogram[LinkIntervalBins - 1] == 1);		// 400 % of nominal, in the missing bin
+
+	// The interval spanning the loss is left out of the jitter:
+	CHECK_NEAR(link.Jitter, 0.0, 0.001);
+}
+
+static void TestLateAndDuplicate()
+{
+	LinkMonitorClass link;
+	link.Init(Nominal);
+	uint32_t time = 1000000;
+
+	// 65533 to 65535, then 65535 again, 65534 again, and 0 and 1 in order:
+	Receive(link, 65533, 3, time);
+	link.RecordReceived(65535, time);
+	link.RecordReceived(65534, time);
+	Receive(link, 0, 2, time);
+	CHECK(link.Late == 2 && link.Received == 5 && link.Lost == 0 && link.Restarts == 0);
+
+	// Out of order: 3 arrives before 2, which is then late; 4 follows on
+	link.RecordReceived(3, time);
+	time += (uint32_t)(Nominal * 1000.0f);
+	link.RecordReceived(2, time);
+	Receive(link, 4, 1, time);
+	CHECK(link.Late == 3 && link.Received == 7 && link.Lost == 1);
+
+	// LinkMaxReorder behind is still late, one further is a restart:
+	link.RecordReceived(5 - LinkMaxReorder, time);
+	CHECK(link.Late == 4 && link.Restarts == 0);
+	link.RecordReceived(5 - LinkMaxReorder - 1, time);
+	CHECK(link.Late == 4 && link.Restarts == 1 && link.Lost == 1);
+}
+
+static void TestRestart()
+{
+	LinkMonitorClass link;
+	link.Init(Nominal);
+	uint32_t time = 1000000;
+
+	// The other end restarts at 0 after 30000, then restarts again after a long outage:
+	Receive(link, 29990, 11, time);
+	time += 5 * (uint32_t)(Nominal * 1000.0f);
+	Receive(link, 0, 10, time);
+	CHECK(link.Restarts == 1 && link.Lost == 0 && link.Received == 21);
+
+	time += 60 * 1000000;
+	Receive(link, 10 + LinkMaxSequenceGap + 1, 10, time);
+	CHECK(link.Restarts == 2 && link.Lost == 0 && link.Received == 31);
+
+	// The intervals across the restarts are not binned:
+	CHECK(link.Histogram[OnTimeBin] == 28);
+	CHECK_NEAR(link.Jitter, 0.0, 0.001);
+
+	// A gap of LinkMaxSequenceGap is loss, not a restart:
+	Receive(link, 20 + 2 * LinkMaxSequenceGap + 1, 1, time);
+	CHECK(link.Restarts == 2 && link.Lost == LinkMaxSequenceGap);
+}
+
+static void TestScore()
+{
+	HostClock::Set(10000000);
+	LinkMonitorClass link;
+	link.Init(Nominal);
+	uint32_t time = 10000000;
+	uint16_t sequence = 0;
+
+	// Four perfect windows:
+	for (int window = 0; window < 4; window++)
+	{
+		Receive(link, sequence, 10, time);
+		sequence += 10;
+		link.RecordSend(true);
+		HostClock::Advance(LinkStatsWindow * 1000);
+		link.Update(millis());
+	}
+	CHECK(link.Score == 100 && link.LossRate == 0.0f && link.FailRate == 0.0f);
+
+	// One packet in ten lost, and one window with nothing received:
+	Receive(link, sequence, 5, time);
+	time += (uint32_t)(Nominal * 1000.0f);
+	Receive(link, sequence + 6, 4, time);
+	sequence += 10;
+	HostClock::Advance(LinkStatsWindow * 1000);
+	link.Update(millis());
+	CHECK_NEAR(link.LossRate, LinkStatsSmoothing * 0.1, 0.0001);
+
+	HostClock::Advance(LinkStatsWindow * 1000);
+	link.Update(millis());
+	CHECK_NEAR(link.LossRate, LinkStatsSmoothing * 0.1 + LinkStatsSmoothing * (1.0 - LinkStatsSmoothing * 0.1), 0.0001);
+	CHECK(link.Score < 75);
+
+	// Not yet the end of a window: nothing changes
+	float lossRate = link.LossRate;
+	HostClock::Advance(LinkStatsWindow * 500);
+	link.Update(millis());
+	CHECK(link.LossRate == lossRate);
+}
+
+int main()
+{
+	TestWrap();
+	TestLost();
+	TestLateAndDuplicate();
+	TestRestart();
+	TestScore();
+	return HostTestResult("LinkMonitorTest");
+}
@@ -0,0 +1,185 @@
+/*	MCCDisplayTest.cpp
+*	MRS MCC LocalDisplayClass drawn on the host framebuffer: every page is drawn in full, identically each time it is
+*	drawn from scratch, and a refresh of its dynamic fields costs less bus traffic than the full draw
+*
+*	The bus traffic of each page is printed and the pages are saved to build/snapshots/MCC_<page>.ppm.
+*
+*	The render budget is checked by running UpdateLocalDisplayTask and UpdateMotorControllerTask as the cooperative
+*	scheduler does, with the clock advanced by the time each transfer takes on the panel bus (drawing time on the
+*	CPU is not simulated), and measuring the motor task jitter while each page is drawn and shown.
+*
+*/
+
+#include "HostTest.h"
+#include "../MRSMCC/src/LocalDisplay.h"
+#include "../MRSMCC/src/MCCControls.h"
+#include "../MRSMCC/src/MCCSensors.h"
+#include <sys/stat.h>
+
+MCCControls mccControls;
+
+/// <summary>
+/// Builds the footer menu as MCCControls::Init() does, without the encoders and buttons it also sets up
+/// </summary>
+static void InitMenu(TFT_eSPI* tft)
+{
+	mccControls.MainMenu = new TFTMenuClass(tft);
+	mccControls.ESPNMenuItem = new MenuItemClass("ESPN", 2, 157, 56, 12, MenuItemClass::MenuItemTypes::OffOn);
+	mccControls.MainMenu->AddItem(mccControls.ESPNMenuItem);
+	mccControls.ESPNMenuItem->SetValue(1);
+	mccControls.MCUARTMenuItem = new MenuItemClass("MCSer", 60, 157, 56, 12, MenuItemClass::MenuItemTypes::OffOn);
+	mccControls.MainMenu->AddItem(mccControls.MCUARTMenuItem);
+	mccControls.MCUARTMenuItem->SetValue(1);
+	mccControls.TBDMenuItem = new MenuItemClass("TBD", 118, 157, 56, 12, MenuItemClass::MenuItemTypes::OffOn);
+	mccControls.MainMenu->AddItem(mccControls.TBDMenuItem);
+	mccControls.BRTMenuItem = new MenuItemClass("BRT", 203, 157, 56, 12, MenuItemClass::MenuItemTypes::Numeric);
+	mccControls.MainMenu->AddItem(mccControls.BRTMenuItem);
+	mccControls.BRTMenuItem->SetMaxValue(255);
+	mccControls.BRTMenuItem->SetValue(DefaultDisplayBrightness);
+	mccControls.NextPageMenuItem = new MenuItemClass("Next", 261, 157, 56, 12, MenuItemClass::MenuItemTypes::Action);
+	mccControls.MainMenu->AddItem(mccControls.NextPageMenuItem);
+}
+
+/// <returns>Pixels of the given colour in the rectangle</returns>
+static int32_t CountColor(TFT_eSPI* tft, int32_t x0, int32_t y0, int32_t w, int32_t h, uint16_t color)
+{
+	int32_t count = 0;
+	for (int32_t y = y0; y < y0 + h; y++)
+	{
+		for (int32_t x = x0; x < x0 + w; x++)
+		{
+			count += (tft->HostPixel(x, y) == color);
+		}
+	}
+	return count;
+}
+
+static void TestPages()
+{
+	const char* names[] = { "SYS", "POW", "COM", "MOT", "DBG", "SEN", "BUS" };
+
+	HostClock::Set(1000000);
+	MCCStatus.Init();
+	LocalDisplay.Init();
+	mccSensors.Init();
+	TFT_eSPI* tft = LocalDisplay.GetTFT();
+	InitMenu(tft);
+	CHECK(tft->width() == 320 && tft->height() == 170);
+	LocalDisplay.SetRenderBudget(0);
+	mkdir("build/snapshots", 0755);
+
+	printf("Page   Full draw: pixels    bytes windows   Refresh: pixels    bytes windows\n");
+	for (uint8_t page = LocalDisplayClass::SYS; page < LocalDisplayClass::NONE; page++)
+	{
+		LocalDisplay.SetCurrentPage((LocalDisplayClass::Pages)page);
+		tft->HostResetCounts();
+		LocalDisplay.Update();
+		uint64_t fullPixels = tft->HostPixelsWritten;
+		uint64_t fullBytes = tft->HostBytesWritten;
+		uint32_t fullWindows = tft->HostWindows;
+		uint32_t hash = tft->HostFrameHash();
+
+		char path[64];
+		snprintf(path, sizeof(path), "build/snapshots/MCC_%s.ppm", names[page]);
+		CHECK(tft->HostWritePPM(path));
+
+		// Whole screen cleared, header ("MRS MCC" in blue) and footer menu drawn:
+		CHECK(fullPixels >= 320u * 170u);
+		CHECK(CountColor(tft, 2, 2, 42, 8, TFT_BLUE) > 20);
+		CHECK(CountColor(tft, 2, 157, 316, 12, TFT_DARKGREY) > 100);
+
+		tft->HostResetCounts();
+		LocalDisplay.Update();
+		printf("%-6s %17lu %8lu %7lu %16lu %8lu %7lu\n", names[page], (unsigned long)fullPixels, (unsigned long)fullBytes,
+			(unsigned long)fullWindows, (unsigned long)tft->HostPixelsWritten, (unsigned long)tft->HostBytesWritten,
+			(unsigned long)tft->HostWindows);
+		CHECK(tft->HostBytesWritten < fullBytes);
+		if (page == LocalDisplayClass::DBG)
+		{
+			continue;									// Shows the statistics of the render pass before
+		}
+		CHECK(tft->HostFrameHash() == hash);
+
+		// Drawn from scratch again, pixel for pixel the same:
+		LocalDisplay.RefreshCurrentPage();
+		CHECK(tft->HostFrameHash() == hash);
+	}
+}
+
+constexpr uint32_t UpdateLocalDisplayInterval = 100000;	// us; as MRSMCC.ino
+constexpr uint32_t UpdateMotorControllerInterval = 50000;	// us
+constexpr uint32_t PanelBusFrequency = 80000000;			// Hz; the T-Display S3's 8 bit parallel bus at 10 MB/s
+
+/// <summary>
+/// Selects a page as the footer menu does, to be drawn by the display task, and runs the display and motor tasks
+/// for 2 s
+/// </summary>
+/// <returns>Largest motor task jitter, us</returns>
+static uint32_t RunTasks(LocalDisplayClass::Pages page)
+{
+	uint32_t start = micros();
+	uint32_t nextDisplay = start;
+	uint32_t nextMotor = start;
+	MCCStatus.MotorTaskStartTime = 0;
+	MCCStatus.MaxMotorTaskJitter = 0;
+
+	LocalDisplay.SetCurrentPage(page);
+	while (micros() - start < 2000000)
+	{
+		// Tasks run in the order they were declared, so the display task goes first when both are due:
+		if ((int32_t)(micros() - nextDisplay) >= 0)
+		{
+			LocalDisplay.Update();
+			nextDisplay += UpdateLocalDisplayInterval;
+		}
+		if ((int32_t)(micros() - nextMotor) >= 0)
+		{
+			MCCStatus.RecordMotorTaskStart(UpdateMotorControllerInterval);
+			nextMotor += UpdateMotorControllerInterval;
+		}
+		HostClock::Advance(100);
+	}
+	return MCCStatus.MaxMotorTaskJitter;
+}
+
+static void TestRenderBudget()
+{
+	const char* names[] = { "SYS", "POW", "COM", "MOT", "DBG", "SEN", "BUS" };
+	uint32_t maxJitter[2][LocalDisplayClass::NONE];
+
+	TFT_eSPI::HostBusFrequency = PanelBusFrequency;
+	for (uint8_t budgeted = 0; budgeted < 2; budgeted++)
+	{
+		LocalDisplay.SetRenderBudget(budgeted ? DefaultRenderBudget : 0);
+		for (uint8_t page = LocalDisplayClass::SYS; page < LocalDisplayClass::NONE; page++)
+		{
+			maxJitter[budgeted][page] = RunTasks((LocalDisplayClass::Pages)page);
+		}
+	}
+	TFT_eSPI::HostBusFrequency = 0;
+
+	printf("Page   Max motor task jitter: whole page   %lu us budget\n", (unsigned long)DefaultRenderBudget);
+	uint32_t worst[2] = { 0, 0 };
+	for (uint8_t page = LocalDisplayClass::SYS; page < LocalDisplayClass::NONE; page++)
+	{
+		printf("%-6s %31lu us %12lu us\n", names[page], (unsigned long)maxJitter[0][page], (unsigned long)maxJitter[1][page]);
+		worst[0] = max(worst[0], maxJitter[0][page]);
+		worst[1] = max(worst[1], maxJitter[1][page]);
+	}
+
+	// Within the budget and one step (a band of the screen being cleared) on every page, where drawing a whole page
+	//at once holds the motor task up for several times as long:
+	uint32_t clearBandTime = (ClearBandHeight * 320 * 2 + HostWindowBytes) * 8000000ull / PanelBusFrequency;
+	for (uint8_t page = LocalDisplayClass::SYS; page < LocalDisplayClass::NONE; page++)
+	{
+		CHECK(maxJitter[1][page] <= DefaultRenderBudget + clearBandTime + 500);
+	}
+	CHECK(worst[0] > 2 * worst[1]);
+}
+
+int main()
+{
+	TestPages();
+	TestRenderBudget();
+	return HostTestResult("MCCDisplayTest");
+}
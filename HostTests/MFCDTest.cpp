@@ -0,0 +1,81 @@
+/*	MFCDTest.cpp
+*	NavModule MFCDClass drawn on the host framebuffer: every page is drawn in full, identically each time it is
+*	activated, and an update of its dynamic fields costs less bus traffic than activating it
+*
+*	The bus traffic of each page is printed and the pages are saved to build/snapshots/MFCD_<page>.ppm.
+*
+*/
+
+#include "HostTest.h"
+#include "../NavModule/src/MFCD.h"
+#include "../NavModule/src/NMControls.h"
+#include <sys/stat.h>
+
+/// <returns>Pixels that are not black in the rectangle</returns>
+static int32_t CountDrawn(TFT_eSPI* tft, int32_t x0, int32_t y0, int32_t w, int32_t h)
+{
+	int32_t count = 0;
+	for (int32_t y = y0; y < y0 + h; y++)
+	{
+		for (int32_t x = x0; x < x0 + w; x++)
+		{
+			count += (tft->HostPixel(x, y) != TFT_BLACK);
+		}
+	}
+	return count;
+}
+
+static void TestPages()
+{
+	const char* names[] = { "NAV", "COM", "SYS", "DBG" };
+
+	HostClock::Set(1000000);
+	NMControls.Init();
+	MFCD.Init();
+	TFT_eSPI* tft = TFT_eSPI::HostPanel;				// MFCD keeps its TFT_eSPI to itself
+	CHECK(tft != nullptr && tft->width() == 240 && tft->height() == 320);
+	mkdir("build/snapshots", 0755);
+
+	printf("Page   Activate: pixels    bytes windows    Update: pixels    bytes windows\n");
+	for (uint8_t page = MFCDClass::NAV; page < MFCDClass::NONE; page++)
+	{
+		tft->HostResetCounts();
+		MFCD.ActivatePage((MFCDClass::PageIDs)page);
+		MFCD.Update();
+		uint64_t fullPixels = tft->HostPixelsWritten;
+		uint64_t fullBytes = tft->HostBytesWritten;
+		uint32_t fullWindows = tft->HostWindows;
+		uint32_t hash = tft->HostFrameHash();
+
+		char path[64];
+		snprintf(path, sizeof(path), "build/snapshots/MFCD_%s.ppm", names[page]);
+		CHECK(tft->HostWritePPM(path));
+
+		// Whole screen cleared, header and the left OSB labels (NAV, COM, SYS, DBG) drawn:
+		CHECK(fullPixels >= 240u * 320u);
+		CHECK(CountDrawn(tft, 0, 0, 240, 10) > 50);
+		for (int32_t osb = 0; osb < 4; osb++)
+		{
+			CHECK(CountDrawn(tft, 0, 40 + 70 * osb, 30, 20) > 20);
+		}
+
+		tft->HostResetCounts();
+		MFCD.Update();
+		printf("%-6s %16lu %8lu %7lu %15lu %8lu %7lu\n", names[page], (unsigned long)fullPixels, (unsigned long)fullBytes,
+			(unsigned long)fullWindows, (unsigned long)tft->HostPixelsWritten, (unsigned long)tft->HostBytesWritten,
+			(unsigned long)tft->HostWindows);
+		CHECK(tft->HostBytesWritten < fullBytes);
+		CHECK(tft->HostFrameHash() == hash);
+
+		// Activated again, pixel for pixel the same:
+		MFCD.ActivatePage((MFCDClass::PageIDs)page);
+		MFCD.Update();
+		CHECK(tft->HostFrameHash() == hash);
+	}
+}
+
+int main()
+{
+	TestPages();
+	return HostTestResult("MFCDTest");
+}
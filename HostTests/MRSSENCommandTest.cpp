@@ -0,0 +1,171 @@
+/*	MRSSENCommandTest.cpp
+*	MRSSENsorsClass command path: sequence stamping, resend on a missing or Dropped acknowledge, give up after
+*	MRSSENCommandRetries, and one command in flight at a time; the MRS SEN module is simulated on the host Wire bus
+*
+*/
+
+#include "HostTest.h"
+#include "../MRSMCC/src/MRSSENsors.h"
+
+#include <vector>
+
+class FakeMRSSEN : public HostI2CDevice
+{
+public:
+	enum Modes
+	{
+		Acknowledge,										// Queue and execute every command
+		Silent,												// Never update the acknowledge register
+		DropFirst,											// Report the first copy of each command Dropped
+	};
+
+	Modes Mode = Acknowledge;
+	std::vector<CSSMCommandPacket> Received;				// Every command packet written, including resends
+	std::vector<CSSMCommandPacket> Executed;				// After the MRS SEN duplicate check
+	MRSSENCommandAck Ack;
+	uint8_t SelectedAddress = 0;
+	uint8_t LastQueuedSequence = 0;
+
+	bool OnWrite(uint8_t address, const uint8_t* data, size_t length) override
+	{
+		if (address != defaultMRSSENAddress)
+		{
+			return false;
+		}
+		if (length == 2)
+		{
+			SelectedAddress = data[0];
+		}
+		else if (length == sizeof(CSSMCommandPacket))
+		{
+			CSSMCommandPacket packet;
+			memcpy(&packet, data, sizeof(packet));
+			Received.push_back(packet);
+			if (Mode == Silent)
+			{
+				return true;
+			}
+			bool firstCopy = (Received.size() < 2 || Received[Received.size() - 2].sequence != packet.sequence);
+			Ack.Sequence = packet.sequence;
+			Ack.Command = packet.command;
+			if (Mode == DropFirst && firstCopy)
+			{
+				Ack.Status = MRSSENCommandAck::Dropped;
+			}
+			else if (packet.sequence != LastQueuedSequence)
+			{
+				LastQueuedSequence = packet.sequence;
+				Executed.push_back(packet);
+				Ack.Status = MRSSENCommandAck::Accepted;
+			}
+		}
+		return true;
+	}
+
+	size_t OnRead(uint8_t address, uint8_t* data, size_t length) override
+	{
+		if (address != defaultMRSSENAddress || SelectedAddress != MRSSEN_CommandAckAddress)
+		{
+			return 0;
+		}
+		memcpy(data, &Ack, min(length, sizeof(Ack)));
+		return length;
+	}
+};
+
+static CSSMCommandPacket MakeCommand(CSSMCommandPacket::CSSMCommandCodes command, int16_t position = 0)
+{
+	CSSMCommandPacket packet;
+	packet.command = command;
+	packet.turretPosition = position;
+	return packet;
+}
+
+static void Service(MRSSENsorsClass& sensors, int times, uint32_t period = 20)
+{
+	for (int i = 0; i < times; i++)
+	{
+		sensors.ServiceCommands();
+		HostClock::Advance(period * 1000);
+	}
+}
+
+static void TestAcknowledged()
+{
+	FakeMRSSEN sen;
+	MRSSENsorsClass sensors;
+	Wire.Device = &sen;
+	HostClock::Set(1000000);
+	sensors.Init();
+
+	CHECK(sensors.SendCommand(MakeCommand(CSSMCommandPacket::SetTurretPosition, 800)));
+	CHECK(sensors.SendCommand(MakeCommand(CSSMCommandPacket::StartTurretScan)));
+	Service(sensors, 1);
+	CHECK(sen.Received.size() == 1);						// The second command waits for the first to be acknowledged
+	Service(sensors, 3);
+	CHECK(sen.Received.size() == 2 && sen.Executed.size() == 2);
+	CHECK(sen.Executed.size() == 2 && sen.Executed[0].turretPosition == 800 && sen.Executed[1].command == CSSMCommandPacket::StartTurretScan);
+	CHECK(sen.Received.size() == 2 && (uint8_t)(sen.Received[1].sequence - sen.Received[0].sequence) == 1);
+	CHECK(sensors.GetCommandAck().Sequence == sensors.GetCommandSequence());
+	CHECK(!sensors.IsCommandInFlight() && sensors.CommandsResent == 0 && sensors.CommandsFailed == 0);
+}
+
+static void TestDropped()
+{
+	FakeMRSSEN sen;
+	MRSSENsorsClass sensors;
+	sen.Mode = FakeMRSSEN::DropFirst;
+	Wire.Device = &sen;
+	HostClock::Set(1000000);
+	sensors.Init();
+
+	sensors.SendCommand(MakeCommand(CSSMCommandPacket::HomeTurret));
+	Service(sensors, 4);
+	CHECK(sen.Received.size() == 2 && sen.Received[0].sequence == sen.Received[1].sequence);
+	CHECK(sen.Executed.size() == 1);
+	CHECK(sensors.CommandsResent == 1 && sensors.CommandsFailed == 0 && !sensors.IsCommandInFlight());
+}
+
+static void TestSilent()
+{
+	FakeMRSSEN sen;
+	MRSSENsorsClass sensors;
+	sen.Mode = FakeMRSSEN::Silent;
+	Wire.Device = &sen;
+	HostClock::Set(1000000);
+	sensors.Init();
+
+	sensors.SendCommand(MakeCommand(CSSMCommandPacket::StopTurretScan));
+	sensors.SendCommand(MakeCommand(CSSMCommandPacket::StartTurretScan));
+	Service(sensors, 1);
+	uint32_t timeouts = 0;
+	while (sensors.CommandsFailed == 0 && timeouts++ < 2 * (MRSSENCommandRetries + 2))
+	{
+		Service(sensors, MRSSENCommandAckTimeout / 20);
+	}
+	CHECK(sensors.CommandsFailed == 1 && sensors.CommandsResent == MRSSENCommandRetries);
+	CHECK(sen.Received.size() == 1u + MRSSENCommandRetries + 1u);		// Original, resends, then the next command
+	CHECK(sen.Received.back().command == CSSMCommandPacket::StartTurretScan);
+	CHECK((uint8_t)(sen.Received.back().sequence - sen.Received.front().sequence) == 1);
+}
+
+static void TestQueueFull()
+{
+	MRSSENsorsClass sensors;
+	Wire.Device = nullptr;
+	int queued = 0;
+	for (int i = 0; i < MRSSENCommandQueueSize + 2; i++)
+	{
+		queued += sensors.SendCommand(MakeCommand(CSSMCommandPacket::SetTurretPosition, i)) ? 1 : 0;
+	}
+	CHECK(queued == MRSSENCommandQueueSize - 1);
+}
+
+int main()
+{
+	TestAcknowledged();
+	TestDropped();
+	TestSilent();
+	TestQueueFull();
+	return HostTestResult("MRSSENCommandTest");
+}
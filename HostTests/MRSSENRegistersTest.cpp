@@ -0,0 +1,312 @@
+/*	MRSSENRegistersTest.cpp
+*	MRSSENsorsClass::Update() against the MRS SEN MRSSENRegistersClass register file on the host Wire bus: bytes and
+*	transactions per update reading only the dirty registers against reading the whole map, and new readings
+*	published between any two transactions of an update are never lost to the acknowledge clearing the dirty mask
+*	nor mixed with older ones under one sequence number
+*
+*/
+
+#include "HostTest.h"
+#include "../MRSMCC/src/MRSSENsors.h"
+#include "../MRSSENXIAOS3/src/MRSSENRegisters.h"
+#include "../MRSSENXIAOS3/src/MRSSENStatus.h"
+
+#include <functional>
+#include <vector>
+#include <random>
+
+constexpr uint32_t BusClock = 400000;						// Hz; MCC I2C bus
+constexpr uint32_t PublishPeriod = 20;						// ms; MRS SEN UpdateNavSensorsPeriod
+constexpr uint32_t UpdatePeriod = 200;						// ms; MCC UpdateMRSSENInterval
+constexpr uint32_t DataRegisterBits = (1UL << MRSSEN_DataRegisterCount) - 1;
+
+class TestRegisters : public MRSSENRegistersClass
+{
+public:
+	uint32_t GetDirtyMask() const { return DirtyMask.load(); }
+	const uint8_t* GetPublished() const { return Staging.Data; }
+};
+
+class TestSensors : public MRSSENsorsClass
+{
+public:
+	uint32_t GetPendingMask() const { return PendingMask; }
+
+	/// <summary>
+	/// Burst reads every data register regardless of the dirty mask
+	/// </summary>
+	bool ReadFullMap()
+	{
+		uint8_t data[MRSSEN_DataEndAddress - MRSSEN_DataStartAddress];
+		LastUpdateBytes = 0;
+		LastUpdateTransactions = 0;
+		if (!ReadRegisters(MRSSEN_DataStartAddress, data, sizeof(data)))
+		{
+			return false;
+		}
+		for (uint8_t i = 0; i < MRSSEN_DataRegisterCount; i++)
+		{
+			MRSSENRegisterMap::Decode(i, &data[i * MRSSEN_RegisterSize], mrsSensorPacket);
+		}
+		return true;
+	}
+};
+
+/// <summary>
+/// The MRS SEN module's MCC bus slave, dispatching as MCCI2CReceiveEvent() and MCCI2CRequestEvent()
+/// </summary>
+class SimulatedMRSSEN : public HostI2CDevice
+{
+public:
+	TestRegisters Registers;
+	TwoWire SlaveBus;
+	uint32_t Bytes = 0;										// On the wire, including address bytes
+	uint32_t Transactions = 0;
+	std::function<void()> BeforeTransaction;				// Lets the test publish new readings at any point of an update
+
+	bool OnWrite(uint8_t address, const uint8_t* data, size_t length) override
+	{
+		if (address != defaultMRSSENAddress)
+		{
+			return false;
+		}
+		Count(length);
+		if (length > 0 && length <= 2)
+		{
+			Registers.Select(data, (int)length);
+		}
+		else if (length == 1 + sizeof(uint32_t) && data[0] == MRSSEN_DirtyMaskAddress)
+		{
+			uint32_t mask;
+			memcpy(&mask, &data[1], sizeof(mask));
+			Registers.AcknowledgeDirtyMask(mask);
+		}
+		return true;
+	}
+
+	size_t OnRead(uint8_t address, uint8_t* data, size_t length) override
+	{
+		if (address != defaultMRSSENAddress)
+		{
+			return 0;
+		}
+		Count(length);
+		SlaveBus.SlaveTxBuffer.clear();
+		Registers.Serve(SlaveBus);
+		size_t served = min(length, SlaveBus.SlaveTxBuffer.size());
+		memcpy(data, SlaveBus.SlaveTxBuffer.data(), served);
+		return served;
+	}
+
+protected:
+	void Count(size_t length)
+	{
+		if (BeforeTransaction)
+		{
+			BeforeTransaction();
+		}
+		Bytes += 1 + (uint32_t)length;
+		Transactions++;
+	}
+};
+
+/// <summary>
+/// Sensor readings as the MRS SEN tasks update them: the timestamp always moves on; the pose, velocity, range and
+/// battery readings only when the robot is driving
+/// </summary>
+static void NextReadings(MRSSensorPacket& packet, uint32_t tick, bool driving)
+{
+	packet.Timestamp = 1000000000ULL + (uint64_t)tick * PublishPeriod * 1000;
+	packet.Sequence++;
+	if (!driving)
+	{
+		return;
+	}
+	float t = tick * PublishPeriod * 0.001f;
+	packet.ODOSPosX = 0.2f * t;
+	packet.ODOSPosY = 0.5f * sinf(0.3f * t);
+	packet.ODOSHdg = 20.0f * cosf(0.3f * t);
+	packet.ODOSVelX = 0.2f + 0.01f * (tick % 3);
+	packet.ODOSVelY = 0.15f * cosf(0.3f * t);
+	packet.ODOSVelHdg = -6.0f * sinf(0.3f * t);
+	packet.FWDVL53L1XRange = 1500 - (int)(100.0f * t) % 1000;
+	packet.RINA219Current = 850.0f + (tick % 7);
+	packet.RINA219Power = 10.6f * packet.RINA219Current;
+}
+
+/// <returns>Bit n set where data register n differs between two register images</returns>
+static uint32_t DifferingRegisters(const uint8_t* a, const uint8_t* b)
+{
+	uint32_t differing = 0;
+	for (uint8_t i = 0; i < MRSSEN_DataRegisterCount; i++)
+	{
+		uint8_t address = MRSSENRegisterMap::GetRegisterAddress(i);
+		if (memcmp(&a[address], &b[address], MRSSEN_RegisterSize) != 0)
+		{
+			differing |= (1UL << i);
+		}
+	}
+	return differing;
+}
+
+/// <returns>Bit n set where data register n of the MCC's packet differs from the given image</returns>
+static uint32_t UnreadRegisters(TestSensors& sensors, const uint8_t* image)
+{
+	MRSSensorPacket packet;
+	uint8_t read[MRSSEN_DataEndAddress];
+	sensors.getMRSSensorPacket(packet);
+	MRSSENRegisterMap::Encode(packet, read);
+	return DifferingRegisters(read, image);
+}
+
+/// <returns>Bit n set where data register n of the MCC's packet differs from the last one the MRS SEN published</returns>
+static uint32_t UnreadRegisters(SimulatedMRSSEN& sen, TestSensors& sensors)
+{
+	return UnreadRegisters(sensors, sen.Registers.GetPublished());
+}
+
+/// <summary>
+/// Mean bytes and transactions per MCC update over 100 updates, with the MRS SEN publishing in between
+/// </summary>
+static void MeasureUpdates(bool driving, bool fullMap, double& bytes, double& transactions)
+{
+	SimulatedMRSSEN sen;
+	TestSensors sensors;
+	MRSSensorPacket packet;
+	Wire.Device = &sen;
+	Wire.setClock(BusClock);
+	HostClock::Set(1000000);
+	sen.Registers.Init();
+	sensors.Init();
+	sensors.Update();										// Every register is fetched once
+
+	uint32_t tick = 0;
+	uint32_t totalBytes = 0;
+	uint32_t totalTransactions = 0;
+	int mismatches = 0;
+	constexpr int Updates = 100;
+	for (int update = 0; update < Updates; update++)
+	{
+		for (uint32_t i = 0; i < UpdatePeriod / PublishPeriod; i++)
+		{
+			NextReadings(packet, tick++, driving);
+			sen.Registers.Publish(packet);
+		}
+		sen.Bytes = 0;
+		sen.Transactions = 0;
+		CHECK(fullMap ? sensors.ReadFullMap() : sensors.Update());
+		mismatches += (UnreadRegisters(sen, sensors) != 0);
+		mismatches += (sen.Bytes != sensors.LastUpdateBytes || sen.Transactions != sensors.LastUpdateTransactions);
+		totalBytes += sen.Bytes;
+		totalTransactions += sen.Transactions;
+	}
+	CHECK(mismatches == 0);
+	bytes = (double)totalBytes / Updates;
+	transactions = (double)totalTransactions / Updates;
+}
+
+static void TestBusUsage()
+{
+	const char* names[] = { "stationary", "driving" };
+	double dirtyBytes[2];
+	double fullBytes[2];
+	for (int driving = 0; driving < 2; driving++)
+	{
+		double dirtyTransactions, fullTransactions;
+		MeasureUpdates(driving, false, dirtyBytes[driving], dirtyTransactions);
+		MeasureUpdates(driving, true, fullBytes[driving], fullTransactions);
+		printf("MRS SEN update, %s: dirty mask %.1f bytes in %.1f transactions (%.0f us at 400 kHz), "
+			"full map %.1f bytes in %.1f transactions (%.0f us)\n", names[driving],
+			dirtyBytes[driving], dirtyTransactions, dirtyBytes[driving] * 9.0e6 / BusClock,
+			fullBytes[driving], fullTransactions, fullBytes[driving] * 9.0e6 / BusClock);
+	}
+
+	// Stationary, only the timestamp changes: the mask and its acknowledge cost less than the registers left unread
+	CHECK(dirtyBytes[0] * 2.0 < fullBytes[0]);
+}
+
+/// <summary>
+/// Publishes at random points between the transactions of each update; after every update each register the MCC has
+/// not caught up with must still be flagged, either in the MRS SEN dirty mask or in the MCC pending mask, and every
+/// register the update changed must hold its value in the snapshot the packet's sequence number names
+/// </summary>
+static void TestAcknowledgeLosesNothing()
+{
+	SimulatedMRSSEN sen;
+	TestSensors sensors;
+	MRSSensorPacket packet;
+	std::vector<std::vector<uint8_t>> published;			// Register image of each snapshot, by sequence number
+	std::mt19937 random(1);
+	uint32_t tick = 0;
+	Wire.Device = &sen;
+	HostClock::Set(1000000);
+	sen.Registers.Init();
+	sensors.Init();
+	published.emplace_back(sen.Registers.GetPublished(), sen.Registers.GetPublished() + MRSSEN_DataEndAddress);
+	sen.BeforeTransaction = [&]()
+		{
+			if (random() % 3 == 0)
+			{
+				NextReadings(packet, tick++, true);
+				if (random() % 2)
+				{
+					packet.TurretPosition = (int)(random() % 360) - 180;
+				}
+				if (random() % 4 == 0)
+				{
+					packet.RINA219SOC = (float)(random() % 100);
+				}
+				sen.Registers.Publish(packet);
+				published.emplace_back(sen.Registers.GetPublished(), sen.Registers.GetPublished() + MRSSEN_DataEndAddress);
+			}
+		};
+
+	int lost = 0;
+	int mixed = 0;
+	int dropped = 0;
+	int publishedDuringUpdate = 0;
+	for (int update = 0; update < 2000; update++)
+	{
+		uint32_t publishCount = sen.Registers.PublishCount;
+		MRSSensorPacket before;
+		uint8_t beforeImage[MRSSEN_DataEndAddress];
+		sensors.getMRSSensorPacket(before);
+		MRSSENRegisterMap::Encode(before, beforeImage);
+		dropped += !sensors.Update();
+		publishedDuringUpdate += (sen.Registers.PublishCount != publishCount);
+		uint32_t flagged = sen.Registers.GetDirtyMask() | sensors.GetPendingMask();
+		if (UnreadRegisters(sen, sensors) & ~flagged)
+		{
+			lost++;
+		}
+
+		MRSSensorPacket read;
+		sensors.getMRSSensorPacket(read);
+		uint32_t changed = UnreadRegisters(sensors, beforeImage);
+		if (read.Sequence >= published.size() || (changed & UnreadRegisters(sensors, published[read.Sequence].data())))
+		{
+			mixed++;
+		}
+	}
+	printf("MRS SEN acknowledge: %d of 2000 updates overlapped a publish, %d lost a change, %d mixed snapshots; "
+		"%lu bursts from different snapshots, %d updates dropped\n", publishedDuringUpdate, lost, mixed,
+		(unsigned long)sensors.SnapshotMismatches, dropped);
+	CHECK(publishedDuringUpdate > 1000);
+	CHECK(lost == 0);
+	CHECK(mixed == 0);
+	CHECK(sensors.SnapshotMismatches > 0);
+	CHECK(dropped * 2 < 2000);								// A publish every three transactions is far more often than the 50 Hz of the MRS SEN
+
+	// Once the readings stop changing, one more update catches up completely:
+	sen.BeforeTransaction = nullptr;
+	CHECK(sensors.Update());
+	CHECK(UnreadRegisters(sen, sensors) == 0);
+	CHECK(((sen.Registers.GetDirtyMask() | sensors.GetPendingMask()) & DataRegisterBits) == 0);
+}
+
+int main()
+{
+	TestBusUsage();
+	TestAcknowledgeLosesNothing();
+	return HostTestResult("MRSSENRegistersTest");
+}
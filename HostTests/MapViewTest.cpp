@@ -0,0 +1,283 @@
+/*	MapViewTest.cpp
+*	MRSCommon Trail simplification, and the CSSMS3 MapView drawing only what has changed on the TileRenderer canvas
+*	against a full redraw of the same view, on a long roaming run with occupancy tiles streaming in from an MCC grid;
+*	the waypoint is only drawn while it is valid
+*
+*/
+
+#include "HostTest.h"
+#include "../CSSMS3/src/MapView.h"
+#include <vector>
+
+constexpr int32_t MapX = 2;								// As CSSMS3Display::Init()
+constexpr int32_t MapY = 13;
+constexpr int32_t MapW = 316;
+constexpr int32_t MapH = 104;
+
+/// <summary>
+/// MapView that can redraw the whole of another view's map as it stands, to compare with what that view has drawn
+/// </summary>
+class TestMapView : public MapView
+{
+public:
+	void RedrawAs(const TestMapView& shown, float x, float y, float heading)
+	{
+		ViewX = shown.ViewX;
+		ViewY = shown.ViewY;
+		WaypointDrawn = shown.WaypointDrawn;
+		DrawnWaypointX = shown.DrawnWaypointX;
+		DrawnWaypointY = shown.DrawnWaypointY;
+		DrawRegion(X, Y, W, H);
+		DrawMarker(ToPixels(x), ToPixels(y), heading);
+	}
+
+	/// <summary>
+	/// Update() with the whole map redrawn, as on every update before only changes were drawn
+	/// </summary>
+	void FullUpdate(float x, float y, float heading)
+	{
+		MapDrawn = false;
+		Update(x, y, heading);
+	}
+};
+
+/// <summary>
+/// Pose at 10 Hz on a roaming figure of eight that drifts east
+/// </summary>
+static void Pose(int i, float& x, float& y, float& heading)
+{
+	float t = i * 0.1f;
+	x = 3.0f * sinf(t * 0.05f) + 0.02f * t;
+	y = 1.5f * sinf(t * 0.1f);
+	heading = atan2f(0.15f * cosf(t * 0.1f), 0.15f * cosf(t * 0.05f) + 0.02f) * RAD_TO_DEG;
+}
+
+static float SegmentDistance(const TrailPoint& p, const TrailPoint& a, const TrailPoint& b)
+{
+	float dx = b.X - a.X;
+	float dy = b.Y - a.Y;
+	float lengthSquared = dx * dx + dy * dy;
+	float t = (lengthSquared > 0.0f) ? constrain(((p.X - a.X) * dx + (p.Y - a.Y) * dy) / lengthSquared, 0.0f, 1.0f) : 0.0f;
+	return hypotf(p.X - a.X - t * dx, p.Y - a.Y - t * dy);
+}
+
+static void TestTrail()
+{
+	RobotTrail trail(RobotTrailSpacing, RobotTrailTolerance);
+	std::vector<TrailPoint> added;
+	for (int i = 0; i < 20000; i++)
+	{
+		float x, y, heading;
+		Pose(i, x, y, heading);
+		if (trail.Add(x, y))
+		{
+			added.push_back({ x, y });
+		}
+	}
+	CHECK(trail.Added == added.size() && trail.GetCount() <= RobotTrailSize);
+	CHECK(trail.Compressions > 0 && trail.Revision == trail.Compressions);
+
+	// Every point added is still within the tolerances of the simplifications it went through:
+	float worst = 0.0f;
+	for (const TrailPoint& p : added)
+	{
+		float distance = 1.0e9f;
+		for (uint16_t i = 1; i < trail.GetCount(); i++)
+		{
+			distance = fminf(distance, SegmentDistance(p, trail.Get(i - 1), trail.Get(i)));
+		}
+		worst = fmaxf(worst, distance);
+	}
+	printf("Trail: %lu points added, %u kept after %lu simplifications, tolerance %.3f m, worst deviation %.3f m\n",
+		(unsigned long)trail.Added, trail.GetCount(), (unsigned long)trail.Compressions, trail.Tolerance, worst);
+	CHECK(worst <= 2.0f * trail.Tolerance);
+
+	// The newest quarter keeps every point:
+	uint16_t count = trail.GetCount();
+	for (uint16_t i = 0; i < RobotTrailSize / 4; i++)
+	{
+		const TrailPoint& p = added[added.size() - 1 - i];
+		CHECK(trail.Get(count - 1 - i).X == p.X && trail.Get(count - 1 - i).Y == p.Y);
+	}
+}
+
+/// <returns>Pixels of the map area that differ between two canvases</returns>
+static int32_t CountDiffering(TileRenderer& a, TileRenderer& b)
+{
+	int32_t count = 0;
+	for (int32_t y = MapY; y < MapY + MapH; y++)
+	{
+		for (int32_t x = MapX; x < MapX + MapW; x++)
+		{
+			count += (a.readPixel(x, y) != b.readPixel(x, y));
+		}
+	}
+	return count;
+}
+
+/// <returns>Pixels of the given colour in the map area of the panel</returns>
+static int32_t CountColor(TFT_eSPI& panel, uint16_t color)
+{
+	int32_t count = 0;
+	for (int32_t y = MapY; y < MapY + MapH; y++)
+	{
+		for (int32_t x = MapX; x < MapX + MapW; x++)
+		{
+			count += (panel.HostPixel(x, y) == color);
+		}
+	}
+	return count;
+}
+
+static void TestRoaming()
+{
+	MapGrid mccMap;											// The MCC's grid, sending its changed tiles
+	MapGrid map;
+	RobotTrail trail(RobotTrailSpacing, RobotTrailTolerance);
+	TFT_eSPI shownPanel;
+	TFT_eSPI redrawnPanel;
+	shownPanel.setRotation(3);
+	redrawnPanel.setRotation(3);
+	TileRenderer shownCanvas(&shownPanel);
+	TileRenderer redrawnCanvas(&redrawnPanel);
+	shownCanvas.Init();
+	redrawnCanvas.Init();
+	TestMapView shown;
+	TestMapView redrawn;
+	CHECK(shown.Init(&shownCanvas, &map, &trail, MapX, MapY, MapW, MapH));
+	CHECK(redrawn.Init(&redrawnCanvas, &map, &trail, MapX, MapY, MapW, MapH));
+
+	float x, y, heading;
+	Pose(0, x, y, heading);
+	shown.SetWaypoint(true, 2.0f, 1.0f);
+	shownCanvas.BeginFrame();
+	shown.DrawFrame(x, y, heading);
+	shownCanvas.Flush();
+
+	constexpr int Frames = 6000;
+	uint64_t shownPixels = 0;
+	uint64_t shownBytes = 0;
+	uint64_t redrawnPixels = 0;
+	int redraws = 0;
+	int32_t differing = 0;
+	int32_t notPushed = 0;
+	for (int i = 1; i < Frames; i++)
+	{
+		Pose(i, x, y, heading);
+		trail.Add(x, y);
+		if (i % 5 == 0)
+		{
+			// A scan around the robot every half second, and up to two tiles sent
+			mccMap.SetCentre(x, y);
+			for (int bearing = 0; bearing < 360; bearing += 6)
+			{
+				mccMap.AddRay(x, y, bearing, (uint16_t)(1800.0f + 300.0f * sinf(bearing * 0.1f + i * 0.001f)));
+			}
+			OccupancyTilePacket tile;
+			for (int n = 0; n < 2 && mccMap.ExportTile(tile); n++)
+			{
+				map.ApplyTile(tile);
+			}
+		}
+		if (i % 600 == 0)
+		{
+			shown.SetWaypoint(true, x + 1.0f, y - 0.5f);
+		}
+
+		shownCanvas.BeginFrame();
+		shown.Update(x, y, heading);
+		shownCanvas.Flush();
+		shownPixels += shownCanvas.PixelsDrawn;
+		shownBytes += shownCanvas.BytesPushed;
+
+		if (i % 50 == 0)
+		{
+			redrawnCanvas.InvalidateAll();
+			redrawnCanvas.BeginFrame();
+			redrawn.RedrawAs(shown, x, y, heading);
+			redrawnCanvas.Flush();
+			redrawnPixels += redrawnCanvas.PixelsDrawn;
+			redraws++;
+
+			differing += CountDiffering(shownCanvas, redrawnCanvas);
+			for (int32_t p = 0; p < 320 * 170; p++)
+			{
+				notPushed += (shownPanel.HostPixel(p % 320, p / 320) != shownCanvas.readPixel(p % 320, p / 320));
+			}
+		}
+	}
+
+	// Bytes pushed redrawing the whole map on every update of 200 more frames (unchanged tiles are still not pushed):
+	uint64_t redrawnBytes = 0;
+	for (int i = Frames; i < Frames + 200; i++)
+	{
+		Pose(i, x, y, heading);
+		trail.Add(x, y);
+		redrawnCanvas.BeginFrame();
+		redrawn.FullUpdate(x, y, heading);
+		redrawnCanvas.Flush();
+		redrawnBytes += redrawnCanvas.BytesPushed;
+	}
+
+	double pixels = (double)shownPixels / (Frames - 1);
+	double bytes = (double)shownBytes / (Frames - 1);
+	double fullPixels = (double)redrawnPixels / redraws;
+	double fullBytes = (double)redrawnBytes / 200;
+	printf("Map: %d frames, %lu full redraws, %lu pans, %lu tiles, %lu trail segments drawn\n", Frames,
+		(unsigned long)shown.FullRedraws, (unsigned long)shown.Pans, (unsigned long)shown.TilesDrawn,
+		(unsigned long)shown.SegmentsDrawn);
+	printf("Map: %.0f pixels drawn and %.0f bytes pushed per update, %.0f and %.0f redrawing the whole map\n",
+		pixels, bytes, fullPixels, fullBytes);
+	CHECK(differing == 0);
+	CHECK(notPushed == 0);
+	CHECK(shown.Pans > 0 && shown.TilesDrawn > 0);
+	CHECK(shown.FullRedraws < (uint32_t)Frames / 50);
+	CHECK(pixels * 10.0 < fullPixels);
+	CHECK(bytes * 5.0 < fullBytes);
+}
+
+static void TestWaypoint()
+{
+	MapGrid map;
+	RobotTrail trail(RobotTrailSpacing, RobotTrailTolerance);
+	TFT_eSPI panel;
+	panel.setRotation(3);
+	TileRenderer canvas(&panel);
+	canvas.Init();
+	MapView view;
+	view.Init(&canvas, &map, &trail, MapX, MapY, MapW, MapH);
+
+	// As CSSMS3Display with no waypoint entered: CSSMDrivePacket has WaypointValid clear and the waypoint at 0, 0
+	CSSMDrivePacket drive;
+	view.SetWaypoint(drive.WaypointValid, drive.WaypointX, drive.WaypointY);
+	canvas.BeginFrame();
+	view.DrawFrame(0.5f, 0.5f, 0.0f);
+	canvas.Flush();
+	uint32_t noWaypoint = panel.HostFrameHash();
+	CHECK(CountColor(panel, TFT_MAGENTA) == 0);
+
+	drive.WaypointValid = true;
+	drive.WaypointX = 1.0f;
+	drive.WaypointY = 0.0f;
+	view.SetWaypoint(drive.WaypointValid, drive.WaypointX, drive.WaypointY);
+	canvas.BeginFrame();
+	view.Update(0.5f, 0.5f, 0.0f);
+	canvas.Flush();
+	CHECK(CountColor(panel, TFT_MAGENTA) > 10);
+
+	// Cleared again: erased, leaving the map as it was
+	drive.WaypointValid = false;
+	view.SetWaypoint(drive.WaypointValid, drive.WaypointX, drive.WaypointY);
+	canvas.BeginFrame();
+	view.Update(0.5f, 0.5f, 0.0f);
+	canvas.Flush();
+	CHECK(panel.HostFrameHash() == noWaypoint);
+}
+
+int main()
+{
+	TestTrail();
+	TestRoaming();
+	TestWaypoint();
+	return HostTestResult("MapViewTest");
+}
@@ -0,0 +1,292 @@
+/*	OccupancyGridTest.cpp
+*	OccupancyGrid ray tracing and tile bookkeeping: Bresenham rays marking free and occupied cells, log-odds
+*	saturation, the window's buffer tiles wrapping around as the robot moves, and dirty tile export to a receiving
+*	grid; ray and cell update rates are reported for several window and cell sizes (host rates, for comparison
+*	between sizes, as MCCMapClass::Benchmark() on the MCC)
+*
+*/
+
+#include "HostTest.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\OccupancyGrid.h"
+
+#include <chrono>
+#include <random>
+
+template <uint8_t N>
+class TestGrid : public OccupancyGrid<N>
+{
+public:
+	TestGrid(uint16_t cellSize) : OccupancyGrid<N>(cellSize) {}
+
+	/// <returns>Log-odds of a world cell, or 0 if its tile is not held</returns>
+	int8_t GetLogOdds(int32_t cx, int32_t cy) const
+	{
+		uint16_t b = OccupancyGrid<N>::GetBufferTile(cx >> 3, cy >> 3);
+		if (this->TileX[b] != (cx >> 3) || this->TileY[b] != (cy >> 3))
+		{
+			return 0;
+		}
+		return this->Cells[b][(cy & 7) * OccupancyTileSide + (cx & 7)];
+	}
+
+	/// <returns>Cells in the window that are not UnknownCell</returns>
+	int CountObserved() const
+	{
+		int32_t ox, oy;
+		int count = 0;
+		this->GetWindowOrigin(ox, oy);
+		for (int32_t cy = oy; cy < oy + this->WindowCells; cy++)
+		{
+			for (int32_t cx = ox; cx < ox + this->WindowCells; cx++)
+			{
+				count += (this->GetState(cx, cy) != UnknownCell);
+			}
+		}
+		return count;
+	}
+};
+
+static void TestRays()
+{
+	TestGrid<8> grid(50);									// 3.2 m window centred on the origin
+
+	// Along the x axis from the middle of cell (0, 0) to 1 m: cells 0 to 19 passed through, cell 20 hit
+	for (int i = 0; i < 3; i++)
+	{
+		grid.AddRay(0.025f, 0.025f, 0.0f, 1000);
+		CHECK(grid.GetState(10, 0) == ((i < 2) ? UncertainCell : FreeCell));		// LogOddsFree is three misses
+	}
+	bool free = true;
+	for (int32_t cx = 0; cx < 20; cx++)
+	{
+		free = free && grid.GetState(cx, 0) == FreeCell && grid.GetLogOdds(cx, 0) == 3 * LogOddsMiss;
+	}
+	CHECK(free);
+	CHECK(grid.GetState(20, 0) == OccupiedCell && grid.GetLogOdds(20, 0) == 3 * LogOddsHit);
+	CHECK(grid.GetState(21, 0) == UnknownCell && grid.GetState(10, 1) == UnknownCell && grid.GetState(-1, 0) == UnknownCell);
+	CHECK(grid.RaysAdded == 3 && grid.CellUpdates == 63);
+
+	// A steep ray into the third quadrant: one cell per row, each a king's move from the last, ending on the hit
+	TestGrid<8> steep(50);
+	steep.AddRay(0.025f, 0.025f, 240.0f, 1200);				// Ends in cell (-12, -21)
+	int32_t cx = 0;
+	int connected = 0;
+	for (int32_t cy = 0; cy >= -21; cy--)
+	{
+		int found = 0;
+		int32_t next = cx;
+		for (int32_t x = cx - 1; x <= cx + 1; x++)
+		{
+			if (steep.GetState(x, cy) != UnknownCell)
+			{
+				found++;
+				next = x;
+			}
+		}
+		connected += (found == 1 || cy == 0);
+		cx = next;
+		float lineX = cy * 0.5773503f;						// Centre of the row on the ideal line, cells
+		CHECK(fabsf(cx - lineX) <= 1.0f);
+	}
+	CHECK(connected == 22 && cx == -12);
+	CHECK(steep.GetLogOdds(-12, -21) == LogOddsHit && steep.CountObserved() == 22);
+
+	// Beyond OccupancyMaxRayRange the ray only clears, and is cut short; no range is ignored
+	TestGrid<16> wide(100);
+	wide.AddRay(0.05f, 0.05f, 90.0f, OccupancyMaxRayRange + 1000);
+	CHECK(wide.GetLogOdds(0, OccupancyMaxRayRange / 100) == LogOddsMiss && wide.GetState(0, OccupancyMaxRayRange / 100 + 1) == UnknownCell);
+	CHECK(wide.CountObserved() == OccupancyMaxRayRange / 100 + 1);
+	wide.AddRay(0.05f, 0.05f, 0.0f, 0);
+	CHECK(wide.RaysAdded == 1);
+}
+
+static void TestSaturation()
+{
+	TestGrid<8> grid(50);
+	for (int i = 0; i < 50; i++)
+	{
+		grid.AddRay(0.025f, 0.025f, 0.0f, 500);
+	}
+	CHECK(grid.GetLogOdds(10, 0) == LogOddsMax && grid.GetLogOdds(0, 0) == LogOddsMin);
+
+	// Saturated, the obstacle clears after (LogOddsMax - LogOddsOccupied) / -LogOddsMiss + 1 misses, not 50 hits' worth
+	int misses = 0;
+	while (grid.GetState(10, 0) == OccupiedCell && misses < 1000)
+	{
+		grid.AddRay(0.025f, 0.025f, 0.0f, 1000);
+		misses++;
+	}
+	CHECK(misses == (LogOddsMax - LogOddsOccupied) / -LogOddsMiss + 1);
+
+	// Log-odds passing through 0 skip it, so an observed cell never becomes unknown again:
+	TestGrid<8> cell(50);
+	for (int i = 0; i < 3; i++)
+	{
+		cell.AddRay(0.025f, 0.025f, 0.0f, 500);				// Cell 10: 30
+	}
+	for (int i = 0; i < 10; i++)
+	{
+		cell.AddRay(0.025f, 0.025f, 0.0f, 1000);			// Cell 10: 0 on the last miss
+	}
+	CHECK(cell.GetLogOdds(10, 0) == -1 && cell.GetState(10, 0) == UncertainCell);
+}
+
+static void TestWraparound()
+{
+	TestGrid<4> grid(100);									// 4 tiles of 0.8 m a side
+	OccupancyTilePacket tile;
+	int32_t tx, ty;
+	uint8_t revision = 0;
+
+	grid.SetCentre(0.0f, 0.0f);
+	grid.AddRay(0.05f, 0.05f, 0.0f, 600);					// Obstacle in cell (6, 0) of world tile (0, 0)
+	grid.AddRay(0.05f, 0.05f, 0.0f, 600);
+	CHECK(grid.GetState(6, 0) == OccupiedCell);
+	uint16_t b = 0;
+	while (b < TestGrid<4>::BufferTiles && !(grid.GetBufferTileInfo(b, tx, ty, revision) && tx == 0 && ty == 0))
+	{
+		b++;
+	}
+	CHECK(b < TestGrid<4>::BufferTiles);
+	uint8_t oldRevision = revision;
+	while (grid.ExportTile(tile))
+	{
+	}
+
+	// Four tiles east the window has moved on by its own width; tile (4, 0) shares the buffer tile of (0, 0)
+	grid.SetCentre(3.25f, 0.05f);
+	CHECK(grid.GetState(6, 0) == OccupiedCell);				// Still held until the buffer tile is reused
+	grid.AddRay(3.15f, 0.05f, 180.0f, 400);					// From cell 31 west to the hit in cell 27, in tile 3
+	CHECK(grid.GetState(6, 0) == OccupiedCell);
+	grid.AddRay(3.25f, 0.05f, 0.0f, 200);					// Cells 32 to 34, in tile 4
+	CHECK(grid.GetState(6, 0) == UnknownCell && grid.GetState(34, 0) == UncertainCell && grid.GetState(27, 0) == UncertainCell);
+	CHECK(grid.GetBufferTileInfo(b, tx, ty, revision) && tx == 4 && ty == 0 && revision != oldRevision);
+
+	// The claimed tile starts clear and is exported as (4, 0):
+	int tiles = 0;
+	bool found = false;
+	while (grid.ExportTile(tile))
+	{
+		tiles++;
+		if (tile.TileX == 4 && tile.TileY == 0)
+		{
+			found = true;
+			int observed = 0;
+			for (uint8_t c = 0; c < OccupancyTileCells; c++)
+			{
+				observed += (tile.GetState(c) != UnknownCell);
+			}
+			CHECK(observed == 3);
+		}
+	}
+	CHECK(found && tiles == 2);
+
+	// The cells of a ray outside the window are skipped, and claim nothing:
+	grid.AddRay(3.25f, 0.05f, 0.0f, 3000);					// To cell 62; the window ends at cell 47
+	CHECK(grid.GetState(47, 0) != UnknownCell && grid.GetState(48, 0) == UnknownCell);
+	CHECK(grid.GetState(6, 0) == UnknownCell);
+
+	// Negative cell indices map to buffer tiles too:
+	grid.SetCentre(-3.15f, -3.15f);
+	grid.AddRay(-3.15f, -3.15f, 225.0f, 300);
+	grid.AddRay(-3.15f, -3.15f, 225.0f, 300);
+	CHECK(grid.GetState(-32, -32) != UnknownCell && grid.GetState(-34, -34) == OccupiedCell);
+}
+
+static void TestExport()
+{
+	TestGrid<8> grid(50);
+	OccupancyGrid<8> received(100);
+	OccupancyTilePacket tile;
+	CHECK(!grid.ExportTile(tile));
+
+	std::mt19937 random(1);
+	for (int i = 0; i < 360; i++)
+	{
+		grid.AddRay(0.0f, 0.0f, (float)i, (uint16_t)(1000 + random() % 500));
+	}
+	int exported = 0;
+	while (grid.ExportTile(tile))
+	{
+		exported++;
+		CHECK(tile.CellSize == 50);
+		received.ApplyTile(tile);
+	}
+	CHECK(exported > 0 && exported <= TestGrid<8>::BufferTiles);
+	CHECK(received.GetCellSize() == 50);
+
+	// The receiver holds the same state in every cell:
+	int32_t ox, oy;
+	int differing = 0;
+	grid.GetWindowOrigin(ox, oy);
+	for (int32_t cy = oy; cy < oy + TestGrid<8>::WindowCells; cy++)
+	{
+		for (int32_t cx = ox; cx < ox + TestGrid<8>::WindowCells; cx++)
+		{
+			differing += (grid.GetState(cx, cy) != received.GetState(cx, cy));
+		}
+	}
+	CHECK(differing == 0);
+
+	// A ray that changes no cell's state dirties nothing; one that does dirties only its tiles
+	for (int i = 0; i < 40; i++)
+	{
+		grid.AddRay(0.0f, 0.0f, 10.0f, 100);				// Saturated both ways
+	}
+	uint32_t revision = grid.Revision;
+	while (grid.ExportTile(tile))
+	{
+	}
+	grid.AddRay(0.0f, 0.0f, 10.0f, 100);
+	CHECK(grid.Revision == revision && !grid.ExportTile(tile));
+
+	grid.AddRay(0.0f, 0.0f, 100.0f, 1400);					// North, into new cells of the two tiles at x = -1 and 0
+	int dirtied = 0;
+	while (grid.ExportTile(tile))
+	{
+		dirtied++;
+		CHECK((tile.TileX == -1 || tile.TileX == 0) && tile.TileY >= 0);
+	}
+	CHECK(dirtied >= 1 && dirtied <= 4);
+
+	// A lost tile is flagged again:
+	grid.MarkTileDirty(0, 0);
+	CHECK(grid.ExportTile(tile) && tile.TileX == 0 && tile.TileY == 0 && !grid.ExportTile(tile));
+	grid.MarkTileDirty(100, 0);								// Outside the window
+	CHECK(!grid.ExportTile(tile));
+}
+
+/// <summary>
+/// Traces random rays from the centre of an N x N tile grid and prints the ray and cell update rates
+/// </summary>
+template <uint8_t N>
+static void Benchmark(uint16_t cellSize)
+{
+	constexpr int Rays = 200000;
+	TestGrid<N>* grid = new TestGrid<N>(cellSize);
+	std::mt19937 random(N);
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < Rays; i++)
+	{
+		grid->AddRay(0.0f, 0.0f, (float)(random() % 360), (uint16_t)(100 + random() % (OccupancyMaxRayRange + 400)));
+	}
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	printf("Occupancy grid %2u x %2u tiles @ %3u mm (%5u B): %9.0f rays/s %10.0f cell updates/s\n", N, N, cellSize,
+		(unsigned)sizeof(OccupancyGrid<N>), Rays / elapsed, grid->CellUpdates / elapsed);
+	CHECK(grid->RaysAdded == (uint32_t)Rays && grid->CellUpdates > grid->RaysAdded);
+	delete grid;
+}
+
+int main()
+{
+	TestRays();
+	TestSaturation();
+	TestWraparound();
+	TestExport();
+	Benchmark<4>(100);
+	Benchmark<8>(50);
+	Benchmark<8>(25);
+	Benchmark<16>(25);
+	Benchmark<16>(50);
+	return HostTestResult("OccupancyGridTest");
+}
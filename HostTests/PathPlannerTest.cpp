@@ -0,0 +1,414 @@
+/*	PathPlannerTest.cpp
+*	GridPathPlanner A* search and WaypointNavigatorClass replanning: paths are connected from the robot to the goal and
+*	keep clear of the inflated obstacles, goals inside the inflation, enclosed goals and an overflowing open set are
+*	reported, and a path is only replanned once an obstacle inserted into the grid blocks it; plan times are reported
+*	for typical MCC grids (host times, for comparison between grids, as WaypointNavigatorClass::Benchmark() on the MCC)
+*
+*/
+
+#include "HostTest.h"
+#include "../MRSMCC/src/WaypointNavigator.h"
+
+#include <random>
+
+template <uint8_t N>
+class TestGrid : public OccupancyGrid<N>
+{
+public:
+	TestGrid(uint16_t cellSize) : OccupancyGrid<N>(cellSize) {}
+
+	/// <summary>
+	/// Sets the log-odds of a world cell in the window directly, as enough rays ending in (or passing through) it would
+	/// </summary>
+	void SetCell(int32_t cx, int32_t cy, int8_t logOdds)
+	{
+		if (!this->InWindow(cx >> 3, cy >> 3))
+		{
+			return;
+		}
+		uint16_t b = this->ClaimTile(cx >> 3, cy >> 3, true);
+		this->Cells[b][(cy & 7) * OccupancyTileSide + (cx & 7)] = logOdds;
+		this->Revision++;
+	}
+
+	/// <summary>
+	/// Fills a rectangle of world cells, corners inclusive
+	/// </summary>
+	void Fill(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int8_t logOdds)
+	{
+		for (int32_t cy = y0; cy <= y1; cy++)
+		{
+			for (int32_t cx = x0; cx <= x1; cx++)
+			{
+				SetCell(cx, cy, logOdds);
+			}
+		}
+	}
+
+	/// <summary>
+	/// Marks the whole window as observed free space
+	/// </summary>
+	void MarkFree()
+	{
+		int32_t ox, oy;
+		this->GetWindowOrigin(ox, oy);
+		Fill(ox, oy, ox + this->WindowCells - 1, oy + this->WindowCells - 1, LogOddsMin);
+	}
+};
+
+template <uint8_t N, uint16_t HeapCapacity = PlannerHeapCapacity>
+class TestPlanner : public GridPathPlanner<N, HeapCapacity>
+{
+public:
+	TestPlanner(const OccupancyGrid<N>& grid) : GridPathPlanner<N, HeapCapacity>(grid) {}
+
+	/// <summary>
+	/// Returns the world cell of a waypoint
+	/// </summary>
+	void GetWaypointCell(uint8_t i, int32_t& cx, int32_t& cy) const
+	{
+		cx = this->OriginX + this->WaypointX[i];
+		cy = this->OriginY + this->WaypointY[i];
+	}
+};
+
+/// <summary>
+/// Checks the waypoints of the last plan against the grid, independently of the planner's own cost map: the straight
+/// segments from the robot's cell through each waypoint step from cell to neighbouring cell, end in the goal's cell, and
+/// pass no closer to an occupied cell than the planner's clearance, except within the clearance around the robot
+/// </summary>
+/// <returns>Path length in cells, or -1 if the path is broken or passes through an inflated cell</returns>
+template <uint8_t N, uint16_t HeapCapacity>
+static int CheckPath(const TestGrid<N>& grid, const TestPlanner<N, HeapCapacity>& planner, float x, float y, float goalX, float goalY)
+{
+	int32_t ox, oy;
+	grid.GetWindowOrigin(ox, oy);
+	int32_t r = planner.Clearance;
+	int32_t startX = grid.GetCellIndex(x);
+	int32_t startY = grid.GetCellIndex(y);
+	int32_t goalCellX = constrain(grid.GetCellIndex(goalX), ox, ox + grid.WindowCells - 1);
+	int32_t goalCellY = constrain(grid.GetCellIndex(goalY), oy, oy + grid.WindowCells - 1);
+
+	auto inflated = [&](int32_t cx, int32_t cy)
+		{
+			if (abs(cx - startX) <= r && abs(cy - startY) <= r && grid.GetState(cx, cy) != OccupiedCell)
+			{
+				return false;
+			}
+			for (int32_t by = cy - r; by <= cy + r; by++)
+			{
+				for (int32_t bx = cx - r; bx <= cx + r; bx++)
+				{
+					if ((bx - cx) * (bx - cx) + (by - cy) * (by - cy) <= r * r && grid.GetState(bx, by) == OccupiedCell)
+					{
+						return true;
+					}
+				}
+			}
+			return false;
+		};
+
+	int length = 0;
+	int32_t px = startX;
+	int32_t py = startY;
+	int32_t cx = px;
+	int32_t cy = py;
+	for (uint8_t i = 0; i < planner.GetWaypointCount(); i++)
+	{
+		planner.GetWaypointCell(i, cx, cy);
+		int32_t dx = abs(cx - px);
+		int32_t dy = -abs(cy - py);
+		int8_t sx = (px < cx) ? 1 : -1;
+		int8_t sy = (py < cy) ? 1 : -1;
+		int32_t error = dx + dy;
+		while (true)
+		{
+			if (px < ox || py < oy || px >= ox + grid.WindowCells || py >= oy + grid.WindowCells || inflated(px, py))
+			{
+				return -1;
+			}
+			if (px == cx && py == cy)
+			{
+				break;
+			}
+			int32_t e2 = 2 * error;
+			if (e2 >= dy)
+			{
+				error += dy;
+				px += sx;
+			}
+			if (e2 <= dx)
+			{
+				error += dx;
+				py += sy;
+			}
+			length++;
+		}
+	}
+	return (planner.GetWaypointCount() > 0 && cx == goalCellX && cy == goalCellY) ? length : -1;
+}
+
+static void TestOpenGrid()
+{
+	TestGrid<8> grid(50);									// Window cells -32 to 31 each way
+	TestPlanner<8> planner(grid);
+
+	// Unknown everywhere: a straight line, one waypoint
+	CHECK(planner.Plan(-1.0f, -0.5f, 1.2f, 0.7f) == planner.PlanOK);
+	CHECK(planner.GetWaypointCount() == 1 && CheckPath(grid, planner, -1.0f, -0.5f, 1.2f, 0.7f) > 0);
+
+	// A goal beyond the window is clamped to its edge
+	grid.MarkFree();
+	CHECK(planner.Plan(0.0f, 0.0f, 5.0f, 0.0f) == planner.PlanOK);
+	int32_t cx, cy;
+	planner.GetWaypointCell(planner.GetWaypointCount() - 1, cx, cy);
+	CHECK(cx == 31 && cy == 0 && CheckPath(grid, planner, 0.0f, 0.0f, 5.0f, 0.0f) == 31);
+
+	// An obstacle whose inflation covers the robot's cell does not stop it leaving
+	grid.SetCell(2, 0, LogOddsMax);
+	CHECK(planner.Plan(0.0f, 0.0f, -1.0f, 0.0f) == planner.PlanOK);
+	CHECK(CheckPath(grid, planner, 0.0f, 0.0f, -1.0f, 0.0f) > 0);
+}
+
+static void TestWalls()
+{
+	TestGrid<8> grid(50);
+	TestPlanner<8> planner(grid);
+	grid.MarkFree();
+
+	// A wall at x = 0 from the bottom of the window to y = 1 m, with a 0.5 m doorway below the direct line
+	grid.Fill(0, -32, 0, -15, LogOddsMax);
+	grid.Fill(0, -4, 0, 20, LogOddsMax);
+	CHECK(planner.Plan(-1.0f, 0.0f, 1.0f, 0.0f) == planner.PlanOK);
+	int length = CheckPath(grid, planner, -1.0f, 0.0f, 1.0f, 0.0f);
+	CHECK(length >= 40 && planner.GetWaypointCount() >= 2);
+	int32_t cx, cy;
+	planner.GetWaypointCell(0, cx, cy);
+	CHECK(cy >= -14 + defaultPlannerClearance && cy <= -5 - defaultPlannerClearance);
+
+	// A doorway narrower than the robot is not: the path goes round the end of the wall instead
+	grid.Fill(0, -14, 0, -10, LogOddsMax);
+	grid.Fill(0, -7, 0, -5, LogOddsMax);
+	CHECK(planner.Plan(-1.0f, 0.0f, 1.0f, 0.0f) == planner.PlanOK);
+	CHECK(CheckPath(grid, planner, -1.0f, 0.0f, 1.0f, 0.0f) > length);
+	planner.GetWaypointCell(0, cx, cy);
+	CHECK(cy >= 21 + defaultPlannerClearance);
+}
+
+static void TestFailures()
+{
+	TestGrid<8> grid(50);
+	TestPlanner<8> planner(grid);
+	grid.MarkFree();
+
+	// A goal within the clearance of an obstacle
+	grid.SetCell(20, 0, LogOddsMax);
+	CHECK(planner.Plan(0.0f, 0.0f, 0.9f, 0.0f) == planner.GoalBlocked);
+	CHECK(planner.GetWaypointCount() == 0 && planner.LastExpanded == 0);
+	CHECK(planner.Plan(0.0f, 0.0f, 0.8f, 0.0f) == planner.PlanOK);
+
+	// A goal walled in: the search runs from the goal, so every cell inside the walls clear of their inflation is
+	// expanded, 13 x 13 of them
+	grid.SetCell(20, 0, LogOddsMin);
+	grid.Fill(10, -10, 30, -10, LogOddsMax);
+	grid.Fill(10, 10, 30, 10, LogOddsMax);
+	grid.Fill(10, -10, 10, 10, LogOddsMax);
+	grid.Fill(30, -10, 30, 10, LogOddsMax);
+	CHECK(planner.Plan(-1.0f, 0.0f, 1.0f, 0.0f) == planner.NoPath);
+	CHECK(planner.GetWaypointCount() == 0 && planner.LastExpanded == 13 * 13);
+	CHECK(planner.Plans == 3 && planner.PlanFailures == 2 && planner.LastResult == planner.NoPath);
+
+	// An open set larger than the heap: the searches of Benchmark() stay well inside PlannerHeapCapacity, so a 256
+	// entry heap is overflowed instead, searching the whole window for a robot walled into a corner
+	TestPlanner<8, 256> smallHeap(grid);
+	grid.MarkFree();
+	grid.Fill(-32, -28, -28, -28, LogOddsMax);
+	grid.Fill(-28, -32, -28, -28, LogOddsMax);
+	CHECK(smallHeap.Plan(-1.5f, -1.5f, 1.5f, 1.5f) == smallHeap.HeapFull);
+	CHECK(smallHeap.GetWaypointCount() == 0 && smallHeap.PlanFailures == 1 && smallHeap.LastExpanded > 0);
+	CHECK(planner.Plan(-1.5f, -1.5f, 1.5f, 1.5f) == planner.NoPath);
+	CHECK(planner.LastExpanded > 64 * 64 / 2);
+
+	// With the walls gone, the search heads straight for the robot and the same plan fits in the small heap
+	grid.MarkFree();
+	CHECK(smallHeap.Plan(-1.5f, -1.5f, 1.5f, 1.5f) == smallHeap.PlanOK);
+	CHECK(CheckPath(grid, smallHeap, -1.5f, -1.5f, 1.5f, 1.5f) > 0);
+}
+
+static void TestRevalidation()
+{
+	TestGrid<8> grid(50);
+	TestPlanner<8> planner(grid);
+	grid.MarkFree();
+
+	// Planned straight along y = 0; nothing has changed since
+	CHECK(planner.Plan(-1.0f, 0.0f, 1.0f, 0.0f) == planner.PlanOK && planner.GetWaypointCount() == 1);
+	CHECK(!planner.IsPathBlocked(-1.0f, 0.0f, 0));
+
+	// An obstacle well clear of the path changes the grid but leaves the path open
+	grid.SetCell(0, 20, LogOddsMax);
+	CHECK(!planner.IsPathBlocked(-1.0f, 0.0f, 0));
+	CHECK(!planner.IsPathBlocked(-0.5f, 0.0f, 0));
+
+	// One whose inflation reaches the path blocks it, until the path is replanned round it
+	grid.SetCell(0, 2, LogOddsMax);
+	CHECK(planner.IsPathBlocked(-0.5f, 0.0f, 0));
+	CHECK(planner.Plan(-0.5f, 0.0f, 1.0f, 0.0f) == planner.PlanOK && planner.GetWaypointCount() > 1);
+	CHECK(CheckPath(grid, planner, -0.5f, 0.0f, 1.0f, 0.0f) > 0);
+	CHECK(!planner.IsPathBlocked(-0.5f, 0.0f, 0));
+
+	// An obstacle on a segment already passed does not block the rest of the path
+	float wx = 0.0f, wy = 0.0f;
+	CHECK(planner.GetWaypoint(0, wx, wy));
+	grid.SetCell(grid.GetCellIndex(wx) - 2, grid.GetCellIndex(wy), LogOddsMax);
+	CHECK(!planner.IsPathBlocked(wx, wy, 1));
+
+	// A scrolled window leaves the waypoints in the old window's cells
+	grid.SetCentre(0.5f, 0.0f);
+	grid.SetCell(10, 10, LogOddsMax);
+	CHECK(planner.IsPathBlocked(wx, wy, 1));
+}
+
+/// <summary>
+/// Drives WaypointNavigatorClass over MCCMap.Grid filled by rays from the robot, as the MCC does: one plan for the
+/// goal, none while the grid changes away from the path, and one more once a wall is seen across it
+/// </summary>
+static void TestNavigatorReplan()
+{
+	class TestNavigator : public WaypointNavigatorClass
+	{
+	public:
+		uint8_t GetWaypointCount() { return Planner.GetWaypointCount(); }
+	};
+
+	HostClock::Set(1000000);
+	TestNavigator navigator;
+	MCCMap.Grid.Clear();
+	for (int bearing = 0; bearing < 360; bearing += 2)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			MCCMap.Grid.AddRay(-1.0f, 0.0f, (float)bearing, 5000);
+		}
+	}
+
+	navigator.SetGoal(1.0f, 0.0f, 1);
+	navigator.Update(-1.0f, 0.0f, 0.0f);
+	CHECK(navigator.Replans == 1 && navigator.GetWaypointCount() == 1);
+	CHECK(navigator.GetSpeed() > 0.0f && navigator.CommandChanged());
+
+	// A wall behind the robot
+	for (int i = 0; i < 3; i++)
+	{
+		for (float bearing = 170.0f; bearing <= 190.0f; bearing += 1.0f)
+		{
+			MCCMap.Grid.AddRay(-1.0f, 0.0f, bearing, 400);
+		}
+	}
+	HostClock::Advance(100000);
+	navigator.Update(-0.95f, 0.0f, 0.0f);
+	CHECK(navigator.Replans == 1);
+
+	// A wall ahead, across the path
+	for (int i = 0; i < 3; i++)
+	{
+		for (float bearing = -15.0f; bearing <= 15.0f; bearing += 1.0f)
+		{
+			MCCMap.Grid.AddRay(-0.95f, 0.0f, bearing, 900);
+		}
+	}
+	HostClock::Advance(100000);
+	navigator.Update(-0.95f, 0.0f, 0.0f);
+	CHECK(navigator.Replans == 2 && navigator.GetWaypointCount() > 1);
+	HostClock::Advance(100000);
+	navigator.Update(-0.95f, 0.0f, 0.0f);
+	CHECK(navigator.Replans == 2 && !navigator.Arrived);
+}
+
+/// <summary>
+/// Times plans from the window centre to random points on its edge, the longest plan the navigator makes inside the
+/// window, on an unexplored window, one explored by 400 random rays from the centre as in
+/// WaypointNavigatorClass::Benchmark(), and rooms with doorways
+/// </summary>
+static void Benchmark()
+{
+	const char* names[] = { "unexplored", "cluttered", "rooms" };
+	std::mt19937 random(1);
+	float extent = MCCMapTilesPerSide * OccupancyTileSide * MCCMapCellSize / 2000.0f;
+	for (int layout = 0; layout < 3; layout++)
+	{
+		TestGrid<MCCMapTilesPerSide>* grid = new TestGrid<MCCMapTilesPerSide>(MCCMapCellSize);
+		TestPlanner<MCCMapTilesPerSide>* planner = new TestPlanner<MCCMapTilesPerSide>(*grid);
+		if (layout == 1)
+		{
+			for (int i = 0; i < 400; i++)
+			{
+				grid->AddRay(0.0f, 0.0f, (float)(random() % 360), (uint16_t)(300 + random() % 1300));
+			}
+		}
+		else if (layout == 2)
+		{
+			grid->MarkFree();
+			for (int32_t c = -16; c <= 16; c += 32)
+			{
+				grid->Fill(c, -32, c, 31, LogOddsMax);
+				grid->Fill(-32, c, 31, c, LogOddsMax);
+			}
+			for (int32_t c = -16; c <= 16; c += 32)
+			{
+				for (int32_t d = -24; d <= 24; d += 24)
+				{
+					grid->Fill(c, d - 4, c, d + 4, LogOddsMin);		// Doorways midway between the walls
+					grid->Fill(d - 4, c, d + 4, c, LogOddsMin);
+				}
+			}
+		}
+
+		constexpr int Plans = 200;
+		uint32_t totalTime = 0;
+		uint32_t worstTime = 0;
+		uint32_t totalExpanded = 0;
+		int blocked = 0;
+		int unreachable = 0;
+		int broken = 0;
+		for (int i = 0; i < Plans; i++)
+		{
+			float bearing = (random() % 360) * DEG_TO_RAD;
+			float goalX = extent * cosf(bearing);
+			float goalY = extent * sinf(bearing);
+			switch (planner->Plan(0.0f, 0.0f, goalX, goalY))
+			{
+			case planner->PlanOK:
+				broken += (CheckPath(*grid, *planner, 0.0f, 0.0f, goalX, goalY) < 0);
+				break;
+			case planner->GoalBlocked:
+				blocked++;
+				break;
+			default:
+				unreachable++;
+				break;
+			}
+			totalTime += planner->LastPlanTime;
+			worstTime = max(worstTime, planner->LastPlanTime);
+			totalExpanded += planner->LastExpanded;
+		}
+		printf("Planner, %-10s: mean %5lu us, worst %5lu us, %4lu cells expanded, %d goals blocked, %d unreachable of %d\n",
+			names[layout], (unsigned long)(totalTime / Plans), (unsigned long)worstTime,
+			(unsigned long)(totalExpanded / Plans), blocked, unreachable, Plans);
+		CHECK(broken == 0);
+		CHECK(unreachable == 0 && blocked * 2 < Plans);
+		delete planner;
+		delete grid;
+	}
+}
+
+int main()
+{
+	TestOpenGrid();
+	TestWalls();
+	TestFailures();
+	TestRevalidation();
+	Benchmark();
+	TestNavigatorReplan();
+	return HostTestResult("PathPlannerTest");
+}
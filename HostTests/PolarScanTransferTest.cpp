@@ -0,0 +1,258 @@
+/*	PolarScanTransferTest.cpp
+*	Polar scans split into PolarScanChunkPackets on the MRS SEN, relayed by the MCC and reassembled by the CSSM's
+*	PolarScanAssemblerClass: ranges survive the quantisation, chunks may arrive in any order, and a dropped chunk only
+*	invalidates its own bins; bytes per sweep and end to end sweep latency are reported
+*
+*/
+
+#include "HostTest.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\PolarScanAssembler.h"
+
+#include <deque>
+#include <random>
+
+constexpr uint32_t UpdateScanInterval = 20;					// ms; MCC one chunk read per run, as MRSMCC.ino
+constexpr uint32_t ForwardMapDataInterval = 20;				// ms; MCC one ESP-NOW map data send per run
+constexpr uint32_t RadioDelay = 2;							// ms; ESP-NOW frame on the air
+
+static PolarScan MakeScan(uint16_t scanID, uint32_t endTime, std::mt19937& random)
+{
+	PolarScan scan;
+	scan.ScanID = scanID;
+	scan.StartAngle = -600;
+	scan.AngleStep = 10;
+	scan.BinCount = MaxPolarScanBins;
+	scan.EndTime = endTime;
+	for (uint8_t i = 0; i < scan.BinCount; i++)
+	{
+		// Mostly walls within the VL53L1X's reach, some empty bins and some beyond the quantised range:
+		uint32_t r = random() % 20;
+		scan.Range[i] = (r == 0) ? PolarScanNoRange : (r == 1) ? 6000 : (uint16_t)(100 + random() % 4000);
+	}
+	return scan;
+}
+
+static PolarScanChunkPacket Chunk(const PolarScan& scan, uint8_t index, uint16_t age = 0)
+{
+	PolarScanChunkPacket chunk;
+	CHECK(chunk.Encode(scan, index, age));
+	return chunk;
+}
+
+/// <returns>Bins of the latest scan whose range differs from the sent one by more than the quantisation allows</returns>
+static int CountWrongBins(PolarScanAssemblerClass& assembler, const PolarScan& sent)
+{
+	PolarScan received;
+	if (!assembler.GetLatestScan(received) || received.ScanID != sent.ScanID || received.BinCount != sent.BinCount)
+	{
+		return sent.BinCount;
+	}
+	int wrong = 0;
+	for (uint8_t i = 0; i < sent.BinCount; i++)
+	{
+		uint16_t expected = PolarScanChunkPacket::DequantiseRange(PolarScanChunkPacket::QuantiseRange(sent.Range[i]));
+		bool inRange = sent.Range[i] == PolarScanNoRange || sent.Range[i] >= 255 * PolarScanRangeUnit
+			|| abs((int)received.Range[i] - (int)sent.Range[i]) <= PolarScanRangeUnit / 2;
+		wrong += (received.Range[i] != expected || !inRange);
+	}
+	return wrong;
+}
+
+static void TestQuantisation()
+{
+	CHECK(PolarScanChunkPacket::QuantiseRange(PolarScanNoRange) == 0);
+	CHECK(PolarScanChunkPacket::QuantiseRange(1) == 1);				// A sample is never reported as no range
+	CHECK(PolarScanChunkPacket::QuantiseRange(1009) == 50 && PolarScanChunkPacket::QuantiseRange(1010) == 51);
+	CHECK(PolarScanChunkPacket::QuantiseRange(6000) == 255);
+	CHECK(PolarScanChunkPacket::DequantiseRange(255) == 5100);
+
+	PolarScan scan;
+	scan.BinCount = 100;
+	PolarScanChunkPacket chunk;
+	CHECK(PolarScanChunkPacket::GetChunkCount(scan) == 4);
+	CHECK(chunk.Encode(scan, 3, 0) && chunk.FirstBin == 96 && chunk.BinCount == 4);
+	CHECK(!chunk.Encode(scan, 4, 0) && chunk.BinCount == 0);
+}
+
+static void TestReassembly()
+{
+	std::mt19937 random(1);
+	HostClock::Set(1000000);
+	PolarScanAssemblerClass assembler;
+
+	// In order:
+	PolarScan scan = MakeScan(1, millis(), random);
+	uint8_t count = PolarScanChunkPacket::GetChunkCount(scan);
+	for (uint8_t i = 0; i < count; i++)
+	{
+		assembler.AddChunk(Chunk(scan, i));
+	}
+	CHECK(assembler.ScansComplete == 1 && assembler.GetLatestScanID() == 1);
+	CHECK(CountWrongBins(assembler, scan) == 0);
+
+	// Any order, with a repeat, and a straggler once the scan has been published:
+	scan = MakeScan(2, millis(), random);
+	uint8_t order[] = { 3, 1, 1, 0, 2 };
+	for (uint8_t i : order)
+	{
+		assembler.AddChunk(Chunk(scan, i));
+		CHECK(assembler.GetLatestScanID() == ((i == 2) ? 2 : 1));
+	}
+	assembler.AddChunk(Chunk(scan, 1));
+	CHECK(assembler.ScansComplete == 2 && assembler.ScansPartial == 0 && assembler.ChunksLost == 0);
+	CHECK(CountWrongBins(assembler, scan) == 0);
+	for (uint8_t bin = 0; bin < scan.BinCount; bin++)
+	{
+		CHECK(assembler.IsBinValid(bin));
+	}
+	CHECK(!assembler.IsBinValid(scan.BinCount));
+
+	// Malformed chunks are ignored:
+	PolarScanChunkPacket bad = Chunk(MakeScan(3, millis(), random), 0);
+	bad.ChunkIndex = bad.ChunkCount;
+	assembler.AddChunk(bad);
+	bad = Chunk(MakeScan(3, millis(), random), 3);
+	bad.BinCount = MaxPolarScanChunkBins;
+	assembler.AddChunk(bad);
+	CHECK(assembler.ChunksReceived == 9);
+}
+
+static void TestDroppedChunk()
+{
+	std::mt19937 random(2);
+	HostClock::Set(1000000);
+	PolarScanAssemblerClass assembler;
+
+	// Chunk 1 dropped, the scan published once the rest are overdue:
+	PolarScan scan = MakeScan(10, millis(), random);
+	assembler.AddChunk(Chunk(scan, 0));
+	assembler.AddChunk(Chunk(scan, 2));
+	assembler.AddChunk(Chunk(scan, 3));
+	HostClock::Advance(PolarScanAssemblyTimeout * 1000);
+	assembler.Update();
+	CHECK(assembler.GetLatestScanID() != 10);
+	HostClock::Advance(1000);
+	assembler.Update();
+	CHECK(assembler.GetLatestScanID() == 10 && assembler.ScansPartial == 1 && assembler.ChunksLost == 1);
+
+	PolarScan received;
+	assembler.GetLatestScan(received);
+	int wrong = 0;
+	for (uint8_t bin = 0; bin < scan.BinCount; bin++)
+	{
+		bool lost = (bin / MaxPolarScanChunkBins == 1);
+		CHECK(assembler.IsBinValid(bin) == !lost);
+		if (lost)
+		{
+			wrong += (received.Range[bin] != PolarScanNoRange);
+		}
+		else
+		{
+			wrong += (received.Range[bin] != PolarScanChunkPacket::DequantiseRange(PolarScanChunkPacket::QuantiseRange(scan.Range[bin])));
+		}
+	}
+	CHECK(wrong == 0);
+
+	// The last chunk dropped: the first chunk of the next scan publishes the partial one without waiting
+	scan = MakeScan(11, millis(), random);
+	assembler.AddChunk(Chunk(scan, 0));
+	assembler.AddChunk(Chunk(scan, 1));
+	assembler.AddChunk(Chunk(scan, 2));
+	PolarScan next = MakeScan(12, millis(), random);
+	assembler.AddChunk(Chunk(next, 2));
+	CHECK(assembler.GetLatestScanID() == 11 && assembler.ScansPartial == 2 && assembler.ChunksLost == 2);
+	CHECK(assembler.IsBinValid(95) && !assembler.IsBinValid(96));
+
+	// The late chunk 3 of scan 11 does not disturb scan 12
+	assembler.AddChunk(Chunk(scan, 3));
+	assembler.AddChunk(Chunk(next, 0));
+	assembler.AddChunk(Chunk(next, 1));
+	assembler.AddChunk(Chunk(next, 3));
+	CHECK(assembler.GetLatestScanID() == 12 && assembler.ScansComplete == 1 && CountWrongBins(assembler, next) == 0);
+}
+
+/// <summary>
+/// A sweep about every 2 s through the SEN, the MCC's chunk reads and its ESP-NOW forwarding, to the CSSM, one ms at a time
+/// </summary>
+static void TestEndToEnd()
+{
+	struct Relayed
+	{
+		PolarScanChunkPacket Chunk;
+		uint32_t Time;										// ms; read by the MCC, or due at the CSSM
+	};
+
+	std::mt19937 random(3);
+	HostClock::Set(1000000);
+	PolarScanAssemblerClass assembler;
+	PolarScan scan;
+	std::deque<Relayed> mccQueue;
+	std::deque<Relayed> radio;
+	uint8_t nextChunk = 0;
+	bool pending = false;
+	uint16_t scanID = 0;
+	uint32_t nextScanTime = 1000;
+	uint32_t latencySum = 0;
+	uint32_t latencyMax = 0;
+	int wrong = 0;
+	for (uint32_t t = 0; t < 60000; t++)
+	{
+		uint32_t now = millis();
+		if (t == nextScanTime)
+		{
+			nextScanTime += 1900 + random() % 200;			// Completed out of step with the MCC tasks
+			scan = MakeScan(++scanID, now, random);
+			nextChunk = 0;
+			pending = true;
+		}
+		if (t % UpdateScanInterval == 3 && pending)
+		{
+			PolarScanChunkPacket chunk;
+			chunk.Encode(scan, nextChunk, now - scan.EndTime);
+			mccQueue.push_back({ chunk, now });
+			pending = (++nextChunk < chunk.ChunkCount);
+		}
+		if (t % ForwardMapDataInterval == 11 && !mccQueue.empty())
+		{
+			Relayed sent = mccQueue.front();
+			mccQueue.pop_front();
+			sent.Chunk.Age += now - sent.Time;
+			sent.Time = now + RadioDelay;
+			radio.push_back(sent);
+		}
+		while (!radio.empty() && radio.front().Time <= now)
+		{
+			uint32_t complete = assembler.ScansComplete;
+			assembler.AddChunk(radio.front().Chunk);
+			radio.pop_front();
+			if (assembler.ScansComplete != complete)
+			{
+				// The Age of each chunk leaves out its time on the air:
+				CHECK(assembler.LastLatency == now - RadioDelay - scan.EndTime);
+				latencySum += assembler.LastLatency;
+				latencyMax = max(latencyMax, (uint32_t)assembler.LastLatency);
+				wrong += CountWrongBins(assembler, scan);
+			}
+		}
+		assembler.Update();
+		HostClock::Advance(1000);
+	}
+
+	uint8_t chunks = PolarScanChunkPacket::GetChunkCount(scan);
+	printf("Polar scan: %u bins in %u chunks, %u bytes per sweep (%u as uint16_t ranges), "
+		"latency %.1f ms mean %lu ms worst over %lu sweeps\n", scan.BinCount, chunks, assembler.BytesPerScan,
+		(unsigned)(scan.BinCount * sizeof(uint16_t)), (double)latencySum / assembler.ScansComplete,
+		(unsigned long)latencyMax, (unsigned long)assembler.ScansComplete);
+	CHECK(assembler.ScansComplete == scanID && assembler.ScansPartial == 0 && wrong == 0);
+	CHECK(assembler.BytesPerScan == chunks * sizeof(PolarScanChunkPacket));
+	CHECK(latencyMax <= chunks * UpdateScanInterval + ForwardMapDataInterval);
+}
+
+int main()
+{
+	TestQuantisation();
+	TestReassembly();
+	TestDroppedChunk();
+	TestEndToEnd();
+	return HostTestResult("PolarScanTransferTest");
+}
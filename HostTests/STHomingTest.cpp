@@ -0,0 +1,188 @@
+/*	STHomingTest.cpp
+*	STHomingClass with a home flag: homing from an arbitrary power up position, re-indexing after lost steps, an index
+*	a whole revolution away, a false edge, and periodic re-homing only once it has been enabled
+*
+*	The turret is simulated a step at a time; the flag covers FlagWidth steps clockwise of the home position.
+*
+*/
+
+#include "HostTest.h"
+#include "../MRSSENXIAOS3/src/STHoming.h"
+
+constexpr int StepsPerRev = 1600;
+constexpr int32_t FlagWidth = 60;							// steps
+constexpr uint32_t UpdateInterval = 10;						// ms; STControl::Update() period
+constexpr int32_t SweepLimit = 133;							// steps; +/-30 degrees
+constexpr uint32_t SweepSpeed = 133;						// steps/s
+
+class TurretSim
+{
+public:
+	FastAccelStepper Motor;
+	STHomingClass Homing;
+	int32_t Turret = 0;										// steps; where the turret actually is
+	float StepAccumulator = 0.0f;
+	float EdgePosition = 0.0f;								// Stepper position at the last flag edge
+	bool Sweeping = false;
+	bool SweepRight = true;
+	uint32_t Now = 0;										// ms
+
+	bool OnFlag() const
+	{
+		int32_t angle = ((Turret % StepsPerRev) + StepsPerRev) % StepsPerRev;
+		return angle < FlagWidth;
+	}
+
+	void SetFlag()
+	{
+		bool wasHigh = (digitalRead(DefaultTurretHomePin) == HIGH);
+		HostGPIO::Set(DefaultTurretHomePin, OnFlag() ? LOW : HIGH);
+		if (wasHigh && OnFlag())
+		{
+			EdgePosition = (float)Motor.Position;
+		}
+	}
+
+	void Start(int32_t turret)
+	{
+		HostGPIO::Reset();
+		HostClock::Set(1000000);
+		Now = millis();
+		Turret = turret;
+		Homing.Init(&Motor, StepsPerRev);
+		SetFlag();
+	}
+
+	void StepMotor()
+	{
+		if (!Motor.isRunning())
+		{
+			StepAccumulator = 0.0f;
+			return;
+		}
+		StepAccumulator += Motor.Speed / 1000.0f;
+		int32_t direction = (Motor.Target > Motor.Position) ? 1 : -1;
+		while (StepAccumulator >= 1.0f && Motor.Position != Motor.Target)
+		{
+			StepAccumulator -= 1.0f;
+			Motor.Position += direction;
+			Turret += direction;
+			SetFlag();
+		}
+	}
+
+	/// <param name="time">ms</param>
+	void Run(uint32_t time)
+	{
+		for (uint32_t i = 0; i < time; i++)
+		{
+			HostClock::Advance(1000);
+			Now = millis();
+			StepMotor();
+			if (Now % UpdateInterval == 0)
+			{
+				uint32_t edgeTime;
+				if (Homing.GetFlagEdge(edgeTime))
+				{
+					Homing.OnFlagEdge(EdgePosition, Motor.getCurrentSpeedInMilliHz() > 0, Now);
+				}
+				Homing.Update(Now, Sweeping);
+				if (Sweeping && !Homing.IsHoming() && !Motor.isRunning())
+				{
+					Motor.setSpeedInHz(SweepSpeed);
+					Motor.moveTo(SweepRight ? SweepLimit : -SweepLimit);
+					SweepRight = !SweepRight;
+				}
+			}
+		}
+	}
+
+	/// <returns>Stepper position less the turret position, modulo a revolution</returns>
+	int32_t GetPositionError() const
+	{
+		int32_t error = ((Motor.Position - Turret) % StepsPerRev + StepsPerRev) % StepsPerRev;
+		return (error > StepsPerRev / 2) ? error - StepsPerRev : error;
+	}
+};
+
+static void TestHoming()
+{
+	TurretSim sim;
+	sim.Motor.Position = 0;
+	sim.Start(-500);										// Powered up 500 steps anticlockwise of home, thinking it is at 0
+	CHECK(sim.Homing.IsHoming());
+	sim.Run(60000);
+	CHECK(sim.Homing.IsHomed() && !sim.Homing.IsHoming());
+	CHECK(sim.Homing.HomingCount == 1 && sim.Homing.HomingFailures == 0);
+	CHECK(abs(sim.GetPositionError()) <= 1);
+	CHECK(sim.Homing.GetConfidence() == 100);
+}
+
+static void TestIndex()
+{
+	TurretSim sim;
+	sim.Start(300);
+	sim.Run(60000);
+	CHECK(sim.Homing.IsHomed());
+
+	// Steps lost while sweeping through the flag are corrected after the next clockwise pass
+	sim.Sweeping = true;
+	sim.Run(5000);
+	uint32_t indexCount = sim.Homing.IndexCount;
+	CHECK(indexCount > 0 && sim.Homing.Corrections == 0);
+	sim.Turret -= 5;										// 5 steps counted but not turned
+	sim.Run(10000);
+	CHECK(sim.Homing.Corrections == 1);
+	CHECK(abs(sim.GetPositionError()) <= IndexTolerance);
+	CHECK(sim.Homing.IndexCount > indexCount);
+
+	// After a whole revolution the flag is a revolution away in stepper coordinates; that is not an error
+	sim.Sweeping = false;
+	sim.Run(5000);
+	sim.Motor.setCurrentPosition(sim.Motor.Position + StepsPerRev);
+	sim.Turret += StepsPerRev;
+	uint32_t corrections = sim.Homing.Corrections;
+	indexCount = sim.Homing.IndexCount;
+	sim.Motor.setSpeedInHz(SweepSpeed);
+	sim.Motor.moveTo(StepsPerRev - SweepLimit);
+	sim.Run(5000);
+	sim.Motor.moveTo(StepsPerRev + SweepLimit);
+	sim.Run(5000);
+	CHECK(sim.Homing.IndexCount == indexCount + 1);
+	CHECK(sim.Homing.Corrections == corrections);
+	CHECK(abs(sim.Homing.LastIndexError) <= IndexTolerance);
+
+	// An edge far from the flag (switch bounce, noise) is ignored rather than corrected
+	int32_t position = sim.Motor.Position;
+	sim.Homing.OnFlagEdge((float)(position - 200), true, sim.Now);
+	sim.Run(100);
+	CHECK(sim.Homing.IndexRejects == 1);
+	CHECK(sim.Motor.Position == position);
+	CHECK(sim.Homing.Corrections == corrections);
+}
+
+static void TestAutoRehome()
+{
+	TurretSim sim;
+	sim.Start(-200);
+	sim.Run(60000);
+	CHECK(sim.Homing.HomingCount == 1);
+
+	// Idle past ReindexInterval: nothing happens until periodic re-homing is enabled
+	sim.Run(ReindexInterval + 1000);
+	CHECK(sim.Homing.HomingCount == 1 && !sim.Homing.IsHoming());
+	sim.Homing.SetAutoRehome(true);
+	sim.Run(100);
+	CHECK(sim.Homing.IsHoming());
+	sim.Run(60000);
+	CHECK(sim.Homing.HomingCount == 2);
+	CHECK(abs(sim.GetPositionError()) <= 1);
+}
+
+int main()
+{
+	TestHoming();
+	TestIndex();
+	TestAutoRehome();
+	return HostTestResult("STHomingTest");
+}
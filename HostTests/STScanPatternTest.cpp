@@ -0,0 +1,60 @@
+/*	STScanPatternTest.cpp
+*	STScanPatternClass: sweep direction over an asymmetric scan range, and the coverage of each pattern against the
+*	simulated turret and room of STScanPatternClass::Simulate()
+*
+*/
+
+#include "HostTest.h"
+#include "../MRSSENXIAOS3/src/STScanPattern.h"
+
+static void TestAsymmetricSweep()
+{
+	// Both limits to the right of 0, so the sign of the position says nothing about the sweep direction
+	STScanPatternClass engine;
+	engine.Configure(1600, 200, 400, 100);
+	engine.SetPattern(STScanPatternClass::SectorSweep);
+
+	int32_t position = 0;
+	uint32_t sweeps = 0;
+	STScanCommand command;
+	for (uint32_t i = 0; i < 10; i++)
+	{
+		engine.Update(position, false, 0, i * 100, command);
+		if (command.Move)
+		{
+			CHECK(command.Target == 200 || command.Target == 400);
+			CHECK(command.Target != position);
+			position = command.Target;
+		}
+		sweeps += command.SweepCompleted;
+	}
+	CHECK(position == 200 || position == 400);
+	CHECK(sweeps >= 8);
+}
+
+static void TestCoverage()
+{
+	const char* names[] = { "Sector sweep", "Dwell list", "Adaptive sweep", "Track nearest" };
+	float bins[STScanPatternClass::PatternCount];
+	float postSamples[STScanPatternClass::PatternCount];
+	for (uint8_t pattern = 0; pattern < STScanPatternClass::PatternCount; pattern++)
+	{
+		STScanPatternClass::Simulate((STScanPatternClass::Patterns)pattern, 60, bins[pattern], postSamples[pattern]);
+		printf("%-14s %5.2f bins/s %5.2f post samples/s\n", names[pattern], bins[pattern], postSamples[pattern]);
+	}
+
+	// The sweeps cover most of the 20 bins each second; adaptive trades some coverage for time on the post and
+	// tracking gives up coverage to stay on it
+	CHECK(bins[STScanPatternClass::SectorSweep] > 4.0f);
+	CHECK(bins[STScanPatternClass::AdaptiveSweep] > 3.0f);
+	CHECK(postSamples[STScanPatternClass::AdaptiveSweep] > postSamples[STScanPatternClass::SectorSweep]);
+	CHECK(postSamples[STScanPatternClass::TrackNearest] > 5.0f * postSamples[STScanPatternClass::SectorSweep]);
+	CHECK(bins[STScanPatternClass::DwellList] > 0.0f);
+}
+
+int main()
+{
+	TestAsymmetricSweep();
+	TestCoverage();
+	return HostTestResult("STScanPatternTest");
+}
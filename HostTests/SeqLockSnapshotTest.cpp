@@ -0,0 +1,147 @@
+/*	SeqLockSnapshotTest.cpp
+*	SeqLockSnapshot: single threaded publish/read, version wrap, and a two thread stress test in which a reader
+*	checks every snapshot it gets for tearing while a writer publishes as fast as it can
+*
+*/
+
+#include "HostTest.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\SeqLockSnapshot.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+constexpr int StressFields = 32;							// 128 B, so a torn copy is likely if the lock is broken
+constexpr auto StressDuration = std::chrono::seconds(2);
+
+struct StressData
+{
+	uint32_t Fields[StressFields];
+};
+
+static StressData MakeData(uint32_t value)
+{
+	StressData data;
+	for (int i = 0; i < StressFields; i++)
+	{
+		data.Fields[i] = value;
+	}
+	return data;
+}
+
+static bool IsConsistent(const StressData& data)
+{
+	for (int i = 1; i < StressFields; i++)
+	{
+		if (data.Fields[i] != data.Fields[0])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+class TestSnapshot : public SeqLockSnapshot<StressData>
+{
+public:
+	void SetVersion(uint32_t version)
+	{
+		Version.store(version);
+	}
+};
+
+static void TestSingleThread()
+{
+	TestSnapshot snapshot;
+	StressData data;
+
+	CHECK(snapshot.GetSequence() == 0);
+	CHECK(snapshot.Publish(MakeData(11)) == 1);
+	CHECK(snapshot.Publish(MakeData(12)) == 2);
+	CHECK(snapshot.GetSequence() == 2);
+	CHECK(snapshot.Read(data) && data.Fields[0] == 12 && IsConsistent(data));
+}
+
+static void TestVersionWrap()
+{
+	TestSnapshot snapshot;
+	StressData data;
+
+	snapshot.SetVersion(0xFFFFFFFAU);
+	for (uint32_t value = 1; value <= 8; value++)
+	{
+		snapshot.Publish(MakeData(value));
+		CHECK(snapshot.Read(data, 1));
+		CHECK(data.Fields[0] == value);
+	}
+}
+
+static void TestTwoThreads()
+{
+	TestSnapshot snapshot;
+	std::atomic<bool> running{ true };
+	uint32_t published = 0;
+	uint64_t reads = 0;
+	uint64_t failedReads = 0;
+	uint64_t tornReads = 0;
+	uint64_t backwardReads = 0;
+
+	snapshot.Publish(MakeData(0));
+
+	std::thread writer([&]()
+		{
+			while (running.load(std::memory_order_relaxed))
+			{
+				snapshot.Publish(MakeData(++published));
+			}
+		});
+
+	std::thread reader([&]()
+		{
+			StressData data;
+			uint32_t last = 0;
+			while (running.load(std::memory_order_relaxed))
+			{
+				reads++;
+				if (!snapshot.Read(data))
+				{
+					failedReads++;
+					continue;
+				}
+				if (!IsConsistent(data))
+				{
+					tornReads++;
+				}
+				else if (data.Fields[0] < last)
+				{
+					backwardReads++;
+				}
+				else
+				{
+					last = data.Fields[0];
+				}
+			}
+		});
+
+	std::this_thread::sleep_for(StressDuration);
+	running = false;
+	writer.join();
+	reader.join();
+
+	printf("SeqLockSnapshot stress: %u publishes, %llu reads, %llu failed (writer overtook reader), %llu torn, %llu backward\n",
+		published, (unsigned long long)reads, (unsigned long long)failedReads, (unsigned long long)tornReads,
+		(unsigned long long)backwardReads);
+	CHECK(published > 1000);
+	CHECK(reads > failedReads + 1000);
+	CHECK(tornReads == 0);
+	CHECK(backwardReads == 0);
+	CHECK(snapshot.GetSequence() == published + 1);
+}
+
+int main()
+{
+	TestSingleThread();
+	TestVersionWrap();
+	TestTwoThreads();
+	return HostTestResult("SeqLockSnapshotTest");
+}
@@ -0,0 +1,120 @@
+/*	StripChartTest.cpp
+*	MinMaxHistory levels and buckets, and the CSSMS3 StripChart scrolled in place on the TileRenderer canvas against
+*	a full redraw after every update, at two spans
+*
+*/
+
+#include "HostTest.h"
+#include "../CSSMS3/src/StripChart.h"
+
+static float Sample(int i)
+{
+	return sinf(i * 0.01f) * 100.0f + ((i % 997 == 0) ? 500.0f : 0.0f);		// With a one sample spike now and then
+}
+
+static void TestHistory()
+{
+	// As CSSMS3Status: 1, 6 and 60 samples per bucket
+	ChartHistory history;
+	history.SetFactor(1, 6);
+	history.SetFactor(2, 10);
+	for (int i = 0; i < 6000; i++)
+	{
+		history.Add(Sample(i));
+	}
+	CHECK(history.GetTotal(0) == 6000 && history.GetTotal(1) == 1000 && history.GetTotal(2) == 100);
+	CHECK(history.GetCount(0) == ChartHistorySize && history.GetCount(2) == ChartHistorySize);
+	CHECK(history.GetSamplesPerBucket(2) == 60);
+	CHECK(history.GetLatest() == Sample(5999));
+
+	// The newest coarsest bucket spans samples 5940 to 5999
+	float min = 1.0e9f;
+	float max = -1.0e9f;
+	for (int i = 5940; i < 6000; i++)
+	{
+		min = fminf(min, Sample(i));
+		max = fmaxf(max, Sample(i));
+	}
+	CHECK(history.Get(2, 0).Min == min && history.Get(2, 0).Max == max);
+
+	// The spikes, one sample each, are still there at the coarsest level
+	uint16_t spikes = 0;
+	for (uint16_t age = 0; age < history.GetCount(2); age++)
+	{
+		spikes += (history.Get(2, age).Max > 400.0f);
+	}
+	CHECK(spikes == 7);
+}
+
+static void InitChart(StripChart& chart, TileRenderer* canvas, ChartHistory* left, ChartHistory* right)
+{
+	chart.Init(canvas, 40, 15, 200, 31);						// Speed chart on the TEL page
+	chart.SetLabel("Spd qpps");
+	chart.SetLimits(-7500.0f, 7500.0f);
+	chart.AddTrace(left, TFT_ORANGE);
+	chart.AddTrace(right, TFT_GREEN);
+}
+
+static void TestScroll()
+{
+	TFT_eSPI scrolledPanel;
+	TFT_eSPI redrawnPanel;
+	scrolledPanel.setRotation(3);
+	redrawnPanel.setRotation(3);
+	TileRenderer scrolledCanvas(&scrolledPanel);
+	TileRenderer redrawnCanvas(&redrawnPanel);
+	scrolledCanvas.Init();
+	redrawnCanvas.Init();
+
+	ChartHistory left;
+	ChartHistory right;
+	left.SetFactor(1, 6);
+	right.SetFactor(1, 6);
+	StripChart scrolled;
+	StripChart redrawn;
+	InitChart(scrolled, &scrolledCanvas, &left, &right);
+	InitChart(redrawn, &redrawnCanvas, &left, &right);
+	scrolled.DrawFrame();
+	scrolledCanvas.Flush();
+
+	uint32_t maxScrolledPixels = 0;
+	uint32_t redrawnPixels = 0;
+	int differing = 0;
+	for (uint8_t level = 0; level < 2; level++)
+	{
+		scrolled.SetLevel(level);
+		redrawn.SetLevel(level);
+		for (int i = 0; i < 700; i++)
+		{
+			left.Add(5000.0f * sinf(i * 0.05f));
+			right.Add(4000.0f * sinf(i * 0.05f - 0.3f) + (i % 13) * 50.0f);
+
+			scrolledCanvas.BeginFrame();
+			scrolled.Update();
+			scrolledCanvas.Flush();
+			if (i > 5)
+			{
+				maxScrolledPixels = max(maxScrolledPixels, scrolledCanvas.PixelsDrawn);
+			}
+
+			redrawnCanvas.fillSprite(TFT_BLACK);
+			redrawnCanvas.BeginFrame();
+			redrawn.DrawFrame();
+			redrawnCanvas.Flush();
+			redrawnPixels = redrawnCanvas.PixelsDrawn;
+
+			differing += (scrolledPanel.HostFrameHash() != redrawnPanel.HostFrameHash());
+		}
+	}
+	printf("Strip chart: at most %lu pixels drawn per update scrolling in place, %lu redrawing\n",
+		(unsigned long)maxScrolledPixels, (unsigned long)redrawnPixels);
+	CHECK(differing == 0);
+	CHECK(maxScrolledPixels * 5 < redrawnPixels);
+}
+
+int main()
+{
+	TestHistory();
+	TestScroll();
+	return HostTestResult("StripChartTest");
+}
@@ -0,0 +1,130 @@
+/*	TileRendererTest.cpp
+*	CSSMS3 TileRenderer on the host framebuffer: a frame drawn on the canvas and flushed leaves the panel pixel for
+*	pixel as drawing it straight to the panel does, an unchanged frame pushes nothing, a small change pushes only its
+*	tiles, and a snapshot sent a chunk at a time is the same image as one written whole
+*
+*/
+
+#include "HostTest.h"
+#include "../CSSMS3/src/TileRenderer.h"
+#include "../CSSMS3/src/BarGauge.h"
+#include <string>
+
+class PrintCapture : public Print
+{
+public:
+	std::string Data;
+	size_t LargestWrite = 0;								// bytes; one call of write()
+
+	size_t write(uint8_t c) override
+	{
+		Data += (char)c;
+		LargestWrite = max(LargestWrite, (size_t)1);
+		return 1;
+	}
+	size_t write(const uint8_t* buffer, size_t size) override
+	{
+		Data.append((const char*)buffer, size);
+		LargestWrite = max(LargestWrite, size);
+		return size;
+	}
+};
+
+static void InitGauge(BarGauge& gauge, TFT_eSPI* tft)
+{
+	gauge.Init(tft, 180, 76, BarGauge::PowerBarLeft);
+	gauge.SetLabel((char*)"LTrk");
+	gauge.SetLimits(-7500.0f, 7500.0f);
+	gauge.SetPowerLimit(1.0f);
+	gauge.DrawFrame();
+}
+
+static void DrawScene(TFT_eSPI* tft, BarGauge& gauge, float reading)
+{
+	tft->setTextColor(TFT_YELLOW, TFT_BLACK, true);
+	tft->setTextDatum(TL_DATUM);
+	tft->drawString("CSSM S3", 2, 2, 2);
+	tft->setTextDatum(MR_DATUM);
+	tft->setTextPadding(tft->textWidth("-8888.8", 4));
+	tft->drawFloat(reading, 1, 316, 40, 4);
+	tft->setTextPadding(0);
+	tft->drawRect(10, 30, 100, 50, TFT_WHITE);
+	tft->drawLine(10, 30, 109, 79, TFT_RED);
+	tft->fillCircle(60, 120, 20, TFT_BLUE);
+	gauge.Update(reading, 0.5f);
+}
+
+static void TestFlush()
+{
+	TFT_eSPI panel;
+	TFT_eSPI direct;
+	panel.setRotation(3);
+	direct.setRotation(3);
+	TileRenderer canvas(&panel);
+	CHECK(canvas.Init());
+	CHECK(canvas.width() == 320 && canvas.height() == 170);
+
+	BarGauge canvasGauge;
+	BarGauge directGauge;
+	InitGauge(canvasGauge, &canvas);
+	InitGauge(directGauge, &direct);
+
+	canvas.BeginFrame();
+	DrawScene(&canvas, canvasGauge, 3000.0f);
+	canvas.Flush();
+	DrawScene(&direct, directGauge, 3000.0f);
+	CHECK(panel.HostFrameHash() == direct.HostFrameHash());
+
+	// The same frame again: hashed, not pushed
+	panel.HostResetCounts();
+	canvas.BeginFrame();
+	DrawScene(&canvas, canvasGauge, 3000.0f);
+	canvas.Flush();
+	CHECK(panel.HostBytesWritten == 0 && canvas.BytesPushed == 0);
+	CHECK(canvas.TilesHashed > 0 && canvas.TilesPushed == 0);
+
+	// A new reading: only the tiles of the number and the gauge are pushed
+	panel.HostResetCounts();
+	canvas.BeginFrame();
+	DrawScene(&canvas, canvasGauge, 3100.0f);
+	canvas.Flush();
+	DrawScene(&direct, directGauge, 3100.0f);
+	printf("New reading: %u tiles, %lu bytes pushed (full screen %u bytes)\n", canvas.TilesPushed,
+		(unsigned long)panel.HostBytesWritten, 320u * 170u * 2u);
+	CHECK(panel.HostBytesWritten > 0 && panel.HostBytesWritten < 320u * 170u * 2u / 4u);
+	CHECK(panel.HostFrameHash() == direct.HostFrameHash());
+}
+
+static void TestSnapshot()
+{
+	TFT_eSPI panel;
+	panel.setRotation(3);
+	TileRenderer canvas(&panel);
+	canvas.Init();
+	BarGauge gauge;
+	InitGauge(gauge, &canvas);
+	DrawScene(&canvas, gauge, -1200.0f);
+
+	PrintCapture whole;
+	canvas.WriteSnapshot(whole);
+	CHECK(whole.Data.compare(0, 3, "P6\n") == 0);
+	CHECK(whole.Data.size() > 320u * 170u * 3u);
+
+	PrintCapture chunked;
+	canvas.BeginSnapshot();
+	uint32_t chunks = 0;
+	while (!canvas.WriteSnapshotChunk(chunked, 100) && chunks < 10000)
+	{
+		chunks++;
+	}
+	CHECK(chunked.Data == whole.Data);
+	CHECK(chunked.LargestWrite <= 100);
+	CHECK(chunks >= 320u * 170u * 3u / 100u);
+}
+
+int main()
+{
+	TestFlush();
+	TestSnapshot();
+	return HostTestResult("TileRendererTest");
+}
@@ -0,0 +1,83 @@
+/*	TimeHistoryTest.cpp
+*	TimeHistory: interpolation of scalars, pairs and poses, heading wrap, a turret sweep through 180 degrees that must
+*	not take the shorter arc, out of order and out of span queries, and decimation by SetWindow()
+*
+*/
+
+#include "HostTest.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\TimeHistory.h"
+
+static void TestInterpolation()
+{
+	TimeHistory<HistoryPair, 16> tracks;
+	float value = 0.0f;
+	HistoryPair pair;
+	CHECK(!tracks.GetAt(0, pair));
+	tracks.Add(1000, { 100.0f, -100.0f });
+	tracks.Add(2000, { 200.0f, 100.0f });
+	CHECK(tracks.GetAt(1250, pair));
+	CHECK_NEAR(pair.Left, 125.0f, 0.01);
+	CHECK_NEAR(pair.Right, -50.0f, 0.01);
+	CHECK(tracks.GetAt(2000, pair) && pair.Left == 200.0f);
+	CHECK(!tracks.GetAt(999, pair) && !tracks.GetAt(2001, pair));
+	CHECK(!tracks.Add(1500, { 0.0f, 0.0f }) && tracks.OutOfOrder == 1);
+
+	TimeHistory<float, 16> range;
+	range.Add(0, 500.0f);
+	range.Add(0, 600.0f);									// Same time replaces the newest entry
+	CHECK(range.GetCount() == 1 && range.Merged == 1);
+	CHECK(range.GetAt(0, value) && value == 600.0f);
+}
+
+static void TestAngles()
+{
+	// Headings wrap: 350 to 10 degrees passes through 0
+	TimeHistory<HistoryPose, 16> poses;
+	HistoryPose pose;
+	poses.Add(0, { 0.0f, 0.0f, 350.0f });
+	poses.Add(1000, { 1.0f, 2.0f, 10.0f });
+	CHECK(poses.GetAt(500, pose));
+	CHECK_NEAR(pose.X, 0.5f, 0.001);
+	CHECK_NEAR(pose.Y, 1.0f, 0.001);
+	CHECK_NEAR(pose.Heading, 0.0f, 0.01);
+
+	TimeHistory<float, 16, HeadingInterpolator> heading;
+	float value = 0.0f;
+	heading.Add(0, 170.0f);
+	heading.Add(1000, -170.0f);
+	CHECK(heading.GetAt(250, value));
+	CHECK_NEAR(value, 175.0f, 0.01);
+
+	// The turret sweeps between its scan limits and never wraps, so 10 to 350 degrees passes through 180
+	TimeHistory<float, 16> turret;
+	turret.Add(0, 10.0f);
+	turret.Add(1000, 350.0f);
+	CHECK(turret.GetAt(500, value));
+	CHECK_NEAR(value, 180.0f, 0.01);
+}
+
+static void TestWindow()
+{
+	constexpr uint16_t N = 16;
+	TimeHistory<float, N> history;
+	history.SetWindow(1000);								// ms
+	float value = 0.0f;
+	for (int64_t t = 0; t <= 3000000; t += 10000)			// 10 ms apart for 3 s
+	{
+		history.Add(t, (float)t);
+	}
+	CHECK(history.GetCount() == N);
+	CHECK(history.GetNewestTime() == 3000000);
+	CHECK(history.GetNewestTime() - history.GetOldestTime() >= 1000000);
+	CHECK(history.Merged > 0);
+	CHECK(history.GetAt(2500000, value));
+	CHECK_NEAR(value, 2500000.0f, 1.0);
+}
+
+int main()
+{
+	TestInterpolation();
+	TestAngles();
+	TestWindow();
+	return HostTestResult("TimeHistoryTest");
+}
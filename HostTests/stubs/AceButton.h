@@ -0,0 +1,73 @@
+/*	AceButton.h
+*	Host stand-in for the AceButton library; buttons are never checked, so no events are raised
+*
+*/
+
+#ifndef _HOST_ACEBUTTON_h
+#define _HOST_ACEBUTTON_h
+
+#include "Arduino.h"
+
+namespace ace_button
+{
+	class AceButton;
+
+	class ButtonConfig
+	{
+	public:
+		typedef void (*EventHandler)(AceButton* button, uint8_t eventType, uint8_t buttonState);
+
+		static const uint16_t kFeatureClick = 0x01;
+		static const uint16_t kFeatureDoubleClick = 0x02;
+		static const uint16_t kFeatureLongPress = 0x04;
+		static const uint16_t kFeatureRepeatPress = 0x08;
+		static const uint16_t kFeatureSuppressAfterClick = 0x10;
+		static const uint16_t kFeatureSuppressAfterDoubleClick = 0x20;
+
+		virtual ~ButtonConfig() {}
+		virtual int readButton(uint8_t pin) { return digitalRead(pin); }
+		void setEventHandler(EventHandler eventHandler) { Handler = eventHandler; }
+		void setFeature(uint16_t features) {}
+		void clearFeature(uint16_t features) {}
+		void setClickDelay(uint16_t delay) {}
+		void setDoubleClickDelay(uint16_t delay) {}
+		void setLongPressDelay(uint16_t delay) {}
+
+	protected:
+		EventHandler Handler = nullptr;
+	};
+
+	class AceButton
+	{
+	public:
+		static const uint8_t kEventPressed = 0;
+		static const uint8_t kEventReleased = 1;
+		static const uint8_t kEventClicked = 2;
+		static const uint8_t kEventDoubleClicked = 3;
+		static const uint8_t kEventLongPressed = 4;
+		static const uint8_t kEventRepeatPressed = 5;
+		static const uint8_t kEventLongReleased = 6;
+
+		AceButton(ButtonConfig* buttonConfig = nullptr, uint8_t pin = 0, uint8_t defaultReleasedState = HIGH, uint8_t id = 0)
+			: Config(buttonConfig), Pin(pin), Id(id)
+		{
+		}
+		void init(ButtonConfig* buttonConfig, uint8_t pin = 0, uint8_t defaultReleasedState = HIGH, uint8_t id = 0)
+		{
+			Config = buttonConfig;
+			Pin = pin;
+			Id = id;
+		}
+		void check() {}
+		ButtonConfig* getButtonConfig() { return Config; }
+		uint8_t getPin() { return Pin; }
+		uint8_t getId() { return Id; }
+
+	protected:
+		ButtonConfig* Config;
+		uint8_t Pin;
+		uint8_t Id;
+	};
+}
+
+#endif
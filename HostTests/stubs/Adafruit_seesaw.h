@@ -0,0 +1,29 @@
+/*	Adafruit_seesaw.h
+*	Host stand-in for the Adafruit seesaw rotary encoder; the encoder stays where it is set and the button is released
+*
+*/
+
+#ifndef _HOST_ADAFRUIT_SEESAW_h
+#define _HOST_ADAFRUIT_SEESAW_h
+
+#include "Arduino.h"
+
+class Adafruit_seesaw
+{
+protected:
+	int32_t Position = 0;
+
+public:
+	bool begin(uint8_t address = 0x49, int8_t flow = -1, bool reset = true) { return true; }
+	uint32_t getVersion() { return 4991; }
+	void pinMode(uint8_t pin, uint8_t mode) {}
+	bool digitalRead(uint8_t pin) { return true; }
+	int32_t getEncoderPosition(uint8_t encoder = 0) { return Position; }
+	int32_t getEncoderDelta(uint8_t encoder = 0) { return 0; }
+	void setEncoderPosition(int32_t position, uint8_t encoder = 0) { Position = position; }
+	bool enableEncoderInterrupt(uint8_t encoder = 0) { return true; }
+	bool disableEncoderInterrupt(uint8_t encoder = 0) { return true; }
+	void setGPIOInterrupts(uint32_t pins, bool enabled) {}
+};
+
+#endif
@@ -0,0 +1,127 @@
+/*	Arduino.cpp
+*	Minimal Arduino core for building MRS sources on a Linux host
+*
+*/
+
+#include "Arduino.h"
+#include "Wire.h"
+
+#include <chrono>
+#include <random>
+#include <thread>
+
+HardwareSerial Serial;
+HardwareSerial Serial1;
+EspClass ESP;
+TwoWire Wire;
+
+namespace
+{
+	const std::chrono::steady_clock::time_point StartTime = std::chrono::steady_clock::now();
+	bool Simulated = false;
+	uint64_t SimulatedTime = 0;
+	std::mt19937 Generator;
+
+	constexpr int PinCount = 49;
+	int PinLevels[PinCount] = {};
+	void (*PinISRs[PinCount])() = {};
+	int PinISRModes[PinCount] = {};
+
+	uint64_t Now()
+	{
+		if (Simulated)
+		{
+			return SimulatedTime;
+		}
+		return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - StartTime).count();
+	}
+}
+
+void HostClock::Set(uint64_t us)
+{
+	Simulated = true;
+	SimulatedTime = us;
+}
+
+void HostClock::Advance(uint64_t us)
+{
+	SimulatedTime += us;
+}
+
+void HostClock::Release()
+{
+	Simulated = false;
+}
+
+uint32_t micros() { return (uint32_t)Now(); }
+uint32_t millis() { return (uint32_t)(Now() / 1000); }
+int64_t esp_timer_get_time() { return (int64_t)Now(); }
+
+void delayMicroseconds(uint32_t us)
+{
+	if (Simulated)
+	{
+		SimulatedTime += us;
+	}
+	else
+	{
+		std::this_thread::sleep_for(std::chrono::microseconds(us));
+	}
+}
+
+void delay(uint32_t ms) { delayMicroseconds(ms * 1000); }
+
+void HostGPIO::Set(int pin, int value)
+{
+	if (pin < 0 || pin >= PinCount || PinLevels[pin] == value)
+	{
+		return;
+	}
+	PinLevels[pin] = value;
+	int mode = PinISRModes[pin];
+	if (PinISRs[pin] != nullptr && (mode == CHANGE || (mode == RISING && value == HIGH) || (mode == FALLING && value == LOW)))
+	{
+		PinISRs[pin]();
+	}
+}
+
+void HostGPIO::Reset()
+{
+	for (int pin = 0; pin < PinCount; pin++)
+	{
+		PinLevels[pin] = LOW;
+		PinISRs[pin] = nullptr;
+	}
+}
+
+void pinMode(int pin, int mode)
+{
+	if (pin >= 0 && pin < PinCount && mode == INPUT_PULLUP)
+	{
+		PinLevels[pin] = HIGH;
+	}
+}
+
+int digitalRead(int pin) { return (pin >= 0 && pin < PinCount) ? PinLevels[pin] : LOW; }
+void digitalWrite(int pin, int value) { HostGPIO::Set(pin, value); }
+
+void attachInterrupt(int interrupt, void (*isr)(), int mode)
+{
+	if (interrupt >= 0 && interrupt < PinCount)
+	{
+		PinISRs[interrupt] = isr;
+		PinISRModes[interrupt] = mode;
+	}
+}
+
+void detachInterrupt(int interrupt)
+{
+	if (interrupt >= 0 && interrupt < PinCount)
+	{
+		PinISRs[interrupt] = nullptr;
+	}
+}
+
+void randomSeed(unsigned long seed) { Generator.seed(seed); }
+long random(long howBig) { return (howBig <= 0) ? 0 : (long)(Generator() % (unsigned long)howBig); }
+long random(long howSmall, long howBig) { return (howBig <= howSmall) ? howSmall : howSmall + random(howBig - howSmall); }
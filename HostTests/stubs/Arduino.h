@@ -0,0 +1,270 @@
+/*	Arduino.h
+*	Minimal Arduino core for building MRS sources on a Linux host
+*
+*	Time comes from std::chrono::steady_clock until a test calls HostClock::Set(); from then on micros() and millis()
+*	return the simulated time, which the test advances with HostClock::Advance().
+*
+*	Input pins read LOW, or HIGH once set to INPUT_PULLUP, until a test drives them with HostGPIO::Set(), which also
+*	runs any interrupt attached to the pin whose mode matches the edge.
+*
+*/
+
+#ifndef _HOST_ARDUINO_h
+#define _HOST_ARDUINO_h
+
+#ifndef ARDUINO
+#define ARDUINO 200
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <algorithm>
+
+typedef uint8_t byte;
+
+using std::min;
+using std::max;
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#define PI 3.1415926535897932384626433832795
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+#define IRAM_ATTR
+
+namespace HostClock
+{
+	void Set(uint64_t us);
+	void Advance(uint64_t us);
+	void Release();
+}
+
+uint32_t micros();
+uint32_t millis();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+int64_t esp_timer_get_time();
+
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+namespace HostGPIO
+{
+	void Set(int pin, int value);
+	void Reset();
+}
+
+void pinMode(int pin, int mode);
+int digitalRead(int pin);
+void digitalWrite(int pin, int value);
+inline int digitalPinToInterrupt(int pin) { return pin; }
+void attachInterrupt(int interrupt, void (*isr)(), int mode);
+void detachInterrupt(int interrupt);
+
+// LilyGO T-Display-S3 board pins, as in the board variant's pins_arduino.h:
+#define LCD_POWER_ON 15
+#define LCD_BL 38
+
+inline void analogWrite(int pin, int value) {}
+inline int analogRead(int pin) { return 0; }
+inline uint32_t analogReadMilliVolts(int pin) { return 0; }
+
+void randomSeed(unsigned long seed);
+long random(long howBig);
+long random(long howSmall, long howBig);
+
+inline size_t strlcpy(char* dst, const char* src, size_t size)
+{
+	size_t length = strlen(src);
+	if (size != 0)
+	{
+		size_t count = (length < size - 1) ? length : size - 1;
+		memcpy(dst, src, count);
+		dst[count] = '\0';
+	}
+	return length;
+}
+
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(mux) (void)(mux)
+#define portEXIT_CRITICAL(mux) (void)(mux)
+#define portENTER_CRITICAL_ISR(mux) (void)(mux)
+#define portEXIT_CRITICAL_ISR(mux) (void)(mux)
+
+typedef enum
+{
+	GPIO_NUM_NC = -1,
+	GPIO_NUM_0 = 0, GPIO_NUM_1, GPIO_NUM_2, GPIO_NUM_3, GPIO_NUM_4, GPIO_NUM_5, GPIO_NUM_6, GPIO_NUM_7,
+	GPIO_NUM_8, GPIO_NUM_9, GPIO_NUM_10, GPIO_NUM_11, GPIO_NUM_12, GPIO_NUM_13, GPIO_NUM_14, GPIO_NUM_15,
+	GPIO_NUM_16, GPIO_NUM_17, GPIO_NUM_18, GPIO_NUM_19, GPIO_NUM_20, GPIO_NUM_21,
+	GPIO_NUM_35 = 35, GPIO_NUM_36, GPIO_NUM_37, GPIO_NUM_38, GPIO_NUM_39, GPIO_NUM_40, GPIO_NUM_41, GPIO_NUM_42,
+	GPIO_NUM_43, GPIO_NUM_44, GPIO_NUM_45, GPIO_NUM_46, GPIO_NUM_47, GPIO_NUM_48
+} gpio_num_t;
+
+class String : public std::string
+{
+public:
+	String() {}
+	String(const char* s) : std::string(s) {}
+	String(const std::string& s) : std::string(s) {}
+	String(char c) : std::string(1, c) {}
+	String(int value) : std::string(std::to_string(value)) {}
+	String(unsigned int value) : std::string(std::to_string(value)) {}
+	String(long value) : std::string(std::to_string(value)) {}
+	String(unsigned long value) : std::string(std::to_string(value)) {}
+	String(float value, unsigned char decimals = 2) : String((double)value, decimals) {}
+	String(double value, unsigned char decimals = 2)
+	{
+		char buf[32];
+		snprintf(buf, sizeof(buf), "%.*f", decimals, value);
+		assign(buf);
+	}
+	unsigned int length() const { return (unsigned int)size(); }
+};
+
+inline String operator+(const String& a, const String& b) { return String(static_cast<const std::string&>(a) + static_cast<const std::string&>(b)); }
+inline String operator+(const String& a, const char* b) { return String(static_cast<const std::string&>(a) + b); }
+inline String operator+(const char* a, const String& b) { return String(a + static_cast<const std::string&>(b)); }
+
+#define HEX 16
+#define DEC 10
+
+#define SERIAL_8N1 0x800001c
+
+class Print
+{
+public:
+	virtual ~Print() {}
+	virtual size_t write(uint8_t c) = 0;
+	virtual size_t write(const uint8_t* buffer, size_t size)
+	{
+		size_t n = 0;
+		while (size-- > 0)
+		{
+			n += write(*buffer++);
+		}
+		return n;
+	}
+	size_t write(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+
+	size_t print(const char* s) { return write(s); }
+	size_t print(const String& s) { return write((const uint8_t*)s.c_str(), s.size()); }
+	size_t print(char c) { return write((uint8_t)c); }
+	size_t print(unsigned char value, int base = DEC) { return print((unsigned long)value, base); }
+	size_t print(int value, int base = DEC) { return print((long)value, base); }
+	size_t print(unsigned int value, int base = DEC) { return print((unsigned long)value, base); }
+	size_t print(long value, int base = DEC) { return print((long long)value, base); }
+	size_t print(unsigned long value, int base = DEC) { return print((unsigned long long)value, base); }
+	size_t print(long long value, int base = DEC)
+	{
+		if (base == DEC && value < 0)
+		{
+			return print('-') + print((unsigned long long)-value, base);
+		}
+		return print((unsigned long long)value, base);
+	}
+	size_t print(unsigned long long value, int base = DEC)
+	{
+		char buf[24];
+		snprintf(buf, sizeof(buf), (base == HEX) ? "%llX" : "%llu", value);
+		return print(buf);
+	}
+	size_t print(double value, int digits = 2)
+	{
+		char buf[48];
+		snprintf(buf, sizeof(buf), "%.*f", digits, value);
+		return print(buf);
+	}
+
+	size_t println() { return write((const uint8_t*)"\r\n", 2); }
+	template<class T> size_t println(const T& value) { return print(value) + println(); }
+	template<class T> size_t println(const T& value, int format) { return print(value, format) + println(); }
+};
+
+/// <summary>
+/// Output is discarded unless a test sets Capture, in which case it is appended to Output
+/// </summary>
+class HardwareSerial : public Print
+{
+public:
+	bool Capture = false;
+	std::string Output;
+
+	HardwareSerial() {}
+	HardwareSerial(int uartNumber) {}
+	void begin(unsigned long) {}
+	void begin(unsigned long baud, uint32_t config, int8_t rxPin = -1, int8_t txPin = -1) {}
+	void end() {}
+	int available() { return 0; }
+	int read() { return -1; }
+	using Print::write;
+	size_t write(uint8_t c) override
+	{
+		if (Capture)
+		{
+			Output.push_back((char)c);
+		}
+		return 1;
+	}
+	size_t write(const uint8_t* buffer, size_t size) override
+	{
+		if (Capture)
+		{
+			Output.append((const char*)buffer, size);
+		}
+		return size;
+	}
+	int availableForWrite() { return 1 << 16; }
+	void flush() {}
+	operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+
+/// <summary>
+/// Chip and memory figures of an ESP32-S3 with 8 MB of PSRAM, part of it in use
+/// </summary>
+class EspClass
+{
+public:
+	uint32_t getHeapSize() { return 393216; }
+	uint32_t getFreeHeap() { return 262144; }
+	uint32_t getPsramSize() { return 8388608; }
+	uint32_t getFreePsram() { return 8200000; }
+	const char* getChipModel() { return "ESP32-S3"; }
+	uint8_t getChipRevision() { return 0; }
+	uint8_t getChipCores() { return 2; }
+	uint32_t getCpuFreqMHz() { return 240; }
+	uint32_t getSketchSize() { return 1048576; }
+	uint32_t getFreeSketchSpace() { return 2097152; }
+	void restart() {}
+};
+
+extern EspClass ESP;
+
+typedef int esp_err_t;
+#define ESP_OK 0
+
+inline esp_err_t esp_efuse_mac_get_default(uint8_t* mac)
+{
+	static const uint8_t address[6] = { 0x24, 0x6F, 0x28, 0x00, 0x00, 0x01 };
+	memcpy(mac, address, sizeof(address));
+	return ESP_OK;
+}
+
+#endif
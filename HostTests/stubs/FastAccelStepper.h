@@ -0,0 +1,48 @@
+/*	FastAccelStepper.h
+*	Host stand-in for a FastAccelStepper motor
+*
+*	Commands only set the target and speed; the test moves Position towards Target itself, so it can model the
+*	mechanism (e.g. a home flag, or steps lost to a stall) step by step.  Moves run at constant speed.
+*
+*/
+
+#ifndef _HOST_FASTACCELSTEPPER_h
+#define _HOST_FASTACCELSTEPPER_h
+
+#include "Arduino.h"
+
+class FastAccelStepper
+{
+public:
+	int32_t Position = 0;									// steps
+	int32_t Target = 0;
+	uint32_t Speed = 0;										// steps/s
+
+	int32_t getCurrentPosition() { return Position; }
+	int32_t getPositionAfterCommandsCompleted() { return Target; }
+	void setCurrentPosition(int32_t position)
+	{
+		Target += position - Position;
+		Position = position;
+	}
+	bool isRunning() { return Position != Target; }
+	int32_t getCurrentSpeedInMilliHz(bool realtime = true)
+	{
+		return isRunning() ? ((Target > Position) ? 1 : -1) * (int32_t)Speed * 1000 : 0;
+	}
+	int8_t setSpeedInHz(uint32_t speed)
+	{
+		Speed = speed;
+		return 0;
+	}
+	int8_t moveTo(int32_t position, bool blocking = false)
+	{
+		Target = position;
+		return 0;
+	}
+	void forceStop() { Target = Position; }
+	void stopMove() { Target = Position; }
+	void applySpeedAcceleration() {}
+};
+
+#endif
@@ -0,0 +1,11 @@
+/*	HardwareSerial.h
+*	Host stand-in; HardwareSerial is defined with the Arduino core shim
+*
+*/
+
+#ifndef _HOST_HARDWARESERIAL_h
+#define _HOST_HARDWARESERIAL_h
+
+#include "Arduino.h"
+
+#endif
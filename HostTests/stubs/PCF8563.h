@@ -0,0 +1,38 @@
+/*	PCF8563.h
+*	Host stand-in for the PCF8563 RTC library; the clock reads as all zeros
+*
+*/
+
+#ifndef _HOST_PCF8563_h
+#define _HOST_PCF8563_h
+
+#include "Arduino.h"
+
+struct Time
+{
+	uint8_t second = 0;
+	uint8_t minute = 0;
+	uint8_t hour = 0;
+	uint8_t day = 0;
+	uint8_t weekday = 0;
+	uint8_t month = 0;
+	uint8_t year = 0;
+};
+
+class PCF8563
+{
+public:
+	void init() {}
+	bool checkClockIntegrity() { return true; }
+	void stopClock() {}
+	void startClock() {}
+	void setHour(uint8_t hour) {}
+	void setMinut(uint8_t minute) {}
+	void setSecond(uint8_t second) {}
+	void setYear(uint8_t year) {}
+	void setMonth(uint8_t month) {}
+	void setDay(uint8_t day) {}
+	Time getTime() { return Time(); }
+};
+
+#endif
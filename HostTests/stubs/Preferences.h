@@ -0,0 +1,47 @@
+/*	Preferences.h
+*	Host stand-in for the ESP32 Preferences (NVS) store; values are kept in memory for the life of the test
+*
+*/
+
+#ifndef _HOST_PREFERENCES_h
+#define _HOST_PREFERENCES_h
+
+#include "Arduino.h"
+#include <map>
+
+class Preferences
+{
+protected:
+	std::string Namespace;
+
+	static std::map<std::string, float>& Floats()
+	{
+		static std::map<std::string, float> floats;
+		return floats;
+	}
+
+public:
+	bool begin(const char* name, bool readOnly = false)
+	{
+		Namespace = name;
+		return true;
+	}
+	void end() {}
+	float getFloat(const char* key, float defaultValue = NAN)
+	{
+		auto value = Floats().find(Namespace + "/" + key);
+		return (value == Floats().end()) ? defaultValue : value->second;
+	}
+	size_t putFloat(const char* key, float value)
+	{
+		Floats()[Namespace + "/" + key] = value;
+		return sizeof(value);
+	}
+	bool clear()
+	{
+		Floats().clear();
+		return true;
+	}
+};
+
+#endif
@@ -0,0 +1,57 @@
+/*	RoboClaw.h
+*	Host stand-in for the RoboClaw packet serial library; the controller never answers
+*
+*/
+
+#ifndef _HOST_ROBOCLAW_h
+#define _HOST_ROBOCLAW_h
+
+#include "Arduino.h"
+
+class RoboClaw
+{
+public:
+	RoboClaw(HardwareSerial* serial, uint32_t timeout) {}
+	void begin(long speed) {}
+	bool ReadVersion(uint8_t address, char* version) { return false; }
+	uint16_t ReadMainBatteryVoltage(uint8_t address, bool* valid = nullptr)
+	{
+		if (valid != nullptr)
+		{
+			*valid = false;
+		}
+		return 0;
+	}
+	uint16_t ReadLogicBatteryVoltage(uint8_t address, bool* valid = nullptr) { return ReadMainBatteryVoltage(address, valid); }
+	bool ReadMinMaxMainVoltages(uint8_t address, uint16_t& min, uint16_t& max) { return false; }
+	bool ReadM1VelocityPID(uint8_t address, float& kp, float& ki, float& kd, uint32_t& qpps) { return false; }
+	bool ReadM2VelocityPID(uint8_t address, float& kp, float& ki, float& kd, uint32_t& qpps) { return false; }
+	bool ReadPWMs(uint8_t address, int16_t& pwm1, int16_t& pwm2) { return false; }
+	bool ReadTemp(uint8_t address, uint16_t& temp) { return false; }
+	bool ReadTemp2(uint8_t address, uint16_t& temp) { return false; }
+	bool ReadCurrents(uint8_t address, int16_t& current1, int16_t& current2) { return false; }
+	uint32_t ReadEncM1(uint8_t address, uint8_t* status = nullptr, bool* valid = nullptr) { return ReadFailed(valid); }
+	uint32_t ReadEncM2(uint8_t address, uint8_t* status = nullptr, bool* valid = nullptr) { return ReadFailed(valid); }
+	uint32_t ReadSpeedM1(uint8_t address, uint8_t* status = nullptr, bool* valid = nullptr) { return ReadFailed(valid); }
+	uint32_t ReadSpeedM2(uint8_t address, uint8_t* status = nullptr, bool* valid = nullptr) { return ReadFailed(valid); }
+	bool ReadEncoders(uint8_t address, uint32_t& enc1, uint32_t& enc2) { return false; }
+	bool ReadISpeeds(uint8_t address, uint32_t& ispeed1, uint32_t& ispeed2) { return false; }
+	uint32_t ReadError(uint8_t address, bool* valid = nullptr) { return ReadFailed(valid); }
+	bool SpeedM1M2(uint8_t address, uint32_t speed1, uint32_t speed2) { return false; }
+	bool DutyM1M2(uint8_t address, uint16_t duty1, uint16_t duty2) { return false; }
+	bool ForwardM1(uint8_t address, uint8_t speed) { return false; }
+	bool ForwardM2(uint8_t address, uint8_t speed) { return false; }
+	bool ResetEncoders(uint8_t address) { return false; }
+
+protected:
+	uint32_t ReadFailed(bool* valid)
+	{
+		if (valid != nullptr)
+		{
+			*valid = false;
+		}
+		return 0;
+	}
+};
+
+#endif
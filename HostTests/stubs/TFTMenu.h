@@ -0,0 +1,191 @@
+/*	TFTMenu.h
+*	Host stand-in for the TFTMenu library (TFTMenuClass and MenuItemClass)
+*
+*	Items are drawn as the library does, into a sprite of the item's size pushed straight to the panel: a box (dark
+*	grey, light grey for the current item, red when activated), the label top left in yellow and the value top right
+*	in green yellow ("->", "ON"/"OFF" or three digits).
+*
+*/
+
+#ifndef _HOST_TFTMENU_h
+#define _HOST_TFTMENU_h
+
+#include "Arduino.h"
+#include <TFT_eSPI.h>
+
+constexpr byte MAX_MENU_ITEMS = 8;
+
+class MenuItemClass
+{
+public:
+	enum MenuItemTypes
+	{
+		Action,
+		OffOn,
+		Numeric,
+		OptionList,
+
+		NoType
+	};
+	MenuItemTypes MenuItemType = Action;
+
+	typedef void (*MenuItemOnExecuteHandler)(int);
+
+protected:
+	TFT_eSprite* canvas = nullptr;
+
+	uint16_t Xtl;
+	uint16_t Ytl;
+	uint16_t Width;
+	uint16_t Height;
+
+	String Label;
+	bool Activated = false;
+
+	int MinValue = 0;
+	int Value = 0;
+	int MaxValue = 1;
+	int NumericStepSize = 1;
+
+	MenuItemOnExecuteHandler OnExecute = nullptr;
+
+public:
+	MenuItemClass(String label, uint16_t xtl, uint16_t ytl, uint16_t width, uint16_t height, MenuItemTypes menuItemType = OffOn,
+		MenuItemOnExecuteHandler onExecute = nullptr)
+		: MenuItemType(menuItemType), Xtl(xtl), Ytl(ytl), Width(width), Height(height), Label(label), OnExecute(onExecute)
+	{
+	}
+
+	void Init(TFT_eSPI* tft) { canvas = new TFT_eSprite(tft); }
+
+	void Draw(TFT_eSPI* tft, bool isCurrent)
+	{
+		if (canvas == nullptr)
+		{
+			Init(tft);
+		}
+		char buf[16];
+		canvas->createSprite(Width, Height);
+		canvas->fillSprite(TFT_BLACK);
+		canvas->drawRect(0, 0, Width, Height, Activated ? TFT_RED : (isCurrent ? TFT_LIGHTGREY : TFT_DARKGREY));
+		canvas->setTextColor(TFT_YELLOW, TFT_BLACK, true);
+		canvas->setTextDatum(TL_DATUM);
+		canvas->setTextSize(1);
+		canvas->drawString(Label, 2, 2, 1);
+		canvas->setTextColor(TFT_GREENYELLOW, TFT_BLACK, true);
+		canvas->setTextDatum(TR_DATUM);
+		switch (MenuItemType)
+		{
+		case Action:
+			canvas->drawString("->", Width - 2, 2);
+			break;
+		case OffOn:
+			canvas->drawString(Value ? "ON" : "OFF", Width - 2, 2);
+			break;
+		case Numeric:
+			snprintf(buf, sizeof(buf), "%03d", Value);
+			canvas->drawString(buf, Width - 2, 2);
+			break;
+		default:
+			break;
+		}
+		canvas->pushSprite(Xtl, Ytl);
+		canvas->deleteSprite();
+	}
+
+	void Activate(bool isActivated) { Activated = isActivated; }
+
+	void SetMinValue(int minValue)
+	{
+		MinValue = minValue;
+		Value = max(Value, MinValue);
+	}
+	void SetValue(int value) { Value = constrain(value, MinValue, MaxValue); }
+	void SetMaxValue(int maxValue)
+	{
+		MaxValue = maxValue;
+		Value = min(Value, MaxValue);
+	}
+	int GetValue() { return Value; }
+
+	void SetNumericStepSize(int numericStepSize) { NumericStepSize = numericStepSize; }
+	int GetNumericStepSize() { return NumericStepSize; }
+
+	void SetOnExecuteHandler(MenuItemOnExecuteHandler onExecute) { OnExecute = onExecute; }
+	void InvokeOnExecuteHandler()
+	{
+		if (OnExecute != nullptr)
+		{
+			OnExecute(Value);
+		}
+	}
+};
+
+class TFTMenuClass
+{
+protected:
+	MenuItemClass* Items[MAX_MENU_ITEMS] = {};
+	byte CurrentItemIndex = 0;
+	byte ItemCount = 0;
+	TFT_eSPI* tft = nullptr;
+
+public:
+	TFTMenuClass() {}
+	TFTMenuClass(TFT_eSPI* parentTFT) { Init(parentTFT); }
+
+	void Init(TFT_eSPI* parentTFT) { tft = parentTFT; }
+
+	void Draw()
+	{
+		for (byte i = 0; i < ItemCount; ++i)
+		{
+			Items[i]->Draw(tft, i == CurrentItemIndex);
+		}
+	}
+
+	bool AddItem(MenuItemClass* item)
+	{
+		if (ItemCount >= MAX_MENU_ITEMS)
+		{
+			return false;
+		}
+		Items[ItemCount++] = item;
+		return true;
+	}
+
+	MenuItemClass* GetCurrentItem() { return (ItemCount > 0) ? Items[CurrentItemIndex] : nullptr; }
+
+	MenuItemClass* PrevItem()
+	{
+		if (ItemCount == 0)
+		{
+			return nullptr;
+		}
+		Items[CurrentItemIndex]->Draw(tft, false);
+		CurrentItemIndex = (CurrentItemIndex == 0) ? ItemCount - 1 : CurrentItemIndex - 1;
+		Items[CurrentItemIndex]->Draw(tft, true);
+		return Items[CurrentItemIndex];
+	}
+
+	MenuItemClass* NextItem()
+	{
+		if (ItemCount == 0)
+		{
+			return nullptr;
+		}
+		Items[CurrentItemIndex]->Draw(tft, false);
+		CurrentItemIndex = (CurrentItemIndex + 1) % ItemCount;
+		Items[CurrentItemIndex]->Draw(tft, true);
+		return Items[CurrentItemIndex];
+	}
+
+	void ExecuteCurrentItem()
+	{
+		if (ItemCount > 0)
+		{
+			Items[CurrentItemIndex]->InvokeOnExecuteHandler();
+		}
+	}
+};
+
+#endif
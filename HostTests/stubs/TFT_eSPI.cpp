@@ -0,0 +1,949 @@
+/*	TFT_eSPI.cpp
+*	Host framebuffer backend for the subset of the TFT_eSPI / TFT_eSprite API used by the MRS display code
+*
+*/
+
+#include "TFT_eSPI.h"
+
+namespace
+{
+	// Classic 5 x 7 GLCD font, ' ' to '~'; one byte per column, least significant bit at the top
+	const uint8_t GLCDFont[95][5] =
+	{
+		{ 0x00, 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x5F, 0x00, 0x00 }, { 0x00, 0x07, 0x00, 0x07, 0x00 },
+		{ 0x14, 0x7F, 0x14, 0x7F, 0x14 }, { 0x24, 0x2A, 0x7F, 0x2A, 0x12 }, { 0x23, 0x13, 0x08, 0x64, 0x62 },
+		{ 0x36, 0x49, 0x55, 0x22, 0x50 }, { 0x00, 0x05, 0x03, 0x00, 0x00 }, { 0x00, 0x1C, 0x22, 0x41, 0x00 },
+		{ 0x00, 0x41, 0x22, 0x1C, 0x00 }, { 0x14, 0x08, 0x3E, 0x08, 0x14 }, { 0x08, 0x08, 0x3E, 0x08, 0x08 },
+		{ 0x00, 0x50, 0x30, 0x00, 0x00 }, { 0x08, 0x08, 0x08, 0x08, 0x08 }, { 0x00, 0x60, 0x60, 0x00, 0x00 },
+		{ 0x20, 0x10, 0x08, 0x04, 0x02 }, { 0x3E, 0x51, 0x49, 0x45, 0x3E }, { 0x00, 0x42, 0x7F, 0x40, 0x00 },
+		{ 0x42, 0x61, 0x51, 0x49, 0x46 }, { 0x21, 0x41, 0x45, 0x4B, 0x31 }, { 0x18, 0x14, 0x12, 0x7F, 0x10 },
+		{ 0x27, 0x45, 0x45, 0x45, 0x39 }, { 0x3C, 0x4A, 0x49, 0x49, 0x30 }, { 0x01, 0x71, 0x09, 0x05, 0x03 },
+		{ 0x36, 0x49, 0x49, 0x49, 0x36 }, { 0x06, 0x49, 0x49, 0x29, 0x1E }, { 0x00, 0x36, 0x36, 0x00, 0x00 },
+		{ 0x00, 0x56, 0x36, 0x00, 0x00 }, { 0x08, 0x14, 0x22, 0x41, 0x00 }, { 0x14, 0x14, 0x14, 0x14, 0x14 },
+		{ 0x00, 0x41, 0x22, 0x14, 0x08 }, { 0x02, 0x01, 0x51, 0x09, 0x06 }, { 0x32, 0x49, 0x79, 0x41, 0x3E },
+		{ 0x7E, 0x11, 0x11, 0x11, 0x7E }, { 0x7F, 0x49, 0x49, 0x49, 0x36 }, { 0x3E, 0x41, 0x41, 0x41, 0x22 },
+		{ 0x7F, 0x41, 0x41, 0x22, 0x1C }, { 0x7F, 0x49, 0x49, 0x49, 0x41 }, { 0x7F, 0x09, 0x09, 0x09, 0x01 },
+		{ 0x3E, 0x41, 0x49, 0x49, 0x7A }, { 0x7F, 0x08, 0x08, 0x08, 0x7F }, { 0x00, 0x41, 0x7F, 0x41, 0x00 },
+		{ 0x20, 0x40, 0x41, 0x3F, 0x01 }, { 0x7F, 0x08, 0x14, 0x22, 0x41 }, { 0x7F, 0x40, 0x40, 0x40, 0x40 },
+		{ 0x7F, 0x02, 0x0C, 0x02, 0x7F }, { 0x7F, 0x04, 0x08, 0x10, 0x7F }, { 0x3E, 0x41, 0x41, 0x41, 0x3E },
+		{ 0x7F, 0x09, 0x09, 0x09, 0x06 }, { 0x3E, 0x41, 0x51, 0x21, 0x5E }, { 0x7F, 0x09, 0x19, 0x29, 0x46 },
+		{ 0x46, 0x49, 0x49, 0x49, 0x31 }, { 0x01, 0x01, 0x7F, 0x01, 0x01 }, { 0x3F, 0x40, 0x40, 0x40, 0x3F },
+		{ 0x1F, 0x20, 0x40, 0x20, 0x1F }, { 0x3F, 0x40, 0x38, 0x40, 0x3F }, { 0x63, 0x14, 0x08, 0x14, 0x63 },
+		{ 0x07, 0x08, 0x70, 0x08, 0x07 }, { 0x61, 0x51, 0x49, 0x45, 0x43 }, { 0x00, 0x7F, 0x41, 0x41, 0x00 },
+		{ 0x02, 0x04, 0x08, 0x10, 0x20 }, { 0x00, 0x41, 0x41, 0x7F, 0x00 }, { 0x04, 0x02, 0x01, 0x02, 0x04 },
+		{ 0x40, 0x40, 0x40, 0x40, 0x40 }, { 0x00, 0x01, 0x02, 0x04, 0x00 }, { 0x20, 0x54, 0x54, 0x54, 0x78 },
+		{ 0x7F, 0x48, 0x44, 0x44, 0x38 }, { 0x38, 0x44, 0x44, 0x44, 0x20 }, { 0x38, 0x44, 0x44, 0x48, 0x7F },
+		{ 0x38, 0x54, 0x54, 0x54, 0x18 }, { 0x08, 0x7E, 0x09, 0x01, 0x02 }, { 0x0C, 0x52, 0x52, 0x52, 0x3E },
+		{ 0x7F, 0x08, 0x04, 0x04, 0x78 }, { 0x00, 0x44, 0x7D, 0x40, 0x00 }, { 0x20, 0x40, 0x44, 0x3D, 0x00 },
+		{ 0x7F, 0x10, 0x28, 0x44, 0x00 }, { 0x00, 0x41, 0x7F, 0x40, 0x00 }, { 0x7C, 0x04, 0x18, 0x04, 0x78 },
+		{ 0x7C, 0x08, 0x04, 0x04, 0x78 }, { 0x38, 0x44, 0x44, 0x44, 0x38 }, { 0x7C, 0x14, 0x14, 0x14, 0x08 },
+		{ 0x08, 0x14, 0x14, 0x18, 0x7C }, { 0x7C, 0x08, 0x04, 0x04, 0x08 }, { 0x48, 0x54, 0x54, 0x54, 0x20 },
+		{ 0x04, 0x3F, 0x44, 0x40, 0x20 }, { 0x3C, 0x40, 0x40, 0x20, 0x7C }, { 0x1C, 0x20, 0x40, 0x20, 0x1C },
+		{ 0x3C, 0x40, 0x30, 0x40, 0x3C }, { 0x44, 0x28, 0x10, 0x28, 0x44 }, { 0x0C, 0x50, 0x50, 0x50, 0x3C },
+		{ 0x44, 0x64, 0x54, 0x4C, 0x44 }, { 0x00, 0x08, 0x36, 0x41, 0x00 }, { 0x00, 0x00, 0x7F, 0x00, 0x00 },
+		{ 0x00, 0x41, 0x36, 0x08, 0x00 }, { 0x10, 0x08, 0x08, 0x10, 0x08 },
+	};
+	const uint8_t DegreeGlyph[5] = { 0x00, 0x06, 0x09, 0x09, 0x06 };	// 0xF7 in the library's code page
+	const uint8_t BlockGlyph[5] = { 0x7F, 0x41, 0x41, 0x41, 0x7F };	// Anything else outside ' ' to '~'
+
+	/// <summary>
+	/// Cell and glyph scale of the stand in for each library font
+	/// </summary>
+	struct HostFont
+	{
+		int32_t Advance;
+		int32_t Height;
+		int32_t ScaleX;
+		int32_t ScaleY;
+	};
+
+	HostFont GetFont(uint8_t font)
+	{
+		switch (font)
+		{
+		case 2:
+			return { 8, 16, 1, 2 };
+		case 4:
+			return { 14, 26, 2, 3 };
+		case 6:
+		case 7:
+			return { 24, 48, 4, 6 };
+		case 8:
+			return { 36, 75, 6, 9 };
+		default:
+			return { 6, 8, 1, 1 };
+		}
+	}
+
+	const uint8_t* GetGlyph(uint16_t c)
+	{
+		if (c >= ' ' && c <= '~')
+		{
+			return GLCDFont[c - ' '];
+		}
+		return (c == 0xF7) ? DegreeGlyph : BlockGlyph;
+	}
+
+	uint8_t To332(uint16_t color)
+	{
+		return ((color & 0xE000) >> 8) | ((color & 0x0700) >> 6) | ((color & 0x0018) >> 3);
+	}
+
+	uint16_t From332(uint8_t color)
+	{
+		// As the library: each field's top bits repeated into the missing low bits
+		static const uint8_t blue[4] = { 0, 10, 20, 31 };
+		return ((color & 0xE0) << 8) | ((color & 0xC0) << 5) | ((color & 0x1C) << 6) | ((color & 0x1C) << 3) | blue[color & 0x03];
+	}
+}
+
+TFT_eSPI* TFT_eSPI::HostPanel = nullptr;
+uint32_t TFT_eSPI::HostBusFrequency = 0;
+
+TFT_eSPI::TFT_eSPI(int16_t w, int16_t h)
+	: _init_width(w), _init_height(h), _width(w), _height(h), Panel((size_t)w * h, TFT_BLACK), _vpW(w), _vpH(h)
+{
+	if (w > 0 && h > 0)
+	{
+		HostPanel = this;
+	}
+}
+
+void TFT_eSPI::setRotation(uint8_t r)
+{
+	rotation = r & 3;
+	_width = (rotation & 1) ? _init_height : _init_width;
+	_height = (rotation & 1) ? _init_width : _init_height;
+	Panel.assign((size_t)_width * _height, TFT_BLACK);
+	resetViewport();
+}
+
+bool TFT_eSPI::Clip(int32_t& x, int32_t& y, int32_t& w, int32_t& h)
+{
+	if (_vpDatum)
+	{
+		x += _vpX;
+		y += _vpY;
+	}
+	int32_t x0 = _vpSet ? max(x, _vpX) : x;
+	int32_t y0 = _vpSet ? max(y, _vpY) : y;
+	int32_t x1 = _vpSet ? min(x + w, _vpX + _vpW) : x + w;
+	int32_t y1 = _vpSet ? min(y + h, _vpY + _vpH) : y + h;
+	x0 = max(x0, (int32_t)0);
+	y0 = max(y0, (int32_t)0);
+	x1 = min(x1, _width);
+	y1 = min(y1, _height);
+	if (x1 <= x0 || y1 <= y0)
+	{
+		return false;
+	}
+	x = x0;
+	y = y0;
+	w = x1 - x0;
+	h = y1 - y0;
+	return true;
+}
+
+void TFT_eSPI::WritePixel(int32_t x, int32_t y, uint16_t color)
+{
+	Panel[(size_t)y * _width + x] = color;
+}
+
+uint16_t TFT_eSPI::GetPixel(int32_t x, int32_t y)
+{
+	if (x < 0 || y < 0 || x >= _width || y >= _height)
+	{
+		return 0;
+	}
+	return Panel[(size_t)y * _width + x];
+}
+
+void TFT_eSPI::CountBus(uint32_t windows, uint32_t pixels)
+{
+	HostWindows += windows;
+	HostPixelsWritten += pixels;
+	HostBytesWritten += windows * HostWindowBytes + pixels * 2;
+	if (HostBusFrequency > 0)
+	{
+		HostBusTime += (windows * HostWindowBytes + pixels * 2) * 8.0e6 / HostBusFrequency;
+		uint64_t us = (uint64_t)HostBusTime;
+		HostBusTime -= us;
+		HostClock::Advance(us);
+	}
+}
+
+/// <summary>
+/// Writes a rectangle of one colour, as one address window
+/// </summary>
+void TFT_eSPI::Fill(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color, bool count)
+{
+	if (!Clip(x, y, w, h))
+	{
+		return;
+	}
+	for (int32_t j = y; j < y + h; j++)
+	{
+		for (int32_t i = x; i < x + w; i++)
+		{
+			WritePixel(i, j, color);
+		}
+	}
+	if (count)
+	{
+		CountBus(1, w * h);
+	}
+}
+
+/// <summary>
+/// Draws a glyph in a cell of its font; the background is written as the same window if it differs from the colour
+/// </summary>
+void TFT_eSPI::DrawGlyph(int32_t x, int32_t y, uint16_t c, uint32_t color, uint32_t bg, int32_t scaleX, int32_t scaleY)
+{
+	const uint8_t* glyph = GetGlyph(c);
+	bool fillBackground = (color != bg);
+	if (fillBackground)
+	{
+		int32_t cx = x, cy = y, cw = 6 * scaleX, ch = 8 * scaleY;
+		if (Clip(cx, cy, cw, ch))
+		{
+			CountBus(1, cw * ch);
+		}
+		Fill(x, y, 6 * scaleX, 8 * scaleY, bg, false);
+	}
+	for (int32_t column = 0; column < 5; column++)
+	{
+		for (int32_t row = 0; row < 8; row++)
+		{
+			if (glyph[column] & (1 << row))
+			{
+				Fill(x + column * scaleX, y + row * scaleY, scaleX, scaleY, color, !fillBackground);
+			}
+		}
+	}
+}
+
+void TFT_eSPI::drawPixel(int32_t x, int32_t y, uint32_t color)
+{
+	Fill(x, y, 1, 1, color);
+}
+
+void TFT_eSPI::drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uint32_t bg, uint8_t size)
+{
+	DrawGlyph(x, y, c, color, bg, size, size);
+}
+
+/// <summary>
+/// Bresenham line, written in horizontal (or for steep lines vertical) runs as the library does
+/// </summary>
+void TFT_eSPI::drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color)
+{
+	bool steep = abs(y1 - y0) > abs(x1 - x0);
+	if (steep)
+	{
+		std::swap(x0, y0);
+		std::swap(x1, y1);
+	}
+	if (x0 > x1)
+	{
+		std::swap(x0, x1);
+		std::swap(y0, y1);
+	}
+	int32_t dx = x1 - x0;
+	int32_t dy = abs(y1 - y0);
+	int32_t err = dx >> 1;
+	int32_t ystep = (y0 < y1) ? 1 : -1;
+	int32_t runStart = x0;
+	for (int32_t x = x0; x <= x1; x++)
+	{
+		err -= dy;
+		if (err < 0 || x == x1)
+		{
+			if (steep)
+			{
+				Fill(y0, runStart, 1, x - runStart + 1, color);
+			}
+			else
+			{
+				Fill(runStart, y0, x - runStart + 1, 1, color);
+			}
+			if (err < 0)
+			{
+				y0 += ystep;
+				err += dx;
+			}
+			runStart = x + 1;
+		}
+	}
+}
+
+void TFT_eSPI::drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color)
+{
+	Fill(x, y, 1, h, color);
+}
+
+void TFT_eSPI::drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color)
+{
+	Fill(x, y, w, 1, color);
+}
+
+void TFT_eSPI::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color)
+{
+	if (w < 0)
+	{
+		x += w;
+		w = -w;
+	}
+	if (h < 0)
+	{
+		y += h;
+		h = -h;
+	}
+	Fill(x, y, w, h, color);
+}
+
+/// <summary>
+/// Fonts other than the GLCD font are written as a window of the whole cell when the background is filled, and as
+/// rectangles of the foreground colour when it is not
+/// </summary>
+int16_t TFT_eSPI::drawChar(uint16_t uniCode, int32_t x, int32_t y, uint8_t font)
+{
+	HostFont f = GetFont(font);
+	if (f.ScaleY == 1)
+	{
+		drawChar(x, y, uniCode, textcolor, textbgcolor, textsize);
+		return 6 * textsize;
+	}
+
+	int32_t scaleX = f.ScaleX * textsize;
+	int32_t scaleY = f.ScaleY * textsize;
+	int32_t w = f.Advance * textsize;
+	int32_t h = f.Height * textsize;
+	int32_t ox = (w - 6 * scaleX) / 2;
+	int32_t oy = (h - 8 * scaleY) / 2;
+	const uint8_t* glyph = GetGlyph(uniCode);
+	if (textcolor != textbgcolor)
+	{
+		setWindow(x, y, x + w - 1, y + h - 1);
+		for (int32_t j = 0; j < h; j++)
+		{
+			for (int32_t i = 0; i < w; i++)
+			{
+				int32_t column = (i - ox) / scaleX;
+				int32_t row = (j - oy) / scaleY;
+				bool set = (i >= ox && j >= oy && column < 5 && row < 8 && (glyph[column] & (1 << row)));
+				pushColor(set ? textcolor : textbgcolor);
+			}
+		}
+	}
+	else
+	{
+		for (int32_t column = 0; column < 5; column++)
+		{
+			for (int32_t row = 0; row < 8; row++)
+			{
+				if (glyph[column] & (1 << row))
+				{
+					fillRect(x + ox + column * scaleX, y + oy + row * scaleY, scaleX, scaleY, textcolor);
+				}
+			}
+		}
+	}
+	return w;
+}
+
+void TFT_eSPI::setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+{
+	if (_vpDatum)
+	{
+		x0 += _vpX;
+		x1 += _vpX;
+		y0 += _vpY;
+		y1 += _vpY;
+	}
+	WindowX0 = WindowX = x0;
+	WindowY0 = WindowY = y0;
+	WindowX1 = x1;
+	WindowY1 = y1;
+	CountBus(1, 0);
+}
+
+void TFT_eSPI::pushColor(uint16_t color)
+{
+	int32_t minX = _vpSet ? max(_vpX, (int32_t)0) : 0;
+	int32_t minY = _vpSet ? max(_vpY, (int32_t)0) : 0;
+	int32_t maxX = _vpSet ? min(_vpX + _vpW, _width) : _width;
+	int32_t maxY = _vpSet ? min(_vpY + _vpH, _height) : _height;
+	if (WindowX >= minX && WindowY >= minY && WindowX < maxX && WindowY < maxY)
+	{
+		WritePixel(WindowX, WindowY, color);
+	}
+	CountBus(0, 1);
+	if (++WindowX > WindowX1)
+	{
+		WindowX = WindowX0;
+		if (++WindowY > WindowY1)
+		{
+			WindowY = WindowY0;
+		}
+	}
+}
+
+uint16_t TFT_eSPI::readPixel(int32_t x, int32_t y)
+{
+	if (_vpDatum)
+	{
+		x += _vpX;
+		y += _vpY;
+	}
+	return GetPixel(x, y);
+}
+
+void TFT_eSPI::drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color)
+{
+	drawFastHLine(x, y, w, color);
+	drawFastHLine(x, y + h - 1, w, color);
+	drawFastVLine(x, y + 1, h - 2, color);
+	drawFastVLine(x + w - 1, y + 1, h - 2, color);
+}
+
+void TFT_eSPI::drawCircle(int32_t x0, int32_t y0, int32_t r, uint32_t color)
+{
+	int32_t f = 1 - r;
+	int32_t ddFx = 1;
+	int32_t ddFy = -2 * r;
+	int32_t x = 0;
+	int32_t y = r;
+	drawPixel(x0, y0 + r, color);
+	drawPixel(x0, y0 - r, color);
+	drawPixel(x0 + r, y0, color);
+	drawPixel(x0 - r, y0, color);
+	while (x < y)
+	{
+		if (f >= 0)
+		{
+			y--;
+			ddFy += 2;
+			f += ddFy;
+		}
+		x++;
+		ddFx += 2;
+		f += ddFx;
+		drawPixel(x0 + x, y0 + y, color);
+		drawPixel(x0 - x, y0 + y, color);
+		drawPixel(x0 + x, y0 - y, color);
+		drawPixel(x0 - x, y0 - y, color);
+		drawPixel(x0 + y, y0 + x, color);
+		drawPixel(x0 - y, y0 + x, color);
+		drawPixel(x0 + y, y0 - x, color);
+		drawPixel(x0 - y, y0 - x, color);
+	}
+}
+
+void TFT_eSPI::fillCircle(int32_t x0, int32_t y0, int32_t r, uint32_t color)
+{
+	drawFastHLine(x0 - r, y0, 2 * r + 1, color);
+	int32_t f = 1 - r;
+	int32_t ddFx = 1;
+	int32_t ddFy = -2 * r;
+	int32_t x = 0;
+	int32_t y = r;
+	while (x < y)
+	{
+		if (f >= 0)
+		{
+			drawFastHLine(x0 - x, y0 + y, 2 * x + 1, color);
+			drawFastHLine(x0 - x, y0 - y, 2 * x + 1, color);
+			y--;
+			ddFy += 2;
+			f += ddFy;
+		}
+		x++;
+		ddFx += 2;
+		f += ddFx;
+		drawFastHLine(x0 - y, y0 + x, 2 * y + 1, color);
+		drawFastHLine(x0 - y, y0 - x, 2 * y + 1, color);
+	}
+}
+
+void TFT_eSPI::drawTriangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color)
+{
+	drawLine(x0, y0, x1, y1, color);
+	drawLine(x1, y1, x2, y2, color);
+	drawLine(x2, y2, x0, y0, color);
+}
+
+/// <summary>
+/// Filled in horizontal spans, as the library does
+/// </summary>
+void TFT_eSPI::fillTriangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color)
+{
+	// Sort the corners by y
+	if (y0 > y1)
+	{
+		std::swap(y0, y1);
+		std::swap(x0, x1);
+	}
+	if (y1 > y2)
+	{
+		std::swap(y2, y1);
+		std::swap(x2, x1);
+	}
+	if (y0 > y1)
+	{
+		std::swap(y0, y1);
+		std::swap(x0, x1);
+	}
+
+	if (y0 == y2)
+	{
+		int32_t a = min(x0, min(x1, x2));
+		int32_t b = max(x0, max(x1, x2));
+		drawFastHLine(a, y0, b - a + 1, color);
+		return;
+	}
+
+	int32_t dx01 = x1 - x0, dy01 = y1 - y0, dx02 = x2 - x0, dy02 = y2 - y0, dx12 = x2 - x1, dy12 = y2 - y1;
+	int32_t sa = 0, sb = 0;
+	int32_t last = (y1 == y2) ? y1 : y1 - 1;
+	int32_t y = y0;
+	for (; y <= last; y++)
+	{
+		int32_t a = x0 + sa / dy01;
+		int32_t b = x0 + sb / dy02;
+		sa += dx01;
+		sb += dx02;
+		if (a > b)
+		{
+			std::swap(a, b);
+		}
+		drawFastHLine(a, y, b - a + 1, color);
+	}
+	sa = dx12 * (y - y1);
+	sb = dx02 * (y - y0);
+	for (; y <= y2; y++)
+	{
+		int32_t a = x1 + sa / dy12;
+		int32_t b = x0 + sb / dy02;
+		sa += dx12;
+		sb += dx02;
+		if (a > b)
+		{
+			std::swap(a, b);
+		}
+		drawFastHLine(a, y, b - a + 1, color);
+	}
+}
+
+void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* data)
+{
+	setWindow(x, y, x + w - 1, y + h - 1);
+	for (int32_t i = 0; i < w * h; i++)
+	{
+		pushColor(data[i]);
+	}
+}
+
+void TFT_eSPI::setViewport(int32_t x, int32_t y, int32_t w, int32_t h, bool vpDatum)
+{
+	_vpX = x;
+	_vpY = y;
+	_vpW = w;
+	_vpH = h;
+	_vpDatum = vpDatum;
+	_vpSet = true;
+}
+
+void TFT_eSPI::resetViewport()
+{
+	_vpX = 0;
+	_vpY = 0;
+	_vpW = _width;
+	_vpH = _height;
+	_vpDatum = false;
+	_vpSet = false;
+}
+
+int16_t TFT_eSPI::textWidth(const char* string, uint8_t font)
+{
+	return (int16_t)(strlen(string) * GetFont(font).Advance * textsize);
+}
+
+int16_t TFT_eSPI::fontHeight(int16_t font)
+{
+	return (int16_t)(GetFont((uint8_t)font).Height * textsize);
+}
+
+/// <summary>
+/// Draws a string aligned on the text datum, padding the background out to the text padding width
+/// </summary>
+int16_t TFT_eSPI::drawString(const char* string, int32_t x, int32_t y, uint8_t font)
+{
+	int32_t width = textWidth(string, font);
+	int32_t height = fontHeight(font);
+	uint8_t padding = 1;				// 1 left, 2 centre, 3 right aligned
+
+	switch (textdatum)
+	{
+	case TC_DATUM:
+	case C_BASELINE:
+		x -= width / 2;
+		padding = 2;
+		break;
+	case TR_DATUM:
+	case R_BASELINE:
+		x -= width;
+		padding = 3;
+		break;
+	case ML_DATUM:
+		y -= height / 2;
+		break;
+	case MC_DATUM:
+		x -= width / 2;
+		y -= height / 2;
+		padding = 2;
+		break;
+	case MR_DATUM:
+		x -= width;
+		y -= height / 2;
+		padding = 3;
+		break;
+	case BL_DATUM:
+		y -= height;
+		break;
+	case BC_DATUM:
+		x -= width / 2;
+		y -= height;
+		padding = 2;
+		break;
+	case BR_DATUM:
+		x -= width;
+		y -= height;
+		padding = 3;
+		break;
+	default:
+		break;
+	}
+	if (textdatum >= L_BASELINE)
+	{
+		y -= height * 7 / 8;
+	}
+
+	int32_t cursor = x;
+	for (const char* c = string; *c != '\0'; c++)
+	{
+		cursor += drawChar((uint8_t)*c, cursor, y, font);
+	}
+
+	if (padX > width && textcolor != textbgcolor)
+	{
+		int32_t extra = padX - width;
+		switch (padding)
+		{
+		case 1:
+			fillRect(x + width, y, extra, height, textbgcolor);
+			break;
+		case 2:
+			fillRect(x - extra / 2, y, extra / 2, height, textbgcolor);
+			fillRect(x + width, y, extra - extra / 2, height, textbgcolor);
+			break;
+		case 3:
+			fillRect(x - extra, y, extra, height, textbgcolor);
+			break;
+		}
+	}
+	return width;
+}
+
+int16_t TFT_eSPI::drawCentreString(const char* string, int32_t x, int32_t y, uint8_t font)
+{
+	uint8_t datum = textdatum;
+	textdatum = TC_DATUM;
+	int16_t width = drawString(string, x, y, font);
+	textdatum = datum;
+	return width;
+}
+
+int16_t TFT_eSPI::drawRightString(const char* string, int32_t x, int32_t y, uint8_t font)
+{
+	uint8_t datum = textdatum;
+	textdatum = TR_DATUM;
+	int16_t width = drawString(string, x, y, font);
+	textdatum = datum;
+	return width;
+}
+
+int16_t TFT_eSPI::drawNumber(long value, int32_t x, int32_t y, uint8_t font)
+{
+	char buf[24];
+	snprintf(buf, sizeof(buf), "%ld", value);
+	return drawString(buf, x, y, font);
+}
+
+int16_t TFT_eSPI::drawFloat(float value, uint8_t dp, int32_t x, int32_t y, uint8_t font)
+{
+	char buf[32];
+	snprintf(buf, sizeof(buf), "%.*f", dp, value);
+	return drawString(buf, x, y, font);
+}
+
+/// <summary>
+/// Text printed at the cursor, which advances and wraps at the right edge
+/// </summary>
+size_t TFT_eSPI::write(uint8_t c)
+{
+	int32_t height = fontHeight(textfont);
+	if (c == '\n')
+	{
+		cursor_x = 0;
+		cursor_y += height;
+		return 1;
+	}
+	if (c == '\r')
+	{
+		return 1;
+	}
+	int32_t advance = GetFont(textfont).Advance * textsize;
+	if (textwrapX && cursor_x + advance > width())
+	{
+		cursor_x = 0;
+		cursor_y += height;
+	}
+	if (textfont == 1)
+	{
+		drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize);
+	}
+	else
+	{
+		drawChar(c, cursor_x, cursor_y, textfont);
+	}
+	cursor_x += advance;
+	return 1;
+}
+
+void TFT_eSPI::HostResetCounts()
+{
+	HostPixelsWritten = 0;
+	HostBytesWritten = 0;
+	HostWindows = 0;
+}
+
+/// <summary>
+/// FNV-1a hash of every pixel of the screen (or sprite)
+/// </summary>
+uint32_t TFT_eSPI::HostFrameHash()
+{
+	uint32_t hash = 2166136261u;
+	for (int32_t y = 0; y < _height; y++)
+	{
+		for (int32_t x = 0; x < _width; x++)
+		{
+			uint16_t color = GetPixel(x, y);
+			hash = (hash ^ (color & 0xFF)) * 16777619u;
+			hash = (hash ^ (color >> 8)) * 16777619u;
+		}
+	}
+	return hash;
+}
+
+/// <summary>
+/// Saves the screen (or sprite) as a binary (P6) PPM image
+/// </summary>
+bool TFT_eSPI::HostWritePPM(const char* path)
+{
+	FILE* file = fopen(path, "wb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+	fprintf(file, "P6\n# frame %08X\n%d %d\n255\n", (unsigned)HostFrameHash(), (int)_width, (int)_height);
+	for (int32_t y = 0; y < _height; y++)
+	{
+		for (int32_t x = 0; x < _width; x++)
+		{
+			uint16_t color = GetPixel(x, y);
+			uint8_t rgb[3] =
+			{
+				(uint8_t)(((color >> 11) & 0x1F) * 255 / 31),
+				(uint8_t)(((color >> 5) & 0x3F) * 255 / 63),
+				(uint8_t)((color & 0x1F) * 255 / 31),
+			};
+			fwrite(rgb, 1, sizeof(rgb), file);
+		}
+	}
+	return fclose(file) == 0;
+}
+
+TFT_eSprite::TFT_eSprite(TFT_eSPI* tft) : TFT_eSPI(0, 0), _tft(tft)
+{
+}
+
+void* TFT_eSprite::createSprite(int16_t w, int16_t h, uint8_t frames)
+{
+	deleteSprite();
+	if (w <= 0 || h <= 0)
+	{
+		return nullptr;
+	}
+	if (_bpp == 16)
+	{
+		Buffer16.assign((size_t)w * h, TFT_BLACK);
+		_img = Buffer16.data();
+	}
+	else
+	{
+		Buffer8.assign((size_t)w * h, 0);
+		_img = Buffer8.data();
+	}
+	_iwidth = _width = _init_width = w;
+	_iheight = _height = _init_height = h;
+	_created = true;
+	resetViewport();
+	return _img;
+}
+
+void TFT_eSprite::deleteSprite()
+{
+	Buffer16.clear();
+	Buffer8.clear();
+	_img = nullptr;
+	_iwidth = _width = 0;
+	_iheight = _height = 0;
+	_created = false;
+}
+
+/// <summary>
+/// 16 or 8 bit; as in the library, a sprite already created is created again at the new depth
+/// </summary>
+void* TFT_eSprite::setColorDepth(int8_t b)
+{
+	_bpp = (b == 8) ? 8 : 16;
+	if (_created)
+	{
+		return createSprite(_iwidth, _iheight);
+	}
+	return nullptr;
+}
+
+void TFT_eSprite::WritePixel(int32_t x, int32_t y, uint16_t color)
+{
+	if (_bpp == 16)
+	{
+		Buffer16[(size_t)y * _iwidth + x] = color;
+	}
+	else
+	{
+		Buffer8[(size_t)y * _iwidth + x] = To332(color);
+	}
+}
+
+uint16_t TFT_eSprite::GetPixel(int32_t x, int32_t y)
+{
+	if (!_created || x < 0 || y < 0 || x >= _iwidth || y >= _iheight)
+	{
+		return 0;
+	}
+	return (_bpp == 16) ? Buffer16[(size_t)y * _iwidth + x] : From332(Buffer8[(size_t)y * _iwidth + x]);
+}
+
+void TFT_eSprite::fillSprite(uint32_t color)
+{
+	Fill(0, 0, _iwidth, _iheight, color);
+}
+
+void TFT_eSprite::setScrollRect(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color)
+{
+	_sx = max(x, (int32_t)0);
+	_sy = max(y, (int32_t)0);
+	_sw = min(x + w, _iwidth) - _sx;
+	_sh = min(y + h, _iheight) - _sy;
+	_scolor = color;
+}
+
+/// <summary>
+/// Moves the scroll rectangle's pixels, filling what is uncovered with the scroll colour
+/// </summary>
+void TFT_eSprite::scroll(int16_t dx, int16_t dy)
+{
+	if (_sw <= 0 || _sh <= 0)
+	{
+		return;
+	}
+	if (abs(dx) >= _sw || abs(dy) >= _sh)
+	{
+		Fill(_sx, _sy, _sw, _sh, _scolor, false);
+		return;
+	}
+
+	std::vector<uint16_t> area((size_t)_sw * _sh);
+	for (int32_t j = 0; j < _sh; j++)
+	{
+		for (int32_t i = 0; i < _sw; i++)
+		{
+			area[(size_t)j * _sw + i] = GetPixel(_sx + i, _sy + j);
+		}
+	}
+	for (int32_t j = 0; j < _sh; j++)
+	{
+		for (int32_t i = 0; i < _sw; i++)
+		{
+			int32_t si = i - dx;
+			int32_t sj = j - dy;
+			bool inside = (si >= 0 && sj >= 0 && si < _sw && sj < _sh);
+			WritePixel(_sx + i, _sy + j, inside ? area[(size_t)sj * _sw + si] : _scolor);
+		}
+	}
+}
+
+void TFT_eSprite::pushSprite(int32_t x, int32_t y)
+{
+	pushSprite(x, y, 0, 0, _iwidth, _iheight);
+}
+
+/// <summary>
+/// Pushes the pixels that are not the transparent colour, as a window for each run of them in a row
+/// </summary>
+void TFT_eSprite::pushSprite(int32_t x, int32_t y, uint16_t transparent)
+{
+	for (int32_t j = 0; j < _iheight; j++)
+	{
+		int32_t i = 0;
+		while (i < _iwidth)
+		{
+			if (GetPixel(i, j) == transparent)
+			{
+				i++;
+				continue;
+			}
+			int32_t start = i;
+			while (i < _iwidth && GetPixel(i, j) != transparent)
+			{
+				i++;
+			}
+			_tft->setWindow(x + start, y + j, x + i - 1, y + j);
+			for (int32_t k = start; k < i; k++)
+			{
+				_tft->pushColor(GetPixel(k, j));
+			}
+		}
+	}
+}
+
+/// <summary>
+/// Pushes part of the sprite to the same size area of the screen
+/// </summary>
+bool TFT_eSprite::pushSprite(int32_t tx, int32_t ty, int32_t sx, int32_t sy, int32_t sw, int32_t sh)
+{
+	if (!_created || sx < 0 || sy < 0 || sw <= 0 || sh <= 0 || sx + sw > _iwidth || sy + sh > _iheight)
+	{
+		return false;
+	}
+	_tft->setWindow(tx, ty, tx + sw - 1, ty + sh - 1);
+	for (int32_t j = sy; j < sy + sh; j++)
+	{
+		for (int32_t i = sx; i < sx + sw; i++)
+		{
+			_tft->pushColor(GetPixel(i, j));
+		}
+	}
+	return true;
+}
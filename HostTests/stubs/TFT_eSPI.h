@@ -0,0 +1,260 @@
+/*	TFT_eSPI.h
+*	Host framebuffer backend for the subset of the TFT_eSPI / TFT_eSprite API used by the MRS display code
+*
+*	TFT_eSPI draws into an in-memory RGB565 panel and counts the traffic the library would put on the bus: each address
+*	window set (CASET, RASET and RAMWR with their parameters, 11 bytes) and 2 bytes per pixel written.  Like the library,
+*	the text, shape and sprite functions are built on the virtual primitives (drawPixel(), drawChar(), drawLine(),
+*	drawFastVLine(), drawFastHLine(), fillRect() and setWindow()), so classes that override them (e.g. TileRenderer)
+*	see the same calls as on the device.  TFT_eSprite draws with the same primitives into its own buffer, which is
+*	RGB565 at 16 bit colour depth and RGB332 at 8 bit, and counts no bus traffic until it is pushed.  If a test sets
+*	HostBusFrequency the simulated clock is advanced by the time each transfer would take on the bus.
+*
+*	Font 1 is the library's 5 x 7 GLCD font in a 6 x 8 cell.  The other fonts are stood in for by the GLCD glyphs
+*	scaled up to the height of the library font, with a fixed advance, so text is laid out and covers close to the
+*	same area as on the panel but glyph shapes and proportional widths differ.
+*
+*	HostWritePPM() saves the panel (or a sprite) as a binary PPM image and HostFrameHash() hashes its pixels, so that a
+*	page can be compared pixel for pixel before and after a change to how it is drawn.
+*
+*/
+
+#ifndef _HOST_TFT_eSPI_h
+#define _HOST_TFT_eSPI_h
+
+#include "Arduino.h"
+#include <vector>
+
+#ifndef TFT_WIDTH
+#define TFT_WIDTH 170
+#endif
+#ifndef TFT_HEIGHT
+#define TFT_HEIGHT 320
+#endif
+
+#define TFT_BLACK		0x0000
+#define TFT_NAVY		0x000F
+#define TFT_DARKGREEN	0x03E0
+#define TFT_DARKCYAN	0x03EF
+#define TFT_MAROON		0x7800
+#define TFT_PURPLE		0x780F
+#define TFT_OLIVE		0x7BE0
+#define TFT_LIGHTGREY	0xD69A
+#define TFT_DARKGREY	0x7BEF
+#define TFT_BLUE		0x001F
+#define TFT_GREEN		0x07E0
+#define TFT_CYAN		0x07FF
+#define TFT_RED			0xF800
+#define TFT_MAGENTA		0xF81F
+#define TFT_YELLOW		0xFFE0
+#define TFT_WHITE		0xFFFF
+#define TFT_ORANGE		0xFDA0
+#define TFT_GREENYELLOW	0xB7E0
+#define TFT_PINK		0xFE19
+#define TFT_BROWN		0x9A60
+#define TFT_GOLD		0xFEA0
+#define TFT_SILVER		0xC618
+#define TFT_SKYBLUE		0x867D
+#define TFT_VIOLET		0x915C
+#define TFT_TRANSPARENT	0x0120
+
+#define TL_DATUM 0
+#define TC_DATUM 1
+#define TR_DATUM 2
+#define ML_DATUM 3
+#define CL_DATUM 3
+#define MC_DATUM 4
+#define CC_DATUM 4
+#define MR_DATUM 5
+#define CR_DATUM 5
+#define BL_DATUM 6
+#define BC_DATUM 7
+#define BR_DATUM 8
+#define L_BASELINE 9
+#define C_BASELINE 10
+#define R_BASELINE 11
+
+constexpr uint32_t HostWindowBytes = 11;		// CASET + 4, RASET + 4, RAMWR
+
+class TFT_eSPI : public Print
+{
+protected:
+	int32_t _init_width;
+	int32_t _init_height;
+	int32_t _width;
+	int32_t _height;
+	uint8_t rotation = 0;
+	std::vector<uint16_t> Panel;				// RGB565, in rows of the current rotation; cleared by setRotation()
+
+	int32_t _vpX = 0;							// Viewport; clips the primitives and offsets them if _vpDatum
+	int32_t _vpY = 0;
+	int32_t _vpW;
+	int32_t _vpH;
+	bool _vpDatum = false;
+	bool _vpSet = false;
+
+	int32_t WindowX0 = 0;
+	int32_t WindowY0 = 0;
+	int32_t WindowX1 = 0;
+	int32_t WindowY1 = 0;
+	int32_t WindowX = 0;						// Next pixel of pushColor()
+	int32_t WindowY = 0;
+	double HostBusTime = 0.0;					// us of bus traffic not yet added to HostClock
+
+	/// <summary>
+	/// Translates a rectangle to panel coordinates and clips it to the viewport and the screen
+	/// </summary>
+	/// <returns>False if nothing is left</returns>
+	bool Clip(int32_t& x, int32_t& y, int32_t& w, int32_t& h);
+	void Fill(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color, bool count = true);
+	virtual void WritePixel(int32_t x, int32_t y, uint16_t color);
+	virtual uint16_t GetPixel(int32_t x, int32_t y);
+	virtual void CountBus(uint32_t windows, uint32_t pixels);
+	void DrawGlyph(int32_t x, int32_t y, uint16_t c, uint32_t color, uint32_t bg, int32_t scaleX, int32_t scaleY);
+
+public:
+	uint32_t textcolor = TFT_WHITE;
+	uint32_t textbgcolor = TFT_WHITE;
+	uint8_t textfont = 1;
+	uint8_t textsize = 1;
+	uint8_t textdatum = TL_DATUM;
+	uint16_t padX = 0;
+	int32_t cursor_x = 0;
+	int32_t cursor_y = 0;
+	bool textwrapX = true;
+
+	// Bus traffic since the last HostResetCounts():
+	uint64_t HostPixelsWritten = 0;
+	uint64_t HostBytesWritten = 0;
+	uint32_t HostWindows = 0;
+
+	static TFT_eSPI* HostPanel;					// The panel constructed last, for classes that keep theirs protected
+	static uint32_t HostBusFrequency;			// SPI clock, Hz; if set, bus traffic advances HostClock by its duration
+
+	TFT_eSPI(int16_t w = TFT_WIDTH, int16_t h = TFT_HEIGHT);
+	virtual ~TFT_eSPI() {}
+
+	void init(uint8_t tc = 0) {}
+	void begin(uint8_t tc = 0) {}
+	void setRotation(uint8_t r);
+	uint8_t getRotation() { return rotation; }
+	void invertDisplay(bool i) {}
+
+	virtual int16_t width() { return _vpSet ? _vpW : _width; }
+	virtual int16_t height() { return _vpSet ? _vpH : _height; }
+
+	// Primitives:
+	virtual void drawPixel(int32_t x, int32_t y, uint32_t color);
+	virtual void drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uint32_t bg, uint8_t size);
+	virtual void drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color);
+	virtual void drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color);
+	virtual void drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color);
+	virtual void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+	virtual int16_t drawChar(uint16_t uniCode, int32_t x, int32_t y, uint8_t font);
+	virtual int16_t drawChar(uint16_t uniCode, int32_t x, int32_t y) { return drawChar(uniCode, x, y, textfont); }
+	virtual void setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1);
+	virtual void pushColor(uint16_t color);
+	virtual uint16_t readPixel(int32_t x, int32_t y);
+
+	// Shapes:
+	void fillScreen(uint32_t color) { fillRect(0, 0, width(), height(), color); }
+	void drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+	void drawCircle(int32_t x0, int32_t y0, int32_t r, uint32_t color);
+	void fillCircle(int32_t x0, int32_t y0, int32_t r, uint32_t color);
+	void drawTriangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color);
+	void fillTriangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color);
+	void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* data);
+
+	// Viewport:
+	void setViewport(int32_t x, int32_t y, int32_t w, int32_t h, bool vpDatum = true);
+	void resetViewport();
+	int32_t getViewportX() { return _vpX; }
+	int32_t getViewportY() { return _vpY; }
+	int32_t getViewportWidth() { return _vpSet ? _vpW : _width; }
+	int32_t getViewportHeight() { return _vpSet ? _vpH : _height; }
+
+	// Text:
+	void setCursor(int16_t x, int16_t y) { cursor_x = x; cursor_y = y; }
+	void setCursor(int16_t x, int16_t y, uint8_t font) { cursor_x = x; cursor_y = y; textfont = font; }
+	int16_t getCursorX() { return cursor_x; }
+	int16_t getCursorY() { return cursor_y; }
+	void setTextColor(uint16_t color) { textcolor = textbgcolor = color; }
+	void setTextColor(uint16_t fgcolor, uint16_t bgcolor, bool bgfill = false) { textcolor = fgcolor; textbgcolor = bgcolor; }
+	void setTextSize(uint8_t size) { textsize = (size > 0) ? size : 1; }
+	void setTextFont(uint8_t font) { textfont = font; }
+	void setTextDatum(uint8_t datum) { textdatum = datum; }
+	uint8_t getTextDatum() { return textdatum; }
+	void setTextPadding(uint16_t x_width) { padX = x_width; }
+	void setTextWrap(bool wrapX, bool wrapY = false) { textwrapX = wrapX; }
+
+	int16_t textWidth(const char* string, uint8_t font);
+	int16_t textWidth(const char* string) { return textWidth(string, textfont); }
+	int16_t textWidth(const String& string, uint8_t font) { return textWidth(string.c_str(), font); }
+	int16_t textWidth(const String& string) { return textWidth(string.c_str(), textfont); }
+	int16_t fontHeight(int16_t font);
+	int16_t fontHeight() { return fontHeight(textfont); }
+
+	int16_t drawString(const char* string, int32_t x, int32_t y, uint8_t font);
+	int16_t drawString(const char* string, int32_t x, int32_t y) { return drawString(string, x, y, textfont); }
+	int16_t drawString(const String& string, int32_t x, int32_t y, uint8_t font) { return drawString(string.c_str(), x, y, font); }
+	int16_t drawString(const String& string, int32_t x, int32_t y) { return drawString(string.c_str(), x, y, textfont); }
+	int16_t drawCentreString(const char* string, int32_t x, int32_t y, uint8_t font);
+	int16_t drawRightString(const char* string, int32_t x, int32_t y, uint8_t font);
+	int16_t drawNumber(long value, int32_t x, int32_t y, uint8_t font);
+	int16_t drawNumber(long value, int32_t x, int32_t y) { return drawNumber(value, x, y, textfont); }
+	int16_t drawFloat(float value, uint8_t dp, int32_t x, int32_t y, uint8_t font);
+	int16_t drawFloat(float value, uint8_t dp, int32_t x, int32_t y) { return drawFloat(value, dp, x, y, textfont); }
+
+	using Print::write;
+	size_t write(uint8_t c) override;
+
+	uint16_t color565(uint8_t r, uint8_t g, uint8_t b) { return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3); }
+
+	// Host only:
+	void HostResetCounts();
+	uint32_t HostFrameHash();
+	bool HostWritePPM(const char* path);
+	uint16_t HostPixel(int32_t x, int32_t y) { return GetPixel(x, y); }
+};
+
+class TFT_eSprite : public TFT_eSPI
+{
+protected:
+	TFT_eSPI* _tft;
+	std::vector<uint16_t> Buffer16;
+	std::vector<uint8_t> Buffer8;				// RGB332
+	void* _img = nullptr;
+	int32_t _iwidth = 0;
+	int32_t _iheight = 0;
+	uint8_t _bpp = 16;
+	bool _created = false;
+
+	int32_t _sx = 0;							// Scroll rectangle
+	int32_t _sy = 0;
+	int32_t _sw = 0;
+	int32_t _sh = 0;
+	uint16_t _scolor = TFT_BLACK;
+
+	void WritePixel(int32_t x, int32_t y, uint16_t color) override;
+	uint16_t GetPixel(int32_t x, int32_t y) override;
+	void CountBus(uint32_t windows, uint32_t pixels) override {}
+
+public:
+	TFT_eSprite(TFT_eSPI* tft);
+
+	void* createSprite(int16_t w, int16_t h, uint8_t frames = 1);
+	void deleteSprite();
+	bool created() { return _created; }
+	void* getPointer() { return _img; }
+	void* setColorDepth(int8_t b);
+	int8_t getColorDepth() { return _bpp; }
+
+	void fillSprite(uint32_t color);
+	void setScrollRect(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color = TFT_BLACK);
+	void scroll(int16_t dx, int16_t dy = 0);
+
+	void pushSprite(int32_t x, int32_t y);
+	void pushSprite(int32_t x, int32_t y, uint16_t transparent);
+	bool pushSprite(int32_t tx, int32_t ty, int32_t sx, int32_t sy, int32_t sw, int32_t sh);
+};
+
+#endif
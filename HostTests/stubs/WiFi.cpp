@@ -0,0 +1,8 @@
+/*	WiFi.cpp
+*	Host stand-in for the ESP32 WiFi object
+*
+*/
+
+#include "WiFi.h"
+
+WiFiClass WiFi;
@@ -0,0 +1,55 @@
+/*	WiFi.h
+*	Host stand-in for the ESP32 WiFi object: a station that is not connected
+*
+*/
+
+#ifndef _HOST_WIFI_h
+#define _HOST_WIFI_h
+
+#include "Arduino.h"
+
+class IPAddress
+{
+protected:
+	uint8_t Octets[4];
+
+public:
+	IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : Octets{ a, b, c, d } {}
+	String toString() const
+	{
+		char buf[16];
+		snprintf(buf, sizeof(buf), "%u.%u.%u.%u", Octets[0], Octets[1], Octets[2], Octets[3]);
+		return String(buf);
+	}
+};
+
+typedef enum
+{
+	WL_IDLE_STATUS = 0,
+	WL_CONNECTED = 3,
+	WL_DISCONNECTED = 6
+} wl_status_t;
+
+class WiFiClass
+{
+public:
+	IPAddress localIP() { return IPAddress(); }
+	uint8_t* macAddress(uint8_t* mac)
+	{
+		static const uint8_t address[6] = { 0x24, 0x6F, 0x28, 0x00, 0x00, 0x01 };
+		memcpy(mac, address, sizeof(address));
+		return mac;
+	}
+	String macAddress()
+	{
+		return String("24:6F:28:00:00:01");
+	}
+	String SSID() { return String(""); }
+	int8_t RSSI() { return 0; }
+	int32_t channel() { return 1; }
+	wl_status_t status() { return WL_DISCONNECTED; }
+};
+
+extern WiFiClass WiFi;
+
+#endif
@@ -0,0 +1,90 @@
+/*	Wire.h
+*	Host stand-in for the Arduino TwoWire master
+*
+*	Each transaction is handed to the Device installed by the test, which plays the part of the slave(s) on the bus.
+*	With no device installed every address NACKs.  A TwoWire can also stand in for a slave's bus: the bytes its
+*	request handler queues with slaveWrite() are kept in SlaveTxBuffer for the test's device to return.
+*
+*/
+
+#ifndef _HOST_WIRE_h
+#define _HOST_WIRE_h
+
+#include "Arduino.h"
+#include <vector>
+
+class HostI2CDevice
+{
+public:
+	/// <returns>True to ACK the write</returns>
+	virtual bool OnWrite(uint8_t address, const uint8_t* data, size_t length) = 0;
+	/// <returns>Number of bytes placed in data, at most length</returns>
+	virtual size_t OnRead(uint8_t address, uint8_t* data, size_t length) = 0;
+	virtual ~HostI2CDevice() {}
+};
+
+class TwoWire
+{
+protected:
+	uint8_t TxAddress = 0;
+	std::vector<uint8_t> TxBuffer;
+	std::vector<uint8_t> RxBuffer;
+	size_t RxIndex = 0;
+	uint32_t Clock = 100000;
+
+public:
+	HostI2CDevice* Device = nullptr;
+	std::vector<uint8_t> SlaveTxBuffer;
+
+	bool begin() { return true; }
+	bool begin(int sda, int scl, uint32_t frequency = 0) { return true; }
+	void setClock(uint32_t frequency) { Clock = frequency; }
+	uint32_t getClock() { return Clock; }
+
+	void beginTransmission(uint8_t address)
+	{
+		TxAddress = address;
+		TxBuffer.clear();
+	}
+
+	size_t write(uint8_t value)
+	{
+		TxBuffer.push_back(value);
+		return 1;
+	}
+
+	size_t write(const uint8_t* data, size_t length)
+	{
+		TxBuffer.insert(TxBuffer.end(), data, data + length);
+		return length;
+	}
+
+	/// <returns>0 on ACK, 2 on address NACK (as the ESP32 core)</returns>
+	uint8_t endTransmission(bool sendStop = true)
+	{
+		return (Device != nullptr && Device->OnWrite(TxAddress, TxBuffer.data(), TxBuffer.size())) ? 0 : 2;
+	}
+
+	size_t requestFrom(uint8_t address, size_t length, bool sendStop = true)
+	{
+		RxBuffer.assign(length, 0);
+		RxIndex = 0;
+		size_t received = (Device != nullptr) ? Device->OnRead(address, RxBuffer.data(), length) : 0;
+		RxBuffer.resize(min(received, length));
+		return RxBuffer.size();
+	}
+
+	int available() { return (int)(RxBuffer.size() - RxIndex); }
+	int read() { return (RxIndex < RxBuffer.size()) ? RxBuffer[RxIndex++] : -1; }
+	int peek() { return (RxIndex < RxBuffer.size()) ? RxBuffer[RxIndex] : -1; }
+
+	size_t slaveWrite(const uint8_t* data, size_t length)
+	{
+		SlaveTxBuffer.insert(SlaveTxBuffer.end(), data, data + length);
+		return length;
+	}
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,25 @@
+/*	Zanshin_BME680.h
+*	Host stand-in for the Zanshin BME680 library; no sensor answers
+*
+*/
+
+#ifndef _HOST_ZANSHIN_BME680_h
+#define _HOST_ZANSHIN_BME680_h
+
+#include "Arduino.h"
+
+enum sensorTypes { TemperatureSensor, HumiditySensor, PressureSensor, GasSensor, UnknownSensor };
+enum oversamplingTypes { SensorOff, Oversample1, Oversample2, Oversample4, Oversample8, Oversample16, UnknownOversample };
+enum iirFilterTypes { IIROff, IIR2, IIR4, IIR8, IIR16, IIR32, IIR64, IIR128, UnknownIIR };
+
+class BME680_Class
+{
+public:
+	bool begin(uint32_t i2cSpeed = 100000, uint8_t address = 0x76) { return false; }
+	bool setOversampling(uint8_t sensor, uint8_t sampling) { return true; }
+	uint8_t setIIRFilter(uint8_t iirFilterSetting) { return 0; }
+	bool setGas(uint16_t gasTemp, uint16_t gasMillis) { return true; }
+	uint8_t getSensorData(int32_t& temp, int32_t& hum, int32_t& press, int32_t& gas, bool waitSwitch = true) { return 0; }
+};
+
+#endif
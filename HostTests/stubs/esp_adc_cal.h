@@ -0,0 +1,38 @@
+/*	esp_adc_cal.h
+*	Host stand-in for the ESP32 ADC calibration API: an ideal 12 bit converter with a 3.3 V range
+*
+*/
+
+#ifndef _HOST_ESP_ADC_CAL_h
+#define _HOST_ESP_ADC_CAL_h
+
+#include "Arduino.h"
+
+typedef enum { ADC_UNIT_1 = 1, ADC_UNIT_2 = 2 } adc_unit_t;
+typedef enum { ADC_ATTEN_DB_0 = 0, ADC_ATTEN_DB_2_5, ADC_ATTEN_DB_6, ADC_ATTEN_DB_11, ADC_ATTEN_DB_12 = ADC_ATTEN_DB_11 } adc_atten_t;
+typedef enum { ADC_WIDTH_BIT_12 = 3 } adc_bits_width_t;
+typedef enum { ESP_ADC_CAL_VAL_EFUSE_VREF = 0, ESP_ADC_CAL_VAL_EFUSE_TP = 1, ESP_ADC_CAL_VAL_DEFAULT_VREF = 2 } esp_adc_cal_value_t;
+
+typedef struct
+{
+	adc_unit_t adc_num;
+	adc_atten_t atten;
+	adc_bits_width_t bit_width;
+	uint32_t coeff_a;
+	uint32_t coeff_b;
+	uint32_t vref;
+} esp_adc_cal_characteristics_t;
+
+inline esp_adc_cal_value_t esp_adc_cal_characterize(adc_unit_t adc_num, adc_atten_t atten, adc_bits_width_t bit_width,
+	uint32_t default_vref, esp_adc_cal_characteristics_t* chars)
+{
+	*chars = { adc_num, atten, bit_width, 0, 0, default_vref };
+	return ESP_ADC_CAL_VAL_DEFAULT_VREF;
+}
+
+inline uint32_t esp_adc_cal_raw_to_voltage(uint32_t adc_reading, const esp_adc_cal_characteristics_t* chars)
+{
+	return adc_reading * 3300 / 4095;
+}
+
+#endif
@@ -0,0 +1,11 @@
+/*	esp_timer.h
+*	Host stand-in; esp_timer_get_time() is defined with the Arduino core shim
+*
+*/
+
+#ifndef _HOST_ESP_TIMER_h
+#define _HOST_ESP_TIMER_h
+
+#include "Arduino.h"
+
+#endif
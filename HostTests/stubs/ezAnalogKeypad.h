@@ -0,0 +1,21 @@
+/*	ezAnalogKeypad.h
+*	Host stand-in for the ezAnalogKeypad library; no key is ever pressed
+*
+*/
+
+#ifndef _HOST_EZANALOGKEYPAD_h
+#define _HOST_EZANALOGKEYPAD_h
+
+#include "Arduino.h"
+
+class ezAnalogKeypad
+{
+public:
+	ezAnalogKeypad(int pin) {}
+	void setDebounceTime(unsigned long time) {}
+	void setNoPressValue(int analogValue) {}
+	void registerKey(unsigned char key, int analogValue) {}
+	unsigned char getKey() { return 0; }
+};
+
+#endif
@@ -0,0 +1,27 @@
+/*	ezButton.h
+*	Host stand-in for the ezButton library; the button reads its input pin with no debounce
+*
+*/
+
+#ifndef _HOST_EZBUTTON_h
+#define _HOST_EZBUTTON_h
+
+#include "Arduino.h"
+
+class ezButton
+{
+protected:
+	int Pin;
+
+public:
+	ezButton(int pin) : Pin(pin) {}
+	ezButton(int pin, int mode) : Pin(pin) { pinMode(pin, mode); }
+	void setDebounceTime(unsigned long time) {}
+	int getState() { return digitalRead(Pin); }
+	int getStateRaw() { return digitalRead(Pin); }
+	bool isPressed() { return false; }
+	bool isReleased() { return false; }
+	void loop() {}
+};
+
+#endif
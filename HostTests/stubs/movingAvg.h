@@ -0,0 +1,49 @@
+/*	movingAvg.h
+*	Host stand-in for the movingAvg library: a moving average of the last interval readings
+*
+*/
+
+#ifndef _HOST_MOVINGAVG_h
+#define _HOST_MOVINGAVG_h
+
+#include "Arduino.h"
+#include <vector>
+
+class movingAvg
+{
+protected:
+	std::vector<int> Readings;
+	int Interval;
+	int Next = 0;
+	int Count = 0;
+	long Sum = 0;
+
+public:
+	movingAvg(int interval) : Readings(interval), Interval(interval) {}
+	void begin() { reset(); }
+	int reading(int newReading)
+	{
+		if (Count < Interval)
+		{
+			Count++;
+		}
+		else
+		{
+			Sum -= Readings[Next];
+		}
+		Readings[Next] = newReading;
+		Sum += newReading;
+		Next = (Next + 1) % Interval;
+		return getAvg();
+	}
+	int getAvg() { return (Count > 0) ? (int)((Sum + Count / 2) / Count) : 0; }
+	int getCount() { return Count; }
+	void reset()
+	{
+		Next = 0;
+		Count = 0;
+		Sum = 0;
+	}
+};
+
+#endif
@@ -0,0 +1,26 @@
+/*	seesaw_neopixel.h
+*	Host stand-in for the NeoPixel on an Adafruit seesaw rotary encoder
+*
+*/
+
+#ifndef _HOST_SEESAW_NEOPIXEL_h
+#define _HOST_SEESAW_NEOPIXEL_h
+
+#include "Arduino.h"
+
+#define NEO_GRB ((1 << 6) | (1 << 4) | (0 << 2) | (2))
+#define NEO_KHZ800 0x0000
+
+class seesaw_NeoPixel
+{
+public:
+	seesaw_NeoPixel(uint16_t n, uint8_t pin, uint16_t type) {}
+	bool begin(uint8_t address = 0x49, int8_t flow = -1) { return true; }
+	void show() {}
+	void setPixelColor(uint16_t n, uint32_t color) {}
+	void setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b) {}
+	void setBrightness(uint8_t brightness) {}
+	static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) { return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b; }
+};
+
+#endif
@@ -20,7 +20,7 @@
 	#include "WProgram.h"
 #endif
 
-constexpr auto MaxI2CDeviceCount = 8;
+constexpr auto MaxI2CDeviceCount = 16;			// Addresses kept by Scan(); the address strings show the first few
 
 class I2CBusClass
 {
@@ -0,0 +1,235 @@
+/*	BatteryFuelGauge.cpp
+*	BatteryFuelGauge - Coulomb counting state of charge (SOC) estimator for a WaveShare UPS 3S battery pack
+*
+*/
+
+#include "BatteryFuelGauge.h"
+#include <Preferences.h>
+
+// Resting voltage of a typical 18650 Li-ion cell at 0, 10, ... 100 % SOC:
+const float BatteryFuelGauge::OCVTable[BatteryFuelGauge::OCVTableSize] =
+{
+	3.00f, 3.45f, 3.55f, 3.62f, 3.68f, 3.74f, 3.80f, 3.88f, 3.96f, 4.06f, 4.18f
+};
+
+/// <summary>
+/// Interpolates SOC from the OCV table
+/// </summary>
+/// <param name="cellVoltage">Open circuit voltage of a single cell (V)</param>
+/// <returns>State of charge (%)</returns>
+float BatteryFuelGauge::SOCFromCellVoltage(float cellVoltage)
+{
+	if (cellVoltage <= OCVTable[0])
+	{
+		return 0.0f;
+	}
+	if (cellVoltage >= OCVTable[OCVTableSize - 1])
+	{
+		return 100.0f;
+	}
+
+	uint8_t i = 1;
+	while (cellVoltage > OCVTable[i])
+	{
+		i++;
+	}
+	float fraction = (cellVoltage - OCVTable[i - 1]) / (OCVTable[i] - OCVTable[i - 1]);
+	return 10.0f * ((float)(i - 1) + fraction);
+}
+
+/// <summary>
+/// Estimates SOC from the pack voltage, compensating for the voltage drop across the pack internal resistance
+/// </summary>
+/// <param name="busVoltage">Pack terminal voltage (V)</param>
+/// <param name="dischargeCurrent">Pack current, positive while discharging (mA)</param>
+/// <returns>State of charge (%)</returns>
+float BatteryFuelGauge::EstimateOCVSOC(float busVoltage, float dischargeCurrent)
+{
+	float ocv = busVoltage + dischargeCurrent * Resistance / 1000.0f;
+	return SOCFromCellVoltage(ocv / UPS3SCellCount);
+}
+
+/// <summary>
+/// Reads the last saved SOC from NVS
+/// </summary>
+/// <param name="soc">Saved state of charge (%)</param>
+/// <returns>true if a valid record was found</returns>
+bool BatteryFuelGauge::Load(float& soc)
+{
+	Preferences prefs;
+	if (!prefs.begin(NVSNamespace, true))
+	{
+		return false;
+	}
+	float savedCharge = prefs.getFloat("charge", -1.0f);
+	float savedCapacity = prefs.getFloat("capacity", 0.0f);
+	prefs.end();
+
+	if (savedCharge < 0.0f || savedCapacity <= 0.0f)
+	{
+		return false;
+	}
+	soc = 100.0f * savedCharge / savedCapacity;
+	return true;
+}
+
+/// <summary>
+/// Seeds the fuel gauge from the charge saved in NVS, falling back to the OCV estimate if there is no saved
+/// record or the saved record is inconsistent with the present pack voltage (e.g., pack charged while powered off)
+/// </summary>
+/// <param name="nvsNamespace">Preferences namespace used to persist accumulated charge (max 15 characters)</param>
+/// <param name="busVoltage">Present pack voltage (V)</param>
+/// <param name="current">Present INA219 current reading (mA)</param>
+/// <param name="capacity">Rated pack capacity (mAh)</param>
+/// <returns>true if the saved charge was restored</returns>
+bool BatteryFuelGauge::Init(const char* nvsNamespace, float busVoltage, float current, float capacity)
+{
+	NVSNamespace = nvsNamespace;
+	Capacity = capacity;
+	BusVoltage = busVoltage;
+	Current = current * CurrentSign;
+	AvgDischargeCurrent = (Current > 0.0f) ? Current : 0.0f;
+	OCVSOC = EstimateOCVSOC(BusVoltage, Current);
+
+	float savedSOC = 0.0f;
+	bool restored = Load(savedSOC) && (fabs(savedSOC - OCVSOC) <= FuelGaugeColdStartSOCError);
+	Charge = Capacity * (restored ? savedSOC : OCVSOC) / 100.0f;
+	SavedCharge = Charge;
+
+	LastSampleTime = micros();
+	RestStartTime = millis();
+	LastSaveTime = RestStartTime;
+	AtRest = false;
+	Initialized = true;
+
+	return restored;
+}
+
+/// <summary>
+/// Integrates pack current since the last sample and applies the OCV correction while the pack is at rest;
+/// intended to be called at a steady, relatively high rate (e.g., 50 Hz)
+/// </summary>
+/// <param name="busVoltage">Pack voltage (V)</param>
+/// <param name="current">INA219 current reading (mA)</param>
+void BatteryFuelGauge::AddSample(float busVoltage, float current)
+{
+	if (!Initialized)
+	{
+		return;
+	}
+
+	uint32_t now = micros();
+	float dt = (float)(now - LastSampleTime) / 1000000.0f;	// s
+	LastSampleTime = now;
+
+	// Trapezoidal integration of discharge current:
+	float newCurrent = current * CurrentSign;
+	Charge -= 0.5f * (Current + newCurrent) * dt / 3600.0f;
+	Charge = constrain(Charge, 0.0f, Capacity);
+	Current = newCurrent;
+	BusVoltage = busVoltage;
+
+	float alpha = dt / defaultFuelGaugeCurrentTau;
+	AvgDischargeCurrent += (Current - AvgDischargeCurrent) * ((alpha < 1.0f) ? alpha : 1.0f);
+
+	// Correct drift in the coulomb count against OCV only after the pack has relaxed:
+	uint32_t nowMs = millis();
+	if (fabs(Current) < defaultFuelGaugeRestCurrent)
+	{
+		AtRest = (nowMs - RestStartTime) >= defaultFuelGaugeRestTime;
+	}
+	else
+	{
+		RestStartTime = nowMs;
+		AtRest = false;
+	}
+
+	OCVSOC = EstimateOCVSOC(BusVoltage, Current);
+	if (AtRest)
+	{
+		alpha = dt / defaultFuelGaugeOCVTau;
+		Charge += (Capacity * OCVSOC / 100.0f - Charge) * ((alpha < 1.0f) ? alpha : 1.0f);
+	}
+
+	Save();
+}
+
+/// <summary>
+/// Writes the accumulated charge to NVS; unless forced, writes are rate limited to spare the flash
+/// </summary>
+/// <param name="force">Write regardless of elapsed time or change in charge</param>
+void BatteryFuelGauge::Save(bool force)
+{
+	if (!Initialized || NVSNamespace == nullptr)
+	{
+		return;
+	}
+
+	uint32_t now = millis();
+	bool due = (now - LastSaveTime >= defaultFuelGaugeSaveInterval)
+		&& (fabs(Charge - SavedCharge) >= Capacity * defaultFuelGaugeSaveDelta / 100.0f);
+	if (!force && !due)
+	{
+		return;
+	}
+
+	Preferences prefs;
+	if (prefs.begin(NVSNamespace, false))
+	{
+		prefs.putFloat("charge", Charge);
+		prefs.putFloat("capacity", Capacity);
+		prefs.end();
+		SavedCharge = Charge;
+	}
+	LastSaveTime = now;
+}
+
+/// <summary>
+/// Overrides the accumulated charge, e.g., after installing a freshly charged pack
+/// </summary>
+/// <param name="soc">New state of charge (%)</param>
+void BatteryFuelGauge::Reset(float soc)
+{
+	Charge = Capacity * constrain(soc, 0.0f, 100.0f) / 100.0f;
+	Save(true);
+}
+
+float BatteryFuelGauge::GetSOC()
+{
+	return 100.0f * Charge / Capacity;
+}
+
+float BatteryFuelGauge::GetOCVSOC()
+{
+	return OCVSOC;
+}
+
+float BatteryFuelGauge::GetRemainingCharge()
+{
+	return Charge;
+}
+
+float BatteryFuelGauge::GetAverageDischargeCurrent()
+{
+	return AvgDischargeCurrent;
+}
+
+float BatteryFuelGauge::GetRuntime()
+{
+	if (AvgDischargeCurrent < 1.0f)
+	{
+		return -1.0f;
+	}
+	return 60.0f * Charge / AvgDischargeCurrent;
+}
+
+bool BatteryFuelGauge::IsAtRest()
+{
+	return AtRest;
+}
+
+bool BatteryFuelGauge::IsLow()
+{
+	float runtime = GetRuntime();
+	return (GetSOC() < LowBatterySOCThreshold) || (runtime >= 0.0f && runtime < LowBatteryRuntimeThreshold);
+}
@@ -0,0 +1,82 @@
+/*	BatteryFuelGauge.h
+*	BatteryFuelGauge - Coulomb counting state of charge (SOC) estimator for a WaveShare UPS 3S battery pack,
+*	using the pack's INA219 current / bus voltage monitor
+*
+*	Current is integrated at the sample rate of the caller; the open circuit voltage (OCV) of the pack is used
+*	to correct the accumulated charge while the pack is at rest, and to seed the estimate on a cold start.
+*	Accumulated charge is saved to NVS (Preferences) so the estimate survives a reboot.
+*
+*	Mitchell Baldwin copyright 2025
+*
+*	v 0.00:	Initial data structure
+*	v
+*
+*/
+
+#ifndef _BatteryFuelGauge_h
+#define _BatteryFuelGauge_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+constexpr uint8_t UPS3SCellCount = 3;
+constexpr float defaultUPS3SCapacity = 2600.0f;				// mAh; 3S1P pack of 18650 cells fitted to the WaveShare UPS 3S
+constexpr float defaultUPS3SResistance = 0.15f;				// ohm; pack internal resistance used to estimate OCV under load
+constexpr float defaultFuelGaugeRestCurrent = 60.0f;		// mA; pack is considered at rest below this current
+constexpr uint32_t defaultFuelGaugeRestTime = 30000;		// ms; continuous rest required before OCV corrections are applied
+constexpr float defaultFuelGaugeOCVTau = 20.0f;				// s; time constant for blending OCV based SOC into the coulomb count
+constexpr float defaultFuelGaugeCurrentTau = 60.0f;			// s; time constant of the average discharge current used for runtime
+constexpr uint32_t defaultFuelGaugeSaveInterval = 60000;	// ms; minimum interval between NVS writes
+constexpr float defaultFuelGaugeSaveDelta = 0.5f;			// %; minimum change in SOC before an NVS write
+constexpr float FuelGaugeColdStartSOCError = 20.0f;			// %; saved SOC is discarded if the OCV estimate disagrees by more than this
+
+constexpr float LowBatterySOCThreshold = 15.0f;				// %; warn operator below this SOC
+constexpr float LowBatteryRuntimeThreshold = 10.0f;			// min; warn operator below this estimated runtime
+
+class BatteryFuelGauge
+{
+protected:
+	static const uint8_t OCVTableSize = 11;
+	static const float OCVTable[OCVTableSize];		// V per cell at 0, 10, ... 100 % SOC
+
+	const char* NVSNamespace = nullptr;
+	float Capacity = defaultUPS3SCapacity;			// mAh
+	float Resistance = defaultUPS3SResistance;		// ohm
+	float CurrentSign = -1.0f;						// INA219 current is negative while the WaveShare UPS 3S is discharging
+
+	float Charge = 0.0f;							// mAh remaining
+	float SavedCharge = 0.0f;						// mAh; value last written to NVS
+	float AvgDischargeCurrent = 0.0f;				// mA; positive while discharging
+	float OCVSOC = 0.0f;							// %; SOC implied by the (IR compensated) pack voltage
+	float BusVoltage = 0.0f;						// V
+	float Current = 0.0f;							// mA; positive while discharging
+
+	uint32_t LastSampleTime = 0;					// us
+	uint32_t RestStartTime = 0;						// ms
+	uint32_t LastSaveTime = 0;						// ms
+	bool AtRest = false;
+	bool Initialized = false;
+
+	float SOCFromCellVoltage(float cellVoltage);
+	float EstimateOCVSOC(float busVoltage, float dischargeCurrent);
+	bool Load(float& soc);
+
+public:
+	bool Init(const char* nvsNamespace, float busVoltage, float current, float capacity = defaultUPS3SCapacity);
+	void AddSample(float busVoltage, float current);
+	void Save(bool force = false);
+	void Reset(float soc);
+
+	float GetSOC();									// %
+	float GetOCVSOC();								// %
+	float GetRemainingCharge();						// mAh
+	float GetAverageDischargeCurrent();				// mA
+	float GetRuntime();								// min; < 0 when the pack is not discharging
+	bool IsAtRest();
+	bool IsLow();
+};
+
+#endif
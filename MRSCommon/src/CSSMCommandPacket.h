@@ -20,6 +20,11 @@
 	#include "WProgram.h"
 #endif
 
+// ConfigureFwdRanging settings, packed into turretPosition:
+constexpr int16_t FwdRangingBudgetMask = 0x03FF;			// Timing budget, ms
+constexpr int16_t FwdRangingLongMode = 0x0400;				// Long distance mode; short mode if clear
+constexpr int16_t FwdRangingZoneCycling = 0x0800;			// Cycle through the ROI zones rather than use only the full array
+
 class CSSMCommandPacket
 {
 public:
@@ -36,14 +41,21 @@ public:
 		SetTurretPosition = 0x20,
 		GetTurretPosition = 0x21,
 		GetFwdLIDARRange = 0x22,
+		StartTurretScan = 0x23,								// Sweep the sensor turret and build polar range scans
+		StopTurretScan = 0x24,
+		SetTurretScanPattern = 0x25,						// turretPosition carries the pattern (see STScanPattern.h in MRSSENXIAOS3)
+		HomeTurret = 0x26,									// Re-reference the sensor turret position (see STHoming.h in MRSSENXIAOS3)
+		ConfigureFwdRanging = 0x27,							// turretPosition carries the forward VL53L1X settings (FwdRanging... below)
+		SetTurretAutoRehome = 0x28,							// turretPosition 1 enables periodic sensor turret re-homing, 0 disables it
 
 	};
 protected:
 	uint8_t PacketType = 0x24;								// Identifies packet type; fixed for all CSSMCommandPackets
 
 public:
+	uint8_t sequence = 0;									// Set by the MCC when forwarding to the MRS SEN module; echoed in its command acknowledge register
 	CSSMCommandCodes command = CSSMCommandCodes::NoCommand;
-	int16_t turretPosition = 0;								// Target turret position in steps; used only for SetTurretPosition command
+	int16_t turretPosition = 0;								// Target turret position in steps for SetTurretPosition; scan pattern for SetTurretScanPattern
 
 };
 
@@ -56,6 +56,11 @@ public:
 	float SpeedSetting = 0.0f;					// Commanded throttle setting (mm/s)
 	float LThrottle = 0.0f;						// Commanded left throttle setting (100.0%)
 	float RThrottle = 0.0f;						// Commanded right throttle setting (100.0%)
+	float WaypointX = 0.0f;						// Commanded waypoint (m, OTOS frame) in WPT mode
+	float WaypointY = 0.0f;
+	bool WaypointValid = false;					// Set when the operator enters a waypoint; the MCC does not navigate without it
+	uint8_t WaypointSequence = 0;				// Incremented each time a waypoint is entered, so re-entering one restarts WPT
+	uint16_t LinkSequence = 0;					// Incremented for each packet sent; used by the MCC's LinkMonitor
 
 	void NextDriveMode()
 	{
@@ -0,0 +1,174 @@
+/*	ClockSync.cpp
+*	ClockSyncClass - Estimates the offset and drift of a remote clock from timestamped exchanges, NTP style
+*
+*	Mitchell Baldwin copyright 2025
+*
+*/
+
+#include "ClockSync.h"
+
+/// <summary>
+/// Adds a four timestamp exchange initiated by this module
+/// </summary>
+/// <param name="originateTime">Local time the request was sent (t1)</param>
+/// <param name="receiveTime">Remote time the request was received (t2)</param>
+/// <param name="transmitTime">Remote time the reply was sent (t3)</param>
+/// <param name="destinationTime">Local time the reply was received (t4)</param>
+/// <returns>False if the exchange was discarded</returns>
+bool ClockSyncClass::AddExchange(int64_t originateTime, int64_t receiveTime, int64_t transmitTime, int64_t destinationTime)
+{
+	int64_t roundTrip = (destinationTime - originateTime) - (transmitTime - receiveTime);
+	return AddSample((originateTime + destinationTime) / 2, (receiveTime + transmitTime) / 2, (uint32_t)max(roundTrip, (int64_t)0));
+}
+
+/// <summary>
+/// Adds one reading of the remote clock
+/// </summary>
+/// <param name="localTime">us</param>
+/// <param name="remoteTime">Remote clock at localTime, us</param>
+/// <param name="roundTrip">us; the reading is uncertain by half of this</param>
+/// <returns>False if the reading was discarded</returns>
+bool ClockSyncClass::AddSample(int64_t localTime, int64_t remoteTime, uint32_t roundTrip)
+{
+	Exchanges++;
+	LastRoundTrip = roundTrip;
+	if (SampleCount > 0 && roundTrip > GetMinRoundTrip() * ClockSyncRoundTripGate + ClockSyncRoundTripSlack
+		&& Rejects < ClockSyncMaxRejects)
+	{
+		Rejects++;
+		Rejected++;
+		return false;
+	}
+	Rejects = 0;
+
+	int64_t offset = remoteTime - localTime;
+	if (SampleCount > 0)
+	{
+		ResidualOffset = (int32_t)(offset - (ToShared(localTime) - localTime));
+	}
+
+	Samples[SampleHead] = { localTime, offset, roundTrip };
+	SampleHead = (SampleHead + 1) % ClockSyncWindow;
+	if (SampleCount < ClockSyncWindow)
+	{
+		SampleCount++;
+	}
+	Fit();
+	return true;
+}
+
+uint32_t ClockSyncClass::GetMinRoundTrip() const
+{
+	uint32_t minRoundTrip = UINT32_MAX;
+	for (uint8_t i = 0; i < SampleCount; i++)
+	{
+		minRoundTrip = min(minRoundTrip, Samples[i].RoundTrip);
+	}
+	return minRoundTrip;
+}
+
+/// <summary>
+/// Fits offset = FitOffset + Drift * (local time - FitLocalTime) through the stored samples, relative to the newest
+/// so the doubles only hold small numbers
+/// </summary>
+void ClockSyncClass::Fit()
+{
+	const ClockSyncSample& newest = Samples[(SampleHead + ClockSyncWindow - 1) % ClockSyncWindow];
+	FitLocalTime = newest.LocalTime;
+	if (SampleCount < ClockSyncMinExchanges)
+	{
+		FitOffset = newest.Offset;
+		Drift = 0.0;
+		return;
+	}
+
+	double sumX = 0.0, sumY = 0.0, sumXX = 0.0, sumXY = 0.0;
+	for (uint8_t i = 0; i < SampleCount; i++)
+	{
+		double x = (double)(Samples[i].LocalTime - newest.LocalTime);
+		double y = (double)(Samples[i].Offset - newest.Offset);
+		sumX += x;
+		sumY += y;
+		sumXX += x * x;
+		sumXY += x * y;
+	}
+	double n = SampleCount;
+	double denominator = n * sumXX - sumX * sumX;
+	Drift = (denominator > 0.0) ? (n * sumXY - sumX * sumY) / denominator : 0.0;
+	FitOffset = newest.Offset + (sumY - Drift * sumX) / n;
+}
+
+void ClockSyncClass::Reset()
+{
+	SampleHead = 0;
+	SampleCount = 0;
+	Rejects = 0;
+	FitOffset = 0.0;
+	Drift = 0.0;
+}
+
+bool ClockSyncClass::IsSynchronised() const
+{
+	return SampleCount >= ClockSyncMinExchanges;
+}
+
+/// <returns>Shared (MCC) time corresponding to a local esp_timer_get_time() value</returns>
+int64_t ClockSyncClass::ToShared(int64_t localTime) const
+{
+	return localTime + (int64_t)(FitOffset + Drift * (double)(localTime - FitLocalTime));
+}
+
+/// <returns>us, shared (MCC) time base</returns>
+int64_t ClockSyncClass::GetSharedTime() const
+{
+	return ToShared(esp_timer_get_time());
+}
+
+float ClockSyncClass::GetDriftPPM() const
+{
+	return Drift * 1.0e6;
+}
+
+String ClockSyncClass::GetStatusString() const
+{
+	char buf[64];
+	snprintf(buf, sizeof(buf), "Clk %+ld us %+.1f ppm rt %lu us %lu/%lu", (long)ResidualOffset, GetDriftPPM(),
+		(unsigned long)LastRoundTrip, (unsigned long)(Exchanges - Rejected), (unsigned long)Exchanges);
+	return String(buf);
+}
+
+/// <summary>
+/// Synchronises to a simulated remote clock with a fixed offset and drift, over a link whose one way delays are
+/// random up to maxDelay, and returns the worst error of ToShared() over the second half of the run
+/// </summary>
+/// <param name="driftPPM">Remote clock rate error</param>
+/// <param name="maxDelay">us</param>
+/// <param name="exchanges">Number of exchanges, ClockSyncInterval apart</param>
+/// <returns>us</returns>
+int32_t ClockSyncClass::Simulate(float driftPPM, uint32_t maxDelay, uint16_t exchanges)
+{
+	ClockSyncClass clock;
+	const int64_t remoteOffset = 123456789;			// us
+	auto remoteAt = [&](int64_t local) { return local + remoteOffset + (int64_t)(local * (double)driftPPM * 1.0e-6); };
+
+	int32_t worstError = 0;
+	int64_t local = 1000000;
+	for (uint16_t i = 0; i < exchanges; i++)
+	{
+		int64_t requestDelay = random(maxDelay + 1);
+		int64_t t1 = local;
+		int64_t t2 = remoteAt(t1 + requestDelay);
+		int64_t t3 = t2 + random(500);
+		int64_t t4 = t1 + requestDelay + (t3 - t2) + random(maxDelay + 1);
+		clock.AddExchange(t1, t2, t3, t4);
+
+		if (i >= exchanges / 2)
+		{
+			int64_t check = local + ClockSyncInterval * 500LL;	// Halfway to the next exchange
+			int32_t error = (int32_t)(clock.ToShared(check) - remoteAt(check));
+			worstError = max(worstError, (int32_t)abs(error));
+		}
+		local += ClockSyncInterval * 1000LL;
+	}
+	return worstError;
+}
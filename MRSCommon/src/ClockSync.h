@@ -0,0 +1,79 @@
+/*	ClockSync.h
+*	ClockSyncClass - Estimates the offset and drift of a remote clock from timestamped exchanges, NTP style
+*
+*	The MCC's esp_timer_get_time() (us since the MCC booted) is the shared time base; the MRS SEN module and the
+*	CSSM each run a ClockSyncClass to map their own esp_timer_get_time() onto it.  Each exchange gives the remote
+*	clock reading at a local time, with an uncertainty of half the round trip: over ESP-NOW the CSSM stamps a
+*	TimeSyncPacket request (t1), the MCC stamps its receipt (t2) and reply (t3) and the CSSM stamps the reply's
+*	receipt (t4); over I2C the MCC stamps either side of a clock register read (t1, t4), the MRS SEN module stamps
+*	the read from its request handler and the MCC writes all three back (see MRSSENRegisterMap.h).
+*
+*	Exchanges whose round trip is well above the recent minimum (delayed by a busy bus or radio) are discarded;
+*	offset and drift are then a least squares line through the remaining offsets over the last ClockSyncWindow
+*	exchanges.
+*
+*	Mitchell Baldwin copyright 2025
+*
+*	v 0.00:	Initial data structure
+*	v
+*
+*/
+
+#ifndef _ClockSync_h
+#define _ClockSync_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+#include <esp_timer.h>
+
+constexpr uint8_t ClockSyncWindow = 16;					// Exchanges in the offset / drift fit
+constexpr uint8_t ClockSyncMinExchanges = 3;			// Before the drift estimate is trusted
+constexpr float ClockSyncRoundTripGate = 2.0f;			// Exchanges with a longer round trip than this times the minimum are discarded...
+constexpr uint32_t ClockSyncRoundTripSlack = 200;		// us; ...plus this, so a very short minimum does not reject everything
+constexpr uint8_t ClockSyncMaxRejects = 4;				// Consecutive discards after which an exchange is accepted anyway
+constexpr uint32_t ClockSyncInterval = 1000;			// ms between exchanges
+
+struct ClockSyncSample
+{
+	int64_t LocalTime;									// us
+	int64_t Offset;										// us; remote - local
+	uint32_t RoundTrip;									// us
+};
+
+class ClockSyncClass
+{
+protected:
+	ClockSyncSample Samples[ClockSyncWindow];
+	uint8_t SampleHead = 0;								// Index of the next sample to be written
+	uint8_t SampleCount = 0;
+	uint8_t Rejects = 0;
+	int64_t FitLocalTime = 0;							// us; local time the fitted offset applies at
+	double FitOffset = 0.0;								// us
+	double Drift = 0.0;									// us of offset per us of local time
+
+	uint32_t GetMinRoundTrip() const;
+	void Fit();
+
+public:
+	uint32_t Exchanges = 0;
+	uint32_t Rejected = 0;
+	uint32_t LastRoundTrip = 0;							// us
+	int32_t ResidualOffset = 0;							// us; last accepted exchange's offset less the fit's prediction of it
+
+	bool AddExchange(int64_t originateTime, int64_t receiveTime, int64_t transmitTime, int64_t destinationTime);
+	bool AddSample(int64_t localTime, int64_t remoteTime, uint32_t roundTrip);
+	void Reset();
+	bool IsSynchronised() const;
+	int64_t ToShared(int64_t localTime) const;
+	int64_t GetSharedTime() const;
+	float GetDriftPPM() const;
+	String GetStatusString() const;
+
+	static int32_t Simulate(float driftPPM, uint32_t maxDelay, uint16_t exchanges);
+};
+
+#endif
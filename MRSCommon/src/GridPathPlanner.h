@@ -0,0 +1,429 @@
+/*	GridPathPlanner.h
+*	GridPathPlanner - A* path planner over the window of an OccupancyGrid, using fixed memory only
+*
+*	Occupied cells are inflated by Clearance cells (the robot's half width) into a bit-packed blocked set; unknown
+*	and uncertain cells are traversable at a small extra cost, so known free space is preferred.  The search runs
+*	8-connected from the goal back to the start with an octile heuristic, a fixed capacity binary heap of open
+*	cells (stale duplicates are skipped when popped) and a bit-packed closed set, and never cuts a blocked corner.
+*	Searching backwards leaves parent links pointing from the start towards the goal, so the path is smoothed in a
+*	single forward pass: each waypoint is the furthest path cell still in line of sight of the previous one.
+*
+*	Replanning is incremental in the sense that matters on the MCC: the grid revision is checked on each update
+*	and the current path is only replanned when a cell change actually blocks one of its remaining segments.
+*
+*	Goals outside the grid window are clamped to its edge; the planner is re-run as the window scrolls.  The open set
+*	holds PlannerHeapCapacity entries unless the second template argument says otherwise.
+*
+*	Mitchell Baldwin copyright 2025
+*
+*	v 0.00:	Initial data structure
+*	v
+*
+*/
+
+#ifndef _GridPathPlanner_h
+#define _GridPathPlanner_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+#include "OccupancyGrid.h"
+
+constexpr uint16_t PlannerStraightCost = 10;
+constexpr uint16_t PlannerDiagonalCost = 14;
+constexpr uint16_t PlannerUnknownPenalty = 4;			// Added to moves into unknown or uncertain cells
+constexpr uint16_t PlannerHeapCapacity = 2048;
+constexpr uint8_t MaxPlannerWaypoints = 16;
+constexpr uint8_t defaultPlannerClearance = 3;			// Cells; 150 mm at 50 mm cells
+
+template <uint8_t N, uint16_t HeapCapacity = PlannerHeapCapacity>
+class GridPathPlanner
+{
+	static constexpr uint16_t W = OccupancyGrid<N>::WindowCells;
+	static constexpr uint16_t Cells = W * W;
+	static constexpr uint16_t NoCost = 0xFFFF;
+
+	static_assert(Cells <= 0xFFFF, "GridPathPlanner window too large for 16 bit cell indices");
+
+public:
+	enum PlanResults : uint8_t
+	{
+		PlanOK,
+		NoPath,
+		GoalBlocked,
+		HeapFull,					// Search abandoned; open set exceeded HeapCapacity
+	};
+
+protected:
+	struct HeapEntry
+	{
+		uint16_t F;
+		uint16_t Cell;
+	};
+
+	const OccupancyGrid<N>& Grid;
+	uint32_t Blocked[Cells / 32];
+	uint32_t Penalised[Cells / 32];
+	uint32_t Closed[Cells / 32];
+	uint16_t G[Cells];									// Cost to the goal
+	uint8_t Parent[Cells];								// Direction of the next cell towards the goal
+	HeapEntry Heap[HeapCapacity];
+	uint16_t HeapSize = 0;
+
+	int32_t OriginX = 0;								// World cell of window cell (0, 0) when planned
+	int32_t OriginY = 0;
+	int16_t WaypointX[MaxPlannerWaypoints];				// Window cells
+	int16_t WaypointY[MaxPlannerWaypoints];
+	uint8_t WaypointCount = 0;
+	uint32_t PlannedRevision = 0;
+
+	static constexpr int8_t DX[8] = { 1, 0, -1, 0, 1, -1, -1, 1 };
+	static constexpr int8_t DY[8] = { 0, 1, 0, -1, 1, 1, -1, -1 };
+
+	static bool GetBit(const uint32_t* set, uint16_t i) { return set[i >> 5] & (1UL << (i & 31)); }
+	static void SetBit(uint32_t* set, uint16_t i) { set[i >> 5] |= (1UL << (i & 31)); }
+	static void ClearBit(uint32_t* set, uint16_t i) { set[i >> 5] &= ~(1UL << (i & 31)); }
+
+	bool IsBlocked(int32_t x, int32_t y) const
+	{
+		return x < 0 || y < 0 || x >= W || y >= W || GetBit(Blocked, y * W + x);
+	}
+
+	static uint16_t Heuristic(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+	{
+		uint16_t dx = abs(x1 - x0);
+		uint16_t dy = abs(y1 - y0);
+		return PlannerStraightCost * max(dx, dy) + (PlannerDiagonalCost - PlannerStraightCost) * min(dx, dy);
+	}
+
+	bool Push(uint16_t cell, uint16_t f)
+	{
+		if (HeapSize >= HeapCapacity)
+		{
+			return false;
+		}
+		uint16_t i = HeapSize++;
+		while (i > 0 && Heap[(i - 1) / 2].F > f)
+		{
+			Heap[i] = Heap[(i - 1) / 2];
+			i = (i - 1) / 2;
+		}
+		Heap[i] = { f, cell };
+		return true;
+	}
+
+	uint16_t Pop()
+	{
+		uint16_t cell = Heap[0].Cell;
+		HeapEntry last = Heap[--HeapSize];
+		uint16_t i = 0;
+		while (2 * i + 1 < HeapSize)
+		{
+			uint16_t child = 2 * i + 1;
+			if (child + 1 < HeapSize && Heap[child + 1].F < Heap[child].F)
+			{
+				child++;
+			}
+			if (Heap[child].F >= last.F)
+			{
+				break;
+			}
+			Heap[i] = Heap[child];
+			i = child;
+		}
+		Heap[i] = last;
+		return cell;
+	}
+
+	/// <summary>
+	/// Rebuilds the blocked and penalised sets from the grid window; cells within Clearance of the robot are never
+	/// blocked by inflation, so the robot can always leave the cell it is in
+	/// </summary>
+	void BuildCostMap(int32_t robotX, int32_t robotY)
+	{
+		Grid.GetWindowOrigin(OriginX, OriginY);
+		memset(Blocked, 0, sizeof(Blocked));
+		memset(Penalised, 0, sizeof(Penalised));
+
+		int16_t r = Clearance;
+		for (int16_t y = 0; y < W; y++)
+		{
+			for (int16_t x = 0; x < W; x++)
+			{
+				OccupancyStates state = Grid.GetState(OriginX + x, OriginY + y);
+				if (state == UnknownCell || state == UncertainCell)
+				{
+					SetBit(Penalised, y * W + x);
+				}
+				else if (state == OccupiedCell)
+				{
+					for (int16_t by = max(0, y - r); by <= min(W - 1, y + r); by++)
+					{
+						for (int16_t bx = max(0, x - r); bx <= min(W - 1, x + r); bx++)
+						{
+							if ((bx - x) * (bx - x) + (by - y) * (by - y) <= r * r)
+							{
+								SetBit(Blocked, by * W + bx);
+							}
+						}
+					}
+				}
+			}
+		}
+
+		int32_t rx = robotX - OriginX;
+		int32_t ry = robotY - OriginY;
+		for (int32_t y = ry - r; y <= ry + r; y++)
+		{
+			for (int32_t x = rx - r; x <= rx + r; x++)
+			{
+				if (x >= 0 && y >= 0 && x < W && y < W && Grid.GetState(OriginX + x, OriginY + y) != OccupiedCell)
+				{
+					ClearBit(Blocked, y * W + x);
+				}
+			}
+		}
+	}
+
+	/// <summary>
+	/// Returns true if no blocked cell lies on the straight line between two window cells
+	/// </summary>
+	bool InLineOfSight(int32_t x0, int32_t y0, int32_t x1, int32_t y1) const
+	{
+		int32_t dx = abs(x1 - x0);
+		int32_t dy = -abs(y1 - y0);
+		int8_t sx = (x0 < x1) ? 1 : -1;
+		int8_t sy = (y0 < y1) ? 1 : -1;
+		int32_t error = dx + dy;
+		while (true)
+		{
+			if (IsBlocked(x0, y0))
+			{
+				return false;
+			}
+			if (x0 == x1 && y0 == y1)
+			{
+				return true;
+			}
+			int32_t e2 = 2 * error;
+			if (e2 >= dy)
+			{
+				error += dy;
+				x0 += sx;
+			}
+			if (e2 <= dx)
+			{
+				error += dx;
+				y0 += sy;
+			}
+		}
+	}
+
+	/// <summary>
+	/// Follows parent links from the start to the goal, keeping only the cells where the line of sight breaks
+	/// </summary>
+	void ExtractWaypoints(int32_t sx, int32_t sy, int32_t gx, int32_t gy)
+	{
+		WaypointCount = 0;
+		int32_t anchorX = sx, anchorY = sy;
+		int32_t lastX = sx, lastY = sy;
+		int32_t x = sx, y = sy;
+		while ((x != gx || y != gy) && WaypointCount < MaxPlannerWaypoints - 1)
+		{
+			uint8_t d = Parent[y * W + x];
+			x += DX[d];
+			y += DY[d];
+			if (!InLineOfSight(anchorX, anchorY, x, y))
+			{
+				WaypointX[WaypointCount] = lastX;
+				WaypointY[WaypointCount] = lastY;
+				WaypointCount++;
+				anchorX = lastX;
+				anchorY = lastY;
+			}
+			lastX = x;
+			lastY = y;
+		}
+		WaypointX[WaypointCount] = x;
+		WaypointY[WaypointCount] = y;
+		WaypointCount++;
+	}
+
+public:
+	uint8_t Clearance = defaultPlannerClearance;
+
+	uint32_t Plans = 0;
+	uint32_t PlanFailures = 0;
+	uint32_t LastPlanTime = 0;							// us
+	uint16_t LastExpanded = 0;							// Cells expanded by the last search
+	PlanResults LastResult = NoPath;
+
+	GridPathPlanner(const OccupancyGrid<N>& grid) : Grid(grid) {}
+
+	/// <summary>
+	/// Plans a path from the robot to a goal and replaces the current waypoint list
+	/// </summary>
+	/// <param name="x">Robot position, m</param>
+	/// <param name="y">Robot position, m</param>
+	/// <param name="goalX">Goal, m; clamped to the grid window</param>
+	/// <param name="goalY">Goal, m</param>
+	PlanResults Plan(float x, float y, float goalX, float goalY)
+	{
+		uint32_t startTime = micros();
+		int32_t robotX = Grid.GetCellIndex(x);
+		int32_t robotY = Grid.GetCellIndex(y);
+		BuildCostMap(robotX, robotY);
+		PlannedRevision = Grid.Revision;
+
+		int32_t sx = constrain(robotX - OriginX, 0, W - 1);
+		int32_t sy = constrain(robotY - OriginY, 0, W - 1);
+		int32_t gx = constrain(Grid.GetCellIndex(goalX) - OriginX, 0, W - 1);
+		int32_t gy = constrain(Grid.GetCellIndex(goalY) - OriginY, 0, W - 1);
+
+		WaypointCount = 0;
+		LastExpanded = 0;
+		LastResult = NoPath;
+		if (IsBlocked(gx, gy))
+		{
+			LastResult = GoalBlocked;
+		}
+		else
+		{
+			memset(Closed, 0, sizeof(Closed));
+			memset(G, 0xFF, sizeof(G));
+			HeapSize = 0;
+
+			uint16_t start = sy * W + sx;
+			uint16_t goal = gy * W + gx;
+			G[goal] = 0;
+			Push(goal, Heuristic(gx, gy, sx, sy));
+			while (HeapSize > 0)
+			{
+				uint16_t cell = Pop();
+				if (GetBit(Closed, cell))
+				{
+					continue;								// Stale duplicate
+				}
+				SetBit(Closed, cell);
+				LastExpanded++;
+				if (cell == start)
+				{
+					LastResult = PlanOK;
+					break;
+				}
+
+				int32_t cx = cell % W;
+				int32_t cy = cell / W;
+				for (uint8_t d = 0; d < 8; d++)
+				{
+					int32_t nx = cx + DX[d];
+					int32_t ny = cy + DY[d];
+					if (IsBlocked(nx, ny) || (d >= 4 && (IsBlocked(nx, cy) || IsBlocked(cx, ny))))
+					{
+						continue;
+					}
+					uint16_t next = ny * W + nx;
+					if (GetBit(Closed, next))
+					{
+						continue;
+					}
+					uint32_t cost = G[cell] + ((d < 4) ? PlannerStraightCost : PlannerDiagonalCost)
+						+ (GetBit(Penalised, next) ? PlannerUnknownPenalty : 0);
+					if (cost < G[next] && cost < NoCost)
+					{
+						G[next] = cost;
+						Parent[next] = (d + 2) % 4 + (d & 4);	// Reverse direction, back towards the goal
+						if (!Push(next, cost + Heuristic(nx, ny, sx, sy)))
+						{
+							LastResult = HeapFull;
+							HeapSize = 0;
+							break;
+						}
+					}
+				}
+			}
+			if (LastResult == PlanOK)
+			{
+				ExtractWaypoints(sx, sy, gx, gy);
+			}
+		}
+
+		Plans++;
+		if (LastResult != PlanOK)
+		{
+			PlanFailures++;
+		}
+		LastPlanTime = micros() - startTime;
+		return LastResult;
+	}
+
+	/// <summary>
+	/// Returns true if cells have changed state since the path was planned and now block one of the segments from
+	/// the robot through the remaining waypoints
+	/// </summary>
+	/// <param name="x">Robot position, m</param>
+	/// <param name="y">Robot position, m</param>
+	/// <param name="fromWaypoint">First waypoint not yet reached</param>
+	bool IsPathBlocked(float x, float y, uint8_t fromWaypoint)
+	{
+		if (Grid.Revision == PlannedRevision || WaypointCount == 0)
+		{
+			return false;
+		}
+
+		int32_t robotX = Grid.GetCellIndex(x);
+		int32_t robotY = Grid.GetCellIndex(y);
+		int32_t originX = OriginX;
+		int32_t originY = OriginY;
+		BuildCostMap(robotX, robotY);
+		PlannedRevision = Grid.Revision;
+		if (OriginX != originX || OriginY != originY)
+		{
+			return true;									// Window has scrolled; waypoints are in the old window's cells
+		}
+
+		int32_t px = robotX - OriginX;
+		int32_t py = robotY - OriginY;
+		for (uint8_t i = fromWaypoint; i < WaypointCount; i++)
+		{
+			if (!InLineOfSight(px, py, WaypointX[i], WaypointY[i]))
+			{
+				return true;
+			}
+			px = WaypointX[i];
+			py = WaypointY[i];
+		}
+		return false;
+	}
+
+	uint8_t GetWaypointCount() const
+	{
+		return WaypointCount;
+	}
+
+	/// <summary>
+	/// Returns the centre of a waypoint cell in metres
+	/// </summary>
+	bool GetWaypoint(uint8_t i, float& x, float& y) const
+	{
+		if (i >= WaypointCount)
+		{
+			return false;
+		}
+		x = (OriginX + WaypointX[i] + 0.5f) * Grid.GetCellSize() / 1000.0f;
+		y = (OriginY + WaypointY[i] + 0.5f) * Grid.GetCellSize() / 1000.0f;
+		return true;
+	}
+
+};
+
+// DX and DY are ODR-used (indexed at run time), so they need a namespace scope definition before C++17:
+template <uint8_t N, uint16_t HeapCapacity>
+constexpr int8_t GridPathPlanner<N, HeapCapacity>::DX[8];
+template <uint8_t N, uint16_t HeapCapacity>
+constexpr int8_t GridPathPlanner<N, HeapCapacity>::DY[8];
+
+#endif
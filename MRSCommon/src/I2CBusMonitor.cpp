@@ -0,0 +1,416 @@
+/*	I2CBusMonitor.cpp
+*	I2CBusMonitor - Per device I2C clock selection and bus utilisation profiler
+*
+*/
+
+#include "I2CBusMonitor.h"
+
+bool I2CBusMonitor::Init(TwoWire* bus, const char* busName, uint32_t baseClock)
+{
+	Bus = bus;
+	BusName = busName;
+	BaseClock = baseClock;
+	BusClock = Bus->getClock();
+	SetBusClock(BaseClock);
+	WindowStartTime = millis();
+
+	return true;
+}
+
+/// <summary>
+/// Registers a device; its clock starts at the base clock until NegotiateClock() is called
+/// </summary>
+/// <returns>Device handle, or -1 if the device table is full</returns>
+int I2CBusMonitor::AddDevice(const char* name, uint8_t address, DriverTypes driver, uint32_t maxClock)
+{
+	int device = FindDevice(address);
+	if (device >= 0)
+	{
+		return device;
+	}
+	if (DeviceCount >= MaxI2CMonitoredDevices)
+	{
+		return -1;
+	}
+
+	I2CDeviceInfo& info = Devices[DeviceCount];
+	info.Name = name;
+	info.Address = address;
+	info.Driver = driver;
+	info.MaxClock = maxClock;
+	info.Clock = BaseClock;
+
+	return DeviceCount++;
+}
+
+int I2CBusMonitor::FindDevice(uint8_t address)
+{
+	for (uint8_t i = 0; i < DeviceCount; i++)
+	{
+		if (Devices[i].Address == address)
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+uint32_t I2CBusMonitor::NextSlowerClock(uint32_t clock)
+{
+	if (clock > I2CFastModeClock)
+	{
+		return I2CFastModeClock;
+	}
+	return I2CStandardModeClock;
+}
+
+void I2CBusMonitor::SetBusClock(uint32_t clock)
+{
+	if (Bus != nullptr && clock != BusClock)
+	{
+		Bus->setClock(clock);
+		BusClock = clock;
+	}
+}
+
+/// <summary>
+/// Finds the fastest clock, up to the device's maximum, at which the device reliably acknowledges its address
+/// </summary>
+/// <returns>Negotiated clock (Hz); the base clock if the device does not respond at all</returns>
+uint32_t I2CBusMonitor::NegotiateClock(int device)
+{
+	if (device < 0 || device >= DeviceCount || Bus == nullptr)
+	{
+		return BaseClock;
+	}
+
+	I2CDeviceInfo& info = Devices[device];
+	uint32_t clock = info.MaxClock;
+	while (true)
+	{
+		SetBusClock(clock);
+		bool acknowledged = true;
+		for (uint8_t i = 0; i < defaultI2CClockProbes && acknowledged; i++)
+		{
+			Bus->beginTransmission(info.Address);
+			acknowledged = (Bus->endTransmission() == 0x00);
+		}
+		if (acknowledged || clock <= I2CStandardModeClock)
+		{
+			info.Clock = acknowledged ? clock : BaseClock;
+			break;
+		}
+		clock = NextSlowerClock(clock);
+	}
+	SetBusClock(BaseClock);
+	info.ConsecutiveErrors = 0;
+
+	return info.Clock;
+}
+
+void I2CBusMonitor::NegotiateClocks()
+{
+	for (uint8_t i = 0; i < DeviceCount; i++)
+	{
+		NegotiateClock(i);
+	}
+}
+
+/// <summary>
+/// Sets the bus clock for a device's transactions; pair with Deselect()
+/// </summary>
+void I2CBusMonitor::Select(int device)
+{
+	if (device < 0 || device >= DeviceCount)
+	{
+		return;
+	}
+	SetBusClock(Devices[device].Clock);
+}
+
+void I2CBusMonitor::Deselect()
+{
+	SetBusClock(BaseClock);
+}
+
+/// <summary>
+/// Records the outcome of a device access; after defaultI2CFallbackErrors consecutive failures the device is moved
+/// to the next slower clock
+/// </summary>
+/// <param name="device">Device handle</param>
+/// <param name="bytes">Bytes on the wire, including address bytes (0 if reported separately with AddTraffic())</param>
+/// <param name="transactions">I2C transactions (START to STOP)</param>
+/// <param name="busyTime">us</param>
+/// <param name="success">False on a NACK or timeout</param>
+void I2CBusMonitor::Record(int device, uint16_t bytes, uint8_t transactions, uint32_t busyTime, bool success)
+{
+	if (device < 0 || device >= DeviceCount)
+	{
+		return;
+	}
+
+	I2CDeviceInfo& info = Devices[device];
+	info.Bytes += bytes;
+	info.Transactions += transactions;
+	info.BusyTime += busyTime;
+
+	if (success)
+	{
+		info.ConsecutiveErrors = 0;
+		return;
+	}
+
+	info.Errors++;
+	if (++info.ConsecutiveErrors >= defaultI2CFallbackErrors && info.Clock > I2CStandardModeClock)
+	{
+		info.Clock = NextSlowerClock(info.Clock);
+		info.Fallbacks++;
+		info.ConsecutiveErrors = 0;
+	}
+}
+
+void I2CBusMonitor::AddTraffic(int device, uint16_t bytes, uint8_t transactions)
+{
+	if (device < 0 || device >= DeviceCount)
+	{
+		return;
+	}
+	Devices[device].Bytes += bytes;
+	Devices[device].Transactions += transactions;
+}
+
+/// <summary>
+/// Closes the current measurement window once it is I2CMonitorWindow long; call regularly (e.g. from a 100 ms task)
+/// </summary>
+void I2CBusMonitor::Update()
+{
+	uint32_t now = millis();
+	uint32_t windowLength = now - WindowStartTime;
+	if (windowLength < I2CMonitorWindow)
+	{
+		return;
+	}
+
+	uint32_t totalBusyTime = 0;
+	for (uint8_t i = 0; i < DeviceCount; i++)
+	{
+		I2CDeviceInfo& info = Devices[i];
+		info.BytesPerSecond = info.Bytes * 1000 / windowLength;
+		info.TransactionsPerSecond = info.Transactions * 1000 / windowLength;
+		info.BusyTimePerSecond = info.BusyTime * 1000 / windowLength;
+		totalBusyTime += info.BusyTime;
+		info.Bytes = 0;
+		info.Transactions = 0;
+		info.BusyTime = 0;
+	}
+	Utilisation = constrain(totalBusyTime / (windowLength * 10), 0, 100);
+	WindowStartTime = now;
+}
+
+bool I2CBusMonitor::ProbeAddress(uint8_t address)
+{
+	Bus->beginTransmission(address);
+	return (Bus->endTransmission() == 0x00);
+}
+
+/// <summary>
+/// Probes the registered addresses only, at the base clock; call once at boot after registering the devices
+/// </summary>
+/// <returns>Number of registered devices that responded</returns>
+uint8_t I2CBusMonitor::ProbeDevices()
+{
+	uint8_t presentCount = 0;
+	uint32_t startTime = micros();
+
+	if (Bus == nullptr)
+	{
+		return 0;
+	}
+
+	SetBusClock(BaseClock);
+	uint32_t now = millis();
+	for (uint8_t i = 0; i < DeviceCount; i++)
+	{
+		I2CDeviceInfo& info = Devices[i];
+		info.Present = ProbeAddress(info.Address);
+		info.MissedProbes = 0;
+		if (info.Present)
+		{
+			info.Appearances++;
+			info.LastSeenTime = now;
+			presentCount++;
+		}
+	}
+	BootProbeTime = micros() - startTime;
+
+	return presentCount;
+}
+
+void I2CBusMonitor::UpdatePresence(int device, bool responding)
+{
+	I2CDeviceInfo& info = Devices[device];
+
+	if (responding)
+	{
+		info.MissedProbes = 0;
+		info.LastSeenTime = millis();
+		if (!info.Present)
+		{
+			info.Present = true;
+			info.Appearances++;
+			TopologyChanges++;
+			NegotiateClock(device);
+		}
+	}
+	else if (info.Present && ++info.MissedProbes >= defaultI2CMissingProbes)
+	{
+		info.Present = false;
+		info.Disappearances++;
+		TopologyChanges++;
+	}
+}
+
+/// <summary>
+/// Probes the next defaultI2CScanAddressesPerPoll unregistered addresses of a background scan
+/// </summary>
+void I2CBusMonitor::ScanStep()
+{
+	for (uint8_t i = 0; i < defaultI2CScanAddressesPerPoll && NextScanAddress != 0; i++)
+	{
+		uint8_t address = NextScanAddress;
+		NextScanAddress = (address < I2CLastScanAddress) ? address + 1 : 0;
+
+		if (FindDevice(address) >= 0 || !ProbeAddress(address))
+		{
+			continue;
+		}
+		int device = AddDevice("?", address, UnknownDriver, I2CStandardModeClock);
+		if (device >= 0)
+		{
+			Devices[device].Expected = false;
+			UpdatePresence(device, true);
+		}
+	}
+	if (NextScanAddress == 0)
+	{
+		LastScanTime = millis() - ScanStartTime;
+	}
+}
+
+/// <summary>
+/// Probes one registered device for presence and advances any background scan; call regularly from the main loop
+/// while the bus is idle (e.g. from the task that runs the bus jobs).  Does nothing until
+/// defaultI2CPresencePollInterval has passed since the last call that probed.
+/// </summary>
+void I2CBusMonitor::Poll()
+{
+	uint32_t now = millis();
+	if (Bus == nullptr || now - LastPollTime < defaultI2CPresencePollInterval)
+	{
+		return;
+	}
+	LastPollTime = now;
+
+	SetBusClock(BaseClock);
+	if (DeviceCount > 0)
+	{
+		if (NextPollDevice >= DeviceCount)
+		{
+			NextPollDevice = 0;
+		}
+		uint8_t device = NextPollDevice++;
+		UpdatePresence(device, ProbeAddress(Devices[device].Address));
+	}
+	if (NextScanAddress != 0)
+	{
+		ScanStep();
+	}
+}
+
+/// <summary>
+/// Starts a single pass over the whole address range, performed a few addresses at a time by Poll()
+/// </summary>
+void I2CBusMonitor::StartBackgroundScan()
+{
+	if (NextScanAddress == 0)
+	{
+		NextScanAddress = I2CFirstScanAddress;
+		ScanStartTime = millis();
+	}
+}
+
+bool I2CBusMonitor::IsScanning()
+{
+	return NextScanAddress != 0;
+}
+
+bool I2CBusMonitor::IsPresent(int device)
+{
+	if (device < 0 || device >= DeviceCount)
+	{
+		return false;
+	}
+	return Devices[device].Present;
+}
+
+uint8_t I2CBusMonitor::GetDeviceCount()
+{
+	return DeviceCount;
+}
+
+const I2CBusMonitor::I2CDeviceInfo* I2CBusMonitor::GetDevice(int device)
+{
+	if (device < 0 || device >= DeviceCount)
+	{
+		return nullptr;
+	}
+	return &Devices[device];
+}
+
+const char* I2CBusMonitor::GetBusName()
+{
+	return BusName;
+}
+
+String I2CBusMonitor::GetPresentAddressesString(uint8_t maxCount)
+{
+	char buf[8];
+	String addresses = "I2C";
+
+	for (uint8_t i = 0; i < DeviceCount && maxCount > 0; i++)
+	{
+		if (Devices[i].Present)
+		{
+			snprintf(buf, sizeof(buf), " %02X", Devices[i].Address);
+			addresses += buf;
+			maxCount--;
+		}
+	}
+
+	return addresses;
+}
+
+/// <summary>
+/// Builds a per device table of the last window's figures for printing to Serial; missing devices are marked '-'
+/// and devices found by a background scan '?'
+/// </summary>
+String I2CBusMonitor::GetReport()
+{
+	char buf[96];
+
+	snprintf(buf, sizeof(buf), "%s I2C %3u%% busy, boot probe %luus, scan %lums, %lu changes\n", BusName, Utilisation,
+		(unsigned long)BootProbeTime, (unsigned long)LastScanTime, (unsigned long)TopologyChanges);
+	String report = buf;
+	for (uint8_t i = 0; i < DeviceCount; i++)
+	{
+		I2CDeviceInfo& info = Devices[i];
+		snprintf(buf, sizeof(buf), "%c%-6s 0x%02X %4lukHz %6luB/s %4luT/s %6luus/s F%lu E%lu +%lu -%lu\n",
+			info.Present ? (info.Expected ? ' ' : '?') : '-', info.Name, info.Address, (unsigned long)(info.Clock / 1000),
+			(unsigned long)info.BytesPerSecond, (unsigned long)info.TransactionsPerSecond, (unsigned long)info.BusyTimePerSecond,
+			(unsigned long)info.Fallbacks, (unsigned long)info.Errors, (unsigned long)info.Appearances,
+			(unsigned long)info.Disappearances);
+		report += buf;
+	}
+
+	return report;
+}
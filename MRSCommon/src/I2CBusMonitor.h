@@ -0,0 +1,153 @@
+/*	I2CBusMonitor.h
+*	I2CBusMonitor - Per device I2C clock selection and bus utilisation profiler
+*
+*	Each device on a bus is registered with the fastest clock it supports (100 kHz, 400 kHz or 1 MHz).
+*	NegotiateClock() probes the device from that clock downwards at start up, and Record() steps the device down
+*	to the next slower clock after repeated failed transactions.  Select() sets the bus clock for a device before
+*	its transactions and Deselect() restores the base clock so code that does not use the monitor (e.g. device
+*	drivers polled from other tasks) always finds the bus at a clock every device supports.
+*
+*	Record() also accumulates bytes, transactions and busy time per device; Update() closes each one second
+*	window so the per second figures can be displayed or printed.
+*
+*	The device table doubles as the bus registry: devices are registered by expected address and driver type, and
+*	ProbeDevices() checks only those addresses at boot instead of scanning the whole address range.  Poll() is
+*	called regularly from the main loop; each call probes one registered device, so a device that stops
+*	responding (e.g. a loose sensor cable) is marked missing and one that comes back is marked present again and
+*	has its clock renegotiated, without ever blocking for a full scan.  StartBackgroundScan() optionally sweeps
+*	the rest of the address range a few addresses per Poll() call and registers anything it finds as an unknown
+*	device.
+*
+*	Mitchell Baldwin copyright 2025
+*
+*	v 0.00:	Initial data structure
+*	v
+*
+*/
+
+#ifndef _I2CBusMonitor_h
+#define _I2CBusMonitor_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+#include <Wire.h>
+
+constexpr uint32_t I2CStandardModeClock = 100000;		// Hz
+constexpr uint32_t I2CFastModeClock = 400000;			// Hz
+constexpr uint32_t I2CFastModePlusClock = 1000000;		// Hz
+
+constexpr uint8_t MaxI2CMonitoredDevices = 12;
+constexpr uint8_t defaultI2CFallbackErrors = 3;			// Consecutive failed transactions before a device is slowed down
+constexpr uint8_t defaultI2CClockProbes = 3;			// Address probes that must all succeed to accept a clock
+constexpr uint32_t I2CMonitorWindow = 1000;				// ms
+constexpr uint32_t defaultI2CPresencePollInterval = 100;	// ms between presence probes (one device per probe)
+constexpr uint8_t defaultI2CMissingProbes = 2;			// Consecutive failed presence probes before a device is marked missing
+constexpr uint8_t defaultI2CScanAddressesPerPoll = 8;	// Addresses probed by each Poll() call during a background scan
+constexpr uint8_t I2CFirstScanAddress = 0x08;			// Addresses below 0x08 and above 0x77 are reserved
+constexpr uint8_t I2CLastScanAddress = 0x77;
+
+class I2CBusMonitor
+{
+public:
+	enum DriverTypes : uint8_t
+	{
+		UnknownDriver = 0,								// Found by a background scan
+		INA219Driver,
+		BME680Driver,
+		VL53L1XDriver,
+		OTOSDriver,
+		PCF8563Driver,
+		SSD1306Driver,
+		SeesawDriver,
+		MRSSENDriver,
+
+		DriverTypeCount
+	};
+
+	struct I2CDeviceInfo
+	{
+		const char* Name = nullptr;
+		uint8_t Address = 0;
+		DriverTypes Driver = UnknownDriver;
+		bool Expected = true;							// Registered by the application rather than found by a scan
+		bool Present = false;
+		uint8_t MissedProbes = 0;						// Consecutive failed presence probes
+		uint32_t Appearances = 0;						// Times the device was found after being absent (including at boot)
+		uint32_t Disappearances = 0;
+		uint32_t LastSeenTime = 0;						// ms
+		uint32_t MaxClock = I2CStandardModeClock;		// Hz; fastest clock the device supports
+		uint32_t Clock = I2CStandardModeClock;			// Hz; clock currently used
+		uint8_t ConsecutiveErrors = 0;
+		uint32_t Fallbacks = 0;							// Times the clock was stepped down
+		uint32_t Errors = 0;
+
+		// Accumulators for the current window:
+		uint32_t Bytes = 0;
+		uint32_t Transactions = 0;
+		uint32_t BusyTime = 0;							// us
+
+		// Last complete window:
+		uint32_t BytesPerSecond = 0;
+		uint32_t TransactionsPerSecond = 0;
+		uint32_t BusyTimePerSecond = 0;					// us
+	};
+
+protected:
+	TwoWire* Bus = nullptr;
+	const char* BusName = "";
+	uint32_t BaseClock = I2CStandardModeClock;
+	uint32_t BusClock = I2CStandardModeClock;			// Clock currently set on the bus
+
+	I2CDeviceInfo Devices[MaxI2CMonitoredDevices];
+	uint8_t DeviceCount = 0;
+
+	uint32_t WindowStartTime = 0;						// ms
+
+	uint32_t LastPollTime = 0;							// ms
+	uint8_t NextPollDevice = 0;
+	uint8_t NextScanAddress = 0;						// 0 when no background scan is in progress
+	uint32_t ScanStartTime = 0;							// ms
+
+	void SetBusClock(uint32_t clock);
+	static uint32_t NextSlowerClock(uint32_t clock);
+	bool ProbeAddress(uint8_t address);
+	void UpdatePresence(int device, bool responding);
+	void ScanStep();
+
+public:
+	uint8_t Utilisation = 0;							// %; total busy time of all devices over the last window
+	uint32_t BootProbeTime = 0;							// us taken by ProbeDevices()
+	uint32_t LastScanTime = 0;							// ms taken by the last complete background scan
+	uint32_t TopologyChanges = 0;						// Devices appearing or disappearing after boot
+
+	bool Init(TwoWire* bus, const char* busName, uint32_t baseClock = I2CStandardModeClock);
+	int AddDevice(const char* name, uint8_t address, DriverTypes driver, uint32_t maxClock = I2CStandardModeClock);
+	int FindDevice(uint8_t address);
+	uint32_t NegotiateClock(int device);
+	void NegotiateClocks();
+
+	uint8_t ProbeDevices();
+	void Poll();
+	void StartBackgroundScan();
+	bool IsScanning();
+	bool IsPresent(int device);
+
+	void Select(int device);
+	void Deselect();
+	void Record(int device, uint16_t bytes, uint8_t transactions, uint32_t busyTime, bool success);
+	void AddTraffic(int device, uint16_t bytes, uint8_t transactions);
+	void Update();
+
+	uint8_t GetDeviceCount();
+	const I2CDeviceInfo* GetDevice(int device);
+	const char* GetBusName();
+	String GetPresentAddressesString(uint8_t maxCount = 6);
+	String GetReport();
+
+};
+
+#endif
@@ -0,0 +1,194 @@
+/*	LinkMonitor.cpp
+*	LinkMonitorClass - Reception, loss, jitter, send failure and RSSI statistics of one end of the CSSM - MCC ESP-NOW link
+*
+*	Mitchell Baldwin copyright 2026
+*
+*/
+
+#include "LinkMonitor.h"
+
+LinkMonitorClass::LinkMonitorClass()
+{
+	Reset();
+}
+
+/// <param name="nominalInterval">ms; period of the other end's sequenced packet stream</param>
+void LinkMonitorClass::Init(float nominalInterval)
+{
+	NominalInterval = (nominalInterval > 0.0f) ? nominalInterval : 100.0f;
+	Reset();
+}
+
+void LinkMonitorClass::Reset()
+{
+	SequenceStarted = false;
+	Received = 0;
+	Lost = 0;
+	Late = 0;
+	Restarts = 0;
+	SendAttempts = 0;
+	SendFailures = 0;
+	memset(Histogram, 0, sizeof(Histogram));
+	MeanInterval = NominalInterval;
+	Jitter = 0.0f;
+	RSSIValid = false;
+	LossRate = 0.0f;
+	FailRate = 0.0f;
+	Score = 0;
+	WindowStartTime = millis();
+	WindowReceived = 0;
+	WindowLost = 0;
+	WindowSendAttempts = 0;
+	WindowSendFailures = 0;
+}
+
+uint8_t LinkMonitorClass::GetIntervalBin(float interval) const
+{
+	float percent = interval * 100.0f / NominalInterval;
+	uint8_t bin = 0;
+	while (bin < LinkIntervalBins - 1 && percent >= LinkIntervalBinEdges[bin])
+	{
+		bin++;
+	}
+	return bin;
+}
+
+/// <summary>
+/// Records a sequenced packet from the other end; call from the ESP-NOW receive callback
+/// </summary>
+/// <param name="receiveTime">us, e.g. esp_timer_get_time()</param>
+void LinkMonitorClass::RecordReceived(uint16_t sequence, uint32_t receiveTime)
+{
+	if (!SequenceStarted)
+	{
+		SequenceStarted = true;
+		ExpectedSequence = sequence + 1;
+		LastReceiveTime = receiveTime;
+		Received++;
+		return;
+	}
+
+	uint16_t ahead = sequence - ExpectedSequence;
+	uint16_t behind = ExpectedSequence - sequence;
+	if (behind != 0 && behind <= LinkMaxReorder)
+	{
+		Late++;
+		return;
+	}
+	Received++;
+	ExpectedSequence = sequence + 1;
+	if (ahead > LinkMaxSequenceGap)
+	{
+		Restarts++;
+		LastReceiveTime = receiveTime;
+		return;
+	}
+	Lost += ahead;
+
+	float interval = (receiveTime - LastReceiveTime) / 1000.0f;
+	LastReceiveTime = receiveTime;
+	Histogram[GetIntervalBin(interval)]++;
+	MeanInterval += LinkIntervalSmoothing * (interval - MeanInterval);
+	if (ahead == 0)
+	{
+		Jitter += LinkIntervalSmoothing * (fabsf(interval - NominalInterval) - Jitter);
+	}
+}
+
+/// <summary>
+/// Records the result of a send; call from the ESP-NOW send callback
+/// </summary>
+void LinkMonitorClass::RecordSend(bool success)
+{
+	SendAttempts++;
+	if (!success)
+	{
+		SendFailures++;
+	}
+}
+
+/// <summary>
+/// Records the signal strength of a frame from the other end; call from the promiscuous receive callback
+/// </summary>
+void LinkMonitorClass::RecordRSSI(int8_t rssi)
+{
+	if (!RSSIValid)
+	{
+		RSSI = rssi;
+		RSSIValid = true;
+	}
+	else
+	{
+		RSSI += LinkRSSISmoothing * (rssi - RSSI);
+	}
+}
+
+/// <summary>
+/// Updates the rolling rates and the link quality score at the end of each LinkStatsWindow
+/// </summary>
+/// <param name="now">ms</param>
+void LinkMonitorClass::Update(uint32_t now)
+{
+	if (now - WindowStartTime < LinkStatsWindow)
+	{
+		return;
+	}
+	WindowStartTime = now;
+
+	uint32_t received = Received - WindowReceived;
+	uint32_t lost = Lost - WindowLost;
+	uint32_t attempts = SendAttempts - WindowSendAttempts;
+	uint32_t failures = SendFailures - WindowSendFailures;
+	WindowReceived += received;
+	WindowLost += lost;
+	WindowSendAttempts += attempts;
+	WindowSendFailures += failures;
+
+	float loss = (received == 0) ? 1.0f : (float)lost / (received + lost);
+	float fail = (attempts == 0) ? 0.0f : (float)failures / attempts;
+	LossRate += LinkStatsSmoothing * (loss - LossRate);
+	FailRate += LinkStatsSmoothing * (fail - FailRate);
+
+	float signal = RSSIValid ? constrain((RSSI - LinkRSSIFloor) / (LinkRSSIGood - LinkRSSIFloor), 0.0f, 1.0f) : 1.0f;
+	float timing = 1.0f - 0.5f * min(Jitter / NominalInterval, 1.0f);
+	float score = 100.0f * (1.0f - LossRate) * (1.0f - FailRate) * (0.5f + 0.5f * signal) * timing;
+	Score = (uint8_t)constrain(lroundf(score), 0L, 100L);
+}
+
+void LinkMonitorClass::GetStats(LinkStatsPacket& packet) const
+{
+	packet.Score = Score;
+	packet.RSSI = RSSIValid ? (int8_t)lroundf(RSSI) : 0;
+	packet.Received = Received;
+	packet.Lost = Lost;
+	packet.Late = Late;
+	packet.SendAttempts = SendAttempts;
+	packet.SendFailures = SendFailures;
+	memcpy(packet.Histogram, Histogram, sizeof(packet.Histogram));
+	packet.LossRate = LossRate;
+	packet.FailRate = FailRate;
+	packet.MeanInterval = MeanInterval;
+	packet.Jitter = Jitter;
+}
+
+/// <summary>
+/// Formats a histogram (this monitor's, or one received from the other end) as the percentage in each bin
+/// </summary>
+/// <returns>e.g. "H  0  0  3 94  2  0  1  0"; 25 characters</returns>
+String LinkMonitorClass::GetHistogramString(const uint32_t* histogram) const
+{
+	char buf[32];
+	uint32_t total = 0;
+	for (uint8_t i = 0; i < LinkIntervalBins; i++)
+	{
+		total += histogram[i];
+	}
+
+	int length = snprintf(buf, sizeof(buf), "H");
+	for (uint8_t i = 0; i < LinkIntervalBins; i++)
+	{
+		uint32_t percent = (total == 0) ? 0 : min((uint32_t)(histogram[i] * 100ULL / total), (uint32_t)99);
+		length += snprintf(buf + length, sizeof(buf) - length, "%3lu", (unsigned long)percent);
+	}
+	return String(buf);
+}
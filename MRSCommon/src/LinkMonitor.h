@@ -0,0 +1,101 @@
+/*	LinkMonitor.h
+*	LinkMonitorClass - Reception, loss, jitter, send failure and RSSI statistics of one end of the CSSM - MCC ESP-NOW link
+*
+*	Each end numbers the packets of its periodic stream (CSSMDrivePacket from the CSSM, RC2x15AMCStatusPacket from the
+*	MCC) with a LinkSequence, and the receiving end passes each one to RecordReceived() from its ESP-NOW receive
+*	callback:
+*	- sequence numbers skipped are counted as lost; a number just behind the expected one is counted as late (a
+*	  duplicate or out of order packet) and not otherwise used; a jump of more than LinkMaxSequenceGap (the other end
+*	  restarted, or a long outage) restarts the count without counting loss;
+*	- the time since the previous packet is binned in a histogram against the stream's nominal interval, with bin edges
+*	  at LinkIntervalBinEdges percent of it, so early, on time, late and missing packets each show in their own bins;
+*	- the jitter is the rolling mean deviation from nominal of the intervals between consecutive packets (intervals
+*	  spanning a lost packet are left out of it).
+*	RecordSend() counts the result of every send callback, whatever the packet type, and RecordRSSI() takes the signal
+*	strength of frames from the other end, caught in promiscuous mode (the ESP-NOW receive callback does not get it).
+*
+*	Update() is called regularly from a task; every LinkStatsWindow it works out the loss and send failure rates of the
+*	window just ended, smooths them and recomputes the link quality score:
+*		Score = 100 * (1 - LossRate) * (1 - FailRate) * (0.5 + 0.5 * signal) * (1 - 0.5 * min(Jitter / nominal, 1))
+*	where signal goes from 0 at LinkRSSIFloor to 1 at LinkRSSIGood (1 if RSSI has not been measured).  A window with
+*	nothing received counts as total loss.
+*
+*	The Record...() functions run in the WiFi task; counts are only ever written there and read elsewhere, so a reading
+*	may be one packet out of date but is never torn.
+*
+*	Mitchell Baldwin copyright 2026
+*
+*	v 0.00:	Initial data structure
+*	v
+*
+*/
+
+#ifndef _LinkMonitor_h
+#define _LinkMonitor_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+#include "LinkStatsPacket.h"
+
+constexpr uint16_t LinkIntervalBinEdges[LinkIntervalBins - 1] = { 50, 80, 95, 105, 120, 150, 250 };	// % of nominal
+constexpr uint32_t LinkStatsWindow = 1000;				// ms
+constexpr float LinkStatsSmoothing = 0.25f;				// Weight of the latest window in the rolling rates
+constexpr float LinkIntervalSmoothing = 0.0625f;		// Weight of the latest packet in the mean interval and jitter
+constexpr float LinkRSSISmoothing = 0.125f;
+constexpr uint16_t LinkMaxSequenceGap = 1000;			// Larger jumps restart the sequence count
+constexpr uint16_t LinkMaxReorder = 16;					// Sequence numbers up to this far behind count as late
+constexpr float LinkRSSIFloor = -90.0f;					// dBm
+constexpr float LinkRSSIGood = -60.0f;					// dBm
+
+class LinkMonitorClass
+{
+protected:
+	float NominalInterval = 100.0f;						// ms
+	bool SequenceStarted = false;
+	uint16_t ExpectedSequence = 0;
+	uint32_t LastReceiveTime = 0;						// us
+
+	uint32_t WindowStartTime = 0;						// ms
+	uint32_t WindowReceived = 0;						// Counts at the start of the window
+	uint32_t WindowLost = 0;
+	uint32_t WindowSendAttempts = 0;
+	uint32_t WindowSendFailures = 0;
+
+	uint8_t GetIntervalBin(float interval) const;
+
+public:
+	uint32_t Received = 0;
+	uint32_t Lost = 0;
+	uint32_t Late = 0;
+	uint32_t Restarts = 0;
+	uint32_t SendAttempts = 0;
+	uint32_t SendFailures = 0;
+	uint32_t Histogram[LinkIntervalBins];
+	float MeanInterval = 0.0f;							// ms
+	float Jitter = 0.0f;								// ms
+	float RSSI = 0.0f;									// dBm
+	bool RSSIValid = false;
+	float LossRate = 0.0f;								// 0 - 1
+	float FailRate = 0.0f;								// 0 - 1
+	uint8_t Score = 0;									// 0 - 100
+
+	LinkMonitorClass();
+	void Init(float nominalInterval);
+	void Reset();
+
+	void RecordReceived(uint16_t sequence, uint32_t receiveTime);
+	void RecordSend(bool success);
+	void RecordRSSI(int8_t rssi);
+	void Update(uint32_t now);
+
+	float GetNominalInterval() const { return NominalInterval; }
+	void GetStats(LinkStatsPacket& packet) const;
+	String GetHistogramString(const uint32_t* histogram) const;
+	String GetHistogramString() const { return GetHistogramString(Histogram); }
+};
+
+#endif
@@ -0,0 +1,47 @@
+/* LinkStatsPacket.h
+* LinkStatsPacket class - ESP-NOW link statistics (see LinkMonitor.h) that the CSSM and the MRS MCC send each other, so
+* that each end can show how the other end sees the link
+*
+* Counts are totals since the sender's monitor was reset; rates, interval, jitter, RSSI and score are the sender's
+* rolling values.
+*
+* Mitchell Baldwin copyright 2026
+*
+*	v 0.0:	Initial commit
+*	v 0.1:
+*
+*/
+
+#ifndef _LinkStatsPacket_h
+#define _LinkStatsPacket_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+constexpr uint8_t LinkIntervalBins = 8;					// Inter-arrival histogram bins
+
+class LinkStatsPacket
+{
+protected:
+	uint8_t PacketType = 0x36;		// Identifies packet type; fixed for all LinkStatsPackets
+
+public:
+	uint8_t Score = 0;				// 0 - 100; rolling link quality
+	int8_t RSSI = 0;				// dBm; 0 if not measured
+	uint32_t Received = 0;			// Sequenced packets received from the other end
+	uint32_t Lost = 0;				// Sequence numbers skipped
+	uint32_t Late = 0;				// Duplicate or out of order sequence numbers
+	uint32_t SendAttempts = 0;		// Send callbacks, all packet types
+	uint32_t SendFailures = 0;		// Send callbacks reporting failure
+	uint32_t Histogram[LinkIntervalBins] = { 0 };	// Inter-arrival times, binned against the nominal interval
+	float LossRate = 0.0f;			// 0 - 1; rolling
+	float FailRate = 0.0f;			// 0 - 1; rolling
+	float MeanInterval = 0.0f;		// ms; rolling
+	float Jitter = 0.0f;			// ms; rolling mean deviation of consecutive packets' interval from nominal
+
+};
+
+#endif
@@ -0,0 +1,94 @@
+/*	MRSSENRegisterMap.cpp
+*	MRSSENRegisterMap - Register map exposed by the MRS Sensors module (MRS SEN) as an I2C slave on the MCC bus
+*
+*/
+
+#include "MRSSENRegisterMap.h"
+
+uint8_t MRSSENRegisterMap::GetRegisterIndex(uint8_t address)
+{
+	return (address - MRSSEN_DataStartAddress) / MRSSEN_RegisterSize;
+}
+
+uint8_t MRSSENRegisterMap::GetRegisterAddress(uint8_t index)
+{
+	return MRSSEN_DataStartAddress + index * MRSSEN_RegisterSize;
+}
+
+/// <summary>
+/// Maps a data register index to the corresponding MRSSensorPacket field
+/// </summary>
+/// <param name="packet">Packet holding the field</param>
+/// <param name="index">Data register index (0 to MRSSEN_DataRegisterCount - 1)</param>
+/// <returns>Pointer to the 4 byte field, or nullptr if the index is out of range</returns>
+void* MRSSENRegisterMap::GetField(MRSSensorPacket& packet, uint8_t index)
+{
+	switch (GetRegisterAddress(index))
+	{
+	case MRSSEN_ODOSPosXAddress:
+		return &packet.ODOSPosX;
+	case MRSSEN_ODOSPosYAddress:
+		return &packet.ODOSPosY;
+	case MRSSEN_ODOSHdgAddress:
+		return &packet.ODOSHdg;
+	case MRSSEN_FWDLIDARRangeAddress:
+		return &packet.FWDVL53L1XRange;
+	case MRSSEN_TurretPositionAddress:
+		return &packet.TurretPosition;
+	case MRSSEN_RINA219VShuntAddress:
+		return &packet.RINA219VShunt;
+	case MRSSEN_RINA219VBusAddress:
+		return &packet.RINA219VBus;
+	case MRSSEN_RINA219CurrentAddress:
+		return &packet.RINA219Current;
+	case MRSSEN_RINA219PowerAddress:
+		return &packet.RINA219Power;
+	case MRSSEN_RINA219SOCAddress:
+		return &packet.RINA219SOC;
+	case MRSSEN_RINA219RuntimeAddress:
+		return &packet.RINA219Runtime;
+	case MRSSEN_ODOSVelXAddress:
+		return &packet.ODOSVelX;
+	case MRSSEN_ODOSVelYAddress:
+		return &packet.ODOSVelY;
+	case MRSSEN_ODOSVelHdgAddress:
+		return &packet.ODOSVelHdg;
+	case MRSSEN_TimestampLowAddress:
+		return &packet.Timestamp;
+	case MRSSEN_TimestampHighAddress:
+		return (uint8_t*)&packet.Timestamp + MRSSEN_RegisterSize;
+	case MRSSEN_TurretConfidenceAddress:
+		return &packet.TurretConfidence;
+	default:
+		return nullptr;
+	}
+}
+
+/// <summary>
+/// Packs all data registers from a sensor packet into a register image
+/// </summary>
+/// <param name="packet">Source packet</param>
+/// <param name="image">Destination; MRSSEN_DataEndAddress bytes, indexed by register address</param>
+void MRSSENRegisterMap::Encode(MRSSensorPacket& packet, uint8_t* image)
+{
+	image[MRSSEN_VersionAddress] = MRSSEN_RegisterMapVersion;
+	for (uint8_t i = 0; i < MRSSEN_DataRegisterCount; i++)
+	{
+		memcpy(&image[GetRegisterAddress(i)], GetField(packet, i), MRSSEN_RegisterSize);
+	}
+}
+
+/// <summary>
+/// Unpacks one data register into the corresponding sensor packet field
+/// </summary>
+/// <param name="index">Data register index</param>
+/// <param name="data">MRSSEN_RegisterSize bytes read from the register</param>
+/// <param name="packet">Destination packet</param>
+void MRSSENRegisterMap::Decode(uint8_t index, const uint8_t* data, MRSSensorPacket& packet)
+{
+	void* field = GetField(packet, index);
+	if (field != nullptr)
+	{
+		memcpy(field, data, MRSSEN_RegisterSize);
+	}
+}
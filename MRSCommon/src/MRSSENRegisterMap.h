@@ -0,0 +1,144 @@
+/*	MRSSENRegisterMap.h
+*	MRSSENRegisterMap - Register map exposed by the MRS Sensors module (MRS SEN) as an I2C slave on the MCC bus
+*
+*	Data registers are 4 bytes wide (float or int32) and laid out back to back from MRSSEN_DataStartAddress so
+*	that any run of adjacent registers can be fetched with a single burst read.  The master selects a register
+*	by writing [address, length] and then reads exactly length bytes.  Bit n of the dirty mask register is set
+*	when data register n has changed; the bits stay set until the master acknowledges them by writing
+*	[MRSSEN_DirtyMaskAddress, mask] back, so a mask lost in a failed read is served again.  The master acknowledges
+*	before fetching the registers, so a change made after the acknowledge sets its bit again.  Reading 8 bytes
+*	from the dirty mask address returns the mask followed by the sequence number of the snapshot being served;
+*	reading 12 bytes also returns the command acknowledge register.  Each read is served from one snapshot, but
+*	successive reads may come from different ones: setting MRSSEN_SequenceTrailer in the selected length of a data
+*	register read appends the sequence number of the snapshot that read was served from, so the master can check
+*	that all the runs it fetched belong together.
+*
+*	The last completed polar range scan is served as PolarScanChunkPackets, one per address from
+*	MRSSEN_ScanChunkAddress; dirty mask bit MRSSEN_ScanAvailableBit is set each time a new scan is completed and
+*	chunk 0 gives the number of chunks to read.
+*
+*	The sensor packet's 64 bit Timestamp is served as two data registers, low word first.  Selecting the clock
+*	register and reading it returns the MRS SEN module's clock time, stamped as the read is served; the MCC stamps
+*	either side of the read and then writes an MRSSENClockExchange to the same address, giving the MRS SEN module one
+*	ClockSync exchange (see ClockSync.h).
+*
+*	Mitchell Baldwin copyright 2025
+*
+*	v 0.00:	Initial data structure
+*	v
+*
+*/
+
+#ifndef _MRSSENRegisterMap_h
+#define _MRSSENRegisterMap_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+#include "MRSSensorPacket.h"
+#include "PolarScanChunkPacket.h"
+
+constexpr uint8_t MRSSEN_RegisterMapVersion = 8;
+
+constexpr uint8_t MRSSEN_RegisterSize = 4;					// Bytes per data register
+constexpr uint8_t MRSSEN_DataStartAddress = 0x01;			// Address of the first data register
+
+// Data registers:
+constexpr uint8_t MRSSEN_ODOSPosXAddress = 0x01;			// SF ODOS X position address
+constexpr uint8_t MRSSEN_ODOSPosYAddress = 0x05;			// SF ODOS Y position address
+constexpr uint8_t MRSSEN_ODOSHdgAddress = 0x09;				// SF ODOS heading address
+constexpr uint8_t MRSSEN_FWDLIDARRangeAddress = 0x0D;		// FWDLIDAR range address
+constexpr uint8_t MRSSEN_TurretPositionAddress = 0x11;		// Sensor turret position address
+constexpr uint8_t MRSSEN_RINA219VShuntAddress = 0x15;		// Right UPS 3S shunt voltage address
+constexpr uint8_t MRSSEN_RINA219VBusAddress = 0x19;			// Right UPS 3S bus voltage address
+constexpr uint8_t MRSSEN_RINA219CurrentAddress = 0x1D;		// Right UPS 3S current address
+constexpr uint8_t MRSSEN_RINA219PowerAddress = 0x21;		// Right UPS 3S power address
+constexpr uint8_t MRSSEN_RINA219SOCAddress = 0x25;			// Right UPS 3S state of charge address
+constexpr uint8_t MRSSEN_RINA219RuntimeAddress = 0x29;		// Right UPS 3S estimated runtime address
+constexpr uint8_t MRSSEN_ODOSVelXAddress = 0x2D;			// SF ODOS X velocity address
+constexpr uint8_t MRSSEN_ODOSVelYAddress = 0x31;			// SF ODOS Y velocity address
+constexpr uint8_t MRSSEN_ODOSVelHdgAddress = 0x35;			// SF ODOS turn rate address
+constexpr uint8_t MRSSEN_TimestampLowAddress = 0x39;		// Shared clock timestamp (us) bits 0 - 31
+constexpr uint8_t MRSSEN_TimestampHighAddress = 0x3D;		// Shared clock timestamp (us) bits 32 - 63
+constexpr uint8_t MRSSEN_TurretConfidenceAddress = 0x41;	// Sensor turret position confidence address
+constexpr uint8_t MRSSEN_DataEndAddress = 0x45;				// One past the last data register
+
+constexpr uint8_t MRSSEN_DataRegisterCount = (MRSSEN_DataEndAddress - MRSSEN_DataStartAddress) / MRSSEN_RegisterSize;
+
+// Polar scan registers:
+constexpr uint8_t MRSSEN_ScanChunkAddress = 0x80;			// + chunk index; PolarScanChunkPacket of the last complete scan
+constexpr uint8_t MRSSEN_ScanChunkEndAddress = MRSSEN_ScanChunkAddress + MaxPolarScanChunks;
+constexpr uint8_t MRSSEN_ScanAvailableBit = 31;				// Dirty mask bit set when a new scan has been completed
+
+constexpr uint8_t MRSSEN_SequenceTrailer = 0x80;			// Selected length flag: follow the data registers with the uint32_t snapshot sequence number
+constexpr uint8_t MRSSEN_MaxReadLength = (sizeof(PolarScanChunkPacket) > MRSSEN_DataEndAddress + sizeof(uint32_t)) ? sizeof(PolarScanChunkPacket) : MRSSEN_DataEndAddress + sizeof(uint32_t);
+
+static_assert(MRSSEN_MaxReadLength < MRSSEN_SequenceTrailer, "Read lengths overlap the sequence trailer flag");
+
+static_assert(MRSSEN_DataRegisterCount <= MRSSEN_ScanAvailableBit, "Data registers overlap the scan available bit");
+
+// Clock synchronisation register:
+constexpr uint8_t MRSSEN_ClockAddress = 0xE0;				// Read: MRSSENClockRegister; write: MRSSENClockExchange
+
+// Control registers:
+constexpr uint8_t MRSSEN_VersionAddress = 0x00;				// uint8_t register map version
+constexpr uint8_t MRSSEN_ControlStartAddress = 0xF0;
+constexpr uint8_t MRSSEN_DirtyMaskAddress = 0xF0;			// uint32_t dirty data register mask; write the mask back to clear
+constexpr uint8_t MRSSEN_SequenceAddress = 0xF4;			// uint32_t sequence number of the served snapshot
+constexpr uint8_t MRSSEN_CommandAckAddress = 0xF8;			// MRSSENCommandAck for the last command handled
+constexpr uint8_t MRSSEN_ControlEndAddress = 0xFC;			// One past the last control register
+
+/// <summary>
+/// Contents of the command acknowledge register; lets the MCC confirm that a CSSMCommandPacket it sent (identified
+/// by its sequence number) was executed
+/// </summary>
+struct MRSSENCommandAck
+{
+	enum AckStatus : uint8_t
+	{
+		None = 0,
+		Accepted = 1,				// Command executed
+		Rejected = 2,				// Command understood but could not be executed (e.g. turret motor not initialized)
+		Unknown = 3,				// Command code not recognized
+		Dropped = 4,				// Command queue was full
+	};
+
+	uint8_t Sequence = 0;			// CSSMCommandPacket::sequence
+	uint8_t Command = 0;			// CSSMCommandPacket::command
+	uint8_t Status = None;
+	uint8_t QueueDepth = 0;			// Commands still waiting to be executed
+};
+
+/// <summary>
+/// Contents of the clock register
+/// </summary>
+struct MRSSENClockRegister
+{
+	int64_t ReadTime = 0;			// us; MRS SEN clock when the I2C request handler served the read
+	int32_t ResidualOffset = 0;		// us; MRS SEN ClockSync residual, reported to the MCC
+};
+
+/// <summary>
+/// Written by the MCC to the clock register after reading it, to complete one exchange
+/// </summary>
+struct MRSSENClockExchange
+{
+	int64_t MCCSendTime = 0;		// us; MCC clock when the clock register read's address byte had been sent
+	int64_t SENReceiveTime = 0;		// us; MRSSENClockRegister::ReadTime
+	int64_t MCCReceiveTime = 0;		// us; MCC clock when the read's data phase began
+};
+
+class MRSSENRegisterMap
+{
+public:
+	static uint8_t GetRegisterIndex(uint8_t address);
+	static uint8_t GetRegisterAddress(uint8_t index);
+	static void* GetField(MRSSensorPacket& packet, uint8_t index);
+	static void Encode(MRSSensorPacket& packet, uint8_t* image);
+	static void Decode(uint8_t index, const uint8_t* data, MRSSensorPacket& packet);
+};
+
+#endif
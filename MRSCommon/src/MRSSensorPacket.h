@@ -31,6 +31,8 @@ public:
 	float INA219VBus = 0.0f;		// V
 	float INA219Current = 0.0f;		// mA
 	float INA219Power = 0.0f;		// mW
+	float INA219SOC = 0.0f;			// %
+	float INA219Runtime = -1.0f;	// min; < 0 when the pack is not discharging
 
 	// Environment BME680:
 	float BME680Temp = 0.0f;		// C
@@ -46,15 +48,27 @@ public:
 	float ODOSPosX = 0.0f;			// m
 	float ODOSPosY = 0.0f;			// m
 	float ODOSHdg = 0.0f;			// 
+	float ODOSVelX = 0.0f;			// m/s
+	float ODOSVelY = 0.0f;			// m/s
+	float ODOSVelHdg = 0.0f;		// /s
 
 	// Sensor turret:
 	int TurretPosition = 0;			// 
+	int TurretConfidence = 0;		// %; 0 until the turret has been homed, then falling with travel until it is re-indexed
 
 	// Right WS 3S UPS:
 	float RINA219VShunt = 0.0f;		// mV
 	float RINA219VBus = 0.0f;		// V
 	float RINA219Current = 0.0f;	// mA
 	float RINA219Power = 0.0f;		// mW
+	float RINA219SOC = 0.0f;		// %
+	float RINA219Runtime = -1.0f;	// min; < 0 when the pack is not discharging
+
+	// Shared (MCC) clock time the MRS SEN module committed this set of readings, us (see ClockSync.h):
+	int64_t Timestamp = 0;
+
+	// Snapshot sequence number; incremented each time the MRS SEN module commits a consistent set of readings:
+	uint32_t Sequence = 0;
 
 };
 
@@ -0,0 +1,160 @@
+/*	MinMaxHistory.h
+*	MinMaxHistory - Fixed size multi-resolution history of a sampled value for strip charts
+*
+*	Each level is a ring of N buckets holding the minimum and maximum of the values that went into them.  Level 0
+*	buckets each take Factor[0] samples (1 by default); each bucket of a higher level takes Factor[level] completed
+*	buckets of the level below.  Sampled every 100 ms with factors of 1, 6 and 10, 100 buckets per level cover the
+*	last 10 s, 1 min and 10 min; a spike shorter than a bucket still shows at every level.
+*
+*	GetTotal() counts the buckets ever completed at a level, so that a chart can tell how many new buckets it has to
+*	draw since it last looked.  All storage is in the object; nothing is allocated.
+*
+*	Not thread safe; add and query from the same task.
+*
+*	Mitchell Baldwin copyright 2026
+*
+*	v 0.00:	Initial data structure
+*	v
+*
+*/
+
+#ifndef _MinMaxHistory_h
+#define _MinMaxHistory_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+struct MinMax
+{
+	float Min;
+	float Max;
+};
+
+template <uint16_t N, uint8_t Levels = 3>
+class MinMaxHistory
+{
+	static_assert(N >= 2 && Levels >= 1, "MinMaxHistory needs at least 2 buckets and 1 level");
+
+protected:
+	MinMax Buckets[Levels][N];
+	uint16_t Head[Levels];								// Next bucket written
+	uint16_t Count[Levels];
+	uint32_t Total[Levels];								// Buckets completed since Clear()
+	uint8_t Factor[Levels];								// Inputs per bucket
+	MinMax Pending[Levels];								// Bucket being filled
+	uint8_t PendingCount[Levels];
+	float Latest = 0.0f;
+
+	void AddBucket(uint8_t level, const MinMax& bucket)
+	{
+		Buckets[level][Head[level]] = bucket;
+		Head[level] = (Head[level] + 1) % N;
+		if (Count[level] < N)
+		{
+			Count[level]++;
+		}
+		Total[level]++;
+	}
+
+	void Merge(uint8_t level, const MinMax& input)
+	{
+		if (PendingCount[level] == 0)
+		{
+			Pending[level] = input;
+		}
+		else
+		{
+			Pending[level].Min = min(Pending[level].Min, input.Min);
+			Pending[level].Max = max(Pending[level].Max, input.Max);
+		}
+
+		if (++PendingCount[level] >= Factor[level])
+		{
+			PendingCount[level] = 0;
+			AddBucket(level, Pending[level]);
+			if (level + 1 < Levels)
+			{
+				Merge(level + 1, Pending[level]);
+			}
+		}
+	}
+
+public:
+	MinMaxHistory()
+	{
+		for (uint8_t level = 0; level < Levels; level++)
+		{
+			Factor[level] = (level == 0) ? 1 : 6;
+		}
+		Clear();
+	}
+
+	/// <param name="factor">Samples per level 0 bucket, or buckets of the level below per bucket of a higher level</param>
+	void SetFactor(uint8_t level, uint8_t factor)
+	{
+		if (level < Levels && factor > 0)
+		{
+			Factor[level] = factor;
+		}
+	}
+
+	uint8_t GetFactor(uint8_t level) const
+	{
+		return (level < Levels) ? Factor[level] : 0;
+	}
+
+	/// <returns>Samples per bucket at a level</returns>
+	uint32_t GetSamplesPerBucket(uint8_t level) const
+	{
+		uint32_t samples = 1;
+		for (uint8_t i = 0; i <= level && i < Levels; i++)
+		{
+			samples *= Factor[i];
+		}
+		return samples;
+	}
+
+	void Clear()
+	{
+		for (uint8_t level = 0; level < Levels; level++)
+		{
+			Head[level] = 0;
+			Count[level] = 0;
+			Total[level] = 0;
+			PendingCount[level] = 0;
+		}
+		Latest = 0.0f;
+	}
+
+	void Add(float value)
+	{
+		Latest = value;
+		Merge(0, { value, value });
+	}
+
+	float GetLatest() const
+	{
+		return Latest;
+	}
+
+	uint16_t GetCount(uint8_t level) const
+	{
+		return Count[level];
+	}
+
+	uint32_t GetTotal(uint8_t level) const
+	{
+		return Total[level];
+	}
+
+	/// <param name="age">0 for the newest completed bucket to GetCount() - 1 for the oldest</param>
+	const MinMax& Get(uint8_t level, uint16_t age) const
+	{
+		return Buckets[level][(Head[level] + N - 1 - age) % N];
+	}
+};
+
+#endif
@@ -0,0 +1,329 @@
+/*	OccupancyGrid.h
+*	OccupancyGrid - Fixed memory log-odds occupancy grid covering a square window of the world around the robot
+*
+*	Cells hold int8_t log-odds (0 = unknown, positive = occupied) and are stored in 8 x 8 cell tiles, so the cells
+*	a ray passes through are mostly in the same 64 byte block.  The window is N x N tiles centred on the tile
+*	holding the robot; world tile (tx, ty) is always stored in buffer tile (tx mod N, ty mod N), so scrolling the
+*	window never moves memory: a buffer tile is cleared and reassigned the first time a ray touches the new world
+*	tile that maps to it.
+*
+*	Range rays are traced with Bresenham's line algorithm: cells before the end point are made more likely free,
+*	the end point more likely occupied unless the range was at or beyond OccupancyMaxRayRange.  A tile is flagged
+*	dirty when one of its cells changes OccupancyState, and ExportTile() hands dirty tiles out one at a time as
+*	OccupancyTilePackets; ApplyTile() rebuilds a (state only) copy of the grid from them on the receiver.
+*
+*	Each buffer tile also has a revision count, incremented when it is claimed or one of its cells changes state, so
+*	that a map view can redraw only the tiles that have changed (GetBufferTileInfo()).
+*
+*	Mitchell Baldwin copyright 2025
+*
+*	v 0.00:	Initial data structure
+*	v
+*
+*/
+
+#ifndef _OccupancyGrid_h
+#define _OccupancyGrid_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+#include "OccupancyTilePacket.h"
+
+constexpr int8_t LogOddsHit = 10;						// Added to the cell a ray ends in
+constexpr int8_t LogOddsMiss = -3;						// Added to each cell a ray passes through
+constexpr int8_t LogOddsMax = 100;
+constexpr int8_t LogOddsMin = -100;
+constexpr int8_t LogOddsOccupied = 20;					// At or above: OccupiedCell
+constexpr int8_t LogOddsFree = -9;						// At or below: FreeCell
+constexpr uint16_t OccupancyMaxRayRange = 4000;			// mm; longer ranges only clear cells
+constexpr int16_t OccupancyNoTile = INT16_MIN;			// TileX of a buffer tile not yet assigned
+
+template <uint8_t N>
+class OccupancyGrid
+{
+	static_assert(N >= 2 && N <= 16, "OccupancyGrid must be 2 to 16 tiles per side");
+
+protected:
+	int8_t Cells[N * N][OccupancyTileCells];			// [buffer tile][row * OccupancyTileSide + column]
+	int16_t TileX[N * N];								// World tile held by each buffer tile
+	int16_t TileY[N * N];
+	uint32_t DirtyTiles[(N * N + 31) / 32];
+	uint8_t TileRevisions[N * N];
+	uint16_t NextExportTile = 0;
+	uint16_t CellSize;									// mm
+	int32_t CentreTileX = 0;
+	int32_t CentreTileY = 0;
+
+	static uint16_t GetBufferTile(int32_t tx, int32_t ty)
+	{
+		return (uint16_t)(((tx % N) + N) % N + (((ty % N) + N) % N) * N);
+	}
+
+	static OccupancyStates GetStateOf(int8_t logOdds)
+	{
+		if (logOdds == 0)
+		{
+			return UnknownCell;
+		}
+		if (logOdds <= LogOddsFree)
+		{
+			return FreeCell;
+		}
+		if (logOdds >= LogOddsOccupied)
+		{
+			return OccupiedCell;
+		}
+		return UncertainCell;
+	}
+
+	bool InWindow(int32_t tx, int32_t ty) const
+	{
+		int32_t dx = tx - CentreTileX + N / 2;
+		int32_t dy = ty - CentreTileY + N / 2;
+		return dx >= 0 && dx < N && dy >= 0 && dy < N;
+	}
+
+	/// <summary>
+	/// Returns the buffer tile holding world tile (tx, ty), claiming (and clearing) it if claim is set, or -1
+	/// </summary>
+	int ClaimTile(int32_t tx, int32_t ty, bool claim)
+	{
+		uint16_t b = GetBufferTile(tx, ty);
+		if (TileX[b] != tx || TileY[b] != ty)
+		{
+			if (!claim)
+			{
+				return -1;
+			}
+			memset(Cells[b], 0, OccupancyTileCells);
+			TileX[b] = tx;
+			TileY[b] = ty;
+			DirtyTiles[b / 32] |= (1UL << (b % 32));
+			TileRevisions[b]++;
+		}
+		return b;
+	}
+
+	void UpdateCell(int32_t cx, int32_t cy, int8_t delta)
+	{
+		int32_t tx = cx >> 3;							// Arithmetic shifts floor negative cell indices too
+		int32_t ty = cy >> 3;
+		if (!InWindow(tx, ty))
+		{
+			return;
+		}
+		uint16_t b = ClaimTile(tx, ty, true);
+		int8_t& cell = Cells[b][(cy & 7) * OccupancyTileSide + (cx & 7)];
+		OccupancyStates before = GetStateOf(cell);
+		int16_t value = constrain(cell + delta, LogOddsMin, LogOddsMax);
+		cell = (value == 0) ? ((delta > 0) ? 1 : -1) : value;	// Once observed a cell never returns to unknown
+		if (GetStateOf(cell) != before)
+		{
+			DirtyTiles[b / 32] |= (1UL << (b % 32));
+			TileRevisions[b]++;
+			Revision++;
+		}
+		CellUpdates++;
+	}
+
+public:
+	static constexpr uint16_t WindowCells = N * OccupancyTileSide;	// Cells per window side
+	static constexpr uint16_t BufferTiles = N * N;
+
+	uint32_t RaysAdded = 0;
+	uint32_t CellUpdates = 0;
+	uint32_t Revision = 0;								// Incremented whenever a cell changes state
+
+	OccupancyGrid(uint16_t cellSize = 50)
+	{
+		CellSize = cellSize;
+		Clear();
+	}
+
+	void Clear()
+	{
+		memset(Cells, 0, sizeof(Cells));
+		memset(DirtyTiles, 0, sizeof(DirtyTiles));
+		memset(TileRevisions, 0, sizeof(TileRevisions));
+		for (uint16_t b = 0; b < N * N; b++)
+		{
+			TileX[b] = OccupancyNoTile;
+			TileY[b] = OccupancyNoTile;
+		}
+	}
+
+	uint16_t GetCellSize() const
+	{
+		return CellSize;
+	}
+
+	/// <returns>World cell index containing a coordinate in metres</returns>
+	int32_t GetCellIndex(float position) const
+	{
+		return (int32_t)floorf(position * 1000.0f / CellSize);
+	}
+
+	/// <summary>
+	/// Moves the window so it is centred on the tile containing the robot
+	/// </summary>
+	/// <param name="x">Robot position, m</param>
+	/// <param name="y">Robot position, m</param>
+	void SetCentre(float x, float y)
+	{
+		CentreTileX = GetCellIndex(x) >> 3;
+		CentreTileY = GetCellIndex(y) >> 3;
+	}
+
+	/// <summary>
+	/// Returns the world cell at the lower left corner of the window
+	/// </summary>
+	void GetWindowOrigin(int32_t& cx, int32_t& cy) const
+	{
+		cx = (CentreTileX - N / 2) * OccupancyTileSide;
+		cy = (CentreTileY - N / 2) * OccupancyTileSide;
+	}
+
+	/// <summary>
+	/// Traces one range measurement through the grid
+	/// </summary>
+	/// <param name="x">Sensor position, m</param>
+	/// <param name="y">Sensor position, m</param>
+	/// <param name="bearing">World bearing of the ray, degrees counterclockwise from the x axis</param>
+	/// <param name="range">mm; PolarScanNoRange (0) rays carry no information and are ignored</param>
+	void AddRay(float x, float y, float bearing, uint16_t range)
+	{
+		if (range == 0)
+		{
+			return;
+		}
+		bool hit = (range < OccupancyMaxRayRange);
+		float length = (hit ? range : OccupancyMaxRayRange) / 1000.0f;
+		float radians = bearing * DEG_TO_RAD;
+
+		int32_t x0 = GetCellIndex(x);
+		int32_t y0 = GetCellIndex(y);
+		int32_t x1 = GetCellIndex(x + length * cosf(radians));
+		int32_t y1 = GetCellIndex(y + length * sinf(radians));
+
+		int32_t dx = abs(x1 - x0);
+		int32_t dy = -abs(y1 - y0);
+		int8_t sx = (x0 < x1) ? 1 : -1;
+		int8_t sy = (y0 < y1) ? 1 : -1;
+		int32_t error = dx + dy;
+		while (x0 != x1 || y0 != y1)
+		{
+			UpdateCell(x0, y0, LogOddsMiss);
+			int32_t e2 = 2 * error;
+			if (e2 >= dy)
+			{
+				error += dy;
+				x0 += sx;
+			}
+			if (e2 <= dx)
+			{
+				error += dx;
+				y0 += sy;
+			}
+		}
+		UpdateCell(x1, y1, hit ? LogOddsHit : LogOddsMiss);
+		RaysAdded++;
+	}
+
+	/// <returns>State of a world cell; UnknownCell if its tile has not been observed or its buffer tile has since been reused</returns>
+	OccupancyStates GetState(int32_t cx, int32_t cy) const
+	{
+		int32_t tx = cx >> 3;
+		int32_t ty = cy >> 3;
+		uint16_t b = GetBufferTile(tx, ty);
+		if (TileX[b] != tx || TileY[b] != ty)
+		{
+			return UnknownCell;
+		}
+		return GetStateOf(Cells[b][(cy & 7) * OccupancyTileSide + (cx & 7)]);
+	}
+
+	/// <summary>
+	/// Returns the world tile held by a buffer tile and its revision count
+	/// </summary>
+	/// <returns>False if the buffer tile has not been assigned a world tile</returns>
+	bool GetBufferTileInfo(uint16_t b, int32_t& tx, int32_t& ty, uint8_t& revision) const
+	{
+		if (b >= N * N || TileX[b] == OccupancyNoTile)
+		{
+			return false;
+		}
+		tx = TileX[b];
+		ty = TileY[b];
+		revision = TileRevisions[b];
+		return true;
+	}
+
+	/// <summary>
+	/// Fills a packet with the next tile whose cells have changed state, and marks it clean
+	/// </summary>
+	/// <returns>False if no tile is dirty</returns>
+	bool ExportTile(OccupancyTilePacket& packet)
+	{
+		for (uint16_t i = 0; i < N * N; i++)
+		{
+			uint16_t b = (NextExportTile + i) % (N * N);
+			if (!(DirtyTiles[b / 32] & (1UL << (b % 32))))
+			{
+				continue;
+			}
+			DirtyTiles[b / 32] &= ~(1UL << (b % 32));
+			NextExportTile = (b + 1) % (N * N);
+
+			packet.TileX = TileX[b];
+			packet.TileY = TileY[b];
+			packet.CellSize = CellSize;
+			for (uint8_t c = 0; c < OccupancyTileCells; c++)
+			{
+				packet.SetState(c, GetStateOf(Cells[b][c]));
+			}
+			return true;
+		}
+		return false;
+	}
+
+	/// <summary>
+	/// Flags world tile (tx, ty) for export again, e.g. after its packet was lost; ignored if the tile has since
+	/// scrolled out of the window
+	/// </summary>
+	void MarkTileDirty(int32_t tx, int32_t ty)
+	{
+		if (!InWindow(tx, ty))
+		{
+			return;
+		}
+		int b = ClaimTile(tx, ty, false);
+		if (b >= 0)
+		{
+			DirtyTiles[b / 32] |= (1UL << (b % 32));
+		}
+	}
+
+	/// <summary>
+	/// Stores a tile received from another grid; cells take a log-odds value representative of their state
+	/// </summary>
+	void ApplyTile(const OccupancyTilePacket& packet)
+	{
+		static const int8_t StateLogOdds[] = { 0, LogOddsFree, 1, LogOddsOccupied };
+
+		CellSize = packet.CellSize;
+		uint16_t b = ClaimTile(packet.TileX, packet.TileY, true);
+		for (uint8_t c = 0; c < OccupancyTileCells; c++)
+		{
+			Cells[b][c] = StateLogOdds[packet.GetState(c)];
+		}
+		TileRevisions[b]++;
+		Revision++;
+	}
+
+};
+
+#endif
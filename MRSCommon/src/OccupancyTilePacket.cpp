@@ -0,0 +1,18 @@
+/* OccupancyTilePacket.cpp
+* OccupancyTilePacket class - One tile of the MCC occupancy grid
+*
+*/
+
+#include "OccupancyTilePacket.h"
+
+/// <param name="cell">row * OccupancyTileSide + column</param>
+OccupancyStates OccupancyTilePacket::GetState(uint8_t cell) const
+{
+	return (OccupancyStates)((States[cell >> 2] >> ((cell & 3) * 2)) & 0x03);
+}
+
+void OccupancyTilePacket::SetState(uint8_t cell, OccupancyStates state)
+{
+	uint8_t shift = (cell & 3) * 2;
+	States[cell >> 2] = (States[cell >> 2] & ~(0x03 << shift)) | (state << shift);
+}
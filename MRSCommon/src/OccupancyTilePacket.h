@@ -0,0 +1,53 @@
+/* OccupancyTilePacket.h
+* OccupancyTilePacket class - One 8 x 8 cell tile of the MCC occupancy grid, sent to the CSSM when any of its cells
+* changes state
+*
+* Log-odds values are reduced to four states packed two bits per cell (16 bytes per tile); the tile position is in
+* world tiles, so the receiver can place it without knowing where the MCC's grid window is centred.
+*
+* Mitchell Baldwin copyright 2025
+*
+*	v 0.0:	Initial commit
+*	v 0.1:
+*
+*/
+
+#ifndef _OccupancyTilePacket_h
+#define _OccupancyTilePacket_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+constexpr uint8_t OccupancyTileSide = 8;				// Cells per tile side
+constexpr uint8_t OccupancyTileCells = OccupancyTileSide * OccupancyTileSide;
+
+enum OccupancyStates : uint8_t
+{
+	UnknownCell = 0,
+	FreeCell = 1,
+	UncertainCell = 2,									// Observed, but neither clearly free nor clearly occupied
+	OccupiedCell = 3,
+};
+
+class OccupancyTilePacket
+{
+protected:
+	uint8_t PacketType = 0x34;		// Identifies packet type; fixed for all OccupancyTilePackets
+
+public:
+	uint8_t Reserved = 0;
+	int16_t TileX = 0;				// World tile; cell x = TileX * OccupancyTileSide + column
+	int16_t TileY = 0;
+	uint16_t CellSize = 0;			// mm
+	uint8_t States[OccupancyTileCells / 4];	// OccupancyStates, 2 bits per cell, row major
+
+	OccupancyStates GetState(uint8_t cell) const;
+	void SetState(uint8_t cell, OccupancyStates state);
+	uint8_t GetPacketType() { return PacketType; }
+
+};
+
+#endif
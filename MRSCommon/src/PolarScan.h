@@ -0,0 +1,81 @@
+/*	PolarScan.h
+*	PolarScan - One sweep of the sensor turret range finder, binned by bearing
+*
+*	Bearings are in tenths of a degree relative to the turret home position, positive clockwise.  Bin i covers
+*	StartAngle + i * AngleStep up to StartAngle + (i + 1) * AngleStep and holds the shortest range sampled in it
+*	during the sweep (the nearest obstacle), or PolarScanNoRange if no sample fell in it.
+*
+*	Mitchell Baldwin copyright 2025
+*
+*	v 0.00:	Initial data structure
+*	v
+*
+*/
+
+#ifndef _PolarScan_h
+#define _PolarScan_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+constexpr uint8_t MaxPolarScanBins = 120;				// e.g. 1 degree bins over a 120 degree sweep
+constexpr uint16_t PolarScanNoRange = 0;
+
+struct PolarScan
+{
+	uint16_t ScanID = 0;								// Incremented for each completed sweep; 0 = no scan yet
+	int16_t StartAngle = 0;								// 0.1 degree; start of bin 0
+	uint16_t AngleStep = 10;							// 0.1 degree per bin
+	uint8_t BinCount = 0;
+	uint32_t StartTime = 0;								// ms
+	uint32_t EndTime = 0;								// ms
+	uint16_t Range[MaxPolarScanBins];					// mm
+
+	void Clear()
+	{
+		for (uint8_t i = 0; i < MaxPolarScanBins; i++)
+		{
+			Range[i] = PolarScanNoRange;
+		}
+	}
+
+	/// <summary>
+	/// Returns the bin containing a bearing, or -1 if the bearing is outside the scan
+	/// </summary>
+	/// <param name="angle">Bearing in degrees</param>
+	int GetBinIndex(float angle) const
+	{
+		float offset = (angle * 10.0f - StartAngle) / AngleStep;
+		if (offset < 0.0f || offset >= BinCount)
+		{
+			return -1;
+		}
+		return (int)offset;
+	}
+
+	/// <summary>
+	/// Returns the bearing of the centre of a bin in degrees
+	/// </summary>
+	float GetBinAngle(uint8_t bin) const
+	{
+		return (StartAngle + (bin + 0.5f) * AngleStep) / 10.0f;
+	}
+
+	uint8_t GetFilledBinCount() const
+	{
+		uint8_t count = 0;
+		for (uint8_t i = 0; i < BinCount; i++)
+		{
+			if (Range[i] != PolarScanNoRange)
+			{
+				count++;
+			}
+		}
+		return count;
+	}
+};
+
+#endif
@@ -0,0 +1,118 @@
+/* PolarScanAssembler.cpp
+* PolarScanAssemblerClass - Reassembles PolarScans from PolarScanChunkPackets
+*
+*/
+
+#include "PolarScanAssembler.h"
+
+void PolarScanAssemblerClass::AddChunk(const PolarScanChunkPacket& chunk)
+{
+	if (chunk.ChunkIndex >= chunk.ChunkCount || chunk.ChunkCount > MaxPolarScanChunks
+		|| chunk.FirstBin + chunk.BinCount > min(chunk.TotalBins, MaxPolarScanBins))
+	{
+		return;											// Malformed
+	}
+	if (chunk.ScanID == Latest.ScanID)
+	{
+		return;											// Straggler from a scan already published
+	}
+
+	if (chunk.ScanID != Building.ScanID)
+	{
+		Publish();
+		Building.Clear();
+		Building.ScanID = chunk.ScanID;
+		Building.StartAngle = chunk.StartAngle;
+		Building.AngleStep = chunk.AngleStep;
+		Building.BinCount = chunk.TotalBins;
+		BuildingChunkCount = chunk.ChunkCount;
+		BuildingChunkMask = 0;
+	}
+
+	for (uint8_t i = 0; i < chunk.BinCount; i++)
+	{
+		Building.Range[chunk.FirstBin + i] = PolarScanChunkPacket::DequantiseRange(chunk.Ranges[i]);
+	}
+	BuildingChunkMask |= 1 << chunk.ChunkIndex;
+	BuildingAge = chunk.Age;
+	LastChunkTime = millis();
+	ChunksReceived++;
+
+	if (BuildingChunkMask == (1 << BuildingChunkCount) - 1)
+	{
+		Publish();
+	}
+}
+
+/// <summary>
+/// Publishes a partially received scan once its remaining chunks are overdue
+/// </summary>
+void PolarScanAssemblerClass::Update()
+{
+	if (BuildingChunkMask != 0 && millis() - LastChunkTime > PolarScanAssemblyTimeout)
+	{
+		Publish();
+	}
+}
+
+void PolarScanAssemblerClass::Publish()
+{
+	if (BuildingChunkMask == 0)
+	{
+		return;
+	}
+
+	uint8_t fullMask = (1 << BuildingChunkCount) - 1;
+	if (BuildingChunkMask == fullMask)
+	{
+		ScansComplete++;
+		LastLatency = BuildingAge + (millis() - LastChunkTime);
+		BytesPerScan = BuildingChunkCount * sizeof(PolarScanChunkPacket);
+	}
+	else
+	{
+		ScansPartial++;
+		for (uint8_t i = 0; i < BuildingChunkCount; i++)
+		{
+			if (!(BuildingChunkMask & (1 << i)))
+			{
+				ChunksLost++;
+			}
+		}
+	}
+
+	Building.EndTime = LastChunkTime;
+	Latest = Building;
+	LatestChunkMask = BuildingChunkMask;
+	BuildingChunkMask = 0;
+}
+
+/// <returns>False if no scan has been received yet</returns>
+bool PolarScanAssemblerClass::GetLatestScan(PolarScan& scan)
+{
+	if (Latest.ScanID == 0)
+	{
+		return false;
+	}
+	scan = Latest;
+	return true;
+}
+
+uint16_t PolarScanAssemblerClass::GetLatestScanID()
+{
+	return Latest.ScanID;
+}
+
+/// <returns>False if the chunk holding the bin was lost</returns>
+bool PolarScanAssemblerClass::IsBinValid(uint8_t bin)
+{
+	return bin < Latest.BinCount && (LatestChunkMask & (1 << (bin / MaxPolarScanChunkBins)));
+}
+
+String PolarScanAssemblerClass::GetStatusString()
+{
+	char buf[80];
+	snprintf(buf, sizeof(buf), "Scan %u: %lu ok %lu part %lu lost %u ms %u B",
+		Latest.ScanID, (unsigned long)ScansComplete, (unsigned long)ScansPartial, (unsigned long)ChunksLost, LastLatency, BytesPerScan);
+	return String(buf);
+}
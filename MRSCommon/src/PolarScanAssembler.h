@@ -0,0 +1,61 @@
+/* PolarScanAssembler.h
+* PolarScanAssemblerClass - Reassembles PolarScans from PolarScanChunkPackets
+*
+* Chunks of one scan may arrive in any order and some may never arrive.  A scan is published when all its chunks
+* have arrived, when a chunk of a newer scan arrives, or when no chunk has arrived for PolarScanAssemblyTimeout;
+* bins from missing chunks are left as PolarScanNoRange and flagged invalid by IsBinValid() so a lost chunk only
+* costs that part of the scan.
+*
+* Mitchell Baldwin copyright 2025
+*
+*	v 0.0:	Initial commit
+*	v 0.1:
+*
+*/
+
+#ifndef _PolarScanAssembler_h
+#define _PolarScanAssembler_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+#include "PolarScanChunkPacket.h"
+
+constexpr uint32_t PolarScanAssemblyTimeout = 500;		// ms
+
+class PolarScanAssemblerClass
+{
+protected:
+	PolarScan Building;
+	uint8_t BuildingChunkCount = 0;
+	uint8_t BuildingChunkMask = 0;						// Bit n set when chunk n has arrived
+	uint16_t BuildingAge = 0;							// Age of the most recent chunk, ms
+	uint32_t LastChunkTime = 0;							// ms
+
+	PolarScan Latest;
+	uint8_t LatestChunkMask = 0;
+
+	void Publish();
+
+public:
+	uint32_t ChunksReceived = 0;
+	uint32_t ChunksLost = 0;
+	uint32_t ScansComplete = 0;
+	uint32_t ScansPartial = 0;
+	uint16_t LastLatency = 0;							// ms from scan completion on the SEN to its last chunk arriving
+	uint16_t BytesPerScan = 0;							// Transfer size of the last scan with all chunks sent
+
+	void AddChunk(const PolarScanChunkPacket& chunk);
+	void Update();
+
+	bool GetLatestScan(PolarScan& scan);
+	uint16_t GetLatestScanID();
+	bool IsBinValid(uint8_t bin);
+	String GetStatusString();
+
+};
+
+#endif
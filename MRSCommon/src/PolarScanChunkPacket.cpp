@@ -0,0 +1,60 @@
+/* PolarScanChunkPacket.cpp
+* PolarScanChunkPacket class - One fragment of a PolarScan
+*
+*/
+
+#include "PolarScanChunkPacket.h"
+
+uint8_t PolarScanChunkPacket::GetChunkCount(const PolarScan& scan)
+{
+	return (scan.BinCount + MaxPolarScanChunkBins - 1) / MaxPolarScanChunkBins;
+}
+
+/// <param name="range">mm; PolarScanNoRange if no sample</param>
+/// <returns>Range in PolarScanRangeUnit steps, rounded; 0 only for no sample</returns>
+uint8_t PolarScanChunkPacket::QuantiseRange(uint16_t range)
+{
+	if (range == PolarScanNoRange)
+	{
+		return 0;
+	}
+	uint32_t value = (range + PolarScanRangeUnit / 2) / PolarScanRangeUnit;
+	return constrain(value, 1, 255);
+}
+
+/// <returns>mm</returns>
+uint16_t PolarScanChunkPacket::DequantiseRange(uint8_t value)
+{
+	return value * PolarScanRangeUnit;
+}
+
+/// <summary>
+/// Fills the packet with one chunk of a scan
+/// </summary>
+/// <param name="scan">Complete scan</param>
+/// <param name="chunkIndex">0 to GetChunkCount(scan) - 1</param>
+/// <param name="age">ms since the scan was completed</param>
+/// <returns>False if the chunk index is beyond the end of the scan</returns>
+bool PolarScanChunkPacket::Encode(const PolarScan& scan, uint8_t chunkIndex, uint16_t age)
+{
+	ChunkCount = GetChunkCount(scan);
+	if (chunkIndex >= ChunkCount)
+	{
+		BinCount = 0;
+		return false;
+	}
+
+	ChunkIndex = chunkIndex;
+	FirstBin = chunkIndex * MaxPolarScanChunkBins;
+	ScanID = scan.ScanID;
+	StartAngle = scan.StartAngle;
+	AngleStep = scan.AngleStep;
+	Age = age;
+	TotalBins = scan.BinCount;
+	BinCount = min((int)MaxPolarScanChunkBins, TotalBins - FirstBin);
+	for (uint8_t i = 0; i < MaxPolarScanChunkBins; i++)
+	{
+		Ranges[i] = (i < BinCount) ? QuantiseRange(scan.Range[FirstBin + i]) : 0;
+	}
+	return true;
+}
@@ -0,0 +1,65 @@
+/* PolarScanChunkPacket.h
+* PolarScanChunkPacket class - One fragment of a PolarScan for transfer from the MRS SEN module through the MCC
+* to the CSSM
+*
+* A scan is split into chunks of up to MaxPolarScanChunkBins consecutive bins so each chunk fits comfortably in
+* one I2C burst read and one ESP-NOW frame.  Every chunk carries the scan ID and geometry, so the receiver can
+* place it without the others; a lost chunk only leaves its own bins empty (see PolarScanAssembler).
+*
+* Ranges are quantised to one byte in PolarScanRangeUnit steps (0 = no range, 255 = beyond 5.08 m), which
+* covers the VL53L1X long distance mode and halves the size of a scan.
+*
+* Age is the time since the scan was completed, added to at each hop (SEN before serving, MCC while queued), so
+* the CSSM can report end to end scan latency without synchronised clocks.
+*
+* Mitchell Baldwin copyright 2025
+*
+*	v 0.0:	Initial commit
+*	v 0.1:
+*
+*/
+
+#ifndef _PolarScanChunkPacket_h
+#define _PolarScanChunkPacket_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+#include "PolarScan.h"
+
+constexpr uint8_t MaxPolarScanChunkBins = 32;
+constexpr uint8_t MaxPolarScanChunks = 8;
+constexpr uint16_t PolarScanRangeUnit = 20;				// mm per quantisation step
+
+static_assert(MaxPolarScanBins <= MaxPolarScanChunkBins * MaxPolarScanChunks, "PolarScan too large for chunk transfer");
+
+class PolarScanChunkPacket
+{
+protected:
+	uint8_t PacketType = 0x33;		// Identifies packet type; fixed for all PolarScanChunkPackets
+
+public:
+	uint8_t ChunkIndex = 0;
+	uint8_t ChunkCount = 0;			// Chunks in the whole scan
+	uint8_t FirstBin = 0;			// Scan bin held in Ranges[0]
+	uint16_t ScanID = 0;
+	int16_t StartAngle = 0;			// 0.1 degree; start of scan bin 0
+	uint16_t AngleStep = 10;		// 0.1 degree per bin
+	uint16_t Age = 0;				// ms since the scan was completed
+	uint8_t BinCount = 0;			// Bins in this chunk
+	uint8_t TotalBins = 0;			// Bins in the whole scan
+	uint8_t Ranges[MaxPolarScanChunkBins];	// Quantised ranges
+
+	static uint8_t GetChunkCount(const PolarScan& scan);
+	static uint8_t QuantiseRange(uint16_t range);
+	static uint16_t DequantiseRange(uint8_t value);
+
+	bool Encode(const PolarScan& scan, uint8_t chunkIndex, uint16_t age);
+	uint8_t GetPacketType() { return PacketType; }
+
+};
+
+#endif
@@ -75,6 +75,9 @@ public:
 	float TurnRate = 0.0f;						// Turn rate (rad/s) calculated from motor odometry
 	float Heading = 0.0f;						// Heading (degrees) calculated from motor odometry	
 
+	int64_t Timestamp = 0;						// us; MCC (shared) clock time of the last odometry update
+	uint16_t LinkSequence = 0;					// Incremented for each packet sent; used by the CSSM's LinkMonitor
+
 };
 
 #endif
\ No newline at end of file
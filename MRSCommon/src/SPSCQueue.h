@@ -0,0 +1,81 @@
+/*	SPSCQueue.h
+*	SPSCQueue - Fixed size, lock free, single producer / single consumer queue for handing small structures from an
+*	interrupt or callback context (e.g. an I2C slave receive handler) to a scheduler task
+*
+*	The producer only writes Head and the consumer only writes Tail, so Push and Pop never block or disable
+*	interrupts.  N must be a power of two; the queue holds up to N - 1 entries.
+*
+*	Mitchell Baldwin copyright 2025
+*
+*	v 0.00:	Initial data structure
+*	v
+*
+*/
+
+#ifndef _SPSCQueue_h
+#define _SPSCQueue_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+#include <atomic>
+
+template <typename T, uint8_t N>
+class SPSCQueue
+{
+	static_assert(N >= 2 && (N & (N - 1)) == 0, "SPSCQueue size must be a power of two");
+
+protected:
+	T Entries[N];
+	std::atomic<uint8_t> Head{ 0 };						// Next entry written by the producer
+	std::atomic<uint8_t> Tail{ 0 };						// Next entry read by the consumer
+
+public:
+	/// <summary>
+	/// Adds an entry; producer only
+	/// </summary>
+	/// <returns>False if the queue is full and the entry was dropped</returns>
+	bool Push(const T& entry)
+	{
+		uint8_t head = Head.load(std::memory_order_relaxed);
+		uint8_t next = (head + 1) & (N - 1);
+		if (next == Tail.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+		Entries[head] = entry;
+		Head.store(next, std::memory_order_release);
+		return true;
+	}
+
+	/// <summary>
+	/// Removes the oldest entry; consumer only
+	/// </summary>
+	/// <returns>False if the queue is empty</returns>
+	bool Pop(T& entry)
+	{
+		uint8_t tail = Tail.load(std::memory_order_relaxed);
+		if (tail == Head.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+		entry = Entries[tail];
+		Tail.store((tail + 1) & (N - 1), std::memory_order_release);
+		return true;
+	}
+
+	uint8_t GetCount() const
+	{
+		return (Head.load(std::memory_order_acquire) - Tail.load(std::memory_order_acquire)) & (N - 1);
+	}
+
+	uint8_t GetCapacity() const
+	{
+		return N - 1;
+	}
+};
+
+#endif
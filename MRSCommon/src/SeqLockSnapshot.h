@@ -0,0 +1,88 @@
+/*	SeqLockSnapshot.h
+*	SeqLockSnapshot - Double buffered snapshot of a plain data structure, published by one writer (task) and
+*	read without locking by another task or callback (e.g. an I2C slave request handler)
+*
+*	The version counter is even while the buffers are stable and odd while the writer is filling the inactive
+*	buffer; each publish adds 2, and Buffers[(Version / 2) & 1] holds the latest complete snapshot.  The writer
+*	makes the version odd and issues a release fence before touching the buffer, so a reader can never see the new
+*	contents of a buffer together with a version from before the write started.  A reader copies the latest
+*	complete buffer (even while the other one is being written) and keeps the copy only if the writer has not
+*	since started refilling that buffer, so a reader never returns a torn structure.  T must be trivially
+*	copyable; there must be only one writer.
+*
+*	HostTests/SeqLockSnapshotTest.cpp hammers a snapshot from two threads.
+*
+*	Mitchell Baldwin copyright 2025
+*
+*	v 0.00:	Initial data structure
+*	v
+*
+*/
+
+#ifndef _SeqLockSnapshot_h
+#define _SeqLockSnapshot_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+#include <atomic>
+
+constexpr uint8_t defaultSeqLockReadAttempts = 4;
+
+template <typename T>
+class SeqLockSnapshot
+{
+protected:
+	T Buffers[2];
+	std::atomic<uint32_t> Version{ 0 };					// 2 per publish; odd while a publish is in progress
+
+public:
+	/// <summary>
+	/// Publishes a new snapshot; call from the single writer only
+	/// </summary>
+	/// <param name="value">Staging copy to publish</param>
+	/// <returns>Sequence number of the published snapshot</returns>
+	uint32_t Publish(const T& value)
+	{
+		uint32_t version = Version.load(std::memory_order_relaxed);
+		Version.store(version + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		Buffers[((version >> 1) + 1) & 1] = value;
+		Version.store(version + 2, std::memory_order_release);
+		return (version + 2) >> 1;
+	}
+
+	/// <summary>
+	/// Copies the latest consistent snapshot
+	/// </summary>
+	/// <param name="value">Destination</param>
+	/// <param name="maxAttempts">Copies attempted before giving up</param>
+	/// <returns>True if value holds a consistent snapshot; false if the writer kept overtaking the reader</returns>
+	bool Read(T& value, uint8_t maxAttempts = defaultSeqLockReadAttempts) const
+	{
+		for (uint8_t attempt = 0; attempt < maxAttempts; attempt++)
+		{
+			uint32_t version = Version.load(std::memory_order_acquire);
+			value = Buffers[(version >> 1) & 1];
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			// The buffer copied is next written by the publish that makes the version (version | 1) + 2:
+			if (Version.load(std::memory_order_relaxed) - (version & ~1U) < 3)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/// <returns>Number of snapshots published</returns>
+	uint32_t GetSequence() const
+	{
+		return Version.load() >> 1;
+	}
+};
+
+#endif
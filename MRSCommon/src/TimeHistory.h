@@ -0,0 +1,274 @@
+/*	TimeHistory.h
+*	TimeHistory - Fixed size ring of timestamped values that can be queried for the value at any time it spans
+*
+*	Values are added in time order (shared clock us, see ClockSync.h) and GetAt() binary searches for the pair of
+*	entries either side of the requested time and interpolates between them.  The interpolation is chosen by the
+*	Interpolator parameter: LinearInterpolator for scalars, track pairs and poses (whose heading is interpolated
+*	on the shortest arc) and HeadingInterpolator for bare headings.  Angles that never wrap, such as the turret
+*	position (a sweep between scan limits in the turret's 0 - 360 degree range), use LinearInterpolator so that an
+*	interpolated value lies on the path the turret actually travelled.
+*
+*	SetWindow() decimates the history so N entries cover at least the given window: while the newest entry is
+*	closer than window / (N - 2) to the one before it, it is overwritten rather than a new entry being added, so the
+*	newest value is always current and the older entries are evenly spread.
+*
+*	Not thread safe; add and query from the same task.  N must be a power of two.
+*
+*	Mitchell Baldwin copyright 2025
+*
+*	v 0.00:	Initial data structure
+*	v
+*
+*/
+
+#ifndef _TimeHistory_h
+#define _TimeHistory_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+struct HistoryPose
+{
+	float X;											// m
+	float Y;											// m
+	float Heading;										// degrees
+};
+
+struct HistoryPair
+{
+	float Left;
+	float Right;
+};
+
+/// <summary>
+/// Interpolates an angle in degrees along the shorter arc (slerp in one dimension); the result is in [-180, 180)
+/// </summary>
+struct HeadingInterpolator
+{
+	static float Lerp(float a, float b, float f)
+	{
+		float difference = fmodf(b - a + 540.0f, 360.0f) - 180.0f;
+		float heading = fmodf(a + difference * f + 540.0f, 360.0f) - 180.0f;
+		return heading;
+	}
+};
+
+struct LinearInterpolator
+{
+	static float Lerp(float a, float b, float f)
+	{
+		return a + (b - a) * f;
+	}
+
+	static int32_t Lerp(int32_t a, int32_t b, float f)
+	{
+		return a + (int32_t)lroundf((b - a) * f);
+	}
+
+	static HistoryPair Lerp(const HistoryPair& a, const HistoryPair& b, float f)
+	{
+		return { Lerp(a.Left, b.Left, f), Lerp(a.Right, b.Right, f) };
+	}
+
+	static HistoryPose Lerp(const HistoryPose& a, const HistoryPose& b, float f)
+	{
+		return { Lerp(a.X, b.X, f), Lerp(a.Y, b.Y, f), HeadingInterpolator::Lerp(a.Heading, b.Heading, f) };
+	}
+};
+
+template <typename T, uint16_t N, typename Interpolator = LinearInterpolator>
+class TimeHistory
+{
+	static_assert(N >= 4 && (N & (N - 1)) == 0, "TimeHistory size must be a power of two");
+
+protected:
+	struct Entry
+	{
+		int64_t Time;									// us
+		T Value;
+	};
+
+	Entry Entries[N];
+	uint16_t Head = 0;									// Next entry written
+	uint16_t Count = 0;
+	int64_t MinSpacing = 0;								// us; see SetWindow()
+
+	/// <param name="index">0 for the oldest entry to Count - 1 for the newest</param>
+	Entry& At(uint16_t index)
+	{
+		return Entries[(Head - Count + index) & (N - 1)];
+	}
+
+	const Entry& At(uint16_t index) const
+	{
+		return Entries[(Head - Count + index) & (N - 1)];
+	}
+
+	/// <returns>Index of the first entry later than time, or Count if there is none</returns>
+	uint16_t UpperBound(int64_t time) const
+	{
+		uint16_t low = 0;
+		uint16_t high = Count;
+		while (low < high)
+		{
+			uint16_t middle = (low + high) / 2;
+			if (At(middle).Time <= time)
+			{
+				low = middle + 1;
+			}
+			else
+			{
+				high = middle;
+			}
+		}
+		return low;
+	}
+
+public:
+	uint32_t Added = 0;
+	uint32_t Merged = 0;								// Values that overwrote the newest entry (see SetWindow())
+	uint32_t OutOfOrder = 0;							// Values discarded as older than the newest entry
+
+	/// <summary>
+	/// Sets the minimum time the history should span; 0 keeps every value
+	/// </summary>
+	/// <param name="window">ms</param>
+	void SetWindow(uint32_t window)
+	{
+		MinSpacing = (int64_t)window * 1000 / (N - 2);
+	}
+
+	void Clear()
+	{
+		Head = 0;
+		Count = 0;
+	}
+
+	/// <summary>
+	/// Adds a value; a value with the same time as the newest entry replaces it
+	/// </summary>
+	/// <param name="time">us</param>
+	/// <returns>False if the value was older than the newest entry and was discarded</returns>
+	bool Add(int64_t time, const T& value)
+	{
+		if (Count > 0)
+		{
+			Entry& newest = At(Count - 1);
+			if (time < newest.Time)
+			{
+				OutOfOrder++;
+				return false;
+			}
+			if (time == newest.Time || (Count >= 2 && time - At(Count - 2).Time < MinSpacing))
+			{
+				newest = { time, value };
+				Merged++;
+				return true;
+			}
+		}
+
+		Entries[Head] = { time, value };
+		Head = (Head + 1) & (N - 1);
+		if (Count < N)
+		{
+			Count++;
+		}
+		Added++;
+		return true;
+	}
+
+	/// <summary>
+	/// Interpolates the value at a time between the oldest and newest entries
+	/// </summary>
+	/// <param name="time">us</param>
+	/// <param name="value">Interpolated value</param>
+	/// <returns>False if time is outside the span of the history</returns>
+	bool GetAt(int64_t time, T& value) const
+	{
+		if (Count == 0 || time < At(0).Time || time > At(Count - 1).Time)
+		{
+			return false;
+		}
+
+		uint16_t index = UpperBound(time);
+		if (index == Count)
+		{
+			value = At(Count - 1).Value;
+			return true;
+		}
+		const Entry& before = At(index - 1);
+		const Entry& after = At(index);
+		float f = (float)(time - before.Time) / (float)(after.Time - before.Time);
+		value = Interpolator::Lerp(before.Value, after.Value, f);
+		return true;
+	}
+
+	/// <returns>False if the history is empty</returns>
+	bool GetNewest(T& value, int64_t& time) const
+	{
+		if (Count == 0)
+		{
+			return false;
+		}
+		value = At(Count - 1).Value;
+		time = At(Count - 1).Time;
+		return true;
+	}
+
+	uint16_t GetCount() const
+	{
+		return Count;
+	}
+
+	int64_t GetOldestTime() const
+	{
+		return (Count > 0) ? At(0).Time : 0;
+	}
+
+	int64_t GetNewestTime() const
+	{
+		return (Count > 0) ? At(Count - 1).Time : 0;
+	}
+
+	/// <summary>
+	/// Times Add() and GetAt() on a full history with a value every 10 ms
+	/// </summary>
+	/// <param name="addTime">ns per Add()</param>
+	/// <param name="queryTime">ns per GetAt()</param>
+	static void Benchmark(uint32_t& addTime, uint32_t& queryTime)
+	{
+		constexpr uint32_t operations = 10000;
+		constexpr int64_t interval = 10000;				// us
+		TimeHistory* history = new TimeHistory();
+		if (history == nullptr)
+		{
+			addTime = queryTime = 0;
+			return;
+		}
+
+		T value{};
+		uint32_t startTime = micros();
+		for (uint32_t i = 0; i < operations; i++)
+		{
+			history->Add(i * interval, value);
+		}
+		addTime = (micros() - startTime) * 1000UL / operations;
+
+		int64_t oldest = history->GetOldestTime();
+		int64_t span = history->GetNewestTime() - oldest;
+		uint32_t found = 0;
+		startTime = micros();
+		for (uint32_t i = 0; i < operations; i++)
+		{
+			found += history->GetAt(oldest + (i * 7919LL) % span, value);
+		}
+		queryTime = (micros() - startTime) * 1000UL / max(found, (uint32_t)1);
+
+		delete history;
+	}
+};
+
+#endif
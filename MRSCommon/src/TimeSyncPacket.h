@@ -0,0 +1,38 @@
+/* TimeSyncPacket.h
+* TimeSyncPacket class - Clock synchronisation request / reply exchanged between the CSSM and the MRS MCC over
+* ESP-NOW (see ClockSync.h)
+*
+* The CSSM sends a request stamped with its own clock (OriginateTime); the MCC stamps the request's arrival
+* (ReceiveTime) and returns the same packet stamped again just before it is sent (TransmitTime).
+*
+* Mitchell Baldwin copyright 2025
+*
+*	v 0.0:	Initial commit
+*	v 0.1:
+*
+*/
+
+#ifndef _TimeSyncPacket_h
+#define _TimeSyncPacket_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+class TimeSyncPacket
+{
+protected:
+	uint8_t PacketType = 0x35;		// Identifies packet type; fixed for all TimeSyncPackets
+
+public:
+	uint8_t Sequence = 0;			// Matches a reply to its request
+	int32_t ResidualOffset = 0;		// us; requester's ClockSync residual, reported to the MCC
+	int64_t OriginateTime = 0;		// us; requester's clock when the request was sent
+	int64_t ReceiveTime = 0;		// us; MCC clock when the request was received
+	int64_t TransmitTime = 0;		// us; MCC clock when the reply was sent
+
+};
+
+#endif
@@ -0,0 +1,185 @@
+/*	Trail.h
+*	Trail - Fixed size polyline of where the robot has been, simplified with Douglas-Peucker to bound its memory
+*
+*	Points closer than MinSpacing to the last point are not added.  When the trail is full the older three quarters
+*	of it are simplified with the Douglas-Peucker algorithm: the points that are kept are those needed for the
+*	simplified line to stay within Tolerance of every point it replaces.  If that does not free a quarter of the
+*	trail, Tolerance is doubled and the simplification repeated, so a long run is kept at a coarser and coarser
+*	resolution, while the newest quarter of the trail always keeps every point.
+*
+*	Revision is incremented whenever existing points are changed (by simplification or Clear()), so that a view
+*	drawing the trail incrementally knows to redraw it; otherwise points are only ever appended.
+*
+*	Not thread safe; add and query from the same task.
+*
+*	Mitchell Baldwin copyright 2026
+*
+*	v 0.00:	Initial data structure
+*	v
+*
+*/
+
+#ifndef _Trail_h
+#define _Trail_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+struct TrailPoint
+{
+	float X;											// m
+	float Y;											// m
+};
+
+template <uint16_t N>
+class Trail
+{
+	static_assert(N >= 16, "Trail must hold at least 16 points");
+
+protected:
+	TrailPoint Points[N];
+	uint16_t Count = 0;
+	bool Keep[N];										// Douglas-Peucker working storage
+	uint16_t StackFirst[N];
+	uint16_t StackLast[N];
+	float MinSpacing;									// m
+	float InitialTolerance;								// m
+
+	/// <returns>Distance of p from the segment a to b, m</returns>
+	static float SegmentDistance(const TrailPoint& p, const TrailPoint& a, const TrailPoint& b)
+	{
+		float dx = b.X - a.X;
+		float dy = b.Y - a.Y;
+		float lengthSquared = dx * dx + dy * dy;
+		float t = 0.0f;
+		if (lengthSquared > 0.0f)
+		{
+			t = constrain(((p.X - a.X) * dx + (p.Y - a.Y) * dy) / lengthSquared, 0.0f, 1.0f);
+		}
+		return hypotf(p.X - (a.X + t * dx), p.Y - (a.Y + t * dy));
+	}
+
+	/// <summary>
+	/// Douglas-Peucker simplification of Points[0] to Points[last], without recursion
+	/// </summary>
+	void Simplify(uint16_t last, float tolerance)
+	{
+		memset(Keep, 0, sizeof(Keep));
+		Keep[0] = true;
+		Keep[last] = true;
+
+		uint16_t depth = 0;
+		StackFirst[depth] = 0;
+		StackLast[depth] = last;
+		depth++;
+		while (depth > 0)
+		{
+			depth--;
+			uint16_t first = StackFirst[depth];
+			uint16_t end = StackLast[depth];
+
+			float maxDistance = 0.0f;
+			uint16_t farthest = first;
+			for (uint16_t i = first + 1; i < end; i++)
+			{
+				float distance = SegmentDistance(Points[i], Points[first], Points[end]);
+				if (distance > maxDistance)
+				{
+					maxDistance = distance;
+					farthest = i;
+				}
+			}
+
+			if (maxDistance > tolerance)
+			{
+				// Each split leaves at most one more span than before, so the stack never exceeds N entries:
+				Keep[farthest] = true;
+				StackFirst[depth] = first;
+				StackLast[depth] = farthest;
+				depth++;
+				StackFirst[depth] = farthest;
+				StackLast[depth] = end;
+				depth++;
+			}
+		}
+
+		uint16_t kept = 0;
+		for (uint16_t i = 0; i < Count; i++)
+		{
+			if (i > last || Keep[i])
+			{
+				Points[kept++] = Points[i];
+			}
+		}
+		Count = kept;
+	}
+
+	void Compress()
+	{
+		// The newest quarter of the trail is left alone; at worst the rest is reduced to its end points:
+		Simplify(Count - 1 - N / 4, Tolerance);
+		while (Count > N - N / 4)
+		{
+			Tolerance *= 2.0f;
+			Simplify(Count - 1 - N / 4, Tolerance);
+		}
+		Compressions++;
+		Revision++;
+	}
+
+public:
+	float Tolerance;									// m; current simplification tolerance
+	uint32_t Revision = 0;
+	uint32_t Added = 0;
+	uint32_t Compressions = 0;
+
+	/// <param name="minSpacing">m; points closer than this to the last point are not added</param>
+	/// <param name="tolerance">m; tolerance of the first simplification</param>
+	Trail(float minSpacing = 0.02f, float tolerance = 0.01f)
+	{
+		MinSpacing = minSpacing;
+		InitialTolerance = tolerance;
+		Tolerance = tolerance;
+	}
+
+	void Clear()
+	{
+		Count = 0;
+		Tolerance = InitialTolerance;
+		Revision++;
+	}
+
+	/// <param name="x">m</param>
+	/// <param name="y">m</param>
+	/// <returns>True if the point was added</returns>
+	bool Add(float x, float y)
+	{
+		if (Count > 0 && hypotf(x - Points[Count - 1].X, y - Points[Count - 1].Y) < MinSpacing)
+		{
+			return false;
+		}
+		if (Count >= N)
+		{
+			Compress();
+		}
+		Points[Count++] = { x, y };
+		Added++;
+		return true;
+	}
+
+	uint16_t GetCount() const
+	{
+		return Count;
+	}
+
+	/// <param name="index">0 for the oldest point</param>
+	const TrailPoint& Get(uint16_t index) const
+	{
+		return Points[index];
+	}
+};
+
+#endif
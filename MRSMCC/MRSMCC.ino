@@ -24,6 +24,7 @@
 #define LocalWiFiPW "103187OS"
 
 #include <esp_now.h>
+#include <esp_wifi.h>
 
 uint8_t MRSRCCSSMS3MAC[] = { 0xF0, 0xF5, 0xBD, 0x48, 0x0A, 0x4C };
 esp_now_peer_info_t MRSRCCSSMInfo;
@@ -42,6 +43,7 @@ Task ToggleBuiltinLEDTask((NormalHeartbeatLEDToggleInterval* TASK_MILLISECOND),
 
 #include "src/MCCControls.h"
 #include "src/MCCSensors.h"
+#include "src/MCCMap.h"
 
 constexpr long ReadControlsInterval = 100;
 void ReadControlsCallback();
@@ -67,14 +69,80 @@ constexpr long UpdateSensorsInterval = 200;
 void UpdateSensorsCallback();
 Task UpdateSensorsTask((UpdateSensorsInterval* TASK_MILLISECOND), TASK_FOREVER, &UpdateSensorsCallback, &MainScheduler, false);
 
+// All I2C sensor reads are jobs dispatched by I2CBusManager, which is run by RunI2CBusTask:
+#include "src/I2CBusManager.h"
+constexpr long RunI2CBusInterval = 2;
+void RunI2CBusCallback();
+Task RunI2CBusTask((RunI2CBusInterval* TASK_MILLISECOND), TASK_FOREVER, &RunI2CBusCallback, &MainScheduler, false);
+
+constexpr uint32_t UpdateRangeInterval = 25;			// ms
+constexpr uint32_t UpdateRangeDeadline = 5;				// ms
+bool UpdateRangeJob();
+int UpdateRangeJobID = -1;
+
+constexpr uint32_t SampleBatteryInterval = 20;
+constexpr uint32_t SampleBatteryDeadline = 10;
+bool SampleBatteryJob();
+int SampleBatteryJobID = -1;
+
+constexpr uint32_t UpdateMRSSENInterval = 200;
+constexpr uint32_t UpdateMRSSENDeadline = 50;
+bool UpdateMRSSENJob();
+int UpdateMRSSENJobID = -1;
+
+constexpr uint32_t ServiceMRSSENCommandsInterval = 20;	// Queued commands are sent, and then confirmed, within this period
+constexpr uint32_t ServiceMRSSENCommandsDeadline = 20;
+bool ServiceMRSSENCommandsJob();
+int ServiceMRSSENCommandsJobID = -1;
+
+constexpr uint32_t UpdateEnvironmentInterval = 200;
+constexpr uint32_t UpdateEnvironmentDeadline = 200;
+bool UpdateEnvironmentJob();
+int UpdateEnvironmentJobID = -1;
+
+constexpr uint32_t UpdateScanInterval = 20;				// One polar scan chunk per run while a scan is pending
+constexpr uint32_t UpdateScanDeadline = 100;
+bool UpdateScanJob();
+int UpdateScanJobID = -1;
+
+// The MCC's esp_timer_get_time() is the shared clock; the MRS SEN module and the CSSM synchronise to it (see
+//ClockSync.h):
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\ClockSync.h"
+constexpr uint32_t SyncMRSSENClockDeadline = 500;
+bool SyncMRSSENClockJob();
+int SyncMRSSENClockJobID = -1;
+
+constexpr long ReplyTimeSyncInterval = 5;				// CSSM time sync requests are answered as soon as the radio is idle
+void ReplyTimeSyncCallback();
+Task ReplyTimeSyncTask((ReplyTimeSyncInterval* TASK_MILLISECOND), TASK_FOREVER, &ReplyTimeSyncCallback, &MainScheduler, false);
+
 constexpr long SendMRSSensorPacketInterval = 1000;
 void SendMRSSensorPacketCallback();
 Task SendMRSSensorPacketTask((SendMRSSensorPacketInterval* TASK_MILLISECOND), TASK_FOREVER, &SendMRSSensorPacketCallback, &MainScheduler, false);
 
+// Polar scan chunks and changed map tiles are forwarded to the CSSM one at a time, only while no other packet is
+//in flight:
+constexpr long ForwardMapDataInterval = 20;
+constexpr uint32_t MapDataSendGap = 10;					// ms since the last ESP-NOW send before map data may be sent
+constexpr uint32_t ESPNOWSendTimeout = 50;				// ms without a send callback before the send is taken as lost
+void ForwardMapDataCallback();
+Task ForwardMapDataTask((ForwardMapDataInterval* TASK_MILLISECOND), TASK_FOREVER, &ForwardMapDataCallback, &MainScheduler, false);
+
+// In WPT mode the navigator plans a path to the commanded waypoint on MCCMap and sets the speed and turn rate:
+#include "src/WaypointNavigator.h"
+constexpr long UpdateNavigatorInterval = 100;
+void UpdateNavigatorCallback();
+Task UpdateNavigatorTask((UpdateNavigatorInterval* TASK_MILLISECOND), TASK_FOREVER, &UpdateNavigatorCallback, &MainScheduler, false);
+
 #include "src/DEBUG Macros.h"
 #include "src/MCCStatus.h"
 #include "src/LocalDisplay.h"
 
+// This end's ESP-NOW link statistics, sent to the CSSM once per statistics window (see LinkMonitor.h):
+constexpr long SendLinkStatsInterval = LinkStatsWindow;
+void SendLinkStatsCallback();
+Task SendLinkStatsTask((SendLinkStatsInterval* TASK_MILLISECOND), TASK_FOREVER, &SendLinkStatsCallback, &MainScheduler, false);
+
 #include <I2CBus.h>
 
 
@@ -93,6 +161,7 @@ void setup()
 	}
 
 	_PL("");
+	MCCStatus.Init();
 
 	// Initialize LocalDisplay and show Debug page to provide information on progress initializing other components:
 	if (LocalDisplay.Init())
@@ -118,15 +187,24 @@ void setup()
 	//Wire.setClock(100000);
 	//End test code block
 
-	if (I2CBus.Init(GPIO_NUM_43, GPIO_NUM_44))
-	{
-		I2CBus.Scan();
-		_PL(I2CBus.GetActiveI2CAddressesString());
-	}
-	else
+	if (!I2CBus.Init(GPIO_NUM_43, GPIO_NUM_44))
 	{
 		_PL("Error initializing I2C bus...");
 	}
+
+	// Devices expected on the MCC I2C bus, with the fastest clock each supports; the seesaw encoders are polled
+	//outside I2CBusManager so they always see the base (standard mode) clock.  Only these addresses are probed at
+	//boot; the rest of the range is swept in the background once the I2C jobs are running:
+	I2CBusManager.Monitor.Init(&Wire, "MCC", I2CStandardModeClock);
+	int senDevice = I2CBusManager.Monitor.AddDevice("SEN", defaultMRSSENAddress, I2CBusMonitor::MRSSENDriver, I2CFastModeClock);
+	int ina219Device = I2CBusManager.Monitor.AddDevice("INA219", defaultINA219Address, I2CBusMonitor::INA219Driver, I2CFastModePlusClock);
+	I2CBusManager.Monitor.AddDevice("BME680", defaultBME680Address, I2CBusMonitor::BME680Driver, I2CFastModePlusClock);
+	I2CBusManager.Monitor.AddDevice("FncEnc", defaultFuncEncoderI2CAddress, I2CBusMonitor::SeesawDriver, I2CStandardModeClock);
+	I2CBusManager.Monitor.AddDevice("NavEnc", defaultNavEncoderI2CAddress, I2CBusMonitor::SeesawDriver, I2CStandardModeClock);
+	I2CBusManager.Monitor.ProbeDevices();
+	sprintf(buf, "I2C boot probe %lu us", I2CBusManager.Monitor.BootProbeTime);
+	_PL(buf);
+	_PL(I2CBusManager.Monitor.GetPresentAddressesString(MaxI2CMonitoredDevices));
 	LocalDisplay.ReportHeapStatus();
 
 	// Determine the channel used by local WiFi router so we can ensure compatibility 
@@ -191,6 +269,12 @@ void setup()
 		// Register OnDataReceived callback
 		esp_now_register_recv_cb(esp_now_recv_cb_t(OnMRSRCCSSMDataReceived));
 
+		// The ESP-NOW receive callback does not get the signal strength; catch the CSSM's frames in promiscuous mode
+		//(management frames only) to measure it:
+		wifi_promiscuous_filter_t filter = { .filter_mask = WIFI_PROMIS_FILTER_MASK_MGMT };
+		esp_wifi_set_promiscuous_filter(&filter);
+		esp_wifi_set_promiscuous_rx_cb(OnPromiscuousFrameReceived);
+		esp_wifi_set_promiscuous(true);
 	}
 
 	uint8_t mac[6];
@@ -209,9 +293,19 @@ void setup()
 	ReadButtonsTask.enable();
 	ReadControlsTask.enable();
 
+	// Register I2C jobs (enabled below according to which sensors initialized):
+	UpdateRangeJobID = I2CBusManager.AddJob("RNG", &UpdateRangeJob, I2CBusManagerClass::Safety, UpdateRangeInterval, UpdateRangeDeadline, senDevice);
+	SampleBatteryJobID = I2CBusManager.AddJob("BAT", &SampleBatteryJob, I2CBusManagerClass::Control, SampleBatteryInterval, SampleBatteryDeadline, ina219Device);
+	UpdateMRSSENJobID = I2CBusManager.AddJob("SEN", &UpdateMRSSENJob, I2CBusManagerClass::Control, UpdateMRSSENInterval, UpdateMRSSENDeadline, senDevice);
+	ServiceMRSSENCommandsJobID = I2CBusManager.AddJob("CMD", &ServiceMRSSENCommandsJob, I2CBusManagerClass::Control, ServiceMRSSENCommandsInterval, ServiceMRSSENCommandsDeadline, senDevice);
+	UpdateEnvironmentJobID = I2CBusManager.AddJob("ENV", &UpdateEnvironmentJob, I2CBusManagerClass::Environment, UpdateEnvironmentInterval, UpdateEnvironmentDeadline);
+	UpdateScanJobID = I2CBusManager.AddJob("SCN", &UpdateScanJob, I2CBusManagerClass::Environment, UpdateScanInterval, UpdateScanDeadline, senDevice);
+	SyncMRSSENClockJobID = I2CBusManager.AddJob("CLK", &SyncMRSSENClockJob, I2CBusManagerClass::Environment, ClockSyncInterval, SyncMRSSENClockDeadline, senDevice);
 	if (mccSensors.Init())
 	{
 		UpdateSensorsTask.enable();
+		I2CBusManager.EnableJob(SampleBatteryJobID);
+		I2CBusManager.EnableJob(UpdateEnvironmentJobID);
 		_PL("mccSensors initialized successfully")
 	}
 	else
@@ -220,6 +314,11 @@ void setup()
 		if (MCCStatus.WSUPS3SINA219Status || MCCStatus.BME680Status)
 		{
 			UpdateSensorsTask.enable();
+			I2CBusManager.EnableJob(UpdateEnvironmentJobID);
+			if (MCCStatus.WSUPS3SINA219Status)
+			{
+				I2CBusManager.EnableJob(SampleBatteryJobID);
+			}
 			_PL("mccSensors initialization incomplete")
 		}
 		else
@@ -227,6 +326,18 @@ void setup()
 			_PL("mccSensors initialization FAILED")
 		}
 	}
+	// Probe each device from its fastest clock down (a device that appears later is negotiated when it is found):
+	I2CBusManager.Monitor.NegotiateClocks();
+	_PL(I2CBusManager.Monitor.GetReport());
+	I2CBusManager.Monitor.StartBackgroundScan();
+
+	// The MRS SEN module may be powered up after the MCC; UpdateMRSSENJob re-tests the connection each period:
+	I2CBusManager.EnableJob(UpdateMRSSENJobID);
+	I2CBusManager.EnableJob(ServiceMRSSENCommandsJobID);
+	I2CBusManager.EnableJob(UpdateRangeJobID);
+	I2CBusManager.EnableJob(UpdateScanJobID);
+	I2CBusManager.EnableJob(SyncMRSSENClockJobID);
+	RunI2CBusTask.enable();
 
 	//TODO: Check whether it is necessary to call UpdateMotorControllerCallback() multiple times here to cycle through
 	//reading all of the MC status registers before proceeding:
@@ -242,6 +353,7 @@ void setup()
 		UpdateMotorControllerCallback();
 	}
 	UpdateMotorControllerTask.enable();
+	UpdateNavigatorTask.enable();
 
 	sprintf(buf, "CSSMDrivePacket: %d b", sizeof(CSSMDrivePacket));
 	MCCStatus.AddDebugTextLine(buf);
@@ -263,6 +375,20 @@ void setup()
 	MCCStatus.AddDebugTextLine(buf);
 	_PL(buf)
 
+#ifdef _TEST_
+	MCCMap.Benchmark();
+	WaypointNavigator.Benchmark();
+	for (uint32_t maxDelay : { 100, 2000, 10000 })
+	{
+		sprintf(buf, "ClkSync %lu us: %ld us", maxDelay, (long)ClockSyncClass::Simulate(50.0f, maxDelay, 120));
+		_PL(buf)
+	}
+	uint32_t addTime, queryTime;
+	TimeHistory<HistoryPose, MCCHistorySize>::Benchmark(addTime, queryTime);
+	sprintf(buf, "History %lu/%lu ns", addTime, queryTime);
+	_PL(buf)
+#endif // _TEST_
+
 	// Components initialzed; switch LocalDisplay to normal operation:
 	LocalDisplay.Control(LocalDisplayClass::Commands::SYSPage);
 	UpdateLocalDisplayTask.enable();
@@ -271,6 +397,9 @@ void setup()
 	{
 		SendRC2x15AMCStatusPacketTask.enable();
 		SendMRSSensorPacketTask.enable();
+		ForwardMapDataTask.enable();
+		ReplyTimeSyncTask.enable();
+		SendLinkStatsTask.enable();
 
 		// Set ESPNOWStatus to match initial setting of the ESP-NOW menu item used to enable / disable the telemetry stream from 
 		//the MCC to the MRS RC CSSM, which should be TRUE to start
@@ -314,26 +443,106 @@ void UpdateLocalDisplayCallback()
 
 void UpdateMotorControllerCallback()
 {
+	MCCStatus.RecordMotorTaskStart(UpdateMotorControllerInterval * 1000);
 	RC2x15AMC.Update();
 }
 
+void UpdateNavigatorCallback()
+{
+	// Navigate only to a waypoint the operator has entered, while the CSSM is still in contact and the pose is current
+	//(the drive packet time is read before millis() as the receive callback may update it meanwhile):
+	uint32_t lastDrivePacketTime = MCCStatus.LastDrivePacketTime;
+	uint32_t now = millis();
+	if (MCCStatus.cssmDrivePacket.DriveMode != CSSMDrivePacket::DriveModes::WPT || !MCCStatus.cssmDrivePacket.WaypointValid
+		|| now - lastDrivePacketTime > NavCSSMLinkTimeout || now - MCCStatus.MRSSENSnapshotTime > NavPoseTimeout)
+	{
+		if (WaypointNavigator.IsActive())
+		{
+			WaypointNavigator.Stop();
+		}
+		return;
+	}
+	WaypointNavigator.SetGoal(MCCStatus.cssmDrivePacket.WaypointX, MCCStatus.cssmDrivePacket.WaypointY,
+		MCCStatus.cssmDrivePacket.WaypointSequence);
+	WaypointNavigator.Update(MCCStatus.mrsSensorPacket.ODOSPosX, MCCStatus.mrsSensorPacket.ODOSPosY, MCCStatus.mrsSensorPacket.ODOSHdg);
+}
+
 void UpdateSensorsCallback()
 {
 	mccSensors.Update();
 }
 
+void RunI2CBusCallback()
+{
+	I2CBusManager.Run();
+}
+
+bool UpdateRangeJob()
+{
+	return mccSensors.UpdateRange();
+}
+
+bool SampleBatteryJob()
+{
+	return mccSensors.SampleBattery();
+}
+
+bool UpdateMRSSENJob()
+{
+	return mccSensors.UpdateMRSSEN();
+}
+
+bool ServiceMRSSENCommandsJob()
+{
+	return mccSensors.ServiceMRSSENCommands();
+}
+
+bool UpdateEnvironmentJob()
+{
+	return mccSensors.UpdateEnvironment();
+}
+
+bool UpdateScanJob()
+{
+	return mccSensors.UpdateScan();
+}
+
+bool SyncMRSSENClockJob()
+{
+	return mccSensors.SyncMRSSENClock();
+}
+
+/// <returns>True if no ESP-NOW send is waiting for its callback; one that has waited ESPNOWSendTimeout is given up
+/// on, as failed, so a lost callback cannot hold every sender off the radio for good</returns>
+bool IsESPNOWIdle()
+{
+	if (MCCStatus.ESPNOWSendInFlight && millis() - MCCStatus.LastESPNOWSendTime >= ESPNOWSendTimeout)
+	{
+		MCCStatus.ESPNOWSendInFlight = false;
+		if (MCCStatus.MapTileInFlight)
+		{
+			MCCStatus.MapTileInFlight = false;
+			MCCStatus.MapTileSendFailed = true;
+		}
+	}
+	return !MCCStatus.ESPNOWSendInFlight;
+}
+
 void SendMRSSensorPacketCallback()
 {
 	char buf2[64];
 
 	esp_err_t result = ESP_OK;
 
-	if (MCCStatus.ESPNOWStatus)
+	if (MCCStatus.ESPNOWStatus && IsESPNOWIdle())
 	{
+		MCCStatus.ESPNOWSendInFlight = true;
+		MCCStatus.LastESPNOWSendTime = millis();
 		result = esp_now_send(MRSRCCSSMS3MAC, (uint8_t*)&MCCStatus.mrsSensorPacket, sizeof(MCCStatus.mrsSensorPacket));
 
 		if (result != ESP_NOW_SEND_SUCCESS)
 		{
+			MCCStatus.ESPNOWSendInFlight = false;
 			sprintf(buf2, "Error sending MRSSensorPacket: %S", esp_err_to_name(result));
 			_PL(buf2)
 		}
@@ -347,12 +556,16 @@ void SendRC2x15AMCStatusPacketCallback()
 
 	esp_err_t result = ESP_OK;
 
-	if (MCCStatus.ESPNOWStatus)
+	if (MCCStatus.ESPNOWStatus && IsESPNOWIdle())
 	{
+		MCCStatus.ESPNOWSendInFlight = true;
+		MCCStatus.LastESPNOWSendTime = millis();
+		MCCStatus.mcStatus.LinkSequence++;
 		result = esp_now_send(MRSRCCSSMS3MAC, (uint8_t*)&MCCStatus.mcStatus, sizeof(MCCStatus.mcStatus));
 
 		if (result != ESP_NOW_SEND_SUCCESS)
 		{
+			MCCStatus.ESPNOWSendInFlight = false;
 			sprintf(buf2, "ESP-NOW send error: %S", esp_err_to_name(result));
 			_PL(buf2)
 		}
@@ -360,9 +573,118 @@ void SendRC2x15AMCStatusPacketCallback()
 	}
 }
 
+/// <summary>
+/// Sends the oldest queued polar scan chunk, or failing that the next changed map tile, if the radio is idle, so
+/// map traffic fills the gaps between the status and sensor packets rather than delaying them
+/// </summary>
+void ForwardMapDataCallback()
+{
+	if (!MCCStatus.ESPNOWStatus || !IsESPNOWIdle() || millis() - MCCStatus.LastESPNOWSendTime < MapDataSendGap)
+	{
+		return;
+	}
+
+	// A tile whose send failed is flagged for export again, rather than lost until one of its cells next changes:
+	if (MCCStatus.MapTileSendFailed)
+	{
+		MCCStatus.MapTileSendFailed = false;
+		MCCMap.ResendLastTile();
+	}
+
+	QueuedScanChunk entry;
+	OccupancyTilePacket tile;
+	uint8_t* data = nullptr;
+	size_t length = 0;
+	if (MCCStatus.ScanChunkQueue.Pop(entry))
+	{
+		uint32_t age = entry.Chunk.Age + (millis() - entry.ReceivedTime);
+		entry.Chunk.Age = min(age, (uint32_t)0xFFFF);
+		data = (uint8_t*)&entry.Chunk;
+		length = sizeof(entry.Chunk);
+	}
+	else if (MCCMap.ExportTile(tile))
+	{
+		data = (uint8_t*)&tile;
+		length = sizeof(tile);
+		MCCStatus.MapTileInFlight = true;
+	}
+	else
+	{
+		return;
+	}
+
+	MCCStatus.ESPNOWSendInFlight = true;
+	MCCStatus.LastESPNOWSendTime = millis();
+	if (esp_now_send(MRSRCCSSMS3MAC, data, length) == ESP_OK)
+	{
+		MCCStatus.MapPacketsForwarded++;
+	}
+	else
+	{
+		MCCStatus.ESPNOWSendInFlight = false;
+		MCCStatus.MapPacketsDropped++;
+		if (MCCStatus.MapTileInFlight)
+		{
+			MCCStatus.MapTileInFlight = false;
+			MCCMap.ResendLastTile();
+		}
+	}
+}
+
+/// <summary>
+/// Returns the oldest queued CSSM time sync request, stamped with its transmit time, as soon as the radio is idle;
+/// the request is stamped on receipt by OnMRSRCCSSMDataReceived()
+/// </summary>
+void ReplyTimeSyncCallback()
+{
+	if (!MCCStatus.ESPNOWStatus || !IsESPNOWIdle() || MCCStatus.TimeSyncQueue.GetCount() == 0)
+	{
+		return;
+	}
+
+	TimeSyncPacket packet;
+	MCCStatus.TimeSyncQueue.Pop(packet);
+	MCCStatus.ESPNOWSendInFlight = true;
+	MCCStatus.LastESPNOWSendTime = millis();
+	packet.TransmitTime = esp_timer_get_time();
+	if (esp_now_send(MRSRCCSSMS3MAC, (uint8_t*)&packet, sizeof(packet)) != ESP_OK)
+	{
+		MCCStatus.ESPNOWSendInFlight = false;
+	}
+}
+
+/// <summary>
+/// Sends this end's view of the ESP-NOW link to the CSSM, which shows it alongside its own; skipped for a window if
+/// the radio is busy
+/// </summary>
+void SendLinkStatsCallback()
+{
+	if (!MCCStatus.ESPNOWStatus || !IsESPNOWIdle())
+	{
+		return;
+	}
+
+	LinkStatsPacket packet;
+	MCCStatus.Link.GetStats(packet);
+	MCCStatus.ESPNOWSendInFlight = true;
+	MCCStatus.LastESPNOWSendTime = millis();
+	if (esp_now_send(MRSRCCSSMS3MAC, (uint8_t*)&packet, sizeof(packet)) != ESP_OK)
+	{
+		MCCStatus.ESPNOWSendInFlight = false;
+	}
+}
+
 void OnMRSRCCSSMDataSent(const uint8_t* mac_addr, esp_now_send_status_t status)
 {
 	bool result = (status == ESP_NOW_SEND_SUCCESS);
+	MCCStatus.ESPNOWSendInFlight = false;
+	MCCStatus.Link.RecordSend(result);
+	if (MCCStatus.MapTileInFlight)
+	{
+		// Runs in the Wi-Fi task; the tile is flagged again by ForwardMapDataCallback(), which owns the map
+		MCCStatus.MapTileInFlight = false;
+		MCCStatus.MapTileSendFailed = !result;
+	}
 	//MCCStatus.ESPNOWStatus = (status == ESP_NOW_SEND_SUCCESS);
 	if (result)
 	{
@@ -378,14 +700,18 @@ void OnMRSRCCSSMDataSent(const uint8_t* mac_addr, esp_now_send_status_t status)
 
 void OnMRSRCCSSMDataReceived(const uint8_t* mac, const uint8_t* data, int lenght)
 {
+	int64_t receiveTime = esp_timer_get_time();
 	char buf[64];
 	CSSMCommandPacket cp;
+	TimeSyncPacket tp;
 	bool success = false;
 	
 	switch (data[0])
 	{
 	case 0x20:	// CSSMDrivePacket
 		memcpy(&(MCCStatus.cssmDrivePacket), data, sizeof(MCCStatus.cssmDrivePacket));
+		MCCStatus.LastDrivePacketTime = millis();
+		MCCStatus.Link.RecordReceived(MCCStatus.cssmDrivePacket.LinkSequence, (uint32_t)receiveTime);
 		break;
 	case 0x24:	// CSSMCommandPacket
 		memcpy(&cp, data, sizeof(cp));
@@ -404,24 +730,42 @@ void OnMRSRCCSSMDataReceived(const uint8_t* mac, const uint8_t* data, int lenght
 			cp.command = CSSMCommandPacket::CSSMCommandCodes::SetTurretPosition;
 			//cp.turretPosition = 800;
 
-			Wire.beginTransmission(defaultMRSSENAddress);
-			size_t bytesWritten = Wire.write((uint8_t*)&cp, sizeof(CSSMCommandPacket));
-			Wire.endTransmission();
-
-			if (bytesWritten != sizeof(CSSMCommandPacket))
+			if (!mccSensors.SendMRSSENCommand(cp))
 			{
-				//_PL("MRS Sensors I2C write FAILED")
+				//_PL("MRS Sensors command queue full")
 				success = false;
 			}
 			else
 			{
-				sprintf(buf, "Sent SetTurretPosition %d (%db)", cp.turretPosition, bytesWritten);
+				sprintf(buf, "Queued SetTurretPosition %d", cp.turretPosition);
 				_PL(buf)
 				success = true;
 			}
 
 			//return success;
 		}
+		else if (cp.command == CSSMCommandPacket::StartTurretScan || cp.command == CSSMCommandPacket::StopTurretScan
+			|| cp.command == CSSMCommandPacket::SetTurretScanPattern || cp.command == CSSMCommandPacket::HomeTurret
+			|| cp.command == CSSMCommandPacket::ConfigureFwdRanging || cp.command == CSSMCommandPacket::SetTurretAutoRehome)
+		{
+			success = mccSensors.SendMRSSENCommand(cp);
+		}
+		break;
+	case 0x35:	// TimeSyncPacket
+		if (lenght == sizeof(TimeSyncPacket))
+		{
+			memcpy(&tp, data, sizeof(tp));
+			tp.ReceiveTime = receiveTime;
+			MCCStatus.CSSMClockResidual = tp.ResidualOffset;
+			MCCStatus.TimeSyncQueue.Push(tp);
+		}
+		break;
+	case 0x36:	// LinkStatsPacket
+		if (lenght == sizeof(LinkStatsPacket))
+		{
+			memcpy(&(MCCStatus.CSSMLinkStats), data, sizeof(MCCStatus.CSSMLinkStats));
+			MCCStatus.CSSMLinkStatsReceivedCount++;
+		}
 		break;
 	default:
 		break;
@@ -431,4 +775,23 @@ void OnMRSRCCSSMDataReceived(const uint8_t* mac, const uint8_t* data, int lenght
 	MCCStatus.CSSMPacketReceiptInterval = receiptTime - MCCStatus.LastCSSMPacketReceivedTime;
 	MCCStatus.LastCSSMPacketReceivedTime = receiptTime;
 
+}
+
+/// <summary>
+/// Passes the signal strength of ESP-NOW frames (vendor specific action frames) from the CSSM to the link monitor
+/// </summary>
+void OnPromiscuousFrameReceived(void* buf, wifi_promiscuous_pkt_type_t type)
+{
+	if (type != WIFI_PKT_MGMT)
+	{
+		return;
+	}
+
+	const wifi_promiscuous_pkt_t* pkt = (const wifi_promiscuous_pkt_t*)buf;
+	const uint8_t* frame = pkt->payload;
+	if (pkt->rx_ctrl.sig_len > 24 && frame[0] == 0xD0 && frame[24] == 127
+		&& memcmp(frame + 10, MRSRCCSSMS3MAC, 6) == 0)
+	{
+		MCCStatus.Link.RecordRSSI(pkt->rx_ctrl.rssi);
+	}
 }
\ No newline at end of file
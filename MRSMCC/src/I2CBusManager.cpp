@@ -0,0 +1,263 @@
+/*	I2CBusManager.cpp
+*	I2CBusManagerClass - Schedules all transactions on the MCC I2C bus (Wire)
+*
+*/
+
+#include "I2CBusManager.h"
+
+/// <summary>
+/// Registers a periodic job; jobs are created disabled, like scheduler tasks
+/// </summary>
+/// <param name="name">Short name for diagnostics</param>
+/// <param name="callback">Performs the job's transactions; returns false on a bus error</param>
+/// <param name="priority">Dispatch priority</param>
+/// <param name="period">ms</param>
+/// <param name="deadline">ms after release; a later start is counted as a deadline miss</param>
+/// <param name="device">Monitor device handle (see I2CBusMonitor::AddDevice())</param>
+/// <returns>Job handle, or -1 if the job table is full</returns>
+int I2CBusManagerClass::AddJob(const char* name, I2CJobCallback callback, Priorities priority, uint32_t period, uint32_t deadline, int device)
+{
+	if (JobCount >= MaxI2CJobs)
+	{
+		return -1;
+	}
+
+	I2CJob& job = Jobs[JobCount];
+	job.Name = name;
+	job.Callback = callback;
+	job.Priority = priority;
+	job.Period = period;
+	job.Deadline = deadline;
+	job.Device = device;
+	job.Enabled = false;
+
+	return JobCount++;
+}
+
+void I2CBusManagerClass::EnableJob(int job, bool enable)
+{
+	if (job < 0 || job >= JobCount)
+	{
+		return;
+	}
+	Jobs[job].Enabled = enable;
+	Jobs[job].NextRelease = millis();
+	Jobs[job].Retries = 0;
+}
+
+const I2CBusManagerClass::I2CJob* I2CBusManagerClass::GetJob(int job)
+{
+	if (job < 0 || job >= JobCount)
+	{
+		return nullptr;
+	}
+	return &Jobs[job];
+}
+
+uint8_t I2CBusManagerClass::GetJobCount()
+{
+	return JobCount;
+}
+
+/// <summary>
+/// Queues a write for execution by Run(); safe to call from other tasks (e.g. the ESP-NOW receive callback)
+/// </summary>
+/// <returns>False if the data is too long or the queue is full</returns>
+bool I2CBusManagerClass::QueueWrite(uint8_t address, const uint8_t* data, uint8_t length, Priorities priority, uint32_t deadline)
+{
+	if (length > MaxI2CWriteLength)
+	{
+		return false;
+	}
+
+	bool queued = false;
+	portENTER_CRITICAL(&QueueMux);
+	if (QueuedWriteCount < MaxI2CQueuedWrites)
+	{
+		I2CWriteRequest& request = QueuedWrites[QueuedWriteCount];
+		request.Address = address;
+		request.Length = length;
+		memcpy(request.Data, data, length);
+		request.Priority = priority;
+		request.Deadline = millis() + deadline;
+		QueuedWriteCount++;
+		WritesQueued++;
+		queued = true;
+	}
+	else
+	{
+		WritesDropped++;
+	}
+	portEXIT_CRITICAL(&QueueMux);
+
+	return queued;
+}
+
+bool I2CBusManagerClass::ExecuteWrite(I2CWriteRequest& request)
+{
+	int device = Monitor.FindDevice(request.Address);
+	bool success = false;
+
+	for (uint8_t attempt = 0; attempt <= defaultI2CMaxRetries && !success; attempt++)
+	{
+		if (attempt > 0)
+		{
+			RetryCount++;
+		}
+		uint32_t startTime = micros();
+		Monitor.Select(device);
+		Wire.beginTransmission(request.Address);
+		Wire.write(request.Data, request.Length);
+		success = (Wire.endTransmission() == 0x00);
+		Monitor.Deselect();
+		Monitor.Record(device, 1 + request.Length, 1, micros() - startTime, success);
+	}
+	if (!success)
+	{
+		ErrorCount++;
+	}
+	return success;
+}
+
+void I2CBusManagerClass::AddBusyTime(uint32_t duration)
+{
+	BusyTime += duration;
+}
+
+/// <summary>
+/// Dispatches ready jobs and queued writes, most urgent first, until none are ready or the run budget is used up;
+/// call from a fast scheduler task in the main loop
+/// </summary>
+void I2CBusManagerClass::Run()
+{
+	uint32_t runStartTime = micros();
+
+	do
+	{
+		uint32_t now = millis();
+
+		// Most urgent queued write (the queue is only appended to elsewhere, so the index stays valid):
+		int bestWrite = -1;
+		Priorities writePriority = PriorityCount;
+		uint32_t writeDeadline = 0;
+		portENTER_CRITICAL(&QueueMux);
+		for (uint8_t i = 0; i < QueuedWriteCount; i++)
+		{
+			if (bestWrite < 0 || QueuedWrites[i].Priority < writePriority ||
+				(QueuedWrites[i].Priority == writePriority && (int32_t)(QueuedWrites[i].Deadline - writeDeadline) < 0))
+			{
+				bestWrite = i;
+				writePriority = QueuedWrites[i].Priority;
+				writeDeadline = QueuedWrites[i].Deadline;
+			}
+		}
+		portEXIT_CRITICAL(&QueueMux);
+
+		// Most urgent released job:
+		int bestJob = -1;
+		Priorities jobPriority = PriorityCount;
+		uint32_t jobDeadline = 0;
+		for (uint8_t i = 0; i < JobCount; i++)
+		{
+			I2CJob& job = Jobs[i];
+			if (!job.Enabled || (int32_t)(now - job.NextRelease) < 0)
+			{
+				continue;
+			}
+			uint32_t deadline = job.NextRelease + job.Deadline;
+			if (bestJob < 0 || job.Priority < jobPriority ||
+				(job.Priority == jobPriority && (int32_t)(deadline - jobDeadline) < 0))
+			{
+				bestJob = i;
+				jobPriority = job.Priority;
+				jobDeadline = deadline;
+			}
+		}
+
+		if (bestWrite < 0 && bestJob < 0)
+		{
+			break;
+		}
+
+		uint32_t startTime = micros();
+		if (bestWrite >= 0 && (bestJob < 0 || writePriority < jobPriority ||
+			(writePriority == jobPriority && (int32_t)(writeDeadline - jobDeadline) <= 0)))
+		{
+			I2CWriteRequest request;
+			portENTER_CRITICAL(&QueueMux);
+			request = QueuedWrites[bestWrite];
+			for (uint8_t i = bestWrite; i + 1 < QueuedWriteCount; i++)
+			{
+				QueuedWrites[i] = QueuedWrites[i + 1];
+			}
+			QueuedWriteCount--;
+			portEXIT_CRITICAL(&QueueMux);
+
+			if ((int32_t)(now - request.Deadline) > 0)
+			{
+				DeadlineMisses++;
+			}
+			ExecuteWrite(request);
+			AddBusyTime(micros() - startTime);
+		}
+		else
+		{
+			I2CJob& job = Jobs[bestJob];
+			if ((int32_t)(now - jobDeadline) > 0 && job.Retries == 0)
+			{
+				job.DeadlineMisses++;
+				DeadlineMisses++;
+			}
+
+			Monitor.Select(job.Device);
+			bool success = job.Callback();
+			Monitor.Deselect();
+
+			job.LastDuration = micros() - startTime;
+			Monitor.Record(job.Device, 0, 0, job.LastDuration, success);
+			if (job.LastDuration > job.MaxDuration)
+			{
+				job.MaxDuration = job.LastDuration;
+			}
+			AddBusyTime(job.LastDuration);
+			job.RunCount++;
+
+			if (!success && job.Retries < defaultI2CMaxRetries)
+			{
+				// Leave the job released so it is retried straight away:
+				job.Retries++;
+				RetryCount++;
+			}
+			else
+			{
+				if (!success)
+				{
+					job.ErrorCount++;
+					ErrorCount++;
+				}
+				job.Retries = 0;
+				job.NextRelease += job.Period;
+				if ((int32_t)(now - job.NextRelease) >= 0)
+				{
+					job.NextRelease = now + job.Period;		// Overran; don't try to catch up
+				}
+			}
+		}
+	} while (micros() - runStartTime < defaultI2CRunBudget);
+
+	uint32_t now = millis();
+	uint32_t windowLength = now - WindowStartTime;
+	if (windowLength >= I2CStatsWindow)
+	{
+		Utilisation = constrain(BusyTime / (windowLength * 10), 0, 100);
+		BusyTime = 0;
+		WindowStartTime = now;
+	}
+	Monitor.Update();
+
+	// Presence probes and background scanning only while no job is running:
+	Monitor.Poll();
+}
+
+
+I2CBusManagerClass I2CBusManager;
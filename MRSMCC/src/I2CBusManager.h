@@ -0,0 +1,120 @@
+/*	I2CBusManager.h
+*	I2CBusManagerClass - Schedules all transactions on the MCC I2C bus (Wire)
+*
+*	Sensor reads are registered as periodic jobs with a priority and a deadline; Run() is called from a fast
+*	scheduler task and dispatches ready jobs highest priority first (earliest deadline first within a priority),
+*	so a safety read such as the forward range is never stuck behind environmental sensing.  Jobs are not
+*	preempted once started.
+*
+*	Code running outside the main loop task (e.g. the ESP-NOW receive callback, which runs in the WiFi task) must
+*	not touch Wire directly; it queues a write with QueueWrite(), which Run() executes with retries.
+*
+*	Each job may name the device it talks to; Monitor then selects that device's negotiated clock for the job and
+*	profiles the device's bus time (see I2CBusMonitor.h).
+*
+*	Mitchell Baldwin copyright 2025
+*
+*	v 0.00:	Initial data structure
+*	v
+*
+*/
+
+#ifndef _I2CBusManager_h
+#define _I2CBusManager_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+#include <Wire.h>
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\I2CBusMonitor.h"
+
+constexpr uint8_t MaxI2CJobs = 8;
+constexpr uint8_t MaxI2CQueuedWrites = 8;
+constexpr uint8_t MaxI2CWriteLength = 16;				// bytes
+constexpr uint8_t defaultI2CMaxRetries = 2;
+constexpr uint32_t defaultI2CRunBudget = 5000;			// us; Run() starts no new transaction after this long
+constexpr uint32_t I2CStatsWindow = 1000;				// ms; utilisation is measured over this window
+
+typedef bool (*I2CJobCallback)();						// Performs a complete set of transactions; false on a bus error
+
+class I2CBusManagerClass
+{
+public:
+	enum Priorities
+	{
+		Safety = 0,										// Collision avoidance (e.g. forward range)
+		Control = 1,									// Closed loop control and commands
+		Operator = 2,									// Operator interface
+		Environment = 3,								// Housekeeping / environmental sensing
+
+		PriorityCount
+	};
+
+	struct I2CJob
+	{
+		const char* Name = nullptr;
+		I2CJobCallback Callback = nullptr;
+		Priorities Priority = Environment;
+		int Device = -1;								// Monitor device handle; -1 if the job uses several devices
+		uint32_t Period = 0;							// ms
+		uint32_t Deadline = 0;							// ms after release
+		uint32_t NextRelease = 0;						// ms
+		uint8_t Retries = 0;							// Consecutive failed attempts
+		bool Enabled = false;
+
+		uint32_t RunCount = 0;
+		uint32_t ErrorCount = 0;						// Runs that still failed after all retries
+		uint32_t DeadlineMisses = 0;
+		uint32_t LastDuration = 0;						// us
+		uint32_t MaxDuration = 0;						// us
+	};
+
+	struct I2CWriteRequest
+	{
+		uint8_t Address = 0;
+		uint8_t Length = 0;
+		uint8_t Data[MaxI2CWriteLength];
+		Priorities Priority = Control;
+		uint32_t Deadline = 0;							// millis() by which the write should have been sent
+	};
+
+protected:
+	I2CJob Jobs[MaxI2CJobs];
+	uint8_t JobCount = 0;
+
+	I2CWriteRequest QueuedWrites[MaxI2CQueuedWrites];
+	uint8_t QueuedWriteCount = 0;
+	portMUX_TYPE QueueMux = portMUX_INITIALIZER_UNLOCKED;
+
+	uint32_t BusyTime = 0;								// us spent in transactions in the current window
+	uint32_t WindowStartTime = 0;						// ms
+
+	bool ExecuteWrite(I2CWriteRequest& request);
+	void AddBusyTime(uint32_t duration);
+
+public:
+	I2CBusMonitor Monitor;								// Per device clock selection and profiling
+
+	uint8_t Utilisation = 0;							// %; bus busy time over the last stats window
+	uint32_t RetryCount = 0;
+	uint32_t ErrorCount = 0;
+	uint32_t DeadlineMisses = 0;
+	uint32_t WritesQueued = 0;
+	uint32_t WritesDropped = 0;							// Queue full
+
+	int AddJob(const char* name, I2CJobCallback callback, Priorities priority, uint32_t period, uint32_t deadline, int device = -1);
+	void EnableJob(int job, bool enable = true);
+	const I2CJob* GetJob(int job);
+	uint8_t GetJobCount();
+
+	bool QueueWrite(uint8_t address, const uint8_t* data, uint8_t length, Priorities priority, uint32_t deadline);
+	void Run();
+
+};
+
+extern I2CBusManagerClass I2CBusManager;
+
+#endif
@@ -123,9 +123,11 @@ public:
   float getCurrent_mA();
   float getPower_mW();
   void powerSave(bool on);
+  bool success();
 
 private:
   TwoWire *_i2c;
+  bool _success = false;
 
   uint8_t ina219_i2caddr;
   uint32_t ina219_calValue;
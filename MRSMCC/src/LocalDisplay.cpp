@@ -5,7 +5,7 @@
 */
 
 #include "LocalDisplay.h"
-#include <I2CBus.h>
+#include "I2CBusManager.h"
 #include "MCCStatus.h"
 #include "MCCControls.h"
 #include "MCCSensors.h"
@@ -16,23 +16,29 @@
 
 void LocalDisplayClass::DrawPageHeaderAndFooter()
 {
-	// Clear display:
-	tft.fillScreen(TFT_BLACK);
+	// Clear display, a band of rows per step so that clearing does not take a whole render budget by itself:
+	for (int32_t y = 0; y < tft.height(); y += ClearBandHeight)
+	{
+		if (Step())
+		{
+			tft.fillRect(0, y, tft.width(), min(ClearBandHeight, tft.height() - y), TFT_BLACK);
+		}
+	}
 
 	// Draw header:
 	tft.setTextSize(1);
 	tft.setTextColor(TFT_BLUE, TFT_BLACK, false);
 	tft.setTextDatum(TL_DATUM);
-	tft.drawString("MRS MCC", 2, 2);
+	DrawString("MRS MCC", 2, 2);
 	sprintf(buf, "v%d.%d", MCCStatus.MajorVersion, MCCStatus.MinorVersion);
-	tft.drawString(buf, 2, 12);
+	DrawString(buf, 2, 12);
 
 	tft.setTextDatum(TR_DATUM);
 	sprintf(buf, "%s", PageTitles[currentPage]);
-	tft.drawString(buf, tft.width() - 2, 2);
+	DrawString(buf, tft.width() - 2, 2);
 
 	// Draw footer menu:
-	if (mccControls.MainMenu != nullptr)
+	if (mccControls.MainMenu != nullptr && Step())
 	{
 		mccControls.MainMenu->Draw();
 	}
@@ -52,37 +58,35 @@ void LocalDisplayClass::DrawSYSPage()
 		tft.setTextColor(TFT_LIGHTGREY);
 		tft.setTextDatum(CL_DATUM);
 		sprintf(buf, "UART0 %s", MCCStatus.UART0Status ? "OK" : "NO");
-		tft.drawString(buf, 2, 30);
+		DrawString(buf, 2, 30);
 
 		tft.setTextDatum(CR_DATUM);
 		sprintf(buf, "RC2x15AUART %s", MCCStatus.RC2x15AUARTStatus ? "OK" : "NO");
-		tft.drawString(buf, tft.width() / 2 - 2, 30);
+		DrawString(buf, tft.width() / 2 - 2, 30);
 
 		tft.setTextColor(TFT_PINK);
 		tft.setTextDatum(CL_DATUM);
-		tft.drawString(ComModeHeadings[MCCStatus.ComMode], 2, 40);
+		DrawString(ComModeHeadings[MCCStatus.ComMode], 2, 40);
 
 		tft.setTextColor(TFT_ORANGE);
 		sprintf(buf, "WiFi %s", MCCStatus.WiFiStatus ? "OK" : "NO");
-		tft.drawString(buf, 2, 50);
+		DrawString(buf, 2, 50);
 
 		tft.setTextColor(TFT_GREEN);
 		tft.setTextDatum(CL_DATUM);
-		sprintf(buf, "IP: %s", WiFi.localIP().toString());
-		tft.drawString(buf, 50, 50);
+		sprintf(buf, "IP: %s", WiFi.localIP().toString().c_str());
+		DrawString(buf, 50, 50);
 
 		tft.setTextColor(TFT_GREENYELLOW);
 		tft.setTextDatum(CR_DATUM);
 		uint8_t mac[6];
 		WiFi.macAddress(mac);
 		sprintf(buf, "MAC:%02X:%02X:%02X:%02X:%02X:%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
-		tft.drawString(buf, tft.width() - 2, 50);
+		DrawString(buf, tft.width() - 2, 50);
 
 		tft.setTextColor(TFT_CYAN);
 		tft.setTextDatum(CL_DATUM);
-		tft.drawString(I2CBus.Get1st6ActiveI2CAddressesString(), 2, tft.height() / 2 + 50);
-
-		lastPage = currentPage;
+		DrawString(I2CBusManager.Monitor.GetPresentAddressesString(), 2, tft.height() / 2 + 50);
 	}
 
 	// Update dynamic displays:
@@ -90,12 +94,12 @@ void LocalDisplayClass::DrawSYSPage()
 	tft.setTextColor(TFT_LIGHTGREY, TFT_BLACK, true);
 	tft.setTextDatum(CC_DATUM);
 	sprintf(buf, "%5d ms", MCCStatus.CSSMPacketReceiptInterval);
-	tft.drawString(buf, tft.width() / 2, 40);
+	DrawString(buf, tft.width() / 2, 40);
 
 	tft.setTextColor(TFT_PINK, TFT_BLACK, true);
 	tft.setTextDatum(CR_DATUM);
 	sprintf(buf, "%s %s", "CSSM Uplink ", MCCStatus.CSSMESPNOWLinkStatus ? "OK" : "NO");
-	tft.drawString(buf, tft.width() - 2, 40);
+	DrawString(buf, tft.width() - 2, 40);
 
 	tft.setTextDatum(CL_DATUM);
 	int16_t cursorY = tft.height() / 2 - 20;
@@ -144,41 +148,41 @@ void LocalDisplayClass::DrawSYSPage()
 	default:
 			break;
 	}
-	tft.drawString(buf, 2, cursorY);
+	DrawString(buf, 2, cursorY);
 
 	//tft.drawString(MCCStatus.IncomingCSSMPacketMACString, 2, 70);
 
 	// Display status of motor controller
 	cursorY += 10;
 	tft.setTextColor(TFT_GOLD, TFT_BLACK, true);
-	tft.drawString("RC2x15AMC", 2, cursorY);
+	DrawString("RC2x15AMC", 2, cursorY);
 	int16_t cursorX = tft.textWidth("RC2x15AMC") + 20;
 	if (MCCStatus.RC2x15AMCStatus)
 	{
 		tft.setTextColor(TFT_GREEN, TFT_BLACK, true);
 		sprintf(buf, "Power ON    ");
-		tft.drawString(buf, cursorX, cursorY);
+		DrawString(buf, cursorX, cursorY);
 		
 	}
 	else
 	{
 		tft.setTextColor(TFT_RED, TFT_BLACK, true);
 		sprintf(buf, "Power OFF   ");
-		tft.drawString(buf, cursorX, cursorY);
+		DrawString(buf, cursorX, cursorY);
 	}
 	cursorX = tft.width() / 2;
 	if (MCCStatus.RC2x15AUARTStatus)
 	{
 		tft.setTextColor(TFT_GREEN, TFT_BLACK, true);
 		sprintf(buf, "Connected   ");
-		tft.drawString(buf, cursorX, cursorY);
+		DrawString(buf, cursorX, cursorY);
 		
 	}
 	else
 	{
 		tft.setTextColor(TFT_RED, TFT_BLACK, true);
 		sprintf(buf, "Disconnected");
-		tft.drawString(buf, cursorX, cursorY);
+		DrawString(buf, cursorX, cursorY);
 	}
 
 	// Two ways to display the  character: as a string (%s) or as a char (%c)
@@ -193,7 +197,7 @@ void LocalDisplayClass::DrawSYSPage()
 	{
 		sprintf(buf, "Vbat: ----  T2: ----%cC  T1: ----%cC", 0xF7, 0xF7);
 	}
-	tft.drawString(buf, 2, cursorY);
+	DrawString(buf, 2, cursorY);
 		
 	cursorY += 10;
 	if (MCCStatus.mcStatus.ENCPOSValid)
@@ -204,7 +208,7 @@ void LocalDisplayClass::DrawSYSPage()
 	{
 		sprintf(buf, "POS:            -            - qp");
 	}
-	tft.drawString(buf, 2, cursorY);
+	DrawString(buf, 2, cursorY);
 
 	cursorY += 10;
 	if (MCCStatus.mcStatus.SPEEDSValid)
@@ -215,7 +219,7 @@ void LocalDisplayClass::DrawSYSPage()
 	{
 		sprintf(buf, "SPD:     -(    -)     -(    -) qpps");
 	}
-	tft.drawString(buf, 2, cursorY);
+	DrawString(buf, 2, cursorY);
 
 	cursorY += 10;
 	if (MCCStatus.mcStatus.IMOTValid)
@@ -226,22 +230,22 @@ void LocalDisplayClass::DrawSYSPage()
 	{
 		sprintf(buf, "Cur:            -            - A");
 	}
-	tft.drawString(buf, 2, cursorY);
+	DrawString(buf, 2, cursorY);
 
 	cursorY = tft.height() / 2 + 50;
 	tft.setTextColor(TFT_SILVER, TFT_BLACK, true);
-	sprintf(buf, "VMCU %s", mccSensors.GetMCUVoltageString());
-	tft.drawString(buf, tft.width() / 2, cursorY);
+	sprintf(buf, "VMCU %s", mccSensors.GetMCUVoltageString().c_str());
+	DrawString(buf, tft.width() / 2, cursorY);
 
 	// Display rotary encoder settings:
 	tft.setTextDatum(TL_DATUM);
 	tft.setTextSize(1);
 	tft.setTextColor(TFT_CYAN, TFT_BLACK, true);
 	sprintf(buf, "%04D", mccControls.NavSetting);
-	tft.drawString(buf, 2, 147);
+	DrawString(buf, 2, 147);
 	tft.setTextDatum(TR_DATUM);
 	sprintf(buf, "%04D", mccControls.FuncSetting);
-	tft.drawString(buf, tft.width() - 2, 147);
+	DrawString(buf, tft.width() - 2, 147);
 
 }
 
@@ -263,44 +267,50 @@ void LocalDisplayClass::DrawPOWPage()
 		tft.setTextDatum(BL_DATUM);
 		tft.setTextSize(2);
 		cursorX = 2;
-		tft.drawString("V", cursorX, cursorY);
+		DrawString("V", cursorX, cursorY);
 		cursorX += tft.textWidth("V", 2) + 1;
 		tft.setTextSize(1);
-		tft.drawString("MCU", cursorX, cursorY);	// Subscript
+		DrawString("MCU", cursorX, cursorY);	// Subscript
 
 		tft.setTextSize(2);
 		cursorX = 2;
 		cursorY -= 20;
-		tft.drawString("P", cursorX, cursorY);
+		DrawString("P", cursorX, cursorY);
 		cursorX += tft.textWidth("P", 2) + 1;
 		tft.setTextSize(1);
-		tft.drawString("Bus", cursorX, cursorY);	// Subscript
+		DrawString("Bus", cursorX, cursorY);	// Subscript
 
 		tft.setTextSize(2);
 		cursorX = 2;
 		cursorY -= 20;
-		tft.drawString("I", cursorX, cursorY);
+		DrawString("I", cursorX, cursorY);
 		cursorX += tft.textWidth("I", 2) + 1;
 		tft.setTextSize(1);
-		tft.drawString("Bus", cursorX, cursorY);	// Subscript
+		DrawString("Bus", cursorX, cursorY);	// Subscript
 
 		tft.setTextSize(2);
 		cursorX = 2;
 		cursorY -= 20;
-		tft.drawString("V", cursorX, cursorY);
+		DrawString("V", cursorX, cursorY);
 		cursorX += tft.textWidth("V", 2) + 1;
 		tft.setTextSize(1);
-		tft.drawString("Bus", cursorX, cursorY);	// Subscript
+		DrawString("Bus", cursorX, cursorY);	// Subscript
 
 		tft.setTextSize(2);
 		cursorX = 2;
 		cursorY -= 20;
-		tft.drawString("V", cursorX, cursorY);
+		DrawString("V", cursorX, cursorY);
 		cursorX += tft.textWidth("V", 2) + 1;
 		tft.setTextSize(1);
-		tft.drawString("BBat", cursorX, cursorY);	// Subscript
+		DrawString("BBat", cursorX, cursorY);	// Subscript
 
-		lastPage = currentPage;
+		tft.setTextSize(2);
+		cursorX = 2;
+		cursorY -= 20;
+		DrawString("Q", cursorX, cursorY);
+		cursorX += tft.textWidth("Q", 2) + 1;
+		tft.setTextSize(1);
+		DrawString("SOC", cursorX, cursorY);	// Subscript
 	}
 
 	// Update dynamic displays:
@@ -311,37 +321,66 @@ void LocalDisplayClass::DrawPOWPage()
 	tft.setTextSize(2);
 	tft.setTextDatum(BR_DATUM);
 	sprintf(buf, "%5.2F  V", mccSensors.GetMCUVoltageReal());
-	tft.drawString(buf, cursorX, cursorY);	// Right justified
+	DrawString(buf, cursorX, cursorY);	// Right justified
 
 	cursorY -= 20;
 	sprintf(buf, "%5.0F mW", MCCStatus.mrsSensorPacket.INA219Power);
-	tft.drawString(buf, cursorX, cursorY);	// Right justified
+	DrawString(buf, cursorX, cursorY);	// Right justified
 
 	cursorY -= 20;
 	sprintf(buf, "%5.1F mA", MCCStatus.mrsSensorPacket.INA219Current);
-	tft.drawString(buf, cursorX, cursorY);	// Right justified
+	DrawString(buf, cursorX, cursorY);	// Right justified
 
 	cursorY -= 20;
 	sprintf(buf, "%5.2F  V", MCCStatus.mrsSensorPacket.INA219VBus);
-	tft.drawString(buf, cursorX, cursorY);	// Right justified
+	DrawString(buf, cursorX, cursorY);	// Right justified
 
 	cursorY -= 20;
 	sprintf(buf, "%5.2F  V", mccSensors.GetBBAKVoltageReal());
-	tft.drawString(buf, cursorX, cursorY);	// Right justified
+	DrawString(buf, cursorX, cursorY);	// Right justified
+
+	// State of charge and estimated runtime remaining, turning red when low:
+	cursorY -= 20;
+	bool lowBattery = (MCCStatus.mrsSensorPacket.INA219SOC < LowBatterySOCThreshold)
+		|| (MCCStatus.mrsSensorPacket.INA219Runtime >= 0.0f && MCCStatus.mrsSensorPacket.INA219Runtime < LowBatteryRuntimeThreshold);
+	tft.setTextColor(lowBattery ? TFT_RED : TFT_PINK, TFT_BLACK, true);
+	if (MCCStatus.mrsSensorPacket.INA219Runtime < 0.0f)
+	{
+		sprintf(buf, "%3.0F%% ---m", MCCStatus.mrsSensorPacket.INA219SOC);
+	}
+	else
+	{
+		sprintf(buf, "%3.0F%% %3.0Fm", MCCStatus.mrsSensorPacket.INA219SOC, MCCStatus.mrsSensorPacket.INA219Runtime);
+	}
+	DrawString(buf, cursorX, cursorY);	// Right justified
 
 	cursorX = tft.width() - 2;
 	cursorY = tft.height() - 40;
 	tft.setTextColor(TFT_GREENYELLOW, TFT_BLACK, true);
 	sprintf(buf, "%5.0F mW", MCCStatus.mrsSensorPacket.RINA219Power);
-	tft.drawString(buf, cursorX, cursorY);	// Right justified
+	DrawString(buf, cursorX, cursorY);	// Right justified
 
 	cursorY -= 20;
 	sprintf(buf, "%5.1F mA", MCCStatus.mrsSensorPacket.RINA219Current);
-	tft.drawString(buf, cursorX, cursorY);	// Right justified
+	DrawString(buf, cursorX, cursorY);	// Right justified
 
 	cursorY -= 20;
 	sprintf(buf, "%5.2F  V", MCCStatus.mrsSensorPacket.RINA219VBus);
-	tft.drawString(buf, cursorX - 2, cursorY);	// Right justified
+	DrawString(buf, cursorX - 2, cursorY);	// Right justified
+
+	cursorY -= 40;
+	lowBattery = (MCCStatus.mrsSensorPacket.RINA219SOC < LowBatterySOCThreshold)
+		|| (MCCStatus.mrsSensorPacket.RINA219Runtime >= 0.0f && MCCStatus.mrsSensorPacket.RINA219Runtime < LowBatteryRuntimeThreshold);
+	tft.setTextColor(lowBattery ? TFT_RED : TFT_GREENYELLOW, TFT_BLACK, true);
+	if (MCCStatus.mrsSensorPacket.RINA219Runtime < 0.0f)
+	{
+		sprintf(buf, "%3.0F%% ---m", MCCStatus.mrsSensorPacket.RINA219SOC);
+	}
+	else
+	{
+		sprintf(buf, "%3.0F%% %3.0Fm", MCCStatus.mrsSensorPacket.RINA219SOC, MCCStatus.mrsSensorPacket.RINA219Runtime);
+	}
+	DrawString(buf, cursorX, cursorY);	// Right justified
 
 }
 
@@ -363,57 +402,74 @@ void LocalDisplayClass::DrawCOMPage()
 		uint8_t mac[6];
 		WiFi.macAddress(mac);
 		sprintf(buf, "MAC:%02X:%02X:%02X:%02X:%02X:%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
-		tft.drawString(buf, 2, halfScreenHeight + 30);
+		DrawString(buf, 2, halfScreenHeight + 30);
 
 		tft.setTextColor(TFT_GREEN);
 		tft.setTextDatum(CL_DATUM);
-		sprintf(buf, "IP: %s Ch: %d %s %d dBm", WiFi.localIP().toString(), WiFi.channel(), WiFi.SSID().c_str(), WiFi.RSSI());
-		tft.drawString(buf, 2, halfScreenHeight + 40);
+		sprintf(buf, "IP: %s Ch: %d %s %d dBm", WiFi.localIP().toString().c_str(), WiFi.channel(), WiFi.SSID().c_str(), WiFi.RSSI());
+		DrawString(buf, 2, halfScreenHeight + 40);
 
 		tft.setTextColor(TFT_CYAN);
-		tft.drawString(I2CBus.Get1st6ActiveI2CAddressesString(), 2, halfScreenHeight + 50);
+		DrawString(I2CBusManager.Monitor.GetPresentAddressesString(), 2, halfScreenHeight + 50);
 
 		tft.setTextColor(TFT_LIGHTGREY);
 		sprintf(buf, "UART0 %s", MCCStatus.UART0Status ? "OK" : "NO");
-		tft.drawString(buf, 2, 30);
+		DrawString(buf, 2, 30);
 
 		tft.setTextDatum(CR_DATUM);
 		sprintf(buf, "UART1 %s", MCCStatus.RC2x15AUARTStatus ? "OK" : "NO");
-		tft.drawString(buf, halfScreenWidth, 30);
+		DrawString(buf, halfScreenWidth, 30);
 
 		tft.setTextColor(TFT_PINK);
 		tft.setTextDatum(CL_DATUM);
-		tft.drawString(ComModeHeadings[MCCStatus.ComMode], 2, 40);
+		DrawString(ComModeHeadings[MCCStatus.ComMode], 2, 40);
 
 		tft.setTextColor(TFT_GREENYELLOW);
 		sprintf(buf, "ESPNow %s", MCCStatus.ESPNOWStatus ? "OK" : "NO");
-		tft.drawString(buf, 2, 50);
+		DrawString(buf, 2, 50);
 
 		tft.setTextColor(TFT_GREEN);
 		sprintf(buf, "WiFi %s", MCCStatus.WiFiStatus ? "OK" : "NO");
-		tft.drawString(buf, 2, 60);
-
-		lastPage = currentPage;
+		DrawString(buf, 2, 60);
 	}
 
 	// Update dynamic displays:
 	tft.setTextColor(TFT_PINK, TFT_BLACK, true);
 	tft.setTextDatum(CL_DATUM);
 	sprintf(buf, "%s %s %5u ms", "CSSM Downlink", MCCStatus.ESPNOWStatus ? "OK" : "NO", MCCStatus.CSSMPacketReceiptInterval);
-	tft.drawString(buf, tft.width() / 2, 40);
+	DrawString(buf, tft.width() / 2, 40);
 
 	tft.setTextColor(TFT_LIGHTGREY, TFT_BLACK, true);
 	tft.setTextDatum(CL_DATUM);
 	sprintf(buf, "%s %s", "CSSM Uplink ", MCCStatus.CSSMESPNOWLinkStatus ? "OK" : "NO");
-	tft.drawString(buf, tft.width() / 2, 50);
+	DrawString(buf, tft.width() / 2, 50);
 
 	tft.setTextColor(TFT_LIGHTGREY, TFT_BLACK, true);
 	tft.setTextDatum(CL_DATUM);
 	sprintf(buf, "%s %5d", "Uplink retries  ", MCCStatus.SendRetries);
-	tft.drawString(buf, tft.width() / 2, 60);
+	DrawString(buf, tft.width() / 2, 60);
 
 	sprintf(buf, "CSSM D/L time    %5u ms", MCCStatus.CSSMPacketReceiptInterval);
-	tft.drawString(buf, tft.width() / 2, 80);
+	DrawString(buf, tft.width() / 2, 80);
+
+	// ESP-NOW link quality (see LinkMonitor.h) as seen from this end (left) and as last reported by the CSSM (right):
+	//score, RSSI (dBm), loss and send failure rates, mean interval, jitter and interval histogram (% per bin):
+	LinkMonitorClass& link = MCCStatus.Link;
+	tft.setTextColor(link.Score >= 50 ? TFT_GREEN : TFT_ORANGE, TFT_BLACK, true);
+	sprintf(buf, "Q%3u R%4ld L%5.1f%% F%5.1f%%", link.Score, link.RSSIValid ? lroundf(link.RSSI) : 0L,
+		link.LossRate * 100.0f, link.FailRate * 100.0f);
+	DrawString(buf, 2, 70);
+	sprintf(buf, "Int %5.1f Jit %5.1f ms", link.MeanInterval, link.Jitter);
+	DrawString(buf, 2, 80);
+	DrawString(link.GetHistogramString(), 2, 90);
+
+	const LinkStatsPacket& remote = MCCStatus.CSSMLinkStats;
+	tft.setTextColor(MCCStatus.CSSMLinkStatsReceivedCount == 0 ? TFT_DARKGREY : remote.Score >= 50 ? TFT_GREEN : TFT_ORANGE,
+		TFT_BLACK, true);
+	sprintf(buf, "CSSM Q%3u R%4d L%5.1f%%", remote.Score, remote.RSSI, remote.LossRate * 100.0f);
+	DrawString(buf, tft.width() / 2, 90);
+	sprintf(buf, "CSSM Jit %5.1f F%5.1f%%", remote.Jitter, remote.FailRate * 100.0f);
+	DrawString(buf, tft.width() / 2, 100);
 
 	//_PL(MCCStatus.CSSMPacketReceiptInterval)
 }
@@ -448,13 +504,13 @@ void LocalDisplayClass::DrawMOTPage()
 		if (MCCStatus.RC2x15AMCStatus)
 		{
 			sprintf(buf, "Version: %s", MCCStatus.RC2x15AMCVersionString.c_str());
-			tft.drawString(buf, cursorX, cursorY);
+			DrawString(buf, cursorX, cursorY);
 		}
 		else
 		{
 			tft.setTextColor(TFT_RED, TFT_BLACK, true);
 			sprintf(buf, "MC UART comm FAILED");
-			tft.drawString(buf, cursorX, cursorY);
+			DrawString(buf, cursorX, cursorY);
 		}
 
 		cursorY = 30;
@@ -462,7 +518,7 @@ void LocalDisplayClass::DrawMOTPage()
 		//TODO: Move to RC2x15AMC.Init function
 		success = RC2x15AMC.GetRC2x15A()->ReadMinMaxMainVoltages(psAddress, minBat, maxBat);
 		sprintf(buf, "Main BAT: (%4.1f - %4.1f )", (float)minBat / 10.0f, (float)maxBat / 10.0f);
-		tft.drawString(buf, cursorX, cursorY);
+		DrawString(buf, cursorX, cursorY);
 
 		cursorY += 10;
 		//TODO: Display logic battery parameters:
@@ -471,23 +527,23 @@ void LocalDisplayClass::DrawMOTPage()
 		cursorY += 10;
 		tft.setTextDatum(TL_DATUM);
 		tft.setTextColor(TFT_GOLD, TFT_BLACK, true);
-		tft.drawString("kp", cursorX, cursorY);
+		DrawString("kp", cursorX, cursorY);
 		cursorY += 10;
-		tft.drawString("ki", cursorX, cursorY);
+		DrawString("ki", cursorX, cursorY);
 		cursorY += 10;
-		tft.drawString("kd", cursorX, cursorY);
+		DrawString("kd", cursorX, cursorY);
 		cursorY += 10;
-		tft.drawString("qpps", cursorX, cursorY);
+		DrawString("qpps", cursorX, cursorY);
 		cursorY += 10;
 
 		cursorY += 10;
-		tft.drawString("PWM", cursorX, cursorY);
+		DrawString("PWM", cursorX, cursorY);
 		cursorY += 10;
-		tft.drawString("Imot", cursorX, cursorY);
+		DrawString("Imot", cursorX, cursorY);
 		cursorY += 10;
-		tft.drawString("Temp", cursorX, cursorY);
+		DrawString("Temp", cursorX, cursorY);
 		cursorY += 10;
-		tft.drawString("Speed", cursorX, cursorY);
+		DrawString("Speed", cursorX, cursorY);
 
 		cursorY = saveCursorY;
 
@@ -497,79 +553,77 @@ void LocalDisplayClass::DrawMOTPage()
 			cursorY += 10;
 			tft.setTextColor(TFT_RED, TFT_BLACK, true);
 			sprintf(buf, "%8.5f", RC2x15AMC.M2kp);
-			tft.drawString(buf, cursorX, cursorY);
+			DrawString(buf, cursorX, cursorY);
 			cursorY += 10;
 			sprintf(buf, "%8.5f", RC2x15AMC.M2ki);
-			tft.drawString(buf, cursorX, cursorY);
+			DrawString(buf, cursorX, cursorY);
 			cursorY += 10;
 			sprintf(buf, "%8.5f", RC2x15AMC.M2kd);
-			tft.drawString(buf, cursorX, cursorY);
+			DrawString(buf, cursorX, cursorY);
 			cursorY += 10;
 			sprintf(buf, "%8d", RC2x15AMC.M2qpps);
-			tft.drawString(buf, cursorX, cursorY);
+			DrawString(buf, cursorX, cursorY);
 			cursorY = saveCursorY;
 			cursorX = halfScreenWidth - 30;
 			cursorY += 10;
 			tft.setTextDatum(TR_DATUM);
 			tft.setTextColor(TFT_GREEN, TFT_BLACK, true);
 			sprintf(buf, "%8.5f", RC2x15AMC.M1kp);
-			tft.drawString(buf, cursorX, cursorY);
+			DrawString(buf, cursorX, cursorY);
 			cursorY += 10;
 			sprintf(buf, "%8.5f", RC2x15AMC.M1ki);
-			tft.drawString(buf, cursorX, cursorY);
+			DrawString(buf, cursorX, cursorY);
 			cursorY += 10;
 			sprintf(buf, "%8.5f", RC2x15AMC.M1kd);
-			tft.drawString(buf, cursorX, cursorY);
+			DrawString(buf, cursorX, cursorY);
 			cursorY += 10;
 			sprintf(buf, "%8d", RC2x15AMC.M1qpps);
-			tft.drawString(buf, cursorX, cursorY);
+			DrawString(buf, cursorX, cursorY);
 		}
 
 		cursorX = halfScreenWidth;
 		cursorY = 110;
 		tft.setTextDatum(TR_DATUM);
 		tft.setTextColor(TFT_GREENYELLOW, TFT_BLACK, true);
-		tft.drawString("A", cursorX, cursorY);
+		DrawString("A", cursorX, cursorY);
 		cursorY += 10;
 		sprintf(buf, "%cC", 0xF7);
-		tft.drawString(buf, cursorX, cursorY);
+		DrawString(buf, cursorX, cursorY);
 		cursorY += 10;
-		tft.drawString("qpps", cursorX, cursorY);
+		DrawString("qpps", cursorX, cursorY);
 
 		cursorX = halfScreenWidth + 10;
 		cursorY = 50;
 		tft.setTextDatum(TL_DATUM);
 		tft.setTextColor(TFT_GOLD, TFT_BLACK, true);
-		tft.drawString("kLTrk", cursorX, cursorY);
+		DrawString("kLTrk", cursorX, cursorY);
 		cursorY += 10;
-		tft.drawString("kRTrk", cursorX, cursorY);
+		DrawString("kRTrk", cursorX, cursorY);
 		cursorY += 10;
-		tft.drawString("kTSpn", cursorX, cursorY);
+		DrawString("kTSpn", cursorX, cursorY);
 		
 		cursorX = tft.width() - 35;
 		cursorY = 50;
 		tft.setTextDatum(TR_DATUM);
 		tft.setTextColor(TFT_CYAN, TFT_BLACK, true);
 		sprintf(buf, "%8.5f", RC2x15AMC.KLTrack);
-		tft.drawString(buf, cursorX, cursorY);
+		DrawString(buf, cursorX, cursorY);
 		cursorY += 10;
 		sprintf(buf, "%8.5f", RC2x15AMC.KRTrack);
-		tft.drawString(buf, cursorX, cursorY);
+		DrawString(buf, cursorX, cursorY);
 		cursorY += 10;
 		sprintf(buf, "%8.1f", RC2x15AMC.TrackSpan);
-		tft.drawString(buf, cursorX, cursorY);
+		DrawString(buf, cursorX, cursorY);
 
 		cursorX = tft.width() - 2;
 		cursorY = 50;
 		tft.setTextDatum(TR_DATUM);
 		tft.setTextColor(TFT_GREENYELLOW, TFT_BLACK, true);
-		tft.drawString("qp/mm", cursorX, cursorY);
+		DrawString("qp/mm", cursorX, cursorY);
 		cursorY += 10;
-		tft.drawString("qp/mm", cursorX, cursorY);
+		DrawString("qp/mm", cursorX, cursorY);
 		cursorY += 10;
-		tft.drawString("mm", cursorX, cursorY);
-
-		lastPage = currentPage;
+		DrawString("mm", cursorX, cursorY);
 	}
 
 	// Update dynamic displays:
@@ -579,7 +633,7 @@ void LocalDisplayClass::DrawMOTPage()
 	tft.setTextDatum(TL_DATUM);
 	tft.setTextColor(TFT_GREENYELLOW, TFT_BLACK, true);
 	sprintf(buf, "%4.1f V", MCCStatus.mcStatus.SupBatV);
-	tft.drawString(buf, cursorX, cursorY);
+	DrawString(buf, cursorX, cursorY);
 
 	cursorX = 75;
 	cursorY = 100;				// Dynamic parameters
@@ -587,31 +641,31 @@ void LocalDisplayClass::DrawMOTPage()
 	tft.setTextDatum(TR_DATUM);
 	tft.setTextColor(TFT_RED, TFT_BLACK, true);
 	sprintf(buf, "%8d", MCCStatus.mcStatus.M2PWM);
-	tft.drawString(buf, cursorX, cursorY);
+	DrawString(buf, cursorX, cursorY);
 	cursorY += 10;
 	sprintf(buf, "%5.2f", MCCStatus.mcStatus.M2Current);
-	tft.drawString(buf, cursorX, cursorY);
+	DrawString(buf, cursorX, cursorY);
 	cursorY += 10;
 	sprintf(buf, "%4.1f", MCCStatus.mcStatus.Temp2);
-	tft.drawString(buf, cursorX, cursorY);
+	DrawString(buf, cursorX, cursorY);
 	cursorY += 10;
 	sprintf(buf, "%4d", MCCStatus.mcStatus.M2Speed);
-	tft.drawString(buf, cursorX, cursorY);
+	DrawString(buf, cursorX, cursorY);
 
 	cursorY = saveCursorY;
 	tft.setTextColor(TFT_GREEN, TFT_BLACK, true);
 	cursorX = halfScreenWidth - 30;
 	sprintf(buf, "%8d", MCCStatus.mcStatus.M1PWM);
-	tft.drawString(buf, cursorX, cursorY);
+	DrawString(buf, cursorX, cursorY);
 	cursorY += 10;
 	sprintf(buf, "%5.2f", MCCStatus.mcStatus.M1Current);
-	tft.drawString(buf, cursorX, cursorY);
+	DrawString(buf, cursorX, cursorY);
 	cursorY += 10;
 	sprintf(buf, "%4.1f", MCCStatus.mcStatus.Temp1);
-	tft.drawString(buf, cursorX, cursorY);
+	DrawString(buf, cursorX, cursorY);
 	cursorY += 10;
 	sprintf(buf, "%4d", MCCStatus.mcStatus.M1Speed);
-	tft.drawString(buf, cursorX, cursorY);
+	DrawString(buf, cursorX, cursorY);
 
 }
 
@@ -632,15 +686,15 @@ void LocalDisplayClass::DrawDBGPage()
 		tft.setTextColor(TFT_GREEN);
 		tft.setTextDatum(CL_DATUM);
 		sprintf(buf, "%s %d core", ESP.getChipModel(), ESP.getChipCores());
-		tft.drawString(buf, 2, 30, 1);
+		DrawString(buf, 2, 30, 1);
 		sprintf(buf, "CPU v%d %d MHz", ESP.getChipRevision(), ESP.getCpuFreqMHz());
-		tft.drawString(buf, 2, 40, 1);
+		DrawString(buf, 2, 40, 1);
 
 		tft.setTextColor(TFT_ORANGE, TFT_BLACK, true);
 		sprintf(buf, "Heap (F/T): %d/%d", ESP.getFreeHeap(), ESP.getHeapSize());
-		tft.drawString(buf, 2, 50, 1);
+		DrawString(buf, 2, 50, 1);
 		sprintf(buf, "Prog (U/F): %d/%d", ESP.getSketchSize(), ESP.getFreeSketchSpace());
-		tft.drawString(buf, 2, 60, 1);
+		DrawString(buf, 2, 60, 1);
 		if (ESP.getPsramSize() > 0)
 		{
 			sprintf(buf, "PSRAM: %d/%d", ESP.getFreePsram(), ESP.getPsramSize());
@@ -649,32 +703,32 @@ void LocalDisplayClass::DrawDBGPage()
 		{
 			sprintf(buf, "No PSRAM");
 		}
-		tft.drawString(buf, 2, 70, 1);
+		DrawString(buf, 2, 70, 1);
 
 		tft.setTextColor(TFT_GREENYELLOW);
 		tft.setTextDatum(CL_DATUM);	//DONE: setTextDatum has NO AFFECT on print() output; print() effectively uses default TL_DATUM
 		uint8_t mac[6];
 		WiFi.macAddress(mac);
 		sprintf(buf, "MAC:%02X:%02X:%02X:%02X:%02X:%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
-		tft.drawString(buf, 2, halfScreenHeight + 20);
+		DrawString(buf, 2, halfScreenHeight + 20);
 
 		tft.setTextColor(TFT_GREEN);
 		tft.setTextDatum(CL_DATUM);
 		sprintf(buf, "SSID: %s %d dBm", WiFi.SSID().c_str(), WiFi.RSSI());
-		tft.drawString(buf, 2, halfScreenHeight + 30, 1);
-		sprintf(buf, "IP: %s", WiFi.localIP().toString());
-		tft.drawString(buf, 2, halfScreenHeight + 40);
+		DrawString(buf, 2, halfScreenHeight + 30, 1);
+		sprintf(buf, "IP: %s", WiFi.localIP().toString().c_str());
+		DrawString(buf, 2, halfScreenHeight + 40);
 
 		tft.setTextColor(TFT_CYAN);
-		tft.drawString(I2CBus.Get1st6ActiveI2CAddressesString(), 2, halfScreenHeight + 50);
+		DrawString(I2CBusManager.Monitor.GetPresentAddressesString(), 2, halfScreenHeight + 50);
 
 		tft.setTextColor(TFT_LIGHTGREY);
 		sprintf(buf, "UART0 %s", MCCStatus.UART0Status ? "OK" : "NO");
-		tft.drawString(buf, 2, halfScreenHeight);
+		DrawString(buf, 2, halfScreenHeight);
 
 		tft.setTextDatum(CR_DATUM);
 		sprintf(buf, "UART1 %s", MCCStatus.RC2x15AUARTStatus ? "OK" : "NO");
-		tft.drawString(buf, halfScreenWidth, halfScreenHeight);
+		DrawString(buf, halfScreenWidth, halfScreenHeight);
 
 		//tft.setTextColor(TFT_PINK);
 		//tft.setTextDatum(CL_DATUM);
@@ -683,25 +737,39 @@ void LocalDisplayClass::DrawDBGPage()
 		tft.setTextColor(TFT_GREENYELLOW);
 		tft.setTextDatum(CL_DATUM);
 		sprintf(buf, "ESPNow %s", MCCStatus.ESPNOWStatus ? "OK" : "NO");
-		tft.drawString(buf, 2, halfScreenHeight + 10);
+		DrawString(buf, 2, halfScreenHeight + 10);
 
 		tft.setTextColor(TFT_GREEN);
 		tft.setTextDatum(CR_DATUM);
 		sprintf(buf, "WiFi %s", MCCStatus.WiFiStatus ? "OK" : "NO");
-		tft.drawString(buf, halfScreenWidth, halfScreenHeight + 10);
+		DrawString(buf, halfScreenWidth, halfScreenHeight + 10);
 
 		tft.setTextColor(TFT_GREENYELLOW);
 		tft.setTextDatum(CL_DATUM);
 		for (int i = 0; i < MAX_TEXT_LINES; ++i)
 		{
-			tft.drawString(MCCStatus.debugTextLines[i].c_str(), halfScreenWidth + 2, 30 + i * 10);
+			DrawString(MCCStatus.debugTextLines[i].c_str(), halfScreenWidth + 2, 30 + i * 10);
 		}
-
-		lastPage = currentPage;
 	}
 
 	// Update dynamic displays:
 
+	// I2C bus utilisation, retries, errors and deadline misses (see I2CBusManager):
+	tft.setTextColor(TFT_CYAN, TFT_BLACK, true);
+	tft.setTextDatum(CL_DATUM);
+	sprintf(buf, "I2C %3u%% R%lu E%lu M%lu  ", I2CBusManager.Utilisation, I2CBusManager.RetryCount, I2CBusManager.ErrorCount,
+		I2CBusManager.DeadlineMisses);
+	DrawString(buf, 2, tft.height() / 2 + 60);
+
+	// Ticks and steps of the last full page draw with the longest display update, and the motor task's average and
+	//maximum start jitter:
+	tft.setTextColor(TFT_SILVER, TFT_BLACK, true);
+	tft.setTextDatum(TC_DATUM);
+	sprintf(buf, "Drw %2u/%3u %5luus", LastPassTicks, LastPassSteps, (unsigned long)MaxRenderTime);
+	DrawString(buf, tft.width() / 2, 2);
+	sprintf(buf, "MotJ %5.0f/%5luus", MCCStatus.AverageMotorTaskJitter, (unsigned long)MCCStatus.MaxMotorTaskJitter);
+	DrawString(buf, tft.width() / 2, 12);
+
 	// Display rotary encoder settings:
 	//tft.setTextDatum(BL_DATUM);
 	//tft.setTextSize(1);
@@ -731,8 +799,6 @@ void LocalDisplayClass::DrawSENPage()
 		cursorY = tft.height() - 20;
 		tft.setTextColor(TFT_YELLOW, TFT_BLACK, true);	//DONE: Does bgfill = true work with the print() method? -> Yes, newly printed text clears the background
 
-
-		lastPage = currentPage;
 	}
 
 	// Update dynamic displays:
@@ -742,35 +808,35 @@ void LocalDisplayClass::DrawSENPage()
 	tft.setTextDatum(CL_DATUM);
 	tft.setTextColor(TFT_GREENYELLOW, TFT_BLACK, true);
 	//sprintf(buf, "Tatm %7.2f %cC", MCCStatus.mrsSensorPacket.BME680Temp, 0xF7);
-	tft.drawString("Local BME680:", cursorX, cursorY);
+	DrawString("Local BME680:", cursorX, cursorY);
 
 	cursorX = 12;
 	cursorY += 10;
 	tft.setTextColor(TFT_GREEN, TFT_BLACK, true);
 	sprintf(buf, "Tatm %7.2f %cC", MCCStatus.mrsSensorPacket.BME680Temp, 0xF7);
-	tft.drawString(buf, cursorX, cursorY);
+	DrawString(buf, cursorX, cursorY);
 
 	cursorY += 10;
 	sprintf(buf, "RH   %7.2f %%", MCCStatus.mrsSensorPacket.BME680RH);
-	tft.drawString(buf, cursorX, cursorY);
+	DrawString(buf, cursorX, cursorY);
 
 	cursorY += 10;
 	sprintf(buf, "Pbar %7.2f hPa", MCCStatus.mrsSensorPacket.BME680Pbaro);
-	tft.drawString(buf, cursorX, cursorY);
+	DrawString(buf, cursorX, cursorY);
 
 	cursorY += 10;
 	sprintf(buf, "Alt  %7.0f m", MCCStatus.mrsSensorPacket.BME680Alt);
-	tft.drawString(buf, cursorX, cursorY);
+	DrawString(buf, cursorX, cursorY);
 
 	cursorY += 10;
 	sprintf(buf, "Gas  %7.2f ohm", MCCStatus.mrsSensorPacket.BME680Gas);
-	tft.drawString(buf, cursorX, cursorY);
+	DrawString(buf, cursorX, cursorY);
 
 	cursorX = 2;
 	cursorY += 20;
 	tft.setTextColor(TFT_SILVER, TFT_BLACK, true);
-	sprintf(buf, "VMCU %s", mccSensors.GetMCUVoltageString());
-	tft.drawString(buf, cursorX, cursorY);
+	sprintf(buf, "VMCU %s", mccSensors.GetMCUVoltageString().c_str());
+	DrawString(buf, cursorX, cursorY);
 
 	// Display MRS SEN pose data:
 
@@ -787,46 +853,207 @@ void LocalDisplayClass::DrawSENPage()
 		tft.setTextColor(TFT_RED, TFT_BLACK, true);
 	}
 	sprintf(buf, "MRSSEN %s", MCCStatus.MRSSENModuleStatus ? "OK" : "NO");
-	tft.drawString(buf, cursorX, cursorY);
+	DrawString(buf, cursorX, cursorY);
 
 	cursorY += 10;
 	tft.setTextColor(TFT_GREENYELLOW, TFT_BLACK, true);
 	sprintf(buf, "SF ODO Pose:");
-	tft.drawString(buf, cursorX, cursorY);
+	DrawString(buf, cursorX, cursorY);
 
 	cursorX = halfScreenWidth + 12;
 	cursorY += 10;
 	tft.setTextColor(TFT_GREEN, TFT_BLACK, true);
 	sprintf(buf, "X %8.3f m", MCCStatus.mrsSensorPacket.ODOSPosX);
-	tft.drawString(buf, cursorX, cursorY);
+	DrawString(buf, cursorX, cursorY);
 
 	cursorY += 10;
 	sprintf(buf, "X %8.3f m", MCCStatus.mrsSensorPacket.ODOSPosY);
-	tft.drawString(buf, cursorX, cursorY);
+	DrawString(buf, cursorX, cursorY);
 
 	cursorY += 10;
 	sprintf(buf, "HDG %6.1f %c", MCCStatus.mrsSensorPacket.ODOSHdg, 0xF7);
-	tft.drawString(buf, cursorX, cursorY);
+	DrawString(buf, cursorX, cursorY);
 
 	cursorX = halfScreenWidth + 2;
 	tft.setTextColor(TFT_GREENYELLOW, TFT_BLACK, true);
 	cursorY += 10;
-	sprintf(buf, "ST BRG %6d %c", MCCStatus.mrsSensorPacket.TurretPosition, 0xF7);
-	tft.drawString(buf, cursorX, cursorY);
+	sprintf(buf, "ST BRG %4d%c %3d%%", MCCStatus.mrsSensorPacket.TurretPosition, 0xF7, MCCStatus.mrsSensorPacket.TurretConfidence);
+	DrawString(buf, cursorX, cursorY);
 
 	cursorY += 10;
 	sprintf(buf, "VL53L1 %6d mm", MCCStatus.mrsSensorPacket.FWDVL53L1XRange);
-	tft.drawString(buf, cursorX, cursorY);
+	DrawString(buf, cursorX, cursorY);
+
+	cursorY += 10;
+	tft.setTextColor(TFT_SILVER, TFT_BLACK, true);
+	sprintf(buf, "I2C %5luus %3ub %ut ", MCCStatus.MRSSENUpdateTime, MCCStatus.MRSSENUpdateBytes, MCCStatus.MRSSENUpdateTransactions);
+	DrawString(buf, cursorX, cursorY);
+
+	// Last command sent to MRS SEN and its acknowledgement (A accepted, R rejected, U unknown, D dropped):
+	cursorY += 10;
+	sprintf(buf, "CMD %3u ACK %3u %c ", MCCStatus.MRSSENCommandSequence, MCCStatus.mrsSENCommandAck.Sequence,
+		"-ARUD"[MCCStatus.mrsSENCommandAck.Status < 5 ? MCCStatus.mrsSENCommandAck.Status : 0]);
+	DrawString(buf, cursorX, cursorY);
+
+	// Clock synchronisation residuals reported by MRS SEN and the CSSM (see ClockSync.h):
+	cursorY += 10;
+	sprintf(buf, "CLK S%+6ld C%+6ld us ", (long)MCCStatus.SENClockResidual, (long)MCCStatus.CSSMClockResidual);
+	DrawString(buf, cursorX, cursorY);
 
 }
 
+void LocalDisplayClass::DrawBUSPage()
+{
+	int16_t cursorY;
+
+	currentPage = BUS;
+
+	if (lastPage != currentPage)	// Clear display and redraw static elements of the page format:
+	{
+		DrawPageHeaderAndFooter();
+
+		tft.setTextDatum(CL_DATUM);
+		tft.setTextColor(TFT_GREENYELLOW);
+		DrawString(" Dev    Addr  kHz    B/s  T/s   us/s Fb", 2, 30);
+		DrawString("Job  Pri  Runs Errs Miss  Last   Max", 2, 100);
+	}
+
+	// Update dynamic displays:
+
+	// Per device figures for the last one second window (see I2CBusMonitor); missing devices are shown in red
+	//and devices found by the background scan are marked '?':
+	tft.setTextDatum(CL_DATUM);
+	cursorY = 40;
+	for (uint8_t i = 0; i < I2CBusManager.Monitor.GetDeviceCount() && cursorY < 100; i++)
+	{
+		const I2CBusMonitor::I2CDeviceInfo* device = I2CBusManager.Monitor.GetDevice(i);
+		tft.setTextColor(device->Present ? TFT_GREEN : TFT_RED, TFT_BLACK, true);
+		sprintf(buf, "%c%-6s 0x%02X %4lu %6lu %4lu %6lu %2lu ", device->Expected ? ' ' : '?', device->Name, device->Address,
+			device->Clock / 1000, device->BytesPerSecond, device->TransactionsPerSecond, device->BusyTimePerSecond,
+			device->Fallbacks);
+		DrawString(buf, 2, cursorY);
+		cursorY += 10;
+	}
+
+	// Per job dispatch statistics (see I2CBusManager):
+	tft.setTextColor(TFT_CYAN, TFT_BLACK, true);
+	cursorY = 110;
+	for (uint8_t i = 0; i < I2CBusManager.GetJobCount() && cursorY < 150; i++)
+	{
+		const I2CBusManagerClass::I2CJob* job = I2CBusManager.GetJob(i);
+		sprintf(buf, "%-4s %3u %5lu %4lu %4lu %5lu %5lu ", job->Name, job->Priority, job->RunCount, job->ErrorCount,
+			job->DeadlineMisses, job->LastDuration, job->MaxDuration);
+		DrawString(buf, 2, cursorY);
+		cursorY += 10;
+	}
+
+	tft.setTextDatum(CR_DATUM);
+	tft.setTextColor(TFT_SILVER, TFT_BLACK, true);
+	sprintf(buf, " %s %3u%%", I2CBusManager.Monitor.GetBusName(), I2CBusManager.Monitor.Utilisation);
+	DrawString(buf, tft.width() - 2, 30);
+}
+
 void LocalDisplayClass::DrawNONEPage()
 {
 	currentPage = NONE;
-	tft.fillScreen(TFT_BLACK);
+	if (Step())
+	{
+		tft.fillScreen(TFT_BLACK);
+	}
 	lastPage = NONE;
 }
 
+/// <summary>
+/// Starts a call of drawing steps
+/// </summary>
+/// <param name="budget">us; 0 to draw the rest of the current pass whatever the time taken</param>
+void LocalDisplayClass::BeginSteps(uint32_t budget)
+{
+	StepBudget = budget;
+	StepsStartTime = micros();
+	StepIndex = 0;
+	StepsDrawn = 0;
+	BudgetSpent = false;
+}
+
+/// <summary>
+/// Counts a drawing step of the current page; each drawing call is made only if this returns true
+/// </summary>
+/// <returns>True if the step has not been drawn yet in the current pass and the budget has not been spent</returns>
+bool LocalDisplayClass::Step()
+{
+	if (currentPage != StepPage)
+	{
+		// Start a new pass; the page that was being drawn, if unfinished, must be redrawn in full next time:
+		StepPage = currentPage;
+		NextStep = 0;
+		PassTicks = 0;
+		lastPage = NONE;
+	}
+
+	uint16_t step = StepIndex++;
+	if (step < NextStep || BudgetSpent)
+	{
+		return false;
+	}
+	if (StepBudget > 0 && StepsDrawn > 0 && micros() - StepsStartTime >= StepBudget)
+	{
+		BudgetSpent = true;
+		return false;
+	}
+	NextStep = step + 1;
+	StepsDrawn++;
+	return true;
+}
+
+/// <summary>
+/// Ends a call of drawing steps; once every step of the pass has been drawn the page is up to date
+/// </summary>
+void LocalDisplayClass::EndSteps()
+{
+	if (StepIndex == 0)
+	{
+		return;
+	}
+
+	PassTicks++;
+	if (!BudgetSpent)
+	{
+		lastPage = currentPage;
+		RenderPasses++;
+		LastPassSteps = StepIndex;
+		LastPassTicks = PassTicks;
+		NextStep = 0;
+		PassTicks = 0;
+	}
+	RenderTime = micros() - StepsStartTime;
+	MaxRenderTime = max(MaxRenderTime, RenderTime);
+}
+
+void LocalDisplayClass::DrawString(const char* string, int32_t x, int32_t y)
+{
+	if (Step())
+	{
+		tft.drawString(string, x, y);
+	}
+}
+
+void LocalDisplayClass::DrawString(const char* string, int32_t x, int32_t y, uint8_t font)
+{
+	if (Step())
+	{
+		tft.drawString(string, x, y, font);
+	}
+}
+
+void LocalDisplayClass::DrawString(const String& string, int32_t x, int32_t y)
+{
+	if (Step())
+	{
+		tft.drawString(string, x, y);
+	}
+}
+
 bool LocalDisplayClass::Init()
 {
 	// Display power is not eanbled by default when the board is powered through the LiPo battery connector
@@ -844,7 +1071,17 @@ bool LocalDisplayClass::Init()
 	return true;
 }
 
+/// <summary>
+/// Draws the current page, within the render budget; the rest of the page is drawn on the following calls
+/// </summary>
 void LocalDisplayClass::Update()
+{
+	BeginSteps(RenderBudget);
+	DrawCurrentPage();
+	EndSteps();
+}
+
+void LocalDisplayClass::DrawCurrentPage()
 {
 	switch (currentPage)
 	{
@@ -866,6 +1103,9 @@ void LocalDisplayClass::Update()
 	case SEN:
 		DrawSENPage();
 		break;
+	case BUS:
+		DrawBUSPage();
+		break;
 
 	default:
 		DrawNONEPage();
@@ -874,6 +1114,8 @@ void LocalDisplayClass::Update()
 
 void LocalDisplayClass::Control(uint8_t command)
 {
+	// Pages selected directly are drawn in full straight away:
+	BeginSteps(0);
 	switch (command)
 	{
 	case Clear:
@@ -894,6 +1136,9 @@ void LocalDisplayClass::Control(uint8_t command)
 	case SENPage:
 		DrawSENPage();
 		break;
+	case BUSPage:
+		DrawBUSPage();
+		break;
 	case Next:
 		NextPage(0);
 		break;
@@ -904,6 +1149,7 @@ void LocalDisplayClass::Control(uint8_t command)
 	default:
 		break;
 	}
+	EndSteps();
 }
 
 void LocalDisplayClass::SetCurrentPage(Pages page)
@@ -948,6 +1194,8 @@ void LocalDisplayClass::NextPage(int /*value*/)
 void LocalDisplayClass::RefreshCurrentPage()
 {
 	lastPage = NONE;
+	NextStep = 0;
+	PassTicks = 0;
 	SetCurrentPage(currentPage);
 	Update();
 }
@@ -960,6 +1208,12 @@ void LocalDisplayClass::RefreshPage(Pages page)
 	}
 }
 
+/// <param name="budget">us of drawing per Update(); 0 for no limit</param>
+void LocalDisplayClass::SetRenderBudget(uint32_t budget)
+{
+	RenderBudget = budget;
+}
+
 void LocalDisplayClass::ReportHeapStatus()
 {
 	sprintf(buf, "Heap (F/T): %d/%d", ESP.getFreeHeap(), ESP.getHeapSize());
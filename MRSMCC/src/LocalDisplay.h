@@ -5,6 +5,11 @@
 *		System (SYS)	Default summary of system, power supply voltages and I/O ststus
 *		Comms (COM)		Communications with MRS RC MCC or MRS RC CSSM
 *
+*	Every drawing call of a page is a step.  Update() draws steps until RenderBudget is spent and carries on from
+*	the next step on its next call, so that redrawing a whole page is spread over several ticks of the display task
+*	rather than holding up the other tasks (e.g. the 50 ms UpdateMotorControllerTask).  A page's static elements
+*	are only taken as drawn once the whole pass over the page has been completed.
+*
 *	Mitchell Baldwin copyright 2024-2025
 *
 *	v 0.00:	Initial command set
@@ -25,6 +30,8 @@
 #include <TFT_eSPI.h>
 
 constexpr byte DefaultDisplayBrightness = 128;
+constexpr uint32_t DefaultRenderBudget = 4000;		// us of drawing per Update(); at least one step is always drawn
+constexpr int32_t ClearBandHeight = 34;				// rows; the screen is cleared in bands of this many, one per step
 
 class LocalDisplayClass
 {
@@ -37,6 +44,7 @@ public:
 		MOT,
 		DBG,
 		SEN,
+		BUS,
 
 		NONE
 	};
@@ -50,6 +58,16 @@ protected:
 	static Pages currentPage;
 	Pages lastPage = NONE;				// Aid to determine when a complete page redraw is needed
 
+	uint32_t RenderBudget = DefaultRenderBudget;	// us; for Update()
+	uint32_t StepBudget = 0;			// us; for the current call, 0 for no limit
+	uint32_t StepsStartTime = 0;		// us
+	uint16_t StepIndex = 0;				// Steps reached so far in the current call
+	uint16_t NextStep = 0;				// First step of the current pass not yet drawn
+	uint16_t StepsDrawn = 0;			// In the current call
+	uint16_t PassTicks = 0;				// Calls so far in the current pass
+	bool BudgetSpent = false;
+	Pages StepPage = NONE;				// Page of the current pass
+
 	const char* PageTitles[NONE] =
 	{
 		"  System",
@@ -58,6 +76,7 @@ protected:
 		"  Motors",
 		"   Debug",
 		" Sensors",
+		" I2C Bus",
 
 	};
 
@@ -90,8 +109,17 @@ protected:
 	void DrawMOTPage();
 	void DrawDBGPage();
 	void DrawSENPage();
+	void DrawBUSPage();
 
 	void DrawNONEPage();
+	void DrawCurrentPage();
+
+	void BeginSteps(uint32_t budget);
+	bool Step();
+	void EndSteps();
+	void DrawString(const char* string, int32_t x, int32_t y);
+	void DrawString(const char* string, int32_t x, int32_t y, uint8_t font);
+	void DrawString(const String& string, int32_t x, int32_t y);
 
 public:
 	enum Commands
@@ -104,6 +132,7 @@ public:
 		MOTPage,
 		DBGPage,
 		SENPage,
+		BUSPage,
 		I2CScan,
 
 		Prev,
@@ -112,6 +141,13 @@ public:
 		Last
 	};
 
+	// Render pass statistics:
+	uint32_t RenderPasses = 0;
+	uint16_t LastPassSteps = 0;
+	uint16_t LastPassTicks = 0;			// Calls of Update() (or Control()) the last pass took
+	uint32_t RenderTime = 0;			// us; last call
+	uint32_t MaxRenderTime = 0;			// us
+
 	bool Init();
 
 	bool Test();
@@ -122,6 +158,7 @@ public:
 	Pages GetCurrentPage();
 	void RefreshCurrentPage();
 	void RefreshPage(Pages page);
+	void SetRenderBudget(uint32_t budget);
 	static void PrevPage(int value);
 	static void NextPage(int value);
 
@@ -0,0 +1,122 @@
+/*	MCCMap.cpp
+*	MCCMapClass - Local occupancy map built on the MCC from MRS SEN polar scans and the OTOS pose
+*
+*	Mitchell Baldwin copyright 2025
+*
+*/
+
+#include "MCCMap.h"
+#include "DEBUG Macros.h"
+
+constexpr uint32_t MCCMapRateRays = 500;				// Rays per RaysPerSecond update
+constexpr uint16_t MCCMapBenchmarkRays = 2000;
+
+/// <summary>
+/// Traces the bins of one polar scan chunk into the grid
+/// </summary>
+/// <param name="chunk">Chunk fetched from the MRS SEN module</param>
+/// <param name="x">OTOS position, m</param>
+/// <param name="y">OTOS position, m</param>
+/// <param name="heading">OTOS heading, degrees counterclockwise</param>
+void MCCMapClass::AddScanChunk(const PolarScanChunkPacket& chunk, float x, float y, float heading)
+{
+	uint32_t startTime = micros();
+	uint32_t cellUpdates = Grid.CellUpdates;
+
+	Grid.SetCentre(x, y);
+	for (uint8_t i = 0; i < chunk.BinCount; i++)
+	{
+		float turretAngle = (chunk.StartAngle + (chunk.FirstBin + i + 0.5f) * chunk.AngleStep) / 10.0f;
+		Grid.AddRay(x, y, heading - turretAngle, PolarScanChunkPacket::DequantiseRange(chunk.Ranges[i]));
+	}
+	ChunksAdded++;
+
+	BusyTime += micros() - startTime;
+	BusyRays += chunk.BinCount;
+	BusyCellUpdates += Grid.CellUpdates - cellUpdates;
+	if (BusyRays >= MCCMapRateRays && BusyTime > 0)
+	{
+		RaysPerSecond = BusyRays * 1000000.0f / BusyTime;
+		CellUpdatesPerSecond = BusyCellUpdates * 1000000.0f / BusyTime;
+		BusyTime = 0;
+		BusyRays = 0;
+		BusyCellUpdates = 0;
+	}
+}
+
+/// <returns>False if no tile has changed since it was last exported</returns>
+bool MCCMapClass::ExportTile(OccupancyTilePacket& packet)
+{
+	if (!Grid.ExportTile(packet))
+	{
+		return false;
+	}
+	LastExportedTileX = packet.TileX;
+	LastExportedTileY = packet.TileY;
+	TilesExported++;
+	return true;
+}
+
+/// <summary>
+/// Flags the tile of the last ExportTile() packet for export again; call if that packet could not be delivered
+/// </summary>
+void MCCMapClass::ResendLastTile()
+{
+	if (LastExportedTileX == OccupancyNoTile)
+	{
+		return;
+	}
+	Grid.MarkTileDirty(LastExportedTileX, LastExportedTileY);
+	LastExportedTileX = OccupancyNoTile;
+	TilesResent++;
+}
+
+String MCCMapClass::GetStatusString()
+{
+	char buf[64];
+	snprintf(buf, sizeof(buf), "Map %lu rays %.0f rays/s %.0f cells/s %lu tiles",
+		(unsigned long)Grid.RaysAdded, RaysPerSecond, CellUpdatesPerSecond, (unsigned long)TilesExported);
+	return String(buf);
+}
+
+/// <summary>
+/// Traces random rays from the centre of an N x N tile grid and prints the ray and cell update rates
+/// </summary>
+template <uint8_t N>
+static void BenchmarkGrid(uint16_t cellSize)
+{
+	char buf[80];
+	OccupancyGrid<N>* grid = new OccupancyGrid<N>(cellSize);
+	if (grid == nullptr)
+	{
+		return;
+	}
+
+	randomSeed(N);
+	uint32_t startTime = micros();
+	for (uint16_t i = 0; i < MCCMapBenchmarkRays; i++)
+	{
+		grid->AddRay(0.0f, 0.0f, random(360), random(100, OccupancyMaxRayRange + 500));
+	}
+	uint32_t elapsed = micros() - startTime;
+
+	snprintf(buf, sizeof(buf), "Map %2u x %2u tiles @ %3u mm: %6.0f rays/s %8.0f cells/s",
+		N, N, cellSize, MCCMapBenchmarkRays * 1000000.0f / elapsed, grid->CellUpdates * 1000000.0f / elapsed);
+	_PL(buf);
+	delete grid;
+}
+
+/// <summary>
+/// Times ray tracing on grids of several sizes and resolutions, so the window the MCC can sustain can be chosen.
+/// Each test grid is taken from the heap in turn (over 16 kB for 16 x 16 tiles) alongside the live map
+/// </summary>
+void MCCMapClass::Benchmark()
+{
+	BenchmarkGrid<4>(100);
+	BenchmarkGrid<8>(50);
+	BenchmarkGrid<8>(25);
+	BenchmarkGrid<16>(25);
+}
+
+
+MCCMapClass MCCMap;
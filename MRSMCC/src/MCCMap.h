@@ -0,0 +1,61 @@
+/*	MCCMap.h
+*	MCCMapClass - Local occupancy map built on the MCC from MRS SEN polar scans and the OTOS pose
+*
+*	Each polar scan chunk fetched from the MRS SEN module is traced into an OccupancyGrid centred on the robot;
+*	turret bearings are clockwise from the chassis forward axis and the OTOS heading is counterclockwise, so a
+*	bin's world bearing is heading - turret angle.  The pose is the one current when the chunk is integrated; at
+*	the default sweep rate the robot moves little during one chunk.
+*
+*	Tiles that change state are exported to the CSSM in the gaps between other ESP-NOW packets.
+*
+*	Mitchell Baldwin copyright 2025
+*
+*	v 0.00:	Initial data structure
+*	v
+*
+*/
+
+#ifndef _MCCMap_h
+#define _MCCMap_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\OccupancyGrid.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\PolarScanChunkPacket.h"
+
+constexpr uint8_t MCCMapTilesPerSide = 8;				// 64 x 64 cells, 4 kB
+constexpr uint16_t MCCMapCellSize = 50;					// mm; 3.2 m square window
+
+class MCCMapClass
+{
+protected:
+	uint32_t BusyTime = 0;								// us spent tracing rays since the last rate update
+	uint32_t BusyRays = 0;
+	uint32_t BusyCellUpdates = 0;
+	int16_t LastExportedTileX = OccupancyNoTile;		// World tile of the last ExportTile() packet
+	int16_t LastExportedTileY = OccupancyNoTile;
+
+public:
+	OccupancyGrid<MCCMapTilesPerSide> Grid{ MCCMapCellSize };
+
+	uint32_t ChunksAdded = 0;
+	uint32_t TilesExported = 0;
+	uint32_t TilesResent = 0;							// Exported tiles whose packet was lost and were flagged again
+	float RaysPerSecond = 0.0f;							// Sustainable rate: rays traced per second of CPU time
+	float CellUpdatesPerSecond = 0.0f;
+
+	void AddScanChunk(const PolarScanChunkPacket& chunk, float x, float y, float heading);
+	bool ExportTile(OccupancyTilePacket& packet);
+	void ResendLastTile();
+	String GetStatusString();
+	void Benchmark();
+
+};
+
+extern MCCMapClass MCCMap;
+
+#endif
@@ -6,6 +6,9 @@
 #include "MCCSensors.h"
 #include "DEBUG Macros.h"
 #include "MCCStatus.h"
+#include "I2CBusManager.h"
+#include "MCCMap.h"
+#include "RC2x15AMC.h"
 
 float MCCSensors::BME680Altitude(const int32_t press, const float seaLevel)
 {
@@ -73,6 +76,10 @@ bool MCCSensors::Init()
 	{
 		MCCStatus.WSUPS3SINA219Status = true;
 		_PL("Left WS UPS 3S INA219 initialized")
+
+		bool restored = LUPSFuelGauge.Init("LUPSGauge", WSUPS3SINA219->getBusVoltage_V(), WSUPS3SINA219->getCurrent_mA());
+		sprintf(buf, "Left UPS SOC %3.0F%% (%s)", LUPSFuelGauge.GetSOC(), restored ? "NVS" : "OCV");
+		_PL(buf)
 	}
 	else
 	{
@@ -108,13 +115,29 @@ bool MCCSensors::Init()
 	return success;
 }
 
+/// <summary>
+/// Updates the analog (non I2C) measurements; I2C sensors are read by the Update... jobs run by I2CBusManager
+/// </summary>
 void MCCSensors::Update()
 {
-	char buf[64];
-	uint8_t data[sizeof(MRSSensorPacket)];
+	// Update at main task frequency:
+	uint16_t newReading = analogRead(defaultVMCUPin);					// ADC counts
+	//int calibratedReading = ReadCalibratedADC1(newReading);			// mV
+	//_PL(calibratedReading)
+	VMCU.AddReading(newReading);
+	newReading = analogRead(defaultVBBAKPin);							// ADC counts
+	VBBAK.AddReading(newReading);
+}
 
+/// <summary>
+/// Reads the BME680 environment sensor and the lower rate Left UPS 3S INA219 values; Environment priority I2C job
+/// </summary>
+/// <returns>False if an INA219 transaction failed or the BME680 stopped acknowledging its address</returns>
+bool MCCSensors::UpdateEnvironment()
+{
 	static int32_t temp, rh, pbaro, gas;
 	static uint32_t loopCounter = 0;
+	bool success = true;
 
 	if (MCCStatus.BME680Status)
 	{
@@ -122,6 +145,7 @@ void MCCSensors::Update()
 		if (!loopCounter)
 		{
 			BME680->getSensorData(temp, rh, pbaro, gas, true);				// Setting waitSwitch = false to read asynchronously?
+			I2CBusManager.Monitor.AddTraffic(I2CBusManager.Monitor.FindDevice(defaultBME680Address), BME680ReadBytes, BME680ReadTransactions);
 		}
 		// Read environment sensors at a lower frequency (e.g., 200 ms x 10 x 2 = 4000 ms sampling period):
 		if (loopCounter++ % 10 == 0)
@@ -133,55 +157,195 @@ void MCCSensors::Update()
 			MCCStatus.mrsSensorPacket.BME680Gas = (float)gas / 100.0f;		// Convert from milliohms (?)
 			MCCStatus.mrsSensorPacket.BME680Alt = BME680Altitude(pbaro);	// m
 			BME680->getSensorData(temp, rh, pbaro, gas, false);				// Setting waitSwitch = false to read asynchronously
+			I2CBusManager.Monitor.AddTraffic(I2CBusManager.Monitor.FindDevice(defaultBME680Address), BME680ReadBytes, BME680ReadTransactions);
+
+			// Zanshin_BME680 does not report bus errors, so check that the BME680 still acknowledges its address:
+			Wire.beginTransmission(defaultBME680Address);
+			success = (Wire.endTransmission() == 0);
+			I2CBusManager.Monitor.AddTraffic(I2CBusManager.Monitor.FindDevice(defaultBME680Address), 1, 1);
 		}
 	}
 
-	// Update at main task frequency:
-	uint16_t newReading = analogRead(defaultVMCUPin);					// ADC counts
-	//int calibratedReading = ReadCalibratedADC1(newReading);			// mV
-	//_PL(calibratedReading)
-	VMCU.AddReading(newReading);
-	newReading = analogRead(defaultVBBAKPin);							// ADC counts
-	VBBAK.AddReading(newReading);
-
+	// Bus voltage and current are sampled at a higher rate by SampleBattery():
 	if (MCCStatus.WSUPS3SINA219Status)
 	{
-		MCCStatus.mrsSensorPacket.INA219VBus = WSUPS3SINA219->getBusVoltage_V();
-		MCCStatus.mrsSensorPacket.INA219VShunt = WSUPS3SINA219->getShuntVoltage_mV();
-		MCCStatus.mrsSensorPacket.INA219Current = WSUPS3SINA219->getCurrent_mA();
-		MCCStatus.mrsSensorPacket.INA219Power = WSUPS3SINA219->getPower_mW();
+		float shuntVoltage = WSUPS3SINA219->getShuntVoltage_mV();
+		bool read = WSUPS3SINA219->success();
+		float power = WSUPS3SINA219->getPower_mW();
+		read = WSUPS3SINA219->success() && read;
+		I2CBusManager.Monitor.AddTraffic(I2CBusManager.Monitor.FindDevice(defaultINA219Address), INA219PairReadBytes, INA219PairReadTransactions);
+		if (read)
+		{
+			MCCStatus.mrsSensorPacket.INA219VShunt = shuntVoltage;
+			MCCStatus.mrsSensorPacket.INA219Power = power;
+		}
+		success = success && read;
+		MCCStatus.mrsSensorPacket.INA219SOC = LUPSFuelGauge.GetSOC();
+		MCCStatus.mrsSensorPacket.INA219Runtime = LUPSFuelGauge.GetRuntime();
 	}
 
+	return success;
+}
+
+/// <summary>
+/// Fetches the changed MRS SEN data registers; Control priority I2C job
+/// </summary>
+/// <returns>False if the MRS SEN module did not respond or a register read failed</returns>
+bool MCCSensors::UpdateMRSSEN()
+{
 	// Get sensor packet from MRS SEN module over I2C:
+	int device = I2CBusManager.Monitor.FindDevice(defaultMRSSENAddress);
 	MCCStatus.MRSSENModuleStatus = MRSSENsors->TestI2CConnection();
-	if (MCCStatus.MRSSENModuleStatus)
+	I2CBusManager.Monitor.AddTraffic(device, 1, 1);
+	if (!MCCStatus.MRSSENModuleStatus)
 	{
-		MRSSENsors->Update();
-		MRSSensorPacket senPacket;
-		MRSSENsors->getMRSSensorPacket(senPacket);
+		return false;
+	}
 
-		MCCStatus.mrsSensorPacket.FWDVL53L1XRange = senPacket.FWDVL53L1XRange;
-		MCCStatus.mrsSensorPacket.ODOSPosX = senPacket.ODOSPosX;
-		MCCStatus.mrsSensorPacket.ODOSPosY = senPacket.ODOSPosY;
-		MCCStatus.mrsSensorPacket.ODOSHdg = senPacket.ODOSHdg;
-		MCCStatus.mrsSensorPacket.TurretPosition = senPacket.TurretPosition;
+	bool success = MRSSENsors->Update();
+	I2CBusManager.Monitor.AddTraffic(device, MRSSENsors->LastUpdateBytes, MRSSENsors->LastUpdateTransactions);
+	MRSSensorPacket senPacket;
+	MRSSENsors->getMRSSensorPacket(senPacket);
+	MCCStatus.MRSSENUpdateTime = MRSSENsors->LastUpdateTime;
+	MCCStatus.MRSSENUpdateBytes = MRSSENsors->LastUpdateBytes;
+	MCCStatus.MRSSENUpdateTransactions = MRSSENsors->LastUpdateTransactions;
 
-		MCCStatus.mrsSensorPacket.RINA219VBus = senPacket.RINA219VBus;
-		MCCStatus.mrsSensorPacket.RINA219VShunt = senPacket.RINA219VShunt;
-		MCCStatus.mrsSensorPacket.RINA219Current = senPacket.RINA219Current;
-		MCCStatus.mrsSensorPacket.RINA219Power = senPacket.RINA219Power;
+	if (success && senPacket.Sequence != MCCStatus.mrsSensorPacket.Sequence)
+	{
+		MCCStatus.MRSSENSnapshotTime = millis();
+	}
 
-	
-		// Test code:
-		//MCCStatus.mrsSensorPacket.FWDVL53L1XRange = MRSSENsors->GetFWDLIDARRangeMM();
+	MCCStatus.mrsSensorPacket.FWDVL53L1XRange = senPacket.FWDVL53L1XRange;
+	MCCStatus.mrsSensorPacket.ODOSPosX = senPacket.ODOSPosX;
+	MCCStatus.mrsSensorPacket.ODOSPosY = senPacket.ODOSPosY;
+	MCCStatus.mrsSensorPacket.ODOSHdg = senPacket.ODOSHdg;
+	MCCStatus.mrsSensorPacket.ODOSVelX = senPacket.ODOSVelX;
+	MCCStatus.mrsSensorPacket.ODOSVelY = senPacket.ODOSVelY;
+	MCCStatus.mrsSensorPacket.ODOSVelHdg = senPacket.ODOSVelHdg;
+	MCCStatus.mrsSensorPacket.TurretPosition = senPacket.TurretPosition;
+	MCCStatus.mrsSensorPacket.TurretConfidence = senPacket.TurretConfidence;
+
+	MCCStatus.mrsSensorPacket.RINA219VBus = senPacket.RINA219VBus;
+	MCCStatus.mrsSensorPacket.RINA219VShunt = senPacket.RINA219VShunt;
+	MCCStatus.mrsSensorPacket.RINA219Current = senPacket.RINA219Current;
+	MCCStatus.mrsSensorPacket.RINA219Power = senPacket.RINA219Power;
+	MCCStatus.mrsSensorPacket.RINA219SOC = senPacket.RINA219SOC;
+	MCCStatus.mrsSensorPacket.RINA219Runtime = senPacket.RINA219Runtime;
+	MCCStatus.mrsSensorPacket.Timestamp = senPacket.Timestamp;
+	MCCStatus.mrsSensorPacket.Sequence = senPacket.Sequence;
+
+	// Repeated reads of the same MRS SEN snapshot carry the same timestamp and just replace the newest entry:
+	MCCStatus.PoseHistory.Add(senPacket.Timestamp, { senPacket.ODOSPosX, senPacket.ODOSPosY, senPacket.ODOSHdg });
+	MCCStatus.TurretHistory.Add(senPacket.Timestamp, senPacket.TurretPosition);
+
+	return success;
+}
+
+/// <summary>
+/// Reads just the MRS SEN forward range register; Safety priority I2C job run more often than UpdateMRSSEN()
+/// </summary>
+/// <returns>False if the read failed</returns>
+bool MCCSensors::UpdateRange()
+{
+	if (!MCCStatus.MRSSENModuleStatus)
+	{
+		return true;		// UpdateMRSSEN() re-tests the connection
 	}
-	else
+
+	uint32_t bytes = MRSSENsors->LastUpdateBytes;
+	uint32_t transactions = MRSSENsors->LastUpdateTransactions;
+	bool success = MRSSENsors->ReadRange();
+	I2CBusManager.Monitor.AddTraffic(I2CBusManager.Monitor.FindDevice(defaultMRSSENAddress),
+		MRSSENsors->LastUpdateBytes - bytes, MRSSENsors->LastUpdateTransactions - transactions);
+	if (!success)
 	{
-		_PL("MRS SEN I2C connection FAILED")
-		//return;
+		return false;
 	}
+	MCCStatus.mrsSensorPacket.FWDVL53L1XRange = MRSSENsors->GetFWDLIDARRangeMM();
+	MCCStatus.RangeHistory.Add(esp_timer_get_time(), MCCStatus.mrsSensorPacket.FWDVL53L1XRange);
+	RC2x15AMC.UpdateCollisionGuard(MCCStatus.mrsSensorPacket.FWDVL53L1XRange, MRSSENsors->GetTurretPosition(), millis());
+	return true;
+}
+
+/// <summary>
+/// Runs one clock synchronisation exchange with the MRS SEN module; Environment priority I2C job, as a delayed
+/// exchange only costs accuracy and is discarded by the MRS SEN ClockSync
+/// </summary>
+bool MCCSensors::SyncMRSSENClock()
+{
+	if (!MCCStatus.MRSSENModuleStatus)
+	{
+		return true;
+	}
+
+	uint32_t bytes = MRSSENsors->LastUpdateBytes;
+	uint32_t transactions = MRSSENsors->LastUpdateTransactions;
+	bool success = MRSSENsors->SyncClock(MCCStatus.SENClockResidual);
+	I2CBusManager.Monitor.AddTraffic(I2CBusManager.Monitor.FindDevice(defaultMRSSENAddress),
+		MRSSENsors->LastUpdateBytes - bytes, MRSSENsors->LastUpdateTransactions - transactions);
+	if (success)
+	{
+		MCCStatus.SENClockExchanges++;
+	}
+	return success;
+}
+
+/// <summary>
+/// Samples the left UPS bus voltage and current for the fuel gauge; Control priority I2C job
+/// </summary>
+/// <returns>False if an INA219 transaction failed</returns>
+bool MCCSensors::SampleBattery()
+{
+	if (!MCCStatus.WSUPS3SINA219Status)
+	{
+		return true;
+	}
+
+	float busVoltage = WSUPS3SINA219->getBusVoltage_V();
+	bool success = WSUPS3SINA219->success();
+	float current = WSUPS3SINA219->getCurrent_mA();
+	success = WSUPS3SINA219->success() && success;
+	I2CBusManager.Monitor.AddTraffic(I2CBusManager.Monitor.FindDevice(defaultINA219Address), INA219PairReadBytes, INA219PairReadTransactions);
+	if (!success)
+	{
+		return false;									// A failed read would feed the fuel gauge a bogus sample
+	}
+	MCCStatus.mrsSensorPacket.INA219VBus = busVoltage;
+	MCCStatus.mrsSensorPacket.INA219Current = current;
+	LUPSFuelGauge.AddSample(busVoltage, current);
+	return true;
+}
 
+/// <summary>
+/// Fetches the next chunk of a newly completed MRS SEN polar scan, adds it to the local map and queues it for
+/// forwarding to the CSSM;
+/// Environment priority I2C job, so scan transfers only use bus time left over by control traffic
+/// </summary>
+bool MCCSensors::UpdateScan()
+{
+	if (!MCCStatus.MRSSENModuleStatus || !MRSSENsors->IsScanPending())
+	{
+		return true;
+	}
 
+	uint32_t bytes = MRSSENsors->LastUpdateBytes;
+	uint32_t transactions = MRSSENsors->LastUpdateTransactions;
+	QueuedScanChunk entry;
+	bool success = MRSSENsors->ReadScanChunk(entry.Chunk);
+	I2CBusManager.Monitor.AddTraffic(I2CBusManager.Monitor.FindDevice(defaultMRSSENAddress),
+		MRSSENsors->LastUpdateBytes - bytes, MRSSENsors->LastUpdateTransactions - transactions);
+	if (success)
+	{
+		MCCMap.AddScanChunk(entry.Chunk, MCCStatus.mrsSensorPacket.ODOSPosX, MCCStatus.mrsSensorPacket.ODOSPosY,
+			MCCStatus.mrsSensorPacket.ODOSHdg);
+		entry.ReceivedTime = millis();
+		MCCStatus.ScanChunksFetched++;
+		if (!MCCStatus.ScanChunkQueue.Push(entry))
+		{
+			MCCStatus.ScanChunksDropped++;
+		}
+	}
+	return success || !MRSSENsors->IsScanPending();
 }
 
 bool MCCSensors::TestMRSSENCommunication()
@@ -192,11 +356,7 @@ bool MCCSensors::TestMRSSENCommunication()
 	testPacket.command = CSSMCommandPacket::CSSMCommandCodes::SetTurretPosition;
 	testPacket.turretPosition = 800;
 
-	Wire.beginTransmission(defaultMRSSENAddress);
-	size_t bytesWritten = Wire.write((uint8_t*)&testPacket, sizeof(CSSMCommandPacket));
-	Wire.endTransmission();
-
-	if (bytesWritten != sizeof(CSSMCommandPacket))
+	if (!SendMRSSENCommand(testPacket))
 	{
 		_PL("MRS Sensors I2C write FAILED")
 		success = false;
@@ -210,6 +370,39 @@ bool MCCSensors::TestMRSSENCommunication()
 	return success;
 }
 
+/// <summary>
+/// Queues a command for the MRS SEN module; ServiceMRSSENCommands() sends it and the outcome appears in
+/// MCCStatus.mrsSENCommandAck
+/// </summary>
+/// <param name="packet">Command to send</param>
+/// <returns>True if the command was queued</returns>
+bool MCCSensors::SendMRSSENCommand(const CSSMCommandPacket& packet)
+{
+	return MRSSENsors->SendCommand(packet);
+}
+
+/// <summary>
+/// Sends queued MRS SEN commands and confirms them from the command acknowledge register; Control priority I2C job,
+/// and the only caller of MRSSENsorsClass::ServiceCommands(), which owns the command sequence number
+/// </summary>
+bool MCCSensors::ServiceMRSSENCommands()
+{
+	if (!MCCStatus.MRSSENModuleStatus)
+	{
+		return true;		// Commands stay queued until UpdateMRSSEN() finds the module
+	}
+
+	uint32_t bytes = MRSSENsors->LastUpdateBytes;
+	uint32_t transactions = MRSSENsors->LastUpdateTransactions;
+	bool success = MRSSENsors->ServiceCommands();
+	I2CBusManager.Monitor.AddTraffic(I2CBusManager.Monitor.FindDevice(defaultMRSSENAddress),
+		MRSSENsors->LastUpdateBytes - bytes, MRSSENsors->LastUpdateTransactions - transactions);
+	MCCStatus.MRSSENCommandSequence = MRSSENsors->GetCommandSequence();
+	MCCStatus.mrsSENCommandAck = MRSSENsors->GetCommandAck();
+	MCCStatus.MRSSENCommandsFailed = MRSSENsors->CommandsFailed;
+	return success;
+}
+
 uint16_t MCCSensors::GetMCURawADC()
 {
 	return VMCU.GetAverageRawValue();
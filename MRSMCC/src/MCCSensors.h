@@ -23,10 +23,15 @@
 #include "Measurement.h"
 #include <Zanshin_BME680.h>
 constexpr byte defaultBME680Address = 0x76;			// Default (factory) I2C address of BME680 sensor
+constexpr uint16_t BME680ReadBytes = 21;				// Nominal bus traffic of one getSensorData() call (trigger + data read)
+constexpr uint8_t BME680ReadTransactions = 3;
 
 //#include <Adafruit_INA219.h>
 #include "INA219.h"
 constexpr byte defaultINA219Address = 0x41;			// I2C address of INA219 sensor on WaveShare UPS 3S module
+constexpr uint16_t INA219PairReadBytes = 14;			// Bus traffic of a voltage read plus a calibrated current or power read
+constexpr uint8_t INA219PairReadTransactions = 5;
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\BatteryFuelGauge.h"
 
 //constexpr byte defaultMRSSENAddress = 0x08;			// I2C address of MRS Sensors module on MCC I2C bus
 
@@ -60,14 +65,23 @@ protected:
 
 	//Adafruit_INA219* WSUPS3SINA219 = new Adafruit_INA219(defaultINA219Address);
 	INA219* WSUPS3SINA219 = new INA219(defaultINA219Address);
+	BatteryFuelGauge LUPSFuelGauge;					// Left WS UPS 3S pack state of charge
 
 	MRSSENsorsClass* MRSSENsors;
 
 public:
 	
 	bool Init();
-	void Update();
+	void Update();									// Analog measurements
+	bool UpdateEnvironment();						// I2C jobs run by I2CBusManager:
+	bool UpdateMRSSEN();
+	bool UpdateRange();
+	bool UpdateScan();
+	bool SyncMRSSENClock();
+	bool ServiceMRSSENCommands();
+	bool SampleBattery();							// High rate INA219 current / voltage sampling for the fuel gauge
 	bool TestMRSSENCommunication();
+	bool SendMRSSENCommand(const CSSMCommandPacket& packet);
 
 	uint16_t GetMCURawADC();
 	float GetMCUVoltageReal();
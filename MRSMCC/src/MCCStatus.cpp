@@ -11,11 +11,18 @@
 
 void MCCStatusClass::Init()
 {
+	PoseHistory.SetWindow(MCCPoseHistoryWindow);
+	TrackSpeedHistory.SetWindow(MCCChannelHistoryWindow);
+	MotorCurrentHistory.SetWindow(MCCChannelHistoryWindow);
+	RangeHistory.SetWindow(MCCChannelHistoryWindow);
+	TurretHistory.SetWindow(MCCChannelHistoryWindow);
+	Link.Init(CSSMDrivePacketInterval);
 }
 
 void MCCStatusClass::Update()
 {
 	CSSMESPNOWLinkStatus = (CSSMPacketReceivedCount != SaveCSSMPacketReceivedCount);
+	Link.Update(millis());
 
 	//TODO: Re-establich / re-synch UART communication with the motor controller; simply ending and re-beginning
 	//the UART does not see to work.  
@@ -50,5 +57,22 @@ void MCCStatusClass::ClearDebugText()
 	curDebugTextLine = 0;
 }
 
+/// <summary>
+/// Measures the interval since the last run of UpdateMotorControllerTask; call at the start of each run
+/// </summary>
+/// <param name="period">Task period, us</param>
+void MCCStatusClass::RecordMotorTaskStart(uint32_t period)
+{
+	uint32_t now = micros();
+	if (MotorTaskStartTime != 0)
+	{
+		uint32_t interval = now - MotorTaskStartTime;
+		MotorTaskJitter = (interval > period) ? interval - period : period - interval;
+		MaxMotorTaskJitter = max(MaxMotorTaskJitter, MotorTaskJitter);
+		AverageMotorTaskJitter += ((float)MotorTaskJitter - AverageMotorTaskJitter) * MotorTaskJitterSmoothing;
+	}
+	MotorTaskStartTime = now;
+}
+
 MCCStatusClass MCCStatus;
 
@@ -25,9 +25,30 @@
 #include "C:\Repos\MRS-VS2022\MRSCommon\src\RC2x15AMCStatusPacket.h"
 #include "C:\Repos\MRS-VS2022\MRSCommon\src\MRSStatusPacket.h"
 #include "C:\Repos\MRS-VS2022\MRSCommon\src\MRSSensorPacket.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\MRSSENRegisterMap.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\PolarScanChunkPacket.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\SPSCQueue.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\TimeSyncPacket.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\TimeHistory.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\LinkMonitor.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\LinkStatsPacket.h"
 
 constexpr uint8_t MAX_TEXT_LINES = 14;
 
+constexpr uint8_t ScanChunkQueueSize = 8;			// Holds up to 7 chunks; one 120 bin scan is 4 chunks
+
+constexpr uint16_t MCCHistorySize = 64;				// Entries per channel history
+constexpr uint32_t MCCPoseHistoryWindow = 10000;	// ms
+constexpr uint32_t MCCChannelHistoryWindow = 5000;	// ms; track speeds, motor currents, range and turret bearing
+constexpr float MotorTaskJitterSmoothing = 0.0625f;	// Weight of the latest interval in the average jitter
+constexpr float CSSMDrivePacketInterval = 100.0f;	// ms; nominal period of the CSSM's drive packets (SendCSSMPacketInterval)
+
+struct QueuedScanChunk
+{
+	PolarScanChunkPacket Chunk;
+	uint32_t ReceivedTime = 0;						// ms; added to the chunk Age when it is forwarded
+};
+
 class MCCStatusClass
 {
  protected:
@@ -69,13 +90,19 @@ class MCCStatusClass
 	 bool ESPNOWStatus = false;
 	 uint32_t CSSMPacketSentCount = 0;
 	 uint16_t SendRetries = 0;
+	 volatile bool ESPNOWSendInFlight = false;		// Set when a packet is handed to ESP-NOW; cleared by the send callback or ESPNOWSendTimeout
+	 uint32_t LastESPNOWSendTime = 0;				// ms
 
 	 uint32_t CSSMPacketReceivedCount = 0;
 	 uint32_t SaveCSSMPacketReceivedCount = 0;
 	 uint64_t LastCSSMPacketReceivedTime = 0;		// ms
+	 volatile uint32_t LastDrivePacketTime = 0;		// ms; CSSMDrivePacket receipt, for the WPT mode link timeout
 	 uint64_t CSSMPacketReceiptInterval = 0;		// ms
 	 String IncomingCSSMPacketMACString;
 	 bool CSSMESPNOWLinkStatus = false;
+	 LinkMonitorClass Link;							// This end's view of the ESP-NOW link (see LinkMonitor.h)
+	 LinkStatsPacket CSSMLinkStats;					// The CSSM's view of the link, as last reported by it
+	 uint32_t CSSMLinkStatsReceivedCount = 0;
 
 	 bool WiFiStatus = false;
 
@@ -87,6 +114,41 @@ class MCCStatusClass
 
 	 bool BME680Status = false;
 	 bool MRSSENModuleStatus = false;
+	 uint32_t MRSSENUpdateTime = 0;				// us; I2C bus time of the last MRS SEN update
+	 uint16_t MRSSENUpdateBytes = 0;			// Bytes on the wire during the last MRS SEN update
+	 uint32_t MRSSENSnapshotTime = 0;			// ms; last read of a new MRS SEN snapshot (sequence changed)
+	 uint8_t MRSSENUpdateTransactions = 0;
+	 uint8_t MRSSENCommandSequence = 0;			// Sequence number of the last command sent to MRS SEN
+	 MRSSENCommandAck mrsSENCommandAck;			// MRS SEN command acknowledge register as of the last read
+	 uint32_t MRSSENCommandsFailed = 0;			// Commands given up without an acknowledge
+
+	 SPSCQueue<QueuedScanChunk, ScanChunkQueueSize> ScanChunkQueue;	// Polar scan chunks waiting to be forwarded to the CSSM
+	 uint32_t ScanChunksFetched = 0;
+	 uint32_t ScanChunksDropped = 0;				// Scan chunk queue full
+	 uint32_t MapPacketsForwarded = 0;				// Scan chunks and map tiles sent to the CSSM
+	 uint32_t MapPacketsDropped = 0;				// ESP-NOW send error
+	 volatile bool MapTileInFlight = false;			// Set when a map tile is handed to ESP-NOW; cleared by the send callback
+	 volatile bool MapTileSendFailed = false;		// Its send callback reported failure; the tile is flagged for export again
+
+	 // The MCC's esp_timer_get_time() is the shared clock the other modules synchronise to (see ClockSync.h):
+	 SPSCQueue<TimeSyncPacket, 4> TimeSyncQueue;	// CSSM requests, stamped on receipt, waiting to be answered
+	 int32_t SENClockResidual = 0;					// us; as reported by the MRS SEN module
+	 int32_t CSSMClockResidual = 0;					// us; as reported by the CSSM
+	 uint32_t SENClockExchanges = 0;
+
+	 // Recent values of the key channels on the shared clock, for time aligned queries (see TimeHistory.h):
+	 TimeHistory<HistoryPose, MCCHistorySize> PoseHistory;				// OTOS pose (m, m, degrees)
+	 TimeHistory<HistoryPair, MCCHistorySize> TrackSpeedHistory;		// mm/s from the motor encoders
+	 TimeHistory<HistoryPair, MCCHistorySize> MotorCurrentHistory;		// As mcStatus.M2Current (left) and M1Current (right)
+	 TimeHistory<float, MCCHistorySize> RangeHistory;					// mm; forward VL53L1X
+	 TimeHistory<float, MCCHistorySize> TurretHistory;					// degrees, 0 - 360; does not wrap
+
+	 // Start to start interval of UpdateMotorControllerTask against its period, to check that other tasks (e.g. the
+	 //local display) are not holding it up:
+	 uint32_t MotorTaskStartTime = 0;				// us
+	 uint32_t MotorTaskJitter = 0;					// us; last interval's difference from the period
+	 uint32_t MaxMotorTaskJitter = 0;				// us
+	 float AverageMotorTaskJitter = 0.0f;			// us
 
 	 bool IMUStatus = false;
 
@@ -102,6 +164,7 @@ class MCCStatusClass
 	 void Update();
 	 void AddDebugTextLine(String newLine);
 	 void ClearDebugText();
+	 void RecordMotorTaskStart(uint32_t period);
 };
 
 extern MCCStatusClass MCCStatus;
@@ -17,16 +17,19 @@
 #endif
 
 constexpr uint8_t defaultMRSSENAddress = 0x08;			// I2C address of MRS Sensors module on MCC I2C bus
-
-constexpr uint8_t MRSSEN_ODOSPosXAddress = 0x01;		// SF ODOS X position address
-constexpr uint8_t MRSSEN_ODOSPosYAddress = 0x05;		// SF ODOS Y position address
-constexpr uint8_t MRSSEN_ODOSHdgAddress = 0x09;			// SF ODOS heading address
-constexpr uint8_t MRSSEN_FWDLIDARRangeAddress = 0x0D;	// FWDLIDAR range address
-constexpr uint8_t MRSSEN_TurretPositionAddress = 0x11;	// Sensor turret position address
+constexpr uint8_t MRSSENMaxMergeGap = 1;				// Clean registers tolerated inside one burst read rather than splitting it
+constexpr uint8_t MRSSENSnapshotRetries = 2;			// Re-reads of the pending registers when their bursts came from different snapshots
 
 #include <Wire.h>
+#include <esp_timer.h>
 #include "C:\Repos\MRS-VS2022\MRSCommon\src\CSSMCommandPacket.h"
 #include "C:\Repos\MRS-VS2022\MRSCommon\src\MRSSensorPacket.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\MRSSENRegisterMap.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\SPSCQueue.h"
+
+constexpr uint8_t MRSSENCommandQueueSize = 8;			// Commands waiting to be sent; power of two
+constexpr uint32_t MRSSENCommandAckTimeout = 100;		// ms without a matching acknowledge before a command is resent
+constexpr uint8_t MRSSENCommandRetries = 3;				// Resends before a command is given up
 
 class MRSSENsorsClass
 {
@@ -36,6 +39,23 @@ protected:
 	//int STPosition = 0;									// Current sensor turret position in steps
 	MRSSensorPacket mrsSensorPacket;                    // Sensor data packet from MRS Sensors module
 	CSSMCommandPacket cssmCommandPacket;                // Command packet to MRS Sensors module
+	uint32_t PendingMask = 0xFFFFFFFF;                  // Data registers still to be fetched; all on the first update
+	SPSCQueue<CSSMCommandPacket, MRSSENCommandQueueSize> CommandQueue;	// Commands waiting for ServiceCommands()
+	portMUX_TYPE CommandQueueMux = portMUX_INITIALIZER_UNLOCKED;		// SendCommand() may be called from several tasks
+	uint8_t CommandSequence = 0;                        // Sequence number of the last command sent; ServiceCommands() only
+	CSSMCommandPacket InFlightCommand;                  // Last command sent, until it is acknowledged or given up
+	bool CommandInFlight = false;
+	uint32_t CommandSendTime = 0;                       // ms; last (re)send of InFlightCommand
+	uint8_t CommandRetries = 0;                         // Resends of InFlightCommand so far
+	MRSSENCommandAck LastCommandAck;                    // Command acknowledge register as of the last read
+
+	bool WriteCommand(const CSSMCommandPacket& packet);
+	bool ScanPending = false;                           // A completed scan has been flagged and not all of it fetched
+	uint8_t NextScanChunk = 0;
+	uint8_t ScanChunkCount = 0;                         // Chunks in the pending scan; known once chunk 0 is read
+
+	bool SelectRegister(const uint8_t addr, const uint8_t length) const;
+	bool FetchPendingRegisters(MRSSensorPacket& packet, uint32_t& sequence, bool& consistent);
 
     template <typename T>
     uint8_t& getData(const uint8_t addr, T& value) const {
@@ -48,12 +68,12 @@ protected:
         */
         uint8_t* bytePtr = (uint8_t*)&value;            // Pointer to structure beginning
         static uint8_t structSize = sizeof(T);          // Number of bytes in structure
+        structSize = sizeof(T);
         if (_i2caddress)                                // Using I2C if address is non-zero
         {                                               //
-            //Wire.beginTransmission(_i2caddress);        // Address the I2C device
-            //Wire.write(addr);                           // Send register address to read
-            //Wire.endTransmission();                     // Close transmission
-            Wire.requestFrom(_i2caddress, sizeof(T));   // Request 1 byte of data
+            if (!SelectRegister(addr, sizeof(T)))       // Send register address and length to read
+                return structSize = 0;                  //
+            Wire.requestFrom(_i2caddress, sizeof(T));   // Request sizeof(T) bytes of data
             structSize = Wire.available();              // Use the actual number of bytes
             for (uint8_t i = 0; i < structSize; i++)
                 *bytePtr++ = Wire.read();               // loop for each byte to be read
@@ -79,6 +99,26 @@ public:
         }
 	}
     bool Update();
+    bool ReadRegisters(const uint8_t addr, uint8_t* data, const uint8_t length, uint32_t* sequence = nullptr);
+    bool ReadDirtyMask(uint32_t& mask, uint32_t& sequence);
+    bool AcknowledgeDirtyMask(const uint32_t mask);
+    bool SendCommand(const CSSMCommandPacket& packet);
+    bool ServiceCommands();
+    bool IsCommandInFlight() const { return CommandInFlight; }
+    uint8_t GetCommandSequence() const { return CommandSequence; }
+    bool ReadRange();
+    bool SyncClock(int32_t& residual);
+    bool IsScanPending() const { return ScanPending; }
+    bool ReadScanChunk(PolarScanChunkPacket& chunk);
+    MRSSENCommandAck GetCommandAck();
+    uint32_t CommandsResent = 0;
+    uint32_t CommandsFailed = 0;                        // Given up after MRSSENCommandRetries resends
+    uint32_t SnapshotMismatches = 0;                    // Update() fetches dropped because their bursts came from different snapshots
+
+    // Bus usage of the last Update():
+    uint32_t LastUpdateTime = 0;                        // us
+    uint16_t LastUpdateBytes = 0;                       // Bytes on the wire, including address bytes
+    uint8_t LastUpdateTransactions = 0;
 
     uint8_t getByte(const uint8_t addr) const {
         /*!
@@ -130,6 +170,7 @@ public:
 
     bool getMRSSensorPacket(MRSSensorPacket& /*packet*/);
 	int GetFWDLIDARRangeMM();
+	int GetTurretPosition();						// Degrees clockwise from the chassis forward axis
 };
 
 //extern MRSSENsorsClass MRSSENsors;
@@ -132,12 +132,12 @@ float MeasurementClass::GetAverageRealValue()
 String MeasurementClass::GetRealString()
 {
 	//TODO: Check whether 'n' in the snprintf function can be as high as the total capacity of the character buffer provided
-	snprintf(buf, 31, "%#5.2f %s", GetAverageRealValue(), Units);
+	snprintf(buf, 31, "%#5.2f %s", GetAverageRealValue(), Units.c_str());
 	return String(buf);
 }
 
 String MeasurementClass::GetRealString(String format)
 {
-	snprintf(buf, 31, (format + String(" %s")).c_str(), GetAverageRealValue(), Units);
+	snprintf(buf, 31, (format + String(" %s")).c_str(), GetAverageRealValue(), Units.c_str());
 	return String(buf);
 }
@@ -9,7 +9,9 @@
 #include "RC2x15AMC.h"
 #include "MCCStatus.h"
 #include "MCCSensors.h"
+#include "WaypointNavigator.h"
 #include <math.h>
+#include <esp_timer.h>
 
 bool RC2x15AMCClass::TestInProgress()
 {
@@ -50,7 +52,7 @@ bool RC2x15AMCClass::CalibrateDriveSystem(uint64_t testPeriod)
 			calibratingDrive = false;
 
 			MCCStatus.cssmDrivePacket.DriveMode = CSSMDrivePacket::DriveModes::STOP;
-			return RC2x15A->DutyM1M2(PSAddress, 0, 0);
+			return Stop(false);
 		}
 		else
 		{
@@ -333,6 +335,115 @@ bool RC2x15AMCClass::DriveSettingsChanged()
 			|| abs(MCCStatus.cssmDrivePacket.RThrottle - MCCStatus.lastCSSMDrivePacket.RThrottle) >= GAMMA);
 }
 
+/// <summary>
+/// Forward speed the MRS can travel at and still stop GuardStopDistance short of an obstacle at range, allowing for
+/// GuardLatency before braking starts; an obstacle moving towards the MRS (closing faster than the MRS is driving)
+/// reduces the limit by its own speed
+/// </summary>
+/// <param name="range">mm; 0 if the range is not known (the VL53L1X reported no valid range)</param>
+/// <param name="closingSpeed">mm/s</param>
+/// <param name="groundSpeed">mm/s; forward speed of the MRS</param>
+/// <returns>mm/s</returns>
+float RC2x15AMCClass::GetGuardLimit(uint16_t range, float closingSpeed, float groundSpeed)
+{
+	if (range == 0)
+	{
+		return GuardCreepSpeed;
+	}
+
+	float approachSpeed = max(0.0f, closingSpeed - max(0.0f, groundSpeed));
+	float distance = range - GuardStopDistance - approachSpeed * GuardLatency;
+	if (distance <= 0.0f)
+	{
+		return 0.0f;
+	}
+
+	// Solves v * GuardLatency + v^2 / (2 * GuardDeceleration) = distance for v:
+	float latencySpeed = GuardDeceleration * GuardLatency;
+	float limit = sqrtf(2.0f * GuardDeceleration * distance + latencySpeed * latencySpeed) - latencySpeed;
+	return max(0.0f, limit - approachSpeed);
+}
+
+/// <summary>
+/// Takes a new forward range; called by the Safety priority range read so the guard acts within one motor control
+/// tick of an obstacle being seen.  The VL53L1X is on the sensor turret, so a range taken while the turret is within
+/// GuardConeHalfAngle of the forward axis is projected onto it, and one taken further off is ignored; a scan sweeping
+/// the cone keeps the guard supplied.  A ray that leaves the path (GuardPathHalfWidth either side of the forward axis)
+/// before its return only shows the path clear that far.  Once no range has been taken for GuardRangeTimeout the
+/// range ahead is treated as unknown
+/// </summary>
+/// <param name="range">mm; 0 if the VL53L1X reported no valid range</param>
+/// <param name="turretPosition">Degrees clockwise from the forward axis when the range was read</param>
+/// <param name="readTime">millis() when the range was read</param>
+void RC2x15AMCClass::UpdateCollisionGuard(uint16_t range, int turretPosition, uint32_t readTime)
+{
+	int bearing = ((turretPosition % 360) + 360) % 360;
+	if (bearing > 180)
+	{
+		bearing -= 360;
+	}
+	if (abs(bearing) > GuardConeHalfAngle)
+	{
+		GuardRangesOutsideCone++;
+		return;
+	}
+
+	float radians = abs(bearing) * DEG_TO_RAD;
+	float forward = range * cosf(radians);
+	bool inPath = (range != 0 && range * sinf(radians) <= GuardPathHalfWidth);
+	if (range != 0 && !inPath)
+	{
+		forward = GuardPathHalfWidth / tanf(radians);
+	}
+
+	if (!inPath || !GuardRangeInPath)
+	{
+		ClosingSpeed = 0.0f;
+	}
+	else if (readTime != GuardRangeTime && abs(bearing - GuardBearing) <= GuardBearingTolerance)
+	{
+		float closingSpeed = (GuardRange - forward) * 1000.0f / (readTime - GuardRangeTime);
+		ClosingSpeed += GuardClosingSpeedWeight * (closingSpeed - ClosingSpeed);
+	}
+	GuardRange = (uint16_t)forward;
+	GuardRangeTime = readTime;
+	GuardBearing = bearing;
+	GuardRangeInPath = inPath;
+}
+
+/// <returns>mm/s; GuardNoLimit if the guard is disabled, at most GuardCreepSpeed while the range ahead is unknown</returns>
+float RC2x15AMCClass::GetGuardSpeedLimit()
+{
+	if (!CollisionGuardEnabled)
+	{
+		return GuardNoLimit;
+	}
+	if (GuardRangeTime == 0)
+	{
+		return GuardCreepSpeed;
+	}
+
+	float limit = GetGuardLimit(GuardRange, ClosingSpeed, MCCStatus.mcStatus.GroundSpeed);
+	if (millis() - GuardRangeTime > GuardRangeTimeout)
+	{
+		limit = min(limit, GuardCreepSpeed);
+	}
+	return limit;
+}
+
+/// <returns>True if the last command needs to be resent because the guard limit on it has changed</returns>
+bool RC2x15AMCClass::GuardNeedsUpdate()
+{
+	float limit = GetGuardSpeedLimit();
+	if (GuardClamping)
+	{
+		// A drop to a stop is always sent, however small, or the MRS creeps on at the last setting
+		return abs(limit - AppliedGuardLimit) >= GuardLimitStep || (limit <= 0.0f && AppliedGuardLimit > 0.0f);
+	}
+	float forwardSpeed = (CommandedLMotorSpeed / KLTrack + CommandedRMotorSpeed / KRTrack) / 2.0f;
+	return forwardSpeed > limit;
+}
+
 void RC2x15AMCClass::Update()
 {
 	bool success = false;
@@ -355,7 +466,7 @@ void RC2x15AMCClass::Update()
 	//	return;
 	//}
 	
-	success = RC2x15A->ReadPWMs(PS, data1, data2);
+	success = RC2x15A->ReadPWMs(PSAddress, data1, data2);
 	if (success)
 	{
 		MCCStatus.mcStatus.M1PWM = data1;
@@ -373,7 +484,7 @@ void RC2x15AMCClass::Update()
 		success = CalibrateDriveSystem(defaultTestDrivePeriod);
 	}
 
-	if (DriveSettingsChanged())
+	if (DriveSettingsChanged() || (MCCStatus.cssmDrivePacket.DriveMode == CSSMDrivePacket::DriveModes::WPT && WaypointNavigator.CommandChanged()))
 	{
 		// Determine the Drive method to use based on the current DriveMode:
 		switch (MCCStatus.cssmDrivePacket.DriveMode)
@@ -386,7 +497,8 @@ void RC2x15AMCClass::Update()
 
 			break;
 		case CSSMDrivePacket::DriveModes::WPT:
-
+			// Speed in mm/s and turn rate in rad/s from the path follower:
+			success = Drive(WaypointNavigator.GetSpeed(), WaypointNavigator.GetTurnRate());
 			break;
 		case CSSMDrivePacket::DriveModes::SEQ:
 
@@ -417,6 +529,10 @@ void RC2x15AMCClass::Update()
 			success = ReadStatus();
 		}
 	}
+	else if (GuardNeedsUpdate())
+	{
+		success = SetMotorSpeeds(CommandedLMotorSpeed, CommandedRMotorSpeed);
+	}
 	else
 	{
 		success = ReadStatus();
@@ -449,6 +565,11 @@ void RC2x15AMCClass::Update()
 	MCCStatus.mcStatus.Trip1Time = timeNow - Trip1StartTime;
 	MCCStatus.mcStatus.Trip2Time = timeNow - Trip2StartTime;
 	LastOdometryUpdateTime = timeNow;
+	MCCStatus.mcStatus.Timestamp = esp_timer_get_time();
+	// M1 is the right motor and M2 the left (see SetMotorSpeeds()):
+	MCCStatus.TrackSpeedHistory.Add(MCCStatus.mcStatus.Timestamp,
+		{ (float)MCCStatus.mcStatus.M2Speed / KLTrack, (float)MCCStatus.mcStatus.M1Speed / KRTrack });
+	MCCStatus.MotorCurrentHistory.Add(MCCStatus.mcStatus.Timestamp, { MCCStatus.mcStatus.M2Current, MCCStatus.mcStatus.M1Current });
 
 	// Save drive settings to test for changes next cycle:
 	MCCStatus.lastCSSMDrivePacket = MCCStatus.cssmDrivePacket;	// Using default C++ copy mechanism
@@ -462,6 +583,47 @@ void RC2x15AMCClass::Update()
 	//MCCStatus.RC2x15AUARTStatus = success;
 }
 
+/// <summary>
+/// Sends left and right motor speeds to the motor controller, first reducing their common (forward) component to
+/// the collision guard limit; the difference between them, and so the turn rate, is kept
+/// </summary>
+/// <param name="lMotorSpeed">qp/s</param>
+/// <param name="rMotorSpeed">qp/s</param>
+/// <returns>
+/// Returns success reported by serial communication with the RoboClaw 2x15A motor controller
+/// </returns>
+bool RC2x15AMCClass::SetMotorSpeeds(int32_t lMotorSpeed, int32_t rMotorSpeed)
+{
+	bool success = false;
+
+	CommandedLMotorSpeed = lMotorSpeed;
+	CommandedRMotorSpeed = rMotorSpeed;
+
+	AppliedGuardLimit = GetGuardSpeedLimit();
+	float excessSpeed = (lMotorSpeed / KLTrack + rMotorSpeed / KRTrack) / 2.0f - AppliedGuardLimit;	// mm/s
+	GuardClamping = (excessSpeed > 0.0f);
+	if (GuardClamping)
+	{
+		lMotorSpeed -= excessSpeed * KLTrack;
+		rMotorSpeed -= excessSpeed * KRTrack;
+		GuardInterventions++;
+	}
+
+	if (abs(lMotorSpeed) < 1 && abs(rMotorSpeed) < 1)
+	{
+		success = RC2x15A->DutyM1M2(PSAddress, 0, 0);
+	}
+	else
+	{
+		success = RC2x15A->SpeedM1M2(PSAddress, rMotorSpeed, lMotorSpeed);
+	}
+
+	MCCStatus.mcStatus.M1SpeedSetting = rMotorSpeed;
+	MCCStatus.mcStatus.M2SpeedSetting = lMotorSpeed;
+
+	return success;
+}
+
 /// <summary>
 /// Standard drive implementation given commanded ground speed and turn rate
 /// Converts commanded speed and trun rate values into motor speed settings for the left and right drive motors
@@ -479,8 +641,6 @@ void RC2x15AMCClass::Update()
 ///	</returns>
 bool RC2x15AMCClass::Drive(float vf, float wxy)
 {
-	bool success = false;
-
 	// Left and right motor speed settings in qp/s:
 	float wLSet = vf * KLTrack;
 	float wRSet = vf * KRTrack;
@@ -491,19 +651,7 @@ bool RC2x15AMCClass::Drive(float vf, float wxy)
 	int32_t lMotorSpeed = wLSet;
 	int32_t rMotorSpeed = wRSet;
 
-	if (abs(lMotorSpeed) < 1 && abs(rMotorSpeed) < 1)
-	{
-		success = RC2x15A->DutyM1M2(PSAddress, 0, 0);
-	}
-	else
-	{
-		success = RC2x15A->SpeedM1M2(PSAddress, rMotorSpeed, lMotorSpeed);
-	}
-
-	MCCStatus.mcStatus.M1SpeedSetting = rMotorSpeed;
-	MCCStatus.mcStatus.M2SpeedSetting = lMotorSpeed;
-
-	return success;
+	return SetMotorSpeeds(lMotorSpeed, rMotorSpeed);
 }
 
 /// <summary>
@@ -522,8 +670,6 @@ bool RC2x15AMCClass::Drive(float vf, float wxy)
 /// </returns>
 bool RC2x15AMCClass::DriveThrottleTurnRate(float throttle, float turnRate)
 {
-	bool success = false;
-
 	// Convert commanded speed and turn rate into motor speeds (qpps - quadrature pulses per second)
 	int32_t lMotorSpeed = throttle / 100.0f * M2qpps;
 	int32_t rMotorSpeed = throttle / 100.0f * M1qpps;
@@ -547,19 +693,7 @@ bool RC2x15AMCClass::DriveThrottleTurnRate(float throttle, float turnRate)
 	lMotorSpeed += turnDifferentialQPPS;
 	rMotorSpeed -= turnDifferentialQPPS;
 
-	if (abs(lMotorSpeed) < 1 && abs(rMotorSpeed) < 1)
-	{
-		success = RC2x15A->DutyM1M2(PSAddress, 0, 0);
-	}
-	else
-	{
-		success = RC2x15A->SpeedM1M2(PSAddress, rMotorSpeed, lMotorSpeed);
-	}
-
-	MCCStatus.mcStatus.M1SpeedSetting = rMotorSpeed;
-	MCCStatus.mcStatus.M2SpeedSetting = lMotorSpeed;
-
-	return success;
+	return SetMotorSpeeds(lMotorSpeed, rMotorSpeed);
 }
 
 /// <summary>
@@ -578,25 +712,11 @@ bool RC2x15AMCClass::DriveThrottleTurnRate(float throttle, float turnRate)
 /// </returns>
 bool RC2x15AMCClass::DriveLRThrottle(float lThrottle, float rThrottle)
 {
-	bool success = false;
-
 	// Convert provided throttle settings into motor speeds (qpps - quadrature pulses per second)
 	int32_t lMotorSpeed = lThrottle / 100.0f * M2qpps;
 	int32_t rMotorSpeed = rThrottle / 100.0f * M1qpps;
 
-	if (abs(lMotorSpeed) < 1 && abs(rMotorSpeed) < 1)
-	{
-		success = RC2x15A->DutyM1M2(PSAddress, 0, 0);
-	}
-	else
-	{
-		success = RC2x15A->SpeedM1M2(PSAddress, rMotorSpeed, lMotorSpeed);
-	}
-
-	MCCStatus.mcStatus.M1SpeedSetting = rMotorSpeed;
-	MCCStatus.mcStatus.M2SpeedSetting = lMotorSpeed;
-
-	return success;
+	return SetMotorSpeeds(lMotorSpeed, rMotorSpeed);
 }
 
 bool RC2x15AMCClass::DriveLRTrackSpeed(float leftTrackSpeed, float rightTrackSpeed)
@@ -620,6 +740,10 @@ bool RC2x15AMCClass::Stop(bool breaking)
 {
 	bool success = false;
 
+	CommandedLMotorSpeed = 0;
+	CommandedRMotorSpeed = 0;
+	GuardClamping = false;
+
 	if (breaking)
 	{
 		success = RC2x15A->SpeedM1M2(PSAddress, 0, 0);
@@ -34,6 +34,19 @@ constexpr float defaulTrackSpan = 185.5;				// mm;  horizontal distance between
 
 constexpr uint64_t defaultTestDrivePeriod = 15000;		// ms
 
+// Collision guard; limits forward speed so the MRS can stop short of the nearest range seen by the forward VL53L1X:
+constexpr float GuardDeceleration = 600.0f;				// mm/s^2; braking the guard plans on
+constexpr float GuardStopDistance = 150.0f;				// mm; range at which forward motion must have stopped
+constexpr float GuardLatency = 0.10f;					// s; range read + motor control tick + motor response
+constexpr float GuardCreepSpeed = 100.0f;				// mm/s; limit while the range ahead is unknown
+constexpr uint32_t GuardRangeTimeout = 250;				// ms without a forward range before it is unknown
+constexpr int GuardConeHalfAngle = 30;					// degrees; ranges taken with the turret further off are ignored
+constexpr float GuardPathHalfWidth = 150.0f;			// mm; half the width of the path ahead the guard keeps clear
+constexpr int GuardBearingTolerance = 2;				// degrees; ranges taken further apart are not compared for closing speed
+constexpr float GuardClosingSpeedWeight = 0.5f;			// Weight of each new closing speed estimate in the filtered value
+constexpr float GuardLimitStep = 10.0f;					// mm/s; smaller limit changes do not resend a clamped command
+constexpr float GuardNoLimit = 100000.0f;				// mm/s
+
 class RC2x15AMCClass
 {
 public:
@@ -82,6 +95,18 @@ protected:
 	uint64_t Trip2StartTime = 0;					// ms;
 	float Trip2StartDistance = 0.0f;				// m
 
+	int32_t CommandedLMotorSpeed = 0;				// qp/s; last drive command before the collision guard is applied
+	int32_t CommandedRMotorSpeed = 0;
+	uint16_t GuardRange = 0;						// mm ahead along the forward axis; 0 if the last range was not valid
+	uint32_t GuardRangeTime = 0;					// ms; millis() when GuardRange was read, 0 if never
+	int GuardBearing = 0;							// Degrees clockwise from the forward axis GuardRange was read at
+	bool GuardRangeInPath = false;					// GuardRange is an obstacle in the path, not where the ray left it
+	float AppliedGuardLimit = GuardNoLimit;			// mm/s; limit in force when the motor speeds were last set
+	bool GuardClamping = false;						// The last command sent was reduced by the guard
+
+	bool SetMotorSpeeds(int32_t lMotorSpeed, int32_t rMotorSpeed);
+	bool GuardNeedsUpdate();
+
 public:
 	bool Init();
 	bool ReadStatus();
@@ -94,6 +119,15 @@ public:
 	static void ResetTrip1();
 	static void ResetTrip2();
 
+	bool CollisionGuardEnabled = true;
+	float ClosingSpeed = 0.0f;						// mm/s; rate the forward range is shrinking, filtered
+	uint32_t GuardInterventions = 0;				// Drive commands reduced by the collision guard
+	uint32_t GuardRangesOutsideCone = 0;			// Ranges ignored because the turret was not looking ahead
+
+	static float GetGuardLimit(uint16_t range, float closingSpeed, float groundSpeed);
+	void UpdateCollisionGuard(uint16_t range, int turretPosition, uint32_t readTime);
+	float GetGuardSpeedLimit();
+
 	bool DriveSettingsChanged();
 	void Update();
 	bool Drive(float vf, float wxy);
@@ -0,0 +1,213 @@
+/*	WaypointNavigator.cpp
+*	WaypointNavigatorClass - Drives the MRS to the waypoint commanded in WPT mode
+*
+*	Mitchell Baldwin copyright 2025
+*
+*/
+
+#include "WaypointNavigator.h"
+#include "DEBUG Macros.h"
+
+constexpr float NavCommandThreshold = 0.10f;			// Changes smaller than this (mm/s, rad/s) are not resent
+constexpr uint8_t NavBenchmarkPlans = 50;
+
+/// <summary>
+/// Starts (or restarts) navigation to a goal; repeated calls with the same goal and sequence are ignored
+/// </summary>
+/// <param name="x">m, OTOS frame</param>
+/// <param name="y">m, OTOS frame</param>
+/// <param name="sequence">Changes each time the operator enters a waypoint, even the same one again</param>
+void WaypointNavigatorClass::SetGoal(float x, float y, uint8_t sequence)
+{
+	if (Active && x == GoalX && y == GoalY && sequence == GoalSequence)
+	{
+		return;
+	}
+	GoalX = x;
+	GoalY = y;
+	GoalSequence = sequence;
+	Active = true;
+	Arrived = false;
+	HavePath = false;
+	LastPlanTime = 0;								// Plan on the next Update()
+}
+
+void WaypointNavigatorClass::Stop()
+{
+	Active = false;
+	HavePath = false;
+	SetCommand(0.0f, 0.0f);
+}
+
+bool WaypointNavigatorClass::IsActive()
+{
+	return Active;
+}
+
+void WaypointNavigatorClass::Replan(float x, float y)
+{
+	HavePath = (Planner.Plan(x, y, GoalX, GoalY) == Planner.PlanOK);
+	NextWaypoint = 0;
+	LastPlanTime = millis();
+	Replans++;
+}
+
+void WaypointNavigatorClass::SetCommand(float speed, float turnRate)
+{
+	Speed = speed;
+	TurnRate = turnRate;
+}
+
+/// <summary>
+/// Replans if needed and updates the speed and turn rate towards the next waypoint
+/// </summary>
+/// <param name="x">OTOS position, m</param>
+/// <param name="y">OTOS position, m</param>
+/// <param name="heading">OTOS heading, degrees counterclockwise</param>
+void WaypointNavigatorClass::Update(float x, float y, float heading)
+{
+	if (!Active)
+	{
+		return;
+	}
+
+	if (hypotf(GoalX - x, GoalY - y) < WaypointAcceptanceRadius)
+	{
+		Arrived = true;
+		SetCommand(0.0f, 0.0f);
+		return;
+	}
+
+	int32_t originX, originY;
+	MCCMap.Grid.GetWindowOrigin(originX, originY);
+	int32_t goalCellX = MCCMap.Grid.GetCellIndex(GoalX) - originX;
+	int32_t goalCellY = MCCMap.Grid.GetCellIndex(GoalY) - originY;
+	uint16_t windowCells = MCCMap.Grid.WindowCells;
+	bool goalInWindow = goalCellX >= 0 && goalCellY >= 0 && goalCellX < windowCells && goalCellY < windowCells;
+
+	uint32_t sincePlan = millis() - LastPlanTime;
+	if (HavePath)
+	{
+		if (Planner.IsPathBlocked(x, y, NextWaypoint) || (!goalInWindow && sincePlan > NavDistantGoalReplanInterval))
+		{
+			Replan(x, y);
+		}
+	}
+	else if (LastPlanTime == 0 || sincePlan > NavFailedPlanRetryInterval)
+	{
+		Replan(x, y);
+	}
+
+	float waypointX, waypointY;
+	while (HavePath && Planner.GetWaypoint(NextWaypoint, waypointX, waypointY)
+		&& NextWaypoint < Planner.GetWaypointCount() - 1
+		&& hypotf(waypointX - x, waypointY - y) < WaypointAcceptanceRadius)
+	{
+		NextWaypoint++;
+	}
+	if (!HavePath || !Planner.GetWaypoint(NextWaypoint, waypointX, waypointY))
+	{
+		SetCommand(0.0f, 0.0f);
+		return;
+	}
+
+	float error = atan2f(waypointY - y, waypointX - x) * RAD_TO_DEG - heading;
+	while (error > 180.0f)
+	{
+		error -= 360.0f;
+	}
+	while (error < -180.0f)
+	{
+		error += 360.0f;
+	}
+
+	float turnRate = -constrain(NavTurnGain * error * DEG_TO_RAD, -NavMaxTurnRate, NavMaxTurnRate);	// Clockwise positive
+	float speed = (fabsf(error) > NavTurnInPlaceError) ? 0.0f : NavCruiseSpeed * cosf(error * DEG_TO_RAD);
+	SetCommand(speed, turnRate);
+}
+
+/// <summary>
+/// Returns true (once) when the speed or turn rate has changed enough to be sent to the motor controller
+/// </summary>
+bool WaypointNavigatorClass::CommandChanged()
+{
+	if (fabsf(Speed - LastSpeed) < NavCommandThreshold && fabsf(TurnRate - LastTurnRate) < NavCommandThreshold / 10.0f)
+	{
+		return false;
+	}
+	LastSpeed = Speed;
+	LastTurnRate = TurnRate;
+	return true;
+}
+
+/// <returns>mm/s</returns>
+float WaypointNavigatorClass::GetSpeed()
+{
+	return Speed;
+}
+
+/// <returns>rad/s, positive clockwise</returns>
+float WaypointNavigatorClass::GetTurnRate()
+{
+	return TurnRate;
+}
+
+String WaypointNavigatorClass::GetStatusString()
+{
+	char buf[80];
+	snprintf(buf, sizeof(buf), "WPT (%.2f,%.2f) plan %u: %u wpts %u cells %lu us",
+		GoalX, GoalY, Planner.LastResult, Planner.GetWaypointCount(), Planner.LastExpanded, (unsigned long)Planner.LastPlanTime);
+	return String(buf);
+}
+
+/// <summary>
+/// Times plans across a grid cluttered with random obstacles and prints the mean and worst plan times, so the
+/// replanning rate the MCC can sustain can be checked.  Each plan runs from the window centre to a random point on
+/// its edge, the longest plan Update() makes inside the window; the planner's arrays alone are about 22 kB
+/// </summary>
+void WaypointNavigatorClass::Benchmark()
+{
+	char buf[96];
+	OccupancyGrid<MCCMapTilesPerSide>* grid = new OccupancyGrid<MCCMapTilesPerSide>(MCCMapCellSize);
+	GridPathPlanner<MCCMapTilesPerSide>* planner = new GridPathPlanner<MCCMapTilesPerSide>(*grid);
+	if (grid == nullptr || planner == nullptr)
+	{
+		delete grid;
+		delete planner;
+		return;
+	}
+
+	randomSeed(1);
+	for (uint16_t i = 0; i < 400; i++)
+	{
+		grid->AddRay(0.0f, 0.0f, random(360), random(300, 1600));
+	}
+
+	uint32_t totalTime = 0;
+	uint32_t worstTime = 0;
+	uint32_t totalExpanded = 0;
+	uint8_t failures = 0;
+	float extent = MCCMapTilesPerSide * OccupancyTileSide * MCCMapCellSize / 2000.0f;	// m from centre to window edge
+	for (uint8_t i = 0; i < NavBenchmarkPlans; i++)
+	{
+		float bearing = random(360) * DEG_TO_RAD;
+		if (planner->Plan(0.0f, 0.0f, extent * cosf(bearing), extent * sinf(bearing)) != planner->PlanOK)
+		{
+			failures++;
+		}
+		totalTime += planner->LastPlanTime;
+		worstTime = max(worstTime, planner->LastPlanTime);
+		totalExpanded += planner->LastExpanded;
+	}
+
+	snprintf(buf, sizeof(buf), "Planner %u plans: mean %lu us, worst %lu us, %lu cells, %u failed",
+		NavBenchmarkPlans, (unsigned long)(totalTime / NavBenchmarkPlans), (unsigned long)worstTime,
+		(unsigned long)(totalExpanded / NavBenchmarkPlans), failures);
+	_PL(buf);
+
+	delete planner;
+	delete grid;
+}
+
+
+WaypointNavigatorClass WaypointNavigator;
@@ -0,0 +1,78 @@
+/*	WaypointNavigator.h
+*	WaypointNavigatorClass - Drives the MRS to the waypoint commanded in WPT mode, around obstacles in the MCC map
+*
+*	A GridPathPlanner on MCCMap.Grid turns the goal into a short list of smoothed waypoints; the follower steers
+*	towards the first waypoint not yet reached (turning in place when the heading error is large) and the speed and
+*	turn rate are applied by RC2x15AMC while the drive mode is WPT.  The path is replanned when the goal changes,
+*	when a map change blocks it, and periodically while the goal is beyond the edge of the map window.  The MCC
+*	only runs it while the operator has entered a waypoint and both the CSSM link and the OTOS pose are current.
+*
+*	Mitchell Baldwin copyright 2025
+*
+*	v 0.00:	Initial data structure
+*	v
+*
+*/
+
+#ifndef _WaypointNavigator_h
+#define _WaypointNavigator_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\GridPathPlanner.h"
+#include "MCCMap.h"
+
+constexpr float WaypointAcceptanceRadius = 0.10f;		// m
+constexpr float NavCruiseSpeed = 150.0f;				// mm/s
+constexpr float NavTurnGain = 2.0f;						// rad/s per rad of heading error
+constexpr float NavMaxTurnRate = 1.5f;					// rad/s
+constexpr float NavTurnInPlaceError = 45.0f;			// degrees; larger heading errors stop the robot to turn
+constexpr uint32_t NavDistantGoalReplanInterval = 2000;	// ms
+constexpr uint32_t NavFailedPlanRetryInterval = 1000;	// ms
+constexpr uint32_t NavCSSMLinkTimeout = 500;			// ms without a CSSMDrivePacket (sent every 100 ms) before stopping
+constexpr uint32_t NavPoseTimeout = 500;				// ms without a new MRS SEN snapshot (OTOS pose) before stopping
+
+class WaypointNavigatorClass
+{
+protected:
+	GridPathPlanner<MCCMapTilesPerSide> Planner{ MCCMap.Grid };
+
+	bool Active = false;
+	bool HavePath = false;
+	float GoalX = 0.0f;									// m
+	float GoalY = 0.0f;
+	uint8_t GoalSequence = 0;							// CSSMDrivePacket::WaypointSequence of the goal
+	uint8_t NextWaypoint = 0;
+	uint32_t LastPlanTime = 0;							// ms
+
+	float Speed = 0.0f;									// mm/s
+	float TurnRate = 0.0f;								// rad/s; positive clockwise, as RC2x15AMC::Drive()
+	float LastSpeed = 0.0f;
+	float LastTurnRate = 0.0f;
+
+	void Replan(float x, float y);
+	void SetCommand(float speed, float turnRate);
+
+public:
+	bool Arrived = false;
+	uint32_t Replans = 0;
+
+	void SetGoal(float x, float y, uint8_t sequence);
+	void Stop();
+	bool IsActive();
+	void Update(float x, float y, float heading);
+	bool CommandChanged();
+	float GetSpeed();
+	float GetTurnRate();
+	String GetStatusString();
+	void Benchmark();
+
+};
+
+extern WaypointNavigatorClass WaypointNavigator;
+
+#endif
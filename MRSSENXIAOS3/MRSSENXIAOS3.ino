@@ -55,7 +55,7 @@ long UpdateLocalDisplayPeriod = 100;	// ms
 void UpdateLocalDisplayCallback();
 Task UpdateLocalDisplayTask((UpdateLocalDisplayPeriod * TASK_MILLISECOND), TASK_FOREVER, &UpdateLocalDisplayCallback, &MainScheduler, false);
 
-long UpdateNavSensorsPeriod = 100;	// ms
+long UpdateNavSensorsPeriod = 20;	// ms; OTOS pose / velocity / acceleration burst read rate
 void UpdateNavSensorsCallback();
 Task UpdateNavSensorsTask((UpdateNavSensorsPeriod * TASK_MILLISECOND), TASK_FOREVER, &UpdateNavSensorsCallback, &MainScheduler, false);
 
@@ -63,24 +63,48 @@ long UpdateChassisSensorsPeriod = 100;	// ms
 void UpdateChassisSensorsCallback();
 Task UpdateChassisSensorsTask((UpdateChassisSensorsPeriod * TASK_MILLISECOND), TASK_FOREVER, &UpdateChassisSensorsCallback, &MainScheduler, false);
 
+long ServiceRangingPeriod = 2;		// ms; reads VL53L1X ranges flagged by its data ready interrupt
+void ServiceRangingCallback();
+Task ServiceRangingTask((ServiceRangingPeriod * TASK_MILLISECOND), TASK_FOREVER, &ServiceRangingCallback, &MainScheduler, false);
+
+long SampleBatteryPeriod = 20;		// ms
+void SampleBatteryCallback();
+Task SampleBatteryTask((SampleBatteryPeriod * TASK_MILLISECOND), TASK_FOREVER, &SampleBatteryCallback, &MainScheduler, false);
+
 long UpdateSTControlPeriod = 100;	// ms
 void UpdateSTControlCallback();
 Task UpdateSTControlTask((UpdateSTControlPeriod * TASK_MILLISECOND), TASK_FOREVER, &UpdateSTControlCallback, &MainScheduler, false);
 
+long ExecuteMCCCommandsPeriod = 10;	// ms
+void ExecuteMCCCommandsCallback();
+Task ExecuteMCCCommandsTask((ExecuteMCCCommandsPeriod * TASK_MILLISECOND), TASK_FOREVER, &ExecuteMCCCommandsCallback, &MainScheduler, false);
+
+long UpdateI2CBusMonitorPeriod = 100;	// ms; presence probes and background scanning (see I2CBusMonitor::Poll())
+constexpr long I2CBusReportPeriods = 50;	// The sensor bus profile is printed to Serial every 5 s
+void UpdateI2CBusMonitorCallback();
+Task UpdateI2CBusMonitorTask((UpdateI2CBusMonitorPeriod * TASK_MILLISECOND), TASK_FOREVER, &UpdateI2CBusMonitorCallback, &MainScheduler, false);
+
 #include "src/DEBUG Macros.h"
 
 #include <I2CBus.h>
 #include <Wire.h>
 TwoWire MCCI2CBus = TwoWire(1);			// MCC master I2C bus 
 constexpr uint8_t MCCI2CAddress = 0x08;	// MRS SEN I2C address on MCC bus
+constexpr uint32_t MCCI2CClock = 400000;	// Hz; the MCC negotiates fast mode with this module
 void MCCI2CReceiveEvent(int numBytes);
 void MCCI2CRequestEvent();
+volatile bool MCCRegisterMode = false;	// True when the MCC last selected a register; false for legacy full packet reads
 
 #include "src/MRSSENStatus.h"
 #include "src/MRSSENLocDisplay.h"
 #include "src/MRSNavSensors.h"
 #include "src/MRSChassisSensors.h"
 #include "src/STControl.h"
+#include "src/PolarSweepBuilder.h"
+#include "src/MRSSENRegisters.h"
+
+volatile CSSMCommandPacket::CSSMCommandCodes MCCLastCommand = CSSMCommandPacket::NoCommand;	// Last command packet received; NoCommand requests a full packet read
+uint8_t MCCLastQueuedSequence = 0;				// Sequence number of the last MCC command queued; 0 is never sent
 
 #include <Adafruit_NeoPixel.h>
 constexpr uint8_t FwdNeoPixelCount = 8;
@@ -100,21 +124,32 @@ void setup()
 	digitalWrite(BUILTIN_LED, LOW);
 
 	// Initialize I2C bus:
-	if (I2CBus.Init(DefaultSDA, DefaultSCL))
-	{
-		I2CBus.Scan();
-		_PL(I2CBus.GetActiveI2CAddressesString());
-	}
-	else
+	if (!I2CBus.Init(DefaultSDA, DefaultSCL))
 	{
 		HeartbeatLEDTogglePeriod = ErrorHeartbeatLEDToggleInterval;
 		_PL("Error initializing I2C bus...");
 	}
 
+	// Register the devices expected on the sensor bus and probe only their addresses; the rest of the range is
+	//swept in the background once the sensor tasks are running:
+	I2CBusMonitor& bus = mrsSENStatus.SENBusMonitor;
+	bus.Init(&Wire, "SEN", I2CStandardModeClock);
+	bus.AddDevice("OTOS", defaultOTOSAddress, I2CBusMonitor::OTOSDriver, I2CFastModeClock);
+	bus.AddDevice("VL53L1", defaultFwdVL53L1XAddress, I2CBusMonitor::VL53L1XDriver, I2CFastModePlusClock);
+	bus.AddDevice("INA219", defaultINA219Address, I2CBusMonitor::INA219Driver, I2CFastModePlusClock);
+	bus.AddDevice("RTC", defaultRTCAddress, I2CBusMonitor::PCF8563Driver, I2CFastModeClock);
+	bus.AddDevice("OLED", DefaultOLEDAddress, I2CBusMonitor::SSD1306Driver, I2CFastModeClock);
+	bus.ProbeDevices();
+	snprintf(buf, 31, "I2C boot probe %lu us", bus.BootProbeTime);
+	_PL(buf);
+	_PL(bus.GetPresentAddressesString(MaxI2CMonitoredDevices));
+
 	// Initialize MCC I2C bus:
+	mrsSENRegisters.Init();
 	MCCI2CBus.onReceive(MCCI2CReceiveEvent);								// Register event handler for receiving commands from MCC
 	MCCI2CBus.onRequest(MCCI2CRequestEvent);								// Register handler for MCC data requests
-	MCCI2CBus.begin(MCCI2CAddress, DefaultI2C1SDA, DefaultI2C1SCL, 100000);	// Set up I2C1 (Wire1) as I2C slave at 100 kHz
+	MCCI2CBus.begin(MCCI2CAddress, DefaultI2C1SDA, DefaultI2C1SCL, MCCI2CClock);	// Set up I2C1 (Wire1) as I2C slave
+	ExecuteMCCCommandsTask.enable();
 	//TODO: Verify MCC I2C bus initialization success:
 	//if (true)
 	//{
@@ -148,6 +183,11 @@ void setup()
 		HeartbeatLEDTogglePeriod = ErrorHeartbeatLEDToggleInterval;
 		_PL("Error initializing chassis sensors...");
 	}
+	ServiceRangingTask.enable();		// Idles until the forward VL53L1X is running, as it may be connected later
+	if (mrsSENStatus.INA219Status)
+	{
+		SampleBatteryTask.enable();
+	}
 	
 	mrsSENStatus.LocDispStatus = mrsSENLocDisplay.Init();
 	if (mrsSENStatus.LocDispStatus)
@@ -166,12 +206,31 @@ void setup()
 	ToggleHeartbeatLEDTask.setInterval(HeartbeatLEDTogglePeriod * TASK_MILLISECOND);
 	ToggleHeartbeatLEDTask.enable();
 
+	// Negotiate a clock for each sensor bus device now that all of them have been initialized:
+	bus.NegotiateClocks();
+	_PL(bus.GetReport());
+	bus.StartBackgroundScan();
+	UpdateI2CBusMonitorTask.enable();
+
 	STControl.Init();
 	UpdateSTControlTask.enable();
 	// Test code for STControl:
 	STControl.SetSTSpeedAndAccel(400, 50);
-	STControl.SetSTScanRange(-30, 30);
-	//STControl.StartSTScan();
+	PolarSweepBuilder.Configure(defaultSweepStartAngle, defaultSweepEndAngle, defaultSweepResolution, defaultSweepsPerSecond);
+	_PL(PolarSweepBuilder.GetStatusString());
+#ifdef _TEST_
+	// Coverage of each scan pattern against a simulated turret and room (see STScanPatternClass::Simulate()):
+	const char* patternNames[] = { "Sector sweep", "Dwell list", "Adaptive sweep", "Track nearest" };
+	char simBuf[64];
+	for (uint8_t pattern = 0; pattern < STScanPatternClass::PatternCount; pattern++)
+	{
+		float binsPerSecond, obstacleSamplesPerSecond;
+		STScanPatternClass::Simulate((STScanPatternClass::Patterns)pattern, 60, binsPerSecond, obstacleSamplesPerSecond);
+		snprintf(simBuf, sizeof(simBuf), "%-14s %5.2f bins/s %5.2f obstacle samples/s", patternNames[pattern], binsPerSecond, obstacleSamplesPerSecond);
+		_PL(simBuf);
+	}
+#endif
+	// Turret scanning is started and stopped by the CSSM (StartTurretScan / StopTurretScan, forwarded by the MCC)
 
 	// Initialize forward NeoPixel strip:
 	FwdNeoPixelStrip.begin();
@@ -255,80 +314,296 @@ void UpdateLocalDisplayCallback()
 	mrsSENLocDisplay.Update();
 }
 
+/// <summary>
+/// Commits the staging sensor packet after a sensor task has updated it, so the MCC is only ever served complete,
+/// consistent sets of readings
+/// </summary>
+void PublishSensorData()
+{
+	mrsSENStatus.CommitSensorPacket();
+	mrsSENRegisters.Publish(mrsSENStatus.mrsSensorPacket);
+}
+
 void UpdateNavSensorsCallback()
 {
 	mrsNavSensors.Update();
+	PublishSensorData();
 }
 
 void UpdateChassisSensorsCallback()
 {
 	MRSChassisSensors.Update();
+	PublishSensorData();
+}
+
+void ServiceRangingCallback()
+{
+	if (MRSChassisSensors.ServiceFwdVL53L1X())
+	{
+		PublishSensorData();
+	}
+}
+
+void SampleBatteryCallback()
+{
+	MRSChassisSensors.SampleBattery();
+	PublishSensorData();
+}
+
+void UpdateI2CBusMonitorCallback()
+{
+	mrsSENStatus.SENBusMonitor.Poll();
+	mrsSENStatus.SENBusMonitor.Update();
+	if (UpdateI2CBusMonitorTask.getRunCounter() % I2CBusReportPeriods == 0)
+	{
+		_PL(mrsSENStatus.SENBusMonitor.GetReport());
+		_PL(mrsSENStatus.SENClock.GetStatusString());
+		_PL(STControl.GetSTHomingStatusString());
+	}
 }
 
 void UpdateSTControlCallback()
 {
 	STControl.Update();
+	PolarSweepBuilder.Update();
+	PublishSensorData();
+	PublishPolarScan();
 }
 
 /// <summary>
-/// Handles an I2C receive event from the MCC: validates and reads an incoming CSSMCommandPacket, updates internal status, 
-/// and processes SetTurretPosition commands by moving the sensor turret if initialized.
+/// Hands each newly completed polar scan to the register file for transfer to the MCC
+/// </summary>
+void PublishPolarScan()
+{
+	static uint16_t lastScanID = 0;
+	if (PolarSweepBuilder.GetCompletedScanID() != lastScanID)
+	{
+		PolarScan scan;
+		PolarSweepBuilder.GetCompletedScan(scan);
+		mrsSENRegisters.PublishScan(scan);
+		lastScanID = scan.ScanID;
+	}
+}
+
+/// <summary>
+/// Handles an I2C receive event from the MCC: a 1 or 2 byte write selects the register served by the next read (see
+/// MRSSENRegisterMap.h); a dirty mask written back to its register clears the bits acknowledged; a CSSMCommandPacket is copied into the command queue and executed later by
+/// ExecuteMCCCommandsTask, and an MRSSENClockExchange written to the clock register is queued for SENClock.  Runs in the I2C driver context while the MCC waits, so nothing here may block or print.
 /// </summary>
 /// <param name="numBytes">The number of bytes received from the I2C bus.</param>
 void MCCI2CReceiveEvent(int numBytes)
 {
-	char buf[64];
-	uint8_t data[numBytes];
+	uint32_t startTime = micros();
+	uint8_t data[1 + sizeof(MRSSENClockExchange)];
 
-	// Currently only CSSMCommandPacket messages are expected from the MCC:
-	if (numBytes != sizeof(mrsSENStatus.cssmCommandPacket))
+	if (numBytes <= 0)
 	{
-		sprintf(buf, "MCCI2CReceiveEvent: Unexpected command packet size: %d bytes", numBytes);
-		_PL(buf);
 		return;
 	}
-	MCCI2CBus.readBytes(data, numBytes);	// Read incomming command packet
-	memcpy(&mrsSENStatus.cssmCommandPacket, data, sizeof(mrsSENStatus.cssmCommandPacket));
-	if (mrsSENStatus.cssmCommandPacket.command == mrsSENStatus.cssmCommandPacket.SetTurretPosition)
+
+	if (numBytes <= 2)
 	{
-		if (mrsSENStatus.SensorTurretMotorStatus)
+		// Register select:
+		MCCI2CBus.readBytes(data, numBytes);
+		mrsSENRegisters.Select(data, numBytes);
+		MCCRegisterMode = true;
+	}
+	else if (numBytes == 1 + sizeof(uint32_t) && MCCI2CBus.peek() == MRSSEN_DirtyMaskAddress)
+	{
+		uint32_t mask;
+		MCCI2CBus.readBytes(data, numBytes);
+		memcpy(&mask, &data[1], sizeof(mask));
+		mrsSENRegisters.AcknowledgeDirtyMask(mask);
+	}
+	else if (numBytes == sizeof(CSSMCommandPacket))
+	{
+		CSSMCommandPacket packet;
+		MCCI2CBus.readBytes(data, numBytes);
+		memcpy(&packet, data, sizeof(packet));
+		MCCRegisterMode = false;
+		MCCLastCommand = packet.command;
+		// A command resent by the MCC because its acknowledge was late is already queued or executed:
+		if (packet.command != CSSMCommandPacket::NoCommand && packet.sequence != MCCLastQueuedSequence)
+		{
+			if (mrsSENStatus.MCCCommandQueue.Push(packet))
+			{
+				MCCLastQueuedSequence = packet.sequence;
+				uint8_t depth = mrsSENStatus.MCCCommandQueue.GetCount();
+				if (depth > mrsSENStatus.MCCCommandQueueHighWater)
+				{
+					mrsSENStatus.MCCCommandQueueHighWater = depth;
+				}
+			}
+			else
+			{
+				MRSSENCommandAck ack;
+				ack.Sequence = packet.sequence;
+				ack.Command = packet.command;
+				ack.Status = MRSSENCommandAck::Dropped;
+				ack.QueueDepth = mrsSENStatus.MCCCommandQueue.GetCount();
+				mrsSENRegisters.SetCommandAck(ack);
+				mrsSENStatus.MCCCommandsDropped++;
+			}
+		}
+	}
+	else if (numBytes == 1 + sizeof(MRSSENClockExchange) && MCCI2CBus.peek() == MRSSEN_ClockAddress)
+	{
+		MRSSENClockExchange exchange;
+		MCCI2CBus.readBytes(data, numBytes);
+		memcpy(&exchange, &data[1], sizeof(exchange));
+		mrsSENStatus.ClockExchangeQueue.Push(exchange);
+	}
+	else
+	{
+		// Unexpected packet size; discard:
+		while (MCCI2CBus.available())
 		{
-			STControl.MoveST(mrsSENStatus.cssmCommandPacket.turretPosition, false);
-			//mrsSENStatus.mrsSensorPacket.TurretPosition = mrsSENStatus.cssmCommandPacket.turretPosition;
-			//mrsSENStatus.mrsSensorPacket.TurretPosition = SensorTurretMotor->getPositionAfterCommandsCompleted();
-			sprintf(buf, "Moving Sensor Turret to: %d steps", mrsSENStatus.cssmCommandPacket.turretPosition);
+			MCCI2CBus.read();
+		}
+		mrsSENStatus.MCCBadPackets++;
+	}
+
+	uint32_t elapsed = micros() - startTime;
+	mrsSENStatus.MCCReceiveTime = elapsed;
+	if (elapsed > mrsSENStatus.MCCReceiveMaxTime)
+	{
+		mrsSENStatus.MCCReceiveMaxTime = elapsed;
+	}
+}
+
+/// <summary>
+/// Executes one queued command from the MCC and records the outcome in the command acknowledge register
+/// </summary>
+/// <param name="packet">Command received from the MCC</param>
+void ExecuteMCCCommand(CSSMCommandPacket& packet)
+{
+	char buf[64];
+	MRSSENCommandAck ack;
+
+	ack.Sequence = packet.sequence;
+	ack.Command = packet.command;
+	mrsSENStatus.cssmCommandPacket = packet;
+
+	if (packet.command == CSSMCommandPacket::SetTurretPosition)
+	{
+		if (mrsSENStatus.SensorTurretMotorStatus && STControl.MoveST(packet.turretPosition, false))
+		{
+			sprintf(buf, "Moving Sensor Turret to: %d steps", packet.turretPosition);
 			_PL(buf);
+			ack.Status = MRSSENCommandAck::Accepted;
+		}
+		else
+		{
+			_PL("Error: SensorTurretMotor not initialized or homing");
+			ack.Status = MRSSENCommandAck::Rejected;
+		}
+	}
+	else if (packet.command == CSSMCommandPacket::StartTurretScan || packet.command == CSSMCommandPacket::StopTurretScan)
+	{
+		if (mrsSENStatus.SensorTurretMotorStatus)
+		{
+			if (packet.command == CSSMCommandPacket::StartTurretScan)
+			{
+				PolarSweepBuilder.Start();
+			}
+			else
+			{
+				PolarSweepBuilder.Stop();
+			}
+			ack.Status = MRSSENCommandAck::Accepted;
 		}
 		else
 		{
 			_PL("Error: SensorTurretMotor not initialized");
+			ack.Status = MRSSENCommandAck::Rejected;
 		}
 	}
-	else if (mrsSENStatus.cssmCommandPacket.command == mrsSENStatus.cssmCommandPacket.GetTurretPosition)
+	else if (packet.command == CSSMCommandPacket::HomeTurret)
 	{
-		size_t bytesWritten = 0;
-		// Cannot write data here; must be done in MCCI2CRequestEvent:
-		//bytesWritten = MCCI2CBus.slaveWrite((uint8_t*)&mrsSENStatus.mrsSensorPacket.TurretPosition, sizeof(int));
+		if (mrsSENStatus.SensorTurretMotorStatus)
+		{
+			STControl.HomeST();
+			ack.Status = MRSSENCommandAck::Accepted;
+		}
+		else
+		{
+			_PL("Error: SensorTurretMotor not initialized");
+			ack.Status = MRSSENCommandAck::Rejected;
+		}
 	}
-	else if (mrsSENStatus.cssmCommandPacket.command == mrsSENStatus.cssmCommandPacket.NoCommand)
+	else if (packet.command == CSSMCommandPacket::SetTurretAutoRehome)
 	{
-		size_t bytesWritten = 0;
-		// Cannot write data here; must be done in MCCI2CRequestEvent:
-		//bytesWritten = MCCI2CBus.slaveWrite((uint8_t*)&mrsSENStatus.mrsSensorPacket.TurretPosition, sizeof(int));
+		STControl.SetSTAutoRehome(packet.turretPosition != 0);
+		ack.Status = MRSSENCommandAck::Accepted;
+	}
+	else if (packet.command == CSSMCommandPacket::SetTurretScanPattern)
+	{
+		if (STControl.SetSTScanPattern((STScanPatternClass::Patterns)packet.turretPosition))
+		{
+			ack.Status = MRSSENCommandAck::Accepted;
+		}
+		else
+		{
+			sprintf(buf, "ExecuteMCCCommand: Unknown scan pattern %d", packet.turretPosition);
+			_PL(buf);
+			ack.Status = MRSSENCommandAck::Rejected;
+		}
+	}
+	else if (packet.command == CSSMCommandPacket::ConfigureFwdRanging)
+	{
+		VL53L1XDistanceModes mode = (packet.turretPosition & FwdRangingLongMode) ? VL53L1XLongMode : VL53L1XShortMode;
+		if (MRSChassisSensors.ConfigureFwdVL53L1X(packet.turretPosition & FwdRangingBudgetMask, mode,
+			(packet.turretPosition & FwdRangingZoneCycling) != 0))
+		{
+			ack.Status = MRSSENCommandAck::Accepted;
+		}
+		else
+		{
+			_PL("Error: Forward VL53L1X not initialized");
+			ack.Status = MRSSENCommandAck::Rejected;
+		}
+	}
+	else if (packet.command == CSSMCommandPacket::GetTurretPosition || packet.command == CSSMCommandPacket::GetFwdLIDARRange)
+	{
+		// Data is served from the register map (see MRSSENRegisterMap.h):
+		ack.Status = MRSSENCommandAck::Accepted;
 	}
 	else
 	{
-		_PL("MCCI2CReceiveEvent: Unknown command received from MCC");
+		sprintf(buf, "ExecuteMCCCommand: Unknown command 0x%02X received from MCC", packet.command);
+		_PL(buf);
+		ack.Status = MRSSENCommandAck::Unknown;
+	}
+
+	ack.QueueDepth = mrsSENStatus.MCCCommandQueue.GetCount();
+	mrsSENRegisters.SetCommandAck(ack);
+}
+
+void ExecuteMCCCommandsCallback()
+{
+	CSSMCommandPacket packet;
+	while (mrsSENStatus.MCCCommandQueue.Pop(packet))
+	{
+		ExecuteMCCCommand(packet);
+	}
+
+	// The MCC's clock reading is taken as the midpoint of its read, which is uncertain by half the round trip:
+	MRSSENClockExchange exchange;
+	while (mrsSENStatus.ClockExchangeQueue.Pop(exchange))
+	{
+		mrsSENStatus.SENClock.AddSample(exchange.SENReceiveTime, (exchange.MCCSendTime + exchange.MCCReceiveTime) / 2,
+			(uint32_t)(exchange.MCCReceiveTime - exchange.MCCSendTime));
+		mrsSENRegisters.SetClockResidual(mrsSENStatus.SENClock.ResidualOffset);
 	}
 }
 
 /// <summary>
-/// Writes the global MRSSensorPacket (mrsSENStatus.mrsSensorPacket) to the MCC I2C bus using MCCI2CBus.slaveWrite. 
-/// The function performs a raw byte write as an I2C slave and does not return a status.
+/// Serves the register selected by the last MCC register select write; for legacy reads (preceded by a NoCommand
+/// CSSMCommandPacket) writes the last committed MRSSensorPacket snapshot (see MRSSENStatus::CommitSensorPacket) to the
+/// MCC I2C bus using MCCI2CBus.slaveWrite.
 /// This function is called in response to an I2C request event from the MCC.
 /// 
 /// TODO: Consider adding error handling for write failures or incomplete writes.
-/// TODO: Develop individual functions to return specific sensor data on demand.
 /// 
 /// Note: Ensure that the MCC I2C master is prepared to read the exact size of MRSSensorPacket to avoid data corruption.
 /// </summary>
@@ -337,9 +612,19 @@ void MCCI2CRequestEvent()
 	char buf[64];
 
 	size_t bytesWritten = 0;
-	if (mrsSENStatus.cssmCommandPacket.command == CSSMCommandPacket::NoCommand)
+	if (MCCRegisterMode)
 	{
-		bytesWritten = MCCI2CBus.slaveWrite((uint8_t*)&mrsSENStatus.mrsSensorPacket, sizeof(MRSSensorPacket));
+		bytesWritten = mrsSENRegisters.Serve(MCCI2CBus);
+	}
+	else if (MCCLastCommand == CSSMCommandPacket::NoCommand)
+	{
+		static MRSSensorPacket servedPacket;
+		MRSSensorPacket packet;
+		if (mrsSENStatus.ReadSensorSnapshot(packet))
+		{
+			servedPacket = packet;
+		}
+		bytesWritten = MCCI2CBus.slaveWrite((uint8_t*)&servedPacket, sizeof(MRSSensorPacket));
 	}
 
 }
@@ -16,7 +16,7 @@ void INA219::wireWriteRegister(uint8_t reg, uint16_t value) {
   _i2c->write(reg);                 // Register
   _i2c->write((value >> 8) & 0xFF); // Upper 8-bits
   _i2c->write(value & 0xFF);        // Lower 8-bits
-  _i2c->endTransmission();
+  _success = (_i2c->endTransmission() == 0);
 }
 
 /*!
@@ -30,15 +30,22 @@ void INA219::wireReadRegister(uint8_t reg, uint16_t *value) {
 
   _i2c->beginTransmission(ina219_i2caddr);
   _i2c->write(reg); // Register
-  _i2c->endTransmission();
+  _success = (_i2c->endTransmission() == 0);
 
   delay(1); // Max 12-bit conversion time is 586us per sample
 
-  _i2c->requestFrom(ina219_i2caddr, (uint8_t)2);
+  _success = (_i2c->requestFrom(ina219_i2caddr, (uint8_t)2) == 2) && _success;
   // Shift values to create properly formed integer
   *value = ((_i2c->read() << 8) | _i2c->read());
 }
 
+/*!
+ *  @brief  Reports whether the I2C transactions of the last call succeeded
+ *  @return true if the last call's writes were acknowledged and its reads
+ *          returned all their bytes
+ */
+bool INA219::success() { return _success; }
+
 /*!
  *  @brief  Configures to INA219 to be able to measure up to 32V and 2A
  *          of current.  Each unit of current corresponds to 100uA, and
@@ -382,9 +389,11 @@ int16_t INA219::getCurrent_raw() {
   // not be available ... avoid this by always setting a cal
   // value even if it's an unfortunate extra step
   wireWriteRegister(INA219_REG_CALIBRATION, ina219_calValue);
+  bool calibrated = _success;
 
   // Now we can safely read the CURRENT register!
   wireReadRegister(INA219_REG_CURRENT, &value);
+  _success = _success && calibrated;
 
   return (int16_t)value;
 }
@@ -401,9 +410,11 @@ int16_t INA219::getPower_raw() {
   // not be available ... avoid this by always setting a cal
   // value even if it's an unfortunate extra step
   wireWriteRegister(INA219_REG_CALIBRATION, ina219_calValue);
+  bool calibrated = _success;
 
   // Now we can safely read the POWER register!
   wireReadRegister(INA219_REG_POWER, &value);
+  _success = _success && calibrated;
 
   return (int16_t)value;
 }
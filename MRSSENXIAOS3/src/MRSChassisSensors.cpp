@@ -8,6 +8,30 @@
 #include "MRSChassisSensors.h"
 #include "DEBUG Macros.h"
 #include "MRSSENStatus.h"
+#include "PolarSweepBuilder.h"
+
+/// <summary>
+/// Maps the raw RESULT__RANGE_STATUS register to the status reported by VL53L1X_GetRangeStatus()
+/// </summary>
+/// <returns>0 = valid range, 1 = sigma fail, 2 = signal fail, 4 = phase out of bounds, 7 = wrap around, 255 = other</returns>
+static uint8_t GetVL53L1XRangeStatus(uint8_t raw)
+{
+	static const uint8_t status[24] = { 255, 255, 255, 5, 2, 4, 1, 7, 3, 0, 255, 255, 9, 13, 255, 255, 255, 255, 10, 6, 255, 255, 11, 12 };
+	raw &= 0x1F;
+	return (raw < sizeof(status)) ? status[raw] : 255;
+}
+
+static volatile bool FwdVL53L1XDataReady = false;
+static volatile uint32_t FwdVL53L1XReadyTime = 0;	// us
+
+/// <summary>
+/// VL53L1X GPIO1 data ready ISR; only timestamps the event, as the I2C bus cannot be used from an ISR
+/// </summary>
+static void IRAM_ATTR FwdVL53L1XISR()
+{
+	FwdVL53L1XReadyTime = micros();
+	FwdVL53L1XDataReady = true;
+}
 
 bool MRSChassisSensorsClass::Init()
 {
@@ -19,6 +43,10 @@ bool MRSChassisSensorsClass::Init()
 	{
 		mrsSENStatus.INA219Status = true;
 		_PL("Right WS UPS 3S INA219 initialized")
+
+		bool restored = RUPSFuelGauge.Init("RUPSGauge", WSUPS3SINA219->getBusVoltage_V(), WSUPS3SINA219->getCurrent_mA());
+		sprintf(buf, "Right UPS SOC %3.0F%% (%s)", RUPSFuelGauge.GetSOC(), restored ? "NVS" : "OCV");
+		_PL(buf)
 	}
 	else
 	{
@@ -28,6 +56,28 @@ bool MRSChassisSensorsClass::Init()
 
 	// Initialize proximity & distance sensors:
 	FwdVL53L1X = new SFEVL53L1X();
+	pinMode(DefaultFwdVL53L1XIntPin, INPUT_PULLUP);
+	StartFwdVL53L1X();
+
+
+	return mrsSENStatus.INA219Status && mrsSENStatus.FwdVL53L1XStatus;
+}
+
+/// <summary>
+/// Configures the forward VL53L1X and starts continuous ranging; also used when the sensor reappears on the bus
+/// after dropping out (e.g. a loose cable), since it loses its configuration if it was power cycled
+/// </summary>
+bool MRSChassisSensorsClass::StartFwdVL53L1X()
+{
+	char buf[32];
+
+	const I2CBusMonitor::I2CDeviceInfo* info = mrsSENStatus.SENBusMonitor.GetDevice(
+		mrsSENStatus.SENBusMonitor.FindDevice(defaultFwdVL53L1XAddress));
+	if (info != nullptr)
+	{
+		FwdVL53L1XAppearances = info->Appearances;
+	}
+
 	mrsSENStatus.FwdVL53L1XStatus = !FwdVL53L1X->begin();
 	if (!mrsSENStatus.FwdVL53L1XStatus)
 	{
@@ -40,31 +90,343 @@ bool MRSChassisSensorsClass::Init()
 		mrsSENStatus.FwdVL53L1XSWVersion = buf;
 		_PL(buf)
 
-			FwdVL53L1X->startRanging();
+		// Short mode is the only one supporting a 15 ms timing budget:
+		if (FwdVL53L1XDistanceMode == VL53L1XShortMode)
+		{
+			FwdVL53L1X->setDistanceModeShort();
+		}
+		else
+		{
+			FwdVL53L1X->setDistanceModeLong();
+			FwdVL53L1XTimingBudget = max(FwdVL53L1XTimingBudget, (uint16_t)20);
+		}
+		FwdVL53L1X->setTimingBudgetInMs(FwdVL53L1XTimingBudget);
+		FwdVL53L1X->setIntermeasurementPeriod(FwdVL53L1XTimingBudget + VL53L1XInterMeasurementMargin);
+		FwdVL53L1XZone = 0;
+		SetFwdVL53L1XZone(0);
+		for (uint8_t i = 0; i < VL53L1XZoneCount; i++)
+		{
+			FwdVL53L1XZoneRange[i] = 0;
+		}
 
+		FwdVL53L1XDataReady = false;
+		FwdVL53L1XInterruptPolarity = FwdVL53L1X->getInterruptPolarity();
+		attachInterrupt(digitalPinToInterrupt(DefaultFwdVL53L1XIntPin), FwdVL53L1XISR,
+			FwdVL53L1XInterruptPolarity ? RISING : FALLING);
+		FwdVL53L1X->startRanging();
+		FwdVL53L1XLastReadyTime = micros();
 	}
 
+	return mrsSENStatus.FwdVL53L1XStatus;
+}
 
-	return mrsSENStatus.INA219Status && mrsSENStatus.FwdVL53L1XStatus;
+/// <summary>
+/// Burst reads forward VL53L1X registers
+/// </summary>
+/// <returns>True if the register index was acknowledged and all length bytes were received</returns>
+bool MRSChassisSensorsClass::ReadFwdVL53L1X(uint16_t reg, uint8_t* data, uint8_t length)
+{
+	Wire.beginTransmission(defaultFwdVL53L1XAddress);
+	Wire.write((uint8_t)(reg >> 8));
+	Wire.write((uint8_t)(reg & 0xFF));
+	if (Wire.endTransmission(false) != 0)
+	{
+		return false;
+	}
+	if (Wire.requestFrom(defaultFwdVL53L1XAddress, length) != length)
+	{
+		return false;
+	}
+	for (uint8_t i = 0; i < length; i++)
+	{
+		data[i] = Wire.read();
+	}
+	return true;
+}
+
+/// <summary>
+/// Burst writes forward VL53L1X registers
+/// </summary>
+/// <returns>True if the write was acknowledged</returns>
+bool MRSChassisSensorsClass::WriteFwdVL53L1X(uint16_t reg, const uint8_t* data, uint8_t length)
+{
+	Wire.beginTransmission(defaultFwdVL53L1XAddress);
+	Wire.write((uint8_t)(reg >> 8));
+	Wire.write((uint8_t)(reg & 0xFF));
+	Wire.write(data, length);
+	return (Wire.endTransmission() == 0);
+}
+
+/// <summary>
+/// Sets the forward VL53L1X region of interest to one of VL53L1XZones; applies from the next measurement
+/// </summary>
+bool MRSChassisSensorsClass::SetFwdVL53L1XZone(uint8_t zone)
+{
+	const VL53L1XZone& roi = VL53L1XZones[zone];
+	uint8_t data[2] = { roi.OpticalCentre, (uint8_t)(((roi.Height - 1) << 4) | (roi.Width - 1)) };
+	return WriteFwdVL53L1X(VL53L1XROICentreRegister, data, sizeof(data));
+}
+
+/// <summary>
+/// Sets the forward VL53L1X ranging parameters and restarts it if it is running
+/// </summary>
+/// <param name="timingBudget">ms; rounded to the nearest of 15 (short mode only), 20, 33, 50, 100, 200 or 500</param>
+/// <param name="distanceMode">Short mode trades range for ambient light immunity</param>
+/// <param name="zoneCycling">Measure each of VL53L1XZones in turn rather than only the full array</param>
+bool MRSChassisSensorsClass::ConfigureFwdVL53L1X(uint16_t timingBudget, VL53L1XDistanceModes distanceMode, bool zoneCycling)
+{
+	static const uint16_t budgets[] = { 15, 20, 33, 50, 100, 200, 500 };
+	uint8_t nearest = 0;
+	for (uint8_t i = 1; i < sizeof(budgets) / sizeof(budgets[0]); i++)
+	{
+		if (abs((int)budgets[i] - (int)timingBudget) < abs((int)budgets[nearest] - (int)timingBudget))
+		{
+			nearest = i;
+		}
+	}
+
+	FwdVL53L1XTimingBudget = budgets[nearest];
+	FwdVL53L1XDistanceMode = distanceMode;
+	FwdVL53L1XZoneCycling = zoneCycling;
+	if (!mrsSENStatus.FwdVL53L1XStatus)
+	{
+		return false;
+	}
+
+	I2CBusMonitor& bus = mrsSENStatus.SENBusMonitor;
+	int device = bus.FindDevice(defaultFwdVL53L1XAddress);
+	detachInterrupt(digitalPinToInterrupt(DefaultFwdVL53L1XIntPin));
+	bus.Select(device);
+	FwdVL53L1X->stopRanging();
+	bus.Deselect();
+	return StartFwdVL53L1X();
 }
 
 bool MRSChassisSensorsClass::Update()
 {
-	mrsSENStatus.mrsSensorPacket.RINA219VBus = WSUPS3SINA219->getBusVoltage_V();
-	mrsSENStatus.mrsSensorPacket.RINA219VShunt = WSUPS3SINA219->getShuntVoltage_mV();
-	mrsSENStatus.mrsSensorPacket.RINA219Current = WSUPS3SINA219->getCurrent_mA();
-	mrsSENStatus.mrsSensorPacket.RINA219Power = WSUPS3SINA219->getPower_mW();
+	I2CBusMonitor& bus = mrsSENStatus.SENBusMonitor;
+	int device;
+	uint32_t startTime;
 
-	// Read forward VL53L1X distance:
-	if (FwdVL53L1X->checkForDataReady())
+	// Bus voltage and current are sampled at a higher rate by SampleBattery():
+	if (mrsSENStatus.INA219Status)
 	{
-		mrsSENStatus.mrsSensorPacket.FWDVL53L1XRange = FwdVL53L1X->getDistance();
-		FwdVL53L1X->clearInterrupt();
+		device = bus.FindDevice(defaultINA219Address);
+		startTime = micros();
+		bus.Select(device);
+		float shuntVoltage = WSUPS3SINA219->getShuntVoltage_mV();
+		bool success = WSUPS3SINA219->success();
+		float power = WSUPS3SINA219->getPower_mW();
+		success = WSUPS3SINA219->success() && success;
+		bus.Deselect();
+		bus.Record(device, INA219PairReadBytes, INA219PairReadTransactions, micros() - startTime, success);
+		if (success)
+		{
+			mrsSENStatus.mrsSensorPacket.RINA219VShunt = shuntVoltage;
+			mrsSENStatus.mrsSensorPacket.RINA219Power = power;
+		}
+		mrsSENStatus.mrsSensorPacket.RINA219SOC = RUPSFuelGauge.GetSOC();
+		mrsSENStatus.mrsSensorPacket.RINA219Runtime = RUPSFuelGauge.GetRuntime();
 	}
 
+	// Forward VL53L1X ranges are read by ServiceFwdVL53L1X(); restart it if it has dropped off the bus and come back
+	//since last configured:
+	device = bus.FindDevice(defaultFwdVL53L1XAddress);
+	const I2CBusMonitor::I2CDeviceInfo* info = bus.GetDevice(device);
+	if (info != nullptr)
+	{
+		if (!info->Present)
+		{
+			mrsSENStatus.FwdVL53L1XStatus = false;
+			return true;
+		}
+		if (info->Appearances != FwdVL53L1XAppearances)
+		{
+			StartFwdVL53L1X();
+		}
+	}
 
 	return true;
 }
 
+/// <summary>
+/// Reads the forward VL53L1X range flagged by its data ready interrupt, then selects the next ROI zone while the
+/// sensor is idle between measurements; polls for data ready instead if no interrupt has arrived for longer than a
+/// measurement period.  Call at a high rate; returns quickly when there is nothing to read.
+/// </summary>
+/// <returns>True if a new range was read</returns>
+bool MRSChassisSensorsClass::ServiceFwdVL53L1X()
+{
+	if (!mrsSENStatus.FwdVL53L1XStatus)
+	{
+		return false;
+	}
+
+	I2CBusMonitor& bus = mrsSENStatus.SENBusMonitor;
+	int device = bus.FindDevice(defaultFwdVL53L1XAddress);
+	uint16_t bytes = 0;
+	uint8_t transactions = 0;
+	uint32_t startTime = micros();
+	uint32_t readyTime;
+	bool polled = false;
+
+	if (FwdVL53L1XDataReady)
+	{
+		readyTime = FwdVL53L1XReadyTime;
+		FwdVL53L1XDataReady = false;
+		bus.Select(device);
+	}
+	else
+	{
+		uint32_t period = (FwdVL53L1XTimingBudget + VL53L1XInterMeasurementMargin) * 1000UL;
+		if (startTime - FwdVL53L1XLastReadyTime < 2 * period || startTime - FwdVL53L1XLastPollTime < VL53L1XFallbackPollInterval)
+		{
+			return false;
+		}
+		FwdVL53L1XLastPollTime = startTime;
+		bus.Select(device);
+		bytes += VL53L1XPollBytes;
+		transactions += VL53L1XPollTransactions;
+		uint8_t status;
+		bool success = ReadFwdVL53L1X(VL53L1XDataReadyRegister, &status, sizeof(status));
+		if (!success || (status & 0x01) != FwdVL53L1XInterruptPolarity)
+		{
+			bus.Deselect();
+			bus.Record(device, bytes, transactions, micros() - startTime, success);
+			return false;
+		}
+		readyTime = startTime;
+		polled = true;
+	}
+
+	// One burst read from the range status register to the range register, then the interrupt clear:
+	uint8_t result[VL53L1XRangeRegister + 2 - VL53L1XRangeStatusRegister];
+	uint8_t clear = 0x01;
+	bool rangeRead = ReadFwdVL53L1X(VL53L1XRangeStatusRegister, result, sizeof(result));
+	bool success = WriteFwdVL53L1X(VL53L1XInterruptClearRegister, &clear, sizeof(clear)) && rangeRead;
+	bytes += VL53L1XRangeReadBytes;
+	transactions += VL53L1XRangeReadTransactions;
+
+	// The next measurement starts when the inter-measurement period expires, so a ROI set now applies to it:
+	uint8_t zone = FwdVL53L1XZone;
+	if (FwdVL53L1XZoneCycling)
+	{
+		if (SetFwdVL53L1XZone((zone + 1) % VL53L1XZoneCount))
+		{
+			FwdVL53L1XZone = (zone + 1) % VL53L1XZoneCount;
+		}
+		else
+		{
+			success = false;							// The next measurement repeats this zone
+		}
+		bytes += VL53L1XROIWriteBytes;
+		transactions += VL53L1XROIWriteTransactions;
+	}
+	bus.Deselect();
+	bus.Record(device, bytes, transactions, micros() - startTime, success);
+	if (!rangeRead)
+	{
+		return false;
+	}
+
+	VL53L1XSample sample;
+	sample.Time = readyTime - FwdVL53L1XTimingBudget * 500UL;
+	sample.Zone = zone;
+	sample.Range = ((uint16_t)result[VL53L1XRangeRegister - VL53L1XRangeStatusRegister] << 8)
+		| result[VL53L1XRangeRegister + 1 - VL53L1XRangeStatusRegister];
+	sample.RangeStatus = GetVL53L1XRangeStatus(result[0]);
+
+	FwdVL53L1XLastReadyTime = readyTime;
+	FwdVL53L1XReadLatency = micros() - readyTime;
+	if (polled)
+	{
+		FwdVL53L1XPolledSamples++;
+	}
+	else
+	{
+		FwdVL53L1XInterruptSamples++;
+	}
+	AddFwdVL53L1XSample(sample);
+
+	return true;
+}
+
+/// <summary>
+/// Stores a sample in the ring and updates the sensor packet (with the nearest range seen by any zone, 0 if none)
+/// and the turret sweep (with boresight ranges only)
+/// </summary>
+void MRSChassisSensorsClass::AddFwdVL53L1XSample(const VL53L1XSample& sample)
+{
+	FwdVL53L1XSamples[FwdVL53L1XSampleHead] = sample;
+	FwdVL53L1XSampleHead = (FwdVL53L1XSampleHead + 1) % VL53L1XSampleRingSize;
+	if (FwdVL53L1XSampleCount < VL53L1XSampleRingSize)
+	{
+		FwdVL53L1XSampleCount++;
+	}
+
+	// An invalid range (nothing in range, or a wrapped / low signal return) clears the zone, so an obstacle that has
+	//gone does not hold the MCC collision guard:
+	FwdVL53L1XZoneRange[sample.Zone] = (sample.RangeStatus == 0) ? sample.Range : 0;
+
+	uint16_t nearest = FwdVL53L1XZoneRange[sample.Zone];
+	if (FwdVL53L1XZoneCycling)
+	{
+		for (uint8_t i = 0; i < VL53L1XZoneCount; i++)
+		{
+			if (FwdVL53L1XZoneRange[i] != 0 && (nearest == 0 || FwdVL53L1XZoneRange[i] < nearest))
+			{
+				nearest = FwdVL53L1XZoneRange[i];
+			}
+		}
+	}
+	mrsSENStatus.mrsSensorPacket.FWDVL53L1XRange = nearest;
+
+	if (sample.RangeStatus == 0 && VL53L1XZones[sample.Zone].Bearing == 0)
+	{
+		PolarSweepBuilder.AddSample(sample.Range, sample.Time);
+	}
+}
+
+/// <summary>
+/// Returns a sample from the ring of recent forward VL53L1X measurements
+/// </summary>
+/// <param name="age">0 for the newest sample, 1 for the one before it, ...</param>
+/// <returns>False if fewer than age + 1 samples have been taken</returns>
+bool MRSChassisSensorsClass::GetFwdVL53L1XSample(uint8_t age, VL53L1XSample& sample)
+{
+	if (age >= FwdVL53L1XSampleCount)
+	{
+		return false;
+	}
+	sample = FwdVL53L1XSamples[(FwdVL53L1XSampleHead + VL53L1XSampleRingSize - 1 - age) % VL53L1XSampleRingSize];
+	return true;
+}
+
+void MRSChassisSensorsClass::SampleBattery()
+{
+	if (!mrsSENStatus.INA219Status)
+	{
+		return;
+	}
+
+	I2CBusMonitor& bus = mrsSENStatus.SENBusMonitor;
+	int device = bus.FindDevice(defaultINA219Address);
+	uint32_t startTime = micros();
+	bus.Select(device);
+	float busVoltage = WSUPS3SINA219->getBusVoltage_V();
+	bool success = WSUPS3SINA219->success();
+	float current = WSUPS3SINA219->getCurrent_mA();
+	success = WSUPS3SINA219->success() && success;
+	bus.Deselect();
+	bus.Record(device, INA219PairReadBytes, INA219PairReadTransactions, micros() - startTime, success);
+	if (!success)
+	{
+		return;											// A failed read would feed the fuel gauge a bogus sample
+	}
+	mrsSENStatus.mrsSensorPacket.RINA219VBus = busVoltage;
+	mrsSENStatus.mrsSensorPacket.RINA219Current = current;
+	RUPSFuelGauge.AddSample(busVoltage, current);
+}
+
 MRSChassisSensorsClass MRSChassisSensors;
 
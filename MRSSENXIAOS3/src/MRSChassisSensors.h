@@ -21,18 +21,105 @@
 
 #include "INA219.h"
 constexpr byte defaultINA219Address = 0x41;			// I2C address of INA219 sensor on WaveShare UPS 3S module
+constexpr uint16_t INA219PairReadBytes = 14;			// Bus traffic of a voltage read plus a calibrated current or power read
+constexpr uint8_t INA219PairReadTransactions = 5;
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\BatteryFuelGauge.h"
 #include <SparkFun_VL53L1X.h>
+constexpr uint8_t defaultFwdVL53L1XAddress = 0x29;
+constexpr int DefaultFwdVL53L1XIntPin = GPIO_NUM_44;	// VL53L1X GPIO1 (data ready) interrupt pin; XIAO D7
+
+// Ranging registers are read and written directly (rather than through SFEVL53L1X, which discards the I2C results)
+//so every transaction is checked; 16 bit register indices, see the VL53L1X ultra lite driver (ST UM2510):
+constexpr uint16_t VL53L1XROICentreRegister = 0x007F;	// ROI_CONFIG__USER_ROI_CENTRE_SPAD, then ..._REQUESTED_GLOBAL_XY_SIZE
+constexpr uint16_t VL53L1XInterruptClearRegister = 0x0086;	// SYSTEM__INTERRUPT_CLEAR
+constexpr uint16_t VL53L1XRangeStatusRegister = 0x0089;	// RESULT__RANGE_STATUS
+constexpr uint16_t VL53L1XRangeRegister = 0x0096;		// RESULT__FINAL_CROSSTALK_CORRECTED_RANGE_MM_SD0; big endian
+constexpr uint16_t VL53L1XDataReadyRegister = 0x0031;	// GPIO__TIO_HV_STATUS; bit 0 equals the interrupt polarity when ready
+constexpr uint16_t VL53L1XPollBytes = 5;				// Bus traffic of one data ready poll
+constexpr uint8_t VL53L1XPollTransactions = 2;
+constexpr uint16_t VL53L1XRangeReadBytes = 23;			// Bus traffic of the range status to range burst read and interrupt clear
+constexpr uint8_t VL53L1XRangeReadTransactions = 3;
+constexpr uint16_t VL53L1XROIWriteBytes = 5;			// Bus traffic of an ROI centre and size write
+constexpr uint8_t VL53L1XROIWriteTransactions = 1;
+
+enum VL53L1XDistanceModes
+{
+	VL53L1XShortMode,									// Up to 1.3 m; better ambient light immunity
+	VL53L1XLongMode										// Up to 4 m
+};
+constexpr uint16_t defaultVL53L1XTimingBudget = 33;		// ms; 15 (short mode only), 20, 33, 50, 100, 200 or 500
+constexpr VL53L1XDistanceModes defaultVL53L1XDistanceMode = VL53L1XLongMode;
+constexpr uint16_t VL53L1XInterMeasurementMargin = 4;	// ms idle between measurements, in which the ROI is changed
+constexpr uint32_t VL53L1XFallbackPollInterval = 5000;	// us; data ready polling rate when no interrupt arrives
+constexpr uint8_t VL53L1XSampleRingSize = 16;
+
+/// <summary>
+/// Region of interest of the VL53L1X SPAD array; narrowing it to one side of the array steers the sensor's field
+/// of view, so cycling through zones approximates a (coarse) multi-zone sensor
+/// </summary>
+struct VL53L1XZone
+{
+	uint8_t Width;										// SPADs, 4 - 16
+	uint8_t Height;
+	uint8_t OpticalCentre;								// SPAD number of the ROI centre (see ST UM2555)
+	int8_t Bearing;										// Degrees clockwise from the sensor boresight
+};
+
+// The receiver lens inverts the image, so the zone centred on the low numbered SPAD columns looks to the right:
+constexpr uint8_t VL53L1XZoneCount = 3;
+constexpr VL53L1XZone VL53L1XZones[VL53L1XZoneCount] =
+{
+	{ 16, 16, 199, 0 },									// Full array; boresight
+	{ 8, 16, 167, 7 },									// Right half
+	{ 8, 16, 231, -7 }									// Left half
+};
+
+/// <summary>
+/// One VL53L1X range measurement
+/// </summary>
+struct VL53L1XSample
+{
+	uint32_t Time = 0;									// micros() at the middle of the measurement
+	uint16_t Range = 0;									// mm
+	uint8_t RangeStatus = 0;							// 0 = valid; see VL53L1X_GetRangeStatus()
+	uint8_t Zone = 0;									// Index into VL53L1XZones
+};
 
 class MRSChassisSensorsClass
 {
 protected:
 	INA219* WSUPS3SINA219 = new INA219(defaultINA219Address);
+	BatteryFuelGauge RUPSFuelGauge;					// Right WS UPS 3S pack state of charge
 	SFEVL53L1X* FwdVL53L1X;
-
+	uint32_t FwdVL53L1XAppearances = 0;				// Bus registry appearance count when the VL53L1X was last configured
+	uint16_t FwdVL53L1XTimingBudget = defaultVL53L1XTimingBudget;
+	VL53L1XDistanceModes FwdVL53L1XDistanceMode = defaultVL53L1XDistanceMode;
+	bool FwdVL53L1XZoneCycling = false;
+	uint8_t FwdVL53L1XZone = 0;						// Zone of the measurement in progress
+	uint32_t FwdVL53L1XLastReadyTime = 0;			// us
+	uint32_t FwdVL53L1XLastPollTime = 0;			// us
+	uint8_t FwdVL53L1XInterruptPolarity = 1;		// GPIO1 level signalling data ready
+	VL53L1XSample FwdVL53L1XSamples[VL53L1XSampleRingSize];
+	uint8_t FwdVL53L1XSampleHead = 0;				// Index of the next sample to be written
+	uint8_t FwdVL53L1XSampleCount = 0;
+	uint16_t FwdVL53L1XZoneRange[VL53L1XZoneCount];	// mm; latest valid range from each zone
+	bool StartFwdVL53L1X();
+	bool ReadFwdVL53L1X(uint16_t reg, uint8_t* data, uint8_t length);
+	bool WriteFwdVL53L1X(uint16_t reg, const uint8_t* data, uint8_t length);
+	bool SetFwdVL53L1XZone(uint8_t zone);
+	void AddFwdVL53L1XSample(const VL53L1XSample& sample);
 
 public:
+	uint32_t FwdVL53L1XInterruptSamples = 0;
+	uint32_t FwdVL53L1XPolledSamples = 0;			// Read by the fallback poll; the interrupt line is missing or late
+	uint32_t FwdVL53L1XReadLatency = 0;				// us; from data ready to the range being read, last sample
+
 	bool Init();
 	bool Update();
+	bool ServiceFwdVL53L1X();						// Reads a range as soon as the VL53L1X signals data ready
+	bool ConfigureFwdVL53L1X(uint16_t timingBudget, VL53L1XDistanceModes distanceMode, bool zoneCycling);
+	bool GetFwdVL53L1XSample(uint8_t age, VL53L1XSample& sample);
+	void SampleBattery();							// High rate INA219 current / voltage sampling for the fuel gauge
 
 
 };
@@ -35,17 +35,21 @@ bool MRSNavSensors::Init()
 		OTOS->resetTracking();
 	}
 
-	// Initialize the RTC:
+	// Initialize the RTC; only set a default date if it has lost time (sample times are kept on the shared MCC
+	// clock, see ClockSync.h, so the RTC is only used for the wall clock date):
 	RTC = new PCF8563();
 	RTC->init();
-	RTC->stopClock();
-	RTC->setHour(0);
-	RTC->setMinut(0);
-	RTC->setSecond(0);
-	RTC->setYear(25);
-	RTC->setMonth(4);
-	RTC->setDay(25);
-	RTC->startClock();
+	if (!RTC->checkClockIntegrity())
+	{
+		RTC->stopClock();
+		RTC->setHour(0);
+		RTC->setMinut(0);
+		RTC->setSecond(0);
+		RTC->setYear(25);
+		RTC->setMonth(4);
+		RTC->setDay(25);
+		RTC->startClock();
+	}
 	mrsSENStatus.RTCStatus = RTC->checkClockIntegrity();
 	if (!mrsSENStatus.RTCStatus)
 	{
@@ -71,18 +75,102 @@ String MRSNavSensors::GetDateTimeString()
 	return String(buf);
 }
 
+/// <summary>
+/// Reads the OTOS position, velocity and acceleration in one burst and stores them as a timestamped sample; the RTC
+/// is read once every RTCReadInterval
+/// </summary>
 void MRSNavSensors::Update()
 {
-	// Read the OTOS IMU data:
-	sfe_otos_pose2d_t pose;
-	OTOS->getPosition(pose);
-	mrsSENStatus.mrsSensorPacket.ODOSPosX = pose.x;
-	mrsSENStatus.mrsSensorPacket.ODOSPosY = pose.y;
-	mrsSENStatus.mrsSensorPacket.ODOSHdg = pose.h;
+	I2CBusMonitor& bus = mrsSENStatus.SENBusMonitor;
+
+	// Read the OTOS pose, velocity and acceleration:
+	NavSample sample;
+	int device = bus.FindDevice(defaultOTOSAddress);
+	int64_t startTime = esp_timer_get_time();
+	bus.Select(device);
+	sfeTkError_t result = OTOS->getPosVelAcc(sample.Pose, sample.Velocity, sample.Acceleration);
+	bus.Deselect();
+	int64_t endTime = esp_timer_get_time();
+	bus.Record(device, OTOSPosVelAccReadBytes, OTOSPosVelAccReadTransactions, endTime - startTime, result == kSTkErrOk);
+	if (result == kSTkErrOk)
+	{
+		sample.Time = (startTime + endTime) / 2;
+		Samples[SampleHead] = sample;
+		SampleHead = (SampleHead + 1) % NavSampleRingSize;
+		if (SampleCount < NavSampleRingSize)
+		{
+			SampleCount++;
+		}
+		SamplesTaken++;
+
+		mrsSENStatus.mrsSensorPacket.ODOSPosX = sample.Pose.x;
+		mrsSENStatus.mrsSensorPacket.ODOSPosY = sample.Pose.y;
+		mrsSENStatus.mrsSensorPacket.ODOSHdg = sample.Pose.h;
+		mrsSENStatus.mrsSensorPacket.ODOSVelX = sample.Velocity.x;
+		mrsSENStatus.mrsSensorPacket.ODOSVelY = sample.Velocity.y;
+		mrsSENStatus.mrsSensorPacket.ODOSVelHdg = sample.Velocity.h;
+	}
+	else
+	{
+		ReadFailures++;
+	}
 
 	// Update the RTC time:
-	mrsSENStatus.RTCtime = RTC->getTime();
+	if (endTime - LastRTCReadTime >= RTCReadInterval)
+	{
+		LastRTCReadTime = endTime;
+		device = bus.FindDevice(defaultRTCAddress);
+		startTime = esp_timer_get_time();
+		bus.Select(device);
+		bool success = ReadRTCTime(mrsSENStatus.RTCtime);
+		bus.Deselect();
+		bus.Record(device, RTCTimeReadBytes, RTCTimeReadTransactions, esp_timer_get_time() - startTime, success);
+	}
+}
+
+/// <summary>
+/// Reads the RTC time registers in one burst; read directly rather than with PCF8563::getTime(), which does not
+/// report a failed read
+/// </summary>
+/// <param name="time">Updated only if the read succeeds; the weekday is not read</param>
+/// <returns>True if the register address was acknowledged and all the time registers were received</returns>
+bool MRSNavSensors::ReadRTCTime(Time& time)
+{
+	uint8_t data[7];
+	Wire.beginTransmission(defaultRTCAddress);
+	Wire.write(RTCTimeRegister);
+	if (Wire.endTransmission() != 0 || Wire.requestFrom(defaultRTCAddress, sizeof(data)) != sizeof(data))
+	{
+		return false;
+	}
+	for (uint8_t i = 0; i < sizeof(data); i++)
+	{
+		data[i] = Wire.read();
+	}
+
+	auto fromBCD = [](uint8_t bcd) { return (uint8_t)((bcd >> 4) * 10 + (bcd & 0x0F)); };
+	time.second = fromBCD(data[0] & 0x7F);
+	time.minute = fromBCD(data[1] & 0x7F);
+	time.hour = fromBCD(data[2] & 0x3F);
+	time.day = fromBCD(data[3] & 0x3F);
+	time.month = fromBCD(data[5] & 0x1F);
+	time.year = fromBCD(data[6]);
+	return true;
+}
 
+/// <summary>
+/// Returns a sample from the ring of recent OTOS reads
+/// </summary>
+/// <param name="age">0 for the newest sample, 1 for the one before it, ...</param>
+/// <returns>False if fewer than age + 1 samples have been taken</returns>
+bool MRSNavSensors::GetSample(uint8_t age, NavSample& sample)
+{
+	if (age >= SampleCount)
+	{
+		return false;
+	}
+	sample = Samples[(SampleHead + NavSampleRingSize - 1 - age) % NavSampleRingSize];
+	return true;
 }
 
 
@@ -27,7 +27,27 @@
 #endif
 
 #include <SparkFun_Qwiic_OTOS_Arduino_Library.h>
+constexpr uint8_t defaultOTOSAddress = 0x17;
+constexpr uint16_t OTOSPosVelAccReadBytes = 21;		// Bus traffic of one getPosVelAcc() burst
+constexpr uint8_t OTOSPosVelAccReadTransactions = 2;
 #include <PCF8563.h>
+constexpr uint8_t defaultRTCAddress = 0x51;
+constexpr uint8_t RTCTimeRegister = 0x02;				// VL_seconds; seconds to years follow in BCD
+constexpr uint16_t RTCTimeReadBytes = 10;				// Bus traffic of one ReadRTCTime() call
+constexpr uint8_t RTCTimeReadTransactions = 2;
+constexpr int64_t RTCReadInterval = 1000000;			// us
+constexpr uint8_t NavSampleRingSize = 8;
+
+/// <summary>
+/// One OTOS burst read
+/// </summary>
+struct NavSample
+{
+	int64_t Time = 0;									// us since boot (esp_timer_get_time()) at the middle of the read
+	sfe_otos_pose2d_t Pose{};							// m, m, degrees
+	sfe_otos_pose2d_t Velocity{};						// m/s, m/s, degrees/s
+	sfe_otos_pose2d_t Acceleration{};					// m/s^2, m/s^2, degrees/s^2
+};
 
 class MRSNavSensors
 {
@@ -35,11 +55,21 @@ protected:
 	QwiicOTOS* OTOS;
 	PCF8563* RTC;
 
+	NavSample Samples[NavSampleRingSize];
+	uint8_t SampleHead = 0;								// Index of the next sample to be written
+	uint8_t SampleCount = 0;
+	int64_t LastRTCReadTime = -RTCReadInterval;			// us
+	bool ReadRTCTime(Time& time);
+
 public:
+	uint32_t SamplesTaken = 0;
+	uint32_t ReadFailures = 0;
+
 	bool Init();
 	String GetDateTimeString();
 
 	void Update();
+	bool GetSample(uint8_t age, NavSample& sample);
 
 };
 
@@ -7,6 +7,7 @@
 #include "MRSSENLocDisplay.h"
 #include "DEBUG Macros.h"
 #include "MRSSENStatus.h"
+#include "MRSChassisSensors.h"
 
 bool MRSSENLocDisplay::Init()
 {
@@ -102,6 +103,12 @@ void MRSSENLocDisplay::Update()
 	display->setCursor(0, 10);
 	display->write("OTOS:");
 
+	// MCC command queue depth / high water and longest I2C receive handler call:
+	snprintf(buf, 31, "Q%u/%u %4luus", mrsSENStatus.MCCCommandQueue.GetCount(), mrsSENStatus.MCCCommandQueueHighWater,
+		mrsSENStatus.MCCReceiveMaxTime);
+	display->setCursor(42, 10);
+	display->write(buf);
+
 	snprintf(buf, 31, "(%6.3f,%6.3f) m", mrsSENStatus.mrsSensorPacket.ODOSPosX, mrsSENStatus.mrsSensorPacket.ODOSPosY);
 	display->setCursor(10, 20);
 	display->write(buf);
@@ -110,14 +117,24 @@ void MRSSENLocDisplay::Update()
 	display->setCursor(10, 30);
 	display->write(buf);
 
-	snprintf(buf, 31, "FwdVL53L1X %4d mm", mrsSENStatus.mrsSensorPacket.FWDVL53L1XRange);
+	// Nearest range over all zones, and the range status of the newest measurement (0 = valid):
+	VL53L1XSample sample;
+	uint8_t status = MRSChassisSensors.GetFwdVL53L1XSample(0, sample) ? sample.RangeStatus : 255;
+	snprintf(buf, 31, "Fwd %4d mm st %3u", mrsSENStatus.mrsSensorPacket.FWDVL53L1XRange, status);
 	display->setCursor(10, 40);
 	display->write(buf);
 
 	display->setCursor(10, 50);
 	display->write(mrsSENStatus.GetDateTimeString().c_str());
 	
+	// The SSD1306 driver sets its own (fast mode) clock for the transfer and restores standard mode afterwards:
+	uint32_t startTime = micros();
 	display->display();
+	// Adafruit_SSD1306 does not report bus errors, so check that the display still acknowledges its address:
+	Wire.beginTransmission(DefaultOLEDAddress);
+	bool success = (Wire.endTransmission() == 0);
+	mrsSENStatus.SENBusMonitor.Record(mrsSENStatus.SENBusMonitor.FindDevice(DefaultOLEDAddress), OLEDFrameBytes + 1,
+		OLEDFrameTransactions + 1, micros() - startTime, success);
 }
 
 
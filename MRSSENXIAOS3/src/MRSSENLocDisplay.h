@@ -26,6 +26,8 @@
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
 constexpr uint8_t DefaultOLEDAddress = 0x3C;
+constexpr uint16_t OLEDFrameBytes = 1050;				// Bus traffic of one display() call (1024 pixel bytes plus framing)
+constexpr uint8_t OLEDFrameTransactions = 10;
 constexpr uint8_t SCREEN_WIDTH = 128;
 constexpr uint8_t SCREEN_HEIGHT = 64;
 constexpr int8_t OLED_RESET = -1;				// Reset pin # (or -1 if sharing Arduino reset pin)
@@ -0,0 +1,216 @@
+/*	MRSSENRegisters.cpp
+*	MRSSENRegistersClass - I2C slave register file served to the MRS MCC
+*
+*/
+
+#include "MRSSENRegisters.h"
+#include "MRSSENStatus.h"
+
+bool MRSSENRegistersClass::Init()
+{
+	MRSSENRegisterMap::Encode(mrsSENStatus.mrsSensorPacket, Staging.Data);
+	Staging.Sequence = mrsSENStatus.mrsSensorPacket.Sequence;
+	Served = Staging;
+	Snapshot.Publish(Staging);
+	DirtyMask.store(0xFFFFFFFF);
+
+	return true;
+}
+
+/// <summary>
+/// Copies the latest sensor data into the register image, publishes the image and flags the data registers whose
+/// contents changed; call from the main loop after mrsSENStatus.CommitSensorPacket()
+/// </summary>
+/// <param name="packet">Committed sensor packet</param>
+void MRSSENRegistersClass::Publish(MRSSensorPacket& packet)
+{
+	uint8_t newImage[MRSSEN_DataEndAddress];
+	uint32_t changed = 0;
+
+	MRSSENRegisterMap::Encode(packet, newImage);
+	for (uint8_t i = 0; i < MRSSEN_DataRegisterCount; i++)
+	{
+		uint8_t address = MRSSENRegisterMap::GetRegisterAddress(i);
+		if (memcmp(&Staging.Data[address], &newImage[address], MRSSEN_RegisterSize) != 0)
+		{
+			memcpy(&Staging.Data[address], &newImage[address], MRSSEN_RegisterSize);
+			changed |= (1UL << i);
+		}
+	}
+	Staging.Data[MRSSEN_VersionAddress] = newImage[MRSSEN_VersionAddress];
+	Staging.Sequence = packet.Sequence;
+	Snapshot.Publish(Staging);
+
+	if (changed)
+	{
+		DirtyMask.fetch_or(changed);
+	}
+	PublishCount++;
+}
+
+/// <summary>
+/// Publishes a completed polar scan for transfer to the MCC and flags it in the dirty mask
+/// </summary>
+void MRSSENRegistersClass::PublishScan(const PolarScan& scan)
+{
+	ScanSnapshot.Publish(scan);
+	DirtyMask.fetch_or(1UL << MRSSEN_ScanAvailableBit);
+	ScansPublished++;
+}
+
+/// <summary>
+/// Selects the register served by the next MCC read; called from the I2C receive handler
+/// </summary>
+/// <param name="data">[address] or [address, length]</param>
+/// <param name="length">Number of bytes received</param>
+void MRSSENRegistersClass::Select(const uint8_t* data, int length)
+{
+	SelectedAddress = data[0];
+	if (length > 1)
+	{
+		SelectedLength = data[1];
+	}
+	else
+	{
+		SelectedLength = (SelectedAddress == MRSSEN_VersionAddress) ? 1 : MRSSEN_RegisterSize;
+	}
+}
+
+/// <summary>
+/// Clears the dirty mask bits the MCC has acknowledged; called from the I2C receive handler.  Bits set again since
+/// the MCC read the mask are cleared too, but the MCC acknowledges before it reads the registers, so it still
+/// fetches those registers' new contents.
+/// </summary>
+void MRSSENRegistersClass::AcknowledgeDirtyMask(uint32_t mask)
+{
+	DirtyMask.fetch_and(~mask);
+}
+
+/// <summary>
+/// Records the outcome of a command from the MCC in the command acknowledge register
+/// </summary>
+void MRSSENRegistersClass::SetCommandAck(const MRSSENCommandAck& ack)
+{
+	uint32_t value;
+	memcpy(&value, &ack, sizeof(value));
+	CommandAck.store(value);
+}
+
+/// <summary>
+/// Sets the ClockSync residual reported to the MCC in the clock register
+/// </summary>
+void MRSSENRegistersClass::SetClockResidual(int32_t residual)
+{
+	ClockResidual.store(residual);
+}
+
+/// <summary>
+/// Writes length bytes of a register block starting at offset; bytes past the end of the block are sent as zeros
+/// </summary>
+size_t MRSSENRegistersClass::ServeBytes(TwoWire& bus, const uint8_t* block, uint8_t blockSize, uint8_t offset, uint8_t length)
+{
+	uint8_t data[MRSSEN_MaxReadLength];
+	memset(data, 0, sizeof(data));
+	if (length > sizeof(data))
+	{
+		length = sizeof(data);
+	}
+	if (offset < blockSize)
+	{
+		uint8_t available = blockSize - offset;
+		memcpy(data, &block[offset], (length < available) ? length : available);
+	}
+	return bus.slaveWrite(data, length);
+}
+
+/// <summary>
+/// Writes one chunk of the last complete scan, stamped with the time since the scan was completed
+/// </summary>
+size_t MRSSENRegistersClass::ServeScanChunk(TwoWire& bus, uint8_t chunkIndex, uint8_t length)
+{
+	PolarScan scan;
+	if (ScanSnapshot.Read(scan))
+	{
+		ServedScan = scan;
+	}
+	else
+	{
+		TornReads++;
+	}
+
+	uint32_t age = millis() - ServedScan.EndTime;
+	PolarScanChunkPacket chunk;
+	if (chunk.Encode(ServedScan, chunkIndex, min(age, (uint32_t)0xFFFF)))
+	{
+		ScanChunksServed++;
+	}
+	return ServeBytes(bus, (uint8_t*)&chunk, sizeof(chunk), 0, length);
+}
+
+/// <summary>
+/// Writes the selected registers to the MCC; called from the I2C request handler.  Reads past the end of the
+/// data registers are padded with zeros so the master always receives the number of bytes it asked for.  A data
+/// register read selected with MRSSEN_SequenceTrailer is followed by the sequence number of the snapshot it was
+/// served from.
+/// </summary>
+/// <param name="bus">MCC I2C bus (slave)</param>
+/// <returns>Number of bytes queued</returns>
+size_t MRSSENRegistersClass::Serve(TwoWire& bus)
+{
+	uint8_t address = SelectedAddress;
+	uint8_t length = SelectedLength;
+	size_t bytesWritten = 0;
+
+	if (address >= MRSSEN_ScanChunkAddress && address < MRSSEN_ScanChunkEndAddress)
+	{
+		bytesWritten = ServeScanChunk(bus, address - MRSSEN_ScanChunkAddress, length);
+		ReadCount++;
+		BytesServed += bytesWritten;
+		return bytesWritten;
+	}
+
+	if (address == MRSSEN_ClockAddress)
+	{
+		// Stamped here rather than in Select(): the receive handler only runs after the select's STOP, so its stamp
+		// falls outside the MCC's window, whereas the MCC holds the read open (clock stretched) until this returns
+		MRSSENClockRegister clock;
+		clock.ReadTime = esp_timer_get_time();
+		clock.ResidualOffset = ClockResidual.load();
+		bytesWritten = ServeBytes(bus, (uint8_t*)&clock, sizeof(clock), 0, length);
+		ReadCount++;
+		BytesServed += bytesWritten;
+		return bytesWritten;
+	}
+
+	MRSSENRegisterImage image;
+	if (Snapshot.Read(image))
+	{
+		Served = image;
+	}
+	else
+	{
+		TornReads++;
+	}
+
+	if (address >= MRSSEN_ControlStartAddress)
+	{
+		uint32_t control[(MRSSEN_ControlEndAddress - MRSSEN_ControlStartAddress) / sizeof(uint32_t)] = { DirtyMask.load(), Served.Sequence, CommandAck.load() };
+		bytesWritten = ServeBytes(bus, (uint8_t*)control, sizeof(control), address - MRSSEN_ControlStartAddress, length);
+	}
+	else
+	{
+		bytesWritten = ServeBytes(bus, Served.Data, MRSSEN_DataEndAddress, address, length & ~MRSSEN_SequenceTrailer);
+		if (length & MRSSEN_SequenceTrailer)
+		{
+			bytesWritten += bus.slaveWrite((uint8_t*)&Served.Sequence, sizeof(Served.Sequence));
+		}
+	}
+
+	ReadCount++;
+	BytesServed += bytesWritten;
+
+	return bytesWritten;
+}
+
+
+MRSSENRegistersClass mrsSENRegisters;
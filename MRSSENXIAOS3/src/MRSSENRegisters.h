@@ -0,0 +1,81 @@
+/*	MRSSENRegisters.h
+*	MRSSENRegistersClass - I2C slave register file served to the MRS MCC (see MRSSENRegisterMap.h)
+*
+*	Sensor tasks publish the current MRSSensorPacket into a register image; the MCC selects a register
+*	with a [address, length] write and burst reads only the registers flagged in the dirty mask.  The image is
+*	published through a SeqLockSnapshot so each read served from the I2C callback comes from one consistent set
+*	of readings.
+*
+*	Completed polar scans are published the same way through a second snapshot and served one chunk per read.
+*
+*	A select of the clock register is stamped with this module's clock as it arrives; the MCC's write of the
+*	completed MRSSENClockExchange is queued in mrsSENStatus for the main loop's ClockSync.
+*
+*	Mitchell Baldwin copyright 2025
+*
+*	v 0.00:	Initial data structure
+*	v
+*
+*/
+
+#ifndef _MRSSENREGISTERS_h
+#define _MRSSENREGISTERS_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+#include <Wire.h>
+#include <atomic>
+#include <esp_timer.h>
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\MRSSENRegisterMap.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\SeqLockSnapshot.h"
+
+struct MRSSENRegisterImage
+{
+	uint8_t Data[MRSSEN_DataEndAddress];					// Indexed by register address
+	uint32_t Sequence;										// MRSSensorPacket sequence number the data was encoded from
+};
+
+class MRSSENRegistersClass
+{
+protected:
+	MRSSENRegisterImage Staging;							// Main loop copy; compared against to find changed registers
+	SeqLockSnapshot<MRSSENRegisterImage> Snapshot;			// Published copy read by the I2C request handler
+	MRSSENRegisterImage Served;								// I2C callback copy; last consistent snapshot served
+	SeqLockSnapshot<PolarScan> ScanSnapshot;				// Last complete scan
+	PolarScan ServedScan;									// I2C callback copy of the last complete scan
+	std::atomic<uint32_t> DirtyMask{ 0xFFFFFFFF };			// Data registers changed since the MCC last acknowledged them
+	std::atomic<uint32_t> CommandAck{ 0 };					// Packed MRSSENCommandAck
+	std::atomic<int32_t> ClockResidual{ 0 };				// us; served in MRSSENClockRegister
+
+	volatile uint8_t SelectedAddress = MRSSEN_VersionAddress;
+	volatile uint8_t SelectedLength = 1;
+
+	size_t ServeBytes(TwoWire& bus, const uint8_t* block, uint8_t blockSize, uint8_t offset, uint8_t length);
+	size_t ServeScanChunk(TwoWire& bus, uint8_t chunkIndex, uint8_t length);
+
+public:
+	uint32_t PublishCount = 0;
+	uint32_t ReadCount = 0;									// Register reads served to the MCC
+	uint32_t BytesServed = 0;
+	uint32_t TornReads = 0;									// Reads served from the previous snapshot because the writer kept overtaking
+	uint32_t ScansPublished = 0;
+	uint32_t ScanChunksServed = 0;
+
+	bool Init();
+	void Publish(MRSSensorPacket& packet);
+	void PublishScan(const PolarScan& scan);
+	void Select(const uint8_t* data, int length);
+	void AcknowledgeDirtyMask(uint32_t mask);
+	size_t Serve(TwoWire& bus);
+	void SetCommandAck(const MRSSENCommandAck& ack);
+	void SetClockResidual(int32_t residual);
+
+};
+
+extern MRSSENRegistersClass mrsSENRegisters;
+
+#endif
@@ -23,6 +23,28 @@ String MRSSENStatus::GetDateTimeString()
 	return String(buf);
 }
 
+/// <summary>
+/// Stamps the staging sensor packet with the shared clock time and the next sequence number and publishes it as the snapshot served to the MCC;
+/// call from the main loop once a sensor task has finished updating mrsSensorPacket
+/// </summary>
+/// <returns>Sequence number of the committed snapshot</returns>
+uint32_t MRSSENStatus::CommitSensorPacket()
+{
+	mrsSensorPacket.Timestamp = SENClock.GetSharedTime();
+	mrsSensorPacket.Sequence = SensorSnapshot.GetSequence() + 1;
+	return SensorSnapshot.Publish(mrsSensorPacket);
+}
+
+/// <summary>
+/// Copies the last committed sensor packet; safe to call from the I2C callbacks
+/// </summary>
+/// <param name="packet">Destination</param>
+/// <returns>False if a consistent copy could not be taken</returns>
+bool MRSSENStatus::ReadSensorSnapshot(MRSSensorPacket& packet)
+{
+	return SensorSnapshot.Read(packet);
+}
+
 
 MRSSENStatus mrsSENStatus;
 
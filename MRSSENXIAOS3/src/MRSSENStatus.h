@@ -21,12 +21,19 @@
 
 #include "C:\Repos\MRS-VS2022\MRSCommon\src\CSSMCommandPacket.h"
 #include "C:\Repos\MRS-VS2022\MRSCommon\src\MRSSensorPacket.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\SeqLockSnapshot.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\SPSCQueue.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\I2CBusMonitor.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\MRSSENRegisterMap.h"
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\ClockSync.h"
+
+constexpr uint8_t MCCCommandQueueSize = 8;			// Holds up to 7 pending commands from the MCC
 #include <PCF8563.h>
 
 class MRSSENStatus
 {
 protected:
-
+	SeqLockSnapshot<MRSSensorPacket> SensorSnapshot;	// Last committed copy of mrsSensorPacket, served to the MCC
 
 public:
 	// MRS Sensors module firmware version:
@@ -43,10 +50,26 @@ public:
 	bool SensorTurretMotorStatus = false;
 	bool INA219Status = false;				// I2C link to Right UPS INA219 power sensor status
 	
-	CSSMCommandPacket cssmCommandPacket;
-	MRSSensorPacket mrsSensorPacket;
+	CSSMCommandPacket cssmCommandPacket;				// Last command executed
+	MRSSensorPacket mrsSensorPacket;					// Staging copy; updated field by field by the sensor tasks
+
+	// Commands from the MCC; queued by the I2C receive handler and executed by a scheduler task:
+	SPSCQueue<CSSMCommandPacket, MCCCommandQueueSize> MCCCommandQueue;
+	volatile uint32_t MCCReceiveTime = 0;				// us; duration of the last MCC I2C receive handler call
+	volatile uint32_t MCCReceiveMaxTime = 0;			// us
+	volatile uint8_t MCCCommandQueueHighWater = 0;
+	volatile uint32_t MCCCommandsDropped = 0;			// Commands discarded because the queue was full
+	volatile uint32_t MCCBadPackets = 0;				// Writes from the MCC of unexpected size
+
+	// Clock exchanges with the MCC; queued by the I2C receive handler and added to SENClock by a scheduler task:
+	SPSCQueue<MRSSENClockExchange, 4> ClockExchangeQueue;
+	ClockSyncClass SENClock;							// Maps this module's clock onto the MCC's (shared) clock
+
+	I2CBusMonitor SENBusMonitor;						// Clock selection and profiling for the sensor I2C bus (Wire)
 
 	bool Init();
+	uint32_t CommitSensorPacket();
+	bool ReadSensorSnapshot(MRSSensorPacket& packet);
 	String GetDateTimeString();
 
 };
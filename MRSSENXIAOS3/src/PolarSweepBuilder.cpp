@@ -0,0 +1,185 @@
+/*	PolarSweepBuilder.cpp
+*	PolarSweepBuilderClass - Builds polar range scans from the forward VL53L1X while the sensor turret sweeps
+*
+*	Mitchell Baldwin copyright 2025
+*
+*/
+
+#include "PolarSweepBuilder.h"
+#include "DEBUG Macros.h"
+#include "STControl.h"
+
+/// <summary>
+/// Sets the scan range, bin size and sweep rate, and configures the sensor turret scan to match
+/// </summary>
+/// <param name="startAngle">Scan limit, degrees</param>
+/// <param name="endAngle">Scan limit, degrees; must be greater than startAngle</param>
+/// <param name="resolution">Requested bin size, degrees; rounded so the bins exactly span the range</param>
+/// <param name="sweepsPerSecond">Passes from one scan limit to the other per second</param>
+/// <returns>False if the parameters are invalid (the previous configuration is kept)</returns>
+bool PolarSweepBuilderClass::Configure(int16_t startAngle, int16_t endAngle, float resolution, float sweepsPerSecond)
+{
+	if (endAngle <= startAngle || resolution <= 0.0f || sweepsPerSecond <= 0.0f)
+	{
+		return false;
+	}
+
+	int16_t span = endAngle - startAngle;
+	uint16_t bins = constrain((uint16_t)ceilf(span / resolution), 1, MaxPolarScanBins);
+
+	StartAngle = startAngle;
+	EndAngle = endAngle;
+	Resolution = (float)span / bins;
+	SweepsPerSecond = sweepsPerSecond;
+
+	Working.StartAngle = StartAngle * 10;
+	Working.AngleStep = (uint16_t)(Resolution * 10.0f + 0.5f);
+	Working.BinCount = bins;
+
+	STControl.SetSTScanRange(StartAngle, EndAngle);
+	STControl.SetSTSpeed((uint32_t)(span * STControl.GetStepsPerRev() / 360.0f * SweepsPerSecond));
+
+	if (Running)
+	{
+		BeginScan();
+		WorkingPartial = true;
+	}
+	return true;
+}
+
+void PolarSweepBuilderClass::Start()
+{
+	Running = true;
+	LastSweepCount = STControl.GetSTSweepCount();
+	BeginScan();
+	WorkingPartial = true;
+	STControl.StartSTScan();
+}
+
+void PolarSweepBuilderClass::Stop()
+{
+	STControl.StopSTScan();
+	Running = false;
+}
+
+bool PolarSweepBuilderClass::IsRunning()
+{
+	return Running;
+}
+
+void PolarSweepBuilderClass::BeginScan()
+{
+	Working.Clear();
+	Working.StartTime = millis();
+}
+
+void PolarSweepBuilderClass::FinishScan()
+{
+	Working.ScanID = NextScanID++;
+	if (NextScanID == 0)
+	{
+		NextScanID = 1;									// 0 means no scan
+	}
+	Working.EndTime = millis();
+	Completed = Working;
+
+	LastFilledBins = Completed.GetFilledBinCount();
+	uint32_t duration = Completed.EndTime - Completed.StartTime;
+	if (duration > 0)
+	{
+		MeasuredSweepsPerSecond = 1000.0f / duration;
+	}
+	SweepsCompleted++;
+
+	_PL(GetStatusString());
+}
+
+/// <summary>
+/// Bins a range sample by the turret bearing at the time it was taken; keeps the shortest range in each bin
+/// </summary>
+/// <param name="range">mm</param>
+/// <param name="sampleTime">micros() at the middle of the measurement</param>
+void PolarSweepBuilderClass::AddSample(uint16_t range, uint32_t sampleTime)
+{
+	if (!Running || range == PolarScanNoRange)
+	{
+		return;
+	}
+
+	int bin = Working.GetBinIndex(STControl.GetSTAngleAt(sampleTime));
+	if (bin < 0)
+	{
+		SamplesOutsideScan++;
+		return;
+	}
+	if (Working.Range[bin] == PolarScanNoRange || range < Working.Range[bin])
+	{
+		Working.Range[bin] = range;
+	}
+	SamplesAdded++;
+}
+
+/// <summary>
+/// Completes the current scan when the turret has reversed at a scan limit; call after STControl.Update()
+/// </summary>
+void PolarSweepBuilderClass::Update()
+{
+	if (!Running)
+	{
+		return;
+	}
+
+	uint32_t sweepCount = STControl.GetSTSweepCount();
+	if (sweepCount != LastSweepCount)
+	{
+		LastSweepCount = sweepCount;
+		if (WorkingPartial)
+		{
+			WorkingPartial = false;
+			PartialScansDropped++;
+		}
+		else
+		{
+			FinishScan();
+		}
+		BeginScan();
+	}
+}
+
+/// <returns>False if no scan has been completed yet</returns>
+bool PolarSweepBuilderClass::GetCompletedScan(PolarScan& scan)
+{
+	if (Completed.ScanID == 0)
+	{
+		return false;
+	}
+	scan = Completed;
+	return true;
+}
+
+uint16_t PolarSweepBuilderClass::GetCompletedScanID()
+{
+	return Completed.ScanID;
+}
+
+float PolarSweepBuilderClass::GetResolution()
+{
+	return Resolution;
+}
+
+float PolarSweepBuilderClass::GetSweepsPerSecond()
+{
+	return SweepsPerSecond;
+}
+
+String PolarSweepBuilderClass::GetStatusString()
+{
+	char buf[96];
+	snprintf(buf, sizeof(buf), "Scan %u: %u/%u bins of %.1f deg, %.2f/%.2f sweeps/s, %lu samples (%lu outside)",
+		Completed.ScanID, LastFilledBins, Completed.BinCount, Resolution, MeasuredSweepsPerSecond, SweepsPerSecond,
+		SamplesAdded, SamplesOutsideScan);
+	return String(buf);
+}
+
+
+PolarSweepBuilderClass PolarSweepBuilder;
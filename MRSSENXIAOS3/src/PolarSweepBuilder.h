@@ -0,0 +1,81 @@
+/*	PolarSweepBuilder.h
+*	PolarSweepBuilderClass - Builds polar range scans from the forward VL53L1X while the sensor turret sweeps
+*
+*	Each range sample is stamped with the (estimated) time the measurement was taken; STControl works out the
+*	turret bearing at that instant from the motor's current position, speed and ramp state, and the sample is
+*	binned by that bearing.  A scan is completed each time the turret reverses at a scan limit.  The scan in
+*	progress when the sweep is started or reconfigured began wherever the turret happened to be, so it is dropped
+*	at the first reversal rather than published as a complete scan.
+*
+*	The sweep rate and angular resolution are set by Configure(); the resolution is rounded so a whole number of
+*	bins spans the scan range, and the measured sweep rate is reported alongside the configured one (turret
+*	acceleration limits the rate actually achieved on short sweeps).
+*
+*	Mitchell Baldwin copyright 2025
+*
+*	v 0.00:	Initial data structure
+*	v
+*
+*/
+
+#ifndef _PolarSweepBuilder_h
+#define _PolarSweepBuilder_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+#include "C:\Repos\MRS-VS2022\MRSCommon\src\PolarScan.h"
+
+constexpr int16_t defaultSweepStartAngle = -30;			// degrees
+constexpr int16_t defaultSweepEndAngle = 30;			// degrees
+constexpr float defaultSweepResolution = 3.0f;			// degrees per bin
+constexpr float defaultSweepsPerSecond = 0.5f;			// One pass from one scan limit to the other every 2 s
+
+class PolarSweepBuilderClass
+{
+protected:
+	PolarScan Working;									// Scan being built
+	PolarScan Completed;								// Last complete scan
+	bool Running = false;
+	bool WorkingPartial = false;						// Working did not start at a scan limit
+	uint32_t LastSweepCount = 0;
+	uint16_t NextScanID = 1;
+
+	int16_t StartAngle = defaultSweepStartAngle;
+	int16_t EndAngle = defaultSweepEndAngle;
+	float Resolution = defaultSweepResolution;
+	float SweepsPerSecond = defaultSweepsPerSecond;
+
+	void BeginScan();
+	void FinishScan();
+
+public:
+	uint32_t SamplesAdded = 0;
+	uint32_t SamplesOutsideScan = 0;					// Samples taken while the turret was outside the scan range
+	uint32_t SweepsCompleted = 0;
+	uint32_t PartialScansDropped = 0;
+	uint8_t LastFilledBins = 0;							// Bins holding a range in the last complete scan
+	float MeasuredSweepsPerSecond = 0.0f;
+
+	bool Configure(int16_t startAngle, int16_t endAngle, float resolution, float sweepsPerSecond);
+	void Start();
+	void Stop();
+	bool IsRunning();
+
+	void AddSample(uint16_t range, uint32_t sampleTime);
+	void Update();
+
+	bool GetCompletedScan(PolarScan& scan);
+	uint16_t GetCompletedScanID();
+	float GetResolution();
+	float GetSweepsPerSecond();
+	String GetStatusString();
+
+};
+
+extern PolarSweepBuilderClass PolarSweepBuilder;
+
+#endif
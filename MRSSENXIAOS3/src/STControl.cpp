@@ -22,9 +22,13 @@ bool STControlClass::Init()
 		STMotor->setDirectionPin(DefaultTurretDirPin, true, 0);		// true: High counts up (clockwise)
 		STMotor->setEnablePin(DefaultTurretEnablePin, true);		// Low active enables TMC2209
 		STMotor->setAutoEnable(true);
+		STMotor->setAcceleration(STMotorAccel);
 		_PL("Sensor turret motor initialized successfully");
 
 		//TestSTMotor();
+
+		// The power up position is arbitrary; reference it before it is used:
+		Homing.Init(STMotor, StepsPerRev);
 	}
 	mrsSENStatus.SensorTurretMotorStatus = (STMotor != NULL);
 
@@ -33,23 +37,97 @@ bool STControlClass::Init()
 
 void STControlClass::Update()
 {
-	mrsSENStatus.mrsSensorPacket.TurretPosition = (int)(STMotor->getCurrentPosition() * 360.0f / StepsPerRev);
-	if (STScanning)
+	if (STMotor == NULL)
+	{
+		return;
+	}
+
+	uint32_t now = millis();
+	uint32_t edgeTime;
+	if (Homing.GetFlagEdge(edgeTime))
+	{
+		Homing.OnFlagEdge(GetSTPositionAt(edgeTime), STMotor->getCurrentSpeedInMilliHz() > 0, now);
+	}
+	bool wasHoming = Homing.IsHoming();
+	Homing.Update(now, STScanning);
+	if (wasHoming && !Homing.IsHoming())
 	{
-		if (!STMotor->isRunning())
+		STMotor->setSpeedInHz(STMotorSpeed);
+		ScanPattern.Start();
+	}
+
+	int32_t position = STMotor->getCurrentPosition();
+	mrsSENStatus.mrsSensorPacket.TurretPosition = (int)(position * 360.0f / StepsPerRev);
+	mrsSENStatus.mrsSensorPacket.TurretConfidence = Homing.GetConfidence();
+	if (STScanning && !Homing.IsHoming())
+	{
+		STScanCommand command;
+		ScanPattern.Update(position, STMotor->isRunning(), mrsSENStatus.mrsSensorPacket.FWDVL53L1XRange, now, command);
+		if (command.SetSpeed)
+		{
+			// Applied to the move in progress, so the adaptive sweep changes speed mid-sweep:
+			STMotor->setSpeedInHz(command.Speed);
+			STMotor->applySpeedAcceleration();
+		}
+		if (command.Move)
 		{
-			if (STMotor->getCurrentPosition() >= 0)
-			{
-				STMotor->moveTo(STScanLeftLimit, false);
-			}
-			else if (STMotor->getCurrentPosition() <0)
-			{
-				STMotor->moveTo(STScanRightLimit, false);
-			}
+			STMotor->moveTo(command.Target, false);
+		}
+		if (command.SweepCompleted)
+		{
+			STSweepCount++;
 		}
 	}
 }
 
+/// <summary>
+/// Estimates the sensor turret bearing at a recent instant, e.g. the middle of a range measurement, by working
+/// back from the motor's current position using its current speed and ramp state (constant acceleration while
+/// accelerating or decelerating, constant speed while coasting).
+/// </summary>
+/// <param name="sampleTime">micros() at the instant of interest; should be no more than a few hundred ms ago</param>
+/// <returns>Bearing in degrees</returns>
+float STControlClass::GetSTAngleAt(uint32_t sampleTime)
+{
+	return GetSTPositionAt(sampleTime) * 360.0f / StepsPerRev;
+}
+
+/// <summary>
+/// As GetSTAngleAt(), in steps
+/// </summary>
+float STControlClass::GetSTPositionAt(uint32_t sampleTime)
+{
+	if (STMotor == NULL)
+	{
+		return 0.0f;
+	}
+
+	int32_t position = STMotor->getCurrentPosition();
+	float speed = STMotor->getCurrentSpeedInMilliHz() / 1000.0f;			// steps/s, signed
+	uint8_t rampState = STMotor->rampState();
+	float dt = (int32_t)(micros() - sampleTime) / 1000000.0f;				// s
+
+	// Signed acceleration (steps/s^2) of the current ramp phase:
+	float accel = 0.0f;
+	if (rampState & RAMP_STATE_ACCELERATING_FLAG)
+	{
+		accel = (speed >= 0.0f) ? STMotorAccel : -(float)STMotorAccel;
+	}
+	else if (rampState & RAMP_STATE_DECELERATING_FLAG)
+	{
+		accel = (speed >= 0.0f) ? -(float)STMotorAccel : STMotorAccel;
+	}
+
+	float pastPosition = position - speed * dt + 0.5f * accel * dt * dt;
+	if (STScanning && !Homing.IsHoming())
+	{
+		// Extrapolating across a reversal at a scan limit would overshoot it:
+		pastPosition = constrain(pastPosition, (float)STScanLeftLimit, (float)STScanRightLimit);
+	}
+
+	return pastPosition;
+}
+
 /// <summary>
 /// Tests the SensorTurretMotor by configuring it and performing one clockwise and one counter-clockwise revolution while logging progress. 
 /// The moves are performed synchronously (blocking).
@@ -122,6 +200,11 @@ bool STControlClass::TestSTMotor(int32_t targetPosition, bool blocking)
 bool STControlClass::MoveSTInSteps(int32_t targetPosition, bool blocking)
 {
 	bool success = false;
+	if (Homing.IsHoming())
+	{
+		_PL("Sensor turret is homing");
+		return success;
+	}
 	if (STMotor != NULL)
 	{
 		STMotor->moveTo(targetPosition, blocking);
@@ -149,6 +232,11 @@ bool STControlClass::MoveSTInSteps(int32_t targetPosition, bool blocking)
 bool STControlClass::MoveST(int32_t angleInDegrees, bool blocking)
 {
 	bool success = false;
+	if (Homing.IsHoming())
+	{
+		_PL("Sensor turret is homing");
+		return success;
+	}
 
 	// Calculate position in steps based on target position in degrees and steps per revolution:
 	int targetPositionInSteps = (int)(angleInDegrees * StepsPerRev / 360.0f);
@@ -179,6 +267,11 @@ bool STControlClass::MoveST(int32_t angleInDegrees, bool blocking)
 bool STControlClass::MoveSTRelative(int32_t angleInDegrees, bool blocking)
 {
 	bool success = false;
+	if (Homing.IsHoming())
+	{
+		_PL("Sensor turret is homing");
+		return success;
+	}
 
 	// Calculate position in steps based on target position in degrees and steps per revolution:
 	int targetAngleInSteps = (int)(angleInDegrees * StepsPerRev / 360.0f) + STMotor->getPositionAfterCommandsCompleted();
@@ -230,7 +323,9 @@ void STControlClass::SetSTSpeed(uint32_t speedInStepsPerSec)
 {
 	if (STMotor != NULL)
 	{
+		STMotorSpeed = speedInStepsPerSec;
 		STMotor->setSpeedInHz(speedInStepsPerSec);
+		ScanPattern.Configure(StepsPerRev, STScanLeftLimit, STScanRightLimit, STMotorSpeed);
 	}
 	else
 	{
@@ -248,6 +343,7 @@ void STControlClass::SetSTAccel(uint32_t accelInStepsPerSec2)
 {
 	if (STMotor != NULL)
 	{
+		STMotorAccel = accelInStepsPerSec2;
 		STMotor->setAcceleration(accelInStepsPerSec2);
 	}
 	else
@@ -269,8 +365,11 @@ void STControlClass::SetSTSpeedAndAccel(uint32_t speedInStepsPerSec, uint32_t ac
 {
 	if (STMotor != NULL)
 	{
+		STMotorSpeed = speedInStepsPerSec;
+		STMotorAccel = accelInStepsPerSec2;
 		STMotor->setSpeedInHz(speedInStepsPerSec);
 		STMotor->setAcceleration(accelInStepsPerSec2);
+		ScanPattern.Configure(StepsPerRev, STScanLeftLimit, STScanRightLimit, STMotorSpeed);
 	}
 	else
 	{
@@ -290,6 +389,7 @@ void STControlClass::SetSTScanRange(int32_t minAngleInDegrees, int32_t maxAngleI
 	STScanRightLimit = (int)(maxAngleInDegrees * StepsPerRev / 360.0f);
 	sprintf(buf, "Sensor turret scan range set to: %d to %d (%d steps to %d steps)", minAngleInDegrees, maxAngleInDegrees, STScanLeftLimit, STScanRightLimit);
 	_PL(buf);
+	ScanPattern.Configure(StepsPerRev, STScanLeftLimit, STScanRightLimit, STMotorSpeed);
 }
 
 /// <summary>
@@ -299,6 +399,7 @@ void STControlClass::StartSTScan()
 {
 	if (STMotor != NULL)
 	{
+		ScanPattern.Start();
 		STScanning = true;
 	}
 	else
@@ -315,6 +416,7 @@ void STControlClass::StopSTScan()
 	if (STMotor != NULL)
 	{
 		STScanning = false;
+		STMotor->setSpeedInHz(STMotorSpeed);			// The adaptive sweep may have left a different speed
 	}
 	else
 	{
@@ -322,6 +424,22 @@ void STControlClass::StopSTScan()
 	}
 }
 
+/// <summary>
+/// Selects the scan pattern (see STScanPattern.h); takes effect immediately if the turret is scanning.
+/// </summary>
+/// <param name="pattern">Scan pattern</param>
+/// <returns>False if the pattern is not recognised</returns>
+bool STControlClass::SetSTScanPattern(STScanPatternClass::Patterns pattern)
+{
+	if (!ScanPattern.SetPattern(pattern))
+	{
+		return false;
+	}
+	sprintf(buf, "Sensor turret scan pattern set: %s", ScanPattern.GetStatusString().c_str());
+	_PL(buf);
+	return true;
+}
+
 
 STControlClass STControl;
 
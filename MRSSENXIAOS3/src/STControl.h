@@ -20,6 +20,8 @@
 //#include <AVRStepperPins.h>
 //#include <common.h>
 #include <FastAccelStepper.h>
+#include "STScanPattern.h"
+#include "STHoming.h"
 //#include <PoorManFloat.h>
 //#include <RampCalculator.h>
 //#include <RampConstAcceleration.h>
@@ -41,8 +43,13 @@ protected:
 	uint32_t STMotorSpeed = 400;			// Speed in steps/s
 	uint32_t STMotorAccel = 50;				// Acceleration in steps/s^2
 	bool STScanning = false;				// True when sensor turret is performing a scan between STScanLeftLimit and STScanRightLimit
-	uint32_t STScanLeftLimit = 0;			// Sensor turret scan left limit in steps; 0 corresponds to 0 position
-	uint32_t STScanRightLimit = 1600;		// Sensor turret scan right limit in steps; 1600 corresponds to 360 position
+	int32_t STScanLeftLimit = 0;			// Sensor turret scan left limit in steps; 0 corresponds to 0 position
+	int32_t STScanRightLimit = 1600;		// Sensor turret scan right limit in steps; 1600 corresponds to 360 position
+	uint32_t STSweepCount = 0;				// Incremented each time ScanPattern completes a pass (see STScanPattern.h)
+	STScanPatternClass ScanPattern;
+	STHomingClass Homing;
+
+	float GetSTPositionAt(uint32_t sampleTime);
 
 public:
 	bool Init();
@@ -59,7 +66,17 @@ public:
 	void SetSTScanRange(int32_t minAngleInDegrees, int32_t maxAngleInDegrees);
 	void StartSTScan();
 	void StopSTScan();
+	bool SetSTScanPattern(STScanPatternClass::Patterns pattern);
 	bool IsSTScanning() { return STScanning; }
+	String GetSTScanStatusString() { return ScanPattern.GetStatusString(); }
+	uint32_t GetSTSweepCount() { return STSweepCount; }
+	int GetStepsPerRev() { return StepsPerRev; }
+	float GetSTAngleAt(uint32_t sampleTime);
+	void HomeST() { Homing.Start(millis()); }
+	void SetSTAutoRehome(bool enable) { Homing.SetAutoRehome(enable); }
+	bool IsSTHoming() { return Homing.IsHoming(); }
+	uint8_t GetSTConfidence() { return Homing.GetConfidence(); }
+	String GetSTHomingStatusString() { return Homing.GetStatusString(); }
 	bool MoveToHomePosition(bool blocking = false) { return MoveST(0, blocking); }
 
 };
@@ -0,0 +1,340 @@
+/*	STHoming.cpp
+*	STHomingClass - Homing and position confidence for the sensor turret
+*
+*	Mitchell Baldwin copyright 2026
+*
+*/
+
+#include "STHoming.h"
+#include "DEBUG Macros.h"
+
+volatile uint32_t STHomingClass::EdgeTime = 0;
+volatile bool STHomingClass::EdgeSeen = false;
+
+void IRAM_ATTR STHomingClass::FlagISR()
+{
+	EdgeTime = micros();
+	EdgeSeen = true;
+}
+
+/// <summary>
+/// Sets up the home flag input or the TMC2209 UART and starts homing
+/// </summary>
+/// <param name="motor">Initialized turret motor</param>
+/// <returns>False if the motor is not initialized or the TMC2209 is not answering for StallGuard homing</returns>
+bool STHomingClass::Init(FastAccelStepper* motor, int stepsPerRev, HomingMethods method)
+{
+	Motor = motor;
+	StepsPerRev = stepsPerRev;
+	Method = method;
+	if (Motor == NULL)
+	{
+		return false;
+	}
+
+	bool success = true;
+	if (Method == Endstop)
+	{
+		pinMode(DefaultTurretHomePin, INPUT_PULLUP);
+		attachInterrupt(DefaultTurretHomePin, FlagISR, FALLING);
+	}
+	else
+	{
+		success = Driver.Begin(Serial1);
+	}
+
+	LastPosition = Motor->getCurrentPosition();
+	Start(millis());
+	return success;
+}
+
+int32_t STHomingClass::GetHomePosition() const
+{
+	return lroundf(((Method == Endstop) ? HomeFlagAngle : HomeStopAngle) * StepsPerRev / 360.0f);
+}
+
+void STHomingClass::SetState(HomingStates state, uint32_t now)
+{
+	State = state;
+	StateTime = now;
+	MoveIssued = false;
+}
+
+void STHomingClass::MoveTo(int32_t target, uint32_t speed)
+{
+	Motor->setSpeedInHz(speed);
+	Motor->moveTo(target, false);
+	MoveIssued = true;
+}
+
+void STHomingClass::Fail(const char* reason)
+{
+	char buf[64];
+	snprintf(buf, sizeof(buf), "Sensor turret homing failed: %s", reason);
+	_PL(buf);
+	HomingFailures++;
+	LastHomingFailed = true;
+	State = Idle;
+}
+
+/// <summary>
+/// Re-labels the current (stopped) position, keeping the travel count continuous
+/// </summary>
+void STHomingClass::SetPosition(int32_t position)
+{
+	Motor->setCurrentPosition(position);
+	LastPosition = position;
+}
+
+/// <summary>
+/// Starts homing; the turret returns to its current bearing (or to 0 if it has never been homed) afterwards
+/// </summary>
+void STHomingClass::Start(uint32_t now)
+{
+	if (Motor == NULL)
+	{
+		return;
+	}
+
+	LastAttemptTime = now;
+	LastHomingFailed = false;
+	PendingCorrection = 0;
+	ReturnPosition = Homed ? Motor->getPositionAfterCommandsCompleted() : 0;
+	EdgeSeen = false;
+	int32_t position = Motor->getCurrentPosition();
+	int32_t searchSteps = (int32_t)(HomeSearchRevs * StepsPerRev);
+
+	if (Method == StallGuard)
+	{
+		if (!Driver.IsConnected() || !Driver.ConfigureStallGuard(HomeStallThreshold))
+		{
+			Fail("TMC2209 UART not responding");
+			return;
+		}
+		SetState(Seeking, now);
+		MoveTo(position - searchSteps, HomeSeekSpeed);
+	}
+	else if (digitalRead(DefaultTurretHomePin) == LOW)
+	{
+		SetState(Clearing, now);
+		MoveTo(position - HomeClearance, HomeSeekSpeed);
+	}
+	else
+	{
+		SetState(Seeking, now);
+		MoveTo(position + searchSteps, HomeSeekSpeed);
+	}
+	_PL("Sensor turret homing...");
+}
+
+/// <returns>True, with the micros() time of the edge, if the home flag has been reached since the last call</returns>
+bool STHomingClass::GetFlagEdge(uint32_t& edgeTime)
+{
+	if (!EdgeSeen)
+	{
+		return false;
+	}
+	noInterrupts();
+	edgeTime = EdgeTime;
+	EdgeSeen = false;
+	interrupts();
+	return true;
+}
+
+/// <summary>
+/// Handles the home flag being reached
+/// </summary>
+/// <param name="edgePosition">Turret position when the flag edge was reached, steps</param>
+/// <param name="clockwise">True if the turret was turning clockwise (only the clockwise leading edge is used)</param>
+void STHomingClass::OnFlagEdge(float edgePosition, bool clockwise, uint32_t now)
+{
+	if (Method != Endstop || !clockwise)
+	{
+		return;
+	}
+
+	switch (State)
+	{
+	case Seeking:
+		Motor->forceStop();
+		CoarseEdge = lroundf(edgePosition);
+		SetState(BackingOff, now);
+		break;
+	case Creeping:
+		Motor->forceStop();
+		ReferencePosition = lroundf(edgePosition);
+		SetState(Referencing, now);
+		break;
+	case Idle:
+		if (Homed)
+		{
+			// Passive re-index; the error is wrapped into (-StepsPerRev / 2, StepsPerRev / 2]:
+			int32_t error = (lroundf(edgePosition) - GetHomePosition()) % StepsPerRev;
+			if (error > StepsPerRev / 2)
+			{
+				error -= StepsPerRev;
+			}
+			else if (error <= -StepsPerRev / 2)
+			{
+				error += StepsPerRev;
+			}
+			if (abs(error) > IndexMaxCorrection)
+			{
+				IndexRejects++;
+				break;
+			}
+			IndexCount++;
+			LastIndexError = error;
+			MaxIndexError = max(MaxIndexError, abs(error));
+			LastIndexTime = now;
+			TravelSinceIndex = 0;
+			if (abs(error) > IndexTolerance)
+			{
+				PendingCorrection = error;
+				IndexConfidence = CorrectedConfidence;
+				Corrections++;
+			}
+			else
+			{
+				PendingCorrection = 0;
+				IndexConfidence = 100;
+			}
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+/// <summary>
+/// Runs homing, applies index corrections, tracks travel and re-homes when due; call regularly
+/// </summary>
+/// <param name="now">millis()</param>
+/// <param name="scanning">True while the turret is scanning (it is not re-homed then)</param>
+void STHomingClass::Update(uint32_t now, bool scanning)
+{
+	if (Motor == NULL)
+	{
+		return;
+	}
+
+	bool running = Motor->isRunning();
+	int32_t position = Motor->getCurrentPosition();
+	TravelSinceIndex += abs(position - LastPosition);
+	LastPosition = position;
+
+	switch (State)
+	{
+	case Idle:
+		if (PendingCorrection != 0 && !running)
+		{
+			SetPosition(position - PendingCorrection);
+			PendingCorrection = 0;
+		}
+		if (AutoRehome && !scanning && !running && now - LastAttemptTime >= ReindexInterval
+			&& (!Homed || now - LastIndexTime >= ReindexInterval || GetConfidence() < ReindexConfidence))
+		{
+			Start(now);
+		}
+		break;
+
+	case Clearing:
+		if (!running)
+		{
+			if (digitalRead(DefaultTurretHomePin) == LOW)
+			{
+				Fail("home flag stuck");
+				return;
+			}
+			EdgeSeen = false;
+			SetState(Seeking, now);
+			MoveTo(position + (int32_t)(HomeSearchRevs * StepsPerRev), HomeSeekSpeed);
+		}
+		break;
+
+	case Seeking:
+		if (Method == StallGuard && now - StateTime >= HomeStallIgnoreTime)
+		{
+			uint16_t load = 0;
+			if (Driver.ReadStallGuard(load) && load <= 2 * HomeStallThreshold)
+			{
+				Motor->forceStop();
+				SetState(Referencing, now);
+				return;
+			}
+		}
+		if (!running)
+		{
+			Fail((Method == Endstop) ? "home flag not found" : "no stall");
+		}
+		break;
+
+	case BackingOff:
+		if (!running)
+		{
+			if (!MoveIssued)
+			{
+				MoveTo(CoarseEdge - HomeBackOff, HomeSeekSpeed);
+			}
+			else
+			{
+				EdgeSeen = false;
+				SetState(Creeping, now);
+				MoveTo(CoarseEdge + HomeBackOff, HomeCreepSpeed);
+			}
+		}
+		break;
+
+	case Creeping:
+		if (!running)
+		{
+			Fail("home flag edge not found");
+		}
+		break;
+
+	case Referencing:
+		if (!running)
+		{
+			if (Method == StallGuard)
+			{
+				ReferencePosition = position;
+			}
+			SetPosition(position - ReferencePosition + GetHomePosition());
+			Homed = true;
+			HomingCount++;
+			IndexConfidence = 100;
+			TravelSinceIndex = 0;
+			LastIndexTime = now;
+			State = Idle;
+			Motor->setSpeedInHz(HomeSeekSpeed);
+			Motor->moveTo(ReturnPosition, false);
+			_PL(GetStatusString());
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+/// <returns>%; 0 while homing or if the turret has never been homed</returns>
+uint8_t STHomingClass::GetConfidence() const
+{
+	if (!Homed || IsHoming())
+	{
+		return 0;
+	}
+	uint32_t decay = TravelSinceIndex / ConfidenceDecayTravel;
+	return (decay >= IndexConfidence) ? 0 : IndexConfidence - decay;
+}
+
+String STHomingClass::GetStatusString() const
+{
+	static const char* stateNames[] = { "idle", "clearing", "seeking", "backing off", "creeping", "referencing" };
+	char buf[128];
+	snprintf(buf, sizeof(buf), "ST home %s %s%s%s %u%%, %lu homed %lu failed, idx %lu err %+ld max %ld rej %lu",
+		(Method == Endstop) ? "flag" : "stall", stateNames[State], LastHomingFailed ? " (failed)" : "", AutoRehome ? " auto" : "",
+		GetConfidence(), (unsigned long)HomingCount, (unsigned long)HomingFailures, (unsigned long)IndexCount, (long)LastIndexError,
+		(long)MaxIndexError, (unsigned long)IndexRejects);
+	return String(buf);
+}
@@ -0,0 +1,131 @@
+/*	STHoming.h
+*	STHomingClass - Homing and position confidence for the sensor turret
+*
+*	The turret's stepper position is only a count of the steps sent to it, so it is referenced to the turret at
+*	start up and then checked against it from time to time:
+*
+*	Endstop:		a home flag switch (low active) whose clockwise leading edge is at HomeFlagAngle.  Homing seeks
+*					the edge, backs off and creeps back onto it; the edge's position comes from the time of its
+*					interrupt (see STControlClass::GetSTPositionAt()).  Afterwards every clockwise pass over the edge,
+*					e.g. each sweep of a scan across the forward bearing, re-indexes the position: the error is taken
+*					modulo a revolution, errors beyond IndexTolerance are corrected the next time the turret stops and
+*					errors beyond IndexMaxCorrection are ignored as a false edge (switch bounce or noise).
+*	StallGuard:		sensorless homing against a hard stop at HomeStopAngle, using the TMC2209 StallGuard load
+*					measurement read over its UART (see TMC2209UART.h).  There is no passive re-index.
+*
+*	Confidence (%) is 0 until the turret has been homed, 100 after homing or an index within IndexTolerance
+*	(CorrectedConfidence after a correction) and drops by 1% every ConfidenceDecayTravel steps travelled since.
+*	Homing runs at start up and on command (HomeTurret).  Periodic re-homing is off until enabled by command
+*	(SetTurretAutoRehome, see SetAutoRehome()): then, when the turret is idle (not scanning or moving) and has not been
+*	indexed for ReindexInterval, or its confidence has fallen below ReindexConfidence, it is homed again and returned
+*	to where it was.
+*
+*	Mitchell Baldwin copyright 2026
+*
+*	v 0.00:	Initial data structure
+*	v
+*
+*/
+
+#ifndef _STHoming_h
+#define _STHoming_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+#include <FastAccelStepper.h>
+#include "TMC2209UART.h"
+
+constexpr int DefaultTurretHomePin = GPIO_NUM_1;		// Home flag switch (low active, internal pull up); XIAO D0
+
+constexpr float HomeFlagAngle = 0.0f;					// degrees; clockwise leading edge of the home flag
+constexpr float HomeStopAngle = -180.0f;				// degrees; hard stop used by StallGuard homing
+constexpr uint32_t HomeSeekSpeed = 100;					// steps/s; stops within a few steps at STControl's acceleration
+constexpr uint32_t HomeCreepSpeed = 25;					// steps/s
+constexpr int32_t HomeClearance = 200;					// steps moved counter-clockwise to get off the flag
+constexpr int32_t HomeBackOff = 40;						// steps back from the flag edge before creeping onto it
+constexpr float HomeSearchRevs = 1.1f;					// Travel before homing gives up
+constexpr uint8_t HomeStallThreshold = 30;				// SGTHRS; stalled when SG_RESULT <= 2 x this
+constexpr uint16_t HomeStallIgnoreTime = 500;			// ms after starting the stall seek, while accelerating
+constexpr int32_t IndexTolerance = 2;					// steps
+constexpr int32_t IndexMaxCorrection = 8;				// steps; larger index errors are rejected
+constexpr uint8_t CorrectedConfidence = 50;				// %; after an index that needed correcting
+constexpr uint32_t ConfidenceDecayTravel = 800;			// steps travelled per 1% of confidence
+constexpr uint32_t ReindexInterval = 600000;			// ms
+constexpr uint8_t ReindexConfidence = 75;				// %
+
+class STHomingClass
+{
+public:
+	enum HomingMethods : uint8_t
+	{
+		Endstop,
+		StallGuard,
+	};
+
+	enum HomingStates : uint8_t
+	{
+		Idle,
+		Clearing,										// Moving off the flag
+		Seeking,										// Moving towards the flag edge or hard stop
+		BackingOff,										// Moving back from the coarse flag edge
+		Creeping,										// Moving slowly onto the flag edge
+		Referencing,									// Waiting to stop before setting the position
+	};
+
+protected:
+	FastAccelStepper* Motor = NULL;
+	TMC2209UARTClass Driver;
+	HomingMethods Method = Endstop;
+	HomingStates State = Idle;
+	int StepsPerRev = 1600;
+	bool MoveIssued = false;
+	bool Homed = false;									// Referenced at least once
+	bool LastHomingFailed = false;
+	bool AutoRehome = false;							// Re-home when due without being commanded to
+	int32_t ReturnPosition = 0;							// steps; where to go once homed
+	int32_t ReferencePosition = 0;						// steps; current coordinates of the flag edge or hard stop
+	int32_t CoarseEdge = 0;
+	uint32_t StateTime = 0;								// ms
+	int32_t PendingCorrection = 0;						// steps; applied when the turret next stops
+	uint8_t IndexConfidence = 0;						// %
+	uint32_t TravelSinceIndex = 0;						// steps
+	int32_t LastPosition = 0;
+	uint32_t LastIndexTime = 0;							// ms
+	uint32_t LastAttemptTime = 0;
+
+	static volatile uint32_t EdgeTime;					// micros() of the last flag edge
+	static volatile bool EdgeSeen;
+	static void IRAM_ATTR FlagISR();
+
+	int32_t GetHomePosition() const;
+	void SetState(HomingStates state, uint32_t now);
+	void MoveTo(int32_t target, uint32_t speed);
+	void Fail(const char* reason);
+	void SetPosition(int32_t position);
+
+public:
+	uint32_t HomingCount = 0;
+	uint32_t HomingFailures = 0;
+	uint32_t IndexCount = 0;
+	uint32_t Corrections = 0;
+	uint32_t IndexRejects = 0;							// Index errors beyond IndexMaxCorrection
+	int32_t LastIndexError = 0;							// steps; flag edge position less its expected position
+	int32_t MaxIndexError = 0;
+
+	bool Init(FastAccelStepper* motor, int stepsPerRev, HomingMethods method = Endstop);
+	void Start(uint32_t now);
+	bool IsHoming() const { return State != Idle; }
+	bool IsHomed() const { return Homed; }
+	void SetAutoRehome(bool enable) { AutoRehome = enable; }
+	bool GetAutoRehome() const { return AutoRehome; }
+	bool GetFlagEdge(uint32_t& edgeTime);
+	void OnFlagEdge(float edgePosition, bool clockwise, uint32_t now);
+	void Update(uint32_t now, bool scanning);
+	uint8_t GetConfidence() const;
+	String GetStatusString() const;
+};
+
+#endif
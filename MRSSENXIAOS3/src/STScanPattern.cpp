@@ -0,0 +1,426 @@
+/*	STScanPattern.cpp
+*	STScanPatternClass - Scan patterns for the sensor turret
+*
+*	Mitchell Baldwin copyright 2026
+*
+*/
+
+#include "STScanPattern.h"
+
+static const char* PatternNames[] = { "SEC", "DWL", "ADP", "TRK" };
+
+/// <summary>
+/// Sets the scan limits and the configured speed; call whenever STControl's scan range or speed changes
+/// </summary>
+/// <param name="stepsPerRev">Turret motor steps per revolution</param>
+/// <param name="leftLimit">steps</param>
+/// <param name="rightLimit">steps; must be greater than leftLimit</param>
+/// <param name="speed">steps/s</param>
+void STScanPatternClass::Configure(int stepsPerRev, int32_t leftLimit, int32_t rightLimit, uint32_t speed)
+{
+	StepsPerRev = stepsPerRev;
+	LeftLimit = min(leftLimit, rightLimit);
+	RightLimit = max(leftLimit, rightLimit);
+	Speed = speed;
+}
+
+/// <returns>False if the pattern is not recognised (the current pattern is kept)</returns>
+bool STScanPatternClass::SetPattern(Patterns pattern)
+{
+	if (pattern >= PatternCount)
+	{
+		return false;
+	}
+	Pattern = pattern;
+	Start();
+	return true;
+}
+
+/// <summary>
+/// Sets the bearings visited by the DwellList pattern
+/// </summary>
+/// <param name="angles">degrees</param>
+/// <param name="count">1 to STMaxDwellAngles</param>
+/// <param name="dwellTime">ms at each bearing</param>
+/// <returns>False if the list is empty or too long (the current list is kept)</returns>
+bool STScanPatternClass::SetDwellAngles(const int16_t* angles, uint8_t count, uint16_t dwellTime)
+{
+	if (count == 0 || count > STMaxDwellAngles)
+	{
+		return false;
+	}
+	memcpy(DwellAngles, angles, count * sizeof(int16_t));
+	DwellCount = count;
+	DwellTime = dwellTime;
+	DwellIndex = 0;
+	return true;
+}
+
+/// <summary>
+/// Restarts the current pattern from wherever the turret is
+/// </summary>
+void STScanPatternClass::Start()
+{
+	Started = false;
+	CommandedSpeed = 0;									// Resend the speed on the next update
+	DwellIndex = 0;
+	ArrivalTime = 0;
+	Tracking = false;
+	SweepNearestRange = 0;
+}
+
+int32_t STScanPatternClass::ToSteps(float angle) const
+{
+	return lroundf(angle * StepsPerRev / 360.0f);
+}
+
+void STScanPatternClass::MoveTo(int32_t target, STScanCommand& command)
+{
+	Target = target;
+	command.Move = true;
+	command.Target = target;
+	Started = true;
+}
+
+void STScanPatternClass::SetSpeed(uint32_t speed, STScanCommand& command)
+{
+	CommandedSpeed = speed;
+	command.SetSpeed = true;
+	command.Speed = speed;
+}
+
+/// <summary>
+/// Works out the next turret move; call regularly (e.g. every 100 ms) while scanning
+/// </summary>
+/// <param name="position">Current turret position, steps</param>
+/// <param name="running">True while the turret motor is moving</param>
+/// <param name="range">Latest forward range, mm; 0 for no return</param>
+/// <param name="now">millis()</param>
+/// <param name="command">What to apply to the turret motor</param>
+void STScanPatternClass::Update(int32_t position, bool running, uint16_t range, uint32_t now, STScanCommand& command)
+{
+	command = STScanCommand();
+	if (RightLimit <= LeftLimit)
+	{
+		return;
+	}
+
+	if (Pattern == AdaptiveSweep)
+	{
+		UpdateAdaptive(range, command);
+	}
+	else if (CommandedSpeed != Speed)
+	{
+		SetSpeed(Speed, command);
+	}
+
+	switch (Pattern)
+	{
+	case SectorSweep:
+	case AdaptiveSweep:
+		UpdateSweep(position, running, command);
+		break;
+	case DwellList:
+		UpdateDwell(position, running, now, command);
+		break;
+	case TrackNearest:
+		UpdateTrack(position, running, range, now, command);
+		break;
+	default:
+		break;
+	}
+}
+
+/// <summary>
+/// Sweeps to whichever limit the turret is heading for, reversing when it gets there; the direction comes from
+/// the position relative to the limits, so it works wherever 0 lies
+/// </summary>
+void STScanPatternClass::UpdateSweep(int32_t position, bool running, STScanCommand& command)
+{
+	if (running)
+	{
+		return;
+	}
+
+	bool atLimit = false;
+	if (position >= RightLimit)
+	{
+		TowardRight = false;
+		atLimit = true;
+	}
+	else if (position <= LeftLimit)
+	{
+		TowardRight = true;
+		atLimit = true;
+	}
+	if (atLimit && Started)
+	{
+		command.SweepCompleted = true;
+	}
+	MoveTo(TowardRight ? RightLimit : LeftLimit, command);
+}
+
+void STScanPatternClass::UpdateDwell(int32_t position, bool running, uint32_t now, STScanCommand& command)
+{
+	if (running)
+	{
+		ArrivalTime = 0;
+		return;
+	}
+
+	int32_t target = ToSteps(DwellAngles[DwellIndex]);
+	if (position != target)
+	{
+		MoveTo(target, command);
+		return;
+	}
+	if (ArrivalTime == 0)
+	{
+		ArrivalTime = max(now, (uint32_t)1);
+		return;
+	}
+	if (now - ArrivalTime < DwellTime)
+	{
+		return;
+	}
+
+	ArrivalTime = 0;
+	if (++DwellIndex >= DwellCount)
+	{
+		DwellIndex = 0;
+		command.SweepCompleted = true;
+	}
+	MoveTo(ToSteps(DwellAngles[DwellIndex]), command);
+}
+
+/// <summary>
+/// Scales the sweep speed with the range: the forward range includes the VL53L1X side zones, so the turret slows
+/// down slightly before the boresight reaches a close object
+/// </summary>
+void STScanPatternClass::UpdateAdaptive(uint16_t range, STScanCommand& command)
+{
+	float factor = AdaptiveMaxSpeedFactor;
+	if (range != 0 && range < AdaptiveFarRange)
+	{
+		float fraction = (float)((int32_t)range - AdaptiveNearRange) / (AdaptiveFarRange - AdaptiveNearRange);
+		factor = AdaptiveMinSpeedFactor + constrain(fraction, 0.0f, 1.0f) * (AdaptiveMaxSpeedFactor - AdaptiveMinSpeedFactor);
+	}
+
+	uint32_t speed = max((uint32_t)(Speed * factor), (uint32_t)1);
+	if (CommandedSpeed == 0 || fabsf((float)speed - CommandedSpeed) > AdaptiveSpeedHysteresis * CommandedSpeed)
+	{
+		SetSpeed(speed, command);
+	}
+}
+
+void STScanPatternClass::UpdateTrack(int32_t position, bool running, uint16_t range, uint32_t now, STScanCommand& command)
+{
+	if (!Tracking)
+	{
+		// Acquire: sector sweep, noting the run of positions that see the nearest return; the sensor's field of view
+		// is wider than most objects, so the middle of the run is the object's bearing
+		if (range != 0 && range < TrackMaxRange)
+		{
+			if (SweepNearestRange == 0 || range + TrackRangeTolerance < SweepNearestRange)
+			{
+				SweepNearestRange = range;
+				SweepNearestFirst = SweepNearestLast = position;
+			}
+			else if (range <= SweepNearestRange + TrackRangeTolerance)
+			{
+				SweepNearestRange = min(SweepNearestRange, range);
+				SweepNearestLast = position;
+			}
+		}
+		UpdateSweep(position, running, command);
+		if (command.SweepCompleted)
+		{
+			if (SweepNearestRange != 0)
+			{
+				Tracking = true;
+				TrackCentre = (SweepNearestFirst + SweepNearestLast) / 2;
+				DitherHigh = false;
+				ArrivalTime = 0;
+				TrackAcquisitions++;
+				MoveTo(constrain(TrackCentre - ToSteps(TrackDitherAngle), LeftLimit, RightLimit), command);
+			}
+			SweepNearestRange = 0;
+		}
+		return;
+	}
+
+	int32_t ditherSteps = ToSteps(TrackDitherAngle);
+	int32_t target = constrain(TrackCentre + (DitherHigh ? ditherSteps : -ditherSteps), LeftLimit, RightLimit);
+	if (running)
+	{
+		ArrivalTime = 0;
+		return;
+	}
+	if (position != target)
+	{
+		MoveTo(target, command);
+		return;
+	}
+	if (ArrivalTime == 0)
+	{
+		ArrivalTime = max(now, (uint32_t)1);
+		return;
+	}
+	if (now - ArrivalTime < TrackSettleTime)
+	{
+		return;
+	}
+
+	uint16_t sideRange = (range < TrackMaxRange) ? range : 0;
+	if (!DitherHigh)
+	{
+		DitherLowRange = sideRange;
+		DitherHigh = true;
+	}
+	else
+	{
+		if (DitherLowRange == 0 && sideRange == 0)
+		{
+			// Lost; sweep again from here to reacquire:
+			Tracking = false;
+			TrackLosses++;
+			SweepNearestRange = 0;
+			Started = false;
+			UpdateSweep(position, false, command);
+			return;
+		}
+
+		// Re-centre half a dither towards the closer side:
+		if (sideRange != 0 && (DitherLowRange == 0 || sideRange < DitherLowRange))
+		{
+			TrackCentre += ditherSteps / 2;
+		}
+		else if (DitherLowRange != 0 && (sideRange == 0 || DitherLowRange < sideRange))
+		{
+			TrackCentre -= ditherSteps / 2;
+		}
+		TrackCentre = constrain(TrackCentre, LeftLimit, RightLimit);
+		DitherHigh = false;
+	}
+
+	ArrivalTime = 0;
+	MoveTo(constrain(TrackCentre + (DitherHigh ? ditherSteps : -ditherSteps), LeftLimit, RightLimit), command);
+}
+
+String STScanPatternClass::GetStatusString() const
+{
+	char buf[64];
+	snprintf(buf, sizeof(buf), "ST %s %lu steps/s%s, %lu acquired %lu lost", PatternNames[Pattern], (unsigned long)CommandedSpeed,
+		Tracking ? " tracking" : "", (unsigned long)TrackAcquisitions, (unsigned long)TrackLosses);
+	return String(buf);
+}
+
+/// <summary>
+/// Runs a pattern against a simulated turret (trapezoidal moves at the default PolarSweepBuilder speed and the
+/// STControl acceleration) in a simulated room: a wall 1.2 m away with a post 0.4 m away, 6 degrees wide, at
+/// 12 degrees.  A range is taken every VL53L1X measurement and the pattern is updated every 100 ms, as on the
+/// MRS SEN module; the range is the nearest return in the VL53L1X field of view, as FWDVL53L1XRange, while bins
+/// and post samples are counted at the boresight bearing, as PolarSweepBuilder.
+/// </summary>
+/// <param name="pattern">Pattern to run over the default -30 to 30 degree scan range</param>
+/// <param name="seconds">Simulated time</param>
+/// <param name="binsPerSecond">Mean number of 3 degree bins (of 20) ranged in each second</param>
+/// <param name="obstacleSamplesPerSecond">Mean number of ranges taken on the post each second</param>
+void STScanPatternClass::Simulate(Patterns pattern, uint16_t seconds, float& binsPerSecond, float& obstacleSamplesPerSecond)
+{
+	constexpr int stepsPerRev = 1600;
+	constexpr float accel = 50.0f;						// steps/s^2
+	constexpr float dt = 0.001f;						// s
+	constexpr uint32_t sampleInterval = 37;				// ms; timing budget plus inter-measurement margin
+	constexpr uint32_t updateInterval = 100;			// ms
+	constexpr float binWidth = 3.0f;					// degrees
+	constexpr float postBearing = 12.0f;				// degrees
+	constexpr float postHalfWidth = 3.0f;
+	constexpr uint16_t postRange = 400;					// mm
+	constexpr uint16_t wallRange = 1200;
+	constexpr float halfFieldOfView = 13.5f;			// degrees; full SPAD array
+
+	STScanPatternClass engine;
+	int32_t limit = lroundf(30.0f * stepsPerRev / 360.0f);
+	engine.Configure(stepsPerRev, -limit, limit, limit);	// One pass every 2 s, as the default PolarSweepBuilder
+	engine.SetPattern(pattern);
+
+	float position = 0.0f;								// steps
+	float velocity = 0.0f;								// steps/s
+	int32_t target = 0;
+	float maxSpeed = engine.Speed;
+	uint16_t range = 0;
+	uint32_t binsRanged = 0;							// Bit per bin, this second
+	uint32_t totalBins = 0;
+	uint32_t obstacleSamples = 0;
+
+	for (uint32_t t = 0; t < seconds * 1000UL; t++)
+	{
+		// Trapezoidal move towards the target:
+		float remaining = target - position;
+		if (fabsf(remaining) < 0.5f && fabsf(velocity) < 20.0f)
+		{
+			position = target;
+			velocity = 0.0f;
+		}
+		else
+		{
+			float direction = (remaining > 0.0f) ? 1.0f : -1.0f;
+			float speed = velocity * direction;			// Towards the target
+			if (speed > 0.0f && speed * speed / (2.0f * accel) >= fabsf(remaining))
+			{
+				speed -= accel * dt;
+			}
+			else if (speed < maxSpeed)
+			{
+				speed = min(speed + accel * dt, maxSpeed);
+			}
+			else
+			{
+				speed = max(speed - accel * dt, maxSpeed);
+			}
+			velocity = speed * direction;
+			position += velocity * dt;
+		}
+
+		float bearing = position * 360.0f / stepsPerRev;
+		if (t % sampleInterval == 0)
+		{
+			bool onPost = fabsf(bearing - postBearing) <= postHalfWidth;
+			range = (fabsf(bearing - postBearing) <= postHalfWidth + halfFieldOfView) ? postRange : wallRange;
+			obstacleSamples += onPost;
+			int bin = (int)floorf((bearing + 30.0f) / binWidth);
+			if (bin >= 0 && bin < 20)
+			{
+				binsRanged |= 1UL << bin;
+			}
+		}
+
+		if (t % updateInterval == 0)
+		{
+			STScanCommand command;
+			bool running = (velocity != 0.0f) || (position != target);
+			engine.Update(lroundf(position), running, range, t + 1, command);
+			if (command.SetSpeed)
+			{
+				maxSpeed = command.Speed;
+			}
+			if (command.Move)
+			{
+				target = command.Target;
+			}
+		}
+
+		if (t % 1000 == 999)
+		{
+			for (uint32_t bits = binsRanged; bits != 0; bits &= bits - 1)
+			{
+				totalBins++;
+			}
+			binsRanged = 0;
+		}
+	}
+
+	binsPerSecond = (float)totalBins / seconds;
+	obstacleSamplesPerSecond = (float)obstacleSamples / seconds;
+}
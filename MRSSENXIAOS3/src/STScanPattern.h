@@ -0,0 +1,120 @@
+/*	STScanPattern.h
+*	STScanPatternClass - Scan patterns for the sensor turret
+*
+*	Works out where the turret should go next from its current position and the latest forward range; STControl
+*	applies the result to the stepper without blocking.  Positions are in steps, as FastAccelStepper, and the scan
+*	limits may lie anywhere (e.g. asymmetric about 0).
+*
+*	SectorSweep:	constant speed sweep from one limit to the other
+*	DwellList:		steps through a list of bearings, pausing at each
+*	AdaptiveSweep:	sector sweep that slows down while there are close returns and speeds up in open space
+*	TrackNearest:	sector sweeps until the nearest return is found, then dithers either side of the middle of the
+*					run of bearings that saw it, re-centring on the closer side, until it is lost
+*
+*	Each completed pass (a sweep reversal, a full pass through the dwell list or a reacquisition sweep) is reported
+*	as a completed sweep, so PolarSweepBuilder completes a scan.
+*
+*	Mitchell Baldwin copyright 2026
+*
+*	v 0.00:	Initial data structure
+*	v
+*
+*/
+
+#ifndef _STScanPattern_h
+#define _STScanPattern_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+
+constexpr uint8_t STMaxDwellAngles = 8;
+constexpr uint16_t defaultSTDwellTime = 300;			// ms at each dwell bearing
+constexpr uint16_t AdaptiveNearRange = 300;				// mm; slowest at and inside this range
+constexpr uint16_t AdaptiveFarRange = 1500;				// mm; fastest at and beyond this range, or with no return
+constexpr float AdaptiveMinSpeedFactor = 0.25f;			// Of the configured speed
+constexpr float AdaptiveMaxSpeedFactor = 2.0f;
+constexpr float AdaptiveSpeedHysteresis = 0.1f;			// Fractional speed change needed before the speed is updated
+constexpr uint16_t TrackMaxRange = 2000;				// mm; nearer returns are tracked
+constexpr uint16_t TrackRangeTolerance = 50;			// mm; returns this close to the nearest are part of the same object
+constexpr float TrackDitherAngle = 4.0f;				// degrees either side of the tracked bearing
+constexpr uint16_t TrackSettleTime = 150;				// ms at each dither point before its range is used
+
+/// <summary>
+/// What STControl should do after an update; Speed and Target are only valid when the matching flag is set
+/// </summary>
+struct STScanCommand
+{
+	bool SetSpeed = false;
+	uint32_t Speed = 0;									// steps/s
+	bool Move = false;
+	int32_t Target = 0;									// steps
+	bool SweepCompleted = false;
+};
+
+class STScanPatternClass
+{
+public:
+	enum Patterns : uint8_t
+	{
+		SectorSweep,
+		DwellList,
+		AdaptiveSweep,
+		TrackNearest,
+
+		PatternCount
+	};
+
+protected:
+	Patterns Pattern = SectorSweep;
+	int StepsPerRev = 1600;
+	int32_t LeftLimit = 0;								// steps
+	int32_t RightLimit = 0;
+	uint32_t Speed = 400;								// steps/s; configured (base) speed
+	uint32_t CommandedSpeed = 400;
+
+	int32_t Target = 0;
+	bool TowardRight = true;
+	bool Started = false;
+
+	int16_t DwellAngles[STMaxDwellAngles] = { -30, -15, 0, 15, 30 };	// degrees
+	uint8_t DwellCount = 5;
+	uint16_t DwellTime = defaultSTDwellTime;
+	uint8_t DwellIndex = 0;
+	uint32_t ArrivalTime = 0;							// ms; 0 while moving
+
+	bool Tracking = false;
+	int32_t TrackCentre = 0;							// steps
+	uint16_t SweepNearestRange = 0;						// mm; nearest return seen during the current acquisition sweep
+	int32_t SweepNearestFirst = 0;						// steps; first and last positions that saw the nearest return
+	int32_t SweepNearestLast = 0;
+	bool DitherHigh = false;							// Dithering to the right of TrackCentre
+	uint16_t DitherLowRange = 0;						// mm; 0 for no return
+
+	int32_t ToSteps(float angle) const;
+	void MoveTo(int32_t target, STScanCommand& command);
+	void SetSpeed(uint32_t speed, STScanCommand& command);
+	void UpdateSweep(int32_t position, bool running, STScanCommand& command);
+	void UpdateDwell(int32_t position, bool running, uint32_t now, STScanCommand& command);
+	void UpdateAdaptive(uint16_t range, STScanCommand& command);
+	void UpdateTrack(int32_t position, bool running, uint16_t range, uint32_t now, STScanCommand& command);
+
+public:
+	uint32_t TrackAcquisitions = 0;
+	uint32_t TrackLosses = 0;
+
+	void Configure(int stepsPerRev, int32_t leftLimit, int32_t rightLimit, uint32_t speed);
+	bool SetPattern(Patterns pattern);
+	Patterns GetPattern() const { return Pattern; }
+	bool SetDwellAngles(const int16_t* angles, uint8_t count, uint16_t dwellTime);
+	void Start();
+	void Update(int32_t position, bool running, uint16_t range, uint32_t now, STScanCommand& command);
+	bool IsTracking() const { return Tracking; }
+	String GetStatusString() const;
+
+	static void Simulate(Patterns pattern, uint16_t seconds, float& binsPerSecond, float& obstacleSamplesPerSecond);
+};
+
+#endif
@@ -0,0 +1,161 @@
+/*	TMC2209UART.cpp
+*	TMC2209UARTClass - Minimal single wire UART access to the TMC2209 sensor turret driver
+*
+*	Mitchell Baldwin copyright 2026
+*
+*/
+
+#include "TMC2209UART.h"
+#include "DEBUG Macros.h"
+
+/// <summary>
+/// CRC8 (polynomial x^8 + x^2 + x + 1) over the datagram, each byte taken LSB first, as the TMC2209 datasheet
+/// </summary>
+uint8_t TMC2209UARTClass::CRC(const uint8_t* data, uint8_t length)
+{
+	uint8_t crc = 0;
+	for (uint8_t i = 0; i < length; i++)
+	{
+		uint8_t byte = data[i];
+		for (uint8_t bit = 0; bit < 8; bit++)
+		{
+			if ((crc >> 7) ^ (byte & 0x01))
+			{
+				crc = (crc << 1) ^ 0x07;
+			}
+			else
+			{
+				crc = crc << 1;
+			}
+			byte = byte >> 1;
+		}
+	}
+	return crc;
+}
+
+/// <summary>
+/// Opens the UART and checks that the driver answers; the driver's microstep and current settings are left alone
+/// </summary>
+/// <returns>True if the driver answered</returns>
+bool TMC2209UARTClass::Begin(HardwareSerial& port, int rxPin, int txPin, uint8_t address)
+{
+	Port = &port;
+	Address = address;
+	Port->begin(TMC2209UARTBaud, SERIAL_8N1, rxPin, txPin);
+
+	uint32_t value = 0;
+	Connected = ReadRegister(TMC2209_IFCNT, value);
+	if (Connected)
+	{
+		_PL("TMC2209 UART connected");
+	}
+	else
+	{
+		_PL("TMC2209 UART not responding");
+	}
+	return Connected;
+}
+
+/// <returns>False if the write could not be confirmed through IFCNT</returns>
+bool TMC2209UARTClass::WriteRegister(uint8_t reg, uint32_t value)
+{
+	if (Port == nullptr)
+	{
+		return false;
+	}
+
+	uint32_t countBefore = 0;
+	bool counted = ReadRegister(TMC2209_IFCNT, countBefore);
+
+	uint8_t datagram[8] = { 0x05, Address, (uint8_t)(reg | 0x80),
+		(uint8_t)(value >> 24), (uint8_t)(value >> 16), (uint8_t)(value >> 8), (uint8_t)value, 0 };
+	datagram[7] = CRC(datagram, 7);
+	Port->write(datagram, sizeof(datagram));
+	Port->flush();
+	Writes++;
+
+	uint32_t countAfter = 0;
+	if (!counted || !ReadRegister(TMC2209_IFCNT, countAfter) || (uint8_t)countAfter != (uint8_t)(countBefore + 1))
+	{
+		WriteFailures++;
+		return false;
+	}
+	return true;
+}
+
+/// <summary>
+/// Requests a register and waits up to TMC2209ReplyTimeout for the reply
+/// </summary>
+/// <returns>False if no valid reply was received</returns>
+bool TMC2209UARTClass::ReadRegister(uint8_t reg, uint32_t& value)
+{
+	if (Port == nullptr)
+	{
+		return false;
+	}
+	Reads++;
+
+	while (Port->available())
+	{
+		Port->read();
+	}
+	uint8_t request[4] = { 0x05, Address, (uint8_t)(reg & 0x7F), 0 };
+	request[3] = CRC(request, 3);
+	Port->write(request, sizeof(request));
+	Port->flush();
+
+	// Find the reply's sync and master address bytes, skipping the echoed request:
+	uint8_t reply[8];
+	uint8_t count = 0;
+	uint32_t startTime = millis();
+	while (count < sizeof(reply) && millis() - startTime < TMC2209ReplyTimeout)
+	{
+		if (!Port->available())
+		{
+			continue;
+		}
+		uint8_t byte = Port->read();
+		if (count == 0 && byte != 0x05)
+		{
+			continue;
+		}
+		if (count == 1 && byte != 0xFF)
+		{
+			count = (byte == 0x05) ? 1 : 0;
+			continue;
+		}
+		reply[count++] = byte;
+	}
+
+	if (count < sizeof(reply) || reply[2] != (reg & 0x7F) || reply[7] != CRC(reply, 7))
+	{
+		ReadFailures++;
+		return false;
+	}
+	value = ((uint32_t)reply[3] << 24) | ((uint32_t)reply[4] << 16) | ((uint32_t)reply[5] << 8) | reply[6];
+	return true;
+}
+
+/// <summary>
+/// Selects UART control with StealthChop (needed by StallGuard4) and enables StallGuard at all speeds
+/// </summary>
+/// <param name="threshold">SGTHRS; DIAG is raised when SG_RESULT falls to 2 x threshold or below</param>
+bool TMC2209UARTClass::ConfigureStallGuard(uint8_t threshold)
+{
+	bool success = WriteRegister(TMC2209_GCONF, TMC2209_GCONF_I_scale_analog | TMC2209_GCONF_pdn_disable | TMC2209_GCONF_multistep_filt);
+	success &= WriteRegister(TMC2209_TCOOLTHRS, 0xFFFFF);
+	success &= WriteRegister(TMC2209_SGTHRS, threshold);
+	return success;
+}
+
+/// <param name="result">SG_RESULT; 0 to 510, lower for higher load</param>
+bool TMC2209UARTClass::ReadStallGuard(uint16_t& result)
+{
+	uint32_t value = 0;
+	if (!ReadRegister(TMC2209_SG_RESULT, value))
+	{
+		return false;
+	}
+	result = value & 0x3FF;
+	return true;
+}
@@ -0,0 +1,70 @@
+/*	TMC2209UART.h
+*	TMC2209UARTClass - Minimal single wire UART access to the TMC2209 sensor turret driver
+*
+*	The TMC2209 PDN_UART pin is driven from the Tx pin through a 1k resistor and read on the Rx pin, so each request
+*	is echoed back ahead of the reply; ReadRegister() skips anything before the reply's sync and master address
+*	bytes.  The driver does not acknowledge writes, so WriteRegister() checks that the interface transmission
+*	counter (IFCNT) has advanced.
+*
+*	Only what is needed for StallGuard homing is provided; step and direction still come from FastAccelStepper and
+*	the microstep resolution from the MS1 & MS2 pins.
+*
+*	Mitchell Baldwin copyright 2026
+*
+*	v 0.00:	Initial data structure
+*	v
+*
+*/
+
+#ifndef _TMC2209UART_h
+#define _TMC2209UART_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+	#include "arduino.h"
+#else
+	#include "WProgram.h"
+#endif
+#include <HardwareSerial.h>
+
+constexpr int DefaultTurretUARTTxPin = GPIO_NUM_43;	// TMC2209 PDN_UART through 1k; XIAO D6
+constexpr int DefaultTurretUARTRxPin = GPIO_NUM_42;	// TMC2209 PDN_UART; XIAO underside pad MTMS (D7 is the forward VL53L1X interrupt)
+constexpr uint32_t TMC2209UARTBaud = 115200;
+constexpr uint8_t DefaultTMC2209Address = 0;		// MS1 & MS2 low (1/8 microstepping)
+constexpr uint32_t TMC2209ReplyTimeout = 5;			// ms
+
+// Registers:
+constexpr uint8_t TMC2209_GCONF = 0x00;
+constexpr uint8_t TMC2209_IFCNT = 0x02;
+constexpr uint8_t TMC2209_TCOOLTHRS = 0x14;
+constexpr uint8_t TMC2209_SGTHRS = 0x40;
+constexpr uint8_t TMC2209_SG_RESULT = 0x41;
+
+// GCONF bits:
+constexpr uint32_t TMC2209_GCONF_I_scale_analog = 0x001;
+constexpr uint32_t TMC2209_GCONF_pdn_disable = 0x040;	// PDN_UART used for UART only
+constexpr uint32_t TMC2209_GCONF_multistep_filt = 0x100;
+
+class TMC2209UARTClass
+{
+protected:
+	HardwareSerial* Port = nullptr;
+	uint8_t Address = DefaultTMC2209Address;
+	bool Connected = false;
+
+	static uint8_t CRC(const uint8_t* data, uint8_t length);
+
+public:
+	uint32_t Writes = 0;
+	uint32_t WriteFailures = 0;
+	uint32_t Reads = 0;
+	uint32_t ReadFailures = 0;
+
+	bool Begin(HardwareSerial& port, int rxPin = DefaultTurretUARTRxPin, int txPin = DefaultTurretUARTTxPin, uint8_t address = DefaultTMC2209Address);
+	bool IsConnected() const { return Connected; }
+	bool WriteRegister(uint8_t reg, uint32_t value);
+	bool ReadRegister(uint8_t reg, uint32_t& value);
+	bool ConfigureStallGuard(uint8_t threshold);
+	bool ReadStallGuard(uint16_t& result);
+};
+
+#endif
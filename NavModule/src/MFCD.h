@@ -80,7 +80,7 @@ protected:
 	TFT_eSPI tft = TFT_eSPI();
 	byte Brightness = InitialMFCDBrightness;
 
-	MFCDPageClass* Pages[PageIDs::NONE];
+	MFCDPageClass* Pages[PageIDs::NONE + 1];
 	MFCDPageClass* lastPage = nullptr;
 	MFCDPageClass* currentPage = nullptr;
 
@@ -235,7 +235,7 @@ void SystemPageClass::Activate(bool reinitialize)
 	tft->drawString(buf, 40, 80);
 
 	tft->setTextColor(TFT_GREEN);
-	sprintf(buf, "IP: %s", WiFi.localIP().toString());
+	sprintf(buf, "IP: %s", WiFi.localIP().toString().c_str());
 	tft->drawString(buf, 40, 90);
 
 	tft->setTextColor(TFT_CYAN);
@@ -330,7 +330,7 @@ void DebugPageClass::Activate(bool reinitialize)
 		tft->setTextColor(TFT_SKYBLUE, TFT_BLACK, true);
 		sprintf(buf, "SSID: %s %d dBm", WiFi.SSID().c_str(), WiFi.RSSI());
 		tft->drawString(buf, 40, 160, 1);
-		sprintf(buf, "IP: %s", WiFi.localIP().toString());
+		sprintf(buf, "IP: %s", WiFi.localIP().toString().c_str());
 		tft->drawString(buf, 40, 170, 1);
 
 		for (int i = 0; i < MAX_TEXT_LINES; ++i)